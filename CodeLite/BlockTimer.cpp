@@ -1,6 +1,7 @@
 #include "BlockTimer.hpp"
 
 #include "clModuleLogger.hpp"
+#include "clTraceRecorder.hpp"
 #include "file_logger.h"
 
 #include <vector>
@@ -143,6 +144,7 @@ BlockTimer::BlockTimer(const char* label)
     : m_label{label}
 {
     if (g_enabled) [[unlikely]] {
+        m_startUs = clTraceRecorder::NowMicro();
         m_sw.Start();
         g_timers_stack.push_back(this);
     }
@@ -183,6 +185,8 @@ void BlockTimer::DoReport()
     if (g_enabled && m_active) [[unlikely]] {
         auto parent = GetParent();
         m_sw.Pause();
+        clTraceRecorder::Get().Record(
+            m_label, m_buffer.str(), m_startUs, static_cast<uint64_t>(m_sw.TimeInMicro()), g_timers_stack.size() - 1);
         auto content = BuildContent();
         if (parent) [[unlikely]] {
             parent->m_childrenContent.reserve(parent->m_childrenContent.size() + content.size());
@@ -94,8 +94,8 @@ private:
     /**
      * Reports the timing results for the current block.
      *
-     * If timing is enabled and the block is active, it builds the content string and
-     * either adds it to a parent timer's content list or logs the results and
+     * If timing is enabled and the block is active, it records the span in the `clTraceRecorder`, builds the
+     * content string and either adds it to a parent timer's content list or logs the results and
      * any children's content directly to the system log.
      *
      * @return void
@@ -103,6 +103,7 @@ private:
     void DoReport();
 
     wxStopWatch m_sw;
+    uint64_t m_startUs{0};
     bool m_active{true};
     std::stringstream m_buffer;
     std::string m_label;
@@ -1,6 +1,7 @@
 #include "CTags.hpp"
 
 #include "AsyncProcess/asyncprocess.h"
+#include "CTagsServer.hpp"
 #include "Platform/Platform.hpp"
 #include "StringUtils.h"
 #include "assistant/Process.hpp"
@@ -12,7 +13,12 @@
 #include "procutils.h"
 
 #include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <mutex>
+#include <queue>
+#include <thread>
 #include <wx/stopwatch.h>
 #include <wx/tokenzr.h>
 
@@ -128,6 +134,14 @@ clStatusOr<std::vector<CTags::SymbolInfo>> CTags::ParseBufferSymbols(const wxStr
         return StatusInvalidArgument(wxString() << _("Failed to resolve file extension for file: ") << filename);
     }
 
+    // send the buffer to the ctags server, fall back to a temporary file when it can't be used (e.g. ctags was
+    // built without JSON support)
+    static CTagsServer server{s_ctags_executable};
+    auto symbols = server.GetSymbols(filename, buffer, ext.value());
+    if (symbols.ok()) {
+        return symbols;
+    }
+
     clTempFile tmpfile{ext.value()};
     if (!tmpfile.Write(buffer)) {
         return StatusIOError(wxString() << _("Failed to write temporary file: ") << tmpfile.GetFullPath()
@@ -167,14 +181,19 @@ clStatusOr<std::vector<CTags::SymbolInfo>> CTags::ParseFileSymbols(const wxStrin
     clDEBUG() << "Parsing symbols...done" << endl;
 
     clDEBUG() << "Sorting symbols..." << endl;
+    SortSymbols(symbols);
+    clDEBUG() << "Sorting symbols...done" << endl;
+    return symbols;
+}
+
+void CTags::SortSymbols(std::vector<SymbolInfo>& symbols)
+{
     std::sort(symbols.begin(), symbols.end(), [](const SymbolInfo& lhs, const SymbolInfo& rhs) {
         if (lhs.line != rhs.line) {
             return lhs.line < rhs.line;
         }
         return lhs.name < rhs.name;
     });
-    clDEBUG() << "Sorting symbols...done" << endl;
-    return symbols;
 }
 
 std::optional<CTags::SymbolRangeInfo> CTags::FindSymbolsRangeNearLine(const std::vector<SymbolInfo>& symbols, int line)
@@ -205,12 +224,82 @@ std::optional<CTags::SymbolRangeInfo> CTags::FindSymbolsRangeNearLine(const std:
     return result;
 }
 
-std::optional<wxString>
-CTags::DoCxxGenerate(const wxString& filesContent, const wxString& ctags_exe, const wxString& ctags_kinds)
+void CTagsOutputParser::Feed(const char* data, size_t len, std::vector<TagEntryPtr>& tags)
 {
-    clDEBUG() << "Generating ctags files" << clEndl;
+    const char* end = data + len;
+    const char* line_start = data;
+    while (line_start < end) {
+        const char* eol = static_cast<const char*>(std::memchr(line_start, '\n', end - line_start));
+        if (eol == nullptr) {
+            break;
+        }
+
+        if (m_partial.empty()) {
+            ParseLine(line_start, eol - line_start, tags);
+        } else {
+            m_partial.append(line_start, eol - line_start);
+            ParseLine(m_partial.data(), m_partial.size(), tags);
+            m_partial.clear();
+        }
+        line_start = eol + 1;
+    }
+    m_partial.append(line_start, end - line_start);
+}
+
+void CTagsOutputParser::Flush(std::vector<TagEntryPtr>& tags)
+{
+    if (!m_partial.empty()) {
+        ParseLine(m_partial.data(), m_partial.size(), tags);
+        m_partial.clear();
+    }
+}
+
+void CTagsOutputParser::ParseLine(const char* line, size_t len, std::vector<TagEntryPtr>& tags)
+{
+    wxString str = wxString::FromUTF8(line, len);
+    if (str.empty()) {
+        // not a valid UTF-8 line
+        str = wxString::From8BitData(line, len);
+    }
+    str.Trim(false).Trim();
+    if (str.empty()) {
+        return;
+    }
 
-    // prepare the options file
+    // construct a tag from the line
+    TagEntryPtr tag(new TagEntry());
+    tag->FromLine(str);
+
+    if (tag->IsEnumerator()                                 // looking at an enumerator
+        && m_prevScopedTag                                  // we have a previously seen scope
+        && m_prevScopedTag->GetFile() == tag->GetFile()     /// and they are on the same file
+        && m_prevScopedTag->GetName() == tag->GetParent()) // and it belongs to it
+    {
+        // remove one part of the scope
+        wxArrayString scopes = ::wxStringTokenize(tag->GetScope(), ":", wxTOKEN_STRTOK);
+        if (scopes.size()) {
+            scopes.pop_back(); // remove the last part of the scope
+            wxString new_scope;
+            for (const wxString& scope : scopes) {
+                if (!new_scope.empty()) {
+                    new_scope << "::";
+                }
+                new_scope << scope;
+            }
+            // update the scope
+            tag->SetScope(new_scope.empty() ? "<global>" : new_scope);
+        }
+    }
+
+    if (tag->IsEnum()) {
+        m_prevScopedTag = tag;
+    }
+    tags.push_back(std::move(tag));
+}
+
+std::vector<wxString>
+CTags::MakeCxxCommand(const wxString& file_list, const wxString& ctags_exe, const wxString& ctags_kinds)
+{
     // one option per line
     std::vector<wxString> options_arr;
     wxString fields_cxx = "--fields-c++=+{template}+{properties}";
@@ -229,108 +318,243 @@ CTags::DoCxxGenerate(const wxString& filesContent, const wxString& ctags_exe, co
         kinds_arr = {"--c-kinds=" + ctags_kinds, "--C++-kinds=" + ctags_kinds};
     }
 
-    // start timer
-    wxStopWatch sw;
-    sw.Start();
-
-    // Split the list of files
-    clTempFile file_list(clStandardPaths::Get().GetTempDir(), "txt");
-    if (!FileUtils::WriteFileContent(file_list.GetFullPath(), filesContent)) {
-        clWARNING() << "Failed to write ctags file list: " << file_list.GetFullPath(true) << endl;
-        return std::nullopt;
-    }
-
     std::vector<wxString> cmdarr{ctags_exe};
     cmdarr.insert(cmdarr.end(), options_arr.begin(), options_arr.end());
     cmdarr.insert(cmdarr.end(), kinds_arr.begin(), kinds_arr.end());
     cmdarr.push_back("-o");
     cmdarr.push_back("-");
     cmdarr.push_back("-L");
-    cmdarr.push_back(file_list.GetFullPath(true));
-    clDEBUG() << "Running command:" << StringUtils::Join(cmdarr, " ") << endl;
+    cmdarr.push_back(file_list);
+    return cmdarr;
+}
 
-    auto command = StringUtils::ToStdStrings(cmdarr);
-    auto result = assistant::Process::RunProcessAndWait(command);
-    if (!result.ok) {
-        clWARNING() << "Failed to execute command. stderr:" << result.err << endl;
-        return std::nullopt;
+bool CTags::DoCxxGenerate(IProcess* process, const std::function<bool(const char* data, size_t len)>& on_output)
+{
+    wxString out;
+    wxString err;
+    std::string raw_out;
+    std::string raw_err;
+    std::string errors;
+    while (true) {
+        // Read() only assigns the buffers of the streams it read from
+        raw_out.clear();
+        raw_err.clear();
+        if (!process->Read(out, err, raw_out, raw_err)) {
+            break;
+        }
+        errors += raw_err;
+        if (!raw_out.empty() && !on_output(raw_out.data(), raw_out.size())) {
+            process->Terminate();
+            return false;
+        }
     }
 
-    wxString output = wxString::FromUTF8(result.out);
-    long elapsed = sw.Time();
+    if (!errors.empty()) {
+        clDEBUG() << "STDERR:" << errors << endl;
+    }
+    return true;
+}
+
+std::vector<std::vector<wxString>> CTags::ShardFiles(const std::vector<wxString>& files, size_t count)
+{
+    count = std::max<size_t>(1, std::min(count, files.size()));
+    if (count == 1) {
+        return {files};
+    }
+
+    std::vector<std::pair<unsigned long long, size_t>> sizes; // size, index in files
+    sizes.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        wxULongLong size = wxFileName::GetSize(files[i]);
+        sizes.push_back({size == wxInvalidSize ? 0 : size.GetValue(), i});
+    }
+    std::stable_sort(sizes.begin(), sizes.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    // the shard with the smallest total is on top
+    using Shard_t = std::pair<unsigned long long, size_t>; // total size, shard index
+    std::priority_queue<Shard_t, std::vector<Shard_t>, std::greater<Shard_t>> totals;
+    for (size_t i = 0; i < count; ++i) {
+        totals.push({0, i});
+    }
+
+    std::vector<size_t> file_shard(files.size());
+    for (const auto& [size, index] : sizes) {
+        auto [total, shard] = totals.top();
+        totals.pop();
+        file_shard[index] = shard;
+        totals.push({total + size, shard});
+    }
 
-    clDEBUG() << "STDOUT:" << result.out << endl;
-    clDEBUG() << "STDERR:" << result.err << endl;
-    clDEBUG() << "ctags generation took:" << (elapsed / 1000) << "secs," << (elapsed % 1000) << "ms" << endl;
-    clDEBUG() << "Generating ctags files... Success" << endl;
-    return output;
+    std::vector<std::vector<wxString>> shards(count);
+    for (size_t i = 0; i < files.size(); ++i) {
+        shards[file_shard[i]].push_back(files[i]);
+    }
+    return shards;
 }
 
-clStatusOr<std::vector<TagEntryPtr>> CTags::ParseCxxFiles(const std::vector<wxString>& files)
+clStatus CTags::ParseCxxFiles(const std::vector<wxString>& files,
+                             const TagsBatchCallback_t& on_batch,
+                             const ParseOptions& options)
 {
     if (s_ctags_executable.empty()) {
         return StatusNotFound("Please install universal-ctags and try again");
     }
 
-    wxString filesList = StringUtils::Join(files, "\n");
-    filesList << "\n";
-
-    auto result = DoCxxGenerate(filesList, s_ctags_executable);
-    if (!result.has_value()) {
-        return std::vector<TagEntryPtr>{};
+    if (files.empty()) {
+        return StatusOk();
     }
 
-    auto content = result.value();
-    std::vector<TagEntryPtr> tags;
-    wxArrayString lines = ::wxStringTokenize(content, "\n", wxTOKEN_STRTOK);
-    clDEBUG() << "Processing" << lines.size() << "lines" << endl;
-    tags.reserve(lines.size());
+    wxStopWatch sw;
+    sw.Start();
 
-    // convert the lines into tags
-    TagEntryPtr prev_scoped_tag = nullptr;
-    for (wxString& line : lines) {
-        line.Trim(false).Trim();
-        if (line.empty()) {
+    size_t shards_count = options.shards;
+    if (shards_count == 0) {
+        shards_count = std::min<size_t>(std::thread::hardware_concurrency(), files.size() / MIN_FILES_PER_SHARD);
+    }
+    auto shards = ShardFiles(files, shards_count);
+    const size_t batch_size = std::max<size_t>(options.batch_size, 1);
+    const size_t max_pending = std::max<size_t>(options.max_pending_batches, 1);
+
+    // write the file lists and start the processes from this thread: creating temporary files and processes is not
+    // thread safe. Only the reads are done by the reader threads
+    std::vector<std::unique_ptr<clTempFile>> file_lists;
+    std::vector<IProcess::Ptr_t> processes;
+    for (const auto& shard : shards) {
+        file_lists.push_back(std::make_unique<clTempFile>(clStandardPaths::Get().GetTempDir(), "txt"));
+        wxString content = StringUtils::Join(shard, "\n");
+        content << "\n";
+        if (!FileUtils::WriteFileContent(file_lists.back()->GetFullPath(), content)) {
+            clWARNING() << "Failed to write ctags file list: " << file_lists.back()->GetFullPath(true) << endl;
+            return StatusIOError(wxString() << _("Failed to write temporary file: ")
+                                            << file_lists.back()->GetFullPath());
+        }
+
+        auto command = MakeCxxCommand(file_lists.back()->GetFullPath(true), s_ctags_executable);
+        clDEBUG() << "Running command:" << StringUtils::Join(command, " ") << endl;
+        // use pipes: a terminal would mix stderr with the tags and turn the "\n" into "\r\n"
+        IProcess::Ptr_t process(::CreateAsyncProcess(nullptr,
+                                                     command,
+                                                     IProcessCreateSync | IProcessNoPty | IProcessStderrEvent |
+                                                         IProcessRawOutput,
+                                                     wxEmptyString,
+                                                     nullptr,
+                                                     wxEmptyString));
+        if (!process) {
+            clWARNING() << "Failed to execute command:" << StringUtils::Join(command, " ") << endl;
             continue;
         }
+        processes.push_back(process);
+    }
+
+    std::mutex mutex;
+    std::condition_variable cv_pending; // the consumer waits for batches
+    std::condition_variable cv_space;   // the readers wait for the consumer to take some batches
+    std::deque<std::vector<TagEntryPtr>> pending;
+    size_t running_readers = processes.size();
+    std::atomic_bool stop{false};
+
+    auto push_batch = [&](std::vector<TagEntryPtr>&& batch) {
+        std::unique_lock lock{mutex};
+        cv_space.wait(lock, [&]() { return pending.size() < max_pending || stop.load(); });
+        if (stop.load()) {
+            return false;
+        }
+        pending.push_back(std::move(batch));
+        cv_pending.notify_one();
+        return true;
+    };
+
+    auto reader_main = [&](IProcess* process) {
+        CTagsOutputParser parser;
+        std::vector<TagEntryPtr> batch;
+        batch.reserve(batch_size);
+        auto on_output = [&](const char* data, size_t len) {
+            parser.Feed(data, len, batch);
+            if (batch.size() < batch_size) {
+                return true;
+            }
+            if (!push_batch(std::move(batch))) {
+                return false;
+            }
+            batch = {};
+            batch.reserve(batch_size);
+            return true;
+        };
+
+        if (DoCxxGenerate(process, on_output)) {
+            parser.Flush(batch);
+            if (!batch.empty()) {
+                push_batch(std::move(batch));
+            }
+        }
+
+        std::lock_guard lock{mutex};
+        --running_readers;
+        cv_pending.notify_one();
+    };
 
-        // construct a tag from the line
-        tags.emplace_back(new TagEntry());
-        auto tag = tags.back();
-        tag->FromLine(line);
+    std::vector<std::thread> readers;
+    readers.reserve(processes.size());
+    for (const auto& process : processes) {
+        readers.emplace_back(reader_main, process.get());
+    }
 
-        if (tag->IsEnumerator()                                // looking at an enumerator
-            && prev_scoped_tag                                 // we have a previously seen scope
-            && prev_scoped_tag->GetFile() == tag->GetFile()    /// and they are on the same file
-            && prev_scoped_tag->GetName() == tag->GetParent()) // and it belongs to it
+    size_t tags_count = 0;
+    while (true) {
+        std::vector<TagEntryPtr> batch;
         {
-            // remove one part of the scope
-            wxArrayString scopes = ::wxStringTokenize(tag->GetScope(), ":", wxTOKEN_STRTOK);
-            if (scopes.size()) {
-                scopes.pop_back(); // remove the last part of the scope
-                wxString new_scope;
-                for (const wxString& scope : scopes) {
-                    if (!new_scope.empty()) {
-                        new_scope << "::";
-                    }
-                    new_scope << scope;
-                }
-                // update the scope
-                tag->SetScope(new_scope.empty() ? "<global>" : new_scope);
+            std::unique_lock lock{mutex};
+            cv_pending.wait(lock, [&]() { return !pending.empty() || running_readers == 0; });
+            if (pending.empty()) {
+                break;
             }
+            batch = std::move(pending.front());
+            pending.pop_front();
+            cv_space.notify_one();
         }
 
-        if (tag->IsEnum()) {
-            prev_scoped_tag = tag;
+        tags_count += batch.size();
+        if (!on_batch(std::move(batch))) {
+            clDEBUG() << "ctags parsing cancelled" << endl;
+            break;
         }
     }
 
-    if (tags.empty()) {
-        clDEBUG() << "0 tags, ctags output:" << content << endl;
+    {
+        std::lock_guard lock{mutex};
+        stop.store(true);
+        cv_space.notify_all();
     }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+
+    long elapsed = sw.Time();
+    clDEBUG() << "ctags:" << files.size() << "files," << tags_count << "tags," << processes.size() << "processes, took"
+              << elapsed << "ms" << endl;
+    return StatusOk();
+}
 
-    for (auto t : tags) {
-        clDEBUG() << "Tag:" << t->GetName() << ", Kind:" << t->GetKind() << endl;
+clStatusOr<std::vector<TagEntryPtr>> CTags::ParseCxxFiles(const std::vector<wxString>& files)
+{
+    std::vector<TagEntryPtr> tags;
+    auto status = ParseCxxFiles(
+        files,
+        [&tags](std::vector<TagEntryPtr>&& batch) {
+            if (tags.empty()) {
+                tags = std::move(batch);
+            } else {
+                tags.insert(tags.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+            }
+            return true;
+        },
+        ParseOptions{});
+    if (!status.ok()) {
+        return status;
+    }
+
+    if (tags.empty()) {
+        clDEBUG() << "0 tags for" << files.size() << "files" << endl;
     }
     return tags;
 }
@@ -6,11 +6,43 @@
 #include "database/entry.h"
 #include "fileextmanager.h"
 
+#include <functional>
 #include <optional>
+#include <string>
 #include <vector>
 #include <wx/filename.h>
 #include <wx/textfile.h>
 
+class IProcess;
+
+/**
+ * @class CTagsOutputParser
+ * @brief converts the output of a ctags process into tags as it arrives
+ *
+ * The output is fed in chunks of raw bytes, as read from the process. Only complete lines are parsed, so a chunk may
+ * end in the middle of a line (or of a multi byte character).
+ */
+class WXDLLIMPEXP_CL CTagsOutputParser
+{
+public:
+    /**
+     * @brief parse the complete lines of `data` and append their tags to `tags`. The incomplete last line is kept
+     * for the next call
+     */
+    void Feed(const char* data, size_t len, std::vector<TagEntryPtr>& tags);
+
+    /**
+     * @brief parse the last line, when the output did not end with a new line
+     */
+    void Flush(std::vector<TagEntryPtr>& tags);
+
+private:
+    void ParseLine(const char* line, size_t len, std::vector<TagEntryPtr>& tags);
+
+    std::string m_partial;
+    TagEntryPtr m_prevScopedTag;
+};
+
 class WXDLLIMPEXP_CL CTags
 {
 public:
@@ -43,12 +75,52 @@ public:
             return s;
         }
     };
+    /// called with each batch of tags, on the thread that called ParseCxxFiles(). Return false to stop parsing
+    using TagsBatchCallback_t = std::function<bool(std::vector<TagEntryPtr>&& tags)>;
+
+    struct ParseOptions {
+        /// the number of ctags processes. 0: one per core, with at least MIN_FILES_PER_SHARD files each
+        size_t shards = 0;
+        /// the number of tags passed to the callback at once
+        size_t batch_size = 1000;
+        /// the number of batches waiting for the callback before the ctags processes are no longer read
+        size_t max_pending_batches = 16;
+    };
+
+    static constexpr size_t MIN_FILES_PER_SHARD = 64;
+
+    /**
+     * Parse C++ source files with universal-ctags and stream the resulting tag entries to `on_batch`.
+     *
+     * The files are split by size across several ctags processes. The output of each process is parsed as it
+     * arrives and handed over in batches, through a bounded queue, to `on_batch` which runs on the calling thread
+     * (e.g. to write them to the tags storage). When the queue is full, the processes are no longer read until the
+     * callback catches up, so the memory used does not depend on the number of files.
+     *
+     * The batches of the different processes are interleaved, but the tags of a file are always in one process
+     * and in the order ctags reported them.
+     *
+     * @param files const std::vector<wxString>& A list of C++ source file paths to parse.
+     * @param on_batch const TagsBatchCallback_t& Receives the tags. Return false to cancel the parsing.
+     * @param options const ParseOptions& The number of processes and the sizes of the batches and of the queue.
+     * @return clStatus StatusNotFound if the universal-ctags executable is not available, StatusOk otherwise.
+     */
+    static clStatus
+    ParseCxxFiles(const std::vector<wxString>& files, const TagsBatchCallback_t& on_batch, const ParseOptions& options);
+
+    /**
+     * @brief split `files` into at most `count` lists of about the same total size on disk.
+     *
+     * The largest files are assigned first, each one to the list with the smallest total so far. The lists keep the
+     * order of `files`.
+     */
+    static std::vector<std::vector<wxString>> ShardFiles(const std::vector<wxString>& files, size_t count);
+
     /**
      * Parse C++ source files with universal-ctags and return the resulting tag entries.
      *
-     * This method invokes the configured ctags executable to generate tags for the given files,
-     * then converts each output line into a TagEntry. It also adjusts enumerator scope information
-     * when an enumerator is detected to belong to the most recently seen enum in the same file.
+     * This collects the batches of the streaming ParseCxxFiles() into a single vector. It also adjusts enumerator
+     * scope information when an enumerator is detected to belong to the most recently seen enum in the same file.
      *
      * @param files const std::vector<wxString>& A list of C++ source file paths to parse.
      * @return clStatusOr<std::vector<TagEntryPtr>> A status-or containing the parsed tag entries on
@@ -108,11 +180,12 @@ public:
     static clStatusOr<std::vector<SymbolInfo>> ParseFileSymbols(const wxString& file);
 
     /**
-     * @brief Parses symbols from an in-memory buffer by writing it to a temporary file and analyzing it with ctags.
+     * @brief Parses symbols from an in-memory buffer with a long running ctags server (see CTagsServer).
      *
-     * This helper resolves the most likely file extension from the provided filename and buffer, writes the buffer to a
-     * temporary file with that extension, and then reuses the file-based symbol parser. The function requires a
-     * configured universal-ctags executable and may fail if the extension cannot be determined or the temporary file
+     * This helper resolves the most likely file extension from the provided filename and buffer, and sends the buffer
+     * to the ctags server, which caches the results by content. When the server can't be used, the buffer is written
+     * to a temporary file with that extension and the file-based symbol parser is used instead. The function requires
+     * a configured universal-ctags executable and may fail if the extension cannot be determined or the temporary file
      * cannot be written.
      *
      * @param filename const wxString& The original file name used to infer the file extension.
@@ -176,28 +249,28 @@ public:
     static void Initialise();
 
 private:
+    friend class CTagsServer;
+
     static clStatusOr<wxString> LocateExe();
     /**
-     * Generate ctags output for a list of source files using a temporary options file.
+     * Build the ctags command line that writes the tags of the files listed in `file_list` to stdout.
      *
-     * This method prepares a per-call ctags options file, writes the provided file list to a temporary
-     * file, and then executes the configured ctags executable to produce tags on standard output.
-     * It is a helper in the CTags class and uses the current thread id to create unique temporary
-     * file names.
-     *
-     * @param filesContent const wxString& Newline-separated list of file paths to pass to ctags.
+     * @param file_list const wxString& Path to a file holding one source file path per line.
      * @param ctags_exe const wxString& Path to the ctags executable to run.
      * @param ctags_kinds const wxString& ctags kind selection string to apply to both C and C++,
      *        or an empty string to use the default kind set.
+     */
+    static std::vector<wxString>
+    MakeCxxCommand(const wxString& file_list, const wxString& ctags_exe, const wxString& ctags_kinds = wxEmptyString);
+    /**
+     * Read the stdout of a ctags process started with a MakeCxxCommand() command and pass it to `on_output` as it
+     * arrives, until the process exits.
      *
-     * @return std::optional<wxString> The command output produced by ctags, or an empty optional
-     *         if execution fails or no output is available.
-     *
-     * @throws None explicitly. Errors are handled by the underlying file and process utility
-     *         functions, which may fail internally when writing temporary files or executing ctags.
+     * @param process IProcess* A synchronous process.
+     * @param on_output Receives the raw output chunks. Return false to terminate the process.
+     * @return bool false if the process was terminated by `on_output`.
      */
-    static std::optional<wxString>
-    DoCxxGenerate(const wxString& filesContent, const wxString& ctags_exe, const wxString& ctags_kinds = wxEmptyString);
+    static bool DoCxxGenerate(IProcess* process, const std::function<bool(const char* data, size_t len)>& on_output);
     /**
      * @brief Generates a JSON symbol listing for a source file using ctags.
      *
@@ -233,6 +306,8 @@ private:
      */
     static std::vector<SymbolInfo>
     ParseSymbolOutput(const wxString& content, const wxString& filename, const wxString& file_ext);
+    /// sort the symbols by line, then by name
+    static void SortSymbols(std::vector<SymbolInfo>& symbols);
     static std::optional<SymbolKind> MapSymbolKind(const wxString& kind,
                                                    const wxString& scope,
                                                    const wxString& kind_from_ctags,
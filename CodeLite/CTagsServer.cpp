@@ -0,0 +1,201 @@
+#include "CTagsServer.hpp"
+
+#include "AsyncProcess/asyncprocess.h"
+#include "StringUtils.h"
+#include "assistant/common/json.hpp"
+#include "file_logger.h"
+
+#include <algorithm>
+#include <wx/filename.h>
+#include <wx/stopwatch.h>
+
+using assistant::json;
+
+namespace
+{
+bool IsMessage(const std::string& line, const std::string& type)
+{
+    // most lines are tags, don't parse them twice
+    if (line.find(type) == std::string::npos) {
+        return false;
+    }
+
+    try {
+        json message = json::parse(line);
+        return message.is_object() && message.contains("_type") && message["_type"] == type;
+    } catch (...) {
+        return false;
+    }
+}
+} // namespace
+
+CTagsServer::CTagsServer(const wxString& ctags_exe, size_t cache_size)
+    : m_ctags_exe(ctags_exe)
+    , m_cacheSize(std::max<size_t>(cache_size, 1))
+{
+}
+
+CTagsServer::~CTagsServer()
+{
+    std::unique_lock lock{m_mutex};
+    m_process.reset();
+}
+
+clStatusOr<std::vector<CTags::SymbolInfo>>
+CTagsServer::GetSymbols(const wxString& filename, const wxString& buffer, const wxString& file_ext)
+{
+    // ctags guesses the language from the file name
+    wxString ext = file_ext.empty() ? wxFileName(filename).GetExt() : file_ext;
+    wxString ctags_name = filename;
+    if (wxFileName(filename).GetExt() != ext) {
+        ctags_name << "." << ext;
+    }
+
+    std::string content = buffer.ToStdString(wxConvUTF8);
+    std::string name = ctags_name.ToStdString(wxConvUTF8);
+    size_t key = std::hash<std::string>{}(content);
+    key ^= std::hash<std::string>{}(name) + 0x9e3779b97f4a7c15ull + (key << 6) + (key >> 2);
+
+    std::unique_lock lock{m_mutex};
+    auto iter = m_cacheIndex.find(key);
+    if (iter != m_cacheIndex.end()) {
+        m_cache.splice(m_cache.begin(), m_cache, iter->second);
+        return iter->second->symbols;
+    }
+
+    if (!m_process && !DoStart()) {
+        return StatusNotFound(_("Failed to start ctags in interactive mode"));
+    }
+
+    auto output = DoQuery(name, content);
+    if (!output.ok()) {
+        // the server crashed or stopped answering: start a new one and ask again
+        clWARNING() << "ctags server:" << output.error_message() << ". Restarting it" << endl;
+        DoStop();
+        ++m_restarts;
+        if (!DoStart()) {
+            return StatusNotFound(_("Failed to start ctags in interactive mode"));
+        }
+        output = DoQuery(name, content);
+        if (!output.ok()) {
+            DoStop();
+            return output.status();
+        }
+    }
+
+    auto symbols =
+        CTags::ParseSymbolOutput(wxString::FromUTF8(output.value().data(), output.value().size()), filename, ext);
+    CTags::SortSymbols(symbols);
+
+    m_cache.push_front({key, symbols});
+    m_cacheIndex.insert({key, m_cache.begin()});
+    if (m_cache.size() > m_cacheSize) {
+        m_cacheIndex.erase(m_cache.back().key);
+        m_cache.pop_back();
+    }
+    return symbols;
+}
+
+void CTagsServer::Stop()
+{
+    std::unique_lock lock{m_mutex};
+    DoStop();
+}
+
+int CTagsServer::GetPid() const
+{
+    std::unique_lock lock{m_mutex};
+    return m_process ? m_process->GetPid() : wxNOT_FOUND;
+}
+
+bool CTagsServer::DoStart()
+{
+    if (m_ctags_exe.empty()) {
+        return false;
+    }
+
+    std::vector<wxString> command{m_ctags_exe, "--_interactive", "--fields=+nKsSe", "--extras=+q"};
+    clDEBUG() << "Starting ctags server:" << StringUtils::Join(command, " ") << endl;
+    m_output.clear();
+    m_process.reset(::CreateAsyncProcess(nullptr,
+                                         command,
+                                         IProcessCreateSync | IProcessNoPty | IProcessStderrEvent | IProcessRawOutput,
+                                         wxEmptyString,
+                                         nullptr,
+                                         wxEmptyString));
+    if (!m_process) {
+        clWARNING() << "Failed to start ctags server:" << StringUtils::Join(command, " ") << endl;
+        return false;
+    }
+
+    // the server introduces itself. ctags built without JSON support exits instead
+    std::string line;
+    if (!ReadLine(line, REQUEST_TIMEOUT_MS) || !IsMessage(line, "program")) {
+        clWARNING() << "ctags does not support the interactive mode:" << line << endl;
+        DoStop();
+        return false;
+    }
+    return true;
+}
+
+void CTagsServer::DoStop()
+{
+    if (m_process) {
+        m_process->Terminate();
+        m_process.reset();
+    }
+    m_output.clear();
+}
+
+bool CTagsServer::ReadLine(std::string& line, long timeout_ms)
+{
+    wxStopWatch sw;
+    wxString out;
+    wxString err;
+    std::string raw_out;
+    std::string raw_err;
+    while (true) {
+        size_t eol = m_output.find('\n');
+        if (eol != std::string::npos) {
+            line = m_output.substr(0, eol);
+            m_output.erase(0, eol + 1);
+            return true;
+        }
+
+        if (sw.Time() > timeout_ms) {
+            return false;
+        }
+
+        // Read() only assigns the buffers of the streams it read from
+        raw_out.clear();
+        raw_err.clear();
+        if (!m_process->Read(out, err, raw_out, raw_err)) {
+            return false;
+        }
+        if (!raw_err.empty()) {
+            clDEBUG() << "ctags server stderr:" << raw_err << endl;
+        }
+        m_output += raw_out;
+    }
+}
+
+clStatusOr<std::string> CTagsServer::DoQuery(const std::string& filename, const std::string& content)
+{
+    ++m_queries;
+    json request = {{"command", "generate-tags"}, {"filename", filename}, {"size", content.size()}};
+    if (!m_process->WriteRaw(request.dump() + "\n" + content)) {
+        return StatusIOError(_("Failed to write to the ctags server"));
+    }
+
+    // one line per tag, then "completed"
+    std::string tags;
+    std::string line;
+    while (ReadLine(line, REQUEST_TIMEOUT_MS)) {
+        if (IsMessage(line, "completed")) {
+            return tags;
+        }
+        tags += line;
+        tags += "\n";
+    }
+    return StatusTimeout(_("The ctags server did not answer"));
+}
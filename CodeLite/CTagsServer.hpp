@@ -0,0 +1,76 @@
+#ifndef CTAGSSERVER_HPP
+#define CTAGSSERVER_HPP
+
+#include "CTags.hpp"
+#include "clResult.hpp"
+#include "codelite_exports.h"
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @class CTagsServer
+ * @brief a long running `ctags --_interactive` process that returns the symbols of in memory buffers.
+ *
+ * The buffers are sent over the process stdin, so no temporary file is written and no process is started per query.
+ * The server is started on the first query and started again when it crashes or stops answering. The results are
+ * cached by the hash of the buffer content and of its file name. Queries are serialised.
+ */
+class WXDLLIMPEXP_CL CTagsServer
+{
+public:
+    static constexpr size_t DEFAULT_CACHE_SIZE = 32;
+    static constexpr long REQUEST_TIMEOUT_MS = 10000;
+
+public:
+    CTagsServer(const wxString& ctags_exe, size_t cache_size = DEFAULT_CACHE_SIZE);
+    ~CTagsServer();
+
+    /**
+     * @brief return the symbols of `buffer`, sorted by line then by name. `filename` is reported as the file of the
+     * symbols. `file_ext` selects the language, the extension of `filename` is used when it is empty
+     */
+    clStatusOr<std::vector<CTags::SymbolInfo>>
+    GetSymbols(const wxString& filename, const wxString& buffer, const wxString& file_ext = wxEmptyString);
+
+    /**
+     * @brief stop the server process. The next query starts it again
+     */
+    void Stop();
+
+    /// the pid of the server process, wxNOT_FOUND when it is not running
+    int GetPid() const;
+    /// the number of times the server had to be started again after a crash or a timeout
+    size_t GetRestartCount() const { return m_restarts.load(); }
+    /// the number of queries sent to ctags (i.e. not answered from the cache)
+    size_t GetQueryCount() const { return m_queries.load(); }
+
+private:
+    struct CacheEntry {
+        size_t key = 0;
+        std::vector<CTags::SymbolInfo> symbols;
+    };
+
+    bool DoStart();
+    void DoStop();
+    bool ReadLine(std::string& line, long timeout_ms);
+    clStatusOr<std::string> DoQuery(const std::string& filename, const std::string& content);
+
+    wxString m_ctags_exe;
+    std::shared_ptr<IProcess> m_process;
+    std::string m_output;
+    mutable std::mutex m_mutex;
+    std::list<CacheEntry> m_cache; // most recent first
+    std::unordered_map<size_t, std::list<CacheEntry>::iterator> m_cacheIndex;
+    size_t m_cacheSize = DEFAULT_CACHE_SIZE;
+    std::atomic_size_t m_restarts{0};
+    std::atomic_size_t m_queries{0};
+};
+
+#endif // CTAGSSERVER_HPP
@@ -12,33 +12,17 @@ PHPDocComment::PHPDocComment(PHPSourceFile& sourceFile, const wxString& comment)
     , m_comment(comment)
     , m_returnNullable(false)
 {
-    static std::unordered_set<wxString> nativeTypes;
-    if (nativeTypes.empty()) {
+    // initialized once, even when files are parsed from several threads
+    static const std::unordered_set<wxString> nativeTypes = {
         // List taken from https://www.php.net/manual/en/language.types.intro.php
         // Native types
-        nativeTypes.insert("bool");
-        nativeTypes.insert("int");
-        nativeTypes.insert("float");
-        nativeTypes.insert("string");
-        nativeTypes.insert("array");
-        nativeTypes.insert("object");
-        nativeTypes.insert("iterable");
-        nativeTypes.insert("callable");
-        nativeTypes.insert("null");
-        nativeTypes.insert("mixed");
-        nativeTypes.insert("void");
+        "bool", "int", "float", "string", "array", "object", "iterable", "callable", "null", "mixed", "void",
         // Types that are common in documentation
-        nativeTypes.insert("boolean");
-        nativeTypes.insert("integer");
-        nativeTypes.insert("double");
-        nativeTypes.insert("real");
-        nativeTypes.insert("binery");
-        nativeTypes.insert("resource");
-        nativeTypes.insert("number");
-        nativeTypes.insert("callback");
-    }
+        "boolean", "integer", "double", "real", "binery", "resource", "number", "callback",
+    };
 
-    static wxRegEx reReturnStatement(wxT("@(return)[ \t]+([\\?\\a-zA-Z_]{1}[\\|\\a-zA-Z0-9_]*)"));
+    // wxRegEx keeps the last match: one instance per thread
+    thread_local wxRegEx reReturnStatement(wxT("@(return)[ \t]+([\\?\\a-zA-Z_]{1}[\\|\\a-zA-Z0-9_]*)"));
     if (reReturnStatement.IsValid() && reReturnStatement.Matches(m_comment)) {
         wxString returnValue = reReturnStatement.GetMatch(m_comment, 2);
         if (returnValue.StartsWith("?")) {
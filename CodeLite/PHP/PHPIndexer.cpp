@@ -0,0 +1,256 @@
+#include "PHPIndexer.h"
+
+#include "PHPSourceFile.h"
+#include "clFilesCollector.h"
+#include "event_notifier.h"
+#include "file_logger.h"
+#include "fileextmanager.h"
+#include "fileutils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <wx/stopwatch.h>
+
+namespace
+{
+constexpr size_t MAX_PENDING_FILES = 256;   // parsed files waiting to be stored
+constexpr size_t PROGRESS_EVENT_STEP = 100; // files
+
+/// a file the writer has to store
+struct ParsedFile {
+    wxFileName filename;
+    wxLongLong contentHash = 0;
+    std::unique_ptr<PHPSourceFile> source; // null: the content did not change, only update the parse time
+};
+
+void SendParseEvent(const wxEventType& type, size_t totalFiles, size_t curfileIndex, const wxString& filename = {})
+{
+    clParseEvent event(type);
+    event.SetTotalFiles(totalFiles);
+    event.SetCurfileIndex(curfileIndex);
+    if (!filename.empty()) {
+        event.SetFileName(filename);
+    }
+    EventNotifier::Get()->AddPendingEvent(event);
+}
+} // namespace
+
+PHPIndexer::PHPIndexer(PHPLookupTable& lookup)
+    : m_lookup(lookup)
+{
+    size_t cores = std::thread::hardware_concurrency();
+    m_workers = cores > 1 ? cores - 1 : 1;
+}
+
+wxLongLong PHPIndexer::GetContentHash(const wxString& content)
+{
+    // FNV-1a, 64 bit
+    wxULongLong_t hash = 14695981039346656037ULL;
+    for (wxUniChar ch : content) {
+        hash ^= static_cast<wxULongLong_t>(ch.GetValue());
+        hash *= 1099511628211ULL;
+    }
+    return wxLongLong(static_cast<wxLongLong_t>(hash));
+}
+
+wxArrayString PHPIndexer::CollectFiles(const wxArrayString& folders)
+{
+    std::vector<std::vector<wxString>> results(folders.size());
+    std::vector<std::thread> threads;
+    threads.reserve(folders.size());
+    for (size_t i = 0; i < folders.size(); ++i) {
+        threads.emplace_back([&folders, &results, i]() {
+            clFilesScanner scanner;
+            scanner.Scan(folders.Item(i), results[i], "*.php");
+        });
+    }
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    wxArrayString files;
+    std::unordered_set<wxString> unique_files;
+    for (const auto& folder_files : results) {
+        for (const auto& file : folder_files) {
+            if (unique_files.insert(file).second) {
+                files.Add(file);
+            }
+        }
+    }
+    return files;
+}
+
+PHPIndexer::Stats PHPIndexer::Index(const wxArrayString& files,
+                                    PHPLookupTable::eUpdateMode updateMode,
+                                    const GoingDownFunc& goingDown)
+{
+    Stats stats;
+    stats.files = files.size();
+    SendParseEvent(wxPHP_PARSE_STARTED, files.size(), 0);
+
+    wxStopWatch sw;
+    sw.Start();
+
+    std::unordered_map<wxString, PHPLookupTable::FileInfo> parsedFiles;
+    if (updateMode == PHPLookupTable::kUpdateMode_Fast) {
+        parsedFiles = m_lookup.GetFilesInfo();
+    } else {
+        // everything is parsed again, rebuild the class cache as we go
+        m_lookup.ClearClassCache();
+    }
+
+    // FileExtManager initializes itself on first use: do it before starting the workers
+    FileExtManager::Init();
+
+    std::mutex mutex;
+    std::condition_variable cv_pending; // the writer waits for parsed files
+    std::condition_variable cv_space;   // the workers wait for the writer to store some files
+    std::deque<ParsedFile> pending;
+    size_t running_workers = 0;
+    std::atomic_bool stop{false};
+    std::atomic_size_t next_file{0};
+    std::atomic_size_t unchanged{0};
+    std::atomic_size_t skipped{0};
+    std::atomic_size_t failed{0};
+
+    auto worker_main = [&]() {
+        while (!stop.load()) {
+            size_t index = next_file.fetch_add(1);
+            if (index >= files.size()) {
+                break;
+            }
+
+            // Parse only valid PHP files that exist
+            wxFileName fnFile(files.Item(index));
+            time_t lastModifiedOnDisk = FileUtils::GetFileModificationTime(fnFile);
+            if (lastModifiedOnDisk == 0 ||
+                FileExtManager::GetType(fnFile.GetFullName()) != FileExtManager::TypePhp) {
+                ++skipped;
+                continue;
+            }
+
+            // Check to see if we need to re-parse this file
+            auto iter = parsedFiles.find(fnFile.GetFullPath());
+            bool known = iter != parsedFiles.end();
+            if (known && lastModifiedOnDisk <= iter->second.lastUpdated.ToLong()) {
+                ++unchanged;
+                continue;
+            }
+
+            wxString content;
+            if (!FileUtils::ReadFileContent(fnFile, content, wxConvISO8859_1)) {
+                clWARNING() << "PHP: Failed to read file:" << fnFile << "for parsing" << clEndl;
+                ++failed;
+                continue;
+            }
+
+            ParsedFile parsed;
+            parsed.filename = fnFile;
+            parsed.contentHash = GetContentHash(content);
+            if (!known || iter->second.contentHash != parsed.contentHash) {
+                parsed.source = std::make_unique<PHPSourceFile>(content, &m_lookup);
+                parsed.source->SetFilename(fnFile);
+                parsed.source->SetParseFunctionBody(m_parseFunctionBodies);
+                parsed.source->Parse();
+            }
+
+            std::unique_lock lock{mutex};
+            cv_space.wait(lock, [&]() { return pending.size() < MAX_PENDING_FILES || stop.load(); });
+            pending.push_back(std::move(parsed));
+            cv_pending.notify_one();
+        }
+
+        std::lock_guard lock{mutex};
+        --running_workers;
+        cv_pending.notify_one();
+    };
+
+    size_t workers_count = std::min(m_workers, std::max<size_t>(files.size(), 1));
+    running_workers = workers_count;
+    std::vector<std::thread> workers;
+    workers.reserve(workers_count);
+    for (size_t i = 0; i < workers_count; ++i) {
+        workers.emplace_back(worker_main);
+    }
+
+    wxSQLite3Database& db = m_lookup.Database();
+    try {
+        size_t in_transaction = 0;
+        size_t stored = 0;
+        db.Begin();
+        while (true) {
+            if (goingDown()) {
+                break;
+            }
+
+            ParsedFile parsed;
+            {
+                std::unique_lock lock{mutex};
+                cv_pending.wait(lock, [&]() { return !pending.empty() || running_workers == 0; });
+                if (pending.empty()) {
+                    break;
+                }
+                parsed = std::move(pending.front());
+                pending.pop_front();
+                cv_space.notify_one();
+            }
+
+            if (parsed.source) {
+                m_lookup.UpdateSourceFile(*parsed.source, false);
+                ++stats.parsed;
+            } else {
+                ++unchanged;
+            }
+            m_lookup.UpdateFileInfo(parsed.filename, parsed.contentHash);
+
+            if (++in_transaction >= m_batchSize) {
+                db.Commit();
+                db.Begin();
+                in_transaction = 0;
+            }
+
+            if (++stored % PROGRESS_EVENT_STEP == 0) {
+                SendParseEvent(wxPHP_PARSE_PROGRESS,
+                               files.size(),
+                               std::min(next_file.load(), files.size()),
+                               parsed.filename.GetFullPath());
+            }
+        }
+        db.Commit();
+
+    } catch (const wxSQLite3Exception& e) {
+        try {
+            db.Rollback();
+        } catch (...) {
+        }
+        clWARNING() << "PHPIndexer::Index:" << e.GetMessage() << clEndl;
+    }
+
+    stop.store(true);
+    {
+        std::lock_guard lock{mutex};
+        cv_space.notify_all();
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    stats.unchanged = unchanged.load();
+    stats.skipped = skipped.load();
+    stats.failed = failed.load();
+    stats.elapsedMs = sw.Time();
+
+    clDEBUG() << "PHP: indexed" << stats.files << "files in" << stats.elapsedMs << "ms." << stats.parsed << "parsed,"
+              << stats.unchanged << "unchanged," << stats.skipped << "skipped," << stats.failed << "failed" << clEndl;
+
+    // always make sure that the end event is sent
+    SendParseEvent(wxPHP_PARSE_ENDED, files.size(), files.size());
+    return stats;
+}
@@ -0,0 +1,71 @@
+#ifndef PHPINDEXER_H
+#define PHPINDEXER_H
+
+#include "PHPLookupTable.h"
+#include "codelite_exports.h"
+
+#include <functional>
+#include <wx/arrstr.h>
+#include <wx/longlong.h>
+
+/**
+ * @class PHPIndexer
+ * @brief (re)index a list of PHP files into a PHPLookupTable.
+ *
+ * The files are read and parsed by a pool of worker threads. The parsed files are stored by the calling thread, the
+ * only one writing to the database, in batches of files per transaction.
+ */
+class WXDLLIMPEXP_CL PHPIndexer
+{
+public:
+    struct Stats {
+        size_t files = 0;     ///< number of files in the request
+        size_t parsed = 0;    ///< parsed and stored
+        size_t unchanged = 0; ///< same modification time or same content as the last time they were parsed
+        size_t skipped = 0;   ///< missing or not PHP files
+        size_t failed = 0;    ///< could not be read
+        long elapsedMs = 0;
+    };
+
+    using GoingDownFunc = std::function<bool()>;
+
+public:
+    explicit PHPIndexer(PHPLookupTable& lookup);
+    ~PHPIndexer() = default;
+
+    /**
+     * @brief number of parser threads. By default, one less than the number of cores
+     */
+    void SetWorkers(size_t workers) { m_workers = workers ? workers : 1; }
+    size_t GetWorkers() const { return m_workers; }
+
+    /**
+     * @brief number of files stored per transaction
+     */
+    void SetBatchSize(size_t batchSize) { m_batchSize = batchSize ? batchSize : 1; }
+    void SetParseFunctionBodies(bool parseFunctionBodies) { m_parseFunctionBodies = parseFunctionBodies; }
+
+    /**
+     * @brief index `files`. In kUpdateMode_Fast mode, a file is parsed only if it was modified since it was last
+     * parsed and its content changed.
+     */
+    Stats Index(const wxArrayString& files, PHPLookupTable::eUpdateMode updateMode, const GoingDownFunc& goingDown);
+
+    /**
+     * @brief collect the PHP files under `folders`, one thread per folder
+     */
+    static wxArrayString CollectFiles(const wxArrayString& folders);
+
+    /**
+     * @brief a hash of the file content, stable across sessions
+     */
+    static wxLongLong GetContentHash(const wxString& content);
+
+private:
+    PHPLookupTable& m_lookup;
+    size_t m_workers = 1;
+    size_t m_batchSize = 1000;
+    bool m_parseFunctionBodies = true;
+};
+
+#endif // PHPINDEXER_H
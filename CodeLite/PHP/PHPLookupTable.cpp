@@ -5,6 +5,7 @@
 #include "PHPEntityFunctionAlias.h"
 #include "PHPEntityNamespace.h"
 #include "PHPEntityVariable.h"
+#include "PHPIndexer.h"
 #include "file_logger.h"
 #include "fileutils.h"
 
@@ -17,7 +18,16 @@ wxDEFINE_EVENT(wxPHP_PARSE_STARTED, clParseEvent);
 wxDEFINE_EVENT(wxPHP_PARSE_ENDED, clParseEvent);
 wxDEFINE_EVENT(wxPHP_PARSE_PROGRESS, clParseEvent);
 
-static wxString PHP_SCHEMA_VERSION = "9.3.0.1";
+static wxString PHP_SCHEMA_VERSION = "9.3.0.3";
+
+// the trigram index can not look for shorter strings
+static constexpr size_t TRIGRAM_MIN_LENGTH = 3;
+// scopes with fewer entries are scanned instead of using the trigram index
+static constexpr int SMALL_SCOPE_SIZE = 2000;
+
+// the tables with a trigram index on their NAME and FULLNAME columns
+static const std::vector<wxString> TRIGRAM_INDEXED_TABLES = {"SCOPE_TABLE", "FUNCTION_TABLE", "FUNCTION_ALIAS_TABLE",
+                                                             "VARIABLES_TABLE"};
 
 //------------------------------------------------
 // Metadata table
@@ -54,6 +64,11 @@ const static wxString CREATE_SCOPE_TABLE_SQL_IDX4 =
     "CREATE INDEX IF NOT EXISTS SCOPE_TABLE_IDX_4 ON SCOPE_TABLE(SCOPE_TYPE)";
 const static wxString CREATE_SCOPE_TABLE_SQL_IDX5 =
     "CREATE UNIQUE INDEX IF NOT EXISTS SCOPE_TABLE_IDX_5 ON SCOPE_TABLE(FULLNAME)";
+// the NOCASE indexes serve the "starts with" queries: LIKE is case insensitive
+const static wxString CREATE_SCOPE_TABLE_SQL_IDX6 =
+    "CREATE INDEX IF NOT EXISTS SCOPE_TABLE_IDX_6 ON SCOPE_TABLE(SCOPE_ID, NAME COLLATE NOCASE)";
+const static wxString CREATE_SCOPE_TABLE_SQL_IDX7 =
+    "CREATE INDEX IF NOT EXISTS SCOPE_TABLE_IDX_7 ON SCOPE_TABLE(NAME COLLATE NOCASE)";
 
 //------------------------------------------------
 // Function table
@@ -81,6 +96,10 @@ const static wxString CREATE_FUNCTION_TABLE_SQL_IDX4 =
     "CREATE INDEX IF NOT EXISTS FUNCTION_TABLE_IDX_4 ON FUNCTION_TABLE(NAME)";
 const static wxString CREATE_FUNCTION_TABLE_SQL_IDX5 =
     "CREATE INDEX IF NOT EXISTS FUNCTION_TABLE_IDX_5 ON FUNCTION_TABLE(LINE_NUMBER)";
+const static wxString CREATE_FUNCTION_TABLE_SQL_IDX6 =
+    "CREATE INDEX IF NOT EXISTS FUNCTION_TABLE_IDX_6 ON FUNCTION_TABLE(SCOPE_ID, NAME COLLATE NOCASE)";
+const static wxString CREATE_FUNCTION_TABLE_SQL_IDX7 =
+    "CREATE INDEX IF NOT EXISTS FUNCTION_TABLE_IDX_7 ON FUNCTION_TABLE(NAME COLLATE NOCASE)";
 
 //------------------------------------------------
 // Function Alias table
@@ -103,6 +122,8 @@ const static wxString CREATE_FUNCTION_ALIAS_TABLE_SQL_IDX3 =
     "CREATE INDEX IF NOT EXISTS FUNCTION_ALIAS_TABLE_IDX_3 ON FUNCTION_ALIAS_TABLE(REALNAME)";
 const static wxString CREATE_FUNCTION_ALIAS_TABLE_SQL_IDX4 =
     "CREATE UNIQUE INDEX IF NOT EXISTS FUNCTION_ALIAS_TABLE_IDX_4 ON FUNCTION_ALIAS_TABLE(NAME,REALNAME,SCOPE_ID)";
+const static wxString CREATE_FUNCTION_ALIAS_TABLE_SQL_IDX5 =
+    "CREATE INDEX IF NOT EXISTS FUNCTION_ALIAS_TABLE_IDX_5 ON FUNCTION_ALIAS_TABLE(SCOPE_ID, NAME COLLATE NOCASE)";
 
 //------------------------------------------------
 // Variables table
@@ -129,6 +150,8 @@ const static wxString CREATE_VARIABLES_TABLE_SQL_IDX3 =
     "CREATE INDEX IF NOT EXISTS VARIABLES_TABLE_IDX_3 ON VARIABLES_TABLE(FILE_NAME)";
 const static wxString CREATE_VARIABLES_TABLE_SQL_IDX4 =
     "CREATE INDEX IF NOT EXISTS VARIABLES_TABLE_IDX_4 ON VARIABLES_TABLE(FUNCTION_ID)";
+const static wxString CREATE_VARIABLES_TABLE_SQL_IDX5 =
+    "CREATE INDEX IF NOT EXISTS VARIABLES_TABLE_IDX_5 ON VARIABLES_TABLE(SCOPE_ID, NAME COLLATE NOCASE)";
 
 //------------------------------------------------
 // Variables table
@@ -151,8 +174,9 @@ const static wxString CREATE_PHPDOC_VAR_TABLE_SQL_IDX2 =
 //------------------------------------------------
 const static wxString CREATE_FILES_TABLE_SQL =
     "CREATE TABLE IF NOT EXISTS FILES_TABLE(ID INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT, "
-    "FILE_NAME TEXT, "                        // for global variable or class member this will be the scope_id parent id
-    "LAST_UPDATED INTEGER NOT NULL DEFAULT 0" // for function argument
+    "FILE_NAME TEXT, "                         // for global variable or class member this will be the scope_id parent id
+    "LAST_UPDATED INTEGER NOT NULL DEFAULT 0, " // for function argument
+    "CONTENT_HASH INTEGER NOT NULL DEFAULT 0"   // the hash of the file content when it was parsed
     ")";
 const static wxString CREATE_FILES_TABLE_SQL_IDX1 =
     "CREATE UNIQUE INDEX IF NOT EXISTS FILES_TABLE_IDX_1 ON FILES_TABLE(FILE_NAME)";
@@ -253,6 +277,10 @@ void PHPLookupTable::CreateSchema()
         sql = wxT("PRAGMA temp_store = MEMORY;");
         m_db.ExecuteUpdate(sql);
 
+        // "REPLACE INTO" must fire the delete triggers that update the trigram indexes
+        sql = wxT("PRAGMA recursive_triggers = ON;");
+        m_db.ExecuteUpdate(sql);
+
         wxSQLite3Statement st =
             m_db.PrepareStatement("select SCHEMA_VERSION from METADATA_TABLE where SCHEMA_NAME=:SCHEMA_NAME");
         st.Bind(st.GetParamIndex(":SCHEMA_NAME"), "CODELITEPHP");
@@ -273,6 +301,14 @@ void PHPLookupTable::CreateSchema()
         m_db.ExecuteUpdate("drop table if exists VARIABLES_TABLE");
         m_db.ExecuteUpdate("drop table if exists FILES_TABLE");
         m_db.ExecuteUpdate("drop table if exists PHPDOC_VAR_TABLE");
+        for (const wxString& table : TRIGRAM_INDEXED_TABLES) {
+            try {
+                m_db.ExecuteUpdate("drop table if exists " + table + "_FTS");
+            } catch (const wxSQLite3Exception& e) {
+                // this sqlite library does not support FTS5
+                wxUnusedVar(e);
+            }
+        }
     }
 
     try {
@@ -288,6 +324,8 @@ void PHPLookupTable::CreateSchema()
         m_db.ExecuteUpdate(CREATE_SCOPE_TABLE_SQL_IDX3);
         m_db.ExecuteUpdate(CREATE_SCOPE_TABLE_SQL_IDX4);
         m_db.ExecuteUpdate(CREATE_SCOPE_TABLE_SQL_IDX5);
+        m_db.ExecuteUpdate(CREATE_SCOPE_TABLE_SQL_IDX6);
+        m_db.ExecuteUpdate(CREATE_SCOPE_TABLE_SQL_IDX7);
 
         // function table
         m_db.ExecuteUpdate(CREATE_FUNCTION_TABLE_SQL);
@@ -296,6 +334,8 @@ void PHPLookupTable::CreateSchema()
         m_db.ExecuteUpdate(CREATE_FUNCTION_TABLE_SQL_IDX3);
         m_db.ExecuteUpdate(CREATE_FUNCTION_TABLE_SQL_IDX4);
         m_db.ExecuteUpdate(CREATE_FUNCTION_TABLE_SQL_IDX5);
+        m_db.ExecuteUpdate(CREATE_FUNCTION_TABLE_SQL_IDX6);
+        m_db.ExecuteUpdate(CREATE_FUNCTION_TABLE_SQL_IDX7);
 
         // function alias table
         m_db.ExecuteUpdate(CREATE_FUNCTION_ALIAS_TABLE_SQL);
@@ -303,6 +343,7 @@ void PHPLookupTable::CreateSchema()
         m_db.ExecuteUpdate(CREATE_FUNCTION_ALIAS_TABLE_SQL_IDX2);
         m_db.ExecuteUpdate(CREATE_FUNCTION_ALIAS_TABLE_SQL_IDX3);
         m_db.ExecuteUpdate(CREATE_FUNCTION_ALIAS_TABLE_SQL_IDX4);
+        m_db.ExecuteUpdate(CREATE_FUNCTION_ALIAS_TABLE_SQL_IDX5);
 
         // variables (function args, globals class members and consts)
         m_db.ExecuteUpdate(CREATE_VARIABLES_TABLE_SQL);
@@ -310,6 +351,7 @@ void PHPLookupTable::CreateSchema()
         m_db.ExecuteUpdate(CREATE_VARIABLES_TABLE_SQL_IDX2);
         m_db.ExecuteUpdate(CREATE_VARIABLES_TABLE_SQL_IDX3);
         m_db.ExecuteUpdate(CREATE_VARIABLES_TABLE_SQL_IDX4);
+        m_db.ExecuteUpdate(CREATE_VARIABLES_TABLE_SQL_IDX5);
 
         // phpdoc var table
         m_db.ExecuteUpdate(CREATE_PHPDOC_VAR_TABLE_SQL);
@@ -320,6 +362,24 @@ void PHPLookupTable::CreateSchema()
         m_db.ExecuteUpdate(CREATE_FILES_TABLE_SQL);
         m_db.ExecuteUpdate(CREATE_FILES_TABLE_SQL_IDX1);
 
+        // Trigram indexes, for the "contains" lookups. They require sqlite 3.34 or later, built with FTS5
+        try {
+            for (const wxString& table : TRIGRAM_INDEXED_TABLES) {
+                DoCreateTrigramIndex(table);
+            }
+            m_hasTrigramIndex = true;
+
+        } catch (const wxSQLite3Exception& e) {
+            clDEBUG() << "PHP: trigram indexes are not available, using LIKE queries." << e.GetMessage() << clEndl;
+            m_hasTrigramIndex = false;
+            // the triggers would fail every update
+            for (const wxString& table : TRIGRAM_INDEXED_TABLES) {
+                m_db.ExecuteUpdate("DROP TRIGGER IF EXISTS " + table + "_FTS_INSERT");
+                m_db.ExecuteUpdate("DROP TRIGGER IF EXISTS " + table + "_FTS_DELETE");
+                m_db.ExecuteUpdate("DROP TRIGGER IF EXISTS " + table + "_FTS_UPDATE");
+            }
+        }
+
         // Update the schema version
         wxSQLite3Statement st =
             m_db.PrepareStatement("replace into METADATA_TABLE (ID, SCHEMA_NAME, SCHEMA_VERSION) VALUES (NULL, "
@@ -333,6 +393,30 @@ void PHPLookupTable::CreateSchema()
     }
 }
 
+void PHPLookupTable::DoCreateTrigramIndex(const wxString& tableName)
+{
+    // an external content table: the index does not keep a copy of the names
+    wxString fts = tableName + "_FTS";
+    bool exists = m_db.TableExists(fts);
+    m_db.ExecuteUpdate("CREATE VIRTUAL TABLE IF NOT EXISTS " + fts + " USING fts5(NAME, FULLNAME, content='" +
+                       tableName + "', content_rowid='ID', tokenize='trigram', detail='none')");
+
+    m_db.ExecuteUpdate("CREATE TRIGGER IF NOT EXISTS " + fts + "_INSERT AFTER INSERT ON " + tableName + " BEGIN " +
+                       "INSERT INTO " + fts + "(rowid, NAME, FULLNAME) VALUES (new.ID, new.NAME, new.FULLNAME); END");
+    m_db.ExecuteUpdate("CREATE TRIGGER IF NOT EXISTS " + fts + "_DELETE AFTER DELETE ON " + tableName + " BEGIN " +
+                       "INSERT INTO " + fts + "(" + fts +
+                       ", rowid, NAME, FULLNAME) VALUES ('delete', old.ID, old.NAME, old.FULLNAME); END");
+    m_db.ExecuteUpdate("CREATE TRIGGER IF NOT EXISTS " + fts + "_UPDATE AFTER UPDATE ON " + tableName + " BEGIN " +
+                       "INSERT INTO " + fts + "(" + fts +
+                       ", rowid, NAME, FULLNAME) VALUES ('delete', old.ID, old.NAME, old.FULLNAME); " +
+                       "INSERT INTO " + fts + "(rowid, NAME, FULLNAME) VALUES (new.ID, new.NAME, new.FULLNAME); END");
+
+    if (!exists) {
+        // the table was filled by a sqlite library without FTS5
+        m_db.ExecuteUpdate("INSERT INTO " + fts + "(" + fts + ") VALUES ('rebuild')");
+    }
+}
+
 void PHPLookupTable::UpdateSourceFile(PHPSourceFile& source, bool autoCommit)
 {
     try {
@@ -665,36 +749,116 @@ PHPEntityBase::List_t PHPLookupTable::LoadFunctionArguments(wxLongLong parentId)
 
 wxString PHPLookupTable::EscapeWildCards(const wxString& str)
 {
+    // '^' is the escape character of the LIKE patterns
     wxString s(str);
+    s.Replace(wxT("^"), wxT("^^"));
+    s.Replace(wxT("%"), wxT("^%"));
     s.Replace(wxT("_"), wxT("^_"));
     return s;
 }
 
 void PHPLookupTable::DoAddLimit(wxString& sql) { sql << " LIMIT " << m_sizeLimit; }
 
-void PHPLookupTable::DoAddNameFilter(wxString& sql, const wxString& nameHint, size_t flags)
+wxString PHPLookupTable::EscapeQuotes(const wxString& str)
 {
-    wxString name = nameHint;
-    name.Trim().Trim(false);
+    wxString s(str);
+    s.Replace("'", "''");
+    return s;
+}
 
-    if (name.IsEmpty()) {
-        sql.Trim();
-        if (sql.EndsWith("AND") || sql.EndsWith("and")) {
-            sql.RemoveLast(3);
+void PHPLookupTable::DoSelectRanked(const std::vector<wxString>& queries, const RowCallback& onRow)
+{
+    size_t count = 0;
+    for (const wxString& query : queries) {
+        if (count >= m_sizeLimit) {
+            break;
+        }
+
+        wxString sql = query;
+        sql << " LIMIT " << (m_sizeLimit - count);
+        wxSQLite3Statement st = m_db.PrepareStatement(sql);
+        wxSQLite3ResultSet res = st.ExecuteQuery();
+        while (res.NextRow()) {
+            onRow(res);
+            ++count;
         }
-        sql << " ";
-        return;
     }
+}
 
-    if (flags & kLookupFlags_ExactMatch && !name.IsEmpty()) {
-        sql << " NAME = '" << name << "'";
+bool PHPLookupTable::DoUseTrigramIndex(const wxString& tableName, const wxString& filter, const wxString& name)
+{
+    if (!m_hasTrigramIndex || name.length() < TRIGRAM_MIN_LENGTH) {
+        return false;
+    }
 
-    } else if (flags & kLookupFlags_Contains && !name.IsEmpty()) {
-        sql << " NAME LIKE '%%" << EscapeWildCards(name) << "%%' ESCAPE '^'";
+    if (filter.IsEmpty()) {
+        return true;
+    }
+
+    // the trigram index visits the matching entries of the whole table
+    wxString sql;
+    sql << "SELECT COUNT(*) FROM (SELECT 1 FROM " << tableName << " WHERE " << filter << " LIMIT " << SMALL_SCOPE_SIZE
+        << ")";
+    return m_db.ExecuteScalar(sql) >= SMALL_SCOPE_SIZE;
+}
 
-    } else if (flags & kLookupFlags_StartsWith && !name.IsEmpty()) {
-        sql << " NAME LIKE '" << EscapeWildCards(name) << "%%' ESCAPE '^'";
+void PHPLookupTable::DoSelectByName(const wxString& tableName,
+                                    const wxString& filter,
+                                    const wxString& nameHint,
+                                    size_t flags,
+                                    const RowCallback& onRow)
+{
+    wxString name = nameHint;
+    name.Trim().Trim(false);
+
+    wxString select;
+    select << "SELECT * FROM " << tableName << " WHERE ";
+    if (!filter.IsEmpty()) {
+        select << filter << " AND ";
+    }
+
+    std::vector<wxString> queries;
+    if (name.IsEmpty()) {
+        if (filter.IsEmpty()) {
+            queries.push_back("SELECT * FROM " + tableName);
+        } else {
+            queries.push_back("SELECT * FROM " + tableName + " WHERE " + filter);
+        }
+
+    } else if (flags & kLookupFlags_ExactMatch) {
+        queries.push_back(select + "NAME = '" + EscapeQuotes(name) + "'");
+
+    } else if (flags & (kLookupFlags_Contains | kLookupFlags_StartsWith)) {
+        // the column names are qualified, for the join with the trigram index
+        wxString column = tableName + ".NAME";
+        wxString literal = EscapeQuotes(name);
+        wxString pattern = EscapeWildCards(literal);
+        wxString startsWith = column + " LIKE '" + pattern + "%' ESCAPE '^'";
+
+        // the exact match (ignoring case) and the names starting with the hint come from the NOCASE indexes
+        queries.push_back(select + column + " = '" + literal + "' COLLATE NOCASE");
+        queries.push_back(select + startsWith + " AND " + column + " != '" + literal + "' COLLATE NOCASE");
+
+        if (flags & kLookupFlags_Contains) {
+            wxString contains = column + " LIKE '%" + pattern + "%' ESCAPE '^' AND NOT " + startsWith;
+            if (DoUseTrigramIndex(tableName, filter, name)) {
+                // the trigram index returns the candidates, LIKE ('_' is a wildcard there) checks them
+                wxString fts = tableName + "_FTS";
+                wxString sql;
+                sql << "SELECT " << tableName << ".* FROM " << fts << " CROSS JOIN " << tableName << " ON "
+                    << tableName << ".ID = " << fts << ".rowid WHERE " << fts << ".NAME LIKE '%" << literal
+                    << "%' AND ";
+                if (!filter.IsEmpty()) {
+                    sql << filter << " AND ";
+                }
+                sql << contains;
+                queries.push_back(sql);
+            } else {
+                queries.push_back(select + contains);
+            }
+        }
     }
+    DoSelectRanked(queries, onRow);
 }
 
 void PHPLookupTable::LoadAllByFilter(PHPEntityBase::List_t& matches, const wxString& nameHint, eLookupFlags flags)
@@ -734,22 +898,36 @@ void PHPLookupTable::LoadFromTableByNameHint(PHPEntityBase::List_t& matches,
         return;
     }
 
-    // Build the filter query
-    wxString filterQuery = "where ";
-    wxString sql;
-    for (size_t i = 0; i < parts.size(); ++i) {
-        wxString tmpName = parts.Item(i);
-        tmpName.Replace(wxT("_"), wxT("^_"));
-        filterQuery << "fullname like '%%" << tmpName << "%%' " << ((i == (parts.size() - 1)) ? "" : "AND ");
+    // every part must be found in the fullname
+    wxString filter;
+    wxString longest;
+    for (const wxString& part : parts) {
+        filter << (filter.IsEmpty() ? "" : " AND ") << tableName << ".FULLNAME LIKE '%"
+               << EscapeWildCards(EscapeQuotes(part)) << "%' ESCAPE '^'";
+        if (part.length() > longest.length()) {
+            longest = part;
+        }
     }
-    sql << "select * from " << tableName << " " << filterQuery << " ESCAPE '^' ";
-    DoAddLimit(sql);
 
-    try {
-        wxSQLite3Statement st = m_db.PrepareStatement(sql);
-        wxSQLite3ResultSet res = st.ExecuteQuery();
+    // the entries whose name starts with the longest part first
+    wxString startsWith;
+    startsWith << tableName << ".NAME LIKE '" << EscapeWildCards(EscapeQuotes(longest)) << "%' ESCAPE '^'";
 
-        while (res.NextRow()) {
+    std::vector<wxString> queries;
+    queries.push_back("SELECT * FROM " + tableName + " WHERE " + startsWith + " AND " + filter);
+    if (DoUseTrigramIndex(tableName, wxEmptyString, longest)) {
+        wxString fts = tableName + "_FTS";
+        wxString sql;
+        sql << "SELECT " << tableName << ".* FROM " << fts << " CROSS JOIN " << tableName << " ON " << tableName
+            << ".ID = " << fts << ".rowid WHERE " << fts << ".FULLNAME LIKE '%" << EscapeQuotes(longest)
+            << "%' AND " << filter << " AND NOT " << startsWith;
+        queries.push_back(sql);
+    } else {
+        queries.push_back("SELECT * FROM " + tableName + " WHERE " + filter + " AND NOT " + startsWith);
+    }
+
+    try {
+        DoSelectRanked(queries, [&](wxSQLite3ResultSet& res) {
             ePhpScopeType st = kPhpScopeTypeAny;
             if (tableName == "SCOPE_TABLE") {
                 st =
@@ -761,9 +939,9 @@ void PHPLookupTable::LoadFromTableByNameHint(PHPEntityBase::List_t& matches,
                 match->FromResultSet(res);
                 matches.push_back(match);
             }
-        }
+        });
     } catch (const wxSQLite3Exception& e) {
-        clWARNING() << "PHPLookupTable::LoadFromTableByNameHint:" << sql << ":" << e.GetMessage() << clEndl;
+        clWARNING() << "PHPLookupTable::LoadFromTableByNameHint:" << tableName << ":" << e.GetMessage() << clEndl;
     }
 }
 
@@ -839,7 +1017,7 @@ void PHPLookupTable::Close()
             m_db.Close();
         }
         m_filename.Clear();
-        m_allClasses.clear();
+        ClearClassCache();
 
     } catch (const wxSQLite3Exception& e) {
         clWARNING() << "PHPLookupTable::Close" << e.GetMessage() << endl;
@@ -854,105 +1032,71 @@ void PHPLookupTable::DoFindChildren(PHPEntityBase::List_t& matches,
                                     const wxString& nameHint)
 {
     // Find members of of parentDbID
+    wxString scopeFilter;
+    scopeFilter << "SCOPE_ID=" << parentId;
     try {
         // Load classes
         if (!(flags & kLookupFlags_FunctionsAndConstsOnly)) {
-            wxString sql;
-            sql << "SELECT * from SCOPE_TABLE WHERE SCOPE_ID=" << parentId << " AND SCOPE_TYPE = 1 AND ";
-            DoAddNameFilter(sql, nameHint, flags);
-            DoAddLimit(sql);
-
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
-            while (res.NextRow()) {
+            wxString classFilter = scopeFilter + " AND SCOPE_TYPE = 1";
+            DoSelectByName("SCOPE_TABLE", classFilter, nameHint, flags, [&](wxSQLite3ResultSet& res) {
                 PHPEntityBase::Ptr_t match(new PHPEntityClass());
                 match->FromResultSet(res);
                 matches.push_back(match);
-            }
+            });
         }
 
-        {
-            // load functions
-            wxString sql;
-            sql << "SELECT * from FUNCTION_TABLE WHERE SCOPE_ID=" << parentId << " AND ";
-            DoAddNameFilter(sql, nameHint, flags);
-            DoAddLimit(sql);
-
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
+        // load functions
+        DoSelectByName("FUNCTION_TABLE", scopeFilter, nameHint, flags, [&](wxSQLite3ResultSet& res) {
+            PHPEntityBase::Ptr_t match(new PHPEntityFunction());
+            match->FromResultSet(res);
+            bool isStaticFunction = match->HasFlag(kFunc_Static);
+            if (isStaticFunction) {
+                // always return static functions
+                matches.push_back(match);
 
-            while (res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityFunction());
-                match->FromResultSet(res);
-                bool isStaticFunction = match->HasFlag(kFunc_Static);
-                if (isStaticFunction) {
-                    // always return static functions
+            } else {
+                // Non static function.
+                if (!(flags & kLookupFlags_Static)) {
                     matches.push_back(match);
-
-                } else {
-                    // Non static function.
-                    if (!(flags & kLookupFlags_Static)) {
-                        matches.push_back(match);
-                    }
                 }
             }
-        }
+        });
 
-        {
-            // load function aliases
-            wxString sql;
-            sql << "SELECT * from FUNCTION_ALIAS_TABLE WHERE SCOPE_ID=" << parentId << " AND ";
-            DoAddNameFilter(sql, nameHint, flags);
-            DoAddLimit(sql);
-
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-            while (res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityFunctionAlias());
-                match->FromResultSet(res);
-                const wxString& realFuncName = match->Cast<PHPEntityFunctionAlias>()->GetRealname();
-                // Load the function pointed by this reference
-                PHPEntityBase::Ptr_t pFunc = FindFunction(realFuncName);
-                if (pFunc) {
-                    // Keep the reference to the real function
-                    match->Cast<PHPEntityFunctionAlias>()->SetFunc(pFunc);
-                    matches.push_back(match);
-                }
+        // load function aliases
+        DoSelectByName("FUNCTION_ALIAS_TABLE", scopeFilter, nameHint, flags, [&](wxSQLite3ResultSet& res) {
+            PHPEntityBase::Ptr_t match(new PHPEntityFunctionAlias());
+            match->FromResultSet(res);
+            const wxString& realFuncName = match->Cast<PHPEntityFunctionAlias>()->GetRealname();
+            // Load the function pointed by this reference
+            PHPEntityBase::Ptr_t pFunc = FindFunction(realFuncName);
+            if (pFunc) {
+                // Keep the reference to the real function
+                match->Cast<PHPEntityFunctionAlias>()->SetFunc(pFunc);
+                matches.push_back(match);
             }
-        }
+        });
 
-        {
-            // Add members from the variables table
-            wxString sql;
-            sql << "SELECT * from VARIABLES_TABLE WHERE SCOPE_ID=" << parentId << " AND ";
-            DoAddNameFilter(sql, nameHint, flags);
-            DoAddLimit(sql);
-
-            wxSQLite3Statement st = m_db.PrepareStatement(sql);
-            wxSQLite3ResultSet res = st.ExecuteQuery();
-
-            while (res.NextRow()) {
-                PHPEntityBase::Ptr_t match(new PHPEntityVariable());
-                match->FromResultSet(res);
+        // Add members from the variables table
+        DoSelectByName("VARIABLES_TABLE", scopeFilter, nameHint, flags, [&](wxSQLite3ResultSet& res) {
+            PHPEntityBase::Ptr_t match(new PHPEntityVariable());
+            match->FromResultSet(res);
 
-                if (flags & kLookupFlags_FunctionsAndConstsOnly) {
-                    // Filter non consts from the list
-                    if (!match->Cast<PHPEntityVariable>()->IsConst() && !match->Cast<PHPEntityVariable>()->IsDefine()) {
-                        continue;
-                    }
+            if (flags & kLookupFlags_FunctionsAndConstsOnly) {
+                // Filter non consts from the list
+                if (!match->Cast<PHPEntityVariable>()->IsConst() && !match->Cast<PHPEntityVariable>()->IsDefine()) {
+                    return;
                 }
+            }
 
-                bool isConst = match->Cast<PHPEntityVariable>()->IsConst();
-                bool isStatic = match->Cast<PHPEntityVariable>()->IsStatic();
-                bool bAddIt = ((isStatic || isConst) && CollectingStatics(flags)) ||
-                              (!isStatic && !isConst && !CollectingStatics(flags));
-                if (bAddIt) {
-                    matches.push_back(match);
-                }
+            bool isConst = match->Cast<PHPEntityVariable>()->IsConst();
+            bool isStatic = match->Cast<PHPEntityVariable>()->IsStatic();
+            bool bAddIt = ((isStatic || isConst) && CollectingStatics(flags)) ||
+                          (!isStatic && !isConst && !CollectingStatics(flags));
+            if (bAddIt) {
+                matches.push_back(match);
             }
-            DoFixVarsDocComment(matches, parentId);
-        }
+        });
+        DoFixVarsDocComment(matches, parentId);
 
     } catch (const wxSQLite3Exception& e) {
         clWARNING() << "PHPLookupTable::FindChildren" << e.GetMessage() << endl;
@@ -989,6 +1133,49 @@ void PHPLookupTable::UpdateFileLastParsedTimestamp(const wxFileName& filename)
     }
 }
 
+std::unordered_map<wxString, PHPLookupTable::FileInfo> PHPLookupTable::GetFilesInfo()
+{
+    std::unordered_map<wxString, FileInfo> files;
+    try {
+        wxSQLite3ResultSet res = m_db.ExecuteQuery("SELECT FILE_NAME, LAST_UPDATED, CONTENT_HASH FROM FILES_TABLE");
+        while (res.NextRow()) {
+            FileInfo info;
+            info.lastUpdated = res.GetInt64("LAST_UPDATED");
+            info.contentHash = res.GetInt64("CONTENT_HASH");
+            files.insert({res.GetString("FILE_NAME"), info});
+        }
+    } catch (const wxSQLite3Exception& e) {
+        clWARNING() << "PHPLookupTable::GetFilesInfo" << e.GetMessage() << endl;
+    }
+    return files;
+}
+
+void PHPLookupTable::UpdateFileInfo(const wxFileName& filename, wxLongLong contentHash)
+{
+    try {
+        wxSQLite3Statement st = m_db.PrepareStatement("REPLACE INTO FILES_TABLE (ID, FILE_NAME, LAST_UPDATED, "
+                                                      "CONTENT_HASH) VALUES (NULL, :FILE_NAME, :LAST_UPDATED, "
+                                                      ":CONTENT_HASH)");
+        st.Bind(st.GetParamIndex(":FILE_NAME"), filename.GetFullPath());
+        st.Bind(st.GetParamIndex(":LAST_UPDATED"), (wxLongLong)time(NULL));
+        st.Bind(st.GetParamIndex(":CONTENT_HASH"), contentHash);
+        st.ExecuteUpdate();
+
+    } catch (const wxSQLite3Exception& e) {
+        clWARNING() << "PHPLookupTable::UpdateFileInfo" << e.GetMessage() << endl;
+    }
+}
+
+void PHPLookupTable::RecreateSymbolsDatabase(const wxArrayString& files,
+                                             eUpdateMode updateMode,
+                                             const std::function<bool()>& goingDown,
+                                             bool parseFuncBodies)
+{
+    PHPIndexer indexer(*this);
+    indexer.SetParseFunctionBodies(parseFuncBodies);
+    indexer.Index(files, updateMode, goingDown);
+}
+
 void PHPLookupTable::ClearAll(bool autoCommit)
 {
     try {
@@ -1314,18 +1501,27 @@ void PHPLookupTable::DoFixVarsDocComment(PHPEntityBase::List_t& matches, wxLongL
 
 void PHPLookupTable::UpdateClassCache(const wxString& classname)
 {
-    if (m_allClasses.count(classname) == 0) {
-        m_allClasses.insert(classname);
-    }
+    std::lock_guard lock{m_allClassesMutex};
+    m_allClasses.insert(classname);
 }
 
-bool PHPLookupTable::ClassExists(const wxString& classname) const { return m_allClasses.count(classname) != 0; }
+bool PHPLookupTable::ClassExists(const wxString& classname) const
+{
+    std::lock_guard lock{m_allClassesMutex};
+    return m_allClasses.count(classname) != 0;
+}
+
+void PHPLookupTable::ClearClassCache()
+{
+    std::lock_guard lock{m_allClassesMutex};
+    m_allClasses.clear();
+}
 
 void PHPLookupTable::RebuildClassCache()
 {
     // locate the scope
     clDEBUG() << "Rebuilding PHP class cache..." << clEndl;
-    m_allClasses.clear();
+    ClearClassCache();
     size_t count = 0;
     try {
         wxString sql;
@@ -35,7 +35,10 @@
 #include "fileextmanager.h"
 #include "fileutils.h"
 
+#include <functional>
+#include <mutex>
 #include <set>
+#include <unordered_map>
 #include <unordered_set>
 #include <vector>
 #include <wx/longlong.h>
@@ -64,6 +67,8 @@ class WXDLLIMPEXP_CL PHPLookupTable
     wxFileName m_filename;
     size_t m_sizeLimit;
     std::unordered_set<wxString> m_allClasses;
+    mutable std::mutex m_allClassesMutex; // the class cache is queried by the parser threads
+    bool m_hasTrigramIndex = false;       // the sqlite library supports FTS5 with the trigram tokenizer
 
 public:
     enum eLookupFlags {
@@ -88,11 +93,46 @@ public:
         kUpdateMode_Full,
     };
 
+    struct FileInfo {
+        wxLongLong lastUpdated = 0; // when the file was parsed
+        wxLongLong contentHash = 0; // see PHPIndexer::GetContentHash()
+    };
+
     static void DoSplitFullname(const wxString& fullname, wxString& ns, wxString& shortName);
 
 private:
+    using RowCallback = std::function<void(wxSQLite3ResultSet&)>;
+
     void EnsureIntegrity(const wxFileName& filename);
-    void DoAddNameFilter(wxString& sql, const wxString& nameHint, size_t flags);
+
+    /**
+     * @brief run "SELECT * FROM tableName WHERE filter" for the entries matching nameHint, best matches first: the
+     * exact match, then the names starting with nameHint and then the names containing it. At most m_sizeLimit rows
+     * are passed to onRow
+     * @param filter an SQL condition on the table columns, e.g. "SCOPE_ID=12". Can be empty
+     */
+    void DoSelectByName(const wxString& tableName,
+                        const wxString& filter,
+                        const wxString& nameHint,
+                        size_t flags,
+                        const RowCallback& onRow);
+
+    /**
+     * @brief run the queries, in order, until m_sizeLimit rows were passed to onRow
+     */
+    void DoSelectRanked(const std::vector<wxString>& queries, const RowCallback& onRow);
+
+    /**
+     * @brief should a "contains" query on tableName be driven by its trigram index? Small scopes are faster to
+     * scan
+     */
+    bool DoUseTrigramIndex(const wxString& tableName, const wxString& filter, const wxString& name);
+
+    /**
+     * @brief create the FTS5 trigram index of tableName NAME and FULLNAME columns, and the triggers that keep it
+     * up to date
+     */
+    void DoCreateTrigramIndex(const wxString& tableName);
 
     void CreateSchema();
     PHPEntityBase::Ptr_t
@@ -117,6 +157,11 @@ private:
      */
     wxString EscapeWildCards(const wxString& str);
 
+    /**
+     * @brief escape a string literal
+     */
+    wxString EscapeQuotes(const wxString& str);
+
     void DoAddLimit(wxString& sql);
 
     /**
@@ -177,12 +222,19 @@ public:
     void UpdateClassCache(const wxString& classname);
 
     /**
-     * @brief check if a class exists in the cache
+     * @brief check if a class exists in the cache. Can be called from any thread
      */
     bool ClassExists(const wxString& classname) const;
 
+    void ClearClassCache();
+
     void SetSizeLimit(size_t sizeLimit) { this->m_sizeLimit = sizeLimit; }
 
+    /**
+     * @brief are "contains" lookups served by a trigram index?
+     */
+    bool HasTrigramIndex() const { return m_hasTrigramIndex; }
+
     /**
      * @brief return list of functions from a given file
      */
@@ -275,14 +327,23 @@ public:
     void UpdateSourceFile(PHPSourceFile& source, bool autoCommit = true);
 
     /**
-     * @brief update list of source files
+     * @brief update list of source files. The files are parsed in parallel, see PHPIndexer
      */
-    template <typename GoindDownFunc>
     void RecreateSymbolsDatabase(const wxArrayString& files,
                                  eUpdateMode updateMode,
-                                 GoindDownFunc pFuncGoingDown,
+                                 const std::function<bool()>& goingDown,
                                  bool parseFuncBodies = true);
 
+    /**
+     * @brief return the parse time and content hash of all the files in the database, by file name
+     */
+    std::unordered_map<wxString, FileInfo> GetFilesInfo();
+
+    /**
+     * @brief mark `filename` as parsed now, with the given content hash
+     */
+    void UpdateFileInfo(const wxFileName& filename, wxLongLong contentHash);
+
     /**
      * @brief delete all entries belonged to filename.
      * @param filename the file name
@@ -302,113 +363,4 @@ public:
     wxSQLite3Database& Database() { return m_db; }
 };
 
-template <typename GoindDownFunc>
-void PHPLookupTable::RecreateSymbolsDatabase(const wxArrayString& files,
-                                             eUpdateMode updateMode,
-                                             GoindDownFunc pFuncGoingDown,
-                                             bool parseFuncBodies)
-{
-    try {
-
-        {
-            clParseEvent event(wxPHP_PARSE_STARTED);
-            event.SetTotalFiles(files.GetCount());
-            event.SetCurfileIndex(0);
-            EventNotifier::Get()->AddPendingEvent(event);
-        }
-
-        wxStopWatch sw;
-        sw.Start();
-
-        m_allClasses.clear(); // clear the cache
-        m_db.Begin();
-        for (size_t i = 0; i < files.GetCount(); ++i) {
-            if (pFuncGoingDown()) {
-                break;
-            }
-            {
-                clParseEvent event(wxPHP_PARSE_PROGRESS);
-                event.SetTotalFiles(files.GetCount());
-                event.SetCurfileIndex(i);
-                event.SetFileName(files.Item(i));
-                EventNotifier::Get()->AddPendingEvent(event);
-            }
-
-            wxFileName fnFile(files.Item(i));
-            bool reParseNeeded(true);
-
-            if (updateMode == kUpdateMode_Fast) {
-                // Check to see if we need to re-parse this file
-                // and store it to the database
-
-                if (!fnFile.Exists()) {
-                    reParseNeeded = false;
-                } else {
-                    time_t lastModifiedOnDisk = fnFile.GetModificationTime().GetTicks();
-                    wxLongLong lastModifiedInDB = GetFileLastParsedTimestamp(fnFile);
-                    if (lastModifiedOnDisk <= lastModifiedInDB.ToLong()) {
-                        reParseNeeded = false;
-                    }
-                }
-            }
-
-            // Ensure that the file exists
-            if (!fnFile.Exists()) {
-                reParseNeeded = false;
-            }
-
-            // Parse only valid PHP files
-            if (FileExtManager::GetType(fnFile.GetFullName()) != FileExtManager::TypePhp) {
-                reParseNeeded = false;
-            }
-
-            if (reParseNeeded) {
-                // For performance reasons, load the file into memory and then parse it
-                wxFileName fnSourceFile(files.Item(i));
-                wxString content;
-                if (!FileUtils::ReadFileContent(fnSourceFile, content, wxConvISO8859_1)) {
-                    clWARNING() << "PHP: Failed to read file:" << fnSourceFile << "for parsing" << clEndl;
-                    continue;
-                }
-                PHPSourceFile sourceFile(content, this);
-                sourceFile.SetFilename(fnSourceFile);
-                sourceFile.SetParseFunctionBody(parseFuncBodies);
-                sourceFile.Parse();
-                UpdateSourceFile(sourceFile, false);
-            }
-        }
-        m_db.Commit();
-        long elapsedMs = sw.Time();
-
-        LOG_IF_TRACE
-        {
-            clDEBUG1() << _("PHP: parsed ") << files.GetCount() << " in " << elapsedMs << " milliseconds" << clEndl;
-        }
-
-        {
-            clParseEvent event(wxPHP_PARSE_ENDED);
-            event.SetTotalFiles(files.GetCount());
-            event.SetCurfileIndex(files.GetCount());
-            EventNotifier::Get()->AddPendingEvent(event);
-        }
-
-    } catch (const wxSQLite3Exception& e) {
-        try {
-            m_db.Rollback();
-
-        } catch (...) {
-        }
-
-        {
-            // always make sure that the end event is sent
-            clParseEvent event(wxPHP_PARSE_ENDED);
-            event.SetTotalFiles(files.GetCount());
-            event.SetCurfileIndex(files.GetCount());
-            EventNotifier::Get()->AddPendingEvent(event);
-        }
-
-        clWARNING() << "PHPLookupTable::UpdateSourceFiles:" << e.GetMessage() << clEndl;
-    }
-}
-
 #endif // PHPLOOKUPTABLE_H
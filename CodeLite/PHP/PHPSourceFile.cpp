@@ -1489,31 +1489,14 @@ wxString PHPSourceFile::DoMakeIdentifierAbsolute(const wxString& type, bool exac
         return m_converter->MakeIdentifierAbsolute(type);
     }
 
-    static std::unordered_set<std::string> phpKeywords;
-    if (phpKeywords.empty()) {
+    // initialized once, even when files are parsed from several threads
+    static const std::unordered_set<std::string> phpKeywords = {
         // List taken from https://www.php.net/manual/en/language.types.intro.php
         // Native types
-        phpKeywords.insert("bool");
-        phpKeywords.insert("int");
-        phpKeywords.insert("float");
-        phpKeywords.insert("string");
-        phpKeywords.insert("array");
-        phpKeywords.insert("object");
-        phpKeywords.insert("iterable");
-        phpKeywords.insert("callable");
-        phpKeywords.insert("null");
-        phpKeywords.insert("mixed");
-        phpKeywords.insert("void");
+        "bool", "int", "float", "string", "array", "object", "iterable", "callable", "null", "mixed", "void",
         // Types that are common in documentation
-        phpKeywords.insert("boolean");
-        phpKeywords.insert("integer");
-        phpKeywords.insert("double");
-        phpKeywords.insert("real");
-        phpKeywords.insert("binery");
-        phpKeywords.insert("resource");
-        phpKeywords.insert("number");
-        phpKeywords.insert("callback");
-    }
+        "boolean", "integer", "double", "real", "binery", "resource", "number", "callback",
+    };
     wxString typeWithNS(type);
     typeWithNS.Trim().Trim(false);
 
@@ -106,6 +106,7 @@ private:
     std::string m_string;
     int m_commentStartLine;
     int m_commentEndLine;
+    int m_attributeDepth;
     bool m_insidePhp;
     FILE* m_fp;
 
@@ -117,6 +118,7 @@ public:
         }
         m_fp = NULL;
         m_insidePhp = false;
+        m_attributeDepth = 0;
         ClearComment();
         m_rawStringLabel.clear();
         m_string.clear();
@@ -126,6 +128,7 @@ public:
         : m_flags(options)
         , m_commentStartLine(wxNOT_FOUND)
         , m_commentEndLine(wxNOT_FOUND)
+        , m_attributeDepth(0)
         , m_insidePhp(false)
         , m_fp(NULL)
     {
@@ -133,6 +136,11 @@ public:
 
     ~phpLexerUserData() { Clear(); }
     void SetFp(FILE* fp) { this->m_fp = fp; }
+    /**
+     * @brief nesting level of the '[' inside a #[...] attribute
+     */
+    void SetAttributeDepth(int depth) { this->m_attributeDepth = depth; }
+    int GetAttributeDepth() const { return m_attributeDepth; }
     /**
      * @brief do we collect comments?
      */
@@ -2,7 +2,10 @@
 
 #include "file_logger.h"
 
+#include <algorithm>
+#include <chrono>
 #include <sstream>
+#include <thread>
 
 // clang-format off
 #include <wx/app.h>
@@ -17,6 +20,98 @@ static HANDLE g_mainThreadHandle{nullptr};
 static DWORD g_mainThreadId{0};
 #endif
 
+#if defined(__linux__) || defined(__APPLE__)
+#define CL_SIGNAL_SAMPLING 1
+#include <atomic>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <mutex>
+#include <pthread.h>
+#include <signal.h>
+
+static pthread_t g_mainThread;
+static bool g_mainThreadSet{false};
+
+namespace
+{
+constexpr int kMaxSampleFrames = 128;
+void* g_sampleFrames[kMaxSampleFrames];
+std::atomic<int> g_sampleDepth{0};
+std::atomic<uint64_t> g_sampleRequested{0};
+std::atomic<uint64_t> g_sampleCompleted{0};
+std::mutex g_sampleMutex;
+/// the SIGPROF action replaced by ours (e.g. a profiler's), guarded by g_sampleMutex
+struct sigaction g_previousAction {
+};
+bool g_handlerInstalled{false};
+
+/// Pass a signal we did not request to the handler that was installed before ours
+void ChainSignal(int signo, siginfo_t* info, void* context)
+{
+    if (g_previousAction.sa_flags & SA_SIGINFO) {
+        if (g_previousAction.sa_sigaction) {
+            g_previousAction.sa_sigaction(signo, info, context);
+        }
+    } else if (g_previousAction.sa_handler != SIG_DFL && g_previousAction.sa_handler != SIG_IGN) {
+        g_previousAction.sa_handler(signo);
+    }
+}
+
+/// Runs on the main thread. Only async-signal-safe calls are allowed here
+void SampleSignalHandler(int signo, siginfo_t* info, void* context)
+{
+    int saved_errno = errno;
+    uint64_t request = g_sampleRequested.load(std::memory_order_acquire);
+    if (request == g_sampleCompleted.load(std::memory_order_acquire)) {
+        // no sample is pending: this SIGPROF is not ours (e.g. a profiler timer)
+        errno = saved_errno;
+        ChainSignal(signo, info, context);
+        return;
+    }
+    g_sampleDepth.store(::backtrace(g_sampleFrames, kMaxSampleFrames), std::memory_order_relaxed);
+    g_sampleCompleted.store(request, std::memory_order_release);
+    errno = saved_errno;
+}
+
+/// Called with g_sampleMutex held
+void InstallSampleHandler()
+{
+    if (g_handlerInstalled) {
+        return;
+    }
+
+    // backtrace() lazily loads libgcc on its first call, which is not async-signal-safe: do it here instead
+    void* warm_up[2];
+    ::backtrace(warm_up, 2);
+
+    struct sigaction action {
+    };
+    action.sa_sigaction = SampleSignalHandler;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = SA_SIGINFO | SA_RESTART; // don't make the main thread system calls fail with EINTR
+    if (sigaction(SIGPROF, &action, &g_previousAction) != 0) {
+        clWARNING() << "Failed to install the SIGPROF handler: " << strerror(errno) << endl;
+        return;
+    }
+    g_handlerInstalled = true;
+}
+
+/// Called with g_sampleMutex held
+void RestoreSampleHandler()
+{
+    if (!g_handlerInstalled) {
+        return;
+    }
+    sigaction(SIGPROF, &g_previousAction, nullptr);
+    g_handlerInstalled = false;
+}
+} // namespace
+#endif
+
 #if wxUSE_STACKWALKER
 class MyStackWalker : public wxStackWalker
 {
@@ -38,6 +133,13 @@ private:
 
 void StackWalker::Shutdown()
 {
+#ifdef CL_SIGNAL_SAMPLING
+    {
+        std::lock_guard lock{g_sampleMutex};
+        RestoreSampleHandler();
+    }
+#endif
+
 #ifdef __WXMSW__
     if (g_mainThreadHandle) {
         CloseHandle(g_mainThreadHandle);
@@ -49,6 +151,11 @@ void StackWalker::Shutdown()
 
 void StackWalker::Initialise()
 {
+#ifdef CL_SIGNAL_SAMPLING
+    g_mainThread = pthread_self();
+    g_mainThreadSet = true;
+#endif
+
 #ifdef __WXMSW__
     // Get the main thread handle (current thread when constructed)
     g_mainThreadId = GetCurrentThreadId();
@@ -69,6 +176,16 @@ void StackWalker::Initialise()
 }
 
 #ifdef __WXMSW__
+static bool MSWInitSymbols()
+{
+    static bool symInitialized = false;
+    if (!symInitialized) {
+        SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
+        symInitialized = SymInitialize(GetCurrentProcess(), NULL, TRUE);
+    }
+    return symInitialized;
+}
+
 std::string MSWGetStackTrace(HANDLE threadHandle, DWORD threadId)
 {
     std::stringstream ss;
@@ -86,18 +203,10 @@ std::string MSWGetStackTrace(HANDLE threadHandle, DWORD threadId)
 
     // Initialize symbol handler for the current process
     HANDLE process = GetCurrentProcess();
-
-    // Set symbol options
-    SymSetOptions(SYMOPT_UNDNAME | SYMOPT_DEFERRED_LOADS | SYMOPT_LOAD_LINES);
-
-    static bool symInitialized = false;
-    if (!symInitialized) {
-        if (!SymInitialize(process, NULL, TRUE)) {
-            ss << "Failed to initialize symbols (error: " << GetLastError() << ")" << std::endl;
-            ResumeThread(threadHandle);
-            return ss.str();
-        }
-        symInitialized = true;
+    if (!MSWInitSymbols()) {
+        ss << "Failed to initialize symbols (error: " << GetLastError() << ")" << std::endl;
+        ResumeThread(threadHandle);
+        return ss.str();
     }
 
     // Get the thread context
@@ -235,3 +344,115 @@ void StackWalker::Dump(const std::vector<wxString>& prefix, bool dumpCurrentThre
 #endif
 #endif
 }
+
+std::vector<void*> StackWalker::CaptureMainThreadFrames(size_t max_frames)
+{
+    std::vector<void*> frames;
+#if defined(__WXMSW__) && defined(_M_X64)
+    if (g_mainThreadHandle == nullptr || GetCurrentThreadId() == g_mainThreadId || !MSWInitSymbols()) {
+        return frames;
+    }
+
+    // No heap allocations while the main thread is suspended: it might be holding the heap lock
+    frames.reserve(max_frames);
+    if (SuspendThread(g_mainThreadHandle) == (DWORD)-1) {
+        return frames;
+    }
+
+    CONTEXT context;
+    memset(&context, 0, sizeof(CONTEXT));
+    context.ContextFlags = CONTEXT_FULL;
+    if (GetThreadContext(g_mainThreadHandle, &context)) {
+        STACKFRAME64 stackFrame;
+        memset(&stackFrame, 0, sizeof(STACKFRAME64));
+        stackFrame.AddrPC.Offset = context.Rip;
+        stackFrame.AddrFrame.Offset = context.Rbp;
+        stackFrame.AddrStack.Offset = context.Rsp;
+        stackFrame.AddrPC.Mode = AddrModeFlat;
+        stackFrame.AddrFrame.Mode = AddrModeFlat;
+        stackFrame.AddrStack.Mode = AddrModeFlat;
+
+        while (frames.size() < max_frames && StackWalk64(IMAGE_FILE_MACHINE_AMD64,
+                                                         GetCurrentProcess(),
+                                                         g_mainThreadHandle,
+                                                         &stackFrame,
+                                                         &context,
+                                                         NULL,
+                                                         SymFunctionTableAccess64,
+                                                         SymGetModuleBase64,
+                                                         NULL)) {
+            if (stackFrame.AddrPC.Offset == 0) {
+                break;
+            }
+            frames.push_back(reinterpret_cast<void*>(stackFrame.AddrPC.Offset));
+        }
+    }
+    ResumeThread(g_mainThreadHandle);
+#elif defined(CL_SIGNAL_SAMPLING)
+    std::lock_guard lock{g_sampleMutex};
+    if (!g_mainThreadSet || pthread_equal(pthread_self(), g_mainThread)) {
+        return frames;
+    }
+    InstallSampleHandler();
+    if (!g_handlerInstalled) {
+        return frames;
+    }
+
+    uint64_t request = g_sampleRequested.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if (pthread_kill(g_mainThread, SIGPROF) != 0) {
+        return frames;
+    }
+
+    // The main thread might be blocked inside a system call with signals masked; don't wait forever
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(100);
+    while (g_sampleCompleted.load(std::memory_order_acquire) < request) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return frames;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    // Skip the signal handler and the signal trampoline frames
+    constexpr int kSkipFrames = 2;
+    int depth = g_sampleDepth.load(std::memory_order_relaxed);
+    frames.reserve(std::min(max_frames, static_cast<size_t>(std::max(depth - kSkipFrames, 0))));
+    for (int i = kSkipFrames; i < depth && frames.size() < max_frames; ++i) {
+        frames.push_back(g_sampleFrames[i]);
+    }
+#else
+    wxUnusedVar(max_frames);
+#endif
+    return frames;
+}
+
+wxString StackWalker::Symbolize(void* address)
+{
+#if defined(__WXMSW__) && defined(_M_X64)
+    if (MSWInitSymbols()) {
+        char buffer[sizeof(SYMBOL_INFO) + MAX_SYM_NAME * sizeof(TCHAR)];
+        PSYMBOL_INFO symbol = (PSYMBOL_INFO)buffer;
+        symbol->SizeOfStruct = sizeof(SYMBOL_INFO);
+        symbol->MaxNameLen = MAX_SYM_NAME;
+
+        DWORD64 displacement = 0;
+        if (SymFromAddr(GetCurrentProcess(), reinterpret_cast<DWORD64>(address), &displacement, symbol)) {
+            return wxString::FromUTF8(symbol->Name);
+        }
+    }
+#elif defined(CL_SIGNAL_SAMPLING)
+    Dl_info info;
+    if (dladdr(address, &info) != 0) {
+        wxString module = info.dli_fname ? wxString::FromUTF8(info.dli_fname).AfterLast('/') : wxString{"?"};
+        if (info.dli_sname == nullptr) {
+            return wxString::Format("%s!%p", module, address);
+        }
+
+        int status = 0;
+        char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+        wxString name = wxString::FromUTF8(status == 0 && demangled ? demangled : info.dli_sname);
+        std::free(demangled);
+        return module + "!" + name;
+    }
+#endif
+    return wxString::Format("%p", address);
+}
@@ -3,6 +3,7 @@
 #include "codelite_exports.h"
 #include "wx/string.h"
 
+#include <cstddef>
 #include <vector>
 
 class WXDLLIMPEXP_CL StackWalker
@@ -11,4 +12,17 @@ public:
     static void Dump(const std::vector<wxString>& prefix, bool dumpCurrentThread = true);
     static void Initialise();
     static void Shutdown();
+
+    /**
+     * @brief capture the raw return addresses of the main thread, innermost frame first. This does not resolve any
+     * symbol so it is cheap enough to be called periodically from a sampling thread. Must not be called from the main
+     * thread. On Linux and macOS the main thread is interrupted with SIGPROF, on Windows it is suspended.
+     * @return the captured frames, or an empty vector if sampling is not supported on this platform
+     */
+    static std::vector<void*> CaptureMainThreadFrames(size_t max_frames = 64);
+
+    /**
+     * @brief resolve an address captured by `CaptureMainThreadFrames()` into a "module!function" string
+     */
+    static wxString Symbolize(void* address);
 };
@@ -2,10 +2,13 @@
 
 #include "BlockTimer.hpp"
 #include "StackWalker/StackWalker.hpp"
+#include "clFoldedStacks.hpp"
+#include "cl_standard_paths.h"
 #include "event_notifier.h"
 #include "file_logger.h"
 
 #include <chrono>
+#include <wx/datetime.h>
 
 #ifdef __WXMSW__
 #include <dbghelp.h>
@@ -17,6 +20,12 @@
         return;                     \
     }
 
+namespace
+{
+/// Stop sampling a single hang after this many samples (~20 seconds with the default interval)
+constexpr size_t kMaxSamplesPerHang = 2000;
+} // namespace
+
 UIHangDetector::UIHangDetector() {}
 
 UIHangDetector::~UIHangDetector()
@@ -25,7 +34,7 @@ UIHangDetector::~UIHangDetector()
     Stop();
 }
 
-void UIHangDetector::Start(long hangThresholdMs, long checkIntervalMs)
+void UIHangDetector::Start(long hangThresholdMs, long checkIntervalMs, long sampleIntervalMs)
 {
     CHECK_ENABLED()
 
@@ -43,8 +52,13 @@ void UIHangDetector::Start(long hangThresholdMs, long checkIntervalMs)
         return; // Already running
     }
 
+    if (sampleIntervalMs <= 0) {
+        sampleIntervalMs = 10;
+    }
+
     m_hangThresholdMs = hangThresholdMs;
     m_checkIntervalMs = checkIntervalMs;
+    m_sampleIntervalMs = sampleIntervalMs;
 
     m_running.store(true);
     m_watchdogThread = std::thread(&UIHangDetector::WatchdogLoop, this);
@@ -70,6 +84,9 @@ void UIHangDetector::Stop()
         m_watchdogThread.join();
     }
 
+    if (m_eventLoopLatency.GetCount() > 0) {
+        ExportEventLoopLatency(GetPerfFile("event-loop-latency.csv"));
+    }
     clSYSTEM() << "UIHangDetector stopped" << endl;
 }
 
@@ -80,6 +97,96 @@ uint64_t UIHangDetector::GetCurrentTimeMs()
     return static_cast<uint64_t>(duration.count());
 }
 
+uint64_t UIHangDetector::GetElapsedMs(uint64_t sinceMs)
+{
+    uint64_t now = GetCurrentTimeMs();
+    return now > sinceMs ? now - sinceMs : 0;
+}
+
+uint64_t UIHangDetector::GetCurrentTimeMicro()
+{
+    auto now = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(now.time_since_epoch());
+    return static_cast<uint64_t>(duration.count());
+}
+
+wxFileName UIHangDetector::GetPerfFile(const wxString& fullname)
+{
+    wxFileName fn{clStandardPaths::Get().GetUserDataDir(), fullname};
+    fn.AppendDir("perf");
+    return fn;
+}
+
+bool UIHangDetector::ExportEventLoopLatency(const wxFileName& path) const
+{
+    if (!m_eventLoopLatency.Save(path)) {
+        clWARNING() << "Failed to write event loop latency histogram:" << path.GetFullPath() << endl;
+        return false;
+    }
+    clSYSTEM() << "Event loop latency histogram written to:" << path.GetFullPath() << endl;
+    return true;
+}
+
+wxString UIHangDetector::SymbolizeCached(void* address)
+{
+    auto iter = m_symbolsCache.find(address);
+    if (iter != m_symbolsCache.end()) {
+        return iter->second;
+    }
+    wxString name = StackWalker::Symbolize(address);
+    m_symbolsCache.insert({address, name});
+    return name;
+}
+
+void UIHangDetector::ProfileHang(uint64_t hangStartMs)
+{
+    auto is_hung = [this]() {
+        return GetElapsedMs(m_lastHeartbeat.load()) > static_cast<uint64_t>(m_hangThresholdMs);
+    };
+
+    // Capture raw addresses only while the hang is in progress, symbols are resolved once it is over
+    std::vector<std::vector<void*>> samples;
+    while (m_running.load() && is_hung() && samples.size() < kMaxSamplesPerHang) {
+        auto frames = StackWalker::CaptureMainThreadFrames();
+        if (!frames.empty()) {
+            samples.push_back(std::move(frames));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_sampleIntervalMs));
+    }
+    uint64_t durationMs = GetElapsedMs(hangStartMs);
+
+    if (samples.empty()) {
+        // Sampling is not supported on this platform, fallback to a single live capture
+        wxString header;
+        header << "Main Thread was not responsive for over " << durationMs << "ms";
+        StackWalker::Dump({"=== UI HANG DETECTED ===", header, "=== (Live Capture) ==="}, false);
+    } else {
+        clFoldedStacks folded;
+        for (const auto& frames : samples) {
+            std::vector<wxString> names;
+            names.reserve(frames.size());
+            for (auto iter = frames.rbegin(); iter != frames.rend(); ++iter) {
+                names.push_back(SymbolizeCached(*iter));
+            }
+            folded.AddSample(names);
+        }
+
+        wxString fullname;
+        fullname << "hang-" << wxDateTime::Now().Format("%Y%m%d-%H%M%S") << ".folded";
+        wxFileName folded_file = GetPerfFile(fullname);
+        folded.Save(folded_file);
+
+        clSYSTEM() << "=== UI HANG DETECTED === Main Thread was not responsive for" << durationMs << "ms."
+                   << folded.GetSamplesCount() << "samples written to:" << folded_file.GetFullPath() << endl;
+        clSYSTEM() << "Hottest stack:" << folded.GetHottestStack() << endl;
+    }
+
+    // If we gave up sampling a very long hang, don't report it again
+    while (m_running.load() && is_hung()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(m_checkIntervalMs));
+    }
+}
+
 void UIHangDetector::WatchdogLoop()
 {
     CHECK_ENABLED()
@@ -102,27 +209,21 @@ void UIHangDetector::WatchdogLoop()
         while (m_running.load()) {
             std::this_thread::sleep_for(std::chrono::milliseconds(m_checkIntervalMs));
 
-            uint64_t now = GetCurrentTimeMs();
+            // the heartbeat may be newer than a time read before it: GetElapsedMs() does not underflow
             uint64_t last = m_lastHeartbeat.load();
-
-            uint64_t timeSinceLastActivity = now - last;
-            if (last != 0 && (timeSinceLastActivity > static_cast<uint64_t>(m_hangThresholdMs))) {
-                wxString header;
-                header << "Main Thread was not responsive for over" << timeSinceLastActivity << "ms";
-                StackWalker::Dump({"=== UI HANG DETECTED ===", header, "=== (Live Capture) ==="}, false);
-
-                // To avoid flooding logs during a permanent hang,
-                // you might want to sleep longer here or set a flag.
-                std::this_thread::sleep_for(std::chrono::seconds(5));
+            if (last != 0 && GetElapsedMs(last) > static_cast<uint64_t>(m_hangThresholdMs)) {
+                ProfileHang(last);
             }
         }
     });
 
-    // 3. Main Watchdog loop: just sends the heartbeat
+    // 3. Main Watchdog loop: sends the heartbeat and measures how long it took the event loop to process it
     while (m_running.load()) {
         // Send heartbeat to main thread
-        EventNotifier::Get()->RunOnMain([this]() {
+        uint64_t posted_at = GetCurrentTimeMicro();
+        EventNotifier::Get()->RunOnMain([this, posted_at]() {
             m_lastHeartbeat.store(GetCurrentTimeMs());
+            m_eventLoopLatency.Add(GetCurrentTimeMicro() - posted_at);
             return 0;
         });
 
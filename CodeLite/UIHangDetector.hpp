@@ -5,10 +5,13 @@
 #include <wx/app.h>
 // clang-format on
 
+#include "clLatencyHistogram.hpp"
 #include "codelite_exports.h"
 
 #include <atomic>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 class WXDLLIMPEXP_CL UIHangDetector
 {
@@ -20,8 +23,9 @@ public:
      * Start the watchdog thread
      * @param hangThresholdMs Time in milliseconds before considering the main thread hung
      * @param checkIntervalMs How often the watchdog wakes up to check (should be < hangThresholdMs)
+     * @param sampleIntervalMs While a hang is in progress, how often the main thread stack is sampled
      */
-    void Start(long hangThresholdMs = 50, long checkIntervalMs = 10);
+    void Start(long hangThresholdMs = 50, long checkIntervalMs = 10, long sampleIntervalMs = 10);
 
     /**
      * Stop the watchdog thread
@@ -33,16 +37,42 @@ public:
      */
     bool IsRunning() const { return m_running.load(); }
 
+    /**
+     * @brief the event loop latency (the time it takes the main thread to pick up a posted heartbeat) of the most
+     * recent heartbeats
+     */
+    const clLatencyHistogram& GetEventLoopLatency() const { return m_eventLoopLatency; }
+
+    /**
+     * @brief export the event loop latency histogram as CSV, for offline analysis
+     */
+    bool ExportEventLoopLatency(const wxFileName& path) const;
+
 private:
     void WatchdogLoop();
     static uint64_t GetCurrentTimeMs();
+    /// the milliseconds elapsed since `sinceMs`, 0 if it is not in the past (the heartbeat is updated concurrently)
+    static uint64_t GetElapsedMs(uint64_t sinceMs);
+    static uint64_t GetCurrentTimeMicro();
+    static wxFileName GetPerfFile(const wxString& fullname);
+
+    /**
+     * @brief called from the monitor thread once a hang is detected: sample the main thread stack until it becomes
+     * responsive again, then write the aggregated samples as a folded stack (flame graph) file
+     */
+    void ProfileHang(uint64_t hangStartMs);
+    wxString SymbolizeCached(void* address);
 
     std::atomic<bool> m_running{false};
     std::thread m_watchdogThread;
 
     long m_hangThresholdMs{50};
     long m_checkIntervalMs{10};
+    long m_sampleIntervalMs{10};
     std::atomic<uint64_t> m_lastHeartbeat{0};
+    clLatencyHistogram m_eventLoopLatency;
+    /// accessed by the monitor thread only
+    std::unordered_map<void*, wxString> m_symbolsCache;
 };
 
 #endif // UIHANGDETECTOR_HPP
@@ -0,0 +1,109 @@
+#include "clContentLengthFramer.hpp"
+
+#include "file_logger.h"
+
+#include <algorithm>
+#include <cctype>
+
+namespace
+{
+constexpr const char CONTENT_LENGTH[] = "content-length:";
+constexpr size_t CONTENT_LENGTH_SIZE = sizeof(CONTENT_LENGTH) - 1;
+
+bool StartsWithNoCase(const char* str, const char* prefix, size_t length)
+{
+    for (size_t i = 0; i < length; ++i) {
+        if (std::tolower(static_cast<unsigned char>(str[i])) != prefix[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+bool clContentLengthFramer::ParseContentLength(const char* header, size_t length, size_t* value)
+{
+    for (size_t i = 0; i + CONTENT_LENGTH_SIZE <= length; ++i) {
+        if (i != 0 && header[i - 1] != '\n') {
+            continue;
+        }
+        if (!StartsWithNoCase(header + i, CONTENT_LENGTH, CONTENT_LENGTH_SIZE)) {
+            continue;
+        }
+        size_t pos = i + CONTENT_LENGTH_SIZE;
+        while (pos < length && header[pos] == ' ') {
+            ++pos;
+        }
+        size_t result = 0;
+        bool has_digits = false;
+        for (; pos < length && header[pos] >= '0' && header[pos] <= '9'; ++pos) {
+            result = result * 10 + (header[pos] - '0');
+            has_digits = true;
+        }
+        *value = result;
+        return has_digits;
+    }
+    return false;
+}
+
+void clContentLengthFramer::Append(const char* data, size_t length)
+{
+    // reclaim the space used by the messages already consumed before growing the buffer
+    if (m_start > 0 && m_start >= m_buffer.size() / 2) {
+        m_buffer.erase(0, m_start);
+        m_scan_from -= m_start;
+        if (m_body_offset != std::string::npos) {
+            m_body_offset -= m_start;
+        }
+        m_start = 0;
+    }
+    m_buffer.append(data, length);
+}
+
+bool clContentLengthFramer::Next(std::string& message)
+{
+    while (m_body_offset == std::string::npos) {
+        size_t header_end = m_buffer.find("\r\n\r\n", std::max(m_scan_from, m_start));
+        if (header_end == std::string::npos) {
+            // resume the search from here when more data arrives (the separator may be split between two reads)
+            m_scan_from = std::max(m_start, m_buffer.size() > 3 ? m_buffer.size() - 3 : 0);
+            return false;
+        }
+
+        size_t body_length = 0;
+        if (!ParseContentLength(m_buffer.data() + m_start, header_end - m_start, &body_length)) {
+            clWARNING() << "Content-Length framer: dropping a message without a Content-Length header" << endl;
+            m_start = header_end + 4;
+            m_scan_from = m_start;
+            continue;
+        }
+        m_body_offset = header_end + 4;
+        m_body_length = body_length;
+    }
+
+    if (m_buffer.size() - m_body_offset < m_body_length) {
+        return false;
+    }
+
+    size_t message_end = m_body_offset + m_body_length;
+    message.assign(m_buffer, m_start, message_end - m_start);
+    m_start = message_end;
+    m_scan_from = message_end;
+    m_body_offset = std::string::npos;
+    m_body_length = 0;
+    if (m_start == m_buffer.size()) {
+        m_buffer.clear();
+        m_start = 0;
+        m_scan_from = 0;
+    }
+    return true;
+}
+
+void clContentLengthFramer::Clear()
+{
+    m_buffer.clear();
+    m_start = 0;
+    m_scan_from = 0;
+    m_body_offset = std::string::npos;
+    m_body_length = 0;
+}
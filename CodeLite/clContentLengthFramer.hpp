@@ -0,0 +1,39 @@
+#ifndef CLCONTENTLENGTHFRAMER_HPP
+#define CLCONTENTLENGTHFRAMER_HPP
+
+#include "codelite_exports.h"
+
+#include <string>
+
+/**
+ * @brief split a stream of bytes into complete `Content-Length` framed messages (DAP, LSP).
+ * Data is appended as it arrives; the header of a partially received message is parsed only once and the body is not
+ * scanned at all
+ */
+class WXDLLIMPEXP_CL clContentLengthFramer
+{
+public:
+    void Append(const char* data, size_t length);
+
+    /**
+     * @brief extract the next complete message (header + body) into `message`
+     * @return false if more data is needed
+     */
+    bool Next(std::string& message);
+
+    void Clear();
+
+    /**
+     * @brief case insensitive search for `Content-Length: <N>` in the header lines
+     */
+    static bool ParseContentLength(const char* header, size_t length, size_t* value);
+
+private:
+    std::string m_buffer;
+    size_t m_start = 0;                       // the beginning of the current message in m_buffer
+    size_t m_scan_from = 0;                   // where to resume looking for the end of the header
+    size_t m_body_offset = std::string::npos; // npos: the header was not parsed yet
+    size_t m_body_length = 0;
+};
+
+#endif // CLCONTENTLENGTHFRAMER_HPP
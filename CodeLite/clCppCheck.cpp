@@ -0,0 +1,221 @@
+#include "clCppCheck.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <string_view>
+#include <wx/log.h>
+#include <wx/mstream.h>
+#include <wx/xml/xml.h>
+
+namespace
+{
+constexpr std::string_view ERROR_START = "<error";
+constexpr std::string_view ERROR_END = "</error>";
+
+/// the position of "<error" starting an element (not "<errors>") at or after `from`
+size_t FindErrorStart(const std::string& buffer, size_t from)
+{
+    while (true) {
+        size_t pos = buffer.find(ERROR_START, from);
+        if (pos == std::string::npos || pos + ERROR_START.size() >= buffer.size()) {
+            return pos;
+        }
+        char ch = buffer[pos + ERROR_START.size()];
+        if (ch == ' ' || ch == '\t' || ch == '\r' || ch == '\n' || ch == '/' || ch == '>') {
+            return pos;
+        }
+        from = pos + ERROR_START.size();
+    }
+}
+
+/// the position of the '>' closing the start tag at `pos`, ignoring the ones in the attribute values
+size_t FindTagEnd(const std::string& buffer, size_t pos)
+{
+    char quote = 0;
+    for (size_t i = pos; i < buffer.size(); ++i) {
+        char ch = buffer[i];
+        if (quote) {
+            if (ch == quote) {
+                quote = 0;
+            }
+        } else if (ch == '"' || ch == '\'') {
+            quote = ch;
+        } else if (ch == '>') {
+            return i;
+        }
+    }
+    return std::string::npos;
+}
+
+int ToInt(const wxString& str)
+{
+    long value = 0;
+    return str.ToCLong(&value) ? static_cast<int>(value) : 0;
+}
+} // namespace
+
+wxString clCppCheckDiagnostic::ToString(Severity severity)
+{
+    switch (severity) {
+    case Severity::kError:
+        return "error";
+    case Severity::kWarning:
+        return "warning";
+    case Severity::kStyle:
+        return "style";
+    case Severity::kPerformance:
+        return "performance";
+    case Severity::kPortability:
+        return "portability";
+    case Severity::kInformation:
+        break;
+    }
+    return "information";
+}
+
+std::vector<clCppCheckDiagnostic> clCppCheckXmlParser::Feed(const std::string& chunk)
+{
+    std::vector<clCppCheckDiagnostic> diagnostics;
+    m_buffer.append(chunk);
+
+    while (true) {
+        size_t start = FindErrorStart(m_buffer, 0);
+        if (start == std::string::npos) {
+            // keep what may be the beginning of "<error"
+            if (m_buffer.size() >= ERROR_START.size()) {
+                m_buffer.erase(0, m_buffer.size() - ERROR_START.size() + 1);
+            }
+            break;
+        }
+        m_buffer.erase(0, start);
+
+        size_t tagEnd = FindTagEnd(m_buffer, ERROR_START.size());
+        if (tagEnd == std::string::npos) {
+            break;
+        }
+
+        size_t end = std::string::npos;
+        if (m_buffer[tagEnd - 1] == '/') {
+            end = tagEnd + 1;
+        } else {
+            size_t close = m_buffer.find(ERROR_END, tagEnd);
+            if (close == std::string::npos) {
+                break;
+            }
+            end = close + ERROR_END.size();
+        }
+
+        clCppCheckDiagnostic diagnostic;
+        if (ParseError(m_buffer.substr(0, end), diagnostic)) {
+            diagnostics.push_back(std::move(diagnostic));
+        }
+        m_buffer.erase(0, end);
+    }
+    return diagnostics;
+}
+
+bool clCppCheckXmlParser::ParseError(const std::string& xml, clCppCheckDiagnostic& diagnostic)
+{
+    wxLogNull noLog;
+    wxMemoryInputStream stream(xml.data(), xml.size());
+    wxXmlDocument doc;
+    if (!doc.Load(stream) || !doc.GetRoot() || doc.GetRoot()->GetName() != "error") {
+        return false;
+    }
+
+    const wxXmlNode* root = doc.GetRoot();
+    diagnostic.id = root->GetAttribute("id");
+    diagnostic.severity = ParseSeverity(root->GetAttribute("severity"));
+    diagnostic.message = root->GetAttribute("msg");
+    diagnostic.verbose = root->GetAttribute("verbose", diagnostic.message);
+    diagnostic.cwe = root->GetAttribute("cwe");
+    diagnostic.file = root->GetAttribute("file0");
+
+    for (const wxXmlNode* child = root->GetChildren(); child; child = child->GetNext()) {
+        if (child->GetName() == "location") {
+            diagnostic.file = child->GetAttribute("file");
+            diagnostic.line = ToInt(child->GetAttribute("line"));
+            diagnostic.column = ToInt(child->GetAttribute("column"));
+            break;
+        }
+    }
+    return !diagnostic.id.empty();
+}
+
+clCppCheckDiagnostic::Severity clCppCheckXmlParser::ParseSeverity(const wxString& severity)
+{
+    if (severity == "error") {
+        return clCppCheckDiagnostic::Severity::kError;
+    } else if (severity == "warning") {
+        return clCppCheckDiagnostic::Severity::kWarning;
+    } else if (severity == "style") {
+        return clCppCheckDiagnostic::Severity::kStyle;
+    } else if (severity == "performance") {
+        return clCppCheckDiagnostic::Severity::kPerformance;
+    } else if (severity == "portability") {
+        return clCppCheckDiagnostic::Severity::kPortability;
+    }
+    return clCppCheckDiagnostic::Severity::kInformation;
+}
+
+void clCppCheckReport::Clear()
+{
+    m_diagnostics.clear();
+    m_keys.clear();
+}
+
+bool clCppCheckReport::Add(clCppCheckDiagnostic diagnostic)
+{
+    if (!m_keys.insert(GetKey(diagnostic)).second) {
+        return false;
+    }
+    m_diagnostics.push_back(std::move(diagnostic));
+    return true;
+}
+
+void clCppCheckReport::ClearFile(const wxString& file)
+{
+    // remove_if leaves the removed elements moved-from: partition them instead, their keys are still needed
+    auto iter = std::stable_partition(m_diagnostics.begin(), m_diagnostics.end(), [&](const clCppCheckDiagnostic& d) {
+        return d.file != file;
+    });
+    for (auto cur = iter; cur != m_diagnostics.end(); ++cur) {
+        m_keys.erase(GetKey(*cur));
+    }
+    m_diagnostics.erase(iter, m_diagnostics.end());
+}
+
+std::vector<clCppCheckDiagnostic> clCppCheckReport::GetFileDiagnostics(const wxString& file) const
+{
+    std::vector<clCppCheckDiagnostic> diagnostics;
+    std::copy_if(m_diagnostics.begin(),
+                 m_diagnostics.end(),
+                 std::back_inserter(diagnostics),
+                 [&](const clCppCheckDiagnostic& d) { return d.file == file; });
+    return diagnostics;
+}
+
+std::vector<clCppCheckDiagnostic> clCppCheckReport::Filter(size_t severityMask, const wxString& text) const
+{
+    wxString lcText = text.Lower();
+    std::vector<clCppCheckDiagnostic> diagnostics;
+    for (const auto& d : m_diagnostics) {
+        if ((d.GetSeverityMask() & severityMask) == 0) {
+            continue;
+        }
+        if (!lcText.empty() && !d.message.Lower().Contains(lcText) && !d.file.Lower().Contains(lcText) &&
+            !d.id.Lower().Contains(lcText)) {
+            continue;
+        }
+        diagnostics.push_back(d);
+    }
+    return diagnostics;
+}
+
+wxString clCppCheckReport::GetKey(const clCppCheckDiagnostic& diagnostic)
+{
+    wxString key;
+    key << diagnostic.file << ":" << diagnostic.line << ":" << diagnostic.column << ":" << diagnostic.id << ":"
+        << diagnostic.message;
+    return key;
+}
@@ -0,0 +1,106 @@
+#ifndef CLCPPCHECK_HPP
+#define CLCPPCHECK_HPP
+
+#include "codelite_exports.h"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+#include <wx/string.h>
+
+/// a diagnostic reported by cppcheck
+struct WXDLLIMPEXP_CL clCppCheckDiagnostic {
+    enum class Severity {
+        kError,
+        kWarning,
+        kStyle,
+        kPerformance,
+        kPortability,
+        kInformation,
+    };
+
+    wxString id;
+    Severity severity = Severity::kInformation;
+    wxString message;
+    wxString verbose;
+    wxString cwe;
+    /// the primary location (the first one). Some diagnostics have none (e.g. a missing system include)
+    wxString file;
+    int line = 0;
+    int column = 0;
+
+    /// the severity mask that matches this diagnostic
+    size_t GetSeverityMask() const { return size_t{1} << static_cast<size_t>(severity); }
+    bool HasLocation() const { return !file.empty() && line > 0; }
+    static wxString ToString(Severity severity);
+};
+
+/**
+ * @brief parse the output of "cppcheck --xml" (version 2) as it is read, into diagnostics.
+ *
+ * The output is fed in chunks of any size; a diagnostic is returned as soon as its `<error>` element is complete.
+ * Only the part of the output that may still start an element is kept, so the memory used does not depend on the
+ * size of the output.
+ */
+class WXDLLIMPEXP_CL clCppCheckXmlParser
+{
+public:
+    /**
+     * @brief feed the next chunk of the output, return the diagnostics it completed
+     */
+    std::vector<clCppCheckDiagnostic> Feed(const std::string& chunk);
+
+    /// discard the buffered output (e.g. a new run starts)
+    void Reset() { m_buffer.clear(); }
+
+    /**
+     * @brief parse a single `<error>` element
+     */
+    static bool ParseError(const std::string& xml, clCppCheckDiagnostic& diagnostic);
+
+    /// "error", "warning", ... unknown values are kInformation
+    static clCppCheckDiagnostic::Severity ParseSeverity(const wxString& severity);
+
+private:
+    std::string m_buffer;
+};
+
+/**
+ * @brief the diagnostics of a cppcheck run, updated as files are checked again
+ */
+class WXDLLIMPEXP_CL clCppCheckReport
+{
+public:
+    static constexpr size_t ALL_SEVERITIES = static_cast<size_t>(-1);
+
+public:
+    void Clear();
+
+    /**
+     * @brief add a diagnostic. Return false if it was already reported (e.g. for a header included by two files)
+     */
+    bool Add(clCppCheckDiagnostic diagnostic);
+
+    /**
+     * @brief remove the diagnostics of `file` (it is about to be checked again)
+     */
+    void ClearFile(const wxString& file);
+
+    std::vector<clCppCheckDiagnostic> GetFileDiagnostics(const wxString& file) const;
+
+    /**
+     * @brief the diagnostics matching the severity mask whose message, file or id contains `text` (ignoring case)
+     */
+    std::vector<clCppCheckDiagnostic> Filter(size_t severityMask, const wxString& text = wxEmptyString) const;
+
+    const std::vector<clCppCheckDiagnostic>& GetDiagnostics() const { return m_diagnostics; }
+    size_t GetCount() const { return m_diagnostics.size(); }
+
+private:
+    static wxString GetKey(const clCppCheckDiagnostic& diagnostic);
+
+    std::vector<clCppCheckDiagnostic> m_diagnostics;
+    std::unordered_set<wxString> m_keys;
+};
+
+#endif // CLCPPCHECK_HPP
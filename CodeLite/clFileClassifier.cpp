@@ -0,0 +1,132 @@
+#include "clFileClassifier.hpp"
+
+#include <algorithm>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/tokenzr.h>
+
+namespace
+{
+/// "*.ext" where "ext" has no wildcard. Return "ext" (which may contain dots, e.g. "tar.gz")
+bool IsExtensionPattern(const wxString& pattern, wxString* ext)
+{
+    if (!pattern.StartsWith("*.") || pattern.length() < 3) {
+        return false;
+    }
+    wxString rest = pattern.Mid(2);
+    if (rest.find_first_of("*?") != wxString::npos) {
+        return false;
+    }
+    *ext = rest;
+    return true;
+}
+
+bool PatternMatches(const wxString& pattern, const wxString& lc_name)
+{
+    if (!pattern.Contains("*")) {
+        return lc_name == pattern;
+    }
+    return ::wxMatchWild(pattern, lc_name, false);
+}
+} // namespace
+
+void clFileClassifier::Add(const wxString& mask, size_t id)
+{
+    m_ids.insert(id);
+    wxArrayString patterns = ::wxStringTokenize(mask.Lower(), ";,", wxTOKEN_STRTOK);
+    for (wxString& pattern : patterns) {
+        pattern.Trim().Trim(false);
+        if (pattern.empty()) {
+            continue;
+        }
+
+        if (pattern[0] == '!' || pattern[0] == '-') {
+            pattern.Remove(0, 1);
+            m_excludes[id].push_back(pattern);
+            continue;
+        }
+
+        wxString ext;
+        if (pattern == "*") {
+            m_matchAll.insert(id);
+        } else if (!pattern.Contains("*")) {
+            m_exact[pattern].push_back(id);
+        } else if (IsExtensionPattern(pattern, &ext)) {
+            m_extensions[ext].push_back(id);
+        } else {
+            m_globs.push_back({pattern, id});
+        }
+    }
+}
+
+std::vector<size_t> clFileClassifier::Match(const wxString& filename) const
+{
+    std::vector<size_t> result{m_matchAll.begin(), m_matchAll.end()};
+    if (m_ids.size() == m_matchAll.size()) {
+        std::sort(result.begin(), result.end());
+        return result;
+    }
+
+    wxString lc_name = filename.AfterLast(wxFileName::GetPathSeparator());
+#ifdef __WXMSW__
+    lc_name = lc_name.AfterLast('/');
+#endif
+    lc_name.MakeLower();
+
+    std::vector<size_t> candidates;
+    auto add_candidates = [&candidates](const auto& table, const wxString& key) {
+        auto iter = table.find(key);
+        if (iter != table.end()) {
+            candidates.insert(candidates.end(), iter->second.begin(), iter->second.end());
+        }
+    };
+
+    add_candidates(m_exact, lc_name);
+    // "*.ext" also matches a file named ".ext", so try every suffix that follows a dot
+    for (size_t pos = lc_name.find('.'); pos != wxString::npos; pos = lc_name.find('.', pos + 1)) {
+        add_candidates(m_extensions, lc_name.Mid(pos + 1));
+    }
+    for (const auto& [pattern, id] : m_globs) {
+        if (::wxMatchWild(pattern, lc_name, false)) {
+            candidates.push_back(id);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    for (size_t id : candidates) {
+        // a plain "*" mask wins over the exclude masks (same as `FileUtils::WildMatch`)
+        if (m_matchAll.count(id) == 0 && !IsExcluded(lc_name, id)) {
+            result.push_back(id);
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+bool clFileClassifier::Matches(const wxString& filename, size_t id) const
+{
+    auto ids = Match(filename);
+    return std::binary_search(ids.begin(), ids.end(), id);
+}
+
+bool clFileClassifier::IsExcluded(const wxString& lc_name, size_t id) const
+{
+    auto iter = m_excludes.find(id);
+    if (iter == m_excludes.end()) {
+        return false;
+    }
+    return std::any_of(iter->second.begin(), iter->second.end(), [&lc_name](const wxString& pattern) {
+        return PatternMatches(pattern, lc_name);
+    });
+}
+
+void clFileClassifier::Clear()
+{
+    m_ids.clear();
+    m_matchAll.clear();
+    m_exact.clear();
+    m_extensions.clear();
+    m_globs.clear();
+    m_excludes.clear();
+}
@@ -0,0 +1,49 @@
+#ifndef CLFILECLASSIFIER_HPP
+#define CLFILECLASSIFIER_HPP
+
+#include "codelite_exports.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief a pre-compiled set of file masks (e.g. the lexers' file specs). Each mask is tagged with an id.
+ *
+ * Masks use the same syntax and rules as `FileUtils::WildMatch()`: patterns are separated by ";" or ",", a pattern
+ * prefixed with "!" or "-" excludes files, a pattern without "*" must match the file name exactly and the match is
+ * case insensitive. The masks are split once, when added: exact names and "*.ext" patterns go into hash tables so
+ * classifying a file costs a few lookups, only the remaining patterns are matched one by one.
+ */
+class WXDLLIMPEXP_CL clFileClassifier
+{
+public:
+    clFileClassifier() = default;
+    ~clFileClassifier() = default;
+
+    /// Add the masks of `id`. Calling `Add()` more than once with the same id extends its masks
+    void Add(const wxString& mask, size_t id);
+
+    /// Return the ids whose mask matches `filename`, sorted. Only the file name part of `filename` is considered
+    std::vector<size_t> Match(const wxString& filename) const;
+
+    /// Convenience: return true if `id` matches `filename`
+    bool Matches(const wxString& filename, size_t id) const;
+
+    void Clear();
+    bool IsEmpty() const { return m_ids.empty(); }
+
+private:
+    bool IsExcluded(const wxString& lc_name, size_t id) const;
+
+    std::unordered_set<size_t> m_ids;
+    std::unordered_set<size_t> m_matchAll;
+    std::unordered_map<wxString, std::vector<size_t>> m_exact;
+    std::unordered_map<wxString, std::vector<size_t>> m_extensions;
+    std::vector<std::pair<wxString, size_t>> m_globs;
+    std::unordered_map<size_t, std::vector<wxString>> m_excludes;
+};
+
+#endif // CLFILECLASSIFIER_HPP
@@ -0,0 +1,52 @@
+#include "clFoldedStacks.hpp"
+
+#include "fileutils.h"
+
+void clFoldedStacks::AddSample(const std::vector<wxString>& frames)
+{
+    if (frames.empty()) {
+        return;
+    }
+
+    wxString stack;
+    for (const auto& frame : frames) {
+        if (!stack.empty()) {
+            stack << ";";
+        }
+        // ';' is the frame separator and a newline would break the line based format
+        wxString name = frame;
+        name.Replace(";", ":");
+        name.Replace("\n", " ");
+        stack << name;
+    }
+    m_stacks[stack]++;
+    m_samplesCount++;
+}
+
+wxString clFoldedStacks::GetHottestStack() const
+{
+    auto hottest = m_stacks.end();
+    for (auto iter = m_stacks.begin(); iter != m_stacks.end(); ++iter) {
+        if (hottest == m_stacks.end() || iter->second > hottest->second) {
+            hottest = iter;
+        }
+    }
+    return hottest == m_stacks.end() ? wxString{} : hottest->first;
+}
+
+wxString clFoldedStacks::ToString() const
+{
+    wxString content;
+    for (const auto& [stack, count] : m_stacks) {
+        content << stack << " " << count << "\n";
+    }
+    return content;
+}
+
+bool clFoldedStacks::Save(const wxFileName& path) const
+{
+    if (!path.DirExists()) {
+        path.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+    return FileUtils::WriteFileContent(path, ToString());
+}
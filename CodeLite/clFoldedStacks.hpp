@@ -0,0 +1,39 @@
+#ifndef CLFOLDEDSTACKS_HPP
+#define CLFOLDEDSTACKS_HPP
+
+#include "codelite_exports.h"
+
+#include <map>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+/**
+ * @brief aggregate call stack samples in the "folded stacks" format used by flame graph tools
+ * (e.g. `flamegraph.pl` or https://www.speedscope.app): one line per unique stack, frames separated by ';'
+ * (outermost first) followed by a space and the number of samples
+ */
+class WXDLLIMPEXP_CL clFoldedStacks
+{
+public:
+    clFoldedStacks() = default;
+    ~clFoldedStacks() = default;
+
+    /// Add a single sample. `frames` are ordered from the outermost frame to the innermost one
+    void AddSample(const std::vector<wxString>& frames);
+
+    size_t GetSamplesCount() const { return m_samplesCount; }
+    bool IsEmpty() const { return m_samplesCount == 0; }
+
+    /// Return the most sampled stack, outermost frame first
+    wxString GetHottestStack() const;
+
+    wxString ToString() const;
+    bool Save(const wxFileName& path) const;
+
+private:
+    std::map<wxString, size_t> m_stacks;
+    size_t m_samplesCount{0};
+};
+
+#endif // CLFOLDEDSTACKS_HPP
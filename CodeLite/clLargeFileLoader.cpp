@@ -0,0 +1,209 @@
+#include "clLargeFileLoader.hpp"
+
+#include "file_logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/log.h>
+
+namespace
+{
+constexpr char UTF8_BOM[] = "\xEF\xBB\xBF";
+constexpr size_t UTF8_BOM_LEN = 3;
+
+/// validate UTF-8 fed in pieces of any size (a sequence may be split between two reads)
+class Utf8Validator
+{
+public:
+    void Feed(const char* data, size_t len)
+    {
+        for (size_t i = 0; i < len && m_valid; ++i) {
+            unsigned char ch = static_cast<unsigned char>(data[i]);
+            if (m_pending > 0) {
+                m_valid = ch >= m_min && ch <= m_max;
+                m_min = 0x80;
+                m_max = 0xBF;
+                --m_pending;
+            } else if (ch >= 0x80) {
+                Start(ch);
+            }
+        }
+    }
+
+    bool IsValid() const { return m_valid && m_pending == 0; }
+
+private:
+    /// the lead byte of a sequence: the range of the next byte rejects overlong forms and surrogates
+    void Start(unsigned char ch)
+    {
+        m_min = 0x80;
+        m_max = 0xBF;
+        if (ch >= 0xC2 && ch <= 0xDF) {
+            m_pending = 1;
+        } else if (ch >= 0xE0 && ch <= 0xEF) {
+            m_pending = 2;
+            m_min = ch == 0xE0 ? 0xA0 : 0x80;
+            m_max = ch == 0xED ? 0x9F : 0xBF;
+        } else if (ch >= 0xF0 && ch <= 0xF4) {
+            m_pending = 3;
+            m_min = ch == 0xF0 ? 0x90 : 0x80;
+            m_max = ch == 0xF4 ? 0x8F : 0xBF;
+        } else {
+            m_valid = false;
+        }
+    }
+
+    size_t m_pending = 0;
+    unsigned char m_min = 0x80;
+    unsigned char m_max = 0xBF;
+    bool m_valid = true;
+};
+} // namespace
+
+clLargeFileLoader::~clLargeFileLoader() { Cancel(); }
+
+bool clLargeFileLoader::Load(const wxString& filename, ChunkCallback onChunk, DoneCallback onDone, size_t chunkSize)
+{
+    Cancel();
+    {
+        std::unique_lock lock{m_mutex};
+        m_pending = 0;
+    }
+    m_stop.store(false);
+    m_hasUtf8Bom.store(false);
+    m_isUtf8.store(true);
+
+    wxLogNull noLog;
+    if (!m_file.Open(filename, "rb")) {
+        clWARNING() << "Large file loader: failed to open file:" << filename << clEndl;
+        return false;
+    }
+
+    wxFileOffset length = m_file.Length();
+    size_t fileSize = length > 0 ? static_cast<size_t>(length) : 0;
+    clDEBUG() << "Large file loader: loading" << filename << "(" << fileSize << "bytes)" << clEndl;
+
+    m_running.store(true);
+    m_thread = std::thread(&clLargeFileLoader::Run,
+                           this,
+                           fileSize,
+                           std::max<size_t>(chunkSize, 1),
+                           std::move(onChunk),
+                           std::move(onDone));
+    return true;
+}
+
+void clLargeFileLoader::Run(size_t fileSize, size_t chunkSize, ChunkCallback onChunk, DoneCallback onDone)
+{
+    std::vector<char> buffer(chunkSize);
+    std::string carry; // the last line of the previous read, if it was incomplete
+    Utf8Validator validator;
+    size_t bytesRead = 0;
+    bool success = true;
+
+    while (!m_stop.load()) {
+        size_t count = m_file.Read(buffer.data(), buffer.size());
+        if (count == 0) {
+            success = !m_file.Error();
+            break;
+        }
+
+        const char* data = buffer.data();
+        if (bytesRead == 0 && count >= UTF8_BOM_LEN && std::memcmp(data, UTF8_BOM, UTF8_BOM_LEN) == 0) {
+            m_hasUtf8Bom.store(true);
+            data += UTF8_BOM_LEN;
+            count -= UTF8_BOM_LEN;
+            bytesRead += UTF8_BOM_LEN;
+        }
+        bytesRead += count;
+        validator.Feed(data, count);
+
+        auto chunk = std::make_shared<std::string>(std::move(carry));
+        carry.clear();
+        chunk->append(data, count);
+
+        // cut the chunk after its last line, unless a single line fills it
+        size_t lastEol = chunk->rfind('\n');
+        if (lastEol != std::string::npos && lastEol + 1 < chunk->size()) {
+            carry.assign(*chunk, lastEol + 1);
+            chunk->resize(lastEol + 1);
+        }
+
+        if (!WaitForSlot()) {
+            break;
+        }
+        onChunk(chunk, bytesRead - carry.size(), fileSize);
+    }
+
+    if (!carry.empty() && WaitForSlot()) {
+        onChunk(std::make_shared<std::string>(std::move(carry)), bytesRead, fileSize);
+    }
+    m_file.Close();
+    m_isUtf8.store(validator.IsValid());
+
+    bool cancelled = m_stop.load();
+    m_running.store(false);
+    if (!cancelled) {
+        onDone(success);
+    }
+}
+
+bool clLargeFileLoader::WaitForSlot()
+{
+    std::unique_lock lock{m_mutex};
+    m_cv.wait(lock, [this] { return m_stop.load() || m_pending < MAX_PENDING_CHUNKS; });
+    if (m_stop.load()) {
+        return false;
+    }
+    ++m_pending;
+    return true;
+}
+
+void clLargeFileLoader::Release()
+{
+    {
+        std::unique_lock lock{m_mutex};
+        if (m_pending > 0) {
+            --m_pending;
+        }
+    }
+    m_cv.notify_all();
+}
+
+void clLargeFileLoader::Cancel()
+{
+    {
+        std::unique_lock lock{m_mutex};
+        m_stop.store(true);
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    if (m_file.IsOpened()) {
+        m_file.Close();
+    }
+    m_running.store(false);
+}
+
+void clLargeFileLoader::Wait()
+{
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+bool clLargeFileLoader::IsLargeFile(const wxString& filename, size_t thresholdMB)
+{
+    if (thresholdMB == 0) {
+        return false;
+    }
+
+    wxULongLong size = wxFileName::GetSize(filename);
+    if (size == wxInvalidSize) {
+        return false;
+    }
+    return size.GetValue() >= static_cast<wxULongLong_t>(thresholdMB) * 1024 * 1024;
+}
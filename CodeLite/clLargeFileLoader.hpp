@@ -0,0 +1,92 @@
+#ifndef CLLARGEFILELOADER_HPP
+#define CLLARGEFILELOADER_HPP
+
+#include "codelite_exports.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <wx/ffile.h>
+#include <wx/string.h>
+
+/**
+ * @brief read a file in chunks on a worker thread.
+ *
+ * Used by the editor to open files that are too large to be read, converted and lexed in one go: each chunk is
+ * appended to the document as it arrives, so the editor is painted long before the whole file is read. Chunks end on
+ * a line boundary (unless a single line is longer than a chunk) and at most MAX_PENDING_CHUNKS chunks are in
+ * flight: the worker waits for the consumer to Release() a chunk before it reads the next one, so the memory used
+ * by the loader does not depend on the file size.
+ *
+ * The content is passed as is (UTF-8 is expected), only a leading UTF-8 BOM is removed. The content is validated as
+ * it is read: once the load is done, IsUtf8() tells if the file can be written back from the editor without loss.
+ */
+class WXDLLIMPEXP_CL clLargeFileLoader
+{
+public:
+    /// called on the worker thread with the next chunk of the file
+    using ChunkCallback = std::function<void(std::shared_ptr<std::string> chunk, size_t bytesRead, size_t fileSize)>;
+    /// called on the worker thread once the whole file was passed or reading it failed. Not called on Cancel()
+    using DoneCallback = std::function<void(bool success)>;
+
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 4 * 1024 * 1024;
+    static constexpr size_t MAX_PENDING_CHUNKS = 4;
+
+public:
+    clLargeFileLoader() = default;
+    ~clLargeFileLoader();
+
+    /**
+     * @brief start reading `filename`. Any previous load is cancelled first
+     * @return false if the file can't be opened
+     */
+    bool Load(const wxString& filename,
+              ChunkCallback onChunk,
+              DoneCallback onDone,
+              size_t chunkSize = DEFAULT_CHUNK_SIZE);
+
+    /**
+     * @brief the consumer is done with a chunk
+     */
+    void Release();
+
+    /**
+     * @brief stop the worker thread and wait for it. No callback is called once this returns
+     */
+    void Cancel();
+
+    /**
+     * @brief wait until the whole file was passed to the consumer. Don't call it from the thread releasing the chunks
+     */
+    void Wait();
+
+    bool IsRunning() const { return m_running.load(); }
+    bool HasUtf8Bom() const { return m_hasUtf8Bom.load(); }
+    /// false if the file is not valid UTF-8. Known once the whole file was read
+    bool IsUtf8() const { return m_isUtf8.load(); }
+
+    /**
+     * @brief should `filename` be opened in large file mode? A `thresholdMB` of 0 disables large file mode
+     */
+    static bool IsLargeFile(const wxString& filename, size_t thresholdMB);
+
+private:
+    void Run(size_t fileSize, size_t chunkSize, ChunkCallback onChunk, DoneCallback onDone);
+    bool WaitForSlot();
+
+    wxFFile m_file;
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    size_t m_pending = 0;
+    std::atomic_bool m_stop{false};
+    std::atomic_bool m_running{false};
+    std::atomic_bool m_hasUtf8Bom{false};
+    std::atomic_bool m_isUtf8{true};
+};
+
+#endif // CLLARGEFILELOADER_HPP
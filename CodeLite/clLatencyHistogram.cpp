@@ -0,0 +1,107 @@
+#include "clLatencyHistogram.hpp"
+
+#include "fileutils.h"
+
+#include <algorithm>
+
+namespace
+{
+constexpr uint64_t kLastBucketMs = 8192;
+
+uint64_t Percentile(const std::vector<uint64_t>& sorted, size_t p)
+{
+    if (sorted.empty()) {
+        return 0;
+    }
+    size_t rank = (std::min<size_t>(p, 100) * sorted.size() + 99) / 100;
+    return sorted[rank == 0 ? 0 : rank - 1];
+}
+} // namespace
+
+clLatencyHistogram::clLatencyHistogram(size_t window_size)
+    : m_windowSize{std::max<size_t>(window_size, 1)}
+{
+    m_samples.reserve(m_windowSize);
+}
+
+void clLatencyHistogram::Add(uint64_t latency_us)
+{
+    std::lock_guard lock{m_mutex};
+    if (m_samples.size() < m_windowSize) {
+        m_samples.push_back(latency_us);
+    } else {
+        // window is full: overwrite the oldest sample
+        m_samples[m_next] = latency_us;
+    }
+    m_next = (m_next + 1) % m_windowSize;
+}
+
+void clLatencyHistogram::Clear()
+{
+    std::lock_guard lock{m_mutex};
+    m_samples.clear();
+    m_next = 0;
+}
+
+size_t clLatencyHistogram::GetCount() const
+{
+    std::lock_guard lock{m_mutex};
+    return m_samples.size();
+}
+
+std::vector<uint64_t> clLatencyHistogram::GetSortedSamples() const
+{
+    std::vector<uint64_t> samples;
+    {
+        std::lock_guard lock{m_mutex};
+        samples = m_samples;
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples;
+}
+
+uint64_t clLatencyHistogram::GetPercentile(size_t p) const { return Percentile(GetSortedSamples(), p); }
+
+std::vector<std::pair<uint64_t, size_t>> clLatencyHistogram::GetBuckets() const
+{
+    std::vector<std::pair<uint64_t, size_t>> buckets;
+    for (uint64_t upper_ms = 1; upper_ms <= kLastBucketMs; upper_ms *= 2) {
+        buckets.push_back({upper_ms, 0});
+    }
+    buckets.push_back({UINT64_MAX, 0});
+
+    std::lock_guard lock{m_mutex};
+    for (uint64_t sample_us : m_samples) {
+        auto where = std::find_if(buckets.begin(), buckets.end(), [sample_us](const auto& bucket) {
+            return bucket.first == UINT64_MAX || sample_us <= bucket.first * 1000;
+        });
+        where->second++;
+    }
+    return buckets;
+}
+
+wxString clLatencyHistogram::ToCSV() const
+{
+    auto sorted = GetSortedSamples();
+    wxString csv;
+    csv << "# samples=" << sorted.size() << " p50_us=" << Percentile(sorted, 50) << " p95_us=" << Percentile(sorted, 95)
+        << " p99_us=" << Percentile(sorted, 99) << " max_us=" << (sorted.empty() ? 0 : sorted.back()) << "\n";
+    csv << "bucket_le_ms,count\n";
+    for (const auto& [upper_ms, count] : GetBuckets()) {
+        if (upper_ms == UINT64_MAX) {
+            csv << "inf";
+        } else {
+            csv << upper_ms;
+        }
+        csv << "," << count << "\n";
+    }
+    return csv;
+}
+
+bool clLatencyHistogram::Save(const wxFileName& path) const
+{
+    if (!path.DirExists()) {
+        path.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+    return FileUtils::WriteFileContent(path, ToCSV());
+}
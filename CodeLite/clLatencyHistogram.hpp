@@ -0,0 +1,46 @@
+#ifndef CLLATENCYHISTOGRAM_HPP
+#define CLLATENCYHISTOGRAM_HPP
+
+#include "codelite_exports.h"
+
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/string.h>
+
+/**
+ * @brief a thread safe latency histogram over a rolling window of the most recent samples.
+ * Buckets are powers of 2 in milliseconds (<=1ms, <=2ms, <=4ms ... <=8192ms and above)
+ */
+class WXDLLIMPEXP_CL clLatencyHistogram
+{
+public:
+    explicit clLatencyHistogram(size_t window_size = 6000);
+    ~clLatencyHistogram() = default;
+
+    void Add(uint64_t latency_us);
+    void Clear();
+    size_t GetCount() const;
+
+    /// Nearest-rank percentile (`p` in the range [0,100]) over the current window, in microseconds
+    uint64_t GetPercentile(size_t p) const;
+
+    /// Return pairs of {bucket upper bound in ms, count}. The last bucket upper bound is `UINT64_MAX`
+    std::vector<std::pair<uint64_t, size_t>> GetBuckets() const;
+
+    /// CSV export (a commented summary line followed by `bucket_le_ms,count` rows)
+    wxString ToCSV() const;
+    bool Save(const wxFileName& path) const;
+
+private:
+    std::vector<uint64_t> GetSortedSamples() const;
+
+    mutable std::mutex m_mutex;
+    std::vector<uint64_t> m_samples;
+    size_t m_next{0};
+    size_t m_windowSize{0};
+};
+
+#endif // CLLATENCYHISTOGRAM_HPP
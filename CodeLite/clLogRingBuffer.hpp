@@ -0,0 +1,100 @@
+#ifndef CLLOGRINGBUFFER_HPP
+#define CLLOGRINGBUFFER_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+/**
+ * @brief a bounded, lock-free, multi-producer / single-consumer queue of strings.
+ *
+ * Each slot carries a sequence number telling whether it is free for the producer that claimed its position or
+ * ready for the consumer (D. Vyukov's bounded queue). Producers only contend on the tail index.
+ */
+class clLogRingBuffer
+{
+public:
+    /// `capacity` is rounded up to a power of 2
+    explicit clLogRingBuffer(size_t capacity)
+    {
+        size_t size = 2;
+        while (size < capacity) {
+            size <<= 1;
+        }
+        m_mask = size - 1;
+        m_slots = std::make_unique<Slot[]>(size);
+        for (size_t i = 0; i < size; ++i) {
+            m_slots[i].seq.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    clLogRingBuffer(const clLogRingBuffer&) = delete;
+    clLogRingBuffer& operator=(const clLogRingBuffer&) = delete;
+
+    size_t GetCapacity() const { return m_mask + 1; }
+
+    /**
+     * @brief add `message` to the queue, can be called from any thread
+     * @return false if the queue is full, `message` is left untouched
+     */
+    bool TryPush(std::string& message)
+    {
+        size_t pos = m_tail.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = m_slots[pos & m_mask];
+            size_t seq = slot.seq.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    slot.data.swap(message);
+                    slot.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = m_tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief take the oldest message, must only be called from the consumer thread
+     * @return false if the queue is empty
+     */
+    bool TryPop(std::string& message)
+    {
+        size_t pos = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[pos & m_mask];
+        size_t seq = slot.seq.load(std::memory_order_acquire);
+        if (static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1) < 0) {
+            return false;
+        }
+        message.swap(slot.data);
+        slot.data.clear();
+        slot.seq.store(pos + m_mask + 1, std::memory_order_release);
+        m_head.store(pos + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    /// a hint only: producers may be adding messages concurrently
+    bool IsEmpty() const
+    {
+        return m_head.load(std::memory_order_relaxed) == m_tail.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Slot {
+        std::atomic_size_t seq{0};
+        std::string data;
+    };
+
+    std::unique_ptr<Slot[]> m_slots;
+    size_t m_mask = 0;
+    alignas(64) std::atomic_size_t m_head{0}; // consumer position
+    alignas(64) std::atomic_size_t m_tail{0}; // producers position
+};
+
+#endif // CLLOGRINGBUFFER_HPP
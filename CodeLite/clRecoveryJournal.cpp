@@ -0,0 +1,271 @@
+#include "clRecoveryJournal.hpp"
+
+#include "file_logger.h"
+
+#include <string_view>
+#include <unordered_set>
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/file.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/log.h>
+#include <wx/process.h>
+#include <wx/time.h>
+#include <wx/utils.h>
+
+namespace
+{
+constexpr const char* SESSION_PREFIX = "session-";
+
+/// the session directories opened by this process
+std::mutex& OpenSessionsMutex()
+{
+    static std::mutex mutex;
+    return mutex;
+}
+
+std::unordered_set<wxString>& OpenSessions()
+{
+    static std::unordered_set<wxString> sessions;
+    return sessions;
+}
+
+bool ReadRaw(const wxString& path, std::string& content)
+{
+    wxLogNull noLog;
+    wxFFile fp(path, "rb");
+    if (!fp.IsOpened()) {
+        return false;
+    }
+    wxFileOffset length = fp.Length();
+    content.resize(length > 0 ? static_cast<size_t>(length) : 0);
+    return content.empty() || fp.Read(content.data(), content.size()) == content.size();
+}
+} // namespace
+
+clRecoveryJournal::clRecoveryJournal(const wxString& root)
+{
+    static std::atomic_size_t counter{0};
+    // the process id identifies a session whose process is gone, the time and the counter make the name unique
+    wxString name;
+    name << SESSION_PREFIX << ::wxGetProcessId() << "-" << wxGetUTCTimeMillis().ToString() << "-" << counter++;
+    m_directory = wxFileName(root, "").GetPath();
+    m_directory << wxFileName::GetPathSeparator() << name;
+    wxFileName::Mkdir(m_directory, wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+
+    {
+        std::unique_lock lock{OpenSessionsMutex()};
+        OpenSessions().insert(m_directory);
+    }
+    m_thread = std::thread(&clRecoveryJournal::Run, this);
+}
+
+clRecoveryJournal::~clRecoveryJournal()
+{
+    DoStop();
+    std::unique_lock lock{OpenSessionsMutex()};
+    OpenSessions().erase(m_directory);
+}
+
+void clRecoveryJournal::Write(const wxString& filename, std::string content)
+{
+    {
+        std::unique_lock lock{m_mutex};
+        m_queue.erase(filename);
+        m_queue.insert({filename, std::move(content)});
+    }
+    m_cv.notify_one();
+}
+
+void clRecoveryJournal::Remove(const wxString& filename)
+{
+    {
+        std::unique_lock lock{m_mutex};
+        m_queue.erase(filename);
+        m_queue.insert({filename, std::nullopt});
+    }
+    m_cv.notify_one();
+}
+
+void clRecoveryJournal::Flush()
+{
+    std::unique_lock lock{m_mutex};
+    m_cvIdle.wait(lock, [this] { return m_stop || (m_queue.empty() && !m_busy); });
+}
+
+void clRecoveryJournal::Discard()
+{
+    DoStop();
+    DeleteSession(m_directory);
+}
+
+void clRecoveryJournal::DoStop()
+{
+    {
+        std::unique_lock lock{m_mutex};
+        m_stop = true;
+    }
+    m_cv.notify_all();
+    m_cvIdle.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+void clRecoveryJournal::Run()
+{
+    while (true) {
+        std::unordered_map<wxString, std::optional<std::string>> queue;
+        {
+            std::unique_lock lock{m_mutex};
+            m_busy = false;
+            m_cvIdle.notify_all();
+            m_cv.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+            if (m_stop) {
+                return;
+            }
+            queue.swap(m_queue);
+            m_busy = true;
+        }
+
+        for (const auto& [filename, content] : queue) {
+            if (content.has_value()) {
+                DoWrite(filename, content.value());
+            } else {
+                DoRemove(filename);
+            }
+        }
+    }
+}
+
+void clRecoveryJournal::DoWrite(const wxString& filename, const std::string& content)
+{
+    size_t hash = std::hash<std::string_view>{}(content);
+    auto iter = m_hashes.find(filename);
+    if (iter != m_hashes.end() && iter->second == hash) {
+        // unchanged since the last snapshot
+        return;
+    }
+
+    // the header is the file name, followed by the content
+    wxString tmpPath = GetSnapshotPath(filename, "tmp");
+    wxFile fp;
+    if (!fp.Create(tmpPath, true)) {
+        clWARNING() << "Recovery journal: failed to create:" << tmpPath << endl;
+        return;
+    }
+
+    std::string header = filename.ToStdString(wxConvUTF8) + "\n";
+    bool ok = fp.Write(header.data(), header.size()) == header.size() &&
+              fp.Write(content.data(), content.size()) == content.size() && fp.Flush();
+    fp.Close();
+
+    // replace the previous snapshot only once the new one is complete
+    if (!ok || !::wxRenameFile(tmpPath, GetSnapshotPath(filename, "snapshot"), true)) {
+        clWARNING() << "Recovery journal: failed to write the snapshot of:" << filename << endl;
+        ::wxRemoveFile(tmpPath);
+        return;
+    }
+    m_hashes.erase(filename);
+    m_hashes.insert({filename, hash});
+    ++m_writeCount;
+}
+
+void clRecoveryJournal::DoRemove(const wxString& filename)
+{
+    wxLogNull noLog;
+    m_hashes.erase(filename);
+    wxString path = GetSnapshotPath(filename, "snapshot");
+    if (wxFileName::FileExists(path)) {
+        ::wxRemoveFile(path);
+    }
+}
+
+wxString clRecoveryJournal::GetSnapshotPath(const wxString& filename, const wxString& ext) const
+{
+    // the real name is in the header of the snapshot
+    wxString path = m_directory;
+    path << wxFileName::GetPathSeparator()
+         << wxString::Format("%016llx", (unsigned long long)std::hash<wxString>{}(filename)) << "." << ext;
+    return path;
+}
+
+std::vector<wxString> clRecoveryJournal::FindOrphanedSessions(const wxString& root)
+{
+    std::vector<wxString> sessions;
+    wxLogNull noLog;
+    wxDir dir(root);
+    if (!dir.IsOpened()) {
+        return sessions;
+    }
+
+    wxString name;
+    for (bool cont = dir.GetFirst(&name, wxString(SESSION_PREFIX) + "*", wxDIR_DIRS); cont;
+         cont = dir.GetNext(&name)) {
+        wxString path = wxFileName(root, "").GetPath() + wxFileName::GetPathSeparator() + name;
+        unsigned long pid = 0;
+        if (!name.Mid(wxStrlen(SESSION_PREFIX)).BeforeFirst('-').ToCULong(&pid)) {
+            continue;
+        }
+
+        bool isOrphaned = false;
+        if (pid == ::wxGetProcessId()) {
+            // a session of this process, or of a previous process that had the same id
+            std::unique_lock lock{OpenSessionsMutex()};
+            isOrphaned = OpenSessions().count(path) == 0;
+        } else {
+            isOrphaned = !wxProcess::Exists(static_cast<int>(pid));
+        }
+
+        if (isOrphaned) {
+            sessions.push_back(path);
+        }
+    }
+    return sessions;
+}
+
+std::vector<clRecoveryJournal::Snapshot> clRecoveryJournal::LoadSession(const wxString& directory)
+{
+    std::vector<Snapshot> snapshots;
+    wxArrayString files;
+    {
+        wxLogNull noLog;
+        // a ".tmp" file is a snapshot that was not complete
+        wxDir::GetAllFiles(directory, &files, "*.snapshot", wxDIR_FILES);
+    }
+
+    for (const auto& file : files) {
+        std::string data;
+        if (!ReadRaw(file, data)) {
+            continue;
+        }
+        size_t eol = data.find('\n');
+        if (eol == std::string::npos) {
+            continue;
+        }
+
+        Snapshot snapshot;
+        snapshot.filename = wxString::FromUTF8(data.data(), eol);
+        snapshot.content = data.substr(eol + 1);
+        snapshots.push_back(std::move(snapshot));
+    }
+    return snapshots;
+}
+
+void clRecoveryJournal::DeleteSession(const wxString& directory)
+{
+    wxLogNull noLog;
+    if (wxFileName::DirExists(directory)) {
+        wxFileName::Rmdir(directory, wxPATH_RMDIR_RECURSIVE);
+    }
+}
+
+bool clRecoveryJournal::DiffersFromDisk(const Snapshot& snapshot)
+{
+    std::string content;
+    if (!ReadRaw(snapshot.filename, content)) {
+        return true;
+    }
+    return content != snapshot.content;
+}
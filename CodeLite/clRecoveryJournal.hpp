@@ -0,0 +1,103 @@
+#ifndef CLRECOVERYJOURNAL_HPP
+#define CLRECOVERYJOURNAL_HPP
+
+#include "codelite_exports.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief a crash recovery journal: snapshots of the modified files, written to a directory of this session.
+ *
+ * The snapshots are written on a worker thread, with a write to a temporary file followed by a rename: a crash
+ * while writing leaves the previous snapshot. A snapshot whose content did not change since the last one is not
+ * written again. The session directory is deleted by Discard() when the session ends normally; the directory of a
+ * session that did not (its process is gone) is found by FindOrphanedSessions() on the next start.
+ */
+class WXDLLIMPEXP_CL clRecoveryJournal
+{
+public:
+    struct Snapshot {
+        wxString filename;
+        /// the content, as in the editor (UTF-8)
+        std::string content;
+    };
+
+public:
+    /// start a session in a new directory under `root`
+    clRecoveryJournal(const wxString& root);
+    /// stop the worker. The snapshots are kept, unless Discard() was called
+    ~clRecoveryJournal();
+
+    /**
+     * @brief snapshot `content` as the content of `filename`. Only the last content queued for a file is written
+     */
+    void Write(const wxString& filename, std::string content);
+
+    /**
+     * @brief delete the snapshot of `filename` (e.g. the file was saved, or closed without saving)
+     */
+    void Remove(const wxString& filename);
+
+    /**
+     * @brief wait until the queued snapshots are written
+     */
+    void Flush();
+
+    /**
+     * @brief the session ended normally: stop the worker and delete the session directory
+     */
+    void Discard();
+
+    const wxString& GetSessionDirectory() const { return m_directory; }
+    /// the number of snapshots written to the disk
+    size_t GetWriteCount() const { return m_writeCount.load(); }
+
+    /**
+     * @brief the session directories under `root` whose process is gone
+     */
+    static std::vector<wxString> FindOrphanedSessions(const wxString& root);
+
+    /**
+     * @brief the snapshots of the session in `directory`
+     */
+    static std::vector<Snapshot> LoadSession(const wxString& directory);
+
+    static void DeleteSession(const wxString& directory);
+
+    /**
+     * @brief is the snapshot different from the file on the disk (or is the file gone)?
+     */
+    static bool DiffersFromDisk(const Snapshot& snapshot);
+
+private:
+    void Run();
+    void DoWrite(const wxString& filename, const std::string& content);
+    void DoRemove(const wxString& filename);
+    void DoStop();
+    wxString GetSnapshotPath(const wxString& filename, const wxString& ext) const;
+
+    wxString m_directory;
+
+    // the queued snapshots: a content to write, or nullopt to delete the snapshot
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::condition_variable m_cvIdle;
+    std::unordered_map<wxString, std::optional<std::string>> m_queue;
+    bool m_busy = false;
+    bool m_stop = false;
+
+    // used by the worker only: the hash of the last snapshot of each file
+    std::unordered_map<wxString, size_t> m_hashes;
+    std::atomic_size_t m_writeCount{0};
+    std::thread m_thread;
+};
+
+#endif // CLRECOVERYJOURNAL_HPP
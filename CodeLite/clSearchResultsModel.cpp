@@ -0,0 +1,225 @@
+#include "clSearchResultsModel.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace
+{
+inline uint32_t ToUInt32(int value) { return value < 0 ? 0 : static_cast<uint32_t>(value); }
+
+template <typename T> size_t VectorMemory(const std::vector<T>& v) { return v.capacity() * sizeof(T); }
+
+size_t StringMemory(const wxString& str) { return sizeof(wxString) + str.length() * sizeof(wxChar); }
+} // namespace
+
+void clSearchResultsModel::Append(const SearchResult& result)
+{
+    if (m_files.empty() || m_files.back().name != result.GetFileName()) {
+        File file;
+        file.name = result.GetFileName();
+        file.findWhat = result.GetFindWhat();
+        file.flags = result.GetFlags();
+        file.first = m_lines.size();
+        file.expanded = m_expandNewFiles;
+        m_files.push_back(std::move(file));
+    }
+
+    File& file = m_files.back();
+    size_t index = m_lines.size();
+    uint32_t line = ToUInt32(result.GetLineNumber());
+
+    // several matches on the same line share its text
+    const wxScopedCharBuffer utf8 = result.GetPattern().utf8_str();
+    uint32_t offset = 0;
+    uint32_t length = 0;
+    if (file.count > 0 && m_lines.back() == line && m_textLengths.back() == utf8.length() &&
+        std::memcmp(m_text.data() + m_textOffsets.back(), utf8.data(), utf8.length()) == 0) {
+        offset = m_textOffsets.back();
+        length = m_textLengths.back();
+
+    } else if (m_text.size() + utf8.length() <= std::numeric_limits<uint32_t>::max()) {
+        offset = static_cast<uint32_t>(m_text.size());
+        length = static_cast<uint32_t>(utf8.length());
+        m_text.append(utf8.data(), utf8.length());
+    }
+
+    m_lines.push_back(line);
+    m_columns.push_back(ToUInt32(result.GetColumn()));
+    m_lens.push_back(ToUInt32(result.GetLen()));
+    m_columnsInChars.push_back(ToUInt32(result.GetColumnInChars()));
+    m_lensInChars.push_back(ToUInt32(result.GetLenInChars()));
+    m_positions.push_back(result.GetPosition());
+    m_textOffsets.push_back(offset);
+    m_textLengths.push_back(length);
+    m_scopes.push_back(AddScope(result.GetScope()));
+    if (!result.GetRegexCaptures().empty()) {
+        m_regexCaptures.insert({index, result.GetRegexCaptures()});
+    }
+    ++file.count;
+}
+
+void clSearchResultsModel::Append(const SearchResultList& results)
+{
+    for (const auto& result : results) {
+        Append(result);
+    }
+}
+
+void clSearchResultsModel::Clear()
+{
+    // release the memory as well: a model can hold millions of matches
+    bool expandNewFiles = m_expandNewFiles;
+    *this = clSearchResultsModel();
+    m_expandNewFiles = expandNewFiles;
+}
+
+uint32_t clSearchResultsModel::AddScope(const wxString& scope)
+{
+    if (scope.empty()) {
+        return 0;
+    }
+
+    auto iter = m_scopeIds.find(scope);
+    if (iter != m_scopeIds.end()) {
+        return iter->second;
+    }
+    uint32_t id = static_cast<uint32_t>(m_scopeNames.size());
+    m_scopeNames.push_back(scope);
+    m_scopeIds.insert({scope, id});
+    return id;
+}
+
+SearchResult clSearchResultsModel::GetMatch(size_t index) const
+{
+    const File& file = m_files[GetFileOfMatch(index)];
+
+    SearchResult result;
+    result.SetFileName(file.name);
+    result.SetFindWhat(file.findWhat);
+    result.SetFlags(file.flags);
+    result.SetLineNumber(static_cast<int>(m_lines[index]));
+    result.SetColumn(static_cast<int>(m_columns[index]));
+    result.SetLen(static_cast<int>(m_lens[index]));
+    result.SetColumnInChars(static_cast<int>(m_columnsInChars[index]));
+    result.SetLenInChars(static_cast<int>(m_lensInChars[index]));
+    result.SetPosition(m_positions[index]);
+    result.SetPattern(GetLineText(index));
+    result.SetScope(m_scopeNames[m_scopes[index]]);
+
+    auto iter = m_regexCaptures.find(index);
+    if (iter != m_regexCaptures.end()) {
+        result.SetRegexCaptures(iter->second);
+    }
+    return result;
+}
+
+wxString clSearchResultsModel::GetLineText(size_t index) const
+{
+    return wxString::FromUTF8(m_text.data() + m_textOffsets[index], m_textLengths[index]);
+}
+
+size_t clSearchResultsModel::GetFileOfMatch(size_t index) const
+{
+    auto iter = std::upper_bound(
+        m_files.begin(), m_files.end(), index, [](size_t match, const File& file) { return match < file.first; });
+    return static_cast<size_t>(iter - m_files.begin()) - 1;
+}
+
+void clSearchResultsModel::SetExpanded(size_t file, bool expanded)
+{
+    if (m_files[file].expanded == expanded) {
+        return;
+    }
+    m_files[file].expanded = expanded;
+    // the rows of the files below have moved
+    m_validFileRows = std::min(m_validFileRows, file + 1);
+}
+
+void clSearchResultsModel::SetAllExpanded(bool expanded)
+{
+    for (auto& file : m_files) {
+        file.expanded = expanded;
+    }
+    m_validFileRows = 0;
+}
+
+void clSearchResultsModel::UpdateRows() const
+{
+    // the row of a file only depends on the files above it, which don't change once a new file is added
+    m_fileRows.resize(m_files.size());
+    for (size_t i = m_validFileRows; i < m_files.size(); ++i) {
+        if (i == 0) {
+            m_fileRows[i] = 0;
+        } else {
+            const File& prev = m_files[i - 1];
+            m_fileRows[i] = m_fileRows[i - 1] + 1 + (prev.expanded ? prev.count : 0);
+        }
+    }
+    m_validFileRows = m_files.size();
+}
+
+size_t clSearchResultsModel::GetRowCount() const
+{
+    if (m_files.empty()) {
+        return 0;
+    }
+    UpdateRows();
+    const File& last = m_files.back();
+    return m_fileRows.back() + 1 + (last.expanded ? last.count : 0);
+}
+
+clSearchResultsModel::Row clSearchResultsModel::GetRow(size_t row) const
+{
+    Row result;
+    if (row >= GetRowCount()) {
+        return result;
+    }
+
+    auto iter = std::upper_bound(m_fileRows.begin(), m_fileRows.end(), row);
+    result.file = static_cast<size_t>(iter - m_fileRows.begin()) - 1;
+    size_t offset = row - m_fileRows[result.file];
+    if (offset > 0) {
+        result.match = m_files[result.file].first + offset - 1;
+    }
+    return result;
+}
+
+size_t clSearchResultsModel::GetFileRow(size_t file) const
+{
+    UpdateRows();
+    return m_fileRows[file];
+}
+
+size_t clSearchResultsModel::GetMatchRow(size_t index) const
+{
+    size_t file = GetFileOfMatch(index);
+    if (!m_files[file].expanded) {
+        return npos;
+    }
+    return GetFileRow(file) + 1 + (index - m_files[file].first);
+}
+
+size_t clSearchResultsModel::GetMemoryUsage() const
+{
+    size_t bytes = sizeof(*this);
+    bytes += VectorMemory(m_lines) + VectorMemory(m_columns) + VectorMemory(m_lens) + VectorMemory(m_columnsInChars) +
+             VectorMemory(m_lensInChars) + VectorMemory(m_positions) + VectorMemory(m_textOffsets) +
+             VectorMemory(m_textLengths) + VectorMemory(m_scopes) + VectorMemory(m_fileRows);
+    bytes += m_text.capacity();
+
+    bytes += VectorMemory(m_files);
+    for (const auto& file : m_files) {
+        bytes += (StringMemory(file.name) - sizeof(wxString)) + (StringMemory(file.findWhat) - sizeof(wxString));
+    }
+    for (const auto& scope : m_scopeNames) {
+        bytes += StringMemory(scope) * 2; // + the key of m_scopeIds
+    }
+    for (const auto& [index, captures] : m_regexCaptures) {
+        bytes += sizeof(index) + sizeof(captures);
+        for (const auto& capture : captures) {
+            bytes += StringMemory(capture);
+        }
+    }
+    return bytes;
+}
@@ -0,0 +1,121 @@
+#ifndef CLSEARCHRESULTSMODEL_HPP
+#define CLSEARCHRESULTSMODEL_HPP
+
+#include "codelite_exports.h"
+#include "search_thread.h"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief the matches of a "Find In Files" search, grouped by file.
+ *
+ * The matches are stored column by column in flat arrays and the matched lines in a single UTF-8 buffer (a line
+ * with several matches is stored once), so a search with millions of hits costs a few dozen bytes per hit.
+ *
+ * The model also maps the rows of a tree-like view (a row per file followed, if the file is expanded, by a row per
+ * match) to the files and matches, so the view only has to render the rows on screen.
+ */
+class WXDLLIMPEXP_CL clSearchResultsModel
+{
+public:
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+    struct Row {
+        size_t file = npos;
+        size_t match = npos; ///< npos for the row of the file itself
+        bool IsFile() const { return match == npos; }
+    };
+
+public:
+    clSearchResultsModel() = default;
+
+    /**
+     * @brief add matches. The matches of a file are expected to be added one after the other, as the search thread
+     * does
+     */
+    void Append(const SearchResult& result);
+    void Append(const SearchResultList& results);
+    void Clear();
+
+    size_t GetMatchCount() const { return m_lines.size(); }
+    size_t GetFileCount() const { return m_files.size(); }
+    bool IsEmpty() const { return m_lines.empty(); }
+
+    /// build back the SearchResult of match `index`
+    SearchResult GetMatch(size_t index) const;
+    int GetLineNumber(size_t index) const { return static_cast<int>(m_lines[index]); }
+    int GetColumnInChars(size_t index) const { return static_cast<int>(m_columnsInChars[index]); }
+    int GetLenInChars(size_t index) const { return static_cast<int>(m_lensInChars[index]); }
+    /// the text of the matched line
+    wxString GetLineText(size_t index) const;
+    size_t GetFileOfMatch(size_t index) const;
+
+    const wxString& GetFileName(size_t file) const { return m_files[file].name; }
+    size_t GetFileMatchCount(size_t file) const { return m_files[file].count; }
+    size_t GetFileFirstMatch(size_t file) const { return m_files[file].first; }
+
+    /**
+     * @brief collapse or expand the matches of a file in the view
+     */
+    void SetExpanded(size_t file, bool expanded);
+    bool IsExpanded(size_t file) const { return m_files[file].expanded; }
+    void SetAllExpanded(bool expanded);
+    /// new files are added expanded (the default) or collapsed
+    void SetExpandNewFiles(bool expanded) { m_expandNewFiles = expanded; }
+
+    /**
+     * @brief the number of rows of the view
+     */
+    size_t GetRowCount() const;
+    Row GetRow(size_t row) const;
+    size_t GetFileRow(size_t file) const;
+    /// the row of match `index`, npos if its file is collapsed
+    size_t GetMatchRow(size_t index) const;
+
+    /**
+     * @brief the memory used by the model, in bytes
+     */
+    size_t GetMemoryUsage() const;
+
+private:
+    struct File {
+        wxString name;
+        wxString findWhat; ///< the matches of a file come from a single search
+        size_t flags = 0;
+        size_t first = 0;
+        size_t count = 0;
+        bool expanded = true;
+    };
+
+    void UpdateRows() const;
+    uint32_t AddScope(const wxString& scope);
+
+    std::vector<File> m_files;
+
+    // the matches, one entry per match in each array
+    std::vector<uint32_t> m_lines;
+    std::vector<uint32_t> m_columns;
+    std::vector<uint32_t> m_lens;
+    std::vector<uint32_t> m_columnsInChars;
+    std::vector<uint32_t> m_lensInChars;
+    std::vector<int32_t> m_positions;
+    std::vector<uint32_t> m_textOffsets;
+    std::vector<uint32_t> m_textLengths;
+    std::vector<uint32_t> m_scopes; ///< index in m_scopeNames, 0 for no scope
+
+    std::string m_text;
+    std::vector<wxString> m_scopeNames{wxString()};
+    std::unordered_map<wxString, uint32_t> m_scopeIds;
+    std::unordered_map<size_t, wxArrayString> m_regexCaptures; ///< only the matches with captures
+
+    // the first row of each file, rebuilt when a file is collapsed or expanded
+    mutable std::vector<size_t> m_fileRows;
+    mutable size_t m_validFileRows = 0;
+    bool m_expandNewFiles = true;
+};
+
+#endif // CLSEARCHRESULTSMODEL_HPP
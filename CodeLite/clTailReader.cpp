@@ -0,0 +1,499 @@
+#include "clTailReader.hpp"
+
+#include "file_logger.h"
+
+#include <algorithm>
+#include <cstring>
+#include <sys/stat.h>
+#include <wx/log.h>
+#include <wx/regex.h>
+
+#ifdef __WXMSW__
+#define cl_stat _wstat64
+using cl_stat_t = struct _stat64;
+#else
+#include <unistd.h>
+#define cl_fileno fileno
+#define cl_fstat fstat
+#define cl_stat stat
+using cl_stat_t = struct stat;
+#endif
+
+namespace
+{
+bool ContainsNoCase(const wxString& lower, const char* word) { return lower.find(word) != wxString::npos; }
+} // namespace
+
+clTailReader::clTailReader(size_t chunkSize)
+    : m_chunkSize(std::max<size_t>(chunkSize, 1))
+{
+}
+
+clTailReader::~clTailReader()
+{
+    Stop();
+    Close();
+}
+
+bool clTailReader::Open(const wxString& filename, size_t startPos)
+{
+    Close();
+    std::unique_lock lock{m_fileMutex};
+    m_filename = filename;
+    return DoOpenFile(startPos);
+}
+
+void clTailReader::Close()
+{
+    {
+        std::unique_lock lock{m_fileMutex};
+        if (m_file.IsOpened()) {
+            m_file.Close();
+        }
+        m_filename.clear();
+        m_carry.clear();
+        m_pos = 0;
+    }
+
+    std::unique_lock lock{m_mutex};
+    m_lines.clear();
+    m_pending.clear();
+    m_dropped = 0;
+    m_reset = true;
+    m_notified = false;
+}
+
+bool clTailReader::DoOpenFile(size_t startPos)
+{
+    wxLogNull noLog;
+    if (m_file.IsOpened()) {
+        m_file.Close();
+    }
+    m_carry.clear();
+    m_pos = 0;
+
+    if (!m_file.Open(m_filename, "rb")) {
+        clDEBUG() << "Tail: failed to open file:" << m_filename << clEndl;
+        return false;
+    }
+
+    GetFileId(m_file, m_fileId);
+    wxFileOffset length = m_file.Length();
+    size_t size = length > 0 ? static_cast<size_t>(length) : 0;
+    m_pos = std::min(startPos, size);
+    return true;
+}
+
+bool clTailReader::IsOpen() const
+{
+    std::unique_lock lock{m_fileMutex};
+    return m_file.IsOpened();
+}
+
+size_t clTailReader::GetPosition() const
+{
+    std::unique_lock lock{m_fileMutex};
+    return m_pos;
+}
+
+void clTailReader::Start(NotifyCallback onLines, std::chrono::milliseconds interval)
+{
+    Stop();
+    NotifyCallback notify;
+    {
+        std::unique_lock lock{m_mutex};
+        m_onLines = std::move(onLines);
+        // the lines (or the filters) changed while paused
+        m_notified = !m_pending.empty() || m_reset;
+        if (m_notified) {
+            notify = m_onLines;
+        }
+    }
+    m_stop.store(false);
+    m_running.store(true);
+    m_thread = std::thread(&clTailReader::Run, this, interval);
+
+    if (notify) {
+        notify();
+    }
+}
+
+void clTailReader::Stop()
+{
+    {
+        std::unique_lock lock{m_wakeMutex};
+        m_stop.store(true);
+    }
+    m_wakeCv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+    m_running.store(false);
+
+    std::unique_lock lock{m_mutex};
+    m_onLines = nullptr;
+}
+
+void clTailReader::Wake()
+{
+    {
+        std::unique_lock lock{m_wakeMutex};
+        m_wake = true;
+    }
+    m_wakeCv.notify_all();
+}
+
+void clTailReader::Run(std::chrono::milliseconds interval)
+{
+    while (!m_stop.load()) {
+        Poll();
+
+        std::unique_lock lock{m_wakeMutex};
+        m_wakeCv.wait_for(lock, interval, [this] { return m_stop.load() || m_wake; });
+        m_wake = false;
+    }
+}
+
+void clTailReader::Poll()
+{
+    std::unique_lock lock{m_fileMutex};
+    if (m_filename.empty()) {
+        return;
+    }
+
+    if (!m_file.IsOpened()) {
+        // the file did not exist yet
+        if (DoOpenFile(0)) {
+            DoAddNotice(_(">>> File created <<<"));
+        }
+        if (!m_file.IsOpened()) {
+            return;
+        }
+    }
+
+    FileId pathId;
+    size_t pathSize = 0;
+    bool exists = GetFileId(m_filename, pathId, pathSize);
+    if (exists && pathId != m_fileId) {
+        // rotated or replaced: read what was written to the old file before following the new one
+        DoReadAvailable();
+        if (!m_carry.empty()) {
+            DoProcess("\n", 1);
+        }
+        if (DoOpenFile(0)) {
+            DoAddNotice(_(">>> File rotated <<<"));
+        }
+    } else if (exists && pathSize < m_pos) {
+        DoAddNotice(_(">>> File truncated <<<"));
+        m_carry.clear();
+        m_pos = 0;
+    }
+
+    if (m_file.IsOpened()) {
+        DoReadAvailable();
+    }
+}
+
+void clTailReader::DoReadAvailable()
+{
+    // seeking clears the end of file flag left by the previous read
+    if (!m_file.Seek(m_pos)) {
+        return;
+    }
+
+    m_buffer.resize(m_chunkSize);
+    while (true) {
+        if (m_running.load() && m_stop.load()) {
+            // the worker is stopping
+            break;
+        }
+
+        size_t count = m_file.Read(m_buffer.data(), m_buffer.size());
+        if (count == 0) {
+            break;
+        }
+        m_pos += count;
+        DoProcess(m_buffer.data(), count);
+        if (count < m_buffer.size()) {
+            break;
+        }
+    }
+}
+
+void clTailReader::DoProcess(const char* data, size_t len)
+{
+    std::vector<Line> lines;
+    const char* end = data + len;
+    const char* lineStart = data;
+    while (lineStart < end) {
+        const char* eol = static_cast<const char*>(std::memchr(lineStart, '\n', end - lineStart));
+        if (eol == nullptr) {
+            break;
+        }
+
+        if (m_carry.empty()) {
+            lines.push_back(MakeLine(lineStart, eol - lineStart));
+        } else {
+            m_carry.append(lineStart, eol - lineStart);
+            lines.push_back(MakeLine(m_carry.data(), m_carry.size()));
+            m_carry.clear();
+        }
+        lineStart = eol + 1;
+    }
+    m_carry.append(lineStart, end - lineStart);
+
+    // a line without end: split it, but not in the middle of a character
+    while (m_carry.size() >= MAX_LINE_BYTES) {
+        size_t size = Utf8Boundary(m_carry.data(), MAX_LINE_BYTES);
+        if (size == 0) {
+            size = MAX_LINE_BYTES;
+        }
+        lines.push_back(MakeLine(m_carry.data(), size));
+        m_carry.erase(0, size);
+    }
+
+    if (!lines.empty()) {
+        DoAddLines(std::move(lines));
+    }
+}
+
+void clTailReader::DoAddNotice(const wxString& message)
+{
+    std::vector<Line> lines;
+    lines.push_back({message, Severity::kNotice});
+    DoAddLines(std::move(lines));
+}
+
+void clTailReader::DoAddLines(std::vector<Line>&& lines)
+{
+    NotifyCallback notify;
+    {
+        std::unique_lock lock{m_mutex};
+        // only the last m_maxLines lines can be seen
+        size_t first = lines.size() > m_maxLines ? lines.size() - m_maxLines : 0;
+        for (size_t i = first; i < lines.size(); ++i) {
+            if (IsVisible(lines[i])) {
+                DoPushPending(lines[i]);
+            }
+            m_lines.push_back(std::move(lines[i]));
+        }
+        while (m_lines.size() > m_maxLines) {
+            m_lines.pop_front();
+        }
+        m_dropped += first;
+
+        // nobody is notified while paused: Start() does it
+        if (!m_pending.empty() && !m_notified && m_onLines) {
+            m_notified = true;
+            notify = m_onLines;
+        }
+    }
+
+    if (notify) {
+        notify();
+    }
+}
+
+void clTailReader::DoPushPending(const Line& line)
+{
+    m_pending.push_back(line);
+    if (m_pending.size() > m_maxLines) {
+        m_pending.pop_front();
+        ++m_dropped;
+    }
+}
+
+bool clTailReader::IsVisible(const Line& line) const
+{
+    if (line.severity == Severity::kNotice) {
+        return true;
+    }
+    if (m_include && !m_include->Matches(line.text)) {
+        return false;
+    }
+    return !(m_exclude && m_exclude->Matches(line.text));
+}
+
+clTailReader::Update clTailReader::TakeUpdate()
+{
+    std::unique_lock lock{m_mutex};
+    Update update;
+    update.reset = m_reset;
+    update.dropped = m_dropped;
+    update.lines.reserve(m_pending.size());
+    std::move(m_pending.begin(), m_pending.end(), std::back_inserter(update.lines));
+
+    m_pending.clear();
+    m_reset = false;
+    m_dropped = 0;
+    m_notified = false;
+    return update;
+}
+
+void clTailReader::SetMaxLines(size_t maxLines)
+{
+    std::unique_lock lock{m_mutex};
+    m_maxLines = std::max<size_t>(maxLines, 1);
+    while (m_lines.size() > m_maxLines) {
+        m_lines.pop_front();
+    }
+    while (m_pending.size() > m_maxLines) {
+        m_pending.pop_front();
+        ++m_dropped;
+    }
+}
+
+size_t clTailReader::GetMaxLines() const
+{
+    std::unique_lock lock{m_mutex};
+    return m_maxLines;
+}
+
+size_t clTailReader::GetLineCount() const
+{
+    std::unique_lock lock{m_mutex};
+    return m_lines.size();
+}
+
+bool clTailReader::SetFilters(const wxString& include, const wxString& exclude)
+{
+    std::unique_ptr<wxRegEx> includeRe;
+    std::unique_ptr<wxRegEx> excludeRe;
+    {
+        wxLogNull noLog;
+        if (!include.empty()) {
+            includeRe = std::make_unique<wxRegEx>(include, wxRE_ADVANCED | wxRE_ICASE);
+            if (!includeRe->IsValid()) {
+                return false;
+            }
+        }
+        if (!exclude.empty()) {
+            excludeRe = std::make_unique<wxRegEx>(exclude, wxRE_ADVANCED | wxRE_ICASE);
+            if (!excludeRe->IsValid()) {
+                return false;
+            }
+        }
+    }
+
+    NotifyCallback notify;
+    {
+        std::unique_lock lock{m_mutex};
+        m_include.swap(includeRe);
+        m_exclude.swap(excludeRe);
+
+        // filter the kept lines again
+        m_pending.clear();
+        m_dropped = 0;
+        m_reset = true;
+        for (const auto& line : m_lines) {
+            if (IsVisible(line)) {
+                m_pending.push_back(line);
+            }
+        }
+
+        if (!m_notified && m_onLines) {
+            m_notified = true;
+            notify = m_onLines;
+        }
+    }
+
+    if (notify) {
+        notify();
+    }
+    return true;
+}
+
+clTailReader::Severity clTailReader::GetSeverity(const wxString& line)
+{
+    wxString lower = line.Lower();
+    if (ContainsNoCase(lower, "error") || ContainsNoCase(lower, "fatal") || ContainsNoCase(lower, "critical")) {
+        return Severity::kError;
+    }
+    if (ContainsNoCase(lower, "warn")) {
+        return Severity::kWarning;
+    }
+    return Severity::kNone;
+}
+
+size_t clTailReader::Utf8Boundary(const char* data, size_t len)
+{
+    // find the start of the last sequence
+    size_t start = len;
+    size_t continuation = 0;
+    while (start > 0 && continuation < 4) {
+        unsigned char ch = static_cast<unsigned char>(data[start - 1]);
+        if ((ch & 0xC0) != 0x80) {
+            break;
+        }
+        --start;
+        ++continuation;
+    }
+    if (start == 0) {
+        return len;
+    }
+
+    unsigned char lead = static_cast<unsigned char>(data[start - 1]);
+    size_t expected = 1;
+    if ((lead & 0xE0) == 0xC0) {
+        expected = 2;
+    } else if ((lead & 0xF0) == 0xE0) {
+        expected = 3;
+    } else if ((lead & 0xF8) == 0xF0) {
+        expected = 4;
+    }
+    // an incomplete sequence is left out
+    return continuation + 1 < expected ? start - 1 : len;
+}
+
+clTailReader::Line clTailReader::MakeLine(const char* data, size_t len)
+{
+    if (len > 0 && data[len - 1] == '\r') {
+        --len;
+    }
+
+    Line line;
+    line.text = wxString::FromUTF8(data, len);
+    if (line.text.empty() && len > 0) {
+        // not UTF-8
+        line.text = wxString::From8BitData(data, len);
+    }
+    line.severity = GetSeverity(line.text);
+    return line;
+}
+
+bool clTailReader::GetFileId(const wxString& path, FileId& id, size_t& size)
+{
+    cl_stat_t st;
+#ifdef __WXMSW__
+    if (cl_stat(path.wc_str(), &st) != 0) {
+        return false;
+    }
+    // st_ino is always 0 and st_dev differs between stat and fstat: a replaced file is only detected when it is
+    // smaller than the old one
+    id = {};
+#else
+    if (cl_stat(path.mb_str(wxConvUTF8).data(), &st) != 0) {
+        return false;
+    }
+    id.device = st.st_dev;
+    id.inode = st.st_ino;
+#endif
+    size = st.st_size;
+    return true;
+}
+
+bool clTailReader::GetFileId(wxFFile& file, FileId& id)
+{
+#ifdef __WXMSW__
+    wxUnusedVar(file);
+    id = {};
+#else
+    cl_stat_t st;
+    if (cl_fstat(cl_fileno(file.fp()), &st) != 0) {
+        return false;
+    }
+    id.device = st.st_dev;
+    id.inode = st.st_ino;
+#endif
+    return true;
+}
@@ -0,0 +1,187 @@
+#ifndef CLTAILREADER_HPP
+#define CLTAILREADER_HPP
+
+#include "codelite_exports.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <wx/ffile.h>
+#include <wx/string.h>
+
+class wxRegEx;
+
+/**
+ * @brief follow the lines appended to a file ("tail -F"), on a worker thread.
+ *
+ * The new content is read in chunks of a fixed size. Partial lines (and so partial UTF-8 sequences) are carried over
+ * to the next read, so a line is only decoded once it is complete. When the file is rotated or replaced (its path
+ * now leads to another file) the rest of the old file is read before following the new one from its start; when it
+ * is truncated it is followed from its start.
+ *
+ * The reader keeps the last `max lines` lines, which the include/exclude filters are applied to when they change.
+ * The lines waiting for the consumer are capped the same way: when the consumer falls behind, the oldest ones are
+ * dropped, since they would be scrolled out of the view anyway. The memory used does not depend on the file size.
+ */
+class WXDLLIMPEXP_CL clTailReader
+{
+public:
+    enum class Severity {
+        kNone,
+        kError,
+        kWarning,
+        kNotice, // a message from the reader (e.g. the file was rotated)
+    };
+
+    struct Line {
+        wxString text;
+        Severity severity = Severity::kNone;
+    };
+
+    struct Update {
+        /// the view must be cleared before appending `lines` (e.g. the filters changed)
+        bool reset = false;
+        /// the lines that were dropped since the last update because the consumer did not take them in time
+        size_t dropped = 0;
+        std::vector<Line> lines;
+    };
+
+    /// called on the worker thread when lines are waiting. It is not called again until TakeUpdate() is called
+    using NotifyCallback = std::function<void()>;
+
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 64 * 1024;
+    static constexpr size_t DEFAULT_MAX_LINES = 10000;
+    /// longer lines are split
+    static constexpr size_t MAX_LINE_BYTES = 64 * 1024;
+    static constexpr size_t END_OF_FILE = static_cast<size_t>(-1);
+    static constexpr std::chrono::milliseconds DEFAULT_POLL_INTERVAL = std::chrono::milliseconds(250);
+
+public:
+    clTailReader(size_t chunkSize = DEFAULT_CHUNK_SIZE);
+    ~clTailReader();
+
+    /**
+     * @brief follow `filename` from `startPos` (END_OF_FILE: only the lines appended from now on)
+     */
+    bool Open(const wxString& filename, size_t startPos = END_OF_FILE);
+
+    /**
+     * @brief stop following the file and clear the lines
+     */
+    void Close();
+
+    /**
+     * @brief poll the file on a worker thread every `interval`. `onLines` is called at once if an update is
+     * waiting (e.g. the filters changed while stopped)
+     */
+    void Start(NotifyCallback onLines, std::chrono::milliseconds interval = DEFAULT_POLL_INTERVAL);
+
+    /**
+     * @brief stop the worker thread. The file remains open: Start() continues from where it stopped
+     */
+    void Stop();
+
+    /**
+     * @brief read what was appended to the file since the last call. Called by the worker thread, call it directly
+     * when the worker is not running
+     */
+    void Poll();
+
+    /**
+     * @brief poll now instead of waiting for the interval
+     */
+    void Wake();
+
+    /**
+     * @brief take the lines waiting for the consumer
+     */
+    Update TakeUpdate();
+
+    void SetMaxLines(size_t maxLines);
+    size_t GetMaxLines() const;
+
+    /**
+     * @brief keep the lines matching `include` and not matching `exclude` (empty: no filter). The kept lines are
+     * filtered again and the next update resets the view
+     * @return false if one of the expressions is invalid, the filters are not changed then
+     */
+    bool SetFilters(const wxString& include, const wxString& exclude);
+
+    bool IsOpen() const;
+    bool IsRunning() const { return m_running.load(); }
+    const wxString& GetFileName() const { return m_filename; }
+    /// the offset of the next byte to read in the current file
+    size_t GetPosition() const;
+    /// the number of lines kept (before filtering)
+    size_t GetLineCount() const;
+
+    /**
+     * @brief the severity of a log line: "error", "fatal" and "critical" are errors, "warn" is a warning
+     */
+    static Severity GetSeverity(const wxString& line);
+
+    /**
+     * @brief the length of the longest prefix of `data` that does not end in the middle of a UTF-8 sequence
+     */
+    static size_t Utf8Boundary(const char* data, size_t len);
+
+private:
+    struct FileId {
+        unsigned long long device = 0;
+        unsigned long long inode = 0;
+        bool operator==(const FileId& other) const = default;
+    };
+
+    void Run(std::chrono::milliseconds interval);
+    bool DoOpenFile(size_t startPos);
+    void DoReadAvailable();
+    void DoProcess(const char* data, size_t len);
+    void DoAddLines(std::vector<Line>&& lines);
+    void DoAddNotice(const wxString& message);
+    bool IsVisible(const Line& line) const;
+    void DoPushPending(const Line& line);
+
+    static Line MakeLine(const char* data, size_t len);
+    static bool GetFileId(const wxString& path, FileId& id, size_t& size);
+    static bool GetFileId(wxFFile& file, FileId& id);
+
+    const size_t m_chunkSize;
+
+    // the file, used by Poll()
+    mutable std::mutex m_fileMutex;
+    wxString m_filename;
+    wxFFile m_file;
+    FileId m_fileId;
+    size_t m_pos = 0;
+    std::string m_carry;
+    std::vector<char> m_buffer;
+
+    // the lines, shared with the consumer
+    mutable std::mutex m_mutex;
+    std::deque<Line> m_lines;
+    std::deque<Line> m_pending;
+    size_t m_dropped = 0;
+    bool m_reset = false;
+    bool m_notified = false;
+    size_t m_maxLines = DEFAULT_MAX_LINES;
+    std::unique_ptr<wxRegEx> m_include;
+    std::unique_ptr<wxRegEx> m_exclude;
+
+    // the worker
+    std::thread m_thread;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCv;
+    bool m_wake = false;
+    std::atomic_bool m_stop{false};
+    std::atomic_bool m_running{false};
+    NotifyCallback m_onLines;
+};
+
+#endif // CLTAILREADER_HPP
@@ -0,0 +1,292 @@
+#include "clTraceRecorder.hpp"
+
+#include "cl_standard_paths.h"
+#include "fileutils.h"
+
+#include <algorithm>
+#include <array>
+#include <assistant/common/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <unordered_map>
+#include <wx/datetime.h>
+#include <wx/thread.h>
+#include <wx/utils.h>
+
+namespace
+{
+constexpr size_t kRingCapacity = 2048;
+constexpr size_t kMaxNameLen = 48;
+constexpr size_t kMaxArgsLen = 80;
+/// Buffers of threads that already exited are kept (so their spans can still be exported), up to this limit
+constexpr size_t kMaxRetiredBuffers = 16;
+
+void CopyTruncated(char* dest, size_t dest_size, std::string_view src)
+{
+    size_t len = std::min(src.size(), dest_size - 1);
+    std::memcpy(dest, src.data(), len);
+    dest[len] = 0;
+}
+} // namespace
+
+/// A single producer ring buffer. The owning thread is the only writer; each slot is protected by a sequence
+/// counter (odd while being written) so readers can detect and skip torn slots without blocking the writer.
+class clTraceThreadBuffer
+{
+public:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};
+        uint64_t start_us{0};
+        uint64_t duration_us{0};
+        uint32_t depth{0};
+        char name[kMaxNameLen]{};
+        char args[kMaxArgsLen]{};
+    };
+
+    explicit clTraceThreadBuffer(uint64_t thread_id)
+        : m_threadId{thread_id}
+    {
+    }
+
+    void Push(std::string_view name, std::string_view args, uint64_t start_us, uint64_t duration_us, size_t depth)
+    {
+        uint64_t index = m_head.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[index % kRingCapacity];
+
+        uint64_t seq = slot.seq.load(std::memory_order_relaxed);
+        slot.seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.start_us = start_us;
+        slot.duration_us = duration_us;
+        slot.depth = static_cast<uint32_t>(depth);
+        CopyTruncated(slot.name, sizeof(slot.name), name);
+        CopyTruncated(slot.args, sizeof(slot.args), args);
+
+        slot.seq.store(seq + 2, std::memory_order_release);
+        m_head.store(index + 1, std::memory_order_release);
+    }
+
+    void Collect(std::vector<clTraceEvent>& events, uint64_t not_before_us) const
+    {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        uint64_t first = head > kRingCapacity ? head - kRingCapacity : 0;
+        for (uint64_t i = first; i < head; ++i) {
+            const Slot& slot = m_slots[i % kRingCapacity];
+            uint64_t seq_before = slot.seq.load(std::memory_order_acquire);
+            if (seq_before & 1) {
+                continue; // being written right now
+            }
+
+            clTraceEvent event;
+            event.start_us = slot.start_us;
+            event.duration_us = slot.duration_us;
+            event.depth = slot.depth;
+            event.name = slot.name;
+            event.args = slot.args;
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != seq_before) {
+                continue; // overwritten while we were reading it
+            }
+
+            if (event.start_us < not_before_us) {
+                continue;
+            }
+            event.category = clTraceRecorder::CategoryFromLabel(event.name);
+            event.thread_id = m_threadId;
+            events.push_back(std::move(event));
+        }
+    }
+
+    uint64_t GetThreadId() const { return m_threadId; }
+    void SetRetired() { m_retired.store(true, std::memory_order_release); }
+    bool IsRetired() const { return m_retired.load(std::memory_order_acquire); }
+
+private:
+    std::array<Slot, kRingCapacity> m_slots;
+    std::atomic<uint64_t> m_head{0};
+    std::atomic<bool> m_retired{false};
+    uint64_t m_threadId{0};
+};
+
+namespace
+{
+/// Owns the calling thread's buffer and flags it as retired once the thread exits
+struct ThreadBufferHolder {
+    std::shared_ptr<clTraceThreadBuffer> buffer;
+    ~ThreadBufferHolder()
+    {
+        if (buffer) {
+            buffer->SetRetired();
+        }
+    }
+};
+thread_local ThreadBufferHolder t_holder;
+} // namespace
+
+clTraceRecorder& clTraceRecorder::Get()
+{
+    static clTraceRecorder recorder;
+    return recorder;
+}
+
+uint64_t clTraceRecorder::NowMicro()
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::microseconds>(now).count());
+}
+
+std::string_view clTraceRecorder::CategoryFromLabel(std::string_view label)
+{
+    size_t where = std::min(label.find("->"), label.find("::"));
+    if (where == std::string_view::npos || where == 0) {
+        return "General";
+    }
+    return label.substr(0, where);
+}
+
+clTraceThreadBuffer* clTraceRecorder::GetThreadBuffer()
+{
+    if (t_holder.buffer) [[likely]] {
+        return t_holder.buffer.get();
+    }
+
+    auto buffer = std::make_shared<clTraceThreadBuffer>(static_cast<uint64_t>(wxThread::GetCurrentId()));
+    std::lock_guard lock{m_mutex};
+
+    // Drop the oldest buffers of threads that are long gone
+    size_t retired = std::count_if(m_buffers.begin(), m_buffers.end(), [](const auto& b) { return b->IsRetired(); });
+    for (auto iter = m_buffers.begin(); iter != m_buffers.end() && retired > kMaxRetiredBuffers;) {
+        if ((*iter)->IsRetired()) {
+            iter = m_buffers.erase(iter);
+            --retired;
+        } else {
+            ++iter;
+        }
+    }
+    m_buffers.push_back(buffer);
+    t_holder.buffer = buffer;
+    return buffer.get();
+}
+
+void clTraceRecorder::Record(
+    std::string_view name, std::string_view args, uint64_t start_us, uint64_t duration_us, size_t depth)
+{
+    GetThreadBuffer()->Push(name, args, start_us, duration_us, depth);
+}
+
+std::vector<clTraceEvent> clTraceRecorder::Snapshot() const
+{
+    std::vector<clTraceEvent> events;
+    {
+        std::lock_guard lock{m_mutex};
+        events.reserve(m_buffers.size() * kRingCapacity);
+        for (const auto& buffer : m_buffers) {
+            buffer->Collect(events, m_clearedAt);
+        }
+    }
+
+    std::sort(events.begin(), events.end(), [](const clTraceEvent& a, const clTraceEvent& b) {
+        return a.start_us < b.start_us;
+    });
+    return events;
+}
+
+void clTraceRecorder::Clear()
+{
+    std::lock_guard lock{m_mutex};
+    m_clearedAt = NowMicro();
+}
+
+std::vector<clTraceLabelStats> clTraceRecorder::ComputeStats(const std::vector<clTraceEvent>& events)
+{
+    std::unordered_map<std::string_view, std::vector<uint64_t>> durations;
+    for (const auto& event : events) {
+        durations[event.name].push_back(event.duration_us);
+    }
+
+    // nearest-rank percentile over a sorted sample
+    auto percentile = [](const std::vector<uint64_t>& sorted, size_t p) -> uint64_t {
+        size_t rank = (p * sorted.size() + 99) / 100;
+        return sorted[rank == 0 ? 0 : rank - 1];
+    };
+
+    std::vector<clTraceLabelStats> result;
+    result.reserve(durations.size());
+    for (auto& [name, samples] : durations) {
+        std::sort(samples.begin(), samples.end());
+        clTraceLabelStats stats;
+        stats.name = name;
+        stats.count = samples.size();
+        stats.p50_us = percentile(samples, 50);
+        stats.p95_us = percentile(samples, 95);
+        stats.p99_us = percentile(samples, 99);
+        stats.max_us = samples.back();
+        result.push_back(std::move(stats));
+    }
+
+    // slowest first
+    std::sort(result.begin(), result.end(), [](const clTraceLabelStats& a, const clTraceLabelStats& b) {
+        return a.p99_us > b.p99_us;
+    });
+    return result;
+}
+
+std::string clTraceRecorder::ToChromeTraceJSON(const std::vector<clTraceEvent>& events)
+{
+    uint64_t pid = static_cast<uint64_t>(::wxGetProcessId());
+    uint64_t main_tid = static_cast<uint64_t>(wxThread::GetMainId());
+
+    nlohmann::json trace_events = nlohmann::json::array();
+    trace_events.push_back({
+        {"name", "thread_name"},
+        {"ph", "M"},
+        {"pid", pid},
+        {"tid", main_tid},
+        {"args", {{"name", "Main Thread"}}},
+    });
+
+    for (const auto& event : events) {
+        nlohmann::json entry = {
+            {"name", event.name},
+            {"cat", event.category},
+            {"ph", "X"},
+            {"ts", event.start_us},
+            {"dur", event.duration_us},
+            {"pid", pid},
+            {"tid", event.thread_id},
+        };
+        nlohmann::json args = {{"depth", event.depth}};
+        if (!event.args.empty()) {
+            args["message"] = event.args;
+        }
+        entry["args"] = std::move(args);
+        trace_events.push_back(std::move(entry));
+    }
+
+    nlohmann::json root = {
+        {"traceEvents", std::move(trace_events)},
+        {"displayTimeUnit", "ms"},
+    };
+    // Invalid UTF-8 in a label should not prevent the export
+    return root.dump(-1, ' ', false, nlohmann::json::error_handler_t::replace);
+}
+
+bool clTraceRecorder::ExportChromeTrace(const wxFileName& filepath) const
+{
+    if (!filepath.DirExists()) {
+        filepath.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+    return FileUtils::WriteFileContentRaw(filepath, ToChromeTraceJSON(Snapshot()));
+}
+
+wxFileName clTraceRecorder::GetDefaultTraceFile()
+{
+    wxString name;
+    name << "trace-" << wxDateTime::Now().Format("%Y%m%d-%H%M%S") << ".json";
+    wxFileName trace_file{clStandardPaths::Get().GetUserDataDir(), name};
+    trace_file.AppendDir("perf");
+    return trace_file;
+}
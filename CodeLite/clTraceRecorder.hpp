@@ -0,0 +1,88 @@
+#ifndef CLTRACERECORDER_HPP
+#define CLTRACERECORDER_HPP
+
+#include "codelite_exports.h"
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <wx/filename.h>
+
+/// A completed span, as recorded by `BlockTimer`
+struct WXDLLIMPEXP_CL clTraceEvent {
+    std::string name;
+    std::string category;
+    std::string args;
+    uint64_t start_us{0};
+    uint64_t duration_us{0};
+    uint64_t thread_id{0};
+    size_t depth{0};
+};
+
+/// Duration percentiles for all the spans sharing the same label
+struct WXDLLIMPEXP_CL clTraceLabelStats {
+    std::string name;
+    size_t count{0};
+    uint64_t p50_us{0};
+    uint64_t p95_us{0};
+    uint64_t p99_us{0};
+    uint64_t max_us{0};
+};
+
+class clTraceThreadBuffer;
+
+/**
+ * @brief collects the spans produced by `BlockTimer` (see `__PERF_IF_ENABLED`).
+ *
+ * Every thread writes into its own fixed size ring buffer, so recording a span never takes a lock and never
+ * allocates. When the ring is full, the oldest spans are overwritten. Readers (the export code and the
+ * "Performance" view) take a consistent snapshot of all the rings on demand.
+ */
+class WXDLLIMPEXP_CL clTraceRecorder
+{
+public:
+    static clTraceRecorder& Get();
+
+    /// Record a completed span for the calling thread. `start_us` is taken from `NowMicro()`
+    void Record(std::string_view name, std::string_view args, uint64_t start_us, uint64_t duration_us, size_t depth);
+
+    /// Return all the spans currently held by the per-thread rings, sorted by their start time
+    std::vector<clTraceEvent> Snapshot() const;
+
+    /// Compute the per-label percentiles over the current snapshot
+    std::vector<clTraceLabelStats> GetStats() const { return ComputeStats(Snapshot()); }
+
+    /// Discard all the spans recorded so far
+    void Clear();
+
+    /**
+     * @brief export the current snapshot in the Chrome trace-event JSON format. The output can be loaded into
+     * `chrome://tracing` or https://ui.perfetto.dev
+     */
+    bool ExportChromeTrace(const wxFileName& filepath) const;
+
+    /// Return the default location for trace files: `<user-data-dir>/perf/trace-<timestamp>.json`
+    static wxFileName GetDefaultTraceFile();
+
+    static std::vector<clTraceLabelStats> ComputeStats(const std::vector<clTraceEvent>& events);
+    static std::string ToChromeTraceJSON(const std::vector<clTraceEvent>& events);
+
+    /// The category is the label prefix up to the first "->" or "::", e.g. "LSP" for "LSP->ProcessQueue"
+    static std::string_view CategoryFromLabel(std::string_view label);
+
+    /// Monotonic clock, in microseconds
+    static uint64_t NowMicro();
+
+private:
+    clTraceRecorder() = default;
+    clTraceThreadBuffer* GetThreadBuffer();
+
+    mutable std::mutex m_mutex;
+    std::vector<std::shared_ptr<clTraceThreadBuffer>> m_buffers;
+    uint64_t m_clearedAt{0};
+};
+
+#endif // CLTRACERECORDER_HPP
@@ -0,0 +1,140 @@
+#include "clWordHighlighter.hpp"
+
+#include <algorithm>
+
+namespace
+{
+// the cancellation flag is checked every CANCEL_CHECK_BYTES bytes
+constexpr size_t CANCEL_CHECK_BYTES = 64 * 1024;
+
+bool IsWordChar(char ch)
+{
+    unsigned char c = static_cast<unsigned char>(ch);
+    // bytes of a multi byte UTF-8 sequence are part of the word
+    return c >= 0x80 || c == '_' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+} // namespace
+
+clWordHighlighter::clWordHighlighter() { m_thread = std::thread(&clWordHighlighter::Run, this); }
+
+clWordHighlighter::~clWordHighlighter()
+{
+    {
+        std::unique_lock lock{m_mutex};
+        m_shutdown = true;
+        m_queue.clear();
+        m_cancelRunning.store(true);
+    }
+    m_cv.notify_all();
+    if (m_thread.joinable()) {
+        m_thread.join();
+    }
+}
+
+clWordHighlighter& clWordHighlighter::Get()
+{
+    static clWordHighlighter highlighter;
+    return highlighter;
+}
+
+size_t clWordHighlighter::Submit(Key_t key, std::string text, int offset, std::string word, Callback_t callback)
+{
+    size_t id = 0;
+    {
+        std::unique_lock lock{m_mutex};
+        id = ++m_nextId;
+        Request request{key, id, std::move(text), offset, std::move(word), std::move(callback)};
+        auto iter = std::find_if(m_queue.begin(), m_queue.end(), [key](const Request& r) { return r.key == key; });
+        if (iter != m_queue.end()) {
+            // keep its place in the queue
+            *iter = std::move(request);
+        } else {
+            m_queue.push_back(std::move(request));
+        }
+        if (m_runningKey == key) {
+            m_cancelRunning.store(true);
+        }
+    }
+    m_cv.notify_all();
+    return id;
+}
+
+void clWordHighlighter::Cancel(Key_t key)
+{
+    std::unique_lock lock{m_mutex};
+    m_queue.erase(std::remove_if(m_queue.begin(), m_queue.end(), [key](const Request& r) { return r.key == key; }),
+                  m_queue.end());
+    if (m_runningKey == key) {
+        // wait for the search (and its callback) to complete
+        m_cancelRunning.store(true);
+        m_cv.wait(lock, [this, key] { return m_runningKey != key; });
+    }
+}
+
+void clWordHighlighter::Run()
+{
+    while (true) {
+        Request request;
+        {
+            std::unique_lock lock{m_mutex};
+            m_cv.wait(lock, [this] { return m_shutdown || !m_queue.empty(); });
+            if (m_shutdown) {
+                return;
+            }
+            request = std::move(m_queue.front());
+            m_queue.pop_front();
+            m_runningKey = request.key;
+            m_cancelRunning.store(false);
+        }
+
+        auto cancelled = [this]() { return m_cancelRunning.load(); };
+        auto matches = FindWholeWords(request.text, request.offset, request.word, cancelled);
+        // Cancel() waits while the callback runs, so the owner is still alive here
+        if (!cancelled()) {
+            request.callback(request.id, std::move(matches));
+        }
+
+        {
+            std::unique_lock lock{m_mutex};
+            m_runningKey = nullptr;
+        }
+        m_cv.notify_all();
+    }
+}
+
+clWordHighlighter::Matches_t clWordHighlighter::FindWholeWords(const std::string& text,
+                                                               int offset,
+                                                               const std::string& word,
+                                                               const std::function<bool()>& cancelled)
+{
+    Matches_t matches;
+    if (word.empty() || text.size() < word.size()) {
+        return matches;
+    }
+
+    // the boundaries are only checked on the sides of the word that are word characters
+    bool check_before = IsWordChar(word.front());
+    bool check_after = IsWordChar(word.back());
+    size_t next_check = CANCEL_CHECK_BYTES;
+
+    size_t pos = text.find(word);
+    while (pos != std::string::npos) {
+        if (cancelled && pos >= next_check) {
+            if (cancelled()) {
+                return {};
+            }
+            next_check = pos + CANCEL_CHECK_BYTES;
+        }
+
+        size_t end = pos + word.size();
+        bool whole_word = (!check_before || pos == 0 || !IsWordChar(text[pos - 1])) &&
+                          (!check_after || end == text.size() || !IsWordChar(text[end]));
+        if (whole_word) {
+            matches.push_back({offset + static_cast<int>(pos), static_cast<int>(word.size())});
+            pos = text.find(word, end);
+        } else {
+            pos = text.find(word, pos + 1);
+        }
+    }
+    return matches;
+}
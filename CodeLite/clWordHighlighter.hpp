@@ -0,0 +1,90 @@
+#ifndef CLWORDHIGHLIGHTER_HPP
+#define CLWORDHIGHLIGHTER_HPP
+
+#include "codelite_exports.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief find the occurrences of a word in a snapshot of the editor text on a worker thread.
+ *
+ * One worker is shared by all the editors (see Get()); the requests are keyed by their owner, usually the editor.
+ * The editor passes a copy of the text around the visible lines and the word to highlight. Only the latest request of
+ * an owner matters: submitting a new one (the caret moved, the view scrolled) cancels the request of that owner being
+ * searched and drops the one waiting. The requests of different owners are searched in the order they were submitted.
+ * The text is searched as UTF-8 bytes, so the matches are Scintilla positions.
+ */
+class WXDLLIMPEXP_CL clWordHighlighter
+{
+public:
+    /// (position, length) in bytes
+    using Matches_t = std::vector<std::pair<int, int>>;
+    /// called on the worker thread with the matches of request `id`
+    using Callback_t = std::function<void(size_t id, Matches_t matches)>;
+    /// the owner of a request
+    using Key_t = const void*;
+
+public:
+    clWordHighlighter();
+    ~clWordHighlighter();
+
+    /**
+     * @brief the worker shared by the editors, started on the first call
+     */
+    static clWordHighlighter& Get();
+
+    /**
+     * @brief search `text`, which starts at position `offset` of the document, for `word` (whole word, match case)
+     * @return the request id (unique across the owners), passed to `callback`. The callback is not called if the
+     * request is superseded before its search completes, but a callback already posted by the caller may arrive after
+     * a newer Submit(): compare its id with the latest one
+     */
+    size_t Submit(Key_t key, std::string text, int offset, std::string word, Callback_t callback);
+
+    /**
+     * @brief cancel the request of `key`, if any. When this returns, the callback of `key` is not running and won't be
+     * called, so the owner can be destroyed
+     */
+    void Cancel(Key_t key);
+
+    /**
+     * @brief the search itself. Returns an empty list if `cancelled` returns true while searching
+     */
+    static Matches_t FindWholeWords(const std::string& text,
+                                    int offset,
+                                    const std::string& word,
+                                    const std::function<bool()>& cancelled = nullptr);
+
+private:
+    struct Request {
+        Key_t key = nullptr;
+        size_t id = 0;
+        std::string text;
+        int offset = 0;
+        std::string word;
+        Callback_t callback;
+    };
+
+    void Run();
+
+    std::thread m_thread;
+    std::mutex m_mutex;
+    std::condition_variable m_cv;
+    /// at most one request per owner, in the order they were submitted
+    std::deque<Request> m_queue;
+    size_t m_nextId = 0;
+    /// the owner of the request being searched, nullptr if the worker is idle
+    Key_t m_runningKey = nullptr;
+    std::atomic_bool m_cancelRunning{false};
+    bool m_shutdown = false;
+};
+
+#endif // CLWORDHIGHLIGHTER_HPP
@@ -30,6 +30,9 @@
 #include "file_logger.h"
 #include "fileutils.h"
 
+#include <algorithm>
+#include <condition_variable>
+#include <vector>
 #include <wx/filefn.h>
 #include <wx/filename.h>
 
@@ -53,6 +56,29 @@ void truncate_array(wxArrayString& arr, size_t maxSize)
         arr.RemoveAt(arr.GetCount() - 1);
     }
 }
+
+// the live instances. Several instances may use the same file (e.g. a plugin creates one to read its settings)
+std::mutex& GetInstancesMutex()
+{
+    static std::mutex instancesMutex;
+    return instancesMutex;
+}
+
+std::vector<clConfig*>& GetInstances()
+{
+    static std::vector<clConfig*> instances;
+    return instances;
+}
+
+// the FlushInstances() calls flushing instances outside of the instances mutex. An instance is not destroyed while
+// there are some, it may be one of the instances they copied
+size_t g_activeFlushes = 0;
+
+std::condition_variable& GetFlushesDoneCondition()
+{
+    static std::condition_variable flushesDone;
+    return flushesDone;
+}
 } // namespace
 
 clConfig::clConfig(const wxString& filename)
@@ -64,6 +90,8 @@ clConfig::clConfig(const wxString& filename)
                      wxFileName::GetPathSeparator() + filename;
     }
 
+    // the file must include the changes not written yet by the other instances
+    FlushInstances(m_filename);
     if (m_filename.FileExists()) {
         m_root = std::make_unique<JSON>(m_filename);
 
@@ -92,6 +120,28 @@ clConfig::clConfig(const wxString& filename)
             m_cacheRecentItems.insert(std::make_pair("RecentFiles", recentFiles));
         }
     }
+
+    std::lock_guard lock{GetInstancesMutex()};
+    GetInstances().push_back(this);
+}
+
+clConfig::~clConfig()
+{
+    {
+        std::unique_lock lock{GetInstancesMutex()};
+        auto& instances = GetInstances();
+        instances.erase(std::remove(instances.begin(), instances.end(), this), instances.end());
+        GetFlushesDoneCondition().wait(lock, [] { return g_activeFlushes == 0; });
+    }
+    Flush();
+    {
+        std::lock_guard lock{m_mutex};
+        m_shutdown = true;
+    }
+    m_cv.notify_one();
+    if (m_writerThread) {
+        m_writerThread->join();
+    }
 }
 
 clConfig& clConfig::Get()
@@ -102,6 +152,7 @@ clConfig& clConfig::Get()
 
 bool clConfig::GetOutputTabOrder(wxArrayString& tabs, int& selected)
 {
+    std::lock_guard lock{m_mutex};
     if (m_root->toElement().hasNamedObject("outputTabOrder")) {
         JSONItem element = m_root->toElement().namedObject("outputTabOrder");
         tabs = element.namedObject("tabs").toArrayString();
@@ -113,6 +164,7 @@ bool clConfig::GetOutputTabOrder(wxArrayString& tabs, int& selected)
 
 void clConfig::SetOutputTabOrder(const wxArrayString& tabs, int selected)
 {
+    std::lock_guard lock{m_mutex};
     DoDeleteProperty("outputTabOrder");
 
     // first time
@@ -120,11 +172,12 @@ void clConfig::SetOutputTabOrder(const wxArrayString& tabs, int selected)
     e.addProperty("tabs", tabs);
     e.addProperty("selected", selected);
     m_root->toElement().addProperty("outputTabOrder", e);
-    m_root->save(m_filename);
+    MarkDirty();
 }
 
 bool clConfig::GetWorkspaceTabOrder(wxArrayString& tabs, int& selected)
 {
+    std::lock_guard lock{m_mutex};
     if (m_root->toElement().hasNamedObject("workspaceTabOrder")) {
         JSONItem element = m_root->toElement().namedObject("workspaceTabOrder");
         tabs = element.namedObject("tabs").toArrayString();
@@ -136,6 +189,7 @@ bool clConfig::GetWorkspaceTabOrder(wxArrayString& tabs, int& selected)
 
 void clConfig::SetWorkspaceTabOrder(const wxArrayString& tabs, int selected)
 {
+    std::lock_guard lock{m_mutex};
     DoDeleteProperty("workspaceTabOrder");
 
     // first time
@@ -143,8 +197,7 @@ void clConfig::SetWorkspaceTabOrder(const wxArrayString& tabs, int selected)
     e.addProperty("tabs", tabs);
     e.addProperty("selected", selected);
     m_root->toElement().addProperty("workspaceTabOrder", e);
-
-    m_root->save(m_filename);
+    MarkDirty();
 }
 
 void clConfig::DoDeleteProperty(const wxString& property)
@@ -156,6 +209,7 @@ void clConfig::DoDeleteProperty(const wxString& property)
 
 bool clConfig::ReadItem(clConfigItem& item)
 {
+    std::lock_guard lock{m_mutex};
     const wxString& name = item.GetName();
     if (m_root->toElement().hasNamedObject(name)) {
         item.FromJSON(m_root->toElement().namedObject(name));
@@ -173,8 +227,10 @@ bool clConfig::Write(const wxString& name, std::function<JSONItem()> serialiser_
         return FileUtils::WriteFileContent(configFile, item.format());
     } else {
         // add it to the global configuration file
+        std::lock_guard lock{m_mutex};
         DoDeleteProperty(name);
         m_root->toElement().addProperty(name, item);
+        MarkDirty();
         return true;
     }
 }
@@ -190,6 +246,7 @@ void clConfig::Read(const wxString& name,
         }
         deserialiser_func(root.toElement());
     } else {
+        std::lock_guard lock{m_mutex};
         auto root = m_root->toElement();
         if (root.hasNamedObject(name)) {
             deserialiser_func(root[name]);
@@ -199,14 +256,48 @@ void clConfig::Read(const wxString& name,
 
 void clConfig::WriteItem(const clConfigItem& item)
 {
+    std::lock_guard lock{m_mutex};
     const wxString& name = item.GetName();
     DoDeleteProperty(name);
     m_root->toElement().addProperty(name, item.ToJSON());
-    m_root->save(m_filename);
+    MarkDirty();
+}
+
+void clConfig::FlushInstances(const wxFileName& filename)
+{
+    // Flush() locks the instance m_mutex and writes the file: don't do it while holding the instances mutex, the
+    // constructor and the destructor take them in the opposite order
+    std::vector<clConfig*> configs;
+    {
+        std::lock_guard lock{GetInstancesMutex()};
+        for (clConfig* config : GetInstances()) {
+            if (config->m_filename == filename) {
+                configs.push_back(config);
+            }
+        }
+        if (configs.empty()) {
+            return;
+        }
+        ++g_activeFlushes;
+    }
+
+    for (clConfig* config : configs) {
+        config->Flush();
+    }
+
+    {
+        std::lock_guard lock{GetInstancesMutex()};
+        --g_activeFlushes;
+    }
+    GetFlushesDoneCondition().notify_all();
 }
 
 void clConfig::Reload()
 {
+    // write the pending changes first, ours and those of the other instances of this file: they would be lost
+    FlushInstances(m_filename);
+
+    std::lock_guard lock{m_mutex};
     if (m_filename.FileExists() == false)
         return;
 
@@ -250,17 +341,95 @@ wxStringMap_t clConfig::MergeStringMaps(const wxStringMap_t& map1, const wxStrin
 
 void clConfig::Save()
 {
+    std::unique_lock lock{m_mutex};
     if (m_root) {
-        m_root->save(m_filename);
+        // write even if nothing changed
+        ++m_generation;
+        DoFlush(lock);
     }
 }
 
 void clConfig::Save(const wxFileName& fn)
 {
+    std::lock_guard lock{m_mutex};
     if (m_root)
         m_root->save(fn);
 }
 
+void clConfig::Flush()
+{
+    std::unique_lock lock{m_mutex};
+    if (m_root && m_generation != m_savedGeneration.load()) {
+        DoFlush(lock);
+    }
+}
+
+bool clConfig::IsDirty() const
+{
+    std::lock_guard lock{m_mutex};
+    return m_generation != m_savedGeneration.load();
+}
+
+void clConfig::SetFlushDelay(std::chrono::milliseconds delay)
+{
+    std::lock_guard lock{m_mutex};
+    m_flushDelay = delay;
+}
+
+std::chrono::milliseconds clConfig::GetFlushDelay() const
+{
+    std::lock_guard lock{m_mutex};
+    return m_flushDelay;
+}
+
+void clConfig::MarkDirty()
+{
+    ++m_generation;
+    m_flushAt = std::chrono::steady_clock::now() + m_flushDelay;
+    if (!m_writerThread) {
+        m_writerThread = std::make_unique<std::thread>(&clConfig::WriterThreadMain, this);
+    }
+    m_cv.notify_one();
+}
+
+void clConfig::DoFlush(std::unique_lock<std::recursive_mutex>& lock)
+{
+    // serialize under the lock, write without it: the UI thread can keep changing the configuration meanwhile
+    size_t generation = m_generation;
+    wxString content = m_root->toElement().format();
+    lock.unlock();
+    {
+        std::lock_guard io_lock{m_ioMutex};
+        // a newer content may have been written while we were waiting for the lock
+        if (generation > m_savedGeneration.load()) {
+            if (FileUtils::WriteFileContent(m_filename, content)) {
+                ++m_saveCount;
+            } else {
+                clWARNING() << "Failed to save configuration file:" << m_filename << endl;
+            }
+            // on failure too: retrying the same content until the next change would not help
+            m_savedGeneration.store(generation);
+        }
+    }
+    lock.lock();
+}
+
+void clConfig::WriterThreadMain()
+{
+    std::unique_lock lock{m_mutex};
+    while (!m_shutdown) {
+        if (m_generation == m_savedGeneration.load()) {
+            m_cv.wait(lock);
+        } else if (std::chrono::steady_clock::now() < m_flushAt) {
+            // more changes may come: the deadline moves with each of them
+            auto flush_at = m_flushAt;
+            m_cv.wait_until(lock, flush_at);
+        } else {
+            DoFlush(lock);
+        }
+    }
+}
+
 JSONItem clConfig::GetGeneralSetting()
 {
     ADD_OBJ_IF_NOT_EXISTS(m_root->toElement(), "General")
@@ -269,17 +438,19 @@ JSONItem clConfig::GetGeneralSetting()
 
 void clConfig::Write(const wxString& name, bool value)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem general = GetGeneralSetting();
     if (general.hasNamedObject(name)) {
         general.removeProperty(name);
     }
 
     general.addProperty(name, value);
-    Save();
+    MarkDirty();
 }
 
 bool clConfig::Read(const wxString& name, bool defaultValue)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem general = GetGeneralSetting();
     if (general.namedObject(name).isBool()) {
         return general.namedObject(name).toBool();
@@ -289,34 +460,38 @@ bool clConfig::Read(const wxString& name, bool defaultValue)
 
 void clConfig::Write(const wxString& name, int value)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem general = GetGeneralSetting();
     if (general.hasNamedObject(name)) {
         general.removeProperty(name);
     }
 
     general.addProperty(name, value);
-    Save();
+    MarkDirty();
 }
 
 int clConfig::Read(const wxString& name, int defaultValue)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem general = GetGeneralSetting();
     return general.namedObject(name).toInt(defaultValue);
 }
 
 void clConfig::Write(const wxString& name, const wxString& value)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem general = GetGeneralSetting();
     if (general.hasNamedObject(name)) {
         general.removeProperty(name);
     }
 
     general.addProperty(name, value);
-    Save();
+    MarkDirty();
 }
 
 wxString clConfig::Read(const wxString& name, const wxString& defaultValue)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem general = GetGeneralSetting();
     if (general.namedObject(name).isString()) {
         return general.namedObject(name).toString();
@@ -327,6 +502,7 @@ wxString clConfig::Read(const wxString& name, const wxString& defaultValue)
 
 int clConfig::GetAnnoyingDlgAnswer(const wxString& name, int defaultValue)
 {
+    std::lock_guard lock{m_mutex};
     if (m_root->toElement().hasNamedObject("AnnoyingDialogsAnswers")) {
 
         JSONItem element = m_root->toElement().namedObject("AnnoyingDialogsAnswers");
@@ -339,6 +515,7 @@ int clConfig::GetAnnoyingDlgAnswer(const wxString& name, int defaultValue)
 
 void clConfig::SetAnnoyingDlgAnswer(const wxString& name, int value)
 {
+    std::lock_guard lock{m_mutex};
     ADD_OBJ_IF_NOT_EXISTS(m_root->toElement(), "AnnoyingDialogsAnswers")
 
     JSONItem element = m_root->toElement().namedObject("AnnoyingDialogsAnswers");
@@ -346,18 +523,23 @@ void clConfig::SetAnnoyingDlgAnswer(const wxString& name, int value)
         element.removeProperty(name);
     }
     element.addProperty(name, value);
-    Save();
+    MarkDirty();
 }
 
 void clConfig::ClearAnnoyingDlgAnswers()
 {
-    DoDeleteProperty("AnnoyingDialogsAnswers");
+    {
+        std::lock_guard lock{m_mutex};
+        DoDeleteProperty("AnnoyingDialogsAnswers");
+    }
+    // Reload() flushes the other instances of this file, which must not happen with m_mutex held
     Save();
     Reload();
 }
 
 void clConfig::SetQuickFindSearchItems(const wxArrayString& items)
 {
+    std::lock_guard lock{m_mutex};
     ADD_OBJ_IF_NOT_EXISTS(m_root->toElement(), "QuickFindBar");
     JSONItem quickFindBar = m_root->toElement().namedObject("QuickFindBar");
     if (quickFindBar.hasNamedObject("SearchHistory")) {
@@ -368,11 +550,12 @@ void clConfig::SetQuickFindSearchItems(const wxArrayString& items)
     truncate_array(items_to_save, 20);
 
     quickFindBar.addProperty("SearchHistory", items_to_save);
-    Save();
+    MarkDirty();
 }
 
 void clConfig::SetQuickFindReplaceItems(const wxArrayString& items)
 {
+    std::lock_guard lock{m_mutex};
     ADD_OBJ_IF_NOT_EXISTS(m_root->toElement(), "QuickFindBar");
     JSONItem quickFindBar = m_root->toElement().namedObject("QuickFindBar");
     if (quickFindBar.hasNamedObject("ReplaceHistory")) {
@@ -383,11 +566,12 @@ void clConfig::SetQuickFindReplaceItems(const wxArrayString& items)
     truncate_array(items_to_save, 20);
 
     quickFindBar.addProperty("ReplaceHistory", items_to_save);
-    Save();
+    MarkDirty();
 }
 
 wxArrayString clConfig::GetQuickFindReplaceItems() const
 {
+    std::lock_guard lock{m_mutex};
     ADD_OBJ_IF_NOT_EXISTS(m_root->toElement(), "QuickFindBar");
     JSONItem quickFindBar = m_root->toElement().namedObject("QuickFindBar");
     ADD_ARR_IF_NOT_EXISTS(quickFindBar, "ReplaceHistory");
@@ -396,6 +580,7 @@ wxArrayString clConfig::GetQuickFindReplaceItems() const
 
 wxArrayString clConfig::GetQuickFindSearchItems() const
 {
+    std::lock_guard lock{m_mutex};
     ADD_OBJ_IF_NOT_EXISTS(m_root->toElement(), "QuickFindBar");
     JSONItem quickFindBar = m_root->toElement().namedObject("QuickFindBar");
     ADD_ARR_IF_NOT_EXISTS(quickFindBar, "SearchHistory");
@@ -404,6 +589,7 @@ wxArrayString clConfig::GetQuickFindSearchItems() const
 
 wxArrayString clConfig::Read(const wxString& name, const wxArrayString& defaultValue)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem general = GetGeneralSetting();
     if (general.hasNamedObject(name)) {
         return general.namedObject(name).toArrayString();
@@ -413,17 +599,19 @@ wxArrayString clConfig::Read(const wxString& name, const wxArrayString& defaultV
 
 void clConfig::Write(const wxString& name, const wxArrayString& value)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem general = GetGeneralSetting();
     if (general.hasNamedObject(name)) {
         general.removeProperty(name);
     }
 
     general.addProperty(name, value);
-    Save();
+    MarkDirty();
 }
 
 void clConfig::DoAddRecentItem(const wxString& propName, const wxString& filename)
 {
+    std::lock_guard lock{m_mutex};
     wxArrayString recentItems = DoGetRecentItems(propName);
 
     // Prepend the item
@@ -467,16 +655,17 @@ void clConfig::DoAddRecentItem(const wxString& propName, const wxString& filenam
     }
 
     m_cacheRecentItems.insert(std::make_pair(propName, recentItems));
-    m_root->save(m_filename);
+    MarkDirty();
 }
 
 void clConfig::DoClearRecentItems(const wxString& propName)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem e = m_root->toElement();
     if (e.hasNamedObject(propName)) {
         e.removeProperty(propName);
     }
-    m_root->save(m_filename);
+    MarkDirty();
     // update the cache
     if (m_cacheRecentItems.count(propName)) {
         m_cacheRecentItems.erase(propName);
@@ -485,6 +674,7 @@ void clConfig::DoClearRecentItems(const wxString& propName)
 
 wxArrayString clConfig::DoGetRecentItems(const wxString& propName) const
 {
+    std::lock_guard lock{m_mutex};
     wxArrayString recentItems;
 
     // Try the cache first
@@ -502,6 +692,7 @@ wxArrayString clConfig::DoGetRecentItems(const wxString& propName) const
 #if wxUSE_GUI
 wxFont clConfig::Read(const wxString& name, const wxFont& defaultValue)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem general = GetGeneralSetting();
     if (!general.hasNamedObject(name))
         return defaultValue;
@@ -518,6 +709,7 @@ wxFont clConfig::Read(const wxString& name, const wxFont& defaultValue)
 
 void clConfig::Write(const wxString& name, const wxFont& value)
 {
+    std::lock_guard lock{m_mutex};
     JSONItem general = GetGeneralSetting();
     if (general.hasNamedObject(name)) {
         general.removeProperty(name);
@@ -525,7 +717,7 @@ void clConfig::Write(const wxString& name, const wxFont& value)
     JSONItem font = JSONItem::createObject();
     font.addProperty("fontDesc", FontUtils::GetFontInfo(value));
     general.addProperty(name, font);
-    Save();
+    MarkDirty();
 }
 
 wxColour clConfig::Read(const wxString& name, const wxColour& defaultValue)
@@ -543,7 +735,6 @@ void clConfig::Write(const wxString& name, const wxColour& value)
 {
     wxString strValue = value.GetAsString(wxC2S_HTML_SYNTAX);
     Write(name, strValue);
-    Save();
 }
 
 #endif
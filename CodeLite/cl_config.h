@@ -29,9 +29,14 @@
 #include "JSON.h"
 #include "codelite_exports.h"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <functional>
 #include <map>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <wx/filename.h>
 
 #if wxUSE_GUI
@@ -96,7 +101,16 @@ public:
 #define kRealPathResolveSymlinks "RealPathResolveSymlinks"
 #define kConfigClearOutputOnLaunch "ClearOutputOnLaunch"
 #define kConfigShowOutputOnLaunch "ShowOutputOnLaunch"
+#define kConfigUseProjectSnapshots "UseProjectSnapshots"
 
+/**
+ * @brief the configuration file, kept in memory.
+ *
+ * Changes are not written immediately: they mark the configuration dirty and a background thread writes the file
+ * once no other change arrived for `GetFlushDelay()`. The file is replaced atomically (temp file + rename), so a crash
+ * leaves either the previous or the new content on disk. `Flush()` writes the pending changes synchronously.
+ * `Reload()` and a new instance for the same file write the pending changes of the live instances before reading it.
+ */
 class WXDLLIMPEXP_CL clConfig
 {
 protected:
@@ -104,7 +118,27 @@ protected:
     std::unique_ptr<JSON> m_root;
     std::map<wxString, wxArrayString> m_cacheRecentItems;
 
+    // write-behind
+    mutable std::recursive_mutex m_mutex; // protects m_root, m_cacheRecentItems and the generations
+    std::condition_variable_any m_cv;
+    std::mutex m_ioMutex; // serializes the writes to the disk
+    std::unique_ptr<std::thread> m_writerThread;
+    std::chrono::milliseconds m_flushDelay{500};
+    std::chrono::steady_clock::time_point m_flushAt;
+    size_t m_generation = 0; // incremented by every change
+    std::atomic_size_t m_savedGeneration{0};
+    std::atomic_size_t m_saveCount{0};
+    bool m_shutdown = false;
+
 protected:
+    /// schedule a write of the configuration file. Must be called with m_mutex locked
+    void MarkDirty();
+    /// write the current content, `lock` is released while writing to the disk
+    void DoFlush(std::unique_lock<std::recursive_mutex>& lock);
+    void WriterThreadMain();
+    /// write the pending changes of all the instances using `filename`
+    static void FlushInstances(const wxFileName& filename);
+
     void DoDeleteProperty(const wxString& property);
     JSONItem GetGeneralSetting();
 
@@ -116,15 +150,25 @@ public:
     // We provide a global configuration
     // and the ability to allocate a private copy with a different file
     clConfig(const wxString& filename = "codelite.conf");
-    ~clConfig() = default;
+    ~clConfig();
     static clConfig& Get();
 
-    // Re-read the content from the disk
+    // Re-read the content from the disk. The pending changes are written first
     void Reload();
     // Save the content to a give file name
     void Save(const wxFileName& fn);
     // Save the content the file passed on the construction
     void Save();
+    // Write the pending changes now, if any. Called on shutdown
+    void Flush();
+    // true if some changes were not written to the disk yet
+    bool IsDirty() const;
+
+    // How long to wait for more changes before writing the file
+    void SetFlushDelay(std::chrono::milliseconds delay);
+    std::chrono::milliseconds GetFlushDelay() const;
+    // Number of times the file was written
+    size_t GetSaveCount() const { return m_saveCount.load(); }
 
     // Utility functions
     //------------------------------
@@ -694,7 +694,7 @@ wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxEVT_NEW_PROJECT_WIZARD_FINISHED, clNe
 // Compiler events
 // --------------------------------------------------------------
 
-// The compiler list was updated (e.g. a compiler was deleted, renamed etc)
+// The compiler list was updated (e.g. a compiler was deleted, renamed, its settings were changed etc)
 // Event type: clCompilerEvent
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_CL, wxEVT_COMPILER_LIST_UPDATED, clCompilerEvent);
 
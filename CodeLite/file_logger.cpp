@@ -25,10 +25,15 @@
 
 #include "file_logger.h"
 
+#include "clLogRingBuffer.hpp"
 #include "cl_standard_paths.h"
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <iostream>
+#include <mutex>
+#include <thread>
 #include <wx/ffile.h>
 #include <wx/filename.h>
 #include <wx/log.h>
@@ -38,6 +43,264 @@ wxString FileLogger::m_logfile;
 std::unordered_map<wxThreadIdType, wxString> FileLogger::m_threads;
 wxCriticalSection FileLogger::m_cs;
 
+namespace
+{
+constexpr size_t LOG_QUEUE_CAPACITY = 16384;              // entries
+constexpr size_t LOG_DEFAULT_MAX_SIZE = 20 * 1024 * 1024; // bytes
+constexpr size_t LOG_DEFAULT_BACKUPS = 2;
+
+std::atomic_bool s_async{true};
+std::atomic<FileLogger::OverflowPolicy> s_overflowPolicy{FileLogger::OverflowPolicy::Block};
+std::atomic_size_t s_dropped{0};
+
+/// the pre-queue way: open the log file and write the entry from the calling thread
+void WriteSync(const wxString& logfile, const wxString& buffer)
+{
+    wxLogNull noLog;
+    if (logfile.empty() || !wxFileName::FileExists(logfile)) {
+        // Use stdout
+        std::cout << buffer.ToStdString(wxConvUTF8) << std::endl;
+    } else {
+        wxFFile fp(logfile, "a+");
+        if (fp.IsOpened()) {
+            fp.Write(buffer + wxT("\n"), wxConvUTF8);
+            fp.Close();
+        }
+    }
+}
+
+/**
+ * @brief drains the entries queued by all the threads into the log file, which is kept open
+ */
+class LogWriter
+{
+public:
+    LogWriter()
+        : m_queue(LOG_QUEUE_CAPACITY)
+    {
+        m_thread = std::thread(&LogWriter::ThreadMain, this);
+    }
+
+    ~LogWriter()
+    {
+        m_stop.store(true);
+        Wakeup();
+        if (m_thread.joinable()) {
+            m_thread.join();
+        }
+        ms_alive.store(false);
+    }
+
+    static LogWriter* Get()
+    {
+        static LogWriter writer;
+        return ms_alive.load() ? &writer : nullptr;
+    }
+
+    bool Push(std::string& entry, FileLogger::OverflowPolicy policy)
+    {
+        while (!m_queue.TryPush(entry)) {
+            if (policy == FileLogger::OverflowPolicy::DropNewest) {
+                s_dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            Wakeup();
+            std::this_thread::yield();
+        }
+        m_pushed.fetch_add(1, std::memory_order_relaxed);
+
+        // pairs with the fence in ThreadMain(): either we see the writer sleeping, or it sees our entry
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleeping.load(std::memory_order_relaxed)) {
+            Wakeup();
+        }
+        return true;
+    }
+
+    void WaitForPendingWrites()
+    {
+        size_t target = m_pushed.load();
+        while (m_written.load() < target && !m_stop.load()) {
+            Wakeup();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    void SetFile(const wxString& path)
+    {
+        std::lock_guard lock{m_mutex};
+        m_path = path;
+        m_reopen = true;
+    }
+
+    void SetRotation(size_t max_size, size_t backups)
+    {
+        std::lock_guard lock{m_mutex};
+        m_maxSize = max_size;
+        m_backups = backups;
+    }
+
+private:
+    void Wakeup()
+    {
+        std::lock_guard lock{m_mutex};
+        m_cv.notify_one();
+    }
+
+    void ThreadMain()
+    {
+        std::string entry;
+        while (true) {
+            bool wrote = false;
+            while (m_queue.TryPop(entry)) {
+                Write(entry);
+                wrote = true;
+                m_written.fetch_add(1);
+            }
+
+            if (wrote) {
+                ReportDropped();
+                if (m_file.IsOpened()) {
+                    m_file.Flush();
+                } else {
+                    std::cout.flush();
+                }
+                continue;
+            }
+
+            if (m_stop.load()) {
+                break;
+            }
+
+            std::unique_lock lock{m_mutex};
+            m_sleeping.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (m_queue.IsEmpty() && !m_stop.load()) {
+                m_cv.wait_for(lock, std::chrono::milliseconds(100));
+            }
+            m_sleeping.store(false, std::memory_order_relaxed);
+        }
+        m_file.Close();
+    }
+
+    void ReportDropped()
+    {
+        size_t dropped = s_dropped.load(std::memory_order_relaxed);
+        if (dropped == m_reportedDropped) {
+            return;
+        }
+
+        wxString message;
+        message << FileLogger::Prefix(FileLogger::System) << " " << (dropped - m_reportedDropped)
+                << " log entries were dropped: the log queue was full\n";
+        m_reportedDropped = dropped;
+        std::string line = message.ToStdString(wxConvUTF8);
+        Write(line);
+    }
+
+    void Write(const std::string& entry)
+    {
+        size_t max_size = 0;
+        size_t backups = 0;
+        {
+            std::lock_guard lock{m_mutex};
+            if (m_reopen) {
+                m_reopen = false;
+                m_file.Close();
+                m_nextOpenAttempt = {};
+            }
+            max_size = m_maxSize;
+            backups = m_backups;
+        }
+
+        if (!m_file.IsOpened()) {
+            Open();
+        }
+
+        if (!m_file.IsOpened()) {
+            std::cout << entry;
+            return;
+        }
+
+        m_file.Write(entry.data(), entry.length());
+        m_fileSize += entry.length();
+        if (max_size && m_fileSize > max_size) {
+            Rotate(backups);
+        }
+    }
+
+    void Open()
+    {
+        // like the synchronous version, only log into a file that exists. Do not check it more than once per second
+        auto now = std::chrono::steady_clock::now();
+        if (now < m_nextOpenAttempt) {
+            return;
+        }
+        m_nextOpenAttempt = now + std::chrono::seconds(1);
+
+        wxString path;
+        {
+            std::lock_guard lock{m_mutex};
+            path = m_path;
+        }
+
+        wxLogNull noLog;
+        if (path.empty() || !wxFileName::FileExists(path) || !m_file.Open(path, "ab")) {
+            return;
+        }
+        m_openedPath = path;
+        m_fileSize = static_cast<size_t>(m_file.Length());
+    }
+
+    void Rotate(size_t backups)
+    {
+        wxLogNull noLog;
+        m_file.Close();
+        if (backups == 0) {
+            ::wxRemoveFile(m_openedPath);
+        } else {
+            for (size_t i = backups; i > 1; --i) {
+                wxString older = wxString::Format("%s.%zu", m_openedPath, i - 1);
+                if (wxFileName::FileExists(older)) {
+                    ::wxRenameFile(older, wxString::Format("%s.%zu", m_openedPath, i), true);
+                }
+            }
+            ::wxRenameFile(m_openedPath, m_openedPath + ".1", true);
+        }
+
+        // create the new file ourselves, Open() only logs into an existing file
+        if (m_file.Open(m_openedPath, "wb")) {
+            m_fileSize = 0;
+        }
+    }
+
+    clLogRingBuffer m_queue;
+    std::thread m_thread;
+    std::mutex m_mutex; // protects m_path, m_reopen and the rotation settings
+    std::condition_variable m_cv;
+    std::atomic_bool m_sleeping{false};
+    std::atomic_bool m_stop{false};
+    std::atomic_size_t m_pushed{0};
+    std::atomic_size_t m_written{0};
+
+    wxString m_path;
+    bool m_reopen = false;
+    size_t m_maxSize = LOG_DEFAULT_MAX_SIZE;
+    size_t m_backups = LOG_DEFAULT_BACKUPS;
+
+    // accessed by the writer thread only
+    wxFFile m_file;
+    wxString m_openedPath;
+    size_t m_fileSize = 0;
+    size_t m_reportedDropped = 0;
+    std::chrono::steady_clock::time_point m_nextOpenAttempt;
+
+    static std::atomic_bool ms_alive;
+};
+
+std::atomic_bool LogWriter::ms_alive{true};
+} // namespace
+
 FileLogger::FileLogger(int verbosity, const char* filename, int line_number)
     : m_logEntryVerbosity(verbosity)
     , m_fp(nullptr)
@@ -125,10 +388,49 @@ void FileLogger::OpenLog(const wxString& fullName, int verbosity)
     wxFileName logfile{clStandardPaths::Get().GetUserDataDir(), fullName};
     logfile.AppendDir("logs");
     logfile.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
-    m_logfile = logfile.GetFullPath();
+    SetLogFile(logfile.GetFullPath());
     SetGlobalLogVerbosity(verbosity);
 }
 
+void FileLogger::SetLogFile(const wxString& fullpath)
+{
+    m_logfile = fullpath;
+    if (auto writer = LogWriter::Get()) {
+        writer->SetFile(fullpath);
+    }
+}
+
+void FileLogger::SetOverflowPolicy(OverflowPolicy policy) { s_overflowPolicy.store(policy); }
+
+FileLogger::OverflowPolicy FileLogger::GetOverflowPolicy() { return s_overflowPolicy.load(); }
+
+void FileLogger::SetRotation(size_t max_size, size_t backups)
+{
+    if (auto writer = LogWriter::Get()) {
+        writer->SetRotation(max_size, backups);
+    }
+}
+
+void FileLogger::SetAsync(bool async)
+{
+    if (!async) {
+        // keep the order of the entries already queued
+        WaitForPendingWrites();
+    }
+    s_async.store(async);
+}
+
+bool FileLogger::IsAsync() { return s_async.load(); }
+
+size_t FileLogger::GetDroppedCount() { return s_dropped.load(); }
+
+void FileLogger::WaitForPendingWrites()
+{
+    if (auto writer = LogWriter::Get()) {
+        writer->WaitForPendingWrites();
+    }
+}
+
 void FileLogger::AddLogLine(const wxArrayString& arr, int verbosity)
 {
     for (size_t i = 0; i < arr.GetCount(); ++i) {
@@ -143,16 +445,14 @@ void FileLogger::Flush()
         return;
     }
 
-    wxLogNull noLog;
-    if (m_logfile.empty() || !wxFileName::FileExists(m_logfile)) {
-        // Use stdout
-        std::cout << m_buffer.ToStdString(wxConvUTF8) << std::endl;
+    // the writer is gone during the static destruction
+    LogWriter* writer = s_async.load() ? LogWriter::Get() : nullptr;
+    if (writer) {
+        std::string entry = m_buffer.ToStdString(wxConvUTF8);
+        entry += '\n';
+        writer->Push(entry, s_overflowPolicy.load(std::memory_order_relaxed));
     } else {
-        wxFFile fp(m_logfile, "a+");
-        if (fp.IsOpened()) {
-            fp.Write(m_buffer + wxT("\n"), wxConvUTF8);
-            fp.Close();
-        }
+        WriteSync(m_logfile, m_buffer);
     }
     m_buffer.Clear();
 }
@@ -40,11 +40,21 @@
 class FileLogger;
 using FileLoggerFunction = FileLogger& (*)(FileLogger&);
 
+/**
+ * @brief a log entry. The entry is queued when flushed, and a background thread writes the queued entries to the log
+ * file, keeping it open and rotating it by size.
+ */
 class WXDLLIMPEXP_CL FileLogger final
 {
 public:
     enum LogLevel { System = -1, Error = 0, Warning = 1, Info = 2, Dbg = 3, Trace = 4 };
 
+    /// what to do with a new entry when the queue is full
+    enum class OverflowPolicy {
+        Block,      // wait for the writer thread to make room, nothing is lost (the default)
+        DropNewest, // drop the entry, the number of dropped entries is reported in the log
+    };
+
 public:
     // construct a file logger entry with a given verbosity
     FileLogger(int verbosity, const char* filename = nullptr, int line_number = wxNOT_FOUND);
@@ -96,6 +106,36 @@ public:
      */
     static void OpenLog(const wxString& fullName, int verbosity);
 
+    /**
+     * @brief log into `fullpath`, as is. Nothing is written to the file unless it exists (stdout is used instead)
+     */
+    static void SetLogFile(const wxString& fullpath);
+
+    static void SetOverflowPolicy(OverflowPolicy policy);
+    static OverflowPolicy GetOverflowPolicy();
+
+    /**
+     * @brief once the log file is bigger than `max_size` bytes, rename it to <log>.1 (<log>.1 to <log>.2 and so on,
+     * up to `backups` files) and start a new one. A `max_size` of 0 disables the rotation
+     */
+    static void SetRotation(size_t max_size, size_t backups);
+
+    /**
+     * @brief when false, entries are written by the thread that logs them (opening the file each time)
+     */
+    static void SetAsync(bool async);
+    static bool IsAsync();
+
+    /**
+     * @brief number of entries dropped because the queue was full
+     */
+    static size_t GetDroppedCount();
+
+    /**
+     * @brief block until all the entries logged so far are written
+     */
+    static void WaitForPendingWrites();
+
     FileLogger& operator<<(FileLoggerFunction f)
     {
         Flush();
@@ -29,7 +29,11 @@
 #include "file_logger.h"
 #include "fileutils.h"
 
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <wx/filefn.h>
 #include <wx/filename.h>
 #include <wx/regex.h>
 #include <wx/tokenzr.h>
@@ -71,6 +75,94 @@ std::map<wxString, std::vector<FileExtManager::FileType>> m_language_bundle;
 std::unordered_map<int, wxString> m_file_type_to_lang;
 std::vector<Matcher> m_matchers;
 bool init_done = false;
+
+/// Results of the detections that require reading the file. An entry remains valid as long as the file's size and
+/// modification time are unchanged, so classifying the same files over and over does not hit the disk
+class ContentTypeCache
+{
+public:
+    using DetectFunc = std::function<bool(FileExtManager::FileType&)>;
+
+    bool Detect(const wxString& filename, FileExtManager::FileType& type, const DetectFunc& detect)
+    {
+        wxStructStat st;
+        if (::wxStat(filename, &st) != 0) {
+            // no such file, nothing to cache
+            return detect(type);
+        }
+
+        {
+            std::lock_guard lock{m_mutex};
+            auto iter = m_entries.find(filename);
+            if (iter != m_entries.end() && iter->second.mtime == st.st_mtime &&
+                iter->second.size == static_cast<wxFileOffset>(st.st_size)) {
+                if (iter->second.detected) {
+                    type = iter->second.type;
+                }
+                return iter->second.detected;
+            }
+        }
+
+        Entry entry;
+        entry.mtime = st.st_mtime;
+        entry.size = static_cast<wxFileOffset>(st.st_size);
+        entry.detected = detect(entry.type);
+        if (entry.detected) {
+            type = entry.type;
+        }
+
+        std::lock_guard lock{m_mutex};
+        if (m_entries.size() >= MAX_ENTRIES) {
+            m_entries.clear();
+        }
+        m_entries.insert_or_assign(filename, entry);
+        return entry.detected;
+    }
+
+private:
+    static constexpr size_t MAX_ENTRIES = 100000;
+    struct Entry {
+        time_t mtime = 0;
+        wxFileOffset size = 0;
+        bool detected = false;
+        FileExtManager::FileType type = FileExtManager::TypeOther;
+    };
+    std::mutex m_mutex;
+    std::unordered_map<wxString, Entry> m_entries;
+};
+
+ContentTypeCache by_content_cache;
+ContentTypeCache workspace_type_cache;
+
+/// Workspace files share the same extension, read the file to tell them apart
+FileExtManager::FileType GetWorkspaceTypeFromContent(const wxString& filename)
+{
+    wxString content;
+    if (!FileUtils::ReadFileContent(filename, content)) {
+        return FileExtManager::TypeWorkspace;
+    }
+
+    if (content.Contains("<CodeLite_Workspace")) {
+        return FileExtManager::TypeWorkspace;
+    }
+
+    JSON root(content);
+    if (!root.isOk()) {
+        return FileExtManager::TypeWorkspace;
+    }
+
+    if (root.toElement().hasNamedObject("NodeJS")) {
+        return FileExtManager::TypeWorkspaceNodeJS;
+    } else if (root.toElement().hasNamedObject("Docker")) {
+        return FileExtManager::TypeWorkspaceDocker;
+    } else if (root.toElement().namedObject("workspace_type").toString() == "File System Workspace") {
+        return FileExtManager::TypeWorkspaceFileSystem;
+    } else if (root.toElement().namedObject("metadata").namedObject("type").toString() == "php") {
+        return FileExtManager::TypeWorkspacePHP;
+    } else {
+        return FileExtManager::TypeWorkspace;
+    }
+}
 } // namespace
 
 void FileExtManager::Init()
@@ -314,32 +406,13 @@ FileExtManager::FileType FileExtManager::GetType(const wxString& filename, FileE
     }
 
     FileExtManager::FileType type = iter->second;
-    if (fn.Exists() && (type == TypeWorkspace)) {
-        wxString content;
-        if (FileUtils::ReadFileContent(fn, content)) {
-            if (content.Contains("<CodeLite_Workspace")) {
-                return TypeWorkspace;
-            } else {
-                JSON root(content);
-                if (!root.isOk())
-                    return TypeWorkspace;
-                if (root.toElement().hasNamedObject("NodeJS")) {
-                    return TypeWorkspaceNodeJS;
-                } else if (root.toElement().hasNamedObject("Docker")) {
-                    return TypeWorkspaceDocker;
-                } else if (root.toElement().namedObject("workspace_type").toString() == "File System Workspace") {
-                    return TypeWorkspaceFileSystem;
-                } else if (root.toElement().namedObject("metadata").namedObject("type").toString() == "php") {
-                    return TypeWorkspacePHP;
-                } else {
-                    return TypeWorkspace;
-                }
-            }
-        } else {
-            return TypeWorkspace;
-        }
+    if (type == TypeWorkspace) {
+        workspace_type_cache.Detect(filename, type, [&filename](FileType& t) {
+            t = GetWorkspaceTypeFromContent(filename);
+            return true;
+        });
     }
-    return iter->second;
+    return type;
 }
 
 /* static */ bool FileExtManager::IsBinaryType(const wxString& filename)
@@ -364,12 +437,15 @@ bool FileExtManager::IsCxxFile(const wxString& filename)
 
 bool FileExtManager::AutoDetectByContent(const wxString& filename, FileExtManager::FileType& fileType)
 {
-    wxString fileContent;
-    if (!FileUtils::ReadBufferFromFile(filename, fileContent, 1024)) {
-        clWARNING() << "Failed to read file's content" << endl;
-        return false;
-    }
-    return GetContentType(fileContent, fileType);
+    Init();
+    return by_content_cache.Detect(filename, fileType, [&filename](FileType& t) {
+        wxString fileContent;
+        if (!FileUtils::ReadBufferFromFile(filename, fileContent, 1024)) {
+            clWARNING() << "Failed to read file's content" << endl;
+            return false;
+        }
+        return GetContentType(fileContent, t);
+    });
 }
 
 std::optional<wxString> FileExtManager::GetFileExtenstion(const wxString& filename, const wxString& string_content)
@@ -0,0 +1,290 @@
+#include "clXmlSnapshot.hpp"
+
+#include "file_logger.h"
+#include "fileutils.h"
+
+#include <cstring>
+#include <memory>
+#include <unordered_set>
+#include <wx/dir.h>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+
+namespace
+{
+constexpr char SNAPSHOT_MAGIC[8] = {'C', 'L', 'X', 'M', 'L', 'S', 'N', '2'};
+constexpr size_t MAX_DEPTH = 512;
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+
+/// FNV-1a
+uint64_t Hash(const char* data, size_t len, uint64_t hash = FNV_OFFSET_BASIS)
+{
+    for (size_t i = 0; i < len; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+bool ReadFile(const wxFileName& fn, std::string* content)
+{
+    wxFFile fp(fn.GetFullPath(), "rb");
+    if (!fp.IsOpened()) {
+        return false;
+    }
+    content->resize(fp.Length());
+    return fp.Read(content->data(), content->size()) == content->size();
+}
+
+template <typename T>
+void Append(std::string& buffer, const T& value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void AppendString(std::string& buffer, const wxString& str)
+{
+    const wxScopedCharBuffer utf8 = str.ToUTF8();
+    Append(buffer, static_cast<uint32_t>(utf8.length()));
+    buffer.append(utf8.data(), utf8.length());
+}
+
+void AppendNode(std::string& buffer, const wxXmlNode* node)
+{
+    Append(buffer, static_cast<uint8_t>(node->GetType()));
+    AppendString(buffer, node->GetName());
+    AppendString(buffer, node->GetContent());
+
+    uint32_t attr_count = 0;
+    for (auto attr = node->GetAttributes(); attr; attr = attr->GetNext()) {
+        ++attr_count;
+    }
+    Append(buffer, attr_count);
+    for (auto attr = node->GetAttributes(); attr; attr = attr->GetNext()) {
+        AppendString(buffer, attr->GetName());
+        AppendString(buffer, attr->GetValue());
+    }
+
+    uint32_t child_count = 0;
+    for (auto child = node->GetChildren(); child; child = child->GetNext()) {
+        ++child_count;
+    }
+    Append(buffer, child_count);
+    for (auto child = node->GetChildren(); child; child = child->GetNext()) {
+        AppendNode(buffer, child);
+    }
+}
+
+/// A bounds checked reader over the snapshot content
+class Reader
+{
+public:
+    explicit Reader(const std::string& buffer)
+        : m_buffer{buffer}
+    {
+    }
+
+    template <typename T>
+    bool Read(T* value)
+    {
+        if (m_pos + sizeof(T) > m_buffer.size()) {
+            return false;
+        }
+        std::memcpy(value, m_buffer.data() + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool ReadString(wxString* str)
+    {
+        uint32_t len = 0;
+        if (!Read(&len) || m_pos + len > m_buffer.size()) {
+            return false;
+        }
+        *str = wxString::FromUTF8(m_buffer.data() + m_pos, len);
+        m_pos += len;
+        return true;
+    }
+
+    /// Read a node and its children. The links between siblings are set directly, as `wxXmlNode::AddChild()` walks
+    /// the whole list of children on every call
+    wxXmlNode* ReadNode(size_t depth)
+    {
+        uint8_t type = 0;
+        wxString name;
+        wxString content;
+        uint32_t attr_count = 0;
+        if (depth > MAX_DEPTH || !Read(&type) || !ReadString(&name) || !ReadString(&content) || !Read(&attr_count)) {
+            return nullptr;
+        }
+
+        auto node = std::make_unique<wxXmlNode>(nullptr, static_cast<wxXmlNodeType>(type), name, content);
+        wxXmlAttribute* last_attr = nullptr;
+        for (uint32_t i = 0; i < attr_count; ++i) {
+            wxString attr_name;
+            wxString attr_value;
+            if (!ReadString(&attr_name) || !ReadString(&attr_value)) {
+                return nullptr;
+            }
+            auto attr = new wxXmlAttribute(attr_name, attr_value);
+            if (last_attr) {
+                last_attr->SetNext(attr);
+            } else {
+                node->SetAttributes(attr);
+            }
+            last_attr = attr;
+        }
+
+        uint32_t child_count = 0;
+        if (!Read(&child_count)) {
+            return nullptr;
+        }
+
+        wxXmlNode* last_child = nullptr;
+        for (uint32_t i = 0; i < child_count; ++i) {
+            wxXmlNode* child = ReadNode(depth + 1);
+            if (!child) {
+                return nullptr;
+            }
+            child->SetParent(node.get());
+            if (last_child) {
+                last_child->SetNext(child);
+            } else {
+                node->SetChildren(child);
+            }
+            last_child = child;
+        }
+        return node.release();
+    }
+
+    bool AtEnd() const { return m_pos == m_buffer.size(); }
+
+private:
+    const std::string& m_buffer;
+    size_t m_pos{0};
+};
+
+bool GetFileHash(const wxFileName& source, uint64_t* hash, uint64_t* size)
+{
+    std::string content;
+    if (!ReadFile(source, &content)) {
+        return false;
+    }
+    *hash = Hash(content.data(), content.size());
+    *size = content.size();
+    return true;
+}
+} // namespace
+
+std::string clXmlSnapshot::ToBuffer(const wxXmlDocument& doc, uint64_t hash, uint64_t size)
+{
+    std::string buffer;
+    buffer.append(SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    Append(buffer, hash);
+    Append(buffer, size);
+    AppendString(buffer, doc.GetVersion());
+    AppendString(buffer, doc.GetFileEncoding());
+    AppendNode(buffer, doc.GetDocumentNode());
+    return buffer;
+}
+
+bool clXmlSnapshot::FromBuffer(const std::string& buffer, uint64_t hash, uint64_t size, wxXmlDocument& doc)
+{
+    if (buffer.size() < sizeof(SNAPSHOT_MAGIC) || std::memcmp(buffer.data(), SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC))) {
+        return false;
+    }
+
+    Reader reader{buffer};
+    char magic[sizeof(SNAPSHOT_MAGIC)];
+    uint64_t snapshot_hash = 0;
+    uint64_t snapshot_size = 0;
+    wxString version;
+    wxString encoding;
+    if (!reader.Read(&magic) || !reader.Read(&snapshot_hash) || !reader.Read(&snapshot_size) ||
+        !reader.ReadString(&version) || !reader.ReadString(&encoding)) {
+        return false;
+    }
+
+    if (snapshot_hash != hash || snapshot_size != size) {
+        // the source file was modified
+        return false;
+    }
+
+    std::unique_ptr<wxXmlNode> document_node{reader.ReadNode(0)};
+    if (!document_node || document_node->GetType() != wxXML_DOCUMENT_NODE || !reader.AtEnd()) {
+        return false;
+    }
+
+    doc.SetDocumentNode(document_node.release());
+    doc.SetVersion(version);
+    doc.SetFileEncoding(encoding);
+    return doc.IsOk();
+}
+
+bool clXmlSnapshot::Save(const wxXmlDocument& doc, const wxFileName& source, const wxFileName& snapshot_file)
+{
+    uint64_t hash = 0;
+    uint64_t size = 0;
+    if (!doc.IsOk() || !GetFileHash(source, &hash, &size)) {
+        return false;
+    }
+
+    if (!snapshot_file.DirExists()) {
+        snapshot_file.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+    return FileUtils::WriteFileContentRaw(snapshot_file, ToBuffer(doc, hash, size));
+}
+
+bool clXmlSnapshot::Load(wxXmlDocument& doc, const wxFileName& source, const wxFileName& snapshot_file)
+{
+    uint64_t hash = 0;
+    uint64_t size = 0;
+    std::string buffer;
+    if (!GetFileHash(source, &hash, &size) || !ReadFile(snapshot_file, &buffer)) {
+        return false;
+    }
+
+    if (!FromBuffer(buffer, hash, size, doc)) {
+        clDEBUG() << "Ignoring stale or corrupted XML snapshot:" << snapshot_file.GetFullPath() << endl;
+        return false;
+    }
+    return true;
+}
+
+wxFileName clXmlSnapshot::GetSnapshotFile(const wxString& dir, const wxFileName& source)
+{
+    // FNV-1a of the full path, so projects with the same name do not collide
+    const std::string path = source.GetFullPath().ToStdString(wxConvUTF8);
+    uint64_t hash = Hash(path.data(), path.size());
+
+    wxString name;
+    name << source.GetName() << "-" << wxString::Format("%016llx", static_cast<unsigned long long>(hash))
+         << ".snapshot";
+    return wxFileName(dir, name);
+}
+
+size_t clXmlSnapshot::Prune(const wxString& dir, const std::vector<wxFileName>& sources)
+{
+    if (!wxFileName::DirExists(dir)) {
+        return 0;
+    }
+
+    std::unordered_set<wxString> keep;
+    for (const auto& source : sources) {
+        keep.insert(GetSnapshotFile(dir, source).GetFullName());
+    }
+
+    wxArrayString files;
+    wxDir::GetAllFiles(dir, &files, "*.snapshot", wxDIR_FILES);
+    size_t count = 0;
+    for (const auto& file : files) {
+        wxFileName fn(file);
+        if (keep.count(fn.GetFullName()) == 0 && FileUtils::RemoveFile(fn, "clXmlSnapshot::Prune")) {
+            ++count;
+        }
+    }
+    if (count) {
+        clDEBUG() << "Deleted" << count << "stale XML snapshot(s) from:" << dir << endl;
+    }
+    return count;
+}
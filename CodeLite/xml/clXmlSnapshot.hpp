@@ -0,0 +1,49 @@
+#ifndef CLXMLSNAPSHOT_HPP
+#define CLXMLSNAPSHOT_HPP
+
+#include "codelite_exports.h"
+
+#include <string>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/xml/xml.h>
+
+/**
+ * @brief a binary copy of a parsed XML document.
+ *
+ * Restoring a snapshot rebuilds the `wxXmlNode` tree directly, skipping the XML tokenizer and the character decoding.
+ * A snapshot is tagged with the size and a hash of the content of the XML file it was created from; if the file
+ * changed since, the snapshot is rejected and the caller should parse the XML file instead. The content is compared
+ * rather than the modification time, which has a resolution of one second on some file systems.
+ */
+class WXDLLIMPEXP_CL clXmlSnapshot
+{
+public:
+    /**
+     * @brief serialize `doc` (loaded from `source`) into `snapshot_file`. The file is written atomically
+     */
+    static bool Save(const wxXmlDocument& doc, const wxFileName& source, const wxFileName& snapshot_file);
+
+    /**
+     * @brief restore `doc` from `snapshot_file`. Return false if the snapshot does not exist, is corrupted or if
+     * `source` was modified after the snapshot was taken
+     */
+    static bool Load(wxXmlDocument& doc, const wxFileName& source, const wxFileName& snapshot_file);
+
+    /**
+     * @brief return the snapshot file for `source`, under `dir`
+     */
+    static wxFileName GetSnapshotFile(const wxString& dir, const wxFileName& source);
+
+    /**
+     * @brief delete the snapshots under `dir` that do not belong to any of `sources` (e.g. the projects removed from
+     * the workspace). Return the number of snapshots deleted
+     */
+    static size_t Prune(const wxString& dir, const std::vector<wxFileName>& sources);
+
+    /// (De)serialize the document tree, exposed for testing
+    static std::string ToBuffer(const wxXmlDocument& doc, uint64_t hash, uint64_t size);
+    static bool FromBuffer(const std::string& buffer, uint64_t hash, uint64_t size, wxXmlDocument& doc);
+};
+
+#endif // CLXMLSNAPSHOT_HPP
@@ -111,6 +111,7 @@ struct LocalVariable {
 struct VariableObjectUpdateInfo {
     wxArrayString removeIds;
     wxArrayString refreshIds;
+    wxStringMap_t values; // gdbId -> new value, for the refreshed variable objects reported with their value
 };
 
 struct DisassembleEntry {
@@ -517,6 +517,17 @@ public:
      */
     virtual void DelAllCompilerMarkers() = 0;
 
+    /**
+     * @brief mark a line with a static analysis (e.g. cppcheck) warning or error. Unlike the compiler markers, these
+     * use their own margin markers and indicators, so they never touch the build errors and warnings
+     */
+    virtual void SetStaticAnalysisMarker(int lineno, bool is_error, const wxString& message) = 0;
+
+    /**
+     * @brief delete all static analysis markers, leaving the compiler markers in place
+     */
+    virtual void DelAllStaticAnalysisMarkers() = 0;
+
     //-------------------------------------------------
     // Provide a user client data API
     //-------------------------------------------------
@@ -620,6 +631,11 @@ public:
      */
     virtual bool IsRemoteFile() const = 0;
 
+    /**
+     * @brief return true if the file is opened in large file mode: no lexer, folding or language server
+     */
+    virtual bool IsLargeFile() const { return false; }
+
     /**
      * @brief return a pointer to the remote data
      * @return remote file info, or null if this file is not a remote a file
@@ -28,6 +28,6 @@
 
 // Interface version is calculated as follows: MAJOR * 1000 + MINOR * 100, e.g. CodeLite 4.1 => 4100, CodeLite 5.0 =>
 // 5000
-#define PLUGIN_INTERFACE_VERSION 16000 // CodeLite 16
+#define PLUGIN_INTERFACE_VERSION 16100 // CodeLite 16.1
 
 #endif // PLUGIN_VERSION_H
@@ -31,4 +31,8 @@ EditorOptionsGeneralEdit::EditorOptionsGeneralEdit(wxWindow* parent, OptionsConf
     AddProperty(_("Enable zoom with mouse scroll"), m_options->IsMouseZoomEnabled(),
                 UPDATE_BOOL_CB(SetMouseZoomEnabled));
     AddProperty(_("Indent line comments"), m_options->GetIndentedComments(), UPDATE_BOOL_CB(SetIndentedComments));
+
+    AddHeader(_("Large Files"));
+    AddProperty(_("Open files larger than this (MB) in large file mode, 0 to disable"),
+                m_options->GetLargeFileThresholdMB(), UPDATE_INT_CB(SetLargeFileThresholdMB));
 }
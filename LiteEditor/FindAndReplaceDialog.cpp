@@ -46,6 +46,7 @@
 #include "manager.h"
 #include "plugin.h"
 
+#include <algorithm>
 #include <wx/dcbuffer.h>
 #include <wx/gdicmn.h>
 #include <wx/regex.h>
@@ -74,6 +75,10 @@ DEFINE_EVENT_TYPE(QUICKFIND_COMMAND_EVENT)
 
 namespace
 {
+// large files are searched a window at a time, and at most LARGE_FILE_SEARCH_LIMIT bytes per search
+constexpr int LARGE_FILE_SEARCH_WINDOW = 4 * 1024 * 1024;
+constexpr int LARGE_FILE_SEARCH_LIMIT = 64 * 1024 * 1024;
+
 void TextCtrlShowMenu(wxTextCtrl* button, wxMenu& menu, wxPoint* point = nullptr)
 {
     wxPoint menuPos;
@@ -912,9 +917,6 @@ TargetRange FindAndReplaceDialog::DoFind(size_t find_flags, const TargetRange& t
         return res;
     }
 
-    m_sci->SetTargetStart(target_start);
-    m_sci->SetTargetEnd(target_end);
-
     size_t stc_search_options = 0;
 
     if (search_options & wxSTC_FIND_REGEXP)
@@ -925,7 +927,17 @@ TargetRange FindAndReplaceDialog::DoFind(size_t find_flags, const TargetRange& t
         stc_search_options |= wxSTC_FIND_WHOLEWORD;
 
     m_sci->SetSearchFlags(stc_search_options);
-    int where = m_sci->SearchInTarget(m_textCtrlFind->GetValue());
+
+    int where = wxNOT_FOUND;
+    int stop_pos = wxNOT_FOUND;
+    if (!target.IsOk() && !m_inSelection && IsLargeFileSearch()) {
+        where = DoSearchInWindows(m_textCtrlFind->GetValue(), target_start, target_end, &stop_pos);
+    } else {
+        m_sci->SetTargetStart(target_start);
+        m_sci->SetTargetEnd(target_end);
+        where = m_sci->SearchInTarget(m_textCtrlFind->GetValue());
+    }
+
     if (where != wxNOT_FOUND) {
         // the target contains the matched string
         target_start = m_sci->GetTargetStart();
@@ -980,6 +992,13 @@ TargetRange FindAndReplaceDialog::DoFind(size_t find_flags, const TargetRange& t
             }
         }
         return {target_start, target_end};
+    } else if (stop_pos != wxNOT_FOUND) {
+        // the next search continues from here
+        m_sci->SetEmptySelection(stop_pos);
+        m_sci->EnsureCaretVisible();
+        TargetRange res = {wxNOT_FOUND, wxNOT_FOUND};
+        res.why = TargetRange::REACHED_SEARCH_LIMIT;
+        return res;
     } else {
         TargetRange res = {wxNOT_FOUND, wxNOT_FOUND};
         res.why = find_flags & FIND_PREV ? TargetRange::REACHED_SOF : TargetRange::REACHED_EOF;
@@ -987,6 +1006,43 @@ TargetRange FindAndReplaceDialog::DoFind(size_t find_flags, const TargetRange& t
     }
 }
 
+bool FindAndReplaceDialog::IsLargeFileSearch() const
+{
+    clEditor* editor = dynamic_cast<clEditor*>(m_sci);
+    return editor && editor->IsLargeFile();
+}
+
+int FindAndReplaceDialog::DoSearchInWindows(const wxString& find_what, int start, int end, int* stop_pos)
+{
+    *stop_pos = wxNOT_FOUND;
+    bool backward = end < start;
+    int searched = 0;
+    int pos = start;
+    while (pos != end) {
+        if (searched >= LARGE_FILE_SEARCH_LIMIT) {
+            *stop_pos = pos;
+            return wxNOT_FOUND;
+        }
+
+        // windows end on a line boundary so a match within a line is never split between two windows
+        int window_end = backward ? std::max(end, pos - LARGE_FILE_SEARCH_WINDOW)
+                                  : std::min(end, pos + LARGE_FILE_SEARCH_WINDOW);
+        int line = m_sci->LineFromPosition(window_end);
+        window_end = backward ? std::max(end, static_cast<int>(m_sci->PositionFromLine(line)))
+                              : std::min(end, static_cast<int>(m_sci->GetLineEndPosition(line)));
+
+        m_sci->SetTargetStart(pos);
+        m_sci->SetTargetEnd(window_end);
+        int where = m_sci->SearchInTarget(find_what);
+        if (where != wxNOT_FOUND) {
+            return where;
+        }
+        searched += std::abs(window_end - pos);
+        pos = window_end;
+    }
+    return wxNOT_FOUND;
+}
+
 void FindAndReplaceDialog::OnFind(wxCommandEvent& event)
 {
     wxUnusedVar(event);
@@ -1095,7 +1151,10 @@ TargetRange FindAndReplaceDialog::DoFindWithMessage(size_t find_flags, const Tar
 
     m_message->SetLabel(wxEmptyString);
     auto res = DoFind(find_flags, target);
-    if (!res.IsOk()) {
+    if (res.why == TargetRange::REACHED_SEARCH_LIMIT) {
+        m_message->SetLabel(wxString::Format(_("No match in the next %d MB, search again to continue"),
+                                             LARGE_FILE_SEARCH_LIMIT / (1024 * 1024)));
+    } else if (!res.IsOk()) {
         if (find_flags & FIND_PREV) {
             m_message->SetLabel(_("Reached the start of the document"));
         } else {
@@ -1108,7 +1167,17 @@ TargetRange FindAndReplaceDialog::DoFindWithMessage(size_t find_flags, const Tar
 TargetRange FindAndReplaceDialog::DoFindWithWrap(size_t find_flags, const TargetRange& target)
 {
     auto res = DoFindWithMessage(find_flags, target);
+    if (res.why == TargetRange::REACHED_SEARCH_LIMIT) {
+        // nothing to wrap: the rest of the document was not searched yet
+        return res;
+    }
+
     if (!res.IsOk()) {
+        if (!target.IsOk() && !m_inSelection && IsLargeFileSearch()) {
+            // wrap by moving the caret so the search stays limited
+            m_sci->SetEmptySelection(find_flags & FIND_PREV ? m_sci->GetLastPosition() : 0);
+            return DoFindWithMessage(find_flags);
+        }
         // reached end or start of the document
         // start from the beginning (the range will switch if FIND_PREV is set)
         res = DoFindWithMessage(find_flags, {0, static_cast<int>(m_sci->GetLastPosition())});
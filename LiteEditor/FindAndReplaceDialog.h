@@ -44,6 +44,7 @@ struct TargetRange {
         REACHED_EOF,
         REACHED_SOF,
         EMPTY_RANGE,
+        REACHED_SEARCH_LIMIT, // large files are searched up to a limit, the caret is moved to where the search stopped
     };
     int start_pos = wxNOT_FOUND;
     int end_pos = wxNOT_FOUND;
@@ -155,6 +156,15 @@ private:
     size_t DoGetSearchFlags() const;
     void DoReplaceAll(bool selectionOnly);
 
+    /// is the editor a file opened in large file mode?
+    bool IsLargeFileSearch() const;
+    /**
+     * @brief search [start, end) (backward if end < start) a window at a time, up to the large file search limit
+     * @param stop_pos set to the position where the search stopped if the limit was reached, wxNOT_FOUND otherwise
+     * @return the match position, the target holds the match
+     */
+    int DoSearchInWindows(const wxString& find_what, int start, int end, int* stop_pos);
+
 protected:
     void OnReplaceKeyDown(wxKeyEvent& event) override;
 
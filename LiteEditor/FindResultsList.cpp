@@ -0,0 +1,309 @@
+#include "FindResultsList.hpp"
+
+#include "clSystemSettings.h"
+#include "drawingutils.h"
+#include "editor_config.h"
+#include "lexer_configuration.h"
+#include "macros.h"
+
+#include <algorithm>
+#include <wx/dcclient.h>
+#include <wx/renderer.h>
+
+namespace
+{
+constexpr int X_MARGIN = 4;
+constexpr int BUTTON_SIZE = 16;
+// a long line is shown from a little before its match
+constexpr size_t MAX_CHARS_BEFORE_MATCH = 80;
+constexpr size_t MAX_CHARS_AFTER_MATCH = 500;
+
+wxString ExpandTabs(const wxString& text)
+{
+    wxString result = text;
+    result.Replace("\t", "    ");
+    return result;
+}
+
+wxString GetLineNumberPrefix(int line) { return wxString::Format(" %5d: ", line); }
+} // namespace
+
+FindResultsList::FindResultsList(wxWindow* parent)
+    : wxVListBox(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxBORDER_NONE)
+{
+    ApplyTheme();
+    Bind(wxEVT_LEFT_DOWN, &FindResultsList::OnLeftDown, this);
+    Bind(wxEVT_KEY_DOWN, &FindResultsList::OnKeyDown, this);
+}
+
+FindResultsList::~FindResultsList()
+{
+    Unbind(wxEVT_LEFT_DOWN, &FindResultsList::OnLeftDown, this);
+    Unbind(wxEVT_KEY_DOWN, &FindResultsList::OnKeyDown, this);
+}
+
+void FindResultsList::SetModel(ModelPtr_t model)
+{
+    m_model = std::move(model);
+    UpdateRows();
+    SetSelection(wxNOT_FOUND);
+    ScrollToRow(0);
+}
+
+void FindResultsList::UpdateRows(bool scrollToBottom)
+{
+    SetItemCount(m_model ? m_model->GetRowCount() : 0);
+    RefreshAll();
+    if (scrollToBottom && GetItemCount() > 0) {
+        ScrollToRow(GetItemCount() - 1);
+    }
+}
+
+void FindResultsList::ToggleFile(size_t file)
+{
+    CHECK_PTR_RET(m_model);
+    m_model->SetExpanded(file, !m_model->IsExpanded(file));
+    UpdateRows();
+    SetSelection(static_cast<int>(m_model->GetFileRow(file)));
+}
+
+void FindResultsList::SetAllExpanded(bool expanded)
+{
+    CHECK_PTR_RET(m_model);
+
+    // keep the selection on the same match, or on its file if the match is no longer visible
+    int sel = GetSelection();
+    clSearchResultsModel::Row row;
+    if (sel != wxNOT_FOUND) {
+        row = m_model->GetRow(sel);
+    }
+
+    m_model->SetAllExpanded(expanded);
+    UpdateRows();
+
+    if (row.file == clSearchResultsModel::npos) {
+        return;
+    }
+    if (!row.IsFile() && expanded) {
+        SetSelection(static_cast<int>(m_model->GetMatchRow(row.match)));
+    } else {
+        SetSelection(static_cast<int>(m_model->GetFileRow(row.file)));
+    }
+}
+
+size_t FindResultsList::GetSelectedMatch() const
+{
+    int sel = GetSelection();
+    if (!m_model || sel == wxNOT_FOUND) {
+        return clSearchResultsModel::npos;
+    }
+    return m_model->GetRow(sel).match;
+}
+
+void FindResultsList::SelectMatch(size_t index)
+{
+    CHECK_PTR_RET(m_model);
+    size_t file = m_model->GetFileOfMatch(index);
+    if (!m_model->IsExpanded(file)) {
+        m_model->SetExpanded(file, true);
+        UpdateRows();
+    }
+    SetSelection(static_cast<int>(m_model->GetMatchRow(index)));
+}
+
+wxString FindResultsList::GetSelectedText() const
+{
+    int sel = GetSelection();
+    if (!m_model || sel == wxNOT_FOUND) {
+        return wxEmptyString;
+    }
+
+    auto row = m_model->GetRow(sel);
+    if (row.IsFile()) {
+        return m_model->GetFileName(row.file);
+    }
+    return GetLineNumberPrefix(m_model->GetLineNumber(row.match)) + m_model->GetLineText(row.match);
+}
+
+void FindResultsList::ApplyTheme()
+{
+    m_font = EditorConfigST::Get()->GetLexer("text")->GetFontForStyle(0, this);
+    m_boldFont = m_font.Bold();
+
+    m_bgColour = DrawingUtils::GetOutputPaneBgColour();
+    m_textColour = DrawingUtils::GetOutputPaneFgColour();
+    bool is_dark = DrawingUtils::IsDark(m_bgColour);
+    m_greyTextColour = m_textColour.ChangeLightness(is_dark ? 70 : 150);
+#ifdef __WXMSW__
+    int factor = 2;
+#else
+    int factor = 5;
+#endif
+    m_matchBgColour = is_dark ? wxColour("GOLD").ChangeLightness(40) : DrawingUtils::LightColour("GOLD", factor);
+    m_selBgColour = clSystemSettings::GetColour(wxSYS_COLOUR_HIGHLIGHT);
+    m_selTextColour = clSystemSettings::GetColour(wxSYS_COLOUR_HIGHLIGHTTEXT);
+
+    wxClientDC dc(this);
+    dc.SetFont(m_font);
+    m_rowHeight = std::max(dc.GetCharHeight() + 4, BUTTON_SIZE + 2);
+
+    SetBackgroundColour(m_bgColour);
+    RefreshAll();
+}
+
+wxCoord FindResultsList::OnMeasureItem(size_t n) const
+{
+    wxUnusedVar(n);
+    return m_rowHeight;
+}
+
+void FindResultsList::OnDrawBackground(wxDC& dc, const wxRect& rect, size_t n) const
+{
+    dc.SetPen(*wxTRANSPARENT_PEN);
+    dc.SetBrush(IsSelected(n) ? m_selBgColour : m_bgColour);
+    dc.DrawRectangle(rect);
+}
+
+void FindResultsList::OnDrawItem(wxDC& dc, const wxRect& rect, size_t n) const
+{
+    if (!m_model) {
+        return;
+    }
+
+    auto row = m_model->GetRow(n);
+    if (row.file == clSearchResultsModel::npos) {
+        return;
+    }
+
+    if (row.IsFile()) {
+        DrawFileRow(dc, rect, row.file, IsSelected(n));
+    } else {
+        DrawMatchRow(dc, rect, row.match, IsSelected(n));
+    }
+}
+
+void FindResultsList::DrawFileRow(wxDC& dc, const wxRect& rect, size_t file, bool selected) const
+{
+    int x = rect.GetX() + X_MARGIN;
+    wxRect button(x, rect.GetY() + (rect.GetHeight() - BUTTON_SIZE) / 2, BUTTON_SIZE, BUTTON_SIZE);
+    wxRendererNative::Get().DrawTreeItemButton(const_cast<FindResultsList*>(this), dc, button,
+                                               m_model->IsExpanded(file) ? wxCONTROL_EXPANDED : 0);
+    x += BUTTON_SIZE + X_MARGIN;
+
+    dc.SetFont(m_boldFont);
+    int y = rect.GetY() + (rect.GetHeight() - dc.GetCharHeight()) / 2;
+    const wxString& filename = m_model->GetFileName(file);
+    dc.SetTextForeground(selected ? m_selTextColour : m_textColour);
+    dc.DrawText(filename, x, y);
+    x += dc.GetTextExtent(filename).GetWidth();
+
+    dc.SetFont(m_font);
+    dc.SetTextForeground(selected ? m_selTextColour : m_greyTextColour);
+    dc.DrawText(wxString::Format(" (%zu)", m_model->GetFileMatchCount(file)), x, y);
+}
+
+void FindResultsList::DrawMatchRow(wxDC& dc, const wxRect& rect, size_t match, bool selected) const
+{
+    dc.SetFont(m_font);
+    int x = rect.GetX() + X_MARGIN + BUTTON_SIZE + X_MARGIN;
+    int y = rect.GetY() + (rect.GetHeight() - dc.GetCharHeight()) / 2;
+
+    wxString prefix = GetLineNumberPrefix(m_model->GetLineNumber(match));
+    dc.SetTextForeground(selected ? m_selTextColour : m_greyTextColour);
+    dc.DrawText(prefix, x, y);
+    x += dc.GetTextExtent(prefix).GetWidth();
+
+    // split the line around the match
+    wxString text = m_model->GetLineText(match);
+    size_t start = std::min<size_t>(m_model->GetColumnInChars(match), text.length());
+    size_t len = std::min<size_t>(m_model->GetLenInChars(match), text.length() - start);
+
+    wxString before = text.Mid(0, start);
+    if (before.length() > MAX_CHARS_BEFORE_MATCH) {
+        before = "..." + before.Right(MAX_CHARS_BEFORE_MATCH);
+    }
+    before = ExpandTabs(before);
+    wxString matched = ExpandTabs(text.Mid(start, len));
+    wxString after = ExpandTabs(text.Mid(start + len, MAX_CHARS_AFTER_MATCH));
+
+    dc.SetTextForeground(selected ? m_selTextColour : m_textColour);
+    dc.DrawText(before, x, y);
+    x += dc.GetTextExtent(before).GetWidth();
+
+    // the highlight is computed here from the match columns instead of being stored per match
+    wxSize matchSize = dc.GetTextExtent(matched);
+    wxRect matchRect(x, rect.GetY() + 1, matchSize.GetWidth(), rect.GetHeight() - 2);
+    if (selected) {
+        dc.SetPen(m_selTextColour);
+        dc.SetBrush(*wxTRANSPARENT_BRUSH);
+    } else {
+        dc.SetPen(m_matchBgColour);
+        dc.SetBrush(m_matchBgColour);
+    }
+    dc.DrawRoundedRectangle(matchRect, 2.0);
+    dc.DrawText(matched, x, y);
+    x += matchSize.GetWidth();
+
+    dc.DrawText(after, x, y);
+}
+
+void FindResultsList::SendActivated(int row)
+{
+    wxCommandEvent event(wxEVT_LISTBOX_DCLICK, GetId());
+    event.SetEventObject(this);
+    event.SetInt(row);
+    GetEventHandler()->ProcessEvent(event);
+}
+
+void FindResultsList::OnLeftDown(wxMouseEvent& event)
+{
+    event.Skip();
+    CHECK_PTR_RET(m_model);
+
+    int row = VirtualHitTest(event.GetY());
+    if (row == wxNOT_FOUND) {
+        return;
+    }
+
+    // a click on the button of a file collapses or expands it
+    auto r = m_model->GetRow(row);
+    if (r.file != clSearchResultsModel::npos && r.IsFile() && event.GetX() < X_MARGIN * 2 + BUTTON_SIZE) {
+        event.Skip(false);
+        SetFocus();
+        ToggleFile(r.file);
+    }
+}
+
+void FindResultsList::OnKeyDown(wxKeyEvent& event)
+{
+    int sel = GetSelection();
+    if (!m_model || sel == wxNOT_FOUND) {
+        event.Skip();
+        return;
+    }
+
+    auto row = m_model->GetRow(sel);
+    switch (event.GetKeyCode()) {
+    case WXK_RETURN:
+    case WXK_NUMPAD_ENTER:
+        SendActivated(sel);
+        return;
+    case WXK_LEFT:
+        // collapse the file, or move to it from one of its matches
+        if (row.IsFile() && m_model->IsExpanded(row.file)) {
+            ToggleFile(row.file);
+        } else {
+            SetSelection(static_cast<int>(m_model->GetFileRow(row.file)));
+        }
+        return;
+    case WXK_RIGHT:
+        if (row.IsFile() && !m_model->IsExpanded(row.file)) {
+            ToggleFile(row.file);
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+    event.Skip();
+}
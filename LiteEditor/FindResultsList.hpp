@@ -0,0 +1,70 @@
+#ifndef FINDRESULTSLIST_HPP
+#define FINDRESULTSLIST_HPP
+
+#include "clSearchResultsModel.hpp"
+
+#include <memory>
+#include <wx/font.h>
+#include <wx/vlbox.h>
+
+/**
+ * @class FindResultsList
+ * @brief a virtual list showing a clSearchResultsModel: a row per file, which can be collapsed, followed by a row per
+ * match. Only the rows on screen are drawn and the match is highlighted while its row is painted.
+ *
+ * Double clicking a row (or hitting ENTER) fires wxEVT_LISTBOX_DCLICK with the row number
+ */
+class FindResultsList : public wxVListBox
+{
+public:
+    using ModelPtr_t = std::shared_ptr<clSearchResultsModel>;
+
+    FindResultsList(wxWindow* parent);
+    ~FindResultsList() override;
+
+    void SetModel(ModelPtr_t model);
+    const ModelPtr_t& GetModel() const { return m_model; }
+
+    /**
+     * @brief update the list after rows were added, collapsed or expanded in the model
+     */
+    void UpdateRows(bool scrollToBottom = false);
+
+    void ToggleFile(size_t file);
+    void SetAllExpanded(bool expanded);
+
+    /// the selected match, clSearchResultsModel::npos if no match is selected
+    size_t GetSelectedMatch() const;
+    /// select match `index`, expanding its file if needed
+    void SelectMatch(size_t index);
+    /// the selected row as text
+    wxString GetSelectedText() const;
+
+    void ApplyTheme();
+
+protected:
+    wxCoord OnMeasureItem(size_t n) const override;
+    void OnDrawItem(wxDC& dc, const wxRect& rect, size_t n) const override;
+    void OnDrawBackground(wxDC& dc, const wxRect& rect, size_t n) const override;
+
+    void OnLeftDown(wxMouseEvent& event);
+    void OnKeyDown(wxKeyEvent& event);
+
+private:
+    void DrawFileRow(wxDC& dc, const wxRect& rect, size_t file, bool selected) const;
+    void DrawMatchRow(wxDC& dc, const wxRect& rect, size_t match, bool selected) const;
+    void SendActivated(int row);
+
+    ModelPtr_t m_model;
+    wxFont m_font;
+    wxFont m_boldFont;
+    wxCoord m_rowHeight = 0;
+    wxColour m_bgColour;
+    wxColour m_textColour;
+    wxColour m_greyTextColour;
+    wxColour m_matchBgColour;
+    wxColour m_selBgColour;
+    wxColour m_selTextColour;
+};
+
+#endif // FINDRESULTSLIST_HPP
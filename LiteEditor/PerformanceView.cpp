@@ -0,0 +1,113 @@
+#include "PerformanceView.hpp"
+
+#include "clThemedListCtrl.h"
+#include "clToolBar.h"
+#include "clTraceRecorder.hpp"
+#include "file_logger.h"
+#include "globals.h"
+#include "imanager.h"
+
+#include <wx/msgdlg.h>
+#include <wx/sizer.h>
+#include <wx/xrc/xmlres.h>
+
+namespace
+{
+constexpr int REFRESH_INTERVAL_MS = 2000;
+
+wxString FormatMicro(uint64_t us)
+{
+    return wxString::Format("%.3f", static_cast<double>(us) / 1000.0);
+}
+} // namespace
+
+PerformanceView::PerformanceView(wxWindow* parent)
+    : wxPanel(parent, wxID_ANY)
+    , m_timer(this)
+{
+    SetSizer(new wxBoxSizer(wxVERTICAL));
+
+    m_toolbar = new clToolBar(this);
+    auto images = m_toolbar->GetBitmapsCreateIfNeeded();
+    m_toolbar->AddTool(wxID_REFRESH, _("Refresh"), images->Add("file_reload"), _("Refresh"));
+    m_toolbar->AddTool(wxID_CLEAR, _("Clear"), images->Add("clear"), _("Discard all recorded spans"));
+    m_toolbar->AddTool(
+        XRCID("perf_export_trace"), _("Export trace"), images->Add("file_save"), _("Export Chrome trace-event JSON"));
+    m_toolbar->Realize();
+    m_toolbar->Bind(wxEVT_TOOL, &PerformanceView::OnRefresh, this, wxID_REFRESH);
+    m_toolbar->Bind(wxEVT_TOOL, &PerformanceView::OnClear, this, wxID_CLEAR);
+    m_toolbar->Bind(wxEVT_TOOL, &PerformanceView::OnExport, this, XRCID("perf_export_trace"));
+    GetSizer()->Add(m_toolbar, 0, wxEXPAND);
+
+    m_ctrl = new clThemedListCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxDV_ROW_LINES);
+    m_ctrl->AppendTextColumn(_("Label"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    m_ctrl->AppendTextColumn(_("Count"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    m_ctrl->AppendTextColumn(_("p50 (ms)"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    m_ctrl->AppendTextColumn(_("p95 (ms)"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    m_ctrl->AppendTextColumn(_("p99 (ms)"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    m_ctrl->AppendTextColumn(_("Max (ms)"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    GetSizer()->Add(m_ctrl, 1, wxEXPAND);
+    GetSizer()->Layout();
+
+    Bind(wxEVT_TIMER, &PerformanceView::OnTimer, this, m_timer.GetId());
+    m_timer.Start(REFRESH_INTERVAL_MS);
+}
+
+PerformanceView::~PerformanceView()
+{
+    m_timer.Stop();
+    Unbind(wxEVT_TIMER, &PerformanceView::OnTimer, this, m_timer.GetId());
+}
+
+void PerformanceView::RefreshStats()
+{
+    auto stats = clTraceRecorder::Get().GetStats();
+
+    m_ctrl->Begin();
+    m_ctrl->DeleteAllItems();
+    for (const auto& entry : stats) {
+        wxVector<wxVariant> cols;
+        cols.push_back(wxString::FromUTF8(entry.name));
+        cols.push_back(wxString() << entry.count);
+        cols.push_back(FormatMicro(entry.p50_us));
+        cols.push_back(FormatMicro(entry.p95_us));
+        cols.push_back(FormatMicro(entry.p99_us));
+        cols.push_back(FormatMicro(entry.max_us));
+        m_ctrl->AppendItem(cols);
+    }
+    m_ctrl->Commit();
+}
+
+void PerformanceView::OnTimer(wxTimerEvent& event)
+{
+    wxUnusedVar(event);
+    if (IsShownOnScreen()) {
+        RefreshStats();
+    }
+}
+
+void PerformanceView::OnRefresh(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+    RefreshStats();
+}
+
+void PerformanceView::OnClear(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+    clTraceRecorder::Get().Clear();
+    RefreshStats();
+}
+
+void PerformanceView::OnExport(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+    wxFileName trace_file = clTraceRecorder::GetDefaultTraceFile();
+    if (!clTraceRecorder::Get().ExportChromeTrace(trace_file)) {
+        ::wxMessageBox(_("Failed to export trace file:\n") + trace_file.GetFullPath(), "CodeLite",
+                       wxICON_ERROR | wxOK | wxCENTER);
+        return;
+    }
+    clSYSTEM() << "Performance trace exported to:" << trace_file.GetFullPath() << endl;
+    clGetManager()->SetStatusMessage(_("Trace exported to: ") + trace_file.GetFullPath(), 5);
+}
@@ -0,0 +1,31 @@
+#ifndef PERFORMANCEVIEW_HPP
+#define PERFORMANCEVIEW_HPP
+
+#include <wx/panel.h>
+#include <wx/timer.h>
+
+class clToolBar;
+class clThemedListCtrl;
+
+/// Per-label latency percentiles of the `BlockTimer` spans. Only created when CodeLite runs in performance mode
+/// (`-r`)
+class PerformanceView : public wxPanel
+{
+public:
+    PerformanceView(wxWindow* parent);
+    ~PerformanceView() override;
+
+protected:
+    void RefreshStats();
+    void OnRefresh(wxCommandEvent& event);
+    void OnClear(wxCommandEvent& event);
+    void OnExport(wxCommandEvent& event);
+    void OnTimer(wxTimerEvent& event);
+
+private:
+    clToolBar* m_toolbar = nullptr;
+    clThemedListCtrl* m_ctrl = nullptr;
+    wxTimer m_timer;
+};
+
+#endif // PERFORMANCEVIEW_HPP
@@ -1323,8 +1323,8 @@ void CodeLiteApp::FinalizeShutdown()
     EditorConfigST::Free();
     ConfFileLocator::Release();
 
-    // flush any saved changes to the configuration file
-    clConfig::Get().Save();
+    // flush any pending changes to the configuration file
+    clConfig::Get().Flush();
     if (m_restartCodeLite) {
         // Execute new CodeLite instance
         if (!m_restartWD.empty()) {
@@ -0,0 +1,29 @@
+#ifndef CLEDITORPLACEHOLDER_HPP
+#define CLEDITORPLACEHOLDER_HPP
+
+#include <wx/filename.h>
+#include <wx/panel.h>
+
+/**
+ * @class clEditorPlaceholder
+ * @brief the notebook page of a restored session tab that was not loaded yet. MainBook replaces it with an editor
+ * the first time the page is selected or the file is looked up
+ */
+class clEditorPlaceholder : public wxPanel
+{
+public:
+    clEditorPlaceholder(wxWindow* parent, const wxFileName& filename)
+        : wxPanel(parent)
+        , m_filename(filename)
+    {
+        Hide();
+    }
+    ~clEditorPlaceholder() override = default;
+
+    const wxFileName& GetFileName() const { return m_filename; }
+
+private:
+    wxFileName m_filename;
+};
+
+#endif // CLEDITORPLACEHOLDER_HPP
@@ -75,7 +75,6 @@
 #include "pluginmanager.h"
 #include "quickdebuginfo.h"
 #include "simpletable.h"
-#include "stringhighlighterjob.h"
 #include "stringsearcher.h"
 #include "tags_options_data.h"
 #include "wxCodeCompletionBoxManager.h"
@@ -88,6 +87,7 @@
 #include <wx/filefn.h>
 #include <wx/filename.h>
 #include <wx/fontmap.h>
+#include <wx/gauge.h>
 #include <wx/log.h>
 #include <wx/msgdlg.h>
 #include <wx/printdlg.h>
@@ -562,6 +562,12 @@ clEditor::clEditor(wxWindow* parent)
 
 clEditor::~clEditor()
 {
+    // stop the workers before their callbacks can reach a destroyed editor
+    if (m_largeFileLoader) {
+        m_largeFileLoader->Cancel();
+    }
+    clWordHighlighter::Get().Cancel(this);
+
     // Report file-close event
     if (GetFileName().IsOk() && GetFileName().FileExists()) {
         clCommandEvent eventClose(wxEVT_FILE_CLOSED);
@@ -617,6 +623,10 @@ void clEditor::SetSyntaxHighlight(const wxString& lexerName)
     SetEOL();
     m_context->SetActive();
     m_context->ApplySettings();
+    if (m_largeFile) {
+        // the context sets its lexer, large files are never lexed
+        SetLexer(wxSTC_LEX_NULL);
+    }
 
     SetCurrentLineMarginStyle(GetCtrl());
     CallAfter(&clEditor::UpdateColours);
@@ -631,6 +641,9 @@ void clEditor::SetSyntaxHighlight(bool bUpdateColors)
 
     m_context->SetActive();
     m_context->ApplySettings();
+    if (m_largeFile) {
+        SetLexer(wxSTC_LEX_NULL);
+    }
     if (bUpdateColors) {
         UpdateColours();
     }
@@ -731,7 +744,8 @@ void clEditor::SetProperties()
     SetVirtualSpaceOptions(options->HasOption(OptionsConfig::Opt_AllowCaretAfterEndOfLine) ? 2 : 1);
     SetCaretStyle(options->HasOption(OptionsConfig::Opt_UseBlockCaret) ? wxSTC_CARETSTYLE_BLOCK
                                                                        : wxSTC_CARETSTYLE_LINE);
-    SetWrapMode(options->GetWordWrap() ? wxSTC_WRAP_WORD : wxSTC_WRAP_NONE);
+    // wrapping a large file means laying out all of its lines
+    SetWrapMode(options->GetWordWrap() && !m_largeFile ? wxSTC_WRAP_WORD : wxSTC_WRAP_NONE);
     SetViewWhiteSpace(options->GetShowWhitespaces());
     SetMouseDwellTime(500);
     SetProperty(wxT("fold"), wxT("1"));
@@ -810,7 +824,8 @@ void clEditor::SetProperties()
     // line number margin displays every thing but folding, bookmarks and breakpoint
     SetMarginMask(
         NUMBER_MARGIN_ID,
-        ~(mmt_folds | mmt_all_bookmarks | mmt_indicator | mmt_compiler | mmt_all_breakpoints | mmt_line_marker));
+        ~(mmt_folds | mmt_all_bookmarks | mmt_indicator | mmt_compiler | mmt_all_breakpoints | mmt_line_marker |
+          mmt_static_analysis));
 
     // Hide the "Tracker" margin, we use the line numbers instead
     SetMarginType(EDIT_TRACKER_MARGIN_ID, 4);
@@ -890,7 +905,7 @@ void clEditor::SetProperties()
     SetMarginMask(FOLD_MARGIN_ID, wxSTC_MASK_FOLDERS);
     SetMarginType(FOLD_MARGIN_ID, wxSTC_MARGIN_SYMBOL);
     SetMarginSensitive(FOLD_MARGIN_ID, true);
-    SetMarginWidth(FOLD_MARGIN_ID, options->GetDisplayFoldMargin() ? FromDIP(MARGIN_WIDTH) : 0);
+    SetMarginWidth(FOLD_MARGIN_ID, options->GetDisplayFoldMargin() && !m_largeFile ? FromDIP(MARGIN_WIDTH) : 0);
     StyleSetBackground(FOLD_MARGIN_ID, StyleGetBackground(wxSTC_STYLE_DEFAULT));
 
     if (options->GetFoldStyle() == wxT("Flatten Tree Square Headers")) {
@@ -1010,6 +1025,14 @@ void clEditor::SetProperties()
     MarkerSetForeground(smt_error, wxColor(128, 0, 0));
     MarkerSetBackground(smt_error, wxColor(255, 0, 0));
 
+    // static analysis markers: same colours as the compiler ones, but a box so the two can be told apart
+    MarkerDefine(smt_static_analysis_warning, wxSTC_MARK_SMALLRECT);
+    MarkerSetForeground(smt_static_analysis_warning, wxColor(128, 128, 0));
+    MarkerSetBackground(smt_static_analysis_warning, wxColor(255, 215, 0));
+    MarkerDefine(smt_static_analysis_error, wxSTC_MARK_SMALLRECT);
+    MarkerSetForeground(smt_static_analysis_error, wxColor(128, 0, 0));
+    MarkerSetBackground(smt_static_analysis_error, wxColor(255, 0, 0));
+
     CallTipSetBackground(wxSystemSettings::GetColour(wxSYS_COLOUR_INFOBK));
     CallTipSetForeground(wxSystemSettings::GetColour(wxSYS_COLOUR_INFOTEXT));
 
@@ -1101,6 +1124,11 @@ void clEditor::SetProperties()
     IndicatorSetStyle(INDICATOR_DEBUGGER, indicator_style);
     IndicatorSetForeground(INDICATOR_DEBUGGER, wxT("GREY"));
 
+    IndicatorSetStyle(INDICATOR_STATIC_ANALYSIS_WARNING, wxSTC_INDIC_SQUIGGLE);
+    IndicatorSetForeground(INDICATOR_STATIC_ANALYSIS_WARNING, wxColor(255, 215, 0));
+    IndicatorSetStyle(INDICATOR_STATIC_ANALYSIS_ERROR, wxSTC_INDIC_SQUIGGLE);
+    IndicatorSetForeground(INDICATOR_STATIC_ANALYSIS_ERROR, wxColor(255, 0, 0));
+
     CmdKeyClear(wxT('L'), wxSTC_KEYMOD_CTRL); // clear Ctrl+D because we use it for something else
 
     // Set CamelCase caret movement
@@ -1542,7 +1570,8 @@ void clEditor::OnSciUpdateUI(wxStyledTextEvent& event)
 #endif
     }
 
-    {
+    if (event.GetUpdated() & (wxSTC_UPDATE_CONTENT | wxSTC_UPDATE_SELECTION)) {
+        // scrolling does not move the caret, no need to match the braces again
         __PERF_DISABLE(BlockTimer timer_2{"Brace Matching"})
         DoBraceMatching();
     }
@@ -2050,6 +2079,10 @@ void clEditor::OnDwellStart(wxStyledTextEvent& event)
             tooltip = m_compilerMessagesMap.find(line)->second.message;
             // Disable markdown to ensure it doesn't break anything
             StringUtils::DisableMarkdownStyling(tooltip);
+
+        } else if ((MarkerGet(line) & mmt_static_analysis) && m_staticAnalysisMessagesMap.count(line)) {
+            tooltip = m_staticAnalysisMessagesMap.find(line)->second;
+            StringUtils::DisableMarkdownStyling(tooltip);
         }
 
         if (!tooltip.IsEmpty()) {
@@ -3068,6 +3101,13 @@ void clEditor::OpenFile()
         return;
     }
 
+    if (!IsRemoteFile() && ShouldOpenAsLargeFile()) {
+        DoOpenLargeFile();
+        return;
+    } else if (m_largeFile) {
+        DoLeaveLargeFileMode();
+    }
+
     // State locker (on dtor it restores: bookmarks, current line, breakpoints and folds)
     clEditorStateLocker stateLocker(GetCtrl());
 
@@ -3116,6 +3156,139 @@ void clEditor::OpenFile()
     CallAfter(&clEditor::SetProperties);
 }
 
+bool clEditor::ShouldOpenAsLargeFile() const
+{
+    return clLargeFileLoader::IsLargeFile(m_fileName.GetFullPath(), std::max(0, GetOptions()->GetLargeFileThresholdMB()));
+}
+
+void clEditor::DoOpenLargeFile()
+{
+    m_largeFile = true;
+    if (!m_largeFileLoader) {
+        m_largeFileLoader = std::make_unique<clLargeFileLoader>();
+    }
+    m_largeFileLoader->Cancel();
+    size_t loadId = ++m_largeFileLoadId;
+
+    // a document without styles and with the large document layout
+    void* doc = CreateDocument(0, wxSTC_DOCUMENTOPTION_STYLES_NONE | wxSTC_DOCUMENTOPTION_TEXT_LARGE);
+    SetDocPointer(doc);
+    ReleaseDocument(doc);
+
+    // no lexing, folding, wrapping or undo history
+    SetLexer(wxSTC_LEX_NULL);
+    SetProperty("fold", "0");
+    SetMarginWidth(FOLD_MARGIN_ID, 0);
+    SetWrapMode(wxSTC_WRAP_NONE);
+    SetUndoCollection(false);
+    SetReadOnly(true);
+    m_fileBom.Clear();
+
+    if (!m_largeFileProgress) {
+        m_largeFileProgress = new wxGauge(this, wxID_ANY, 100);
+    }
+    wxRect rect = GetClientRect();
+    m_largeFileProgress->SetSize(rect.GetX(), rect.GetY(), rect.GetWidth(), FromDIP(6));
+    m_largeFileProgress->SetValue(0);
+    m_largeFileProgress->Show();
+    m_mgr->GetStatusBar()->SetMessage(_("Loading file..."));
+
+    // the callbacks are called on the loader thread
+    bool started = m_largeFileLoader->Load(
+        m_fileName.GetFullPath(),
+        [this, loadId](std::shared_ptr<std::string> chunk, size_t bytesRead, size_t fileSize) {
+            CallAfter([this, loadId, chunk, bytesRead, fileSize]() {
+                OnLargeFileChunk(loadId, chunk, bytesRead, fileSize);
+            });
+        },
+        [this, loadId](bool success) { CallAfter([this, loadId, success]() { OnLargeFileLoaded(loadId, success); }); });
+
+    if (!started) {
+        OnLargeFileLoaded(loadId, false);
+    }
+}
+
+void clEditor::DoLeaveLargeFileMode()
+{
+    if (m_largeFileLoader) {
+        m_largeFileLoader->Cancel();
+    }
+    ++m_largeFileLoadId;
+    wxDELETE(m_largeFileProgress);
+
+    // back to a regular document
+    void* doc = CreateDocument(0, wxSTC_DOCUMENTOPTION_DEFAULT);
+    SetDocPointer(doc);
+    ReleaseDocument(doc);
+
+    m_largeFile = false;
+    SetReadOnly(false);
+    SetUndoCollection(true);
+    SetSyntaxHighlight(false);
+}
+
+void clEditor::OnLargeFileChunk(size_t loadId, std::shared_ptr<std::string> chunk, size_t bytesRead, size_t fileSize)
+{
+    if (loadId != m_largeFileLoadId) {
+        // a chunk of a cancelled load
+        return;
+    }
+
+    SetReadOnly(false);
+    AppendTextRaw(chunk->data(), chunk->size());
+    SetReadOnly(true);
+    m_largeFileLoader->Release();
+
+    int percent = fileSize == 0 ? 100 : static_cast<int>((bytesRead * 100) / fileSize);
+    if (m_largeFileProgress) {
+        m_largeFileProgress->SetValue(percent);
+    }
+    m_mgr->GetStatusBar()->SetMessage(wxString::Format(_("Loading file... %d%%"), percent));
+}
+
+void clEditor::OnLargeFileLoaded(size_t loadId, bool success)
+{
+    if (loadId != m_largeFileLoadId) {
+        return;
+    }
+
+    wxDELETE(m_largeFileProgress);
+    SetReadOnly(false);
+    SetUndoCollection(true);
+    EmptyUndoBuffer();
+    SetSavePoint();
+    GetCommandsProcessor().Reset();
+
+    // the content was passed as is, write it back the same way
+    if (m_largeFileLoader->HasUtf8Bom()) {
+        m_fileBom.SetData("\xEF\xBB\xBF", 3);
+    }
+    m_modifyTime = GetFileLastModifiedTime();
+
+    UpdateLineNumberMarginWidth();
+    SetEOL();
+    clMainFrame::Get()->GetMainBook()->MarkEditorReadOnly(this);
+    SetReloadingFile(false);
+
+    if (!success) {
+        m_mgr->GetStatusBar()->SetMessage(_("Failed to load file: ") + m_fileName.GetFullName());
+        return;
+    }
+
+    bool isUtf8 = m_largeFileLoader->IsUtf8();
+    if (!isUtf8) {
+        // the content is not converted: saving it as UTF-8 would lose the bytes that are not valid UTF-8
+        SetReadOnly(true);
+        clWARNING() << "Large file is not UTF-8, opened as read-only:" << m_fileName.GetFullPath() << clEndl;
+    }
+
+    clCommandEvent fileLoadedEvent(wxEVT_FILE_LOADED);
+    fileLoadedEvent.SetFileName(FileUtils::RealPath(GetFileName().GetFullPath()));
+    EventNotifier::Get()->AddPendingEvent(fileLoadedEvent);
+    m_mgr->GetStatusBar()->SetMessage(isUtf8 ? _("Ready")
+                                             : _("The file is not UTF-8 encoded, it was opened as read-only"));
+}
+
 void clEditor::SetEditorText(const wxString& text)
 {
     wxWindowUpdateLocker locker(this);
@@ -3854,6 +4027,45 @@ void clEditor::DelAllCompilerMarkers()
     NotifyMarkerChanged();
 }
 
+void clEditor::SetStaticAnalysisMarker(int lineno, bool is_error, const wxString& message)
+{
+    if (lineno < 0 || lineno >= GetLineCount()) {
+        return;
+    }
+
+    // several diagnostics may point to the same line, keep them all for the tooltip
+    wxString& tooltip = m_staticAnalysisMessagesMap[lineno];
+    if (!tooltip.empty()) {
+        tooltip << "\n";
+    }
+    tooltip << message;
+
+    MarkerAdd(lineno, is_error ? smt_static_analysis_error : smt_static_analysis_warning);
+    NotifyMarkerChanged(lineno);
+
+    // underline the line's text, skipping its indentation
+    int start_pos = GetLineIndentPosition(lineno);
+    int end_pos = GetLineEndPosition(lineno);
+    if (end_pos > start_pos) {
+        SetIndicatorCurrent(is_error ? INDICATOR_STATIC_ANALYSIS_ERROR : INDICATOR_STATIC_ANALYSIS_WARNING);
+        IndicatorFillRange(start_pos, end_pos - start_pos);
+    }
+}
+
+void clEditor::DelAllStaticAnalysisMarkers()
+{
+    MarkerDeleteAll(smt_static_analysis_warning);
+    MarkerDeleteAll(smt_static_analysis_error);
+
+    SetIndicatorCurrent(INDICATOR_STATIC_ANALYSIS_WARNING);
+    IndicatorClearRange(0, GetLength());
+    SetIndicatorCurrent(INDICATOR_STATIC_ANALYSIS_ERROR);
+    IndicatorClearRange(0, GetLength());
+
+    m_staticAnalysisMessagesMap.clear();
+    NotifyMarkerChanged();
+}
+
 // Maybe one day we'll display multiple bps differently
 void clEditor::SetBreakpointMarker(int lineno,
                                    BreakpointType bptype,
@@ -3994,7 +4206,13 @@ void clEditor::OnDbgCustomWatch(wxCommandEvent& event)
     }
 }
 
-void clEditor::UpdateColours() { Colourise(0, wxSTC_INVALID_POSITION); }
+void clEditor::UpdateColours()
+{
+    if (m_largeFile) {
+        return;
+    }
+    Colourise(0, wxSTC_INVALID_POSITION);
+}
 
 int clEditor::SafeGetChar(int pos)
 {
@@ -4050,6 +4268,11 @@ int clEditor::GetCurrLineHeight()
 
 void clEditor::DoHighlightWord()
 {
+    // marking every occurrence means searching the whole document
+    if (m_largeFile) {
+        return;
+    }
+
     // Read the primary selected text
     int mainSelectionStart = GetSelectionNStart(GetMainSelection());
     int mainSelectionEnd = GetSelectionNEnd(GetMainSelection());
@@ -4061,69 +4284,28 @@ void clEditor::DoHighlightWord()
         return;
     }
 
-    // Search only the visible areas
-    StringHighlighterJob j;
+    // Search the visible lines and a screen above and below them: scrolling by less than a screen keeps the markers
+    int screenLines = LinesOnScreen();
     int firstVisibleLine = GetFirstVisibleLine();
-    int lastDocLine = LineFromPosition(GetLength());
-    int offset = PositionFromLine(firstVisibleLine);
-
-    if (GetAllLinesVisible()) {
-        // The simple case: there aren't any folds
-        int lastLine = firstVisibleLine + LinesOnScreen();
-        if (lastLine > lastDocLine) {
-            lastLine = lastDocLine;
-        }
-        int lastPos = PositionFromLine(lastLine) + LineLength(lastLine);
-        wxString text = GetTextRange(offset, lastPos);
-        j.Set(text, word, offset);
-        j.Process();
-    } else {
-
-        // There are folds, so we have to process each visible section separately
-        firstVisibleLine = DocLineFromVisible(firstVisibleLine); // This copes with folds above the displayed lines
-        int lineCount(0);
-        int nextLineToProcess(firstVisibleLine);
-        int screenLines(LinesOnScreen());
-        while (lineCount < screenLines && nextLineToProcess <= lastDocLine) {
-            int offset(-1);
-            int line = nextLineToProcess;
-
-            // Skip over any invisible lines
-            while (!GetLineVisible(line) && line < lastDocLine) {
-                ++line;
-            }
-
-            // EOF?
-            if (line >= lastDocLine)
-                break;
-
-            while (GetLineVisible(line) && line <= lastDocLine) {
-                if (offset == -1) {
-                    offset = PositionFromLine(line); // Get offset value the first time through
-                }
-                ++line;
-                ++lineCount;
-                if (lineCount >= screenLines) {
-                    break;
-                }
-            }
-            if (line > lastDocLine) {
-                line = lastDocLine;
-            }
-            nextLineToProcess = line;
+    int firstLine = DocLineFromVisible(std::max(0, firstVisibleLine - screenLines));
+    int lastLine = std::min(DocLineFromVisible(firstVisibleLine + 2 * screenLines), GetLineCount() - 1);
+    int startPos = PositionFromLine(firstLine);
+    int endPos = GetLineEndPosition(lastLine);
 
-            int lastPos = PositionFromLine(nextLineToProcess) + LineLength(nextLineToProcess);
-            wxString text = GetTextRange(offset, lastPos);
-            j.Set(text, word, offset);
-            j.Process();
-        }
-    }
+    // the search runs on a snapshot of the range, a newer search cancels this one
+    wxCharBuffer text = GetTextRangeRaw(startPos, endPos);
+    wxCharBuffer rawWord = GetTextRangeRaw(mainSelectionStart, mainSelectionEnd);
 
-    // Keep the first offset
-    m_highlightedWordInfo.Clear();
-    m_highlightedWordInfo.SetFirstOffset(offset);
+    m_highlightedWordInfo.SetRange(startPos, endPos);
     m_highlightedWordInfo.SetWord(word);
-    HighlightWord((StringHighlightOutput*)&j.GetOutput());
+    m_wordHighlightId = clWordHighlighter::Get().Submit(
+        this,
+        std::string(text.data(), text.length()),
+        startPos,
+        std::string(rawWord.data(), rawWord.length()),
+        [this](size_t id, clWordHighlighter::Matches_t matches) {
+            CallAfter([this, id, matches = std::move(matches)]() { HighlightWord(id, matches); });
+        });
 }
 
 void clEditor::HighlightWord(bool highlight)
@@ -4133,10 +4315,15 @@ void clEditor::HighlightWord(bool highlight)
         __PERF_IF_ENABLED(BlockTimer timer_enable{"Enable"})
         DoHighlightWord();
 
-    } else if (m_highlightedWordInfo.IsHasMarkers()) {
+    } else if (m_highlightedWordInfo.IsActive()) {
         __PERF_IF_ENABLED(BlockTimer timer_clear{"Clearing"})
-        SetIndicatorCurrent(INDICATOR_WORD_HIGHLIGHT);
-        IndicatorClearRange(0, GetLength());
+        // drop the result of a search that is still running
+        clWordHighlighter::Get().Cancel(this);
+        m_wordHighlightId = 0;
+        if (m_highlightedWordInfo.IsHasMarkers()) {
+            SetIndicatorCurrent(INDICATOR_WORD_HIGHLIGHT);
+            IndicatorClearRange(0, GetLength());
+        }
         m_highlightedWordInfo.Clear();
     }
 }
@@ -4960,26 +5147,25 @@ bool clEditor::ReplaceAllExactMatch(const wxString& what, const wxString& replac
 
 void clEditor::SetLexerName(const wxString& lexerName) { SetSyntaxHighlight(lexerName); }
 
-void clEditor::HighlightWord(StringHighlightOutput* highlightOutput)
+void clEditor::HighlightWord(size_t id, const clWordHighlighter::Matches_t& matches)
 {
-    // the search highlighter thread has completed the calculations, fetch the results and mark them
-    // in the editor
-    const std::vector<std::pair<int, int>>& matches = highlightOutput->matches;
+    // the word highlighter thread has completed the search, mark the results in the editor in one go
+    if (id != m_wordHighlightId) {
+        // a newer search was submitted or the highlight was cleared
+        return;
+    }
+
     SetIndicatorCurrent(INDICATOR_WORD_HIGHLIGHT);
 
     // clear the old markers
     IndicatorClearRange(0, GetLength());
-    if (!highlightOutput->matches.empty()) {
-        m_highlightedWordInfo.SetHasMarkers(true);
-        int selStart = GetSelectionStart();
-        for (const std::pair<int, int>& p : matches) {
-            // Don't highlight the current selection
-            if (p.first != selStart) {
-                IndicatorFillRange(p.first, p.second);
-            }
+    m_highlightedWordInfo.SetHasMarkers(!matches.empty());
+    int selStart = GetSelectionStart();
+    for (const std::pair<int, int>& p : matches) {
+        // Don't highlight the current selection
+        if (p.first != selStart) {
+            IndicatorFillRange(p.first, p.second);
         }
-    } else {
-        m_highlightedWordInfo.Clear();
     }
 }
 
@@ -5336,7 +5522,7 @@ void clEditor::OnTimer(wxTimerEvent& event)
     if (!HasFocus())
         return;
 
-    if (!HasSelection() && m_highlightedWordInfo.IsHasMarkers()) {
+    if (!HasSelection() && m_highlightedWordInfo.IsActive()) {
         HighlightWord(false);
 
     } else if (HasSelection() && EditorConfigST::Get()->GetInteger("highlight_word") == 1) {
@@ -5797,6 +5983,14 @@ void clEditor::ReloadFromDisk(bool keepUndoHistory)
         return;
     }
 
+    if (!IsRemoteFile() && ShouldOpenAsLargeFile()) {
+        // large files have no undo history to keep
+        DoOpenLargeFile();
+        return;
+    } else if (m_largeFile) {
+        DoLeaveLargeFileMode();
+    }
+
     clEditorStateLocker stateLocker(GetCtrl());
 
     wxString text;
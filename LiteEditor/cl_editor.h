@@ -33,6 +33,8 @@
 #include "clEditorStateLocker.h"
 #include "clFileSystemWatcher.h"
 #include "clIdleEventThrottler.hpp"
+#include "clLargeFileLoader.hpp"
+#include "clWordHighlighter.hpp"
 #include "cl_calltip.h"
 #include "cl_unredo.h"
 #include "context_base.h"
@@ -41,8 +43,8 @@
 #include "lexer_configuration.h"
 #include "navigationmanager.h"
 #include "plugin.h"
-#include "stringhighlighterjob.h"
 
+#include <algorithm>
 #include <cstdint>
 #include <limits>
 #include <map>
@@ -55,6 +57,7 @@
 #include <wx/stc/stc.h>
 
 class wxRichToolTip;
+class wxGauge;
 class CCBoxTipWindow;
 class IManager;
 class wxFindReplaceDialog;
@@ -185,34 +188,52 @@ private:
     struct MarkWordInfo {
     private:
         bool m_hasMarkers;
-        int m_firstOffset;
+        int m_startPos;
+        int m_endPos;
         wxString m_word;
 
     public:
         MarkWordInfo()
             : m_hasMarkers(false)
-            , m_firstOffset(wxNOT_FOUND)
+            , m_startPos(wxNOT_FOUND)
+            , m_endPos(wxNOT_FOUND)
         {
         }
 
         void Clear()
         {
             m_hasMarkers = false;
-            m_firstOffset = wxNOT_FOUND;
+            m_startPos = wxNOT_FOUND;
+            m_endPos = wxNOT_FOUND;
             m_word.Clear();
         }
 
+        /**
+         * @brief is the word searched (or being searched) in a range covering the visible lines?
+         */
         bool IsValid(wxStyledTextCtrl* ctrl) const
         {
-            return ctrl->PositionFromLine(ctrl->GetFirstVisibleLine()) == m_firstOffset && m_hasMarkers;
+            if (!IsActive()) {
+                return false;
+            }
+            int firstVisibleLine = ctrl->GetFirstVisibleLine();
+            int firstLine = ctrl->DocLineFromVisible(firstVisibleLine);
+            int lastLine = std::min(ctrl->DocLineFromVisible(firstVisibleLine + ctrl->LinesOnScreen()),
+                                    ctrl->GetLineCount() - 1);
+            return ctrl->PositionFromLine(firstLine) >= m_startPos && ctrl->GetLineEndPosition(lastLine) <= m_endPos;
         }
 
         // setters/getters
-        void SetFirstOffset(int firstOffset) { this->m_firstOffset = firstOffset; }
+        void SetRange(int startPos, int endPos)
+        {
+            this->m_startPos = startPos;
+            this->m_endPos = endPos;
+        }
         void SetHasMarkers(bool hasMarkers) { this->m_hasMarkers = hasMarkers; }
         void SetWord(const wxString& word) { this->m_word = word; }
-        int GetFirstOffset() const { return m_firstOffset; }
         bool IsHasMarkers() const { return m_hasMarkers; }
+        /// a word is highlighted, or its search is still running
+        bool IsActive() const { return !m_word.IsEmpty(); }
         const wxString& GetWord() const { return m_word; }
     };
 
@@ -737,6 +758,10 @@ public:
     void SetErrorMarker(int lineno, CompilerMessage&& msg) override;
     void DelAllCompilerMarkers() override;
 
+    // static analysis warnings and errors
+    void SetStaticAnalysisMarker(int lineno, bool is_error, const wxString& message) override;
+    void DelAllStaticAnalysisMarkers() override;
+
     void DoShowCalltip(int pos, const wxString& title, const wxString& tip, bool strip_html_tags = true);
     /**
      * @brief adjust calltip window position to fit into the display screen
@@ -959,7 +984,7 @@ public:
     bool GetIsVisible() const { return m_isVisible; }
 
     wxString GetEolString();
-    void HighlightWord(StringHighlightOutput* highlightOutput);
+    void HighlightWord(size_t id, const clWordHighlighter::Matches_t& matches);
 
     /**
      * Get a vector of relevant position changes. Used for 'GoTo next/previous FindInFiles match'
@@ -997,6 +1022,11 @@ public:
      */
     bool IsRemoteFile() const override;
 
+    /**
+     * @brief return true if the file is opened in large file mode
+     */
+    bool IsLargeFile() const override { return m_largeFile; }
+
     /**
      * @brief return a pointer to the remote data
      * @return remote file info, or null if this file is not a remote a file
@@ -1008,6 +1038,14 @@ private:
     void UpdateLineNumberMarginWidth();
     void DoUpdateTLWTitle(bool raise);
     void DoWrapPrevSelectionWithChars(wxChar first, wxChar last);
+
+    // large file mode
+    bool ShouldOpenAsLargeFile() const;
+    void DoOpenLargeFile();
+    void DoLeaveLargeFileMode();
+    void OnLargeFileChunk(size_t loadId, std::shared_ptr<std::string> chunk, size_t bytesRead, size_t fileSize);
+    void OnLargeFileLoaded(size_t loadId, bool success);
+
     int GetFirstSingleLineCommentPos(int from, int commentStyle);
     void DoSelectRange(const LSP::Range& range, bool center_line);
     /**
@@ -1135,6 +1173,7 @@ private:
     std::vector<std::pair<int, int>> m_savedMarkers;
     bool m_findBookmarksActive;
     std::map<int, CompilerMessage> m_compilerMessagesMap;
+    std::map<int, wxString> m_staticAnalysisMessagesMap;
     CLCommandProcessor m_commandsProcessor;
     wxString m_preProcessorsWords;
     SelectionInfo m_prevSelectionInfo;
@@ -1174,4 +1213,10 @@ private:
     bool m_hasBraceHighlight = false;
     clIdleEventThrottler m_event_throttler{250};
     std::unique_ptr<clWatchedFileLocker> m_watcher{nullptr};
+    bool m_largeFile = false;
+    std::unique_ptr<clLargeFileLoader> m_largeFileLoader;
+    size_t m_largeFileLoadId = 0; // chunks of a previous load that are still queued are dropped
+    wxGauge* m_largeFileProgress = nullptr;
+    // the id of the latest search submitted to clWordHighlighter::Get()
+    size_t m_wordHighlightId = 0;
 };
@@ -331,12 +331,12 @@ SearchData FindInFilesDialog::DoGetSearchData()
                 files.Add(editor->GetFileName().GetFullPath());
             }
         } else if ((rootDir == wxGetTranslation(SEARCH_IN_OPEN_FILES)) || (rootDir == SEARCH_IN_OPEN_FILES)) {
-            std::vector<clEditor*> editors = clMainFrame::Get()->GetMainBook()->GetAllEditors();
-
-            for (size_t n = 0; n < editors.size(); ++n) {
-                clEditor* editor = dynamic_cast<clEditor*>(*(editors.begin() + n));
-                if (editor) {
-                    files.Add(editor->GetFileName().GetFullPath());
+            // the tabs, including the ones of the restored session that were not loaded yet
+            clTab::Vec_t tabs;
+            clMainFrame::Get()->GetMainBook()->GetAllTabs(tabs);
+            for (const auto& tab : tabs) {
+                if (tab.isFile) {
+                    files.Add(tab.filename.GetFullPath());
                 }
             }
         } else if (wxFileName::DirExists(searchWhere.Item(i))) {
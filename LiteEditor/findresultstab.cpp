@@ -56,7 +56,7 @@ BEGIN_EVENT_TABLE(FindResultsTab, OutputTabWindow)
 EVT_UPDATE_UI(XRCID("hold_pane_open"), FindResultsTab::OnHoldOpenUpdateUI)
 END_EVENT_TABLE()
 
-FindResultsTab::FindResultsTab(wxWindow* parent, wxWindowID id, const wxString& name)
+FindResultsTab::FindResultsTab(wxWindow* parent, wxWindowID id, const wxString& name, bool virtualView)
     : OutputTabWindow(parent, id, name)
     , m_searchInProgress(false)
 {
@@ -77,6 +77,19 @@ FindResultsTab::FindResultsTab(wxWindow* parent, wxWindowID id, const wxString&
     Connect(XRCID("stop_search"), wxEVT_UPDATE_UI, wxUpdateUIEventHandler(FindResultsTab::OnStopSearchUI), NULL, this);
     m_tb->Realize();
 
+    if(virtualView) {
+        // replace the editor with a virtual list, the search header and summary are shown above it
+        m_model = std::make_shared<clSearchResultsModel>();
+        m_header = new wxStaticText(this, wxID_ANY, wxEmptyString);
+        m_list = new FindResultsList(this);
+        m_list->SetModel(m_model);
+        m_list->Bind(wxEVT_LISTBOX_DCLICK, &FindResultsTab::OnListDClick, this);
+        m_sci->Hide();
+        m_vSizer->Replace(m_sci, m_list);
+        m_vSizer->Insert(1, m_header, 0, wxEXPAND | wxALL, 5);
+        m_vSizer->Layout();
+    }
+
     EventNotifier::Get()->Connect(wxEVT_CL_THEME_CHANGED, wxCommandEventHandler(FindResultsTab::OnThemeChanged), NULL,
                                   this);
 
@@ -113,6 +126,18 @@ void FindResultsTab::Clear()
     m_searchTitle.clear();
     OutputTabWindow::Clear();
     m_styler->Reset();
+
+    if(IsVirtualView()) {
+        // the previous model may still be referenced by the history
+        m_model = std::make_shared<clSearchResultsModel>();
+        m_list->SetModel(m_model);
+        m_header->SetLabelText(wxEmptyString);
+    }
+}
+
+bool FindResultsTab::HasOutput() const
+{
+    return IsVirtualView() ? !m_header->GetLabelText().IsEmpty() : m_sci->GetLength() > 0;
 }
 
 void FindResultsTab::OnFindInFiles(wxCommandEvent& e)
@@ -141,8 +166,13 @@ void FindResultsTab::OnSearchStart(wxCommandEvent& e)
                 << (data->IsMatchCase() ? _("true") : _("false")) << _(" ; Match whole word: ")
                 << (data->IsMatchWholeWord() ? _("true") : _("false")) << _(" ; Regular expression: ")
                 << (data->IsRegularExpression() ? _("true") : _("false")) << wxT(" ======\n");
-        AppendLine(message);
-        ScrollToBottom();
+        if(IsVirtualView()) {
+            m_header->SetLabelText(message.Trim());
+            Layout();
+        } else {
+            AppendLine(message);
+            ScrollToBottom();
+        }
     }
     wxDELETE(data);
 
@@ -161,6 +191,13 @@ void FindResultsTab::OnSearchMatch(wxCommandEvent& e)
         return;
     }
 
+    if(IsVirtualView()) {
+        m_model->Append(*res);
+        m_list->UpdateRows(m_outputScrolls);
+        wxDELETE(res);
+        return;
+    }
+
     wxWindowUpdateLocker locker{ m_sci };
     m_indicators.reserve(m_indicators.size() + res->size());
 
@@ -194,14 +231,32 @@ void FindResultsTab::OnSearchEnded(wxCommandEvent& e)
     if(!summary)
         return;
 
-    // did the page closed before the search ended?
-    AppendLine(summary->GetMessage() + wxT("\n"));
+    bool scrollToTop =
+        m_tb->FindById(XRCID("scroll_on_output")) && m_tb->FindById(XRCID("scroll_on_output"))->IsToggled();
+    bool autoFold = !EditorConfigST::Get()->GetOptions()->GetDontAutoFoldResults();
+
+    if(IsVirtualView()) {
+        m_header->SetLabelText(m_header->GetLabelText() + wxT("\n") + summary->GetMessage().Trim());
+        Layout();
+        if(autoFold && m_model->GetFileCount() > 0) {
+            // Keep only the first file's matches expanded
+            m_model->SetAllExpanded(false);
+            m_model->SetExpanded(0, true);
+            m_list->UpdateRows();
+        }
+        if(scrollToTop) {
+            m_list->ScrollToRow(0);
+        }
 
-    if(m_tb->FindById(XRCID("scroll_on_output")) && m_tb->FindById(XRCID("scroll_on_output"))->IsToggled()) {
-        m_sci->GotoLine(0);
+    } else {
+        // did the page closed before the search ended?
+        AppendLine(summary->GetMessage() + wxT("\n"));
+        if(scrollToTop) {
+            m_sci->GotoLine(0);
+        }
     }
 
-    if(!EditorConfigST::Get()->GetOptions()->GetDontAutoFoldResults()) {
+    if(autoFold && !IsVirtualView()) {
         OutputTabWindow::OnCollapseAll(e);
         // Uncollapse the first file's matches
         int maxLine = m_sci->GetLineCount();
@@ -229,7 +284,15 @@ void FindResultsTab::OnSearchEnded(wxCommandEvent& e)
     }
 }
 
-void FindResultsTab::OnSearchCancel(wxCommandEvent& e) { AppendLine(_("====== Search cancelled by user ======\n")); }
+void FindResultsTab::OnSearchCancel(wxCommandEvent& e)
+{
+    if(IsVirtualView()) {
+        m_header->SetLabelText(m_header->GetLabelText() + wxT("\n") + _("====== Search cancelled by user ======"));
+        Layout();
+        return;
+    }
+    AppendLine(_("====== Search cancelled by user ======\n"));
+}
 
 void FindResultsTab::OnClearAll(wxCommandEvent& e)
 {
@@ -238,7 +301,7 @@ void FindResultsTab::OnClearAll(wxCommandEvent& e)
     Clear();
 }
 
-void FindResultsTab::OnClearAllUI(wxUpdateUIEvent& e) { e.Enable(!m_searchInProgress && !m_sci->IsEmpty()); }
+void FindResultsTab::OnClearAllUI(wxUpdateUIEvent& e) { e.Enable(!m_searchInProgress && HasOutput()); }
 
 void FindResultsTab::OnRepeatOutput(wxCommandEvent& e)
 {
@@ -248,7 +311,7 @@ void FindResultsTab::OnRepeatOutput(wxCommandEvent& e)
     SearchThreadST::Get()->PerformSearch(*searchData);
 }
 
-void FindResultsTab::OnRepeatOutputUI(wxUpdateUIEvent& e) { e.Enable(m_sci->GetLength() > 0); }
+void FindResultsTab::OnRepeatOutputUI(wxUpdateUIEvent& e) { e.Enable(HasOutput()); }
 
 void FindResultsTab::OnMouseDClick(wxStyledTextEvent& e)
 {
@@ -268,10 +331,117 @@ void FindResultsTab::OnMouseDClick(wxStyledTextEvent& e)
     }
 }
 
+void FindResultsTab::OnListDClick(wxCommandEvent& e)
+{
+    auto row = m_model->GetRow(e.GetInt());
+    if(row.file == clSearchResultsModel::npos) {
+        return;
+    }
+
+    if(row.IsFile()) {
+        m_list->ToggleFile(row.file);
+    } else {
+        DoOpenMatch(row.match);
+    }
+}
+
+void FindResultsTab::DoOpenMatch(size_t index)
+{
+    m_list->SelectMatch(index);
+    DoOpenSearchResult(m_model->GetMatch(index), nullptr, wxNOT_FOUND);
+}
+
+void FindResultsTab::OnCollapseAll(wxCommandEvent& e)
+{
+    if(!IsVirtualView()) {
+        OutputTabWindow::OnCollapseAll(e);
+        return;
+    }
+
+    // fold all the files, or unfold them if they are all folded already
+    bool hasExpanded = false;
+    for(size_t i = 0; i < m_model->GetFileCount() && !hasExpanded; ++i) {
+        hasExpanded = m_model->IsExpanded(i);
+    }
+    m_list->SetAllExpanded(!hasExpanded);
+}
+
+void FindResultsTab::OnCollapseAllUI(wxUpdateUIEvent& e)
+{
+    if(!IsVirtualView()) {
+        OutputTabWindow::OnCollapseAllUI(e);
+        return;
+    }
+    e.Enable(m_model->GetFileCount() > 0);
+}
+
+bool FindResultsTab::IsFocused()
+{
+    if(!IsVirtualView()) {
+        return OutputTabWindow::IsFocused();
+    }
+    wxWindow* win = wxWindow::FindFocus();
+    return (win && win == m_list);
+}
+
+void FindResultsTab::OnEditUI(wxUpdateUIEvent& e)
+{
+    if(!IsVirtualView()) {
+        OutputTabWindow::OnEditUI(e);
+        return;
+    }
+
+    if(!IsFocused()) {
+        return;
+    }
+
+    switch(e.GetId()) {
+    case wxID_COPY:
+        e.Enable(m_list->GetSelection() != wxNOT_FOUND);
+        break;
+    case wxID_SELECTALL:
+        e.Enable(false);
+        break;
+    default:
+        break;
+    }
+}
+
+void FindResultsTab::OnEdit(wxCommandEvent& e)
+{
+    if(!IsVirtualView()) {
+        OutputTabWindow::OnEdit(e);
+        return;
+    }
+
+    if(!IsFocused() || e.GetId() != wxID_COPY) {
+        e.Skip();
+        return;
+    }
+    ::CopyToClipboard(m_list->GetSelectedText());
+}
+
 SearchData* FindResultsTab::GetSearchData() { return &m_searchData; }
 
 void FindResultsTab::NextMatch()
 {
+    if(IsVirtualView()) {
+        // the match after the selected one, or the first match of the selected file
+        size_t next = 0;
+        int sel = m_list->GetSelection();
+        if(sel != wxNOT_FOUND) {
+            auto row = m_model->GetRow(sel);
+            next = row.IsFile() ? m_model->GetFileFirstMatch(row.file) : row.match + 1;
+        }
+
+        if(next < m_model->GetMatchCount()) {
+            DoOpenMatch(next);
+        } else {
+            clMainFrame::Get()->GetStatusBar()->SetMessage(_("Reached the end of the 'Find In Files' results"));
+        }
+        return;
+    }
+
     // locate the last match
     int firstLine = m_sci->MarkerNext(0, 255);
     if(firstLine == wxNOT_FOUND) {
@@ -298,6 +468,22 @@ void FindResultsTab::NextMatch()
 
 void FindResultsTab::PrevMatch()
 {
+    if(IsVirtualView()) {
+        size_t current = m_model->GetMatchCount();
+        int sel = m_list->GetSelection();
+        if(sel != wxNOT_FOUND) {
+            auto row = m_model->GetRow(sel);
+            current = row.IsFile() ? m_model->GetFileFirstMatch(row.file) : row.match;
+        }
+
+        if(current > 0) {
+            DoOpenMatch(current - 1);
+        } else {
+            clMainFrame::Get()->GetStatusBar()->SetMessage(_("Reached the start of the 'Find In Files' results"));
+        }
+        return;
+    }
+
     // locate the last match
     int firstLine = m_sci->MarkerPrevious(m_sci->GetLineCount() - 1, 255);
     if(firstLine == wxNOT_FOUND) {
@@ -439,6 +625,9 @@ void FindResultsTab::OnThemeChanged(wxCommandEvent& e)
 {
     e.Skip();
     SetStyles(m_sci);
+    if(m_list) {
+        m_list->ApplyTheme();
+    }
 }
 
 void FindResultsTab::OnRecentSearches(wxCommandEvent& e)
@@ -476,10 +665,11 @@ void FindResultsTab::OnRecentSearches(wxCommandEvent& e)
 void FindResultsTab::SaveSearchData()
 {
     History entry;
-    entry.text = m_sci->GetText();
+    entry.text = IsVirtualView() ? m_header->GetLabelText() : m_sci->GetText();
     entry.searchData = m_searchData;
     entry.title = m_searchTitle;
     entry.matchInfo = m_matchInfo;
+    entry.model = m_model;
 
     // Save the indicators as well
     entry.indicators = m_indicators;
@@ -496,6 +686,15 @@ void FindResultsTab::LoadSearch(const History& h)
     m_searchData = h.searchData;
     m_matchInfo = h.matchInfo;
     m_searchTitle = h.title;
+
+    if(IsVirtualView()) {
+        m_model = h.model;
+        m_list->SetModel(m_model);
+        m_header->SetLabelText(h.text);
+        Layout();
+        return;
+    }
+
     m_sci->SetEditable(true);
     m_sci->ClearAll();
     m_sci->SetText(h.text);
@@ -25,7 +25,9 @@
 #ifndef __findresultstab__
 #define __findresultstab__
 
+#include "FindResultsList.hpp"
 #include "Notebook.h"
+#include "clSearchResultsModel.hpp"
 #include "clWorkspaceEvent.hpp"
 #include "findinfilesdlg.h"
 #include "outputtabwindow.h"
@@ -33,10 +35,12 @@
 #include "wx_ordered_map.h"
 
 #include <map>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 #include <wx/aui/auibar.h>
 #include <wx/debug.h>
+#include <wx/stattext.h>
 #include <wx/stc/stc.h>
 
 // Map between the line numbers and a search results
@@ -57,6 +61,7 @@ protected:
         wxString text;
         MatchInfo_t matchInfo;
         std::vector<int> indicators;
+        std::shared_ptr<clSearchResultsModel> model;
         using Map_t = wxOrderedMap<wxString, History>;
     };
 
@@ -64,6 +69,16 @@ protected:
 
 protected:
     MatchInfo_t m_matchInfo;
+
+    // the virtual view: the matches are kept in a compact model and only the visible rows are drawn
+    std::shared_ptr<clSearchResultsModel> m_model;
+    FindResultsList* m_list = nullptr;
+    wxStaticText* m_header = nullptr;
+
+    bool IsVirtualView() const { return m_list != nullptr; }
+    bool HasOutput() const;
+    void DoOpenMatch(size_t index);
+
     void UnbindSearchEvents(wxEvtHandler* binder);
     void BindSearchEvents(wxEvtHandler* binder);
 
@@ -84,6 +99,12 @@ protected:
     virtual void OnRecentSearchesUI(wxUpdateUIEvent& e);
     virtual void OnRepeatOutputUI(wxUpdateUIEvent& e);
     virtual void OnMouseDClick(wxStyledTextEvent& e);
+    virtual void OnListDClick(wxCommandEvent& e);
+    virtual void OnCollapseAll(wxCommandEvent& e);
+    virtual void OnCollapseAllUI(wxUpdateUIEvent& e);
+    virtual void OnEdit(wxCommandEvent& e);
+    virtual void OnEditUI(wxUpdateUIEvent& e);
+    virtual bool IsFocused();
 
     virtual void OnStopSearch(wxCommandEvent& e);
     virtual void OnStopSearchUI(wxUpdateUIEvent& e);
@@ -96,7 +117,11 @@ protected:
     DECLARE_EVENT_TABLE()
 
 public:
-    FindResultsTab(wxWindow* parent, wxWindowID id, const wxString& name);
+    /**
+     * @param virtualView show the results in a virtual list instead of an editor. The editor is needed by views
+     * that mark the matches in its margin
+     */
+    FindResultsTab(wxWindow* parent, wxWindowID id, const wxString& name, bool virtualView = true);
     ~FindResultsTab();
 
     virtual void SetStyles(wxStyledTextCtrl* sci);
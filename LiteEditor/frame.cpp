@@ -2280,10 +2280,10 @@ void clMainFrame::OnFileSaveTabGroup(wxCommandEvent& WXUNUSED(event))
 
     SaveTabGroupDlg dlg(this, previousgroups);
 
+    // same order as the tabs saved by SaveSession()
     wxArrayString filepaths;
-    const auto editors = GetMainBook()->GetAllEditors();
-    for (size_t i = 0; i < editors.size(); ++i) {
-        filepaths.Add(editors[i]->GetFileName().GetFullPath());
+    for (const auto& tab : GetMainBook()->GetSessionTabs()) {
+        filepaths.Add(tab.GetFileName());
     }
     dlg.SetListTabs(filepaths);
 
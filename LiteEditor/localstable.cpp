@@ -144,23 +144,7 @@ void LocalsTable::OnListChildren(const DebuggerEventData& event)
                     m_listChildItemId[ch.gdbId] = item;
 
                 } else {
-
-                    DbgTreeItemData* data = new DbgTreeItemData();
-                    data->_gdbId = ch.gdbId;
-                    data->_isFake = ch.isAFake;
-
-                    wxTreeItemId child = m_listTable->AppendItem(item, ch.varName, -1, -1, data);
-                    m_listTable->SetItemText(child, ch.type, 2);
-
-                    // Add a dummy node
-                    if (child.IsOk() && ch.numChild > 0) {
-                        m_listTable->AppendItem(child, wxT("<dummy>"));
-                    }
-
-                    // refresh this item only
-                    dbgr->EvaluateVariableObject(data->_gdbId, m_DBG_USERR);
-                    // ask the value for this node
-                    m_gdbIdToTreeId[data->_gdbId] = child;
+                    DoAppendVariableObjectChild(item, ch);
                 }
             }
         }
@@ -186,7 +170,7 @@ void LocalsTable::OnVariableObjUpdate(const DebuggerEventData& event)
     IDebugger* dbgr = DoGetDebugger();
     if (dbgr) {
         wxArrayString itemsToRefresh = event.m_varObjUpdateInfo.refreshIds;
-        DoRefreshItemRecursively(dbgr, m_listTable->GetRootItem(), itemsToRefresh);
+        DoRefreshItemRecursively(dbgr, m_listTable->GetRootItem(), itemsToRefresh, event.m_varObjUpdateInfo.values);
     }
 }
 
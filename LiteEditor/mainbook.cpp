@@ -29,6 +29,7 @@
 #include "LSP/LSPManager.hpp"
 #include "WelcomePage.h"
 #include "aui/clAuiFlatTabArt.hpp"
+#include "clEditorPlaceholder.hpp"
 #include "clFileSystemWatcher.h"
 #include "clIdleEventThrottler.hpp"
 #include "clImageViewer.h"
@@ -135,6 +136,30 @@ wxString create_platform_filepath(const wxString& fullpath)
 #endif
 }
 
+/// restore the view of a session tab, once its editor is visible on screen
+std::function<void(IEditor*)> create_restore_tab_callback(const TabInfo& ti, bool is_selected)
+{
+    int first_visible_line = ti.GetFirstVisibleLine();
+    int current_line = ti.GetCurrentLine();
+    const wxArrayString& bookmarks = ti.GetBookmarks();
+    const std::vector<int>& folds = ti.GetCollapsedFolds();
+    return [first_visible_line, current_line, is_selected, bookmarks, folds](IEditor* editor) {
+        auto ctrl = editor->GetCtrl();
+        ctrl->SetFirstVisibleLine(first_visible_line);
+        editor->SetCaretAt(ctrl->PositionFromLine(current_line));
+
+        clEditor* cl_editor = dynamic_cast<clEditor*>(ctrl);
+        if (cl_editor) {
+            cl_editor->LoadMarkersFromArray(bookmarks);
+            cl_editor->LoadCollapsedFoldsFromArray(folds);
+        }
+
+        if (is_selected) {
+            editor->SetActive();
+        }
+    };
+}
+
 int FrameTimerId = wxNewId();
 // return the wxBORDER_SIMPLE that matches the current application theme
 wxBorder get_border_simple_theme_aware_bit()
@@ -297,6 +322,10 @@ void MainBook::OnPageClosing(wxBookCtrlEvent& e)
             e.Veto();
         }
 
+    } else if (auto placeholder = dynamic_cast<clEditorPlaceholder*>(m_book->GetPage(e.GetSelection()))) {
+        // a session tab that was never loaded: nothing to save
+        m_lazyTabs.Remove(placeholder->GetFileName().GetFullPath());
+
     } else {
 
         // Unknown type, ask the plugins - maybe they know about this type
@@ -430,41 +459,28 @@ void MainBook::DoRestoreSession(const SessionEntry& session)
     clAuiBookEventsDisabler events_disabler{m_book};
 #endif
 
+    // only the selected tab is loaded now, the others are loaded the first time they are needed
     size_t sel = session.GetSelectedTab();
     clEditor* active_editor = nullptr;
-    const auto& vTabInfoArr = session.GetTabInfoArr();
-    for (size_t i = 0; i < vTabInfoArr.size(); i++) {
-        const TabInfo& ti = vTabInfoArr[i];
-        int first_visible_line = ti.GetFirstVisibleLine();
-        int current_line = ti.GetCurrentLine();
-        const wxArrayString& bookmarks = ti.GetBookmarks();
-        const std::vector<int>& folds = ti.GetCollapsedFolds();
-
-        bool is_selected = sel == i;
-        m_reloadingDoRaise = (i == vTabInfoArr.size() - 1); // Raise() when opening only the last editor
-
-        /// prepare a callback to be executed once the file is visible on screen
-        auto cb = [first_visible_line, current_line, is_selected, bookmarks, folds](IEditor* editor) {
-            auto ctrl = editor->GetCtrl();
-            ctrl->SetFirstVisibleLine(first_visible_line);
-            editor->SetCaretAt(ctrl->PositionFromLine(current_line));
-
-            clEditor* cl_editor = dynamic_cast<clEditor*>(ctrl);
-            if (cl_editor) {
-                cl_editor->LoadMarkersFromArray(bookmarks);
-                cl_editor->LoadCollapsedFoldsFromArray(folds);
-            }
-
-            if (is_selected) {
-                editor->SetActive();
-            }
-        };
-        auto editor = OpenFileAsync(ti.GetFileName(), std::move(cb));
-        if (sel == i) {
-            active_editor = editor;
+    m_lazyTabs.Restore(session.GetTabInfoArr(), sel, [this, &active_editor](const TabInfo& ti, bool pending) {
+        if (pending) {
+            wxFileName fn(ti.GetFileName());
+            AddBookPage(new clEditorPlaceholder(m_book, fn),
+                        CreateLabel(fn, false),
+                        fn.GetFullPath(),
+                        wxNOT_FOUND,
+                        false,
+                        wxNOT_FOUND);
+        } else {
+            active_editor = OpenFileAsync(ti.GetFileName(), create_restore_tab_callback(ti, true));
         }
+    });
+
+    if (active_editor) {
+        SelectPage(active_editor);
+    } else {
+        SelectPage(GetCurrentPage());
     }
-    SelectPage(active_editor);
 
 #if MAINBOOK_AUIBOOK
     // now that all the pages have been loaded into the book, ensure that our Ctrl-TAB window
@@ -512,6 +528,9 @@ void MainBook::GetAllTabs(clTab::Vec_t& tabs)
             t.isFile = true;
             t.isModified = editor->GetModify();
             t.filename = editor->GetFileName();
+        } else if (auto placeholder = dynamic_cast<clEditorPlaceholder*>(t.window)) {
+            t.isFile = true;
+            t.filename = placeholder->GetFileName();
         }
         tabs.push_back(t);
     }
@@ -587,9 +606,93 @@ clEditor* MainBook::FindEditor(const wxString& fileName)
     if (index != wxNOT_FOUND) {
         return dynamic_cast<clEditor*>(m_book->GetPage(index));
     }
+
+    // a session tab that was not loaded yet
+    auto placeholder = FindPlaceholder(fileName);
+    if (placeholder) {
+        return DoLoadPlaceholder(placeholder);
+    }
     return nullptr;
 }
 
+bool MainBook::CloseEditor(const wxString& fileName)
+{
+    // no need to load a tab in order to close it
+    auto placeholder = FindPlaceholder(fileName);
+    if (placeholder) {
+        return ClosePage(placeholder);
+    }
+    return ClosePage(FindEditor(fileName));
+}
+
+clEditorPlaceholder* MainBook::FindPlaceholder(const wxString& fullpath)
+{
+    if (m_lazyTabs.GetPendingCount() == 0) {
+        return nullptr;
+    }
+
+    const TabInfo* tab = m_lazyTabs.Find(fullpath);
+    if (!tab) {
+        tab = m_lazyTabs.Find(FileUtils::RealPath(fullpath, true));
+    }
+    if (!tab) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < m_book->GetPageCount(); ++i) {
+        auto placeholder = dynamic_cast<clEditorPlaceholder*>(m_book->GetPage(i));
+        if (placeholder && m_lazyTabs.Find(placeholder->GetFileName().GetFullPath()) == tab) {
+            return placeholder;
+        }
+    }
+    return nullptr;
+}
+
+clEditor* MainBook::DoLoadPlaceholder(clEditorPlaceholder* placeholder)
+{
+    int index = m_book->GetPageIndex(placeholder);
+    if (index == wxNOT_FOUND) {
+        return nullptr;
+    }
+
+    wxString filePath = placeholder->GetFileName().GetFullPath();
+    TabInfo ti;
+    if (!m_lazyTabs.Take(filePath, ti)) {
+        ti.SetFileName(filePath);
+    }
+    bool selected = m_book->GetSelection() == index;
+
+#if MAINBOOK_AUIBOOK
+    clAuiBookEventsDisabler events_disabler{m_book};
+#endif
+
+    clEditor* editor = nullptr;
+    if (wxFileName::FileExists(filePath)) {
+        // See OpenFile()
+        wxString projName = ManagerST::Get()->GetProjectNameByFile(filePath);
+        wxFileName fileName(filePath);
+
+        editor = new clEditor(m_book);
+        editor->Create(projName, fileName);
+        AddBookPage(editor, CreateLabel(fileName, false), fileName.GetFullPath(), wxNOT_FOUND, false, index);
+        editor->SetSyntaxHighlight();
+        ManagerST::Get()->GetBreakpointsMgr()->RefreshBreakpointsForEditor(editor);
+        MarkEditorReadOnly(editor);
+        push_callback(create_restore_tab_callback(ti, false), FileUtils::RealPath(fileName.GetFullPath(), true));
+
+        if (selected) {
+            m_book->ChangeSelection(index);
+        }
+    } else {
+        clWARNING() << "Session tab:" << filePath << "no longer exists" << clEndl;
+    }
+
+    // the editor took the place of the placeholder: remove it without notifications
+    m_book->RemovePage(m_book->GetPageIndex(placeholder), false);
+    placeholder->Destroy();
+    return editor;
+}
+
 wxWindow* MainBook::FindPage(const wxString& text)
 {
     for (size_t i = 0; i < m_book->GetPageCount(); i++) {
@@ -878,6 +981,15 @@ bool MainBook::SelectPage(wxWindow* win)
         return false;
     }
 
+    auto placeholder = dynamic_cast<clEditorPlaceholder*>(win);
+    if (placeholder) {
+        win = DoLoadPlaceholder(placeholder);
+        if (win == nullptr) {
+            // the file is gone, select whatever took its place
+            return SelectPage(GetCurrentPage());
+        }
+    }
+
     int index = m_book->GetPageIndex(win);
     if (index != wxNOT_FOUND && m_book->GetSelection() != index) {
 #if !CL_USE_NATIVEBOOK
@@ -1090,6 +1202,18 @@ bool MainBook::CloseAllButThis(wxWindow* page)
         }
         ClosePage(editor, true);
     }
+
+    // and the session tabs that were not loaded yet
+    std::vector<wxWindow*> placeholders;
+    for (size_t i = 0; i < m_book->GetPageCount(); ++i) {
+        wxWindow* win = m_book->GetPage(i);
+        if (win != page && dynamic_cast<clEditorPlaceholder*>(win)) {
+            placeholders.push_back(win);
+        }
+    }
+    for (wxWindow* win : placeholders) {
+        ClosePage(win);
+    }
     return true;
 }
 
@@ -1137,6 +1261,7 @@ bool MainBook::CloseAll(bool cancellable)
     m_reloadingDoRaise = false;
     m_book->DeleteAllPages();
     m_reloadingDoRaise = true;
+    m_lazyTabs.Clear();
 
     // Since we got no more editors opened,
     // send a wxEVT_ALL_EDITORS_CLOSED event
@@ -1582,53 +1707,79 @@ FilesModifiedDlg* MainBook::GetFilesModifiedDlg()
 
 void MainBook::CreateSession(SessionEntry& session, wxArrayInt* excludeArr)
 {
-    std::vector<clEditor*> editors = GetAllEditors();
-
-    // Remove editors which belong to the SFTP
-    std::vector<clEditor*> editorsTmp;
-    for (clEditor* editor : editors) {
-        IEditor* ieditor = dynamic_cast<IEditor*>(editor);
-        if (ieditor->GetClientData("sftp") == NULL) {
-            editorsTmp.push_back(editor);
-        }
-    }
-
-    editors.swap(editorsTmp);
+    int selected = wxNOT_FOUND;
+    std::vector<TabInfo> tabs = GetSessionTabs(&selected);
 
     session.SetSelectedTab(0);
     std::vector<TabInfo> vTabInfoArr;
-    for (size_t i = 0; i < editors.size(); i++) {
+    for (size_t i = 0; i < tabs.size(); i++) {
 
         if (excludeArr && (excludeArr->GetCount() > i) && (!excludeArr->Item(i))) {
             // If we're saving only selected editors, and this isn't one of them...
             continue;
         }
 
-        if (editors[i] == GetActiveEditor()) {
+        if ((int)i == selected) {
             session.SetSelectedTab(vTabInfoArr.size());
         }
+        vTabInfoArr.push_back(std::move(tabs[i]));
+    }
+    session.SetTabInfoArr(vTabInfoArr);
+
+    // Set the "Find In Files" file mask for this workspace
+    FindReplaceData frd;
+    frd.SetName("FindInFilesData");
+    clConfig::Get().ReadItem(frd);
+    session.SetFindInFilesMask(frd.GetSelectedMask());
+}
+
+std::vector<TabInfo> MainBook::GetSessionTabs(int* selected)
+{
+    if (selected) {
+        *selected = wxNOT_FOUND;
+    }
+
+    clEditor* active_editor = GetActiveEditor();
+    std::vector<TabInfo> tabs;
+    tabs.reserve(m_book->GetPageCount());
+    for (size_t i = 0; i < m_book->GetPageCount(); ++i) {
+        wxWindow* page = m_book->GetPage(i);
+
+        // a tab that was not loaded yet keeps the state it was restored with
+        auto placeholder = dynamic_cast<clEditorPlaceholder*>(page);
+        if (placeholder) {
+            const TabInfo* tab = m_lazyTabs.Find(placeholder->GetFileName().GetFullPath());
+            if (tab) {
+                tabs.push_back(*tab);
+            }
+            continue;
+        }
+
+        // Skip the editors which belong to the SFTP
+        clEditor* editor = dynamic_cast<clEditor*>(page);
+        if (!editor || static_cast<IEditor*>(editor)->GetClientData("sftp") != nullptr) {
+            continue;
+        }
+
+        if (selected && editor == active_editor) {
+            *selected = (int)tabs.size();
+        }
         TabInfo oTabInfo;
-        oTabInfo.SetFileName(editors[i]->GetFileName().GetFullPath());
-        oTabInfo.SetFirstVisibleLine(editors[i]->GetFirstVisibleLine());
-        oTabInfo.SetCurrentLine(editors[i]->GetCurrentLine());
+        oTabInfo.SetFileName(editor->GetFileName().GetFullPath());
+        oTabInfo.SetFirstVisibleLine(editor->GetFirstVisibleLine());
+        oTabInfo.SetCurrentLine(editor->GetCurrentLine());
 
         wxArrayString astrBookmarks;
-        editors[i]->StoreMarkersToArray(astrBookmarks);
+        editor->StoreMarkersToArray(astrBookmarks);
         oTabInfo.SetBookmarks(astrBookmarks);
 
         std::vector<int> folds;
-        editors[i]->StoreCollapsedFoldsToArray(folds);
+        editor->StoreCollapsedFoldsToArray(folds);
         oTabInfo.SetCollapsedFolds(folds);
 
-        vTabInfoArr.push_back(oTabInfo);
+        tabs.push_back(std::move(oTabInfo));
     }
-    session.SetTabInfoArr(vTabInfoArr);
-
-    // Set the "Find In Files" file mask for this workspace
-    FindReplaceData frd;
-    frd.SetName("FindInFilesData");
-    clConfig::Get().ReadItem(frd);
-    session.SetFindInFilesMask(frd.GetSelectedMask());
+    return tabs;
 }
 
 void MainBook::ShowTabBar(bool b) { wxUnusedVar(b); }
@@ -30,6 +30,7 @@
 #include "Notebook.h"
 #include "clAuiBook.hpp"
 #include "clEditorBar.h"
+#include "clLazyTabs.hpp"
 #include "cl_command_event.h"
 #include "cl_editor.h"
 #include "filehistory.h"
@@ -45,6 +46,7 @@
 #endif
 
 class FilesModifiedDlg;
+class clEditorPlaceholder;
 
 class IEditor;
 class MessagePane;
@@ -101,6 +103,12 @@ public:
      * @brief create session from current IDE state
      */
     void CreateSession(SessionEntry& session, wxArrayInt* excludeArr = NULL);
+    /**
+     * @brief the tabs saved by CreateSession(), in the notebook order. This includes the tabs of the restored session
+     * that were not loaded yet
+     * @param selected [output] the index of the active tab, or wxNOT_FOUND
+     */
+    std::vector<TabInfo> GetSessionTabs(int* selected = nullptr);
 
     clEditor* GetActiveEditor();
     /**
@@ -114,7 +122,7 @@ public:
     void GetAllTabs(clTab::Vec_t& tabs);
 
     clEditor* FindEditor(const wxString& fileName);
-    bool CloseEditor(const wxString& fileName) { return ClosePage(FindEditor(fileName)); }
+    bool CloseEditor(const wxString& fileName);
 
     wxWindow* GetCurrentPage();
     int GetCurrentPageIndex();
@@ -316,6 +324,11 @@ private:
 
     int FindEditorIndexByFullPath(const wxString& fullpath);
     void DoRestoreSession(const SessionEntry& entry);
+    clEditorPlaceholder* FindPlaceholder(const wxString& fullpath);
+    /**
+     * @brief replace a tab that was not loaded yet with its editor
+     */
+    clEditor* DoLoadPlaceholder(clEditorPlaceholder* placeholder);
 
 #if wxHAS_MINIMAP
     /**
@@ -472,6 +485,7 @@ private:
     WelcomePage* m_welcomePage{nullptr};
     FindAndReplaceDialog* m_findBar{nullptr};
     std::unordered_map<wxString, CallbackVec_t> m_callbacksTable;
+    clLazyTabs m_lazyTabs;
     bool m_initDone{false};
 
 #if wxHAS_MINIMAP
@@ -2173,6 +2173,12 @@ void Manager::DbgDoSimpleCommand(int cmd)
 
     IDebugger* dbgr = DebuggerMgr::Get().GetActiveDebugger();
     if (dbgr && dbgr->IsRunning()) {
+        if (cmd == DBG_NEXT || cmd == DBG_STEPIN || cmd == DBG_STEPI || cmd == DBG_STEPOUT || cmd == DBG_NEXTI) {
+            m_dbgStepStopWatch.Start();
+            m_dbgStepPending = true;
+            m_dbgStepLocalsPending = false;
+        }
+
         switch (cmd) {
         case DBG_PAUSE:
             GetBreakpointsMgr()->SetExpectingControl(true);
@@ -2807,6 +2813,13 @@ void Manager::DebuggerUpdate(const DebuggerEventData& event)
     case DBG_UR_GOT_CONTROL:
         // keep the current function name
         m_dbgCurrentFrameInfo.func = event.m_frameInfo.function;
+        if (m_dbgStepPending) {
+            m_dbgStepStoppedMs = m_dbgStepStopWatch.Time();
+            clGetManager()->SetStatusMessage(wxString::Format(_("Step: %ldms"), m_dbgStepStoppedMs), 5);
+        }
+        // the locals are reported only if we got here by stepping
+        m_dbgStepLocalsPending = m_dbgStepPending;
+        m_dbgStepPending = false;
         UpdateGotControl(event);
         break;
 
@@ -2843,6 +2856,11 @@ void Manager::DebuggerUpdate(const DebuggerEventData& event)
 
     case DBG_UR_LOCALS:
         clMainFrame::Get()->GetDebuggerPane()->GetLocalsTable()->UpdateLocals(event.m_locals);
+        if (m_dbgStepLocalsPending) {
+            m_dbgStepLocalsPending = false;
+            clGetManager()->SetStatusMessage(
+                wxString::Format(_("Step: %ldms, locals: %ldms"), m_dbgStepStoppedMs, m_dbgStepStopWatch.Time()), 5);
+        }
 #ifdef __WXMAC__
         {
             for (size_t i = 0; i < event.m_locals.size(); i++) {
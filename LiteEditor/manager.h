@@ -41,6 +41,7 @@
 #include <list>
 #include <map>
 #include <wx/event.h>
+#include <wx/stopwatch.h>
 
 class clEditor;
 class IProcess;
@@ -96,6 +97,11 @@ protected:
     wxArrayString m_dbgWatchExpressions;
     DisplayVariableDlg* m_watchDlg;
     DbgStackInfo m_dbgCurrentFrameInfo;
+    // per step latency, reported in the status bar: step command -> got control -> locals updated
+    wxStopWatch m_dbgStepStopWatch;
+    bool m_dbgStepPending = false;
+    bool m_dbgStepLocalsPending = false;
+    long m_dbgStepStoppedMs = 0;
     PerspectiveManager m_perspectiveManager;
     clDebuggerTerminalPOSIX m_debuggerTerminal;
 
@@ -157,16 +157,21 @@ void DisplayVariableDlg::DoAddChildren(wxTreeItemId& item, const VariableObjChil
         // Don't use ch.isAFake here since it will also returns true of inheritance
         if(ch.varName != "public" && ch.varName != "private" && ch.varName != "protected") {
             // Real node
-            wxTreeItemId child = m_treeCtrl->AppendItem(item, ch.varName, -1, -1, new QWTreeData(ch));
+            wxString label = ch.varName;
+            if(!ch.value.empty()) {
+                label << wxT(" = ") << ch.value;
+            }
+            wxTreeItemId child = m_treeCtrl->AppendItem(item, label, -1, -1, new QWTreeData(ch));
             if (ch.numChild > 0) {
                 // add fake node to this item, so it will have the [+] on the side
                 m_treeCtrl->AppendItem(child, wxT("<dummy>"));
             }
 
-            // ask gdb for the value for this node
-
-            m_debugger->EvaluateVariableObject(ch.gdbId, DBG_USERR_QUICKWACTH);
-            m_gdbId2ItemLeaf[ch.gdbId] = child;
+            if(ch.value.empty()) {
+                // ask gdb for the value for this node
+                m_debugger->EvaluateVariableObject(ch.gdbId, DBG_USERR_QUICKWACTH);
+                m_gdbId2ItemLeaf[ch.gdbId] = child;
+            }
 
         } else {
 
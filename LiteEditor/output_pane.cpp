@@ -24,8 +24,10 @@
 //////////////////////////////////////////////////////////////////////////////
 #include "output_pane.h"
 
+#include "BlockTimer.hpp"
 #include "BuildTab.hpp"
 #include "FileManager.hpp"
+#include "PerformanceView.hpp"
 #include "clAuiBookSerialiser.hpp"
 #include "clPropertiesPage.hpp"
 #include "clStrings.h"
@@ -151,6 +153,14 @@ void OutputPane::CreateGUIControls()
     m_tabs.insert(std::make_pair(TERMINAL_TAB, Tab(TERMINAL_TAB, m_terminal)));
     mgr->AddOutputTab(TERMINAL_TAB);
 
+    if (BlockTimer::IsEnabled()) {
+        // Performance mode ("-r"): show the BlockTimer statistics
+        auto perf_view = new PerformanceView(m_book);
+        m_book->AddPage(perf_view, PERFORMANCE_TAB, false);
+        m_tabs.insert(std::make_pair(PERFORMANCE_TAB, Tab(PERFORMANCE_TAB, perf_view)));
+        mgr->AddOutputTab(PERFORMANCE_TAB);
+    }
+
     SetMinSize(wxSize(200, 100));
     mainSizer->Layout();
 }
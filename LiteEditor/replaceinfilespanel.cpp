@@ -47,7 +47,7 @@
 #include <wx/xrc/xmlres.h>
 
 ReplaceInFilesPanel::ReplaceInFilesPanel(wxWindow* parent, int id, const wxString& name)
-    : FindResultsTab(parent, id, name)
+    : FindResultsTab(parent, id, name, false)
 {
     Bind(wxEVT_UPDATE_UI, &ReplaceInFilesPanel::OnHoldOpenUpdateUI, this, XRCID("hold_pane_open"));
     wxBoxSizer* horzSizer = new wxBoxSizer(wxHORIZONTAL);
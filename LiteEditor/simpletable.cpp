@@ -419,7 +419,7 @@ void WatchesTable::OnListChildren(const DebuggerEventData& event)
                 return;
             m_listTable->Begin();
             for (size_t i = 0; i < event.m_varObjChildren.size(); i++) {
-                VariableObjChild ch = event.m_varObjChildren.at(i);
+                const VariableObjChild& ch = event.m_varObjChildren.at(i);
 
                 if (ch.varName == "public" || ch.varName == "private" || ch.varName == "protected") {
                     // not really a node...
@@ -428,21 +428,7 @@ void WatchesTable::OnListChildren(const DebuggerEventData& event)
                     m_listChildItemId[ch.gdbId] = item;
 
                 } else {
-
-                    DbgTreeItemData* data = new DbgTreeItemData();
-                    data->_gdbId = ch.gdbId;
-                    wxTreeItemId child = m_listTable->AppendItem(item, ch.varName, -1, -1, data);
-                    m_listTable->SetItemText(child, ch.type, 2);
-
-                    // Add a dummy node
-                    if (child.IsOk() && ch.numChild > 0) {
-                        m_listTable->AppendItem(child, wxT("<dummy>"));
-                    }
-
-                    // refresh this item only
-                    dbgr->EvaluateVariableObject(data->_gdbId, m_DBG_USERR);
-                    // ask the value for this node
-                    m_gdbIdToTreeId[data->_gdbId] = child;
+                    DoAppendVariableObjectChild(item, ch);
                 }
             }
             m_listTable->Commit();
@@ -548,7 +534,7 @@ void WatchesTable::OnUpdateVariableObject(const DebuggerEventData& event)
     wxArrayString itemsToRefresh = event.m_varObjUpdateInfo.refreshIds;
     IDebugger* dbgr = DoGetDebugger();
     if (dbgr) {
-        DoRefreshItemRecursively(dbgr, m_listTable->GetRootItem(), itemsToRefresh);
+        DoRefreshItemRecursively(dbgr, m_listTable->GetRootItem(), itemsToRefresh, event.m_varObjUpdateInfo.values);
     }
 }
 
@@ -54,6 +54,8 @@ DebuggerTreeListCtrlBase::DebuggerTreeListCtrlBase(wxWindow* parent, wxWindowID
         m_toolbar->Bind(wxEVT_TOOL, &DebuggerTreeListCtrlBase::OnSortItems, this, wxID_SORT_ASCENDING);
     }
     m_toolbar->Realize();
+    Bind(wxEVT_IDLE, &DebuggerTreeListCtrlBase::OnIdle, this);
+    m_listTable->Bind(wxEVT_PAINT, &DebuggerTreeListCtrlBase::OnListPaint, this);
 }
 
 IDebugger* DebuggerTreeListCtrlBase::DoGetDebugger()
@@ -96,20 +98,24 @@ void DebuggerTreeListCtrlBase::OnEvaluateVariableObj(const DebuggerEventData& ev
 
     std::map<wxString, wxTreeItemId>::iterator iter = m_gdbIdToTreeId.find(gdbId);
     if(iter != m_gdbIdToTreeId.end()) {
-        wxString newValue = value;
-        wxString curValue = m_listTable->GetItemText(iter->second, 1);
-        if(!(newValue == curValue || curValue.IsEmpty())) {
-            m_listTable->SetItemTextColour(iter->second, *wxRED, 1);
-        }
-        m_listTable->SetItemText(iter->second, value, 1);
+        DoSetItemValue(iter->second, value);
 
         // keep the red items IDs in the array
         m_gdbIdToTreeId.erase(iter);
     }
 }
 
+void DebuggerTreeListCtrlBase::DoSetItemValue(const wxTreeItemId& item, const wxString& value)
+{
+    wxString curValue = m_listTable->GetItemText(item, 1);
+    if(!(value == curValue || curValue.IsEmpty())) {
+        m_listTable->SetItemTextColour(item, *wxRED, 1);
+    }
+    m_listTable->SetItemText(item, value, 1);
+}
+
 void DebuggerTreeListCtrlBase::DoRefreshItemRecursively(IDebugger* dbgr, const wxTreeItemId& item,
-                                                        wxArrayString& itemsToRefresh)
+                                                        wxArrayString& itemsToRefresh, const wxStringMap_t& values)
 {
     if(itemsToRefresh.IsEmpty())
         return;
@@ -122,14 +128,20 @@ void DebuggerTreeListCtrlBase::DoRefreshItemRecursively(IDebugger* dbgr, const w
         if(data) {
             int where = itemsToRefresh.Index(data->_gdbId);
             if(where != wxNOT_FOUND) {
-                dbgr->EvaluateVariableObject(data->_gdbId, m_DBG_USERR);
-                m_gdbIdToTreeId[data->_gdbId] = exprItem;
+                auto iter = values.find(data->_gdbId);
+                if(iter != values.end()) {
+                    // the new value came with the update
+                    DoSetItemValue(exprItem, iter->second);
+                } else {
+                    dbgr->EvaluateVariableObject(data->_gdbId, m_DBG_USERR);
+                    m_gdbIdToTreeId[data->_gdbId] = exprItem;
+                }
                 itemsToRefresh.RemoveAt((size_t)where);
             }
         }
 
         if(m_listTable->HasChildren(exprItem)) {
-            DoRefreshItemRecursively(dbgr, exprItem, itemsToRefresh);
+            DoRefreshItemRecursively(dbgr, exprItem, itemsToRefresh, values);
         }
         exprItem = m_listTable->GetNextChild(item, cookieOne);
     }
@@ -155,9 +167,66 @@ void DebuggerTreeListCtrlBase::Clear()
     m_listChildItemId.clear();
     m_createVarItemId.clear();
     m_gdbIdToTreeId.clear();
+    m_pendingValues.clear();
     m_curStackInfo.Clear();
 }
 
+wxTreeItemId DebuggerTreeListCtrlBase::DoAppendVariableObjectChild(const wxTreeItemId& parent,
+                                                                   const VariableObjChild& child)
+{
+    DbgTreeItemData* data = new DbgTreeItemData();
+    data->_gdbId = child.gdbId;
+    data->_isFake = child.isAFake;
+
+    wxTreeItemId item = m_listTable->AppendItem(parent, child.varName, -1, -1, data);
+    m_listTable->SetItemText(item, child.type, 2);
+
+    // Add a dummy node
+    if(item.IsOk() && child.numChild > 0) {
+        m_listTable->AppendItem(item, wxT("<dummy>"));
+    }
+
+    if(child.value.IsEmpty()) {
+        m_pendingValues.insert(child.gdbId);
+    } else {
+        m_listTable->SetItemText(item, child.value, 1);
+    }
+    return item;
+}
+
+void DebuggerTreeListCtrlBase::OnListPaint(wxPaintEvent& event)
+{
+    event.Skip();
+    // scrolling, expanding or collapsing a row and adding rows all repaint the list
+    m_visibleRowsChanged = true;
+}
+
+void DebuggerTreeListCtrlBase::OnIdle(wxIdleEvent& event)
+{
+    event.Skip();
+    // the values of the rows that were never on screen stay pending: look again only when the visible rows changed
+    if(m_pendingValues.empty() || !m_visibleRowsChanged) {
+        return;
+    }
+    m_visibleRowsChanged = false;
+
+    IDebugger* dbgr = DoGetDebugger();
+    if(!dbgr) {
+        return;
+    }
+
+    // only the rows on screen are evaluated, the others are handled when scrolled into view
+    wxTreeItemId item = m_listTable->GetFirstVisibleItem();
+    while(item.IsOk() && !m_pendingValues.empty()) {
+        wxString gdbId = DoGetGdbId(item);
+        if(!gdbId.IsEmpty() && m_pendingValues.erase(gdbId)) {
+            dbgr->EvaluateVariableObject(gdbId, m_DBG_USERR);
+            m_gdbIdToTreeId[gdbId] = item;
+        }
+        item = m_listTable->GetNextVisible(item);
+    }
+}
+
 void DebuggerTreeListCtrlBase::DoRefreshItem(IDebugger* dbgr, const wxTreeItemId& item, bool forceCreate)
 {
     if(!dbgr || !item.IsOk())
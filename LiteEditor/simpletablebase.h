@@ -32,6 +32,7 @@
 #include "manager.h"
 
 #include <map>
+#include <unordered_set>
 #include <wx/gdicmn.h>
 #include <wx/string.h>
 
@@ -91,8 +92,13 @@ protected:
     virtual void OnNewWatch(wxCommandEvent& event);
     virtual void OnNewWatchUI(wxUpdateUIEvent& event);
     virtual void OnRefresh(wxCommandEvent& event);
+    void OnIdle(wxIdleEvent& event);
+    void OnListPaint(wxPaintEvent& event);
 
     std::map<wxString, wxTreeItemId> m_gdbIdToTreeId;
+    // variable objects whose value was not listed with their parent. The value is fetched once the row is on screen
+    std::unordered_set<wxString> m_pendingValues;
+    bool m_visibleRowsChanged = false;
     std::map<wxString, wxTreeItemId> m_listChildItemId;
     std::map<wxString, wxTreeItemId> m_createVarItemId;
     DbgStackInfo m_curStackInfo;
@@ -115,7 +121,10 @@ public:
     virtual void DoResetItemColour(const wxTreeItemId& item, size_t itemKind);
     virtual void OnEvaluateVariableObj(const DebuggerEventData& event);
     virtual void OnCreateVariableObjError(const DebuggerEventData& event);
-    virtual void DoRefreshItemRecursively(IDebugger* dbgr, const wxTreeItemId& item, wxArrayString& itemsToRefresh);
+    virtual void DoRefreshItemRecursively(IDebugger* dbgr, const wxTreeItemId& item, wxArrayString& itemsToRefresh,
+                                          const wxStringMap_t& values);
+    /// set the value column, highlighting the change
+    void DoSetItemValue(const wxTreeItemId& item, const wxString& value);
     virtual void Clear();
     virtual void DoRefreshItem(IDebugger* dbgr, const wxTreeItemId& item, bool forceCreate);
     virtual wxString DoGetGdbId(const wxTreeItemId& item);
@@ -124,6 +133,12 @@ public:
     virtual wxTreeItemId DoFindItemByExpression(const wxString& expr);
     virtual void ResetTableColors();
     virtual wxString GetItemPath(const wxTreeItemId& item);
+
+    /**
+     * @brief add a child variable object listed by IDebugger::ListChildren. Its value is set right away when the
+     * debugger listed it, otherwise it is evaluated when the row becomes visible
+     */
+    wxTreeItemId DoAppendVariableObjectChild(const wxTreeItemId& parent, const VariableObjChild& child);
 };
 
 #endif //__simpletablebase__
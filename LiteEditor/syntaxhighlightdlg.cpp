@@ -483,7 +483,7 @@ void SyntaxHighlightDlg::OnText(wxCommandEvent& event)
     CHECK_PTR_RET(m_lexer);
     event.Skip();
     m_isModified = true;
-    m_lexer->SetFileSpec(m_fileSpec->GetValue());
+    ColoursAndFontsManager::Get().SetLexerFileSpec(m_lexer, m_fileSpec->GetValue());
 }
 
 void SyntaxHighlightDlg::CreateLexerPage()
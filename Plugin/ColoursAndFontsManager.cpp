@@ -395,6 +395,9 @@ void ColoursAndFontsManager::Save(const wxFileName& lexer_json)
     output_file.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
 
     root.save(output_file);
+    // the file specs may have been edited
+    m_fileSpecsDirty = true;
+
     // store the global font as well
     if (m_globalFont.IsOk()) {
         clConfig::Get().Write("GlobalThemeFont", m_globalFont);
@@ -452,15 +455,17 @@ std::optional<LexerConf::Ptr_t> ColoursAndFontsManager::GetLexerForFileType(File
     }
 }
 
+void ColoursAndFontsManager::SetLexerFileSpec(LexerConf::Ptr_t lexer, const wxString& fileSpec)
+{
+    lexer->SetFileSpec(fileSpec);
+    m_fileSpecsDirty = true;
+}
+
 LexerConf::Ptr_t ColoursAndFontsManager::GetLexerForFile(const wxString& filename) const
 {
     if (filename.IsEmpty())
         return GetLexer("text");
 
-    wxFileName fnFileName(filename);
-    wxString fileNameLowercase = fnFileName.GetFullName();
-    fileNameLowercase.MakeLower();
-
     LexerConf::Ptr_t defaultLexer = nullptr;
     LexerConf::Ptr_t firstLexer = nullptr;
     LexerConf::Ptr_t firstLexerForTheme = nullptr;
@@ -468,34 +473,23 @@ LexerConf::Ptr_t ColoursAndFontsManager::GetLexerForFile(const wxString& filenam
     // try and find a match for the current theme
     const wxString& theme_name = GetGlobalTheme();
 
-    // Get list of all lexers - without the "text" lexer
-    ColoursAndFontsManager::Vec_t allLexersNoText;
-    allLexersNoText.reserve(m_allLexers.size());
-
-    for (auto lexer : m_allLexers) {
-        if (lexer->GetName() != "text") {
-            allLexersNoText.push_back(lexer);
-        }
-    }
-
-    // Scan the list of lexers, locate the active lexer for it and return it
-    for (auto lexer : allLexersNoText) {
-        wxString fileMask = lexer->GetFileSpec();
-        if (FileUtils::WildMatch(fileMask, filename)) {
-            if (lexer->IsActive()) {
-                return lexer;
+    // Scan the lexers matching the file mask, locate the active lexer for it and return it
+    UpdateFileSpecs();
+    for (size_t id : m_fileSpecs.Match(filename)) {
+        const auto& lexer = m_fileSpecsLexers[id];
+        if (lexer->IsActive()) {
+            return lexer;
 
-            } else if (!firstLexer) {
-                firstLexer = lexer;
+        } else if (!firstLexer) {
+            firstLexer = lexer;
 
-            } else if (!defaultLexer && lexer->GetThemeName() == DEFAULT_THEME) {
-                defaultLexer = lexer;
-            }
+        } else if (!defaultLexer && lexer->GetThemeName() == DEFAULT_THEME) {
+            defaultLexer = lexer;
+        }
 
-            // try to find a theme that matches the current one
-            if (!firstLexerForTheme && lexer->GetThemeName() == theme_name) {
-                firstLexerForTheme = lexer;
-            }
+        // try to find a theme that matches the current one
+        if (!firstLexerForTheme && lexer->GetThemeName() == theme_name) {
+            firstLexerForTheme = lexer;
         }
     }
 
@@ -547,10 +541,30 @@ void ColoursAndFontsManager::Reload()
     Load();
 }
 
+void ColoursAndFontsManager::UpdateFileSpecs() const
+{
+    if (!m_fileSpecsDirty) {
+        return;
+    }
+
+    m_fileSpecs.Clear();
+    m_fileSpecsLexers.clear();
+    m_fileSpecsLexers.reserve(m_allLexers.size());
+    // The "text" lexer is the fallback, it is never matched by its file spec
+    for (const auto& lexer : m_allLexers) {
+        if (lexer->GetName() != "text") {
+            m_fileSpecs.Add(lexer->GetFileSpec(), m_fileSpecsLexers.size());
+            m_fileSpecsLexers.push_back(lexer);
+        }
+    }
+    m_fileSpecsDirty = false;
+}
+
 void ColoursAndFontsManager::Clear()
 {
     m_allLexers.clear();
     m_lexersMap.clear();
+    m_fileSpecsDirty = true;
     m_initialized = false;
 }
 
@@ -685,6 +699,7 @@ void ColoursAndFontsManager::LoadLexersFromFile()
 
     m_allLexers.clear();
     m_lexersMap.clear();
+    m_fileSpecsDirty = true;
 
     clINFO() << "Loading lexers. System file:" << fnInstallLexers << endl;
     clINFO() << "Loading lexers. Local file:" << fnUserLexers << endl;
@@ -1112,6 +1127,7 @@ LexerConf::Ptr_t ColoursAndFontsManager::DoAddLexer(JSONItem json)
     }
     vec.push_back(lexer);
     m_allLexers.push_back(lexer);
+    m_fileSpecsDirty = true;
 
     if (m_globalFont.IsOk()) {
         const wxString font_desc = m_globalFont.GetNativeFontInfoDesc();
@@ -1218,6 +1234,7 @@ bool ColoursAndFontsManager::ImportLexersFile(const wxFileName& inputFile, bool
 
     // Rebuild "m_allLexers" after the merge
     m_allLexers.clear();
+    m_fileSpecsDirty = true;
     for (const auto& p : m_lexersMap) {
         for (const auto& lexer : p.second) {
             m_allLexers.push_back(lexer);
@@ -26,6 +26,7 @@
 #ifndef LEXERCONFMANAGER_H
 #define LEXERCONFMANAGER_H
 
+#include "clFileClassifier.hpp"
 #include "cl_command_event.h"
 #include "codelite_exports.h"
 #include "fileextmanager.h"
@@ -61,6 +62,10 @@ protected:
     LexerConf::Ptr_t m_defaultLexer;
     int m_lexersVersion = wxNOT_FOUND;
     wxFont m_globalFont;
+    /// The lexers' file specs, compiled. Ids are indexes into `m_fileSpecsLexers`
+    mutable clFileClassifier m_fileSpecs;
+    mutable ColoursAndFontsManager::Vec_t m_fileSpecsLexers;
+    mutable bool m_fileSpecsDirty = true;
 
 private:
     ColoursAndFontsManager();
@@ -79,6 +84,11 @@ private:
      */
     void LoadLexersFromFile();
 
+    /**
+     * @brief (re)compile the lexers' file specs if the lexers were changed since the last call
+     */
+    void UpdateFileSpecs() const;
+
     /**
      * @brief load lexers from lexers.db
      */
@@ -189,6 +199,11 @@ public:
      */
     LexerConf::Ptr_t GetLexerForFile(const wxString& filename) const;
 
+    /**
+     * @brief change the file spec of `lexer`. The file specs are compiled again on the next GetLexerForFile()
+     */
+    void SetLexerFileSpec(LexerConf::Ptr_t lexer, const wxString& fileSpec);
+
     /**
      * @brief Retrieves the lexer configuration for a given file type.
      *
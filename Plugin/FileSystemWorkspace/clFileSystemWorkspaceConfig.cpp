@@ -186,11 +186,41 @@ wxArrayString clFileSystemWorkspaceConfig::ExpandUserCompletionFlags(const wxStr
                                                                      clBacktickCache::ptr_t backticks,
                                                                      bool withPrefix) const
 {
-    wxArrayString searchPaths;
+    // we support up to one backtick in a line
+    std::vector<clBacktickCache::Request> requests;
     for (const auto& line : m_compileFlags) {
-        // we support up to one backtick in a line
         wxString backtick = line.AfterFirst('`');
         backtick = backtick.BeforeLast('`');
+        requests.push_back({backtick, workingDirectory});
+    }
+
+    // run the distinct commands concurrently
+    std::vector<wxString> outputs(requests.size());
+    if (backticks) {
+        std::vector<clBacktickCache::Request> commands;
+        std::vector<size_t> lines;
+        for (size_t i = 0; i < requests.size(); ++i) {
+            if (!requests[i].command.empty()) {
+                commands.push_back(requests[i]);
+                lines.push_back(i);
+            }
+        }
+
+        size_t runCount = backticks->GetRunCount();
+        auto expanded = backticks->EvaluateAll(commands);
+        for (size_t i = 0; i < lines.size(); ++i) {
+            outputs[lines[i]] = expanded[i];
+        }
+        // keep the new results for future lookups
+        if (backticks->GetRunCount() != runCount) {
+            backticks->Save();
+        }
+    }
+
+    wxArrayString searchPaths;
+    for (size_t i = 0; i < m_compileFlags.size(); ++i) {
+        const wxString& line = m_compileFlags[i];
+        const wxString& backtick = requests[i].command;
 
         wxString prefix;
         wxString suffix;
@@ -200,27 +230,18 @@ wxArrayString clFileSystemWorkspaceConfig::ExpandUserCompletionFlags(const wxStr
         } else {
             prefix = line;
         }
-        wxString backtick_expanded;
-        if (!backtick.empty()) {
-            if (backticks && backticks->HasCommand(backtick)) {
-                backtick_expanded = backticks->GetExpanded(backtick);
-            } else {
-                // we got backtick, expand it
-                DirSaver ds;
-
-                ::wxSetWorkingDirectory(workingDirectory);
-                // Now run the command
-                clDEBUG() << "Working directory is set to:" << workingDirectory << clEndl;
-                clDEBUG() << "Running command:" << backtick << clEndl;
-                backtick_expanded = ProcUtils::SafeExecuteCommand(backtick);
-                backtick_expanded.Trim().Trim(false);
-                // keep the result for future lookups
-                if (backticks) {
-                    backticks->SetCommand(backtick, backtick_expanded);
-                    backticks->Save();
-                }
-                clDEBUG() << "Output:" << backtick_expanded << clEndl;
-            }
+        wxString backtick_expanded = outputs[i];
+        if (!backtick.empty() && !backticks) {
+            // we got backtick, expand it
+            DirSaver ds;
+
+            ::wxSetWorkingDirectory(workingDirectory);
+            // Now run the command
+            clDEBUG() << "Working directory is set to:" << workingDirectory << clEndl;
+            clDEBUG() << "Running command:" << backtick << clEndl;
+            backtick_expanded = ProcUtils::SafeExecuteCommand(backtick);
+            backtick_expanded.Trim().Trim(false);
+            clDEBUG() << "Output:" << backtick_expanded << clEndl;
         }
         wxString line_expanded = prefix + backtick_expanded + suffix;
 
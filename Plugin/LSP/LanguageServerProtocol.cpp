@@ -255,6 +255,11 @@ bool LanguageServerProtocol::IsRunning() const { return m_network->IsConnected()
 
 bool LanguageServerProtocol::CanHandle(IEditor* editor) const
 {
+    // a file in large file mode is never sent to the server: its whole content is sent on every change
+    if (editor && editor->IsLargeFile()) {
+        return false;
+    }
+
     // use the local file path
     wxString lang = GetLanguageId(editor);
     return IsRunning() && m_languages.count(lang) != 0;
@@ -38,6 +38,7 @@
 
 #include <algorithm>
 #include <array>
+#include <thread>
 #include <unordered_map>
 #include <wx/app.h>
 #include <wx/dcscreen.h>
@@ -46,21 +47,45 @@
 #include <wx/msgdlg.h>
 #include <wx/settings.h>
 #include <wx/stdpaths.h>
+#include <wx/stopwatch.h>
 #include <wx/tokenzr.h>
 
 namespace
 {
 std::unordered_map<wxString, wxBitmapBundle> DARK_THEME_BMPBUNLES;
 std::unordered_map<wxString, wxBitmapBundle> LIGHT_THEME_BMPBUNLES;
+std::unordered_map<wxString, wxString> DARK_THEME_SVG_FILES;
+std::unordered_map<wxString, wxString> LIGHT_THEME_SVG_FILES;
+
+// the icons rasterized for the atlas per timer event
+constexpr size_t ATLAS_BATCH_SIZE = 16;
+constexpr int ATLAS_STEP_INTERVAL_MS = 20;
+
+double GetTopWindowScale()
+{
+    wxWindow* win = wxTheApp->GetTopWindow();
+    return win ? win->GetDPIScaleFactor() : 1.0;
+}
 } // namespace
 
 BitmapLoader::BitmapLoader(wxWindow* win, bool darkTheme)
     : m_win(win)
 {
     wxUnusedVar(m_win);
+    m_atlasTimer.SetOwner(this);
+    Bind(wxEVT_TIMER, &BitmapLoader::OnBuildAtlasStep, this, m_atlasTimer.GetId());
     Initialize(darkTheme);
 }
 
+BitmapLoader::~BitmapLoader()
+{
+    m_atlasTimer.Stop();
+    // the worker posts its result to this object: it must be done before we are gone
+    if (m_atlasThread.joinable()) {
+        m_atlasThread.join();
+    }
+}
+
 std::unordered_map<wxString, wxBitmapBundle>* BitmapLoader::GetBundles(bool darkTheme) const
 { return darkTheme ? &DARK_THEME_BMPBUNLES : &LIGHT_THEME_BMPBUNLES; }
 
@@ -70,11 +95,25 @@ const wxBitmap& BitmapLoader::LoadBitmap(const wxString& name, int requestedSize
     wxUnusedVar(requestedSize);
     wxString newName = name.AfterLast('/');
 
-    if (m_toolbarsBitmaps.count(newName) == 0) {
+    auto iter = m_toolbarsBitmaps.find(newName);
+    if (iter != m_toolbarsBitmaps.end()) {
+        return iter->second;
+    }
+
+    // Prefer the pre-rasterized atlas, fallback to the SVG file
+    wxBitmap bmp = m_atlas.GetBitmap(newName);
+    if (!bmp.IsOk()) {
+        const wxBitmapBundle& bundle = DoGetBundle(newName, m_darkTheme);
+        if (bundle.IsOk()) {
+            bmp = bundle.GetBitmapFor(wxTheApp->GetTopWindow());
+        }
+    }
+
+    if (!bmp.IsOk()) {
         LOG_IF_WARN { clWARNING() << "requested image:" << newName << "does not exist" << endl; }
         return wxNullBitmap;
     }
-    return m_toolbarsBitmaps.find(newName)->second;
+    return m_toolbarsBitmaps.insert({newName, bmp}).first->second;
 }
 
 int BitmapLoader::GetMimeImageId(int type, bool disabled) { return GetMimeBitmaps().GetIndex(type, disabled); }
@@ -89,16 +128,13 @@ wxIcon BitmapLoader::GetIcon(const wxBitmap& bmp) const
     return icn;
 }
 
-void BitmapLoader::AddBitmapInternal(const wxBitmapBundle& bundle, const wxString& base_name)
+const std::unordered_map<wxString, wxString>& BitmapLoader::GetSVGFiles(bool darkTheme) const
 {
-    wxBitmap bmp = bundle.GetBitmapFor(wxTheApp->GetTopWindow());
-    if (bmp.IsOk()) {
-        m_toolbarsBitmaps.insert({base_name, bmp});
+    auto& svg_files = darkTheme ? DARK_THEME_SVG_FILES : LIGHT_THEME_SVG_FILES;
+    if (!svg_files.empty()) {
+        return svg_files;
     }
-}
 
-void BitmapLoader::LoadSVGFiles(bool darkTheme)
-{
     // Load the bitmaps based on the current theme background colour
     wxFileName svg_path{clStandardPaths::Get().GetDataDir(), wxEmptyString};
     svg_path.AppendDir("svgs");
@@ -106,42 +142,126 @@ void BitmapLoader::LoadSVGFiles(bool darkTheme)
 
     if (!svg_path.DirExists()) {
         clWARNING() << "Unable to load SVG images. Broken installation" << endl;
-        return;
+        return svg_files;
     }
+
+    clFilesScanner scanner;
+    clDEBUG() << "Indexing SVG files from:" << svg_path.GetPath() << endl;
+    scanner.ScanWithCallbacks(svg_path.GetPath(), nullptr, [&](const wxArrayString& files) -> bool {
+        for (const wxString& filepath : files) {
+            svg_files.insert({wxFileName(filepath).GetName(), filepath});
+        }
+        return true;
+    });
+    return svg_files;
+}
+
+const wxBitmapBundle& BitmapLoader::DoGetBundle(const wxString& name, bool darkTheme) const
+{
+    static wxBitmapBundle NullBundle;
     auto bitmap_bundle_cache = GetBundles(darkTheme);
+    auto bundle = bitmap_bundle_cache->find(name);
+    if (bundle != bitmap_bundle_cache->end()) {
+        return bundle->second;
+    }
 
-    // load the cache
-    if (bitmap_bundle_cache->empty()) {
-        clFilesScanner scanner;
-        clDEBUG() << "Loading SVG files from:" << svg_path.GetPath() << endl;
-        scanner.ScanWithCallbacks(svg_path.GetPath(), nullptr, [&](const wxArrayString& files) -> bool {
-            for (const wxString& filepath : files) {
-                auto bmpbundle = wxBitmapBundle::FromSVGFile(filepath, wxSize(16, 16));
-                if (bmpbundle.IsOk()) {
-                    bitmap_bundle_cache->insert({wxFileName(filepath).GetName(), bmpbundle});
-                }
-            }
-            return true;
-        });
+    const auto& svg_files = GetSVGFiles(darkTheme);
+    auto svg_file = svg_files.find(name);
+    if (svg_file == svg_files.end()) {
+        return NullBundle;
     }
+
+    auto bmpbundle = wxBitmapBundle::FromSVGFile(svg_file->second, wxSize(16, 16));
+    if (!bmpbundle.IsOk()) {
+        return NullBundle;
+    }
+    return bitmap_bundle_cache->insert({name, bmpbundle}).first->second;
 }
 
 void BitmapLoader::Initialize(bool darkTheme)
 {
-    LoadSVGFiles(darkTheme);
-    auto bitmap_bundle_cache = GetBundles(darkTheme);
-
+    wxStopWatch sw;
+    m_darkTheme = darkTheme;
     m_toolbarsBitmaps.clear();
-    m_toolbarsBitmaps.reserve(bitmap_bundle_cache->size());
 
-    for (const auto& vt : *bitmap_bundle_cache) {
-        AddBitmapInternal(vt.second, vt.first);
-    }
+    const auto& svg_files = GetSVGFiles(darkTheme);
+    double scale = GetTopWindowScale();
+    bool atlas_loaded =
+        m_atlas.Load(clIconAtlas::GetAtlasFile(darkTheme, scale), clIconAtlas::ComputeHash(svg_files, scale));
 
     // Create the mime-list
     CreateMimeList();
+
+    clDEBUG() << "BitmapLoader (" << (darkTheme ? "dark" : "light") << "theme) initialised in" << sw.Time()
+              << "ms. Icon atlas:" << (atlas_loaded ? "loaded" : "missing or out of date") << endl;
+
+    if (!atlas_loaded && !svg_files.empty()) {
+        // (Re)build the atlas once the startup is over
+        CallAfter(&BitmapLoader::BuildAtlas);
+    }
+}
+
+void BitmapLoader::BuildAtlas()
+{
+    if (!m_atlasPending.empty()) {
+        return;
+    }
+
+    // the scale used to rasterize the icons is the one the atlas is keyed by: at Initialize() time, the top window
+    // (and so its scale) may not exist yet
+    m_atlasScale = GetTopWindowScale();
+    m_atlasImages.clear();
+    for (const auto& vt : GetSVGFiles(m_darkTheme)) {
+        m_atlasPending.push_back(vt.first);
+    }
+    m_atlasTimer.StartOnce(ATLAS_STEP_INTERVAL_MS);
+}
+
+void BitmapLoader::OnBuildAtlasStep(wxTimerEvent& event)
+{
+    wxUnusedVar(event);
+
+    // rasterizing an SVG file requires the UI thread: a few icons at a time, so the UI remains responsive
+    for (size_t i = 0; i < ATLAS_BATCH_SIZE && !m_atlasPending.empty(); ++i) {
+        wxString name = m_atlasPending.back();
+        m_atlasPending.pop_back();
+
+        const wxBitmapBundle& bundle = DoGetBundle(name, m_darkTheme);
+        if (bundle.IsOk()) {
+            wxBitmap bmp = bundle.GetBitmap(bundle.GetDefaultSize() * m_atlasScale);
+            if (bmp.IsOk()) {
+                m_atlasImages.insert({name, bmp.ConvertToImage()});
+            }
+        }
+    }
+
+    if (!m_atlasPending.empty()) {
+        m_atlasTimer.StartOnce(ATLAS_STEP_INTERVAL_MS);
+        return;
+    }
+
+    // pack and write the atlas on a worker thread. The images are moved there, the UI thread no longer uses them
+    wxFileName atlasFile = clIconAtlas::GetAtlasFile(m_darkTheme, m_atlasScale);
+    uint64_t hash = clIconAtlas::ComputeHash(GetSVGFiles(m_darkTheme), m_atlasScale);
+    if (m_atlasThread.joinable()) {
+        // a previous build (e.g. for the other scale) is still writing
+        m_atlasThread.join();
+    }
+    m_atlasThread = std::thread([this, atlasFile, hash, scale = m_atlasScale, images = std::move(m_atlasImages)]() {
+        wxStopWatch sw;
+        if (!clIconAtlas::Build(atlasFile, hash, scale, images)) {
+            clWARNING() << "Failed to write icon atlas:" << atlasFile.GetFullPath() << endl;
+            return;
+        }
+        clDEBUG() << "Icon atlas" << atlasFile.GetFullPath() << "created with" << images.size() << "icons in"
+                  << sw.Time() << "ms" << endl;
+        CallAfter(&BitmapLoader::OnAtlasBuilt, atlasFile, hash);
+    });
+    m_atlasImages.clear();
 }
 
+void BitmapLoader::OnAtlasBuilt(const wxFileName& atlasFile, uint64_t hash) { m_atlas.Load(atlasFile, hash); }
+
 wxImageList* BitmapLoader::GetStandardMimeImageList()
 {
     wxImageList* images = new wxImageList();
@@ -255,16 +375,7 @@ const wxBitmap& BitmapLoader::GetBitmapForFile(const wxString& filename, bool di
 
 const wxBitmapBundle& BitmapLoader::GetBundle(const wxString& name) const
 {
-    static wxBitmapBundle NullBundle;
-    bool darkTheme = clSystemSettings::Get().IsDark();
-    auto bitmap_bundle_cache = GetBundles(darkTheme);
-
-    auto bundle = bitmap_bundle_cache->find(name);
-    if (bundle == bitmap_bundle_cache->end()) {
-        return NullBundle;
-    } else {
-        return bundle->second;
-    }
+    return DoGetBundle(name, clSystemSettings::Get().IsDark());
 }
 
 //===---------------------------
@@ -363,8 +474,7 @@ BitmapLoader* clBitmaps::GetLoader() { return m_activeBitmaps; }
 
 void clBitmaps::InitialiseInternal(wxWindow* win)
 {
-    m_darkBitmaps = new BitmapLoader(win, true);
-    m_lightBitmaps = new BitmapLoader(win, false);
+    m_win = win;
     SysColoursChanged();
 }
 
@@ -372,6 +482,13 @@ void clBitmaps::SysColoursChanged()
 {
     auto old_ptr = m_activeBitmaps;
     bool isDark = clSystemSettings::IsDark();
+
+    // The loader of the other theme is only created when the user switches to it
+    if (isDark && m_darkBitmaps == nullptr) {
+        m_darkBitmaps = new BitmapLoader(m_win, true);
+    } else if (!isDark && m_lightBitmaps == nullptr) {
+        m_lightBitmaps = new BitmapLoader(m_win, false);
+    }
     m_activeBitmaps = isDark ? m_darkBitmaps : m_lightBitmaps;
 
     if (old_ptr != m_activeBitmaps) {
@@ -547,13 +664,11 @@ const wxString& clBitmapList::GetBitmapName(size_t index) const
 
 bool BitmapLoader::GetIconBundle(const wxString& name, wxIconBundle* bundle)
 {
-    LoadSVGFiles(clSystemSettings::IsDark());
-    auto bundles = GetBundles(clSystemSettings::IsDark());
-    if (bundles->count(name) == 0) {
+    const auto& bmp_bundle = DoGetBundle(name, clSystemSettings::IsDark());
+    if (!bmp_bundle.IsOk()) {
         return false;
     }
 
-    const auto& bmp_bundle = bundles->find(name)->second;
     std::array<int, 5> sizes = {24, 32, 64, 128, 256};
     for (int size : sizes) {
         size = wxTheApp->GetTopWindow()->FromDIP(size);
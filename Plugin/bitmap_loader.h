@@ -26,14 +26,17 @@
 #ifndef BITMAP_LOADER_H
 #define BITMAP_LOADER_H
 
+#include "clIconAtlas.hpp"
 #include "cl_command_event.h"
 #include "codelite_exports.h"
 #include "fileextmanager.h"
 
+#include <thread>
 #include <vector>
 #include <wx/bitmap.h>
 #include <wx/filename.h>
 #include <wx/imaglist.h>
+#include <wx/timer.h>
 
 class WXDLLIMPEXP_SDK clMimeBitmaps
 {
@@ -201,11 +204,29 @@ protected:
 
 private:
     BitmapLoader(wxWindow* win, bool darkTheme);
-    virtual ~BitmapLoader() = default;
+    virtual ~BitmapLoader();
 
-    void AddBitmapInternal(const wxBitmapBundle& bundle, const wxString& base_name);
     void Initialize(bool darkTheme);
-    void LoadSVGFiles(bool darkTheme);
+
+    /**
+     * @brief return the SVG files (name -> path) of a given theme. The directory is scanned once, the SVG files are
+     * loaded only when needed (see `DoGetBundle()`)
+     */
+    const std::unordered_map<wxString, wxString>& GetSVGFiles(bool darkTheme) const;
+
+    /**
+     * @brief return the bundle for `name`, loading its SVG file on first use
+     */
+    const wxBitmapBundle& DoGetBundle(const wxString& name, bool darkTheme) const;
+
+    /**
+     * @brief rasterize all the icons of this theme into the icon atlas, so the next startup can skip the SVG loading.
+     * The icons are rasterized a few at a time on the UI thread, the atlas is packed and written on a worker thread
+     */
+    void BuildAtlas();
+    void OnBuildAtlasStep(wxTimerEvent& event);
+    /// the worker thread wrote the atlas
+    void OnAtlasBuilt(const wxFileName& atlasFile, uint64_t hash);
 
     wxFileName m_zipPath;
     std::unordered_map<wxString, wxBitmap> m_toolbarsBitmaps;
@@ -214,6 +235,15 @@ private:
     clMimeBitmaps m_mimeBitmaps;
     std::unordered_map<wxString, wxBitmapBundle>* GetBundles(bool darkTheme) const;
     wxWindow* m_win{nullptr};
+    bool m_darkTheme{false};
+    clIconAtlas m_atlas;
+    // the atlas being built
+    wxTimer m_atlasTimer;
+    std::vector<wxString> m_atlasPending;
+    std::unordered_map<wxString, wxImage> m_atlasImages;
+    double m_atlasScale{1.0};
+    // packs and writes the atlas, joined before the loader is destroyed
+    std::thread m_atlasThread;
 };
 
 wxDECLARE_EXPORTED_EVENT(WXDLLIMPEXP_SDK, wxEVT_BITMAPS_UPDATED, clCommandEvent);
@@ -222,6 +252,7 @@ class WXDLLIMPEXP_SDK clBitmaps : public wxEvtHandler
     BitmapLoader* m_lightBitmaps = nullptr;
     BitmapLoader* m_darkBitmaps = nullptr;
     BitmapLoader* m_activeBitmaps = nullptr;
+    wxWindow* m_win = nullptr;
 
 protected:
     void InitialiseInternal(wxWindow* win);
@@ -68,6 +68,8 @@ enum sci_marker_types { /* markers 0-2 are unused atm */
                         smt_warning,                              // 16
                         smt_error,                                // 17
                         smt_line_marker,                          // 18
+                        smt_static_analysis_warning,              // 19
+                        smt_static_analysis_error,                // 20
 };
 
 // These are bitmap masks of the various margin markers.
@@ -93,6 +95,9 @@ enum marker_mask_type {
     mmt_error = 1 << 17,
     mmt_compiler = mmt_warning | mmt_error, // Compiler errors and warnings
     mmt_line_marker = 1 << 18,              // Mask for the 18th bit (smt_line_marker)
+    mmt_static_analysis_warning = 1 << 19,
+    mmt_static_analysis_error = 1 << 20,
+    mmt_static_analysis = mmt_static_analysis_warning | mmt_static_analysis_error, // cppcheck and friends
     mmt_folds = wxSTC_MASK_FOLDERS          /* 0xFE000000 */
 };
 
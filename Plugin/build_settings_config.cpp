@@ -114,6 +114,10 @@ void BuildSettingsConfig::SetCompiler(CompilerPtr cmp)
 
     SaveXmlFile();
     DoUpdateCompilers();
+
+    // the compiler tools may have changed
+    clCommandEvent event(wxEVT_COMPILER_LIST_UPDATED);
+    EventNotifier::Get()->AddPendingEvent(event);
 }
 
 CompilerPtr BuildSettingsConfig::GetCompiler(const wxString& name) const
@@ -178,6 +182,9 @@ void BuildSettingsConfig::DeleteCompiler(const wxString& name)
         delete node;
         SaveXmlFile();
         DoUpdateCompilers();
+
+        clCommandEvent event(wxEVT_COMPILER_LIST_UPDATED);
+        EventNotifier::Get()->AddPendingEvent(event);
     }
 }
 
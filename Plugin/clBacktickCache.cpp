@@ -1,56 +1,225 @@
 #include "clBacktickCache.hpp"
 
-#include "fileutils.h"
+#include "AsyncProcess/asyncprocess.h"
+#include "JSON.h"
+#include "file_logger.h"
 
+#include <algorithm>
+#include <thread>
+#include <unordered_set>
 #include <wx/filename.h>
-#include <wx/tokenzr.h>
+#include <wx/utils.h>
+
+namespace
+{
+wxString RunCommand(const wxString& command, const wxString& workingDirectory)
+{
+    wxString output;
+    IProcess::Ptr_t proc(::CreateSyncProcess(command, IProcessCreateDefault, workingDirectory));
+    if (proc) {
+        proc->WaitForTerminate(output);
+    }
+    return output;
+}
+
+size_t ToMilliseconds(std::chrono::system_clock::time_point time)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()).count();
+}
+} // namespace
+
+clBacktickCache::clBacktickCache()
+    : m_runner(RunCommand)
+{
+}
 
 clBacktickCache::clBacktickCache(const wxString& directory)
+    : clBacktickCache()
 {
-    wxString content;
-    wxFileName fn(directory, "BacktickCache.txt");
+    wxFileName fn(directory, "BacktickCache.json");
     fn.AppendDir(".codelite");
     m_file = fn.GetFullPath();
-    if (fn.FileExists()) {
-        FileUtils::ReadFileContent(fn, content);
-        wxArrayString lines = ::wxStringTokenize(content, "\n", wxTOKEN_STRTOK);
-        for (auto& line : lines) {
-            TrimString(line);
-            wxString command = line.BeforeFirst('=');
-            wxString output = line.AfterFirst('=');
-            TrimString(command);
-            TrimString(output);
-
-            if (command.empty()) {
-                continue;
-            }
-            m_cache.insert({command, output});
+    if (!fn.FileExists()) {
+        return;
+    }
+
+    JSON root(fn);
+    if (!root.isOk()) {
+        return;
+    }
+
+    JSONItem entries = root.toElement();
+    int count = entries.arraySize();
+    for (int i = 0; i < count; ++i) {
+        JSONItem item = entries.arrayItem(i);
+        Entry entry;
+        entry.output = item["output"].toString();
+        entry.time = std::chrono::system_clock::time_point(std::chrono::milliseconds(item["time"].toSize_t()));
+        if (IsExpired(entry)) {
+            continue;
         }
+        wxString key =
+            MakeKey(item["command"].toString(), item["workingDirectory"].toString(), item["environment"].toSize_t());
+        m_cache.insert({key, entry});
     }
 }
 
 void clBacktickCache::Save()
 {
-    wxString content;
-    for (const auto& vt : m_cache) {
-        content << vt.first << "=" << vt.second << "\n";
+    if (m_file.empty()) {
+        return;
+    }
+
+    JSON root(JsonType::Array);
+    JSONItem entries = root.toElement();
+    {
+        std::unique_lock lock{m_mutex};
+        for (const auto& [key, entry] : m_cache) {
+            // the key is: command \n working directory \n environment hash
+            wxString command = key.BeforeFirst('\n');
+            wxString workingDirectory = key.AfterFirst('\n').BeforeLast('\n');
+            unsigned long long envHash = 0;
+            key.AfterLast('\n').ToULongLong(&envHash);
+
+            JSONItem item = JSONItem::createObject();
+            item.addProperty("command", command);
+            item.addProperty("workingDirectory", workingDirectory);
+            item.addProperty("environment", static_cast<size_t>(envHash));
+            item.addProperty("time", ToMilliseconds(entry.time));
+            item.addProperty("output", entry.output);
+            entries.arrayAppend(std::move(item));
+        }
+    }
+    root.save(m_file);
+}
+
+wxString clBacktickCache::Evaluate(const wxString& command, const wxString& workingDirectory)
+{
+    return DoEvaluate(MakeKey(command, workingDirectory, HashEnvironment()), command, workingDirectory);
+}
+
+std::vector<wxString> clBacktickCache::EvaluateAll(const std::vector<Request>& requests, size_t maxJobs)
+{
+    size_t envHash = HashEnvironment();
+
+    // the distinct commands, in the order they first appear
+    std::vector<wxString> keys;
+    keys.reserve(requests.size());
+    std::vector<size_t> unique;
+    std::unordered_set<wxString> seen;
+    for (size_t i = 0; i < requests.size(); ++i) {
+        keys.push_back(MakeKey(requests[i].command, requests[i].workingDirectory, envHash));
+        if (seen.insert(keys.back()).second) {
+            unique.push_back(i);
+        }
+    }
+
+    std::vector<wxString> outputs(unique.size());
+    std::atomic_size_t next{0};
+    auto worker = [&]() {
+        for (size_t n = next++; n < unique.size(); n = next++) {
+            const auto& request = requests[unique[n]];
+            outputs[n] = DoEvaluate(keys[unique[n]], request.command, request.workingDirectory);
+        }
+    };
+
+    // the processes inherit the environment of this thread's caller, which is the same for all the requests
+    size_t jobs = maxJobs > 0 ? maxJobs : std::max(std::thread::hardware_concurrency(), 1u);
+    jobs = std::min(jobs, unique.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < jobs; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thr : threads) {
+        thr.join();
+    }
+
+    std::unordered_map<wxString, size_t> outputIndex;
+    for (size_t n = 0; n < unique.size(); ++n) {
+        outputIndex.insert({keys[unique[n]], n});
+    }
+
+    std::vector<wxString> result;
+    result.reserve(requests.size());
+    for (const auto& key : keys) {
+        result.push_back(outputs[outputIndex[key]]);
+    }
+    return result;
+}
+
+void clBacktickCache::Clear()
+{
+    std::unique_lock lock{m_mutex};
+    m_cache.clear();
+}
+
+size_t clBacktickCache::HashEnvironment()
+{
+    wxEnvVariableHashMap env;
+    ::wxGetEnvMap(&env);
+
+    // the map is unordered
+    std::vector<wxString> vars;
+    vars.reserve(env.size());
+    for (const auto& [name, value] : env) {
+        vars.push_back(name + "=" + value);
     }
-    FileUtils::WriteFileContent(m_file, content);
+    std::sort(vars.begin(), vars.end());
+
+    size_t hash = 0;
+    for (const auto& var : vars) {
+        hash ^= std::hash<wxString>{}(var) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+    }
+    return hash;
 }
 
-bool clBacktickCache::HasCommand(const wxString& command) const { return m_cache.count(command) != 0; }
+wxString clBacktickCache::MakeKey(const wxString& command, const wxString& workingDirectory, size_t envHash)
+{
+    wxString key;
+    key << command << "\n" << workingDirectory << "\n" << wxString::Format("%llu", (unsigned long long)envHash);
+    return key;
+}
 
-void clBacktickCache::SetCommand(const wxString& command, const wxString& expanded)
+bool clBacktickCache::IsExpired(const Entry& entry) const
 {
-    m_cache.erase(command);
-    m_cache.insert({command, expanded});
+    return m_ttl.count() > 0 && std::chrono::system_clock::now() - entry.time >= m_ttl;
 }
 
-wxString clBacktickCache::GetExpanded(const wxString& command) const
+wxString clBacktickCache::DoEvaluate(const wxString& key, const wxString& command, const wxString& workingDirectory)
 {
-    auto iter = m_cache.find(command);
-    if (iter == m_cache.end()) {
-        return "";
+    std::promise<wxString> promise;
+    std::shared_future<wxString> running;
+    {
+        std::unique_lock lock{m_mutex};
+        auto iter = m_cache.find(key);
+        if (iter != m_cache.end() && !IsExpired(iter->second)) {
+            return iter->second.output;
+        }
+
+        auto runningIter = m_running.find(key);
+        if (runningIter != m_running.end()) {
+            running = runningIter->second;
+        } else {
+            m_running.insert({key, promise.get_future().share()});
+        }
+    }
+
+    if (running.valid()) {
+        // another thread is running this command
+        return running.get();
+    }
+
+    clDEBUG() << "Running backtick command:" << command << "from:" << workingDirectory << endl;
+    ++m_runCount;
+    wxString output = m_runner(command, workingDirectory);
+    output.Trim().Trim(false);
+    {
+        std::unique_lock lock{m_mutex};
+        m_cache.erase(key);
+        m_cache.insert({key, Entry{output, std::chrono::system_clock::now()}});
+        m_running.erase(key);
     }
-    return iter->second;
+    promise.set_value(output);
+    return output;
 }
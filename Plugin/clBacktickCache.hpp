@@ -2,28 +2,91 @@
 #define CLBACKTICKCACHE_HPP
 
 #include "codelite_exports.h"
-#include "macros.h"
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include <wx/string.h>
 
+/**
+ * @brief evaluate backticks and $(shell ...) commands, and cache their output.
+ *
+ * An output is cached for the command, its working directory and the environment it ran in: a change in the
+ * environment (e.g. PKG_CONFIG_PATH) is a cache miss. Entries expire after the TTL. Concurrent evaluations of the
+ * same command wait for a single run.
+ */
 class WXDLLIMPEXP_SDK clBacktickCache
 {
-    wxString m_file;
-    wxStringMap_t m_cache;
-
 public:
     using ptr_t = std::shared_ptr<clBacktickCache>;
+    /// run `command` from `workingDirectory` and return its output. Called from worker threads by EvaluateAll()
+    using Runner_t = std::function<wxString(const wxString& command, const wxString& workingDirectory)>;
+
+    struct Request {
+        wxString command;
+        wxString workingDirectory;
+    };
+
+    static constexpr std::chrono::milliseconds DEFAULT_TTL = std::chrono::minutes(10);
 
 public:
+    /// an in memory cache
+    clBacktickCache();
+    /// a cache saved to `directory`/.codelite
     clBacktickCache(const wxString& directory);
     virtual ~clBacktickCache() = default;
 
     void Save();
 
-    bool HasCommand(const wxString& command) const;
-    void SetCommand(const wxString& command, const wxString& expanded);
-    wxString GetExpanded(const wxString& command) const;
+    /**
+     * @brief return the output of `command`, from the cache or by running it in the current environment
+     */
+    wxString Evaluate(const wxString& command, const wxString& workingDirectory);
+
+    /**
+     * @brief evaluate all the `requests` in the current environment. The commands that are not cached are run once
+     * each, at most `maxJobs` at a time (0: the number of cores)
+     * @return the outputs, in the order of `requests`
+     */
+    std::vector<wxString> EvaluateAll(const std::vector<Request>& requests, size_t maxJobs = 0);
+
+    void Clear();
+
+    /// a TTL of 0 keeps the entries until Clear() is called
+    void SetTTL(std::chrono::milliseconds ttl) { m_ttl = ttl; }
+    /// replace the function running the commands
+    void SetRunner(Runner_t runner) { m_runner = std::move(runner); }
+
+    /// the number of commands that were run (i.e. the cache misses)
+    size_t GetRunCount() const { return m_runCount.load(); }
+
+    /**
+     * @brief a hash of the environment variables of this process
+     */
+    static size_t HashEnvironment();
+
+private:
+    struct Entry {
+        wxString output;
+        std::chrono::system_clock::time_point time;
+    };
+
+    static wxString MakeKey(const wxString& command, const wxString& workingDirectory, size_t envHash);
+    bool IsExpired(const Entry& entry) const;
+    wxString DoEvaluate(const wxString& key, const wxString& command, const wxString& workingDirectory);
+
+    wxString m_file;
+    std::unordered_map<wxString, Entry> m_cache;
+    std::unordered_map<wxString, std::shared_future<wxString>> m_running;
+    mutable std::mutex m_mutex;
+    std::chrono::milliseconds m_ttl = DEFAULT_TTL;
+    Runner_t m_runner;
+    std::atomic_size_t m_runCount{0};
 };
 
 #endif // CLBACKTICKCACHE_HPP
@@ -0,0 +1,369 @@
+#include "clIconAtlas.hpp"
+
+#include "cl_standard_paths.h"
+#include "file_logger.h"
+#include "fileutils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <wx/image.h>
+
+#ifdef __WXMSW__
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+constexpr char ATLAS_MAGIC[8] = {'C', 'L', 'A', 'T', 'L', 'A', 'S', '1'};
+constexpr uint32_t ATLAS_MAX_WIDTH = 1024;
+
+template <typename T>
+void Append(std::string& buffer, const T& value)
+{
+    buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/// A bounds checked reader over the mapped file
+class Reader
+{
+public:
+    Reader(const unsigned char* data, size_t size)
+        : m_data{data}
+        , m_size{size}
+    {
+    }
+
+    template <typename T>
+    bool Read(T* value)
+    {
+        if (m_pos + sizeof(T) > m_size) {
+            return false;
+        }
+        std::memcpy(value, m_data + m_pos, sizeof(T));
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool ReadBytes(size_t count, const unsigned char** ptr)
+    {
+        if (m_pos + count > m_size) {
+            return false;
+        }
+        *ptr = m_data + m_pos;
+        m_pos += count;
+        return true;
+    }
+
+private:
+    const unsigned char* m_data{nullptr};
+    size_t m_size{0};
+    size_t m_pos{0};
+};
+} // namespace
+
+/// Read-only memory mapped file
+class clMappedFile
+{
+public:
+    clMappedFile() = default;
+    ~clMappedFile()
+    {
+#ifdef __WXMSW__
+        if (m_data) {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping) {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+        }
+#else
+        if (m_data) {
+            munmap(m_data, m_size);
+        }
+        if (m_fd != -1) {
+            close(m_fd);
+        }
+#endif
+    }
+
+    bool Open(const wxString& path)
+    {
+#ifdef __WXMSW__
+        m_file = CreateFileW(path.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (m_file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(m_file, &file_size) || file_size.QuadPart == 0) {
+            return false;
+        }
+        m_size = static_cast<size_t>(file_size.QuadPart);
+        m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (m_mapping == nullptr) {
+            return false;
+        }
+        m_data = MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+        return m_data != nullptr;
+#else
+        m_fd = open(path.mb_str(wxConvUTF8).data(), O_RDONLY);
+        if (m_fd == -1) {
+            return false;
+        }
+        struct stat st;
+        if (fstat(m_fd, &st) != 0 || st.st_size == 0) {
+            return false;
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_fd, 0);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+        m_data = data;
+        return true;
+#endif
+    }
+
+    const unsigned char* GetData() const { return static_cast<const unsigned char*>(m_data); }
+    size_t GetSize() const { return m_size; }
+
+private:
+#ifdef __WXMSW__
+    HANDLE m_file{INVALID_HANDLE_VALUE};
+    HANDLE m_mapping{nullptr};
+#else
+    int m_fd{-1};
+#endif
+    void* m_data{nullptr};
+    size_t m_size{0};
+};
+
+clIconAtlas::clIconAtlas() {}
+
+clIconAtlas::~clIconAtlas() {}
+
+uint64_t clIconAtlas::ComputeHash(const std::unordered_map<wxString, wxString>& svg_files, double scale)
+{
+    std::vector<wxString> names;
+    names.reserve(svg_files.size());
+    for (const auto& vt : svg_files) {
+        names.push_back(vt.first);
+    }
+    std::sort(names.begin(), names.end());
+
+    // FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    auto update = [&hash](const std::string& str) {
+        for (unsigned char ch : str) {
+            hash ^= ch;
+            hash *= 1099511628211ULL;
+        }
+    };
+
+    update(std::to_string(static_cast<int>(scale * 1000)));
+    for (const auto& name : names) {
+        wxFileName fn{svg_files.at(name)};
+        wxString token;
+        token << name << "|" << fn.GetSize().ToString() << "|" << fn.GetModificationTime().GetTicks() << ";";
+        update(token.ToStdString(wxConvUTF8));
+    }
+    return hash;
+}
+
+wxFileName clIconAtlas::GetAtlasFile(bool dark_theme, double scale)
+{
+    wxString fullname;
+    fullname << "icons-" << (dark_theme ? "dark" : "light") << "-" << static_cast<int>(scale * 100) << ".atlas";
+    wxFileName atlas_file{clStandardPaths::Get().GetUserDataDir(), fullname};
+    atlas_file.AppendDir("cache");
+    return atlas_file;
+}
+
+bool clIconAtlas::Load(const wxFileName& path, uint64_t expected_hash)
+{
+    m_file.reset();
+    m_index.clear();
+    m_pixels = nullptr;
+
+    auto file = std::make_unique<clMappedFile>();
+    if (!file->Open(path.GetFullPath())) {
+        return false;
+    }
+
+    Reader reader{file->GetData(), file->GetSize()};
+    const unsigned char* magic = nullptr;
+    uint64_t hash = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t scale_factor = 0;
+    uint32_t count = 0;
+    if (!reader.ReadBytes(sizeof(ATLAS_MAGIC), &magic) || std::memcmp(magic, ATLAS_MAGIC, sizeof(ATLAS_MAGIC)) != 0 ||
+        !reader.Read(&hash) || !reader.Read(&width) || !reader.Read(&height) || !reader.Read(&scale_factor) ||
+        !reader.Read(&count)) {
+        clWARNING() << "Corrupted icon atlas:" << path.GetFullPath() << endl;
+        return false;
+    }
+
+    if (hash != expected_hash) {
+        clDEBUG() << "Icon atlas" << path.GetFullPath() << "is out of date" << endl;
+        return false;
+    }
+
+    std::unordered_map<wxString, Entry> index;
+    index.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        uint32_t name_len = 0;
+        const unsigned char* name = nullptr;
+        Entry entry;
+        if (!reader.Read(&name_len) || !reader.ReadBytes(name_len, &name) || !reader.Read(&entry.x) ||
+            !reader.Read(&entry.y) || !reader.Read(&entry.width) || !reader.Read(&entry.height) ||
+            entry.x + entry.width > width || entry.y + entry.height > height) {
+            clWARNING() << "Corrupted icon atlas:" << path.GetFullPath() << endl;
+            return false;
+        }
+        index.insert({wxString::FromUTF8(reinterpret_cast<const char*>(name), name_len), entry});
+    }
+
+    const unsigned char* pixels = nullptr;
+    if (!reader.ReadBytes(static_cast<size_t>(width) * height * 4, &pixels)) {
+        clWARNING() << "Corrupted icon atlas:" << path.GetFullPath() << endl;
+        return false;
+    }
+
+    m_file.swap(file);
+    m_index.swap(index);
+    m_pixels = pixels;
+    m_atlasWidth = width;
+    m_scaleFactor = static_cast<double>(scale_factor) / 1000.0;
+    return true;
+}
+
+wxImage clIconAtlas::GetImage(const wxString& name) const
+{
+    auto where = m_index.find(name);
+    if (!IsOk() || where == m_index.end()) {
+        return wxNullImage;
+    }
+
+    const Entry& entry = where->second;
+    size_t pixels_count = static_cast<size_t>(entry.width) * entry.height;
+    // wxImage takes ownership of malloc()ed buffers
+    unsigned char* rgb = static_cast<unsigned char*>(std::malloc(pixels_count * 3));
+    unsigned char* alpha = static_cast<unsigned char*>(std::malloc(pixels_count));
+    for (uint32_t row = 0; row < entry.height; ++row) {
+        const unsigned char* src = m_pixels + (static_cast<size_t>(entry.y + row) * m_atlasWidth + entry.x) * 4;
+        size_t dest = static_cast<size_t>(row) * entry.width;
+        for (uint32_t col = 0; col < entry.width; ++col, src += 4, ++dest) {
+            rgb[dest * 3] = src[0];
+            rgb[dest * 3 + 1] = src[1];
+            rgb[dest * 3 + 2] = src[2];
+            alpha[dest] = src[3];
+        }
+    }
+
+    return wxImage{static_cast<int>(entry.width), static_cast<int>(entry.height), rgb, alpha};
+}
+
+wxBitmap clIconAtlas::GetBitmap(const wxString& name) const
+{
+    wxImage image = GetImage(name);
+    if (!image.IsOk()) {
+        return wxNullBitmap;
+    }
+    wxBitmap bmp{image};
+    bmp.SetScaleFactor(m_scaleFactor);
+    return bmp;
+}
+
+bool clIconAtlas::Build(const wxFileName& path,
+                        uint64_t hash,
+                        double scale_factor,
+                        const std::unordered_map<wxString, wxImage>& images)
+{
+    struct Item {
+        wxString name;
+        const wxImage* image;
+        Entry entry;
+    };
+
+    std::vector<Item> items;
+    items.reserve(images.size());
+    for (const auto& [name, image] : images) {
+        if (image.IsOk()) {
+            items.push_back({name, &image, {}});
+        }
+    }
+
+    // Shelf packing: tallest first, fill rows up to ATLAS_MAX_WIDTH
+    std::sort(items.begin(), items.end(), [](const Item& a, const Item& b) {
+        return a.image->GetHeight() > b.image->GetHeight();
+    });
+
+    uint32_t x = 0;
+    uint32_t y = 0;
+    uint32_t row_height = 0;
+    uint32_t atlas_width = 0;
+    for (auto& item : items) {
+        uint32_t w = item.image->GetWidth();
+        uint32_t h = item.image->GetHeight();
+        if (x > 0 && x + w > ATLAS_MAX_WIDTH) {
+            y += row_height;
+            x = 0;
+            row_height = 0;
+        }
+        item.entry = {x, y, w, h};
+        x += w;
+        row_height = std::max(row_height, h);
+        atlas_width = std::max(atlas_width, x);
+    }
+    uint32_t atlas_height = y + row_height;
+
+    std::vector<unsigned char> pixels(static_cast<size_t>(atlas_width) * atlas_height * 4, 0);
+    for (const auto& item : items) {
+        const unsigned char* rgb = item.image->GetData();
+        const unsigned char* alpha = item.image->HasAlpha() ? item.image->GetAlpha() : nullptr;
+        for (uint32_t row = 0; row < item.entry.height; ++row) {
+            unsigned char* dest = &pixels[(static_cast<size_t>(item.entry.y + row) * atlas_width + item.entry.x) * 4];
+            for (uint32_t col = 0; col < item.entry.width; ++col, dest += 4) {
+                size_t src = static_cast<size_t>(row) * item.entry.width + col;
+                dest[0] = rgb[src * 3];
+                dest[1] = rgb[src * 3 + 1];
+                dest[2] = rgb[src * 3 + 2];
+                dest[3] = alpha ? alpha[src] : 255;
+            }
+        }
+    }
+
+    std::string buffer;
+    buffer.reserve(pixels.size() + items.size() * 64 + 64);
+    buffer.append(ATLAS_MAGIC, sizeof(ATLAS_MAGIC));
+    Append(buffer, hash);
+    Append(buffer, atlas_width);
+    Append(buffer, atlas_height);
+    Append(buffer, static_cast<uint32_t>(scale_factor * 1000));
+    Append(buffer, static_cast<uint32_t>(items.size()));
+    for (const auto& item : items) {
+        std::string name = item.name.ToStdString(wxConvUTF8);
+        Append(buffer, static_cast<uint32_t>(name.size()));
+        buffer.append(name);
+        Append(buffer, item.entry.x);
+        Append(buffer, item.entry.y);
+        Append(buffer, item.entry.width);
+        Append(buffer, item.entry.height);
+    }
+    buffer.append(reinterpret_cast<const char*>(pixels.data()), pixels.size());
+
+    if (!path.DirExists()) {
+        path.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    }
+    return FileUtils::WriteFileContentRaw(path, buffer);
+}
@@ -0,0 +1,86 @@
+#ifndef CLICONATLAS_HPP
+#define CLICONATLAS_HPP
+
+#include "codelite_exports.h"
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <wx/bitmap.h>
+#include <wx/filename.h>
+#include <wx/image.h>
+#include <wx/string.h>
+
+class clMappedFile;
+
+/**
+ * @brief a cache of pre-rasterized icons. All the icons of a theme, rasterized for a given DPI scale, are packed into
+ * a single RGBA image stored on disk together with a name -> rectangle index. At startup, the file is memory mapped
+ * and bitmaps are created only when requested.
+ *
+ * The atlas is tagged with a hash of the source SVG set (see `ComputeHash()`), a mismatching atlas is ignored.
+ */
+class WXDLLIMPEXP_SDK clIconAtlas
+{
+public:
+    struct Entry {
+        uint32_t x{0};
+        uint32_t y{0};
+        uint32_t width{0};
+        uint32_t height{0};
+    };
+
+    clIconAtlas();
+    ~clIconAtlas();
+
+    /**
+     * @brief hash the SVG set (names, sizes and modification times) together with the scale factor
+     */
+    static uint64_t ComputeHash(const std::unordered_map<wxString, wxString>& svg_files, double scale);
+
+    /**
+     * @brief return the atlas file path for a theme and DPI scale
+     */
+    static wxFileName GetAtlasFile(bool dark_theme, double scale);
+
+    /**
+     * @brief map the atlas file. Return false if the file does not exist, is corrupted or was not created from the
+     * SVG set identified by `expected_hash`
+     */
+    bool Load(const wxFileName& path, uint64_t expected_hash);
+
+    /**
+     * @brief pack `images`, rasterized for `scale_factor`, into a new atlas file. The file is written atomically.
+     * It does not use any GUI object: it can run on a worker thread
+     */
+    static bool Build(const wxFileName& path,
+                      uint64_t hash,
+                      double scale_factor,
+                      const std::unordered_map<wxString, wxImage>& images);
+
+    bool IsOk() const { return m_file != nullptr; }
+    bool Contains(const wxString& name) const { return m_index.count(name) > 0; }
+    size_t GetCount() const { return m_index.size(); }
+
+    double GetScaleFactor() const { return m_scaleFactor; }
+
+    /**
+     * @brief create an image from the atlas. Return `wxNullImage` if `name` is not part of it
+     */
+    wxImage GetImage(const wxString& name) const;
+
+    /**
+     * @brief create a bitmap from the atlas. Return `wxNullBitmap` if `name` is not part of it
+     */
+    wxBitmap GetBitmap(const wxString& name) const;
+
+private:
+    std::unique_ptr<clMappedFile> m_file;
+    std::unordered_map<wxString, Entry> m_index;
+    const unsigned char* m_pixels{nullptr};
+    uint32_t m_atlasWidth{0};
+    double m_scaleFactor{1.0};
+};
+
+#endif // CLICONATLAS_HPP
@@ -0,0 +1,131 @@
+#include "clLazyTabs.hpp"
+
+#include "file_logger.h"
+
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+namespace
+{
+constexpr size_t PREFETCH_BUFFER_SIZE = 64 * 1024;
+constexpr wxFileOffset MAX_PREFETCH_FILE_SIZE = 16 * 1024 * 1024; // don't push other files out of the cache
+
+wxString GetKey(const wxString& filename)
+{
+    wxString key = wxFileName(filename).GetFullPath();
+#ifdef __WXMSW__
+    key.MakeLower();
+    key.Replace("\\", "/");
+#endif
+    return key;
+}
+
+/// read `filename` and drop the content, so the next read comes from the OS cache
+bool ReadFile(const wxString& filename, const std::atomic_bool& stop)
+{
+    wxLogNull noLog;
+    wxFFile fp(filename, "rb");
+    if (!fp.IsOpened() || fp.Length() > MAX_PREFETCH_FILE_SIZE) {
+        return false;
+    }
+
+    std::vector<char> buffer(PREFETCH_BUFFER_SIZE);
+    while (!stop.load() && fp.Read(buffer.data(), buffer.size()) == buffer.size()) {
+    }
+    return !stop.load();
+}
+} // namespace
+
+clLazyTabs::~clLazyTabs() { StopPrefetch(); }
+
+void clLazyTabs::Restore(const std::vector<TabInfo>& tabs, size_t selected, const AddPageFunc& addPage)
+{
+    StopPrefetch();
+    for (size_t i = 0; i < tabs.size(); ++i) {
+        bool pending = i != selected;
+        if (pending) {
+            m_pending.insert({GetKey(tabs[i].GetFileName()), tabs[i]});
+        }
+        addPage(tabs[i], pending);
+    }
+
+    // the tabs next to the selected one are the most likely to be opened next: read them first
+    size_t origin = selected < tabs.size() ? selected : 0;
+    std::vector<wxString> files;
+    files.reserve(m_pending.size());
+    if (origin < tabs.size() && IsPending(tabs[origin].GetFileName())) {
+        files.push_back(tabs[origin].GetFileName());
+    }
+    for (size_t distance = 1; distance < tabs.size(); ++distance) {
+        for (size_t i : {origin + distance, origin - distance}) {
+            if (i < tabs.size() && IsPending(tabs[i].GetFileName())) {
+                files.push_back(tabs[i].GetFileName());
+            }
+        }
+    }
+    StartPrefetch(std::move(files));
+}
+
+bool clLazyTabs::IsPending(const wxString& filename) const { return Find(filename) != nullptr; }
+
+const TabInfo* clLazyTabs::Find(const wxString& filename) const
+{
+    if (m_pending.empty()) {
+        return nullptr;
+    }
+    auto iter = m_pending.find(GetKey(filename));
+    return iter == m_pending.end() ? nullptr : &iter->second;
+}
+
+bool clLazyTabs::Take(const wxString& filename, TabInfo& tab)
+{
+    auto iter = m_pending.find(GetKey(filename));
+    if (iter == m_pending.end()) {
+        return false;
+    }
+    tab = std::move(iter->second);
+    m_pending.erase(iter);
+    return true;
+}
+
+void clLazyTabs::Remove(const wxString& filename) { m_pending.erase(GetKey(filename)); }
+
+void clLazyTabs::Clear()
+{
+    StopPrefetch();
+    m_pending.clear();
+}
+
+void clLazyTabs::WaitForPrefetch()
+{
+    if (m_prefetchThread.joinable()) {
+        m_prefetchThread.join();
+    }
+}
+
+void clLazyTabs::StartPrefetch(std::vector<wxString> files)
+{
+    m_stopPrefetch.store(false);
+    m_prefetched.store(0);
+    if (files.empty()) {
+        return;
+    }
+
+    m_prefetchThread = std::thread([this, files = std::move(files)]() {
+        for (const auto& file : files) {
+            if (m_stopPrefetch.load()) {
+                break;
+            }
+            if (ReadFile(file, m_stopPrefetch)) {
+                ++m_prefetched;
+            }
+        }
+        clDEBUG1() << "Session restore: read" << m_prefetched.load() << "of" << files.size() << "files" << clEndl;
+    });
+}
+
+void clLazyTabs::StopPrefetch()
+{
+    m_stopPrefetch.store(true);
+    WaitForPrefetch();
+}
@@ -0,0 +1,63 @@
+#ifndef CLLAZYTABS_HPP
+#define CLLAZYTABS_HPP
+
+#include "codelite_exports.h"
+#include "serialized_object.h"
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief the tabs of a restored session that were not loaded yet.
+ *
+ * On restore, only the selected tab is opened: the other tabs are added as placeholder pages that keep their
+ * TabInfo here until they are first needed. Meanwhile, a worker thread reads their files, so they are in the OS
+ * cache when that happens.
+ */
+class WXDLLIMPEXP_SDK clLazyTabs
+{
+public:
+    /// add a page for `tab`. `pending` is false for the selected tab, which should be loaded right away
+    using AddPageFunc = std::function<void(const TabInfo& tab, bool pending)>;
+
+public:
+    clLazyTabs() = default;
+    ~clLazyTabs();
+
+    /**
+     * @brief add the pages of a session, in order, and start reading the files of the pending tabs
+     */
+    void Restore(const std::vector<TabInfo>& tabs, size_t selected, const AddPageFunc& addPage);
+
+    bool IsPending(const wxString& filename) const;
+    const TabInfo* Find(const wxString& filename) const;
+
+    /**
+     * @brief the tab of `filename` is being loaded: remove it from the pending tabs and return its state
+     */
+    bool Take(const wxString& filename, TabInfo& tab);
+    void Remove(const wxString& filename);
+    void Clear();
+    size_t GetPendingCount() const { return m_pending.size(); }
+
+    /**
+     * @brief wait until the worker thread is done reading the files
+     */
+    void WaitForPrefetch();
+    size_t GetPrefetchedCount() const { return m_prefetched.load(); }
+
+private:
+    void StartPrefetch(std::vector<wxString> files);
+    void StopPrefetch();
+
+    std::unordered_map<wxString, TabInfo> m_pending;
+    std::thread m_prefetchThread;
+    std::atomic_bool m_stopPrefetch{false};
+    std::atomic_size_t m_prefetched{0};
+};
+
+#endif // CLLAZYTABS_HPP
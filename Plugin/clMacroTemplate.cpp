@@ -0,0 +1,159 @@
+#include "clMacroTemplate.hpp"
+
+#include <mutex>
+
+namespace
+{
+constexpr size_t MAX_CACHED_TEMPLATES = 1000;
+
+std::mutex s_cacheMutex;
+std::unordered_map<wxString, clMacroTemplate::ptr_t> s_cache;
+
+inline bool IsMacroChar(wxUniChar ch)
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+}
+} // namespace
+
+void clMacroVariables::Add(const wxString& name, const wxString& value)
+{
+    Entry entry;
+    entry.order = m_count++;
+    entry.value = value;
+    m_entries[name].push_back(std::move(entry));
+}
+
+void clMacroVariables::AddLazy(const wxString& name, LazyValue value)
+{
+    Entry entry;
+    entry.order = m_count++;
+    entry.lazy = std::move(value);
+    m_entries[name].push_back(std::move(entry));
+}
+
+void clMacroVariables::Append(const clMacroVariables& other)
+{
+    for (const auto& [name, entries] : other.m_entries) {
+        auto& list = m_entries[name];
+        for (auto entry : entries) {
+            entry.order += m_count;
+            list.push_back(std::move(entry));
+        }
+    }
+    m_count += other.m_count;
+}
+
+const wxString* clMacroVariables::Find(const wxString& name, size_t min_order, size_t& order) const
+{
+    auto iter = m_entries.find(name);
+    if (iter == m_entries.end()) {
+        return nullptr;
+    }
+
+    for (const auto& entry : iter->second) {
+        if (entry.order < min_order) {
+            continue;
+        }
+        if (entry.lazy) {
+            entry.value = entry.lazy();
+            entry.lazy = nullptr;
+        }
+        order = entry.order;
+        return &entry.value;
+    }
+    return nullptr;
+}
+
+clMacroTemplate::clMacroTemplate(const wxString& source)
+{
+    auto add_literal = [this](wxString::const_iterator from, wxString::const_iterator to) {
+        if (from != to) {
+            wxString literal(from, to);
+            m_literalLength += literal.length();
+            m_segments.push_back({literal, false});
+        }
+    };
+
+    auto literal_start = source.begin();
+    auto iter = source.begin();
+    while (iter != source.end()) {
+        if (*iter != '$' || (iter + 1) == source.end() || *(iter + 1) != '(') {
+            ++iter;
+            continue;
+        }
+
+        // $(Name)
+        auto name_start = iter + 2;
+        auto name_end = name_start;
+        while (name_end != source.end() && IsMacroChar(*name_end)) {
+            ++name_end;
+        }
+
+        if (name_end == name_start || name_end == source.end() || *name_end != ')') {
+            ++iter;
+            continue;
+        }
+
+        add_literal(literal_start, iter);
+        wxString name(name_start, name_end);
+        m_macros.insert(name);
+        m_segments.push_back({name, true});
+        iter = literal_start = name_end + 1;
+    }
+    add_literal(literal_start, source.end());
+}
+
+clMacroTemplate::ptr_t clMacroTemplate::Compile(const wxString& source)
+{
+    std::lock_guard lock{s_cacheMutex};
+    auto iter = s_cache.find(source);
+    if (iter != s_cache.end()) {
+        return iter->second;
+    }
+
+    if (s_cache.size() >= MAX_CACHED_TEMPLATES) {
+        s_cache.clear();
+    }
+    auto compiled = std::make_shared<const clMacroTemplate>(source);
+    s_cache.insert({source, compiled});
+    return compiled;
+}
+
+void clMacroTemplate::ClearCache()
+{
+    std::lock_guard lock{s_cacheMutex};
+    s_cache.clear();
+}
+
+wxString clMacroTemplate::Expand(const clMacroVariables& variables) const
+{
+    wxString output;
+    output.reserve(m_literalLength * 2);
+    DoExpand(variables, 0, output);
+    return output;
+}
+
+void clMacroTemplate::DoExpand(const clMacroVariables& variables, size_t min_order, wxString& output) const
+{
+    for (const auto& segment : m_segments) {
+        if (!segment.is_macro) {
+            output << segment.text;
+            continue;
+        }
+
+        size_t order = 0;
+        const wxString* value = variables.Find(segment.text, min_order, order);
+        if (!value) {
+            output << "$(" << segment.text << ")";
+            continue;
+        }
+
+        if (value->Find("$(") == wxNOT_FOUND) {
+            output << *value;
+        } else {
+            // macros in the value are replaced by the variables that come after this one
+            clMacroTemplate nested(*value);
+            nested.DoExpand(variables, order + 1, output);
+        }
+    }
+}
@@ -0,0 +1,87 @@
+#ifndef CLMACROTEMPLATE_HPP
+#define CLMACROTEMPLATE_HPP
+
+#include "codelite_exports.h"
+#include "macros.h"
+
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @brief the values of the $(Name) macros for one expansion context (workspace, project, configuration, editor).
+ *
+ * Values are kept in the order they are added: a macro found inside a value is only replaced by a variable added
+ * after it, which is what a chain of wxString::Replace() calls does.
+ */
+class WXDLLIMPEXP_SDK clMacroVariables
+{
+public:
+    using LazyValue = std::function<wxString()>;
+
+    void Add(const wxString& name, const wxString& value);
+    /// `value` is only called if the macro is used
+    void AddLazy(const wxString& name, LazyValue value);
+    /// add the variables of `other` after the ones already added, in their order
+    void Append(const clMacroVariables& other);
+    bool IsEmpty() const { return m_entries.empty(); }
+
+    /**
+     * @brief find the first value of `name` added at position `min_order` or later
+     * @param [out] order the position of the value
+     */
+    const wxString* Find(const wxString& name, size_t min_order, size_t& order) const;
+
+private:
+    struct Entry {
+        size_t order = 0;
+        mutable wxString value;
+        mutable LazyValue lazy;
+    };
+    std::unordered_map<wxString, std::vector<Entry>> m_entries;
+    size_t m_count = 0;
+};
+
+/**
+ * @brief a string compiled into literal text and $(Name) macro segments, so it can be expanded in a single pass
+ */
+class WXDLLIMPEXP_SDK clMacroTemplate
+{
+public:
+    using ptr_t = std::shared_ptr<const clMacroTemplate>;
+
+    struct Segment {
+        wxString text; ///< the literal text, or the macro name
+        bool is_macro = false;
+    };
+
+public:
+    explicit clMacroTemplate(const wxString& source);
+    ~clMacroTemplate() = default;
+
+    /**
+     * @brief compile `source`, compiled templates are cached by their source string
+     */
+    static ptr_t Compile(const wxString& source);
+    static void ClearCache();
+
+    const std::vector<Segment>& GetSegments() const { return m_segments; }
+    bool HasMacros() const { return !m_macros.empty(); }
+    bool HasMacro(const wxString& name) const { return m_macros.count(name) != 0; }
+
+    /**
+     * @brief replace the macros with their values from `variables`. Unknown macros are kept as they are
+     */
+    wxString Expand(const clMacroVariables& variables) const;
+
+private:
+    void DoExpand(const clMacroVariables& variables, size_t min_order, wxString& output) const;
+
+    std::vector<Segment> m_segments;
+    wxStringSet_t m_macros;
+    size_t m_literalLength = 0;
+};
+
+#endif // CLMACROTEMPLATE_HPP
@@ -10,6 +10,7 @@
 #define TRACE_TAB _("Trace")
 #define SHOW_USAGE _("References")
 #define TERMINAL_TAB _("Terminal")
+#define PERFORMANCE_TAB _("Performance")
 
 // Panes
 #define PANE_LEFT_SIDEBAR wxT("Workspace View")
@@ -47,6 +47,8 @@
 #define INDICATOR_HYPERLINK 4
 #define INDICATOR_FIND_BAR_WORD_HIGHLIGHT 5
 #define INDICATOR_CONTEXT_WORD_HIGHLIGHT 6
+#define INDICATOR_STATIC_ANALYSIS_WARNING 7
+#define INDICATOR_STATIC_ANALYSIS_ERROR 8
 
 struct WXDLLIMPEXP_SDK WordSetIndex {
     int index = wxNOT_FOUND;
@@ -28,8 +28,11 @@
 #include "FileSystemWorkspace/clFileSystemWorkspace.hpp"
 #include "IWorkspace.h"
 #include "build_config.h"
+#include "clMacroTemplate.hpp"
 #include "clWorkspaceManager.h"
+#include "codelite_events.h"
 #include "environmentconfig.h"
+#include "event_notifier.h"
 #include "fileutils.h"
 #include "globals.h"
 #include "imanager.h"
@@ -37,7 +40,10 @@
 #include "ssh_account_info.h"
 #include "workspace.h"
 
-#include <wx/regex.h>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 MacroManager* MacroManager::Instance()
 {
@@ -45,328 +51,609 @@ MacroManager* MacroManager::Instance()
     return &ms_instance;
 }
 
+MacroManager::MacroManager()
+{
+    // the cached project variables are computed from the workspace, the project settings and the compilers
+    auto clear_cache = [this](wxEvent& event) {
+        event.Skip();
+        ClearCache();
+    };
+    EventNotifier::Get()->Bind(wxEVT_WORKSPACE_LOADED, clear_cache);
+    EventNotifier::Get()->Bind(wxEVT_WORKSPACE_CLOSED, clear_cache);
+    EventNotifier::Get()->Bind(wxEVT_WORKSPACE_CONFIG_CHANGED, clear_cache);
+    EventNotifier::Get()->Bind(wxEVT_WORKSPACE_BUILD_CONFIG_CHANGED, clear_cache);
+    EventNotifier::Get()->Bind(wxEVT_CMD_PROJ_SETTINGS_SAVED, clear_cache);
+    EventNotifier::Get()->Bind(wxEVT_PROJ_ADDED, clear_cache);
+    EventNotifier::Get()->Bind(wxEVT_PROJ_REMOVED, clear_cache);
+    EventNotifier::Get()->Bind(wxEVT_PROJ_RENAMED, clear_cache);
+    EventNotifier::Get()->Bind(wxEVT_COMPILER_LIST_UPDATED, clear_cache);
+}
+
 wxString MacroManager::Expand(const wxString& expression,
                               IManager* manager,
                               const wxString& project,
                               const wxString& confToBuild)
 { return DoExpand(expression, manager, project, true, confToBuild); }
 
-bool MacroManager::FindVariable(const wxString& inString, wxString& name, wxString& fullname)
+namespace
 {
-    size_t flags = wxRE_DEFAULT | wxRE_ICASE;
-
-    wxString strRe1;
-    wxString strRe2;
-    wxString strRe3;
-    wxString strRe4;
-
-    strRe1 << "\\$\\(("
-           << "[a-z_0-9]+"
-           << ")\\)";
-    strRe2 << "\\$\\{("
-           << "[a-z_0-9]+"
-           << ")\\}";
-    strRe3 << "\\$("
-           << "[a-z_0-9]+"
-           << ")";
-    strRe4 << "%("
-           << "[a-z_0-9]+"
-           << ")%";
-
-    wxRegEx reOne(strRe1, flags);   // $(variable)
-    wxRegEx reTwo(strRe2, flags);   // ${variable}
-    wxRegEx reThree(strRe3, flags); // $variable
-    wxRegEx reFour(strRe4, flags);  // %variable%
-
-    if (reOne.Matches(inString)) {
-        name = reOne.GetMatch(inString, 1);
-        fullname = reOne.GetMatch(inString);
-        return true;
-    }
-
-    if (reTwo.Matches(inString)) {
-        name = reTwo.GetMatch(inString, 1);
-        fullname = reTwo.GetMatch(inString);
-        return true;
-    }
+inline bool IsVariableChar(wxUniChar ch)
+{
+    return (ch >= 'a' && ch <= 'z') || (ch >= 'A' && ch <= 'Z') || (ch >= '0' && ch <= '9') || ch == '_';
+}
 
-    if (reThree.Matches(inString)) {
-        name = reThree.GetMatch(inString, 1);
-        fullname = reThree.GetMatch(inString);
-        return true;
-    }
+/// find the first `open` + name + `close` in `str`
+bool FindVariableOfType(
+    const wxString& str, const wxString& open, const wxString& close, wxString& name, wxString& fullname)
+{
+    size_t pos = str.find(open);
+    while (pos != wxString::npos) {
+        size_t name_start = pos + open.length();
+        size_t name_end = name_start;
+        while (name_end < str.length() && IsVariableChar(str[name_end])) {
+            ++name_end;
+        }
 
-    if (reFour.Matches(inString)) {
-        name = reFour.GetMatch(inString, 1);
-        fullname = reFour.GetMatch(inString);
-        return true;
+        if (name_end > name_start && str.compare(name_end, close.length(), close) == 0) {
+            name = str.Mid(name_start, name_end - name_start);
+            fullname = str.Mid(pos, name_end + close.length() - pos);
+            return true;
+        }
+        pos = str.find(open, pos + 1);
     }
     return false;
 }
-
-namespace
-{
-// the below list are macros supported by CodeLite
-const std::unordered_set<wxString> CODELITE_MACROS = {
-    "WorkspaceName",
-    "WorkspaceConfiguration",
-    "WorkspacePath",
-    "WorkspaceRealPath",
-    "OutputDirectory",
-    "ProjectOutputFile",
-    "OutputFile",
-    "ProjectWorkingDirectory",
-    "ProjectRunWorkingDirectory",
-    "ProjectPath",
-    "ProjectName",
-    "IntermediateDirectory",
-    "ConfigurationName",
-    "OutDir",
-    "ProjectFiles",
-    "ProjectFilesAbs",
-    "CurrentFileName",
-    "CurrentFilePath",
-    "CurrentFileExt",
-    "CurrentFileFullName",
-    "CurrentFileFullPath",
-    "CurrentFileRelPath",
-    "CurrentSelection",
-    "CurrentSelectionRange",
-    "Program",
-    "User",
-    "Date",
-    "Year",
-    "CodeLitePath",
-    "CC",
-    "CFLAGS",
-    "CXX",
-    "CXXFLAGS",
-    "LDFLAGS",
-    "AS",
-    "ASFLAGS",
-    "RES",
-    "RESFLAGS",
-    "AR",
-    "MAKE",
-    "IncludePath",
-    "LibraryPath",
-    "ResourcePath",
-    "LinkLibraries",
-    "SSH_AccountName",
-    "SSH_Host",
-    "SSH_User",
-};
 } // namespace
 
-wxString MacroManager::ExpandNoEnv(const wxString& expression, const wxString& project, const wxString& confToBuild)
-{ return DoExpand(expression, NULL, project, false, confToBuild); }
-
-wxString MacroManager::DoExpand(
-    const wxString& expression, IManager* manager, const wxString& project, bool applyEnv, const wxString& confToBuild)
+bool MacroManager::FindVariable(const wxString& inString, wxString& name, wxString& fullname)
 {
-    wxString expandedString(expression);
-    clCxxWorkspace* workspace = nullptr;
-
-    if (!manager) {
-        manager = clGetManager();
-    }
+    // the forms are searched in this order, the first form found wins (not the first variable in the string)
+    return FindVariableOfType(inString, "$(", ")", name, fullname) ||           // $(variable)
+           FindVariableOfType(inString, "${", "}", name, fullname) ||           // ${variable}
+           FindVariableOfType(inString, "$", wxEmptyString, name, fullname) || // $variable
+           FindVariableOfType(inString, "%", "%", name, fullname);              // %variable%
+}
 
+namespace
+{
+/// what the values of the CodeLite macros are computed from
+struct MacroContext {
+    IManager* manager = nullptr;
+    bool applyEnv = false;
+    IWorkspace* workspace = nullptr;
+    clCxxWorkspace* cxxWorkspace = nullptr;
     wxString wspName;
     wxString wspConfig;
     wxString wspPath;
-    wxString program_to_run;
-
-    // ssh macros
-    wxString ssh_host;
-    wxString account_name;
-    wxString ssh_user;
-
-    auto w = clWorkspaceManager::Get().GetWorkspace();
-    if (w && w->IsRemote()) {
-        wxString ssh_account = w->GetSshAccount();
-        auto account = SSHAccountInfo::LoadAccount(ssh_account);
-        ssh_host = account.GetHost();
-        account_name = ssh_account;
-        ssh_user = account.GetUsername();
-    }
-
-    if (clCxxWorkspaceST::Get()->IsOpen()) {
-        wspName = clCxxWorkspaceST::Get()->GetName();
-        wspConfig = clCxxWorkspaceST::Get()->GetSelectedConfig()
-                        ? clCxxWorkspaceST::Get()->GetSelectedConfig()->GetName()
-                        : wxString();
-        wspPath = clCxxWorkspaceST::Get()->GetDir();
-        workspace = clCxxWorkspaceST::Get();
-    } else if (clFileSystemWorkspace::Get().IsOpen()) {
-        wspName = clFileSystemWorkspace::Get().GetName();
-        if (clFileSystemWorkspace::Get().GetSettings().GetSelectedConfig()) {
-            program_to_run = clFileSystemWorkspace::Get().GetSettings().GetSelectedConfig()->GetExecutable();
-            wspConfig = clFileSystemWorkspace::Get().GetSettings().GetSelectedConfig()->GetName();
-        }
-        wspPath = clFileSystemWorkspace::Get().GetDir();
-    } else if (clWorkspaceManager::Get().IsWorkspaceOpened()) {
-        wspPath = clWorkspaceManager::Get().GetWorkspace()->GetDir();
-        wspName = clWorkspaceManager::Get().GetWorkspace()->GetName();
-    }
-
-    wxString wspRealPath = FileUtils::RealPath(wspPath, true);
-
-    size_t retries = 0;
-    wxString dummyname;
-    while ((retries < 5) && FindVariable(expandedString, dummyname, dummyname)) {
-        ++retries;
-        DollarEscaper de(expandedString);
-        expandedString.Replace("$(WorkspaceName)", wspName);
-        expandedString.Replace("$(WorkspaceConfiguration)", wspConfig);
-        expandedString.Replace("$(WorkspacePath)", wspPath);
-        expandedString.Replace("$(WorkspaceRealPath)", wspRealPath);
-
-        if (workspace) {
-            ProjectPtr proj = workspace->GetProject(project);
-            if (proj) {
-                wxString prjBuildWd;
-                wxString prjRunWd;
-                wxString project_name(proj->GetName());
-
-                // make sure that the project name does not contain any spaces
-                project_name.Replace(" ", "_");
-
-                BuildConfigPtr bldConf = workspace->GetProjBuildConf(proj->GetName(), confToBuild);
-                if (bldConf) {
-                    bool isCustom = bldConf->IsCustomBuild();
-                    expandedString.Replace("$(OutputDirectory)", bldConf->GetOutputDirectory());
-                    expandedString.Replace("$(ProjectOutputFile)", bldConf->GetOutputFileName());
-                    // An alias
-                    expandedString.Replace("$(OutputFile)", bldConf->GetOutputFileName());
-                    expandedString.Replace("$(Program)", bldConf->GetCommand());
-
-                    // When custom build project, use the working directory set in the
-                    // custom build tab, otherwise use the project file's path
-                    prjBuildWd = isCustom ? bldConf->GetCustomBuildWorkingDir() : proj->GetFileName().GetPath();
-                    prjRunWd = bldConf->GetWorkingDirectory();
-                }
-
-                expandedString.Replace("$(ProjectWorkingDirectory)", prjBuildWd);
-                expandedString.Replace("$(ProjectRunWorkingDirectory)", prjRunWd);
-                expandedString.Replace("$(ProjectPath)", proj->GetFileName().GetPath());
-                expandedString.Replace("$(WorkspacePath)", workspace->GetWorkspaceFileName().GetPath());
-                expandedString.Replace("$(ProjectName)", project_name);
-
-                if (bldConf) {
-                    expandedString.Replace("$(IntermediateDirectory)", bldConf->GetIntermediateDirectory());
-                    expandedString.Replace("$(ConfigurationName)", bldConf->GetName());
-                    expandedString.Replace("$(OutDir)", bldConf->GetIntermediateDirectory());
-
-                    // Compiler-related variables
-                    wxString cFlags = bldConf->GetCCompileOptions();
-                    cFlags.Replace(";", " ");
-                    expandedString.Replace("$(CC)", bldConf->GetCompiler()->GetTool("CC"));
-                    expandedString.Replace("$(CFLAGS)", cFlags);
-
-                    wxString cxxFlags = bldConf->GetCompileOptions();
-                    cxxFlags.Replace(";", " ");
-                    expandedString.Replace("$(CXX)", bldConf->GetCompiler()->GetTool("CXX"));
-                    expandedString.Replace("$(CXXFLAGS)", cxxFlags);
+    wxString programToRun;
+    wxString sshAccount;
+    wxString sshHost;
+    wxString sshUser;
+
+    // the project part, set only if the project variables are not cached
+    ProjectPtr proj;
+    BuildConfigPtr bldConf;
+
+    IEditor* editor = nullptr;
+    wxFileName file; ///< the file of the active editor
+    wxDateTime now;
+};
 
-                    wxString ldFlags = bldConf->GetLinkOptions();
-                    ldFlags.Replace(";", " ");
-                    expandedString.Replace("$(LDFLAGS)", ldFlags);
+enum class MacroScope {
+    kContext, ///< computed on every expansion
+    kProject, ///< depends on the project and its build configuration only: cached
+};
 
-                    wxString asFlags = bldConf->GetAssemblerOptions();
-                    asFlags.Replace(";", " ");
-                    expandedString.Replace("$(AS)", bldConf->GetCompiler()->GetTool("AS"));
-                    expandedString.Replace("$(ASFLAGS)", asFlags);
+struct MacroDefinition {
+    wxString name;
+    MacroScope scope;
+    void (*add)(const MacroContext& ctx, const wxString& name, clMacroVariables& variables);
+};
 
-                    wxString resFlags = bldConf->GetResCompileOptions();
-                    resFlags.Replace(";", " ");
-                    expandedString.Replace("$(RES)", bldConf->GetCompiler()->GetTool("ResourceCompiler"));
-                    expandedString.Replace("$(RESFLAGS)", resFlags);
+wxString ToSpaces(wxString options)
+{
+    options.Replace(";", " ");
+    return options;
+}
 
-                    expandedString.Replace("$(AR)", bldConf->GetCompiler()->GetTool("AR"));
+/// the CodeLite macros, in the order their values are added (and used to be replaced): a value may use the macros
+/// that come after it
+const std::vector<MacroDefinition>& GetMacroDefinitions()
+{
+    using Scope = MacroScope;
+    using Vars = clMacroVariables;
+    using Ctx = MacroContext;
+    static const std::vector<MacroDefinition> definitions = {
+        {"WorkspaceName", Scope::kContext, [](const Ctx& c, const wxString& n, Vars& v) { v.Add(n, c.wspName); }},
+        {"WorkspaceConfiguration",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) { v.Add(n, c.wspConfig); }},
+        {"WorkspacePath", Scope::kContext, [](const Ctx& c, const wxString& n, Vars& v) { v.Add(n, c.wspPath); }},
+        {"WorkspaceRealPath",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             v.AddLazy(n, [path = c.wspPath]() { return FileUtils::RealPath(path, true); });
+         }},
+
+        // the project and its build configuration
+        {"OutputDirectory",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetOutputDirectory());
+             }
+         }},
+        {"ProjectOutputFile",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetOutputFileName());
+             }
+         }},
+        // an alias
+        {"OutputFile",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetOutputFileName());
+             }
+         }},
+        {"Program",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetCommand());
+             }
+         }},
+        // when custom build project, use the working directory set in the custom build tab, otherwise use the
+        // project file's path
+        {"ProjectWorkingDirectory",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             wxString wd;
+             if (c.bldConf) {
+                 wd = c.bldConf->IsCustomBuild() ? c.bldConf->GetCustomBuildWorkingDir()
+                                                 : c.proj->GetFileName().GetPath();
+             }
+             v.Add(n, wd);
+         }},
+        {"ProjectRunWorkingDirectory",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             v.Add(n, c.bldConf ? c.bldConf->GetWorkingDirectory() : wxString());
+         }},
+        {"ProjectPath",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) { v.Add(n, c.proj->GetFileName().GetPath()); }},
+        {"WorkspacePath",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             v.Add(n, c.cxxWorkspace->GetWorkspaceFileName().GetPath());
+         }},
+        {"ProjectName",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             // make sure that the project name does not contain any spaces
+             wxString project_name(c.proj->GetName());
+             project_name.Replace(" ", "_");
+             v.Add(n, project_name);
+         }},
+        {"IntermediateDirectory",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetIntermediateDirectory());
+             }
+         }},
+        {"ConfigurationName",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetName());
+             }
+         }},
+        {"OutDir",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetIntermediateDirectory());
+             }
+         }},
+
+        // compiler-related variables
+        {"CC",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetCompiler()->GetTool("CC"));
+             }
+         }},
+        {"CFLAGS",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, ToSpaces(c.bldConf->GetCCompileOptions()));
+             }
+         }},
+        {"CXX",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetCompiler()->GetTool("CXX"));
+             }
+         }},
+        {"CXXFLAGS",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, ToSpaces(c.bldConf->GetCompileOptions()));
+             }
+         }},
+        {"LDFLAGS",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, ToSpaces(c.bldConf->GetLinkOptions()));
+             }
+         }},
+        {"AS",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetCompiler()->GetTool("AS"));
+             }
+         }},
+        {"ASFLAGS",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, ToSpaces(c.bldConf->GetAssemblerOptions()));
+             }
+         }},
+        {"RES",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetCompiler()->GetTool("ResourceCompiler"));
+             }
+         }},
+        {"RESFLAGS",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, ToSpaces(c.bldConf->GetResCompileOptions()));
+             }
+         }},
+        {"AR",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetCompiler()->GetTool("AR"));
+             }
+         }},
+        {"MAKE",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetCompiler()->GetTool("MAKE"));
+             }
+         }},
+        {"IncludePath",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetIncludePath());
+             }
+         }},
+        {"LibraryPath",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetLibPath());
+             }
+         }},
+        {"ResourcePath",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetResCmpIncludePath());
+             }
+         }},
+        {"LinkLibraries",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.bldConf) {
+                 v.Add(n, c.bldConf->GetLibraries());
+             }
+         }},
+        {"ProjectFiles",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             v.AddLazy(n, [proj = c.proj]() { return proj->GetFilesAsString(false); });
+         }},
+        {"ProjectFilesAbs",
+         Scope::kProject,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             v.AddLazy(n, [proj = c.proj]() { return proj->GetFilesAsString(true); });
+         }},
+
+        // the executable of the file system workspace
+        {"Program",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (!c.programToRun.empty()) {
+                 v.Add(n, c.programToRun);
+             }
+         }},
+
+        // the active editor
+        {"CurrentFileName",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.editor) {
+                 v.Add(n, c.file.GetName());
+             }
+         }},
+        {"CurrentFilePath",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.editor) {
+                 wxString fpath = c.file.GetPath();
+                 fpath.Replace("\\", "/");
+                 v.Add(n, fpath);
+             }
+         }},
+        {"CurrentFileExt",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.editor) {
+                 v.Add(n, c.file.GetExt());
+             }
+         }},
+        {"CurrentFileFullName",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.editor) {
+                 v.Add(n, c.file.GetFullName());
+             }
+         }},
+        {"CurrentFileRelPath",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (!c.editor) {
+                 return;
+             }
+             wxFileName fn = c.file;
+             wxString rel_path = fn.GetFullPath();
+             if (c.workspace) {
+                 fn.MakeRelativeTo(c.workspace->GetDir());
+                 rel_path = fn.GetFullPath(c.workspace->IsRemote() ? wxPATH_UNIX : wxPATH_NATIVE);
+             }
+             v.Add(n, rel_path);
+         }},
+        {"CurrentFileFullPath",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.editor) {
+                 wxString ffullpath = c.file.GetFullPath();
+                 ffullpath.Replace("\\", "/");
+                 v.Add(n, ffullpath);
+             }
+         }},
+        {"CurrentSelection",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.editor) {
+                 v.AddLazy(n, [editor = c.editor]() { return editor->GetSelection(); });
+             }
+         }},
+        {"CurrentSelectionRange",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.editor) {
+                 v.AddLazy(n, [editor = c.editor]() {
+                     return wxString::Format("%i:%i", editor->GetSelectionStart(), editor->GetSelectionEnd());
+                 });
+             }
+         }},
+
+        // common macros
+        {"User", Scope::kContext, [](const Ctx&, const wxString& n, Vars& v) { v.Add(n, wxGetUserId()); }},
+        {"Date", Scope::kContext, [](const Ctx& c, const wxString& n, Vars& v) { v.Add(n, c.now.FormatDate()); }},
+        {"Year",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             v.Add(n, StringUtils::wxIntToString(c.now.GetCurrentYear()));
+         }},
 
-                    expandedString.Replace("$(MAKE)", bldConf->GetCompiler()->GetTool("MAKE"));
+        // ssh related
+        {"SSH_AccountName",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) { v.Add(n, c.sshAccount); }},
+        {"SSH_Host", Scope::kContext, [](const Ctx& c, const wxString& n, Vars& v) { v.Add(n, c.sshHost); }},
+        {"SSH_User", Scope::kContext, [](const Ctx& c, const wxString& n, Vars& v) { v.Add(n, c.sshUser); }},
+
+        {"CodeLitePath",
+         Scope::kContext,
+         [](const Ctx& c, const wxString& n, Vars& v) {
+             if (c.manager && c.applyEnv) {
+                 v.Add(n, c.manager->GetInstallDirectory());
+             }
+         }},
+    };
+    return definitions;
+}
 
-                    expandedString.Replace("$(IncludePath)", bldConf->GetIncludePath());
-                    expandedString.Replace("$(LibraryPath)", bldConf->GetLibPath());
-                    expandedString.Replace("$(ResourcePath)", bldConf->GetResCmpIncludePath());
-                    expandedString.Replace("$(LinkLibraries)", bldConf->GetLibraries());
-                }
+std::mutex s_projectVariablesMutex;
+std::unordered_map<wxString, std::shared_ptr<const clMacroVariables>> s_projectVariables;
 
-                if (expandedString.Find("$(ProjectFiles)") != wxNOT_FOUND) {
-                    expandedString.Replace("$(ProjectFiles)", proj->GetFilesAsString(false));
-                }
+/// the variables of the project scope, cached per project and build configuration
+std::shared_ptr<const clMacroVariables>
+GetProjectVariables(MacroContext ctx, const wxString& project, const wxString& confToBuild)
+{
+    // without a configuration to build, the configuration selected for the workspace is used
+    wxString key;
+    key << ctx.cxxWorkspace->GetFileName() << "\n" << project << "\n" << confToBuild << "\n" << ctx.wspConfig;
+
+    {
+        std::lock_guard lock{s_projectVariablesMutex};
+        auto iter = s_projectVariables.find(key);
+        if (iter != s_projectVariables.end()) {
+            return iter->second;
+        }
+    }
 
-                if (expandedString.Find("$(ProjectFilesAbs)") != wxNOT_FOUND) {
-                    expandedString.Replace("$(ProjectFilesAbs)", proj->GetFilesAsString(true));
-                }
+    auto variables = std::make_shared<clMacroVariables>();
+    ctx.proj = ctx.cxxWorkspace->GetProject(project);
+    if (ctx.proj) {
+        ctx.bldConf = ctx.cxxWorkspace->GetProjBuildConf(ctx.proj->GetName(), confToBuild);
+        for (const auto& definition : GetMacroDefinitions()) {
+            if (definition.scope == MacroScope::kProject) {
+                definition.add(ctx, definition.name, *variables);
             }
         }
+    }
 
-        if (!program_to_run.empty()) {
-            expandedString.Replace("$(Program)", program_to_run);
-        }
+    std::lock_guard lock{s_projectVariablesMutex};
+    s_projectVariables.insert({key, variables});
+    return variables;
+}
 
-        if (manager) {
-            IEditor* editor = manager->GetActiveEditor();
-            if (editor) {
-                wxFileName fn(editor->GetRemotePathOrLocal());
+// the below list are macros supported by CodeLite
+const std::unordered_set<wxString>& GetCodeLiteMacros()
+{
+    static const std::unordered_set<wxString> macros = []() {
+        std::unordered_set<wxString> names;
+        for (const auto& definition : GetMacroDefinitions()) {
+            names.insert(definition.name);
+        }
+        return names;
+    }();
+    return macros;
+}
+} // namespace
 
-                expandedString.Replace("$(CurrentFileName)", fn.GetName());
+wxString MacroManager::ExpandNoEnv(const wxString& expression, const wxString& project, const wxString& confToBuild)
+{ return DoExpand(expression, NULL, project, false, confToBuild); }
 
-                wxString fpath(fn.GetPath());
+wxString MacroManager::DoExpand(
+    const wxString& expression, IManager* manager, const wxString& project, bool applyEnv, const wxString& confToBuild)
+{
+    wxString expandedString(expression);
+    wxString dummyname;
+    if (!FindVariable(expandedString, dummyname, dummyname)) {
+        return expandedString;
+    }
 
-                // build the relative path
-                wxString rel_path = fn.GetFullPath();
-                if (w) {
-                    wxFileName _f(fn);
-                    _f.MakeRelativeTo(w->GetDir());
-                    rel_path = _f.GetFullPath(w->IsRemote() ? wxPATH_UNIX : wxPATH_NATIVE);
-                }
+    if (!manager) {
+        manager = clGetManager();
+    }
 
-                fpath.Replace("\\", "/");
-                expandedString.Replace("$(CurrentFilePath)", fpath);
-                expandedString.Replace("$(CurrentFileExt)", fn.GetExt());
-                expandedString.Replace("$(CurrentFileFullName)", fn.GetFullName());
-                expandedString.Replace("$(CurrentFileRelPath)", rel_path);
-
-                wxString ffullpath(fn.GetFullPath());
-                ffullpath.Replace("\\", "/");
-                expandedString.Replace("$(CurrentFileFullPath)", ffullpath);
-                expandedString.Replace("$(CurrentSelection)", editor->GetSelection());
-                if (expandedString.Find("$(CurrentSelectionRange)") != wxNOT_FOUND) {
-                    int start = editor->GetSelectionStart(), end = editor->GetSelectionEnd();
-
-                    wxString output = wxString::Format("%i:%i", start, end);
-                    expandedString.Replace("$(CurrentSelectionRange)", output);
-                }
+    // the variables are collected once, on the first pass that needs them
+    clMacroVariables variables;
+    size_t retries = 0;
+    do {
+        ++retries;
+        DollarEscaper de(expandedString);
+        auto compiled = clMacroTemplate::Compile(expandedString);
+        if (compiled->HasMacros()) {
+            if (variables.IsEmpty()) {
+                DoCollectVariables(variables, manager, project, applyEnv, confToBuild);
             }
+            expandedString = compiled->Expand(variables);
         }
 
-        // expand common macros
-        wxDateTime now = wxDateTime::Now();
-        expandedString.Replace("$(User)", wxGetUserId());
-        expandedString.Replace("$(Date)", now.FormatDate());
-        expandedString.Replace("$(Year)", StringUtils::wxIntToString(now.GetCurrentYear()));
-
-        // ssh related
-        expandedString.Replace("$(SSH_AccountName)", account_name);
-        expandedString.Replace("$(SSH_Host)", ssh_host);
-        expandedString.Replace("$(SSH_User)", ssh_user);
-
         if (manager && applyEnv) {
-            expandedString.Replace("$(CodeLitePath)", manager->GetInstallDirectory());
-
             // Apply the environment and expand the variables
             EnvSetter es(NULL, NULL, project, confToBuild);
             expandedString = manager->GetEnv()->ExpandVariables(expandedString, false);
         } else if (applyEnv) {
             expandedString = EnvironmentConfig::Instance()->ExpandVariables(expandedString, false);
         }
-    }
+    } while ((retries < 5) && FindVariable(expandedString, dummyname, dummyname));
     return expandedString;
 }
 
-bool MacroManager::IsCodeLiteMacro(const wxString& macroname) const { return CODELITE_MACROS.count(macroname) != 0; }
+void MacroManager::DoCollectVariables(clMacroVariables& variables,
+                                      IManager* manager,
+                                      const wxString& project,
+                                      bool applyEnv,
+                                      const wxString& confToBuild)
+{
+    MacroContext ctx;
+    ctx.manager = manager;
+    ctx.applyEnv = applyEnv;
+    ctx.workspace = clWorkspaceManager::Get().GetWorkspace();
+    ctx.editor = manager ? manager->GetActiveEditor() : nullptr;
+    if (ctx.editor) {
+        ctx.file = ctx.editor->GetRemotePathOrLocal();
+    }
+    ctx.now = wxDateTime::Now();
+
+    if (ctx.workspace && ctx.workspace->IsRemote()) {
+        ctx.sshAccount = ctx.workspace->GetSshAccount();
+        auto account = SSHAccountInfo::LoadAccount(ctx.sshAccount);
+        ctx.sshHost = account.GetHost();
+        ctx.sshUser = account.GetUsername();
+    }
+
+    if (clCxxWorkspaceST::Get()->IsOpen()) {
+        ctx.cxxWorkspace = clCxxWorkspaceST::Get();
+        ctx.wspName = ctx.cxxWorkspace->GetName();
+        ctx.wspConfig = ctx.cxxWorkspace->GetSelectedConfig() ? ctx.cxxWorkspace->GetSelectedConfig()->GetName()
+                                                              : wxString();
+        ctx.wspPath = ctx.cxxWorkspace->GetDir();
+    } else if (clFileSystemWorkspace::Get().IsOpen()) {
+        ctx.wspName = clFileSystemWorkspace::Get().GetName();
+        if (clFileSystemWorkspace::Get().GetSettings().GetSelectedConfig()) {
+            ctx.programToRun = clFileSystemWorkspace::Get().GetSettings().GetSelectedConfig()->GetExecutable();
+            ctx.wspConfig = clFileSystemWorkspace::Get().GetSettings().GetSelectedConfig()->GetName();
+        }
+        ctx.wspPath = clFileSystemWorkspace::Get().GetDir();
+    } else if (ctx.workspace) {
+        ctx.wspPath = ctx.workspace->GetDir();
+        ctx.wspName = ctx.workspace->GetName();
+    }
+
+    const auto& definitions = GetMacroDefinitions();
+    for (size_t i = 0; i < definitions.size(); ++i) {
+        if (definitions[i].scope == MacroScope::kContext) {
+            definitions[i].add(ctx, definitions[i].name, variables);
+            continue;
+        }
+
+        // the project variables come in one block
+        if (ctx.cxxWorkspace) {
+            variables.Append(*GetProjectVariables(ctx, project, confToBuild));
+        }
+        while (i + 1 < definitions.size() && definitions[i + 1].scope == MacroScope::kProject) {
+            ++i;
+        }
+    }
+}
+
+void MacroManager::ClearCache()
+{
+    std::lock_guard lock{s_projectVariablesMutex};
+    s_projectVariables.clear();
+}
+
+const std::vector<wxString>& MacroManager::GetVariablesOrder()
+{
+    static const std::vector<wxString> order = []() {
+        std::vector<wxString> names;
+        for (const auto& definition : GetMacroDefinitions()) {
+            names.push_back(definition.name);
+        }
+        return names;
+    }();
+    return order;
+}
+
+bool MacroManager::IsCodeLiteMacro(const wxString& macroname) const
+{
+    return GetCodeLiteMacros().count(macroname) != 0;
+}
 
 wxString MacroManager::ExpandFileMacros(const wxString& expression, const wxString& filepath)
 {
@@ -394,14 +681,14 @@ wxString MacroManager::ExpandFileMacros(const wxString& expression, const wxStri
     filedir = fn.GetPath(is_remote ? wxPATH_UNIX : wxPATH_NATIVE);
 
     EnvSetter env;
-    wxString tmp_expr = expression;
-    tmp_expr.Replace("$(CurrentFileName)", fn.GetName());
-    tmp_expr.Replace("$(CurrentFilePath)", filedir);
-    tmp_expr.Replace("$(CurrentFileExt)", fn.GetExt());
-    tmp_expr.Replace("$(CurrentFileFullName)", fullname);
-    tmp_expr.Replace("$(CurrentFileFullPath)", fullpath);
-    tmp_expr.Replace("$(CurrentFileRelPath)", filepath_relative);
-    return tmp_expr;
+    clMacroVariables variables;
+    variables.Add("CurrentFileName", fn.GetName());
+    variables.Add("CurrentFilePath", filedir);
+    variables.Add("CurrentFileExt", fn.GetExt());
+    variables.Add("CurrentFileFullName", fullname);
+    variables.Add("CurrentFileFullPath", fullpath);
+    variables.Add("CurrentFileRelPath", filepath_relative);
+    return clMacroTemplate::Compile(expression)->Expand(variables);
 }
 
 #if 1 // DEPRECATED
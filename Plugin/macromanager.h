@@ -28,16 +28,18 @@
 
 #include "codelite_exports.h"
 
+#include <vector>
 #include <wx/string.h>
 
 class IManager;
+class clMacroVariables;
 class WXDLLIMPEXP_SDK MacroManager
 {
 public:
     static MacroManager* Instance();
 
 private:
-    MacroManager() = default;
+    MacroManager();
     virtual ~MacroManager() = default;
 
     wxString DoExpand(const wxString& expression,
@@ -46,6 +48,13 @@ private:
                       bool applyEnv,
                       const wxString& confToBuild = wxEmptyString);
 
+    /// the values of the CodeLite macros for this project and configuration
+    void DoCollectVariables(clMacroVariables& variables,
+                            IManager* manager,
+                            const wxString& project,
+                            bool applyEnv,
+                            const wxString& confToBuild);
+
 public:
     /*
      * The following macro will be expanded into their real values:
@@ -84,6 +93,18 @@ public:
      */
     wxString ExpandFileMacros(const wxString& expression, const wxString& filepath);
 
+    /**
+     * @brief the CodeLite macros in the order their values are added: a macro found in the value of a variable is
+     * replaced by the variables that come after it. A name may appear more than once
+     */
+    static const std::vector<wxString>& GetVariablesOrder();
+
+    /**
+     * @brief drop the cached project variables. Called when the workspace, its configuration or the project settings
+     * change
+     */
+    void ClearCache();
+
     /**
      * @brief return true if macroname can be resolved as CodeLite internal macro
      */
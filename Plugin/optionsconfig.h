@@ -162,6 +162,7 @@ protected:
     bool m_lineNumberHighlightCurrent = false;
     bool m_showRightMarginIndicator = false;
     int m_rightMarginColumn = 120;
+    int m_largeFileThresholdMB = 50;
 
 public:
     // Helpers
@@ -359,6 +360,9 @@ public:
     void SetRightMarginColumn(int rightMarginColumn) { this->m_rightMarginColumn = rightMarginColumn; }
     bool IsShowRightMarginIndicator() const { return m_showRightMarginIndicator; }
     int GetRightMarginColumn() const { return m_rightMarginColumn; }
+    /// files larger than this are opened without lexing, folding and language server. 0 disables it
+    void SetLargeFileThresholdMB(int largeFileThresholdMB) { this->m_largeFileThresholdMB = largeFileThresholdMB; }
+    int GetLargeFileThresholdMB() const { return m_largeFileThresholdMB; }
     void SetHighlightMatchedBraces(bool highlightMatchedBraces)
     { this->m_highlightMatchedBraces = highlightMatchedBraces; }
     bool GetHighlightMatchedBraces() const { return m_highlightMatchedBraces; }
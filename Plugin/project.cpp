@@ -39,6 +39,7 @@
 #include "macros.h"
 #include "workspace.h"
 #include "wxArrayStringAppender.h"
+#include "xml/clXmlSnapshot.hpp"
 #include "xml/xmlutils.h"
 
 #include <algorithm>
@@ -99,10 +100,22 @@ bool Project::Create(const wxString& name, const wxString& description, const wx
     return true;
 }
 
-bool Project::Load(const wxString& path)
+bool Project::Load(const wxString& path) { return LoadXml(path) && FinishLoad(); }
+
+bool Project::LoadXml(const wxString& path, const wxString& snapshotDir)
 {
-    if (!m_doc.Load(path)) {
-        return false;
+    wxFileName snapshotFile;
+    if (!snapshotDir.empty()) {
+        snapshotFile = clXmlSnapshot::GetSnapshotFile(snapshotDir, path);
+    }
+
+    if (!snapshotFile.IsOk() || !clXmlSnapshot::Load(m_doc, path, snapshotFile)) {
+        if (!m_doc.Load(path)) {
+            return false;
+        }
+        if (snapshotFile.IsOk()) {
+            clXmlSnapshot::Save(m_doc, path, snapshotFile);
+        }
     }
 
     // Workaround WX bug: load the plugins data (GetAllPluginsData will strip any trailing whitespaces)
@@ -114,6 +127,11 @@ bool Project::Load(const wxString& path)
     m_projectPath = m_fileName.GetPath();
 
     DoBuildCacheFromXml();
+    return true;
+}
+
+bool Project::FinishLoad()
+{
     SetModified(true);
     SetProjectLastModifiedTime(GetFileLastModifiedTime());
 
@@ -1319,36 +1337,58 @@ wxString Project::GetCompileLineForCXXFile(const wxStringMap_t& compilersGlobalP
 
 wxString Project::DoExpandBacktick(const wxString& backtick)
 {
-    wxString tmp;
     wxString cmpOption = backtick;
     cmpOption.Trim().Trim(false);
 
+    wxString command;
+    if (!DoStripBacktick(cmpOption, command)) {
+        return cmpOption;
+    }
+
+    // Expand the backticks into their value
+    EnvSetter es(nullptr, nullptr, GetName(), wxEmptyString);
+    command = MacroManager::Instance()->Expand(command, nullptr, GetName(), wxEmptyString);
+    return GetWorkspace()->GetBacktickCache()->Evaluate(command, GetFileName().GetPath());
+}
+
+bool Project::DoStripBacktick(const wxString& option, wxString& command) const
+{
     // Expand backticks / $(shell ...) syntax supported by CodeLite
-    if (cmpOption.StartsWith("$(shell ", &tmp) || cmpOption.StartsWith("`", &tmp)) {
-        cmpOption = tmp;
-        tmp.Clear();
-        if (cmpOption.EndsWith(")", &tmp) || cmpOption.EndsWith("`", &tmp)) {
-            cmpOption = tmp;
-        }
+    wxString tmp;
+    if (!option.StartsWith("$(shell ", &tmp) && !option.StartsWith("`", &tmp)) {
+        return false;
+    }
 
-        // Expand the backticks into their value
-        wxString expandedValue;
-        {
-            EnvSetter es(nullptr, nullptr, GetName(), wxEmptyString);
-            cmpOption = MacroManager::Instance()->Expand(cmpOption, nullptr, GetName(), wxEmptyString);
-
-            // Check the cache
-            if (!GetWorkspace()->GetBacktickValue(cmpOption, expandedValue)) {
-                IProcess::Ptr_t p(::CreateSyncProcess(cmpOption, IProcessCreateDefault, GetFileName().GetPath()));
-                if (p) {
-                    p->WaitForTerminate(expandedValue);
-                }
-                GetWorkspace()->SetBacktickValue(cmpOption, expandedValue);
-            }
-            return expandedValue;
+    command = tmp;
+    tmp.Clear();
+    if (command.EndsWith(")", &tmp) || command.EndsWith("`", &tmp)) {
+        command = tmp;
+    }
+    return true;
+}
+
+size_t Project::GetBacktickRequests(std::vector<clBacktickCache::Request>& requests)
+{
+    BuildConfigPtr buildConf = GetBuildConfiguration();
+    if (!buildConf) {
+        return 0;
+    }
+
+    // the environment applied by GetCompileLineForCXXFile()
+    EnvSetter es(nullptr, nullptr, GetName(), buildConf->GetName());
+    wxArrayString options = ::wxStringTokenize(buildConf->GetCompileOptions(), ";", wxTOKEN_STRTOK);
+    wxArrayString cOptions = ::wxStringTokenize(buildConf->GetCCompileOptions(), ";", wxTOKEN_STRTOK);
+    options.insert(options.end(), cOptions.begin(), cOptions.end());
+
+    for (wxString& option : options) {
+        option.Trim().Trim(false);
+        wxString command;
+        if (DoStripBacktick(option, command)) {
+            command = MacroManager::Instance()->Expand(command, nullptr, GetName(), wxEmptyString);
+            requests.push_back({command, GetFileName().GetPath()});
         }
     }
-    return cmpOption;
+    return clBacktickCache::HashEnvironment();
 }
 
 void Project::AppendToCompileCommandsJSON(const wxStringMap_t& compilersGlobalPaths, nlohmann::json& compile_commands)
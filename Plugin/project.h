@@ -25,6 +25,7 @@
 #ifndef PROJECT_H
 #define PROJECT_H
 
+#include "clBacktickCache.hpp"
 #include "codelite_exports.h"
 #include "macros.h"
 #include "project_settings.h"
@@ -427,6 +428,20 @@ public:
      * \return
      */
     bool Load(const wxString& path);
+
+    /**
+     * @brief the first part of `Load()`: parse the project file and build the files cache. This part does not use
+     * the workspace, the build settings or the event system so it may run on a worker thread. `FinishLoad()` must be
+     * called on the main thread afterwards.
+     * @param snapshotDir when not empty, restore the parsed XML from a binary snapshot kept in this folder (and
+     * create the snapshot when missing or outdated) instead of parsing the project file
+     */
+    bool LoadXml(const wxString& path, const wxString& snapshotDir = wxEmptyString);
+
+    /**
+     * @brief complete the loading started by `LoadXml()`
+     */
+    bool FinishLoad();
     /**
      * \brief Create new project
      * \param name project name
@@ -672,6 +687,13 @@ public:
      */
     wxArrayString GetIncludePaths();
 
+    /**
+     * @brief collect the backticks and $(shell ..) commands of the compile options, with their macros expanded, in
+     * the environment used to generate the compile lines
+     * @return the hash of that environment
+     */
+    size_t GetBacktickRequests(std::vector<clBacktickCache::Request>& requests);
+
     /**
      * @brief return the pre-processors for this project.
      * The PreProcessors returned are from the build configuration
@@ -755,6 +777,8 @@ private:
     wxArrayString DoBacktickToIncludePath(const wxString& backtick);
     wxArrayString DoBacktickToPreProcessors(const wxString& backtick);
     wxString DoExpandBacktick(const wxString& backtick);
+    /// strip the backtick or $(shell ..) syntax from `option`. Return false if `option` is not a backtick
+    bool DoStripBacktick(const wxString& option, wxString& command) const;
     void DoGetVirtualDirectories(wxXmlNode* parent, TreeNode<wxString, VisualWorkspaceNode>* tree);
 
     // Recursive helper function
@@ -27,8 +27,10 @@
 #include "StringUtils.h"
 #include "build_settings_config.h"
 #include "cl_command_event.h"
+#include "cl_config.h"
 #include "codelite_events.h"
 #include "ctags_manager.h"
+#include "environmentconfig.h"
 #include "event_notifier.h"
 #include "file_logger.h"
 #include "fileutils.h"
@@ -37,15 +39,21 @@
 #include "macromanager.h"
 #include "macros.h"
 #include "project.h"
+#include "xml/clXmlSnapshot.hpp"
 #include "xml/xmlutils.h"
 
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <wx/log.h>
 #include <wx/msgdlg.h>
 #include <wx/sstream.h>
+#include <wx/stopwatch.h>
 #include <wx/tokenzr.h>
 
 clCxxWorkspace::clCxxWorkspace()
     : m_saveOnExit(true)
+    , m_backticks(std::make_shared<clBacktickCache>())
 {
     SetWorkspaceType(_("C++"));
     m_localWorkspace = new LocalWorkspace();
@@ -1062,14 +1070,20 @@ nlohmann::json clCxxWorkspace::CreateCompileCommandsJSON() const
     // Build the global compiler paths, we will need this later on...
     const wxStringMap_t compilersGlobalPaths = BuildGlobalCompilerPath();
 
-    nlohmann::json compile_commands;
+    std::vector<ProjectPtr> projects;
     for (const auto& [_, project] : m_projects) {
         BuildConfigPtr buildConf = project->GetBuildConfiguration();
         if (buildConf && buildConf->IsProjectEnabled() && !buildConf->IsCustomBuild() &&
             buildConf->IsCompilerRequired()) {
-            project->AppendToCompileCommandsJSON(compilersGlobalPaths, compile_commands);
+            projects.push_back(project);
         }
     }
+    DoEvaluateBackticks(projects);
+
+    nlohmann::json compile_commands;
+    for (const auto& project : projects) {
+        project->AppendToCompileCommandsJSON(compilersGlobalPaths, compile_commands);
+    }
     return compile_commands;
 }
 
@@ -1084,19 +1098,25 @@ wxArrayString clCxxWorkspace::CreateCompileFlagsTexts() const
     }
 
     const wxStringMap_t compilersGlobalPaths = BuildGlobalCompilerPath();
-    wxArrayString generated_paths;
+    std::vector<ProjectPtr> projects;
     for (const auto& [_, project] : m_projects) {
         BuildConfigPtr buildConf = project->GetBuildConfiguration();
         if (buildConf && buildConf->IsProjectEnabled() && !buildConf->IsCustomBuild() &&
             buildConf->IsCompilerRequired()) {
-            project->CreateCompileFlags(compilersGlobalPaths);
-
-            // compile_flags.txt files are created under the same path as the project
-            wxFileName project_fn = project->GetFileName();
-            project_fn.SetFullName("compile_flags.txt");
-            generated_paths.Add(project_fn.GetFullPath());
+            projects.push_back(project);
         }
     }
+    DoEvaluateBackticks(projects);
+
+    wxArrayString generated_paths;
+    for (const auto& project : projects) {
+        project->CreateCompileFlags(compilersGlobalPaths);
+
+        // compile_flags.txt files are created under the same path as the project
+        wxFileName project_fn = project->GetFileName();
+        project_fn.SetFullName("compile_flags.txt");
+        generated_paths.Add(project_fn.GetFullPath());
+    }
     return generated_paths;
 }
 
@@ -1270,16 +1290,22 @@ void clCxxWorkspace::DoUnselectActiveProject()
 
 void clCxxWorkspace::DoLoadProjectsFromXml(wxXmlNode* parentNode,
                                            const wxString& folder,
-                                           std::vector<wxXmlNode*>& removedChildren)
+                                           std::vector<ProjectToLoad>& projects)
 {
     wxXmlNode* child = parentNode->GetChildren();
     while (child) {
         if (child->GetName() == wxT("Project")) {
-            wxString projectPath = child->GetAttribute(wxT("Path"), wxEmptyString);
-            wxString errmsg;
-            if (!DoAddProject(projectPath, folder, errmsg)) {
-                removedChildren.push_back(child);
+            // Convert the path to absolute path
+            wxFileName projectFile(child->GetAttribute(wxT("Path"), wxEmptyString));
+            if (projectFile.IsRelative()) {
+                projectFile.MakeAbsolute(m_fileName.GetPath());
             }
+
+            ProjectToLoad project;
+            project.xmlNode = child;
+            project.path = projectFile.GetFullPath();
+            project.workspaceFolder = folder;
+            projects.push_back(std::move(project));
         } else if (child->GetName() == wxT("VirtualDirectory")) {
             // Virtual directory
             wxString currentFolder = folder;
@@ -1288,7 +1314,7 @@ void clCxxWorkspace::DoLoadProjectsFromXml(wxXmlNode* parentNode,
                 currentFolder << "/";
             }
             currentFolder << vdName;
-            DoLoadProjectsFromXml(child, currentFolder, removedChildren);
+            DoLoadProjectsFromXml(child, currentFolder, projects);
         } else if ((child->GetName() == wxT("WorkspaceParserPaths")) ||
                    (child->GetName() == wxT("WorkspaceParserMacros"))) {
             wxString swtlw = XmlUtils::ReadString(m_doc.GetRoot(), "SWTLW");
@@ -1303,6 +1329,93 @@ void clCxxWorkspace::DoLoadProjectsFromXml(wxXmlNode* parentNode,
     }
 }
 
+void clCxxWorkspace::DoLoadProjects(std::vector<ProjectToLoad>& projects, std::vector<wxXmlNode*>& removedChildren)
+{
+    wxStopWatch sw;
+    wxString snapshotDir;
+    if (clConfig::Get().Read(kConfigUseProjectSnapshots, true)) {
+        wxFileName dir(GetPrivateFolder(), wxEmptyString);
+        dir.AppendDir("snapshots");
+        snapshotDir = dir.GetPath();
+    }
+
+    // The project constructor reads the build settings, so it must run here
+    for (auto& project : projects) {
+        project.project = std::make_shared<Project>();
+    }
+
+    // Parse the project files on worker threads. `Project::LoadXml()` only touches the project itself
+    std::atomic_size_t next{0};
+    auto worker = [&projects, &next, &snapshotDir]() {
+        for (size_t i = next++; i < projects.size(); i = next++) {
+            auto& project = projects[i];
+            project.loaded = project.project->LoadXml(project.path, snapshotDir);
+        }
+    };
+
+    size_t threadsCount = std::min<size_t>(std::max(std::thread::hardware_concurrency(), 1u), projects.size());
+    std::vector<std::thread> threads;
+    threads.reserve(threadsCount);
+    for (size_t i = 1; i < threadsCount; ++i) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thr : threads) {
+        thr.join();
+    }
+
+    if (!snapshotDir.empty()) {
+        // drop the snapshots of the projects that were removed from the workspace
+        std::vector<wxFileName> sources;
+        sources.reserve(projects.size());
+        for (const auto& project : projects) {
+            sources.emplace_back(project.path);
+        }
+        clXmlSnapshot::Prune(snapshotDir, sources);
+    }
+
+    // Add them to the workspace, in order
+    for (auto& project : projects) {
+        if (!project.loaded || !project.project->FinishLoad()) {
+            clWARNING() << "Corrupted project file:" << project.path << endl;
+            removedChildren.push_back(project.xmlNode);
+            continue;
+        }
+        DoAddProject(project.project);
+        project.project->SetWorkspaceFolder(project.workspaceFolder);
+    }
+    clDEBUG() << "Loaded" << projects.size() << "projects in" << sw.Time() << "ms" << endl;
+}
+
+void clCxxWorkspace::DoEvaluateBackticks(const std::vector<ProjectPtr>& projects) const
+{
+    // a command runs in the environment of its project, group the projects by environment
+    struct Group {
+        ProjectPtr project;
+        std::vector<clBacktickCache::Request> requests;
+    };
+    std::unordered_map<size_t, Group> groups;
+    for (const auto& project : projects) {
+        std::vector<clBacktickCache::Request> requests;
+        size_t envHash = project->GetBacktickRequests(requests);
+        if (requests.empty()) {
+            continue;
+        }
+
+        auto& group = groups[envHash];
+        if (!group.project) {
+            group.project = project;
+        }
+        group.requests.insert(group.requests.end(), requests.begin(), requests.end());
+    }
+
+    for (const auto& [_, group] : groups) {
+        BuildConfigPtr buildConf = group.project->GetBuildConfiguration();
+        EnvSetter es(nullptr, nullptr, group.project->GetName(), buildConf ? buildConf->GetName() : wxString());
+        m_backticks->EvaluateAll(group.requests);
+    }
+}
+
 wxXmlNode* clCxxWorkspace::DoGetWorkspaceFolderXmlNode(const wxString& path)
 {
     wxArrayString parts = ::wxStringTokenize(path, "/", wxTOKEN_STRTOK);
@@ -1420,8 +1533,10 @@ bool clCxxWorkspace::DoLoadWorkspace(const wxString& fileName, wxString& errMsg)
     ::wxSetWorkingDirectory(m_fileName.GetPath());
 
     // Load all projects from the XML file
+    std::vector<ProjectToLoad> projects;
     std::vector<wxXmlNode*> removedChildren;
-    DoLoadProjectsFromXml(m_doc.GetRoot(), wxEmptyString, removedChildren);
+    DoLoadProjectsFromXml(m_doc.GetRoot(), wxEmptyString, projects);
+    DoLoadProjects(projects, removedChildren);
 
     // Delete the faulty projects
     for (size_t i = 0; i < removedChildren.size(); i++) {
@@ -1545,24 +1660,7 @@ size_t clCxxWorkspace::GetExcludeFilesForConfig(std::vector<wxString>& files, co
     return files.size();
 }
 
-void clCxxWorkspace::ClearBacktickCache() { m_backticks.clear(); }
-
-bool clCxxWorkspace::HasBacktick(const wxString& backtick) const { return m_backticks.count(backtick) != 0; }
-
-void clCxxWorkspace::SetBacktickValue(const wxString& backtick, const wxString& value)
-{
-    m_backticks.erase(backtick);
-    m_backticks.insert({backtick, value});
-}
-
-bool clCxxWorkspace::GetBacktickValue(const wxString& backtick, wxString& value) const
-{
-    if (!HasBacktick(backtick)) {
-        return false;
-    }
-    value = m_backticks.find(backtick)->second;
-    return true;
-}
+void clCxxWorkspace::ClearBacktickCache() { m_backticks->Clear(); }
 
 void clCxxWorkspace::OnBuildHotspotClicked(clBuildEvent& event)
 {
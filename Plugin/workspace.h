@@ -26,6 +26,7 @@
 #define WORKSPACE_H
 
 #include "IWorkspace.h"
+#include "clBacktickCache.hpp"
 #include "clWorkspaceManager.h"
 #include "cl_command_event.h"
 #include "codelite_exports.h"
@@ -76,7 +77,7 @@ protected:
     bool m_saveOnExit;
     BuildMatrixPtr m_buildMatrix;
     LocalWorkspace* m_localWorkspace = nullptr;
-    wxStringMap_t m_backticks;
+    clBacktickCache::ptr_t m_backticks;
 
 public:
     /// Constructor
@@ -96,9 +97,7 @@ public:
     LocalWorkspace* GetLocalWorkspace() const { return m_localWorkspace; }
 
     // Backtick cache
-    bool HasBacktick(const wxString& backtick) const;
-    bool GetBacktickValue(const wxString& backtick, wxString& value) const;
-    void SetBacktickValue(const wxString& backtick, const wxString& value);
+    clBacktickCache::ptr_t GetBacktickCache() const { return m_backticks; }
     void ClearBacktickCache();
 
 private:
@@ -108,10 +107,31 @@ private:
      */
     void DoUnselectActiveProject();
 
+    /// A project referenced by the workspace XML file
+    struct ProjectToLoad {
+        wxXmlNode* xmlNode = nullptr;
+        wxString path;
+        wxString workspaceFolder;
+        ProjectPtr project;
+        bool loaded = false;
+    };
+
+    /**
+     * @brief collect the projects referenced by the XML file
+     */
+    void DoLoadProjectsFromXml(wxXmlNode* parentNode, const wxString& folder, std::vector<ProjectToLoad>& projects);
+
+    /**
+     * @brief load the projects. The project files are parsed concurrently, the projects are then added to the
+     * workspace in their XML order. The XML nodes of the projects that failed to load are added to `removedChildren`
+     */
+    void DoLoadProjects(std::vector<ProjectToLoad>& projects, std::vector<wxXmlNode*>& removedChildren);
+
     /**
-     * @brief load projects from the XML file
+     * @brief run the backticks of `projects` ahead of the compile lines generation. The distinct commands of the
+     * projects sharing an environment run concurrently
      */
-    void DoLoadProjectsFromXml(wxXmlNode* parentNode, const wxString& folder, std::vector<wxXmlNode*>& removedChildren);
+    void DoEvaluateBackticks(const std::vector<ProjectPtr>& projects) const;
 
     // return the wxXmlNode instance for the give path
     // the path is separated by "/"
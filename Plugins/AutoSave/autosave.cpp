@@ -2,11 +2,24 @@
 
 #include "AutoSaveDlg.h"
 #include "AutoSaveSettings.h"
+#include "Diff/clDiffFrame.h"
+#include "cl_standard_paths.h"
+#include "codelite_events.h"
 #include "event_notifier.h"
+#include "file_logger.h"
+#include "fileutils.h"
 
+#include <unordered_set>
 #include <wx/menu.h>
+#include <wx/msgdlg.h>
 #include <wx/xrc/xmlres.h>
 
+namespace
+{
+/// the number of files listed when offering to restore them
+constexpr size_t MAX_LISTED_FILES = 10;
+} // namespace
+
 // Define the plugin entry point
 CL_PLUGIN_API IPlugin* CreatePlugin(IManager* manager) { return new AutoSave(manager); }
 
@@ -15,7 +28,7 @@ CL_PLUGIN_API PluginInfo* GetPluginInfo()
     static PluginInfo info;
     info.SetAuthor(wxT("PC"));
     info.SetName(wxT("AutoSave"));
-    info.SetDescription(_("Automatically save modified source files"));
+    info.SetDescription(_("Keep a crash recovery journal of the modified files"));
     info.SetVersion(wxT("v1.0"));
     return &info;
 }
@@ -26,11 +39,13 @@ AutoSave::AutoSave(IManager* manager)
     : IPlugin(manager)
     , m_timer(NULL)
 {
-    m_longName = _("Automatically save modified source files");
+    m_longName = _("Keep a crash recovery journal of the modified files");
     m_shortName = wxT("AutoSave");
 
     UpdateTimers();
     wxTheApp->Bind(wxEVT_MENU, &AutoSave::OnSettings, this, XRCID("auto_save_settings"));
+    EventNotifier::Get()->Bind(wxEVT_INIT_DONE, &AutoSave::OnInitDone, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_SAVED, &AutoSave::OnFileSaved, this);
 }
 
 void AutoSave::CreateToolBar(clToolBarGeneric* toolbar) { wxUnusedVar(toolbar); }
@@ -46,6 +61,14 @@ void AutoSave::UnPlug()
 {
     DeleteTimer();
     wxTheApp->Unbind(wxEVT_MENU, &AutoSave::OnSettings, this, XRCID("auto_save_settings"));
+    EventNotifier::Get()->Unbind(wxEVT_INIT_DONE, &AutoSave::OnInitDone, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_SAVED, &AutoSave::OnFileSaved, this);
+
+    // a normal exit: there is nothing to recover
+    if (m_journal) {
+        m_journal->Discard();
+        m_journal.reset();
+    }
 }
 
 void AutoSave::OnSettings(wxCommandEvent& event)
@@ -62,9 +85,18 @@ void AutoSave::UpdateTimers()
     DeleteTimer();
     AutoSaveSettings conf = AutoSaveSettings::Load();
     if (!conf.HasFlag(AutoSaveSettings::kEnabled)) {
+        if (m_journal) {
+            m_journal->Discard();
+            m_journal.reset();
+        }
+        m_snapshotCounts.clear();
         return;
     }
 
+    if (!m_journal) {
+        m_journal = std::make_unique<clRecoveryJournal>(GetJournalRoot());
+    }
+
     m_checkIntervalSeconds = conf.GetCheckInterval();
     m_timer = new wxTimer(this, XRCID("auto_save_timer"));
     m_timer->Start((m_checkIntervalSeconds * 1000), true);
@@ -76,13 +108,37 @@ void AutoSave::OnTimer(wxTimerEvent& event)
     IEditor::List_t editors;
     m_mgr->GetAllEditors(editors);
 
-    // Save every modified editor
+    // Snapshot the modified editors. The files are not written: they belong to the user (and to the file watchers,
+    // the builds and the source control that follow them)
+    std::unordered_set<wxString> modified;
     for (auto editor : editors) {
-        // Save modified files. However, don't attempt to try and save an "Untitled" document :/
-        bool local_file_and_exists = !editor->IsRemoteFile() && editor->GetFileName().FileExists();
-        bool is_remote = editor->IsRemoteFile();
-        if (editor->IsEditorModified() && (local_file_and_exists || is_remote)) {
-            editor->Save();
+        // "Untitled" documents have no file to restore, and remote files are edited through a local copy
+        if (!editor->IsEditorModified() || editor->IsRemoteFile() || !editor->GetFileName().FileExists()) {
+            continue;
+        }
+
+        wxString filename = editor->GetFileName().GetFullPath();
+        modified.insert(filename);
+        auto iter = m_snapshotCounts.find(filename);
+        if (iter != m_snapshotCounts.end() && iter->second == editor->GetModificationCount()) {
+            // not modified since its last snapshot: no need to copy its text
+            continue;
+        }
+
+        std::string content;
+        editor->GetEditorTextRaw(content);
+        m_journal->Write(filename, std::move(content));
+        m_snapshotCounts.erase(filename);
+        m_snapshotCounts.insert({filename, editor->GetModificationCount()});
+    }
+
+    // the editors that were closed without saving, or whose changes were undone
+    for (auto iter = m_snapshotCounts.begin(); iter != m_snapshotCounts.end();) {
+        if (modified.count(iter->first) == 0) {
+            m_journal->Remove(iter->first);
+            iter = m_snapshotCounts.erase(iter);
+        } else {
+            ++iter;
         }
     }
 
@@ -98,3 +154,96 @@ void AutoSave::DeleteTimer()
     }
     wxDELETE(m_timer);
 }
+
+void AutoSave::OnFileSaved(clCommandEvent& event)
+{
+    event.Skip();
+    if (m_journal && m_snapshotCounts.erase(event.GetString())) {
+        m_journal->Remove(event.GetString());
+    }
+}
+
+void AutoSave::OnInitDone(wxCommandEvent& event)
+{
+    event.Skip();
+    DoRecover();
+}
+
+wxString AutoSave::GetJournalRoot()
+{
+    wxFileName root(clStandardPaths::Get().GetUserDataDir(), "");
+    root.AppendDir("recovery");
+    return root.GetPath();
+}
+
+void AutoSave::DoRecover()
+{
+    std::vector<wxString> sessions = clRecoveryJournal::FindOrphanedSessions(GetJournalRoot());
+    if (sessions.empty()) {
+        return;
+    }
+
+    // only the snapshots that differ from the files
+    std::vector<clRecoveryJournal::Snapshot> snapshots;
+    for (const auto& session : sessions) {
+        for (auto& snapshot : clRecoveryJournal::LoadSession(session)) {
+            if (wxFileName::FileExists(snapshot.filename) && clRecoveryJournal::DiffersFromDisk(snapshot)) {
+                snapshots.push_back(std::move(snapshot));
+            }
+        }
+    }
+
+    if (!snapshots.empty()) {
+        wxString message;
+        message << _("CodeLite did not exit normally. Unsaved changes to the following files can be restored:")
+                << "\n\n";
+        for (size_t i = 0; i < snapshots.size() && i < MAX_LISTED_FILES; ++i) {
+            message << snapshots[i].filename << "\n";
+        }
+        if (snapshots.size() > MAX_LISTED_FILES) {
+            message << wxString::Format(_("... and %lu more"), (unsigned long)(snapshots.size() - MAX_LISTED_FILES))
+                    << "\n";
+        }
+        message << "\n"
+                << _("The restored changes are not saved, their differences with the files are shown for review.");
+
+        wxMessageDialog dlg(EventNotifier::Get()->TopFrame(), message, "CodeLite",
+                            wxYES_NO | wxCANCEL | wxYES_DEFAULT | wxICON_WARNING);
+        dlg.SetYesNoCancelLabels(_("Restore"), _("Discard"), _("Ask Me Later"));
+        int answer = dlg.ShowModal();
+        if (answer == wxID_CANCEL) {
+            return;
+        }
+
+        if (answer == wxID_YES) {
+            for (const auto& snapshot : snapshots) {
+                IEditor* editor = m_mgr->OpenFile(snapshot.filename);
+                if (!editor) {
+                    clWARNING() << "AutoSave: failed to open file:" << snapshot.filename << endl;
+                    continue;
+                }
+                editor->SetEditorText(wxString::FromUTF8(snapshot.content));
+                DoShowDiff(snapshot);
+            }
+        }
+    }
+
+    for (const auto& session : sessions) {
+        clRecoveryJournal::DeleteSession(session);
+    }
+}
+
+void AutoSave::DoShowDiff(const clRecoveryJournal::Snapshot& snapshot)
+{
+    wxFileName fn(snapshot.filename);
+    wxFileName recovered = FileUtils::CreateTempFileName(clStandardPaths::Get().GetTempDir(), "recovered", fn.GetExt());
+    if (!FileUtils::WriteFileContentRaw(recovered, snapshot.content)) {
+        return;
+    }
+
+    DiffSideBySidePanel::FileInfo left(fn, _("On disk"), true);
+    DiffSideBySidePanel::FileInfo right(recovered, _("Recovered"), true);
+    right.deleteOnExit = true;
+    clDiffFrame* diff = new clDiffFrame(EventNotifier::Get()->TopFrame(), left, right, false);
+    diff->Show();
+}
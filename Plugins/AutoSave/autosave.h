@@ -26,21 +26,37 @@
 #ifndef __AutoSave__
 #define __AutoSave__
 
+#include "clRecoveryJournal.hpp"
+#include "cl_command_event.h"
 #include "plugin.h"
 
+#include <memory>
+#include <unordered_map>
 #include <wx/timer.h>
 
+/**
+ * @brief snapshot the modified editors to a crash recovery journal, and offer to restore the snapshots left by a
+ * session that did not exit normally. The files themselves are only written by the user
+ */
 class AutoSave : public IPlugin
 {
     wxTimer* m_timer;
     size_t m_checkIntervalSeconds = 5;
+    std::unique_ptr<clRecoveryJournal> m_journal;
+    /// the modification count of the editors when their last snapshot was taken
+    std::unordered_map<wxString, wxUint64> m_snapshotCounts;
 
 protected:
     void OnSettings(wxCommandEvent& event);
     void OnTimer(wxTimerEvent& event);
+    void OnInitDone(wxCommandEvent& event);
+    void OnFileSaved(clCommandEvent& event);
 
     void UpdateTimers();
     void DeleteTimer();
+    void DoRecover();
+    void DoShowDiff(const clRecoveryJournal::Snapshot& snapshot);
+    static wxString GetJournalRoot();
 
 public:
     AutoSave(IManager* manager);
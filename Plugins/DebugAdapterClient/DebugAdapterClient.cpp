@@ -84,11 +84,14 @@ wxString get_dap_settings_file()
     return fn.GetFullPath();
 }
 
-class StdioTransport : public dap::Transport
+/// Bridge between the `dap::Client` thread and an adapter started with `CreateAsyncProcess()` (the process output is
+/// delivered to the main thread as events). Used for adapters running over ssh and on platforms without a
+/// `dap::StdioTransport`
+class AsyncProcessTransport : public dap::Transport
 {
 public:
-    StdioTransport() = default;
-    ~StdioTransport() override = default;
+    AsyncProcessTransport() = default;
+    ~AsyncProcessTransport() override = default;
 
     void SetProcess(DapProcess::Ptr_t process) { m_dap_server = process; }
 
@@ -100,7 +103,7 @@ public:
     bool Read(std::string& buffer, int msTimeout) override
     {
         if (wxThread::IsMain()) {
-            DAP_ERROR() << "StdioTransport::Read is called from the main thread!" << endl;
+            DAP_ERROR() << "AsyncProcessTransport::Read is called from the main thread!" << endl;
             return false;
         }
 
@@ -427,9 +430,17 @@ void DebugAdapterClient::OnDebugNext(clDebugEvent& event)
 {
     CHECK_IS_DAP_CONNECTED();
     DAP_DEBUG() << "-> Next" << endl;
+    StartStepTimer();
     m_client.Next();
 }
 
+void DebugAdapterClient::StartStepTimer()
+{
+    m_stepStopWatch.Start();
+    m_stepPending = true;
+    m_stepVariablesPending = false;
+}
+
 void DebugAdapterClient::OnDebugStop(clDebugEvent& event)
 {
     CHECK_IS_DAP_CONNECTED();
@@ -452,6 +463,7 @@ void DebugAdapterClient::OnDebugCanInteract(clDebugEvent& event)
 void DebugAdapterClient::OnDebugStepIn(clDebugEvent& event)
 {
     CHECK_IS_DAP_CONNECTED();
+    StartStepTimer();
     m_client.StepIn();
     DAP_DEBUG() << "-> StopIn" << endl;
 }
@@ -459,6 +471,7 @@ void DebugAdapterClient::OnDebugStepIn(clDebugEvent& event)
 void DebugAdapterClient::OnDebugStepOut(clDebugEvent& event)
 {
     CHECK_IS_DAP_CONNECTED();
+    StartStepTimer();
     m_client.StepOut();
     DAP_DEBUG() << "-> StopOut" << endl;
 }
@@ -774,6 +787,7 @@ void DebugAdapterClient::OnDebugVOID(clDebugEvent& event) { CHECK_IS_DAP_CONNECT
 void DebugAdapterClient::OnDebugNextInst(clDebugEvent& event)
 {
     CHECK_IS_DAP_CONNECTED();
+    StartStepTimer();
     m_client.Next(wxNOT_FOUND, true, dap::SteppingGranularity::INSTRUCTION);
 }
 
@@ -894,6 +908,13 @@ void DebugAdapterClient::OnDapStoppedEvent(DAPEvent& event)
     }
 
     DAP_DEBUG() << " *** DAP Stopped Event *** " << endl;
+    if (m_stepPending) {
+        m_stepStoppedMs = m_stepStopWatch.Time();
+        m_mgr->SetStatusMessage(wxString::Format(_("Step: %ldms"), m_stepStoppedMs), 5);
+    }
+    // the variables are reported only if we got here by stepping
+    m_stepVariablesPending = m_stepPending;
+    m_stepPending = false;
     dap::StoppedEvent* stopped_data = event.GetDapEvent()->As<dap::StoppedEvent>();
     if (stopped_data) {
         m_client.GetThreads();
@@ -966,6 +987,11 @@ void DebugAdapterClient::OnDapVariablesResponse(DAPEvent& event)
     default:
         // assume its the variables view
         GetThreadsView()->UpdateVariables(response->refId, response);
+        if (m_stepVariablesPending) {
+            m_stepVariablesPending = false;
+            m_mgr->SetStatusMessage(
+                wxString::Format(_("Step: %ldms, variables: %ldms"), m_stepStoppedMs, m_stepStopWatch.Time()), 5);
+        }
         break;
     }
 }
@@ -1106,7 +1132,21 @@ dap::Transport* DebugAdapterClient::StartStdioDap()
 
     DAP_DEBUG() << "starting dap with command:" << command << endl;
 
-    auto transport = new StdioTransport();
+#if DAP_HAS_STDIO_TRANSPORT
+    if (!m_session.debug_over_ssh) {
+        // launch local process, its stdin / stdout are handled by the transport threads
+        EnvSetter env; // apply CodeLite env variables
+        auto env_list = ResolveEnvList(dap_server.GetEnvironment());
+        auto process = std::make_shared<dap::StdioProcess>(this);
+        if (!process->Start(command, wxEmptyString, env_list)) {
+            return nullptr;
+        }
+        m_dap_server.reset(new DapProcess(process));
+        return new dap::StdioTransport(process);
+    }
+#endif
+
+    auto transport = new AsyncProcessTransport();
 
     if (m_session.debug_over_ssh) {
         // launch ssh process
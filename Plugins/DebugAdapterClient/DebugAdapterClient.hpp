@@ -32,6 +32,7 @@
 #include "DebugSession.hpp"
 #include "RunInTerminalHelper.hpp"
 #include "SessionBreakpoints.hpp"
+#include "StdioTransport.hpp"
 #include "clDapSettingsStore.hpp"
 #include "cl_command_event.h"
 #include "dap/Client.hpp"
@@ -40,6 +41,7 @@
 
 #include <memory>
 #include <wx/msgqueue.h>
+#include <wx/stopwatch.h>
 
 class DAPMainView;
 class DAPTooltip;
@@ -58,10 +60,31 @@ struct DapProcess {
         }
     }
 
-    bool IsOk() const { return m_process != nullptr; }
+#if DAP_HAS_STDIO_TRANSPORT
+    /// a local adapter talking over its stdin / stdout, read and written by the transport threads
+    DapProcess(dap::StdioProcess::Ptr_t process)
+        : m_stdioProcess(std::move(process))
+    {
+    }
+#endif
+
+    bool IsOk() const
+    {
+#if DAP_HAS_STDIO_TRANSPORT
+        if (m_stdioProcess) {
+            return m_stdioProcess->IsRunning();
+        }
+#endif
+        return m_process != nullptr;
+    }
 
     void Terminate()
     {
+#if DAP_HAS_STDIO_TRANSPORT
+        if (m_stdioProcess) {
+            m_stdioProcess->Terminate();
+        }
+#endif
         if (m_process) {
             m_process->Terminate();
         }
@@ -82,6 +105,9 @@ struct DapProcess {
 private:
     IProcess::Ptr_t m_process = nullptr;
     wxMessageQueue<std::string> m_readQueue;
+#if DAP_HAS_STDIO_TRANSPORT
+    dap::StdioProcess::Ptr_t m_stdioProcess;
+#endif
 };
 
 class DebugAdapterClient : public IPlugin
@@ -96,6 +122,12 @@ class DebugAdapterClient : public IPlugin
     SessionBreakpoints m_sessionBreakpoints;
     DapProcess::Ptr_t m_dap_server;
 
+    // per step latency, reported in the status bar: step request -> stopped event -> variables of the frame
+    wxStopWatch m_stepStopWatch;
+    bool m_stepPending = false;
+    bool m_stepVariablesPending = false;
+    long m_stepStoppedMs = 0;
+
     /// ------------------------------------
     /// UI elements
     /// ------------------------------------
@@ -141,6 +173,7 @@ private:
     bool IsDebuggerOwnedByPlugin(const wxString& name) const;
 
     void DestroyTooltip();
+    void StartStepTimer();
     DAPMainView* GetThreadsView() const { return m_debuggerPane->GetMainView(); }
     DAPBreakpointsView* GetBreakpointsView() const { return m_debuggerPane->GetBreakpointsView(); }
     DAPWatchesView* GetWatchesView() const { return m_debuggerPane->GetWatchesView(); }
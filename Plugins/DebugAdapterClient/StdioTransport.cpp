@@ -1,14 +1,476 @@
 #include "StdioTransport.hpp"
 
-bool dap::StdioTransport::Read(std::string& buffer, int msTimeout)
+#include "DapLogger.hpp"
+#include "clContentLengthFramer.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <vector>
+
+#if defined(__WXGTK__) || defined(__WXOSX__)
+#include "AsyncProcess/processreaderthread.h"
+#include "cl_command_event.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+namespace
+{
+constexpr int POLL_INTERVAL_MS = 50;
+constexpr int TERMINATE_GRACE_MS = 500;
+
+/// look for the first `"key": <value>` in a JSON message, without parsing it
+const char* FindJsonValue(const std::string& json, const char* key)
+{
+    const std::string pattern = "\"" + std::string{key} + "\"";
+    size_t pos = json.find(pattern);
+    if (pos == std::string::npos) {
+        return nullptr;
+    }
+    pos += pattern.length();
+    while (pos < json.length() && (json[pos] == ' ' || json[pos] == ':')) {
+        ++pos;
+    }
+    return pos < json.length() ? json.c_str() + pos : nullptr;
+}
+
+bool FindJsonString(const std::string& json, const char* key, std::string* value)
+{
+    const char* p = FindJsonValue(json, key);
+    if (!p || *p != '"') {
+        return false;
+    }
+    const char* end = strchr(p + 1, '"');
+    if (!end) {
+        return false;
+    }
+    value->assign(p + 1, end);
+    return true;
+}
+
+bool FindJsonNumber(const std::string& json, const char* key, long* value)
+{
+    const char* p = FindJsonValue(json, key);
+    if (!p) {
+        return false;
+    }
+    char* end = nullptr;
+    *value = strtol(p, &end, 10);
+    return end != p;
+}
+
+bool IsMeasuredCommand(const std::string& command) { return command == "stackTrace" || command == "variables"; }
+
+void SetNonBlocking(int fd) { ::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK); }
+
+/// a pipe whose ends are not inherited by the processes started by the other threads meanwhile
+bool OpenPipe(int fds[2])
+{
+#ifdef __linux__
+    return ::pipe2(fds, O_CLOEXEC) == 0;
+#else
+    // no pipe2() on macOS
+    if (::pipe(fds) != 0) {
+        return false;
+    }
+    ::fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+    ::fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+    return true;
+#endif
+}
+
+void ClosePipe(int fds[2])
+{
+    for (int i = 0; i < 2; ++i) {
+        if (fds[i] != -1) {
+            ::close(fds[i]);
+            fds[i] = -1;
+        }
+    }
+}
+} // namespace
+
+dap::StdioProcess::StdioProcess(wxEvtHandler* owner)
+    : m_owner(owner)
+{
+}
+
+dap::StdioProcess::~StdioProcess() { Shutdown(); }
+
+bool dap::StdioProcess::Start(const wxString& command, const wxString& working_directory, const clEnvList_t& env)
+{
+    // [0] is the read end, [1] the write end
+    int child_stdin[2] = {-1, -1};
+    int child_stdout[2] = {-1, -1};
+    int child_stderr[2] = {-1, -1};
+    if (!OpenPipe(child_stdin) || !OpenPipe(child_stdout) || !OpenPipe(child_stderr)) {
+        DAP_ERROR() << "stdio transport: failed to create pipes." << strerror(errno) << endl;
+        for (int* fds : {child_stdin, child_stdout, child_stderr}) {
+            ClosePipe(fds);
+        }
+        return false;
+    }
+
+    // prepare everything the child needs before forking
+    std::vector<std::string> env_strings;
+    for (char** entry = environ; entry && *entry; ++entry) {
+        std::string_view var{*entry};
+        std::string_view name = var.substr(0, var.find('='));
+        bool overridden = std::any_of(env.begin(), env.end(), [name](const auto& p) {
+            return p.first.ToStdString(wxConvUTF8) == name;
+        });
+        if (!overridden) {
+            env_strings.emplace_back(var);
+        }
+    }
+    for (const auto& [name, value] : env) {
+        env_strings.emplace_back(wxString{name + "=" + value}.ToStdString(wxConvUTF8));
+    }
+    std::vector<char*> envp;
+    envp.reserve(env_strings.size() + 1);
+    for (auto& var : env_strings) {
+        envp.push_back(var.data());
+    }
+    envp.push_back(nullptr);
+
+    std::string shell = "/bin/sh";
+    std::string shell_flag = "-c";
+    std::string cmd = command.ToStdString(wxConvUTF8);
+    char* argv[] = {shell.data(), shell_flag.data(), cmd.data(), nullptr};
+    std::string wd = working_directory.ToStdString(wxConvUTF8);
+
+    pid_t child_pid = ::fork();
+    if (child_pid == -1) {
+        DAP_ERROR() << "stdio transport: failed to start:" << command << "." << strerror(errno) << endl;
+        for (int* fds : {child_stdin, child_stdout, child_stderr}) {
+            ClosePipe(fds);
+        }
+        return false;
+    }
+
+    if (child_pid == 0) {
+        // child process: only async-signal-safe calls from here. dup2() clears FD_CLOEXEC on the standard handles
+        ::dup2(child_stdin[0], STDIN_FILENO);
+        ::dup2(child_stdout[1], STDOUT_FILENO);
+        ::dup2(child_stderr[1], STDERR_FILENO);
+        const int fd_max = (::sysconf(_SC_OPEN_MAX) != -1 ? ::sysconf(_SC_OPEN_MAX) : FD_SETSIZE);
+        for (int fd = 3; fd < fd_max; ++fd) {
+            ::close(fd);
+        }
+        if (!wd.empty() && ::chdir(wd.c_str()) != 0) {
+            ::_exit(127);
+        }
+        ::execve(argv[0], argv, envp.data());
+        ::_exit(127);
+    }
+
+    // parent process: keep our ends of the pipes, the adapter sees EOF on its stdin once we close the write end
+    m_child_reaped = false;
+    m_child_pid.store(child_pid);
+    m_stdin_fd = child_stdin[1];
+    m_stdout_fd = child_stdout[0];
+    m_stderr_fd = child_stderr[0];
+    ::close(child_stdin[0]);
+    ::close(child_stdout[1]);
+    ::close(child_stderr[1]);
+    SetNonBlocking(m_stdin_fd);
+    SetNonBlocking(m_stdout_fd);
+    SetNonBlocking(m_stderr_fd);
+
+    DAP_DEBUG() << "stdio transport: started adapter, pid:" << child_pid << endl;
+    m_writer_thread = std::make_unique<std::thread>(&StdioProcess::WriterThreadMain, this, m_stdin_fd);
+    m_reader_thread = std::make_unique<std::thread>(&StdioProcess::ReaderThreadMain, this, m_stdout_fd, m_stderr_fd);
+    return true;
+}
+
+void dap::StdioProcess::ReaderThreadMain(int stdout_fd, int stderr_fd)
+{
+    clContentLengthFramer framer;
+    std::string stderr_line;
+    std::string message;
+    char buffer[65536];
+
+    // the adapter is gone once its stdout is closed
+    bool stdout_open = true;
+    bool stderr_open = true;
+    while (!m_shutdown.load() && stdout_open) {
+        // a negative fd is ignored by poll()
+        pollfd fds[2] = {{stdout_fd, POLLIN, 0}, {stderr_open ? stderr_fd : -1, POLLIN, 0}};
+        int rc = ::poll(fds, 2, POLL_INTERVAL_MS);
+        if (rc < 0 && errno != EINTR) {
+            DAP_ERROR() << "stdio transport: poll error." << strerror(errno) << endl;
+            break;
+        } else if (rc <= 0) {
+            continue;
+        }
+
+        if (stderr_open && fds[1].revents) {
+            ssize_t len = 0;
+            while ((len = ::read(stderr_fd, buffer, sizeof(buffer))) > 0) {
+                stderr_line.append(buffer, len);
+            }
+            stderr_open = !(len == 0 || (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR));
+
+            // the adapter diagnostics go to the log, line by line
+            size_t eol = 0;
+            while ((eol = stderr_line.find('\n')) != std::string::npos) {
+                DAP_DEBUG() << "[adapter stderr]" << stderr_line.substr(0, eol) << endl;
+                stderr_line.erase(0, eol + 1);
+            }
+        }
+
+        if (fds[0].revents) {
+            ssize_t len = 0;
+            while ((len = ::read(stdout_fd, buffer, sizeof(buffer))) > 0) {
+                framer.Append(buffer, len);
+                while (framer.Next(message)) {
+                    OnIncomingMessage(message);
+                    m_incoming.Post(std::move(message));
+                }
+            }
+            stdout_open = !(len == 0 || (len < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR));
+        }
+    }
+
+    m_terminated.store(true);
+    if (!stdout_open && m_notify_owner.load()) {
+        clProcessEvent event{wxEVT_ASYNC_PROCESS_TERMINATED};
+        event.SetOutput("debug adapter closed its output");
+        m_owner->AddPendingEvent(event);
+    }
+    DAP_DEBUG() << "stdio transport: reader thread going down" << endl;
+}
+
+void dap::StdioProcess::WriterThreadMain(int stdin_fd)
+{
+    bool ok = true;
+    bool terminating = false;
+    while (!m_shutdown.load()) {
+        std::string buffer;
+        if (m_outgoing.ReceiveTimeout(POLL_INTERVAL_MS, buffer) != wxMSGQUEUE_NO_ERROR) {
+            continue;
+        }
+
+        if (buffer.empty()) {
+            // Terminate(): everything queued before was written, let the adapter see EOF
+            terminating = true;
+            break;
+        }
+
+        // once the pipe is broken, keep draining the queue without writing
+        size_t offset = 0;
+        while (ok && offset < buffer.length()) {
+            ssize_t bytes = ::write(stdin_fd, buffer.data() + offset, buffer.length() - offset);
+            if (bytes > 0) {
+                offset += bytes;
+            } else if (bytes < 0 && errno == EINTR) {
+                continue;
+            } else if (bytes < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (m_shutdown.load()) {
+                    break;
+                }
+                // the adapter is not reading: wait for room in the pipe
+                pollfd fd{stdin_fd, POLLOUT, 0};
+                ::poll(&fd, 1, POLL_INTERVAL_MS);
+            } else {
+                DAP_ERROR() << "stdio transport: write error." << strerror(errno) << endl;
+                ok = false;
+            }
+        }
+    }
+    CloseStdin();
+
+    if (terminating) {
+        // the adapter still has to read what we wrote: give it time to exit on its own before asking with SIGTERM
+        for (int waited = 0; waited < TERMINATE_GRACE_MS && !m_terminated.load() && !m_shutdown.load();
+             waited += 10) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        if (!m_terminated.load()) {
+            SignalChild(SIGTERM);
+        }
+    }
+    DAP_DEBUG() << "stdio transport: writer thread going down" << endl;
+}
+
+void dap::StdioProcess::CloseStdin()
+{
+    int fd = m_stdin_fd;
+    m_stdin_fd = -1;
+    if (fd != -1) {
+        ::close(fd);
+    }
+}
+
+void dap::StdioProcess::Terminate()
+{
+    if (m_child_pid.load() == -1) {
+        return;
+    }
+    // the writer thread flushes the pending requests, closes the adapter stdin and sends SIGTERM if needed
+    m_outgoing.Post(std::string{});
+}
+
+void dap::StdioProcess::SignalChild(int signo)
+{
+    std::lock_guard<std::mutex> lock{m_child_mutex};
+    pid_t child_pid = m_child_pid.load();
+    if (child_pid != -1 && !m_child_reaped) {
+        ::kill(child_pid, signo);
+    }
+}
+
+void dap::StdioProcess::Shutdown()
+{
+    m_notify_owner.store(false);
+    pid_t child_pid = m_child_pid.load();
+    if (child_pid != -1) {
+        Terminate();
+
+        // the adapter exits on EOF, or on the SIGTERM sent by the writer thread after the grace period
+        bool reaped = false;
+        for (int waited = 0; waited < 2 * TERMINATE_GRACE_MS && !reaped; waited += 10) {
+            {
+                std::lock_guard<std::mutex> lock{m_child_mutex};
+                int status = 0;
+                pid_t rc = ::waitpid(child_pid, &status, WNOHANG);
+                reaped = rc == child_pid || (rc == -1 && errno == ECHILD);
+                m_child_reaped = reaped;
+            }
+            if (!reaped) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+
+        std::lock_guard<std::mutex> lock{m_child_mutex};
+        if (!reaped) {
+            DAP_WARNING() << "stdio transport: adapter did not exit, killing it. pid:" << child_pid << endl;
+            ::kill(child_pid, SIGKILL);
+            int status = 0;
+            ::waitpid(child_pid, &status, 0);
+            m_child_reaped = true;
+        }
+        m_child_pid.store(-1);
+    }
+
+    m_shutdown.store(true);
+    if (m_writer_thread) {
+        m_writer_thread->join();
+        m_writer_thread.reset();
+    }
+    if (m_reader_thread) {
+        m_reader_thread->join();
+        m_reader_thread.reset();
+    }
+
+    CloseStdin();
+    for (int* fd : {&m_stdout_fd, &m_stderr_fd}) {
+        if (*fd != -1) {
+            ::close(*fd);
+            *fd = -1;
+        }
+    }
+}
+
+bool dap::StdioProcess::Write(const std::string& message)
 {
-    wxUnusedVar(buffer);
-    wxUnusedVar(msTimeout);
-    return false;
+    if (!IsRunning() || message.empty()) {
+        return false;
+    }
+    OnOutgoingMessage(message);
+    m_outgoing.Post(message);
+    return true;
 }
 
+bool dap::StdioProcess::Read(std::string& buffer, int msTimeout)
+{
+    buffer.clear();
+    std::string message;
+    auto rc = m_incoming.ReceiveTimeout(msTimeout, message);
+    if (rc == wxMSGQUEUE_TIMEOUT && m_terminated.load()) {
+        // messages posted right before the reader thread exited
+        rc = m_incoming.ReceiveTimeout(0, message);
+        if (rc != wxMSGQUEUE_NO_ERROR) {
+            return false;
+        }
+    }
+
+    switch (rc) {
+    case wxMSGQUEUE_NO_ERROR:
+        // hand over everything that is ready in one go
+        buffer.swap(message);
+        while (m_incoming.ReceiveTimeout(0, message) == wxMSGQUEUE_NO_ERROR) {
+            buffer.append(message);
+        }
+        return true;
+    case wxMSGQUEUE_TIMEOUT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+void dap::StdioProcess::OnOutgoingMessage(const std::string& message)
+{
+    std::string command;
+    long seq = 0;
+    if (!FindJsonString(message, "command", &command) || !IsMeasuredCommand(command) ||
+        !FindJsonNumber(message, "seq", &seq)) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock{m_latency_mutex};
+    m_pending_requests.insert({seq, {command, std::chrono::steady_clock::now()}});
+}
+
+void dap::StdioProcess::OnIncomingMessage(const std::string& message)
+{
+    std::lock_guard<std::mutex> lock{m_latency_mutex};
+    if (m_pending_requests.empty()) {
+        return;
+    }
+
+    long request_seq = 0;
+    if (!FindJsonNumber(message, "request_seq", &request_seq)) {
+        return;
+    }
+    auto iter = m_pending_requests.find(request_seq);
+    if (iter == m_pending_requests.end()) {
+        return;
+    }
+
+    std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - iter->second.second;
+    auto& latency = m_latency[iter->second.first];
+    latency.count++;
+    latency.total_ms += elapsed.count();
+    latency.max_ms = std::max(latency.max_ms, elapsed.count());
+    DAP_DEBUG() << "stdio transport:" << iter->second.first << "round trip:" << elapsed.count()
+                << "ms, average:" << latency.Average() << "ms" << endl;
+    m_pending_requests.erase(iter);
+}
+
+dap::StdioProcess::Latency dap::StdioProcess::GetLatency(const std::string& command) const
+{
+    std::lock_guard<std::mutex> lock{m_latency_mutex};
+    auto iter = m_latency.find(command);
+    return iter == m_latency.end() ? Latency{} : iter->second;
+}
+
+bool dap::StdioTransport::Read(std::string& buffer, int msTimeout) { return m_process->Read(buffer, msTimeout); }
+
 size_t dap::StdioTransport::Send(const std::string& buffer)
 {
-    wxUnusedVar(buffer);
-    return false;
+    if (!m_process->Write(buffer)) {
+        return 0;
+    }
+    return buffer.length();
 }
+#endif // defined(__WXGTK__) || defined(__WXOSX__)
@@ -1,11 +1,108 @@
 #ifndef STDIOTRANSPORT_HPP
 #define STDIOTRANSPORT_HPP
 
+#include "clEnvironment.hpp"
 #include "dap/Client.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <wx/event.h>
+#include <wx/msgqueue.h>
+#include <wx/string.h>
+
 namespace dap
 {
 
+#if defined(__WXGTK__) || defined(__WXOSX__)
+#define DAP_HAS_STDIO_TRANSPORT 1
+
+/**
+ * @brief a debug adapter running as a child process, talking DAP over its stdin / stdout.
+ *
+ * A reader thread drains the adapter stdout and frames the messages; a writer thread drains the outgoing queue, so
+ * neither the UI thread nor the `dap::Client` thread ever blocks on a pipe. When the adapter exits, the owner receives
+ * `wxEVT_ASYNC_PROCESS_TERMINATED`.
+ */
+class StdioProcess
+{
+public:
+    using Ptr_t = std::shared_ptr<StdioProcess>;
+
+    /// round trip statistics for a request type
+    struct Latency {
+        size_t count = 0;
+        double total_ms = 0.0;
+        double max_ms = 0.0;
+        double Average() const { return count ? total_ms / count : 0.0; }
+    };
+
+    explicit StdioProcess(wxEvtHandler* owner);
+    ~StdioProcess();
+
+    /**
+     * @brief start `command` (executed by the shell) in `working_directory`, adding `env` to the current environment
+     */
+    bool Start(const wxString& command, const wxString& working_directory, const clEnvList_t& env);
+
+    /**
+     * @brief ask the adapter to exit: close its stdin once the queued messages were written, and send it SIGTERM if it
+     * is still running after a grace period. The owner is notified once it is gone
+     */
+    void Terminate();
+
+    bool IsRunning() const { return m_child_pid.load() != -1 && !m_terminated.load(); }
+
+    /// queue a framed message for the adapter
+    bool Write(const std::string& message);
+
+    /**
+     * @brief wait up to `msTimeout` milliseconds for incoming messages
+     * @return false if the adapter is gone and there is nothing left to read
+     */
+    bool Read(std::string& buffer, int msTimeout);
+
+    /// return the measured round trip of the `command` requests (only `stackTrace` and `variables` are measured)
+    Latency GetLatency(const std::string& command) const;
+
+private:
+    void ReaderThreadMain(int stdout_fd, int stderr_fd);
+    void WriterThreadMain(int stdin_fd);
+    void OnOutgoingMessage(const std::string& message);
+    void OnIncomingMessage(const std::string& message);
+    void CloseStdin();
+    /// send `signo` to the adapter, unless it was already reaped
+    void SignalChild(int signo);
+    void Shutdown();
+
+private:
+    wxEvtHandler* m_owner = nullptr;
+    std::mutex m_child_mutex; // protects m_child_reaped, so the pid is never signalled once it was reaped
+    std::atomic_int m_child_pid{-1};
+    bool m_child_reaped = false;
+    int m_stdin_fd = -1;
+    int m_stdout_fd = -1;
+    int m_stderr_fd = -1;
+    std::unique_ptr<std::thread> m_reader_thread;
+    std::unique_ptr<std::thread> m_writer_thread;
+    wxMessageQueue<std::string> m_incoming;
+    wxMessageQueue<std::string> m_outgoing;
+    std::atomic_bool m_shutdown{false};
+    std::atomic_bool m_terminated{false};
+    std::atomic_bool m_notify_owner{true};
+
+    mutable std::mutex m_latency_mutex;
+    std::unordered_map<long, std::pair<std::string, std::chrono::steady_clock::time_point>> m_pending_requests;
+    std::unordered_map<std::string, Latency> m_latency;
+};
+
+/**
+ * @brief a transport over the stdin / stdout of a `StdioProcess`
+ */
 class StdioTransport : public dap::Transport
 {
 private:
@@ -15,7 +112,10 @@ private:
     StdioTransport& operator=(StdioTransport&&) = delete;
 
 public:
-    StdioTransport() = default;
+    explicit StdioTransport(StdioProcess::Ptr_t process)
+        : m_process(std::move(process))
+    {
+    }
     virtual ~StdioTransport() = default;
 
     /**
@@ -30,7 +130,11 @@ public:
      * @return number of bytes written
      */
     size_t Send(const std::string& buffer) override;
+
+private:
+    StdioProcess::Ptr_t m_process;
 };
+#endif // defined(__WXGTK__) || defined(__WXOSX__)
 
 } // namespace dap
 
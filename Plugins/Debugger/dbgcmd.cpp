@@ -110,10 +110,10 @@ template <typename T>
 wxString get_file_name(const T& node)
 {
     wxString file_name;
-    if (!node["fullname"].value.empty()) {
-        file_name = node["fullname"].value;
-    } else if (!node["pending"].value.empty()) {
-        file_name = node["pending"].value;
+    if (!node["fullname"].raw_value.empty()) {
+        file_name = node["fullname"].value();
+    } else if (!node["pending"].raw_value.empty()) {
+        file_name = node["pending"].value();
         if (file_name.AfterLast(':').IsNumber()) {
             file_name = file_name.BeforeLast(':');
         }
@@ -123,28 +123,13 @@ wxString get_file_name(const T& node)
     return file_name;
 }
 
-void ParseStackEntry(gdbmi::Node& frame, StackEntry& entry)
+void ParseStackEntry(const gdbmi::Node& frame, StackEntry& entry)
 {
-    entry.level = frame["level"].value;
-    entry.address = frame["addr"].value;
-    entry.function = frame["func"].value;
+    entry.level = frame["level"].value();
+    entry.address = frame["addr"].value();
+    entry.function = frame["func"].value();
     entry.file = get_file_name(frame);
-    entry.line = frame["line"].value;
-}
-
-wxString ExtractGdbChild(const std::map<std::string, std::string>& attr, const wxString& name)
-{
-    std::map<std::string, std::string>::const_iterator iter = attr.find(name.mb_str(wxConvUTF8).data());
-    if (iter == attr.end()) {
-        return wxT("");
-    }
-    wxString val = wxString(iter->second.c_str(), wxConvUTF8);
-    val.Trim().Trim(false);
-
-    wxRemoveQuotes(val);
-    val = wxGdbFixValue(val);
-
-    return val;
+    entry.line = frame["line"].value();
 }
 
 // Keep a cache of all file paths converted from
@@ -166,8 +151,8 @@ bool DbgCmdHandlerGetLine::ProcessOutput(const wxString& line)
     // read the file name, giving fullname priority
     filename = get_file_name(result);
 
-    if (!result["line"].value.empty()) {
-        lineNumber = result["line"].value;
+    if (!result["line"].raw_value.empty()) {
+        lineNumber = result["line"].value();
         lineNumber.ToCLong(&line_number);
     }
 
@@ -210,9 +195,9 @@ bool DbgCmdHandlerAsyncCmd::ProcessOutput(const wxString& line)
         return false;
     }
 
-    wxString func = result["frame"]["func"].value;
-    wxString reason = result["reason"].value;
-    wxString signal_name = result["signal-name"].value;
+    wxString func = result["frame"]["func"].value();
+    wxString reason = result["reason"].value();
+    wxString signal_name = result["signal-name"].value();
 
     // Note:
     // This might look like a stupid if-else, since all taking
@@ -355,7 +340,7 @@ bool DbgCmdHandlerAsyncCmd::ProcessOutput(const wxString& line)
         // Return to the caller the gdb-result-var since we might want
         // to create a variable object out of it
         if (result.exists("gdb-result-var")) {
-            wxString gdbVar = result["gdb-result-var"].value;
+            wxString gdbVar = result["gdb-result-var"].value();
             DebuggerEventData evt;
             evt.m_updateReason = DBG_UR_FUNCTIONFINISHED;
             evt.m_expression = gdbVar;
@@ -482,7 +467,7 @@ bool DbgCmdHandlerLocals::ProcessOutput(const wxString& line)
         return false;
     }
 
-    auto variables = result["variables"].children;
+    const auto& variables = result["variables"];
     if (!variables.empty()) {
         // no children
         locals.reserve(variables.size());
@@ -490,8 +475,8 @@ bool DbgCmdHandlerLocals::ProcessOutput(const wxString& line)
             // each entry in the list is also represented as a list
             // with the index as its name
             LocalVariable var;
-            var.name = (*variable)["name"].value;
-            var.value = (*variable)["value"].value;
+            var.name = variable["name"].value();
+            var.value = variable["value"].value();
             if (var.value.empty()) {
                 var.value = "{..}";
             }
@@ -538,17 +523,16 @@ bool DbgCmdStackList::ProcessOutput(const wxString& line)
     gdbmi::ParsedResult result;
 
     parser.parse(line, &result);
-    if (result["stack"].children.empty()) {
+    const auto& stack = result["stack"];
+    if (stack.empty()) {
         return false;
     }
 
-    const auto& stack = result["stack"];
-
     StackEntryArray stackArray;
-    stackArray.reserve(stack.children.size());
-    for (size_t i = 0; i < stack.children.size(); ++i) {
+    stackArray.reserve(stack.size());
+    for (const auto& frame : stack) {
         StackEntry entry;
-        ParseStackEntry(stack[i], entry);
+        ParseStackEntry(frame, entry);
         stackArray.push_back(entry);
     }
 
@@ -618,8 +602,8 @@ bool DbgCmdResolveTypeHandler::ProcessOutput(const wxString& line)
         return true;
 
     } else {
-        var_name = result["name"].value;
-        type_name = result["type"].value;
+        var_name = result["name"].value();
+        type_name = result["type"].value();
     }
 
     // delete the variable object
@@ -707,32 +691,29 @@ bool DbgCmdBreakList::ProcessOutput(const wxString& line)
         return false;
     }
 
-    const auto& body = result["BreakpointTable"]["body"].children;
+    const auto& body = result["BreakpointTable"]["body"];
     if (body.empty()) {
         return false;
     }
 
     li.reserve(body.size());
     // convert gdbmi breakpoint info into clDebuggerBreakpoint construct
-    for (size_t i = 0; i < body.size(); i++) {
+    for (const auto& bkpt : body) {
         clDebuggerBreakpoint breakpoint;
-        auto& bkpt = *body[i];
-
-        // "consume" the values by swapping them
-        breakpoint.what.swap(bkpt["what"].value);
-        breakpoint.at.swap(bkpt["at"].value);
+        breakpoint.what = bkpt["what"].value();
+        breakpoint.at = bkpt["at"].value();
         breakpoint.file = get_file_name(bkpt);
 
-        wxString lineNumber = bkpt["line"].value;
+        wxString lineNumber = bkpt["line"].value();
         if (!lineNumber.empty()) {
             breakpoint.lineno = wxAtoi(lineNumber);
         }
-        wxString ignore = bkpt["ignore"].value;
+        wxString ignore = bkpt["ignore"].value();
         if (!ignore.empty()) {
             breakpoint.ignore_number = wxAtoi(ignore);
         }
 
-        wxString bpId = bkpt["number"].value;
+        wxString bpId = bkpt["number"].value();
         if (!bpId.empty()) {
             breakpoint.debugger_id = wxAtof(bpId);
         }
@@ -787,20 +768,18 @@ bool DbgCmdWatchMemory::ProcessOutput(const wxString& line)
 
     wxString output;
     wxString current_line;
-    size_t rows_count = result["memory"].children.size();
-    if (rows_count) {
-        for (size_t i = 0; i < rows_count; ++i) {
-            const auto& row = result["memory"][i];
-            current_line << row["addr"].value << " ";
+    const auto& rows = result["memory"];
+    if (!rows.empty()) {
+        for (const auto& row : rows) {
+            current_line << row["addr"].value() << " ";
 
             // add the data
-            size_t data_size = row["data"].children.size();
-            for (size_t x = 0; x < data_size; ++x) {
-                current_line << row["data"][x].value << " ";
+            for (const auto& data : row["data"]) {
+                current_line << data.value() << " ";
             }
 
             if (row.exists("ascii")) {
-                current_line << row["ascii"].value;
+                current_line << row["ascii"].value();
             }
             output << current_line << "\n";
             current_line.clear();
@@ -907,11 +886,11 @@ static VariableObjChild FromParserOutput(const gdbmi::Node& child)
 {
     VariableObjChild var_child;
 
-    var_child.varName = child["exp"].value;
-    var_child.type = child["type"].value;
-    var_child.gdbId = child["name"].value;
-    wxString numChild = child["numchild"].value;
-    wxString dynamic = child["dynamic"].value;
+    var_child.varName = child["exp"].value();
+    var_child.type = child["type"].value();
+    var_child.gdbId = child["name"].value();
+    wxString numChild = child["numchild"].value();
+    wxString dynamic = child["dynamic"].value();
 
     if (numChild.IsEmpty() == false) {
         var_child.numChild = wxAtoi(numChild);
@@ -929,11 +908,8 @@ static VariableObjChild FromParserOutput(const gdbmi::Node& child)
     //     child.isAFake = true;
     // }
 
-    // For primitive types, we also get the value
-    var_child.value = child["value"].value;
-    if (!var_child.value.empty()) {
-        var_child.varName << " = " << var_child.value;
-    }
+    // For primitive types, we also get the value (see DbgGdb::ListChildren)
+    var_child.value = child["value"].value();
     return var_child;
 }
 
@@ -949,7 +925,7 @@ bool DbgCmdListChildren::ProcessOutput(const wxString& line)
         return false;
     }
 
-    const auto& children = result["children"].children;
+    const auto& children = result["children"];
     if (children.empty()) {
         return true;
     }
@@ -958,7 +934,7 @@ bool DbgCmdListChildren::ProcessOutput(const wxString& line)
 
     // Convert the parser output to CodeLite data structure
     for (const auto& child : children) {
-        e.m_varObjChildren.push_back(FromParserOutput(*child));
+        e.m_varObjChildren.push_back(FromParserOutput(child));
     }
 
     e.m_updateReason = DBG_UR_LISTCHILDREN;
@@ -978,7 +954,7 @@ bool DbgCmdEvalVarObj::ProcessOutput(const wxString& line)
     gdbmi::Parser parser;
     parser.parse(line, &result);
 
-    wxString display_line = result["value"].value;
+    wxString display_line = result["value"].value();
 
     if (!display_line.empty()) {
         if (m_userReason == DBG_USERR_WATCHTABLE || display_line != "{...}") {
@@ -1046,19 +1022,22 @@ bool DbgVarObjUpdate::ProcessOutput(const wxString& line)
         return false; // let the default loop to handle this as well by passing DBG_CMD_ERR to the observer
     }
 
-    std::string cbuffer = line.mb_str(wxConvUTF8).data();
-    GdbChildrenInfo info;
-    gdbParseListChildren(cbuffer, info);
+    gdbmi::Parser parser;
+    gdbmi::ParsedResult result;
+    parser.parse(line, &result);
 
-    for (const auto& child : info.children) {
-        wxString name = ExtractGdbChild(child, wxT("name"));
-        wxString in_scope = ExtractGdbChild(child, wxT("in_scope"));
-        wxString type_changed = ExtractGdbChild(child, wxT("type_changed"));
-        if (in_scope == wxT("false") || type_changed == wxT("true")) {
+    // gdb reports only the variable objects that changed since the last update
+    for (const auto& child : result["changelist"]) {
+        wxString name = child["name"].value();
+        const auto& in_scope = child["in_scope"].raw_value;
+        if (in_scope == "false" || child["type_changed"].raw_value == "true") {
             e.m_varObjUpdateInfo.removeIds.Add(name);
 
-        } else if (in_scope == wxT("true")) {
+        } else if (in_scope == "true") {
             e.m_varObjUpdateInfo.refreshIds.Add(name);
+            if (child.exists("value")) {
+                e.m_varObjUpdateInfo.values.insert({name, child["value"].value()});
+            }
         }
     }
     e.m_updateReason = DBG_UR_VAROBJUPDATE;
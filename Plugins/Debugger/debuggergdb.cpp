@@ -396,7 +396,7 @@ void DbgGdb::DoCleanup()
     SetIsRemoteDebugging(false);
     SetIsRemoteExtended(false);
     EmptyQueue();
-    m_gdbOutputArr.Clear();
+    m_gdbOutputArr.clear();
     m_bpList.clear();
     m_debuggeeProjectName.Clear();
 
@@ -790,7 +790,7 @@ void DbgGdb::Poke()
 
     // poll the debugger output
     wxString curline;
-    if (!m_gdbProcess || m_gdbOutputArr.IsEmpty()) {
+    if (!m_gdbProcess || m_gdbOutputArr.empty()) {
         return;
     }
 
@@ -1285,7 +1285,9 @@ DbgCmdCLIHandler* DbgGdb::GetCliHandler() { return m_cliHandler; }
 bool DbgGdb::ListChildren(const wxString& name, int userReason)
 {
     wxString cmd;
-    cmd << "-var-list-children " << WrapSpaces(name);
+    // --simple-values: the values of the scalar children come with the list, saving a -var-evaluate-expression round
+    // trip per child
+    cmd << "-var-list-children --simple-values " << WrapSpaces(name);
     if (m_info.maxDisplayElements > 0) {
         cmd << " " << 0 << " " << m_info.maxDisplayElements;
     }
@@ -1348,18 +1350,13 @@ void DbgGdb::OnDataRead(clProcessEvent& e)
         lines.RemoveAt(lines.GetCount() - 1);
     }
 
-    // make sure we have enough memory for the new lines
-
-    m_gdbOutputArr.reserve(m_gdbOutputArr.size() + lines.size());
-    for (size_t i = 0; i < lines.GetCount(); ++i) {
-        wxString& line = lines.Item(i);
-
+    for (wxString& line : lines) {
         line.Replace("(gdb)", "");
         line.Trim().Trim(false);
         if (line.empty()) {
             continue;
         }
-        m_gdbOutputArr.Add(line);
+        m_gdbOutputArr.push_back(std::move(line));
     }
 
     if (!m_gdbOutputArr.empty()) {
@@ -1371,16 +1368,12 @@ void DbgGdb::OnDataRead(clProcessEvent& e)
 bool DbgGdb::DoGetNextLine(wxString& line)
 {
     line.Clear();
-    if (m_gdbOutputArr.IsEmpty()) {
-        return false;
-    }
-    line = m_gdbOutputArr.Item(0);
-    m_gdbOutputArr.RemoveAt(0);
-    line.Replace("(gdb)", "");
-    line.Trim().Trim(false);
-    if (line.IsEmpty()) {
+    if (m_gdbOutputArr.empty()) {
         return false;
     }
+    // the lines were already cleaned by OnDataRead()
+    line = std::move(m_gdbOutputArr.front());
+    m_gdbOutputArr.pop_front();
     return true;
 }
 
@@ -1427,7 +1420,7 @@ bool DbgGdb::UpdateVariableObject(const wxString& name, int userReason)
 bool DbgGdb::UpdateWatch(const wxString& name)
 {
     wxString cmd;
-    cmd << "-var-update " << name;
+    cmd << "-var-update --simple-values " << name;
     return WriteCommand(cmd, new DbgVarObjUpdate(m_observer, this, name, DBG_USERR_WATCHTABLE));
 }
 
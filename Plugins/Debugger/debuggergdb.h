@@ -31,6 +31,7 @@
 #include "debugger.h"
 #include "ssh/ssh_account_info.h"
 
+#include <deque>
 #include <vector>
 #include <wx/event.h>
 #include <wx/hashmap.h>
@@ -58,7 +59,7 @@ class DbgGdb : public wxEvtHandler, public IDebugger
     std::vector<clDebuggerBreakpoint> m_bpList;
     DbgCmdCLIHandler* m_cliHandler;
     IProcess* m_gdbProcess;
-    wxArrayString m_gdbOutputArr;
+    std::deque<wxString> m_gdbOutputArr;
     wxString m_gdbOutputIncompleteLine;
     bool m_break_at_main;
     bool m_attachedMode;
@@ -2,41 +2,69 @@
 
 #include <cctype>
 #include <iostream>
-#include <memory>
-#include <sstream>
-#include <stdexcept>
-#include <unordered_map>
-#include <unordered_set>
-#include <vector>
-
-thread_local gdbmi::Node emptyNode;
 
 namespace
 {
-std::unordered_map<wxString, gdbmi::eToken> words = {
-    {"done", gdbmi::T_DONE},
-    {"running", gdbmi::T_RUNNING},
-    {"connected", gdbmi::T_CONNECTED},
-    {"error", gdbmi::T_ERROR},
-    {"exit", gdbmi::T_EXIT},
-    {"stopped", gdbmi::T_STOPPED},
+const gdbmi::Node& empty_node()
+{
+    thread_local gdbmi::Node emptyNode;
+    return emptyNode;
+}
+
+struct Word {
+    const char* text;
+    gdbmi::eToken type;
+};
+
+constexpr Word words[] = {
+    {"done", gdbmi::T_DONE},       {"running", gdbmi::T_RUNNING}, {"connected", gdbmi::T_CONNECTED},
+    {"error", gdbmi::T_ERROR},     {"exit", gdbmi::T_EXIT},       {"stopped", gdbmi::T_STOPPED},
 };
 
-void trim_both(wxString& str)
+inline bool is_trim_char(wxChar ch) { return ch == ' ' || ch == '\r' || ch == '\n' || ch == '\t' || ch == '\v'; }
+
+inline bool is_word_char(wxChar ch) { return (ch < 128 && std::isalnum(ch)) || ch == '-' || ch == '_'; }
+
+/// true if `ch` is not part of the MI syntax: it is skipped like a whitespace
+inline bool is_ignored_char(wxChar ch)
 {
-    static wxString trimString(" \r\n\t\v");
-    str.erase(0, str.find_first_not_of(trimString));
-    str.erase(str.find_last_not_of(trimString) + 1);
+    switch (ch) {
+    case '{':
+    case '}':
+    case '[':
+    case ']':
+    case '=':
+    case '^':
+    case '*':
+    case '+':
+    case '@':
+    case '&':
+    case '~':
+    case ',':
+    case '"':
+        return false;
+    default:
+        return !is_word_char(ch);
+    }
 }
+} // namespace
 
-void strip_double_backslashes(wxString& str)
+wxString gdbmi::Node::value() const
 {
+    // gdb escapes backslashes and double quotes. Drop the escaping backslashes while copying the value out of the
+    // record, and trim it
+    size_t start = 0;
+    size_t end = raw_value.length();
+    while (start < end && is_trim_char(raw_value[start])) {
+        ++start;
+    }
+
     wxString fixed_str;
-    fixed_str.reserve(str.length());
+    fixed_str.reserve(end - start);
 
     wxChar last_char = 0;
-    for (size_t i = 0; i < str.length(); ++i) {
-        wxChar ch = str[i];
+    for (size_t i = start; i < end; ++i) {
+        wxChar ch = raw_value[i];
         if (ch == '\\' && last_char == '\\') {
             // do nothing
         } else if (ch == '"' && last_char == '\\') {
@@ -50,18 +78,53 @@ void strip_double_backslashes(wxString& str)
         }
         last_char = ch;
     }
-    str.swap(fixed_str);
-    trim_both(str);
+
+    size_t len = fixed_str.length();
+    while (len > 0 && is_trim_char(fixed_str[len - 1])) {
+        --len;
+    }
+    fixed_str.erase(len);
+    return fixed_str;
 }
 
-} // namespace
+const gdbmi::Node& gdbmi::Node::find_child(const wxString& name) const
+{
+    const Node* child = find_child_ptr(name);
+    return child ? *child : empty_node();
+}
 
-gdbmi::Node::ptr_t gdbmi::Node::add_child(const wxString& name, const wxString& value)
+const gdbmi::Node& gdbmi::Node::find_child(const char* name) const
 {
-    auto c = do_add_child(name);
-    c->value = std::move(value);
-    strip_double_backslashes(c->value);
-    return c;
+    const Node* child = find_child_ptr(name);
+    return child ? *child : empty_node();
+}
+
+const gdbmi::Node& gdbmi::Node::operator[](size_t index) const
+{
+    if (index >= children_count) {
+        return empty_node();
+    }
+
+    const Node* child = first_child;
+    for (; index > 0; --index) {
+        child = child->next;
+    }
+    return *child;
+}
+
+gdbmi::Node* gdbmi::ParsedResult::add_child(Node* parent, StringView name, StringView value)
+{
+    Node* child = &m_arena.emplace_back();
+    child->name = name;
+    child->raw_value = value;
+    if (parent->last_child) {
+        parent->last_child->next = child;
+    } else {
+        parent->first_child = child;
+    }
+    parent->last_child = child;
+    ++parent->children_count;
+    return child;
 }
 
 #define CHECK_EOF()                       \
@@ -89,9 +152,10 @@ gdbmi::StringView gdbmi::Tokenizer::next_token(eToken* type)
     *type = T_EOF;
     StringView curbuf;
 
-    // skip leading whitespaces
+    // skip leading whitespaces, and the characters that can't start a token (e.g. the ':' of a line that is not an
+    // MI record): they would never be consumed
     for (; m_pos < m_buffer.length(); ++m_pos) {
-        if (m_buffer[m_pos] == ' ' || m_buffer[m_pos] == '\t') {
+        if (m_buffer[m_pos] == ' ' || m_buffer[m_pos] == '\t' || is_ignored_char(m_buffer[m_pos])) {
             continue;
         }
         break;
@@ -134,14 +198,14 @@ gdbmi::StringView gdbmi::Tokenizer::next_token(eToken* type)
     } else {
 
         auto w = read_word(type);
-        wxString as_str = w.to_string();
-        if (words.count(as_str)) {
-            *type = words[as_str];
-            return w;
-        } else {
-            *type = T_WORD;
-            return w;
+        for (const auto& word : words) {
+            if (w == word.text) {
+                *type = word.type;
+                return w;
+            }
         }
+        *type = T_WORD;
+        return w;
     }
 }
 
@@ -195,7 +259,7 @@ gdbmi::StringView gdbmi::Tokenizer::remainder()
 gdbmi::StringView gdbmi::Tokenizer::read_word(eToken* type)
 {
     size_t start_pos = m_pos;
-    while (std::isalnum(m_buffer[m_pos]) || m_buffer[m_pos] == '-' || m_buffer[m_pos] == '_') {
+    while (m_pos < m_buffer.length() && is_word_char(m_buffer[m_pos])) {
         ++m_pos;
     }
     *type = T_WORD;
@@ -290,10 +354,10 @@ void gdbmi::Parser::parse(const wxString& buffer, ParsedResult* result)
             break;
         }
     }
-    parse_properties(&tokenizer, result->tree);
+    parse_properties(&tokenizer, result, result->tree);
 }
 
-void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
+void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, ParsedResult* result, Node* parent)
 {
     gdbmi::eToken token;
 
@@ -324,7 +388,7 @@ void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
             case T_CSTRING: {
                 // an array look-a-like
                 // create a fake entry id
-                parent->add_child("", s.to_string());
+                result->add_child(parent, {}, s);
                 break;
             }
             case T_TUPLE_CLOSE:
@@ -332,7 +396,7 @@ void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
                 return;
             case T_TUPLE_OPEN:
             case T_LIST_OPEN: {
-                parse_properties(tokenizer, parent->add_child());
+                parse_properties(tokenizer, result, result->add_child(parent, {}));
                 state = STATE_NAME;
                 RESET_PROP();
                 break;
@@ -365,7 +429,7 @@ void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
                 return;
             case T_TUPLE_OPEN:
             case T_LIST_OPEN: {
-                parse_properties(tokenizer, parent->add_child(name.to_string()));
+                parse_properties(tokenizer, result, result->add_child(parent, name));
                 state = STATE_NAME;
                 RESET_PROP();
                 break;
@@ -373,7 +437,7 @@ void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
             case T_CSTRING: {
                 state = STATE_NAME;
                 value = s;
-                parent->add_child(name.to_string(), value.to_string());
+                result->add_child(parent, name, value);
                 RESET_PROP();
                 break;
             }
@@ -386,27 +450,19 @@ void gdbmi::Parser::parse_properties(Tokenizer* tokenizer, Node::ptr_t parent)
 #undef RESET_PROP
 }
 
-void gdbmi::Parser::print(Node::ptr_t node, int depth)
+void gdbmi::Parser::print(const Node& node, int depth)
 {
     std::cout << wxString(depth, ' ');
-    if (!node->name.empty()) {
-        std::cout << node->name;
+    if (!node.name.empty()) {
+        std::cout << node.name.to_string();
     }
 
-    if (!node->value.empty()) {
-        std::cout << " -> " << node->value;
+    if (!node.raw_value.empty()) {
+        std::cout << " -> " << node.value();
     }
     std::cout << std::endl;
 
-    for (auto child : node->children) {
+    for (const auto& child : node) {
         print(child, depth + 4);
     }
 }
-
-gdbmi::Node& gdbmi::Node::find_child(const wxString& name) const
-{
-    if (children_map.count(name) == 0) {
-        return emptyNode;
-    }
-    return *(children_map.find(name)->second);
-}
@@ -1,10 +1,9 @@
 #ifndef GDBMI_HPP
 #define GDBMI_HPP
 
-#include <memory>
-#include <unordered_map>
-#include <utility>
-#include <vector>
+#include <deque>
+#include <iterator>
+#include <string>
 #include <wx/string.h>
 
 namespace gdbmi
@@ -71,8 +70,25 @@ struct StringView {
 
     const wxChar* data() const { return m_pdata; }
     size_t length() const { return m_length; }
-    char operator[](size_t index) const { return m_pdata[index]; }
+    wxChar operator[](size_t index) const { return m_pdata[index]; }
     bool empty() const { return m_length == 0; }
+
+    /// compare with an ASCII string, without converting it to a wxString first
+    bool operator==(const char* str) const
+    {
+        size_t i = 0;
+        for (; i < m_length && str[i]; ++i) {
+            if (m_pdata[i] != static_cast<wxChar>(static_cast<unsigned char>(str[i]))) {
+                return false;
+            }
+        }
+        return i == m_length && str[i] == 0;
+    }
+    bool operator==(const wxString& str) const
+    {
+        return str.length() == m_length &&
+               (m_length == 0 || std::char_traits<wxChar>::compare(m_pdata, str.wc_str(), m_length) == 0);
+    }
 };
 
 class Tokenizer
@@ -93,67 +109,113 @@ public:
     StringView remainder();
 };
 
+/**
+ * @brief a node of the parsed record. Nodes are allocated from the `ParsedResult` arena and their names and values
+ * point into the parsed line, so the line must outlive the `ParsedResult`. Children are kept as a linked list and
+ * looked up linearly: MI tuples are small, lists are iterated in order.
+ */
 struct Node {
-public:
-    using ptr_t = std::shared_ptr<Node>;
-    using vec_t = std::vector<ptr_t>;
-
-private:
-    ptr_t do_add_child(const wxString& name)
+    class iterator
     {
-        children.emplace_back(std::make_shared<Node>());
-        auto child = children.back();
-        child->name = std::move(name);
-        children_map.insert({ child->name, child });
-        return child;
-    }
-
-public:
-    wxString name;
-    wxString value; // optional
-    vec_t children;
-    std::unordered_map<wxString, ptr_t> children_map;
-
-    Node() = default;
-    Node& find_child(const wxString& name) const;
-    Node& operator[](const wxString& name) const { return find_child(name); }
-    Node& operator[](size_t index) const
-    {
-        if(index >= children.size()) {
-            thread_local Node emptyNode;
-            return emptyNode;
+        const Node* m_node = nullptr;
+
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Node;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Node*;
+        using reference = const Node&;
+
+        iterator() = default;
+        explicit iterator(const Node* node)
+            : m_node(node)
+        {
         }
-        return *(children[index].get());
-    }
-
-    ptr_t add_child()
+        reference operator*() const { return *m_node; }
+        pointer operator->() const { return m_node; }
+        iterator& operator++()
+        {
+            m_node = m_node->next;
+            return *this;
+        }
+        iterator operator++(int)
+        {
+            iterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+        bool operator==(const iterator& other) const { return m_node == other.m_node; }
+        bool operator!=(const iterator& other) const { return m_node != other.m_node; }
+    };
+
+    StringView name;      // empty for list items
+    StringView raw_value; // as found in the record, still escaped
+    Node* first_child = nullptr;
+    Node* last_child = nullptr;
+    Node* next = nullptr;
+    size_t children_count = 0;
+
+    /// the unescaped value
+    wxString value() const;
+
+    template <typename T>
+    const Node* find_child_ptr(const T& name) const
     {
-        wxString s;
-        s << children.size();
-        return do_add_child(s);
+        for (const Node* child = first_child; child; child = child->next) {
+            if (child->name == name) {
+                return child;
+            }
+        }
+        return nullptr;
     }
 
-    ptr_t add_child(const wxString& name, const wxString& value = {});
-    bool exists(const wxString& name) const { return children_map.count(name) > 0; }
+    const Node& find_child(const wxString& name) const;
+    const Node& find_child(const char* name) const;
+    const Node& operator[](const wxString& name) const { return find_child(name); }
+    const Node& operator[](const char* name) const { return find_child(name); }
+    /// Walks the children list, use the iterators to visit all the children
+    const Node& operator[](size_t index) const;
+    const Node& operator[](int index) const { return (*this)[static_cast<size_t>(index)]; }
+    bool exists(const wxString& name) const { return find_child_ptr(name) != nullptr; }
+    bool exists(const char* name) const { return find_child_ptr(name) != nullptr; }
+
+    iterator begin() const { return iterator(first_child); }
+    iterator end() const { return iterator(); }
+    size_t size() const { return children_count; }
+    bool empty() const { return children_count == 0; }
 };
 
 struct ParsedResult {
     eLineType line_type = LT_INVALID;
     StringView line_type_context; // depends on the line type, this will hold the context string
     StringView txid;              //  optional
-    Node::ptr_t tree = std::make_shared<Node>();
-    Node& operator[](const wxString& index) const { return tree->find_child(index); }
+
+    ParsedResult() { tree = &m_arena.emplace_back(); }
+    ParsedResult(const ParsedResult&) = delete;
+    ParsedResult& operator=(const ParsedResult&) = delete;
+
+    Node* tree = nullptr;
+    const Node& operator[](const wxString& index) const { return tree->find_child(index); }
+    const Node& operator[](const char* index) const { return tree->find_child(index); }
     bool exists(const wxString& name) const { return tree->exists(name); }
+    bool exists(const char* name) const { return tree->exists(name); }
+
+    /// allocate a new node and append it to `parent`
+    Node* add_child(Node* parent, StringView name, StringView value = {});
+
+private:
+    /// deque: growing the arena never moves the nodes already allocated
+    std::deque<Node> m_arena;
 };
 
 class Parser
 {
 private:
-    void parse_properties(Tokenizer* tokenizer, Node::ptr_t parent);
+    void parse_properties(Tokenizer* tokenizer, ParsedResult* result, Node* parent);
 
 public:
     void parse(const wxString& buffer, ParsedResult* result);
-    void print(Node::ptr_t node, int depth = 0);
+    void print(const Node& node, int depth = 0);
 };
 } // namespace gdbmi
 
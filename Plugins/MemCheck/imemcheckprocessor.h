@@ -98,6 +98,12 @@ public:
      * @brief Processes data from external tool (log file) to ErrorList.
      */
     virtual bool Process(const wxString& outputLogFileName = wxEmptyString) = 0;
+
+    /**
+     * @brief Processes what the external tool added to its log since the last call, while it is still running.
+     * @return number of errors appended to errorList
+     */
+    virtual size_t ProcessPending() { return 0; }
 };
 
 #endif //_IMEMCHECKPROCESSOR_H_
@@ -42,9 +42,11 @@ CL_PLUGIN_API int GetPluginInterfaceVersion() { return PLUGIN_INTERFACE_VERSION;
 MemCheckPlugin::MemCheckPlugin(IManager* manager)
     : IPlugin(manager)
     , m_memcheckProcessor(NULL)
+    , m_logTimer(this)
 {
     m_terminal.Bind(wxEVT_TERMINAL_COMMAND_EXIT, &MemCheckPlugin::OnProcessTerminated, this);
     m_terminal.Bind(wxEVT_TERMINAL_COMMAND_OUTPUT, &MemCheckPlugin::OnProcessOutput, this);
+    Bind(wxEVT_TIMER, &MemCheckPlugin::OnLogTimer, this, m_logTimer.GetId());
 
     // CL_DEBUG1(PLUGIN_PREFIX("MemCheckPlugin constructor"));
     m_longName = _("Detects memory management problems. Uses Valgrind - memcheck skin.");
@@ -207,8 +209,10 @@ void MemCheckPlugin::HookPopupMenu(wxMenu* menu, MenuType type)
 void MemCheckPlugin::UnPlug()
 {
     m_tabHelper.reset();
+    m_logTimer.Stop();
     m_terminal.Unbind(wxEVT_TERMINAL_COMMAND_EXIT, &MemCheckPlugin::OnProcessTerminated, this);
     m_terminal.Unbind(wxEVT_TERMINAL_COMMAND_OUTPUT, &MemCheckPlugin::OnProcessOutput, this);
+    Unbind(wxEVT_TIMER, &MemCheckPlugin::OnLogTimer, this, m_logTimer.GetId());
 
     m_mgr->GetTheApp()->Disconnect(XRCID("memcheck_check_active_project"),
                                    wxEVT_COMMAND_MENU_SELECTED,
@@ -356,7 +360,6 @@ void MemCheckPlugin::CheckProject(const wxString& projectName)
     wxString wd;
     wxString command = PrepareCommand(projectName, wd);
 
-    m_outputView->Clear(); // To reduce the risk of confusion, clear any current errors before running
     DirSaver ds;
     EnvSetter envGuard(m_mgr->GetEnv());
     wxSetWorkingDirectory(path);
@@ -367,9 +370,12 @@ void MemCheckPlugin::CheckProject(const wxString& projectName)
     wxString cmd;
     wxString cmdArgs;
     m_memcheckProcessor->GetExecutionCommand(command, cmd, cmdArgs);
+    m_outputView->LoadErrors(); // To reduce the risk of confusion, clear any current errors before running
     m_mgr->AppendOutputTabText(
         kOutputTab_Output, wxString() << _("MemCheck command: ") << command << " " << cmdArgs << "\n");
-    m_terminal.ExecuteConsole(cmd, true, cmdArgs, "", wxString::Format("MemCheck: %s", projectName));
+    if (m_terminal.ExecuteConsole(cmd, true, cmdArgs, "", wxString::Format("MemCheck: %s", projectName))) {
+        m_logTimer.Start(LOG_POLL_INTERVAL);
+    }
 }
 
 void MemCheckPlugin::OnImportLog(wxCommandEvent& event)
@@ -423,6 +429,7 @@ void MemCheckPlugin::OnProcessOutput(clCommandEvent& event)
 
 void MemCheckPlugin::OnProcessTerminated(clCommandEvent& event)
 {
+    m_logTimer.Stop();
     m_mgr->AppendOutputTabText(kOutputTab_Output, _("\n-- MemCheck process completed\n"));
     wxBusyInfo wait(BUSY_MESSAGE);
     m_mgr->GetTheApp()->Yield();
@@ -432,6 +439,14 @@ void MemCheckPlugin::OnProcessTerminated(clCommandEvent& event)
     SwitchToMyPage();
 }
 
+void MemCheckPlugin::OnLogTimer(wxTimerEvent& event)
+{
+    wxUnusedVar(event);
+    if (m_memcheckProcessor->ProcessPending()) {
+        m_outputView->ErrorsAdded();
+    }
+}
+
 void MemCheckPlugin::OnStopProcess(wxCommandEvent& event)
 {
     wxUnusedVar(event);
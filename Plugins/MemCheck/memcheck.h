@@ -39,6 +39,8 @@
 #include "memcheckui.hpp"
 #include "plugin.h"
 
+#include <wx/timer.h>
+
 class MemCheckOutputView;
 
 class MemCheckPlugin : public IPlugin
@@ -85,6 +87,7 @@ protected:
     IMemCheckProcessor* m_memcheckProcessor;
     MemCheckSettings* m_settings;
     TerminalEmulator m_terminal;
+    wxTimer m_logTimer; ///< reads the log while the test is running
     MemCheckOutputView* m_outputView; ///< Main plugin UI pane.
     clTabTogglerHelper::Ptr_t m_tabHelper;
 
@@ -137,6 +140,7 @@ protected:
 
     void OnProcessOutput(clCommandEvent& event);
     void OnProcessTerminated(clCommandEvent& event);
+    void OnLogTimer(wxTimerEvent& event);
 
     /**
      * @brief Analyse can be made independent of CodeLite and log can be load from file.
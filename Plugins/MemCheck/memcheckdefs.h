@@ -41,5 +41,10 @@
 #define FILTER_NONWORKSPACE_PLACEHOLDER "<nonworkspace_errors>"
 #define WAIT_UPDATE_PER_ITEMS 1000
 #define ITEMS_FOR_WAIT_DIALOG 5000
+#define MAX_UNIQUE_ERRORS 100000            // distinct errors kept, the others are only counted
+#define LOG_READ_CHUNK_SIZE (64 * 1024)     // bytes fed to the xml reader at once
+#define LOG_READ_PER_POLL (4 * 1024 * 1024) // bytes read from the log of a running test per poll
+#define LOG_POLL_INTERVAL 500               // ms
+#define WAIT_UPDATE_PER_CHUNKS 16
 
 #endif
@@ -55,6 +55,7 @@ bool MemCheckErrorLocation::isOutOfWorkspace(const wxString& workspacePath) cons
 
 MemCheckError::MemCheckError()
     : suppressed(false)
+    , count(1)
 {
 }
 
@@ -186,6 +186,7 @@ public:
 
     Type type;
     bool suppressed;
+    unsigned int count; ///< how many times Valgrind reported this error (same label and stack)
     wxString label;
     wxString suppression;
     LocationList locations;
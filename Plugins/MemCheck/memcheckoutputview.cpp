@@ -104,6 +104,40 @@ void MemCheckOutputView::LoadErrors()
     ApplyFilterSupp(FILTER_CLEAR);
 }
 
+void MemCheckOutputView::ErrorsAdded()
+{
+    size_t pageSize = m_plugin->GetSettings()->GetResultPageSize();
+    size_t shown = std::min(m_totalErrorsView, pageSize);
+    ResetItemsView();
+
+    // only the first page is filled while the test runs: errors are only appended, so the rows already shown stay
+    // valid and nothing is redrawn once the page is full
+    if (m_currentPage > 1 || shown >= pageSize || m_totalErrorsView == shown)
+        return;
+
+    if (m_currentPage == 0) {
+        m_currentPage = 1;
+        pageValidator.TransferToWindow();
+    }
+    m_currentPageIsEmptyView = false;
+
+    unsigned int flags = 0;
+    if (m_plugin->GetSettings()->GetOmitNonWorkspace())
+        flags |= MC_IT_OMIT_NONWORKSPACE;
+    if (m_plugin->GetSettings()->GetOmitDuplications())
+        flags |= MC_IT_OMIT_DUPLICATIONS;
+    if (m_plugin->GetSettings()->GetOmitSuppressed())
+        flags |= MC_IT_OMIT_SUPPRESSED;
+
+    ErrorList& errorList = m_plugin->GetProcessor()->GetErrors();
+    size_t i = 0;
+    MemCheckIterTools::ErrorListIterator it = MemCheckIterTools::Factory(errorList, m_workspacePath, flags);
+    for (; it != errorList.end() && i < pageSize; ++it, ++i) {
+        if (i >= shown)
+            AddTree(wxDataViewItem(0), *it);
+    }
+}
+
 void MemCheckOutputView::ResetItemsView()
 {
     ErrorList& errorList = m_plugin->GetProcessor()->GetErrors();
@@ -223,11 +257,15 @@ void MemCheckOutputView::AddTree(const wxDataViewItem& parentItem, MemCheckError
     wxVariant variantBitmap;
     variantBitmap << wxXmlResource::Get()->LoadBitmap(wxT("memcheck_transparent"));
 
+    wxString label = error.label;
+    if (error.count > 1)
+        label << wxString::Format(" (%u times)", error.count);
+
     wxVector<wxVariant> cols;
     cols.push_back(variantBitmap);
     cols.push_back(wxVariant(false));
     cols.push_back(MemCheckDVCErrorsModel::CreateIconTextVariant(
-        error.label,
+        label,
         (error.type == MemCheckError::TYPE_AUXILIARY ? wxXmlResource::Get()->LoadBitmap(wxT("memcheck_auxiliary"))
                                                      : wxXmlResource::Get()->LoadBitmap(wxT("memcheck_error")))));
     cols.push_back(wxString());
@@ -178,6 +178,12 @@ public:
      * MemCheck plugin calls this method after test ends and after processor parses logfile into ErrorList.
      */
     void LoadErrors();
+    /**
+     * @brief Update the page count and fill the first page with the errors appended to ErrorList.
+     *
+     * MemCheck plugin calls this method while the test is running, each time the processor reads new errors.
+     */
+    void ErrorsAdded();
     /**
      * @brief clear the content
      */
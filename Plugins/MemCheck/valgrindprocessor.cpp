@@ -7,14 +7,20 @@
 
 #include "valgrindprocessor.h"
 
+#include "file_logger.h"
+#include "memcheckdefs.h"
 #include "memchecksettings.h"
 #include "workspace.h"
 
+#include <algorithm>
+#include <cstdio>
+#include <vector>
 #include <wx/app.h>
 #include <wx/textfile.h>
 
 ValgrindMemcheckProcessor::ValgrindMemcheckProcessor(MemCheckSettings* const settings)
     : IMemCheckProcessor(settings)
+    , m_reader([this](MemCheckError&& error) { AddError(std::move(error)); })
 {
 }
 
@@ -35,6 +41,7 @@ void ValgrindMemcheckProcessor::GetExecutionCommand(const wxString& originalComm
                                                     wxString& command,
                                                     wxString& command_args)
 {
+    ResetLog();
     m_outputLogFileName = m_settings->GetValgrindSettings().GetOutputFile();
     if (m_settings->GetValgrindSettings().GetOutputInPrivateFolder() && m_outputLogFileName.IsEmpty())
         if (m_settings->GetValgrindSettings().GetOutputInPrivateFolder() || m_outputLogFileName.IsEmpty()) {
@@ -46,6 +53,10 @@ void ValgrindMemcheckProcessor::GetExecutionCommand(const wxString& originalComm
                     wxFileName(clStandardPaths::Get().GetTempDir(), "valgrind.memcheck.log.xml").GetFullPath();
         }
 
+    // the log is read while Valgrind writes it, make sure the previous one is not picked up before it is replaced
+    if (!m_outputLogFileName.IsEmpty() && wxFileName::FileExists(m_outputLogFileName))
+        wxRemoveFile(m_outputLogFileName);
+
     wxString suppressions;
     for (const auto& suppressionFile : GetSuppressionFiles())
         suppressions.Append(
@@ -65,27 +76,67 @@ bool ValgrindMemcheckProcessor::Process(const wxString& outputLogFileName)
 {
     // CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::Process()"));
 
-    if (!outputLogFileName.IsEmpty())
+    if (!outputLogFileName.IsEmpty()) {
         m_outputLogFileName = outputLogFileName;
+        ResetLog();
+    }
 
-    wxXmlDocument doc;
-    if (!doc.Load(m_outputLogFileName) || doc.GetRoot()->GetName() != wxT("valgrindoutput")) {
+    m_newErrors = 0;
+    if (!ReadLog(0) || !m_reader.IsValgrindOutput()) {
         return false;
     }
+
+    if (m_omittedErrors) {
+        clWARNING() << "MemCheck: too many distinct errors," << m_omittedErrors << "errors were not loaded" << endl;
+    }
+    return true;
+}
+
+size_t ValgrindMemcheckProcessor::ProcessPending()
+{
+    m_newErrors = 0;
+    ReadLog(LOG_READ_PER_POLL);
+    return m_newErrors;
+}
+
+void ValgrindMemcheckProcessor::ResetLog()
+{
+    if (m_log.IsOpened()) {
+        m_log.Close();
+    }
+    m_reader.Reset();
     m_errorList.clear();
+    m_errorIndex.clear();
+    m_newErrors = 0;
+    m_omittedErrors = 0;
+}
+
+bool ValgrindMemcheckProcessor::ReadLog(size_t maxBytes)
+{
+    if (!m_log.IsOpened()) {
+        if (m_outputLogFileName.IsEmpty() || !wxFileName::FileExists(m_outputLogFileName) ||
+            !m_log.Open(m_outputLogFileName, "rb")) {
+            return false;
+        }
+    }
+
+    // the log may still be written by Valgrind: forget the end of file reached by the previous read
+    clearerr(m_log.fp());
 
+    std::vector<char> chunk(LOG_READ_CHUNK_SIZE);
+    size_t total = 0;
     int i = 0;
-    wxXmlNode* errorNode = doc.GetRoot()->GetChildren();
-    while (errorNode) {
-        if (errorNode->GetName() == wxT("error")) {
-            m_errorList.push_back(ProcessError(doc, errorNode));
+    while (maxBytes == 0 || total < maxBytes) {
+        size_t count = m_log.Read(chunk.data(), chunk.size());
+        if (count == 0) {
+            break;
+        }
+        total += count;
+        if (!m_reader.Feed(chunk.data(), count)) {
+            return false;
         }
-        errorNode = errorNode->GetNext();
 
-        if (i < 1000)
-            i++;
-        else {
-            i = 0;
+        if (maxBytes == 0 && ++i % WAIT_UPDATE_PER_CHUNKS == 0) {
             // ATTN  m_mgr->GetTheApp()
             wxTheApp->Yield();
         }
@@ -93,112 +144,51 @@ bool ValgrindMemcheckProcessor::Process(const wxString& outputLogFileName)
     return true;
 }
 
-MemCheckError ValgrindMemcheckProcessor::ProcessError(wxXmlDocument& doc, wxXmlNode* errorNode)
+namespace
 {
-    // CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::ProcessError()"));
-
-    bool auxiliary = false;
-    MemCheckError result;
-    result.type = MemCheckError::TYPE_ERROR;
-    MemCheckError auxiliaryResult;
-
-    wxXmlNode* suberrorNode = errorNode->GetChildren();
-    while (suberrorNode) {
-
-        // retrieving error label
-        if (suberrorNode->GetName() == wxT("what")) {
-            result.label = suberrorNode->GetNodeContent();
-        } else if (suberrorNode->GetName() == wxT("xwhat")) {
-            wxXmlNode* child = suberrorNode->GetChildren();
-            while (child) {
-                if (child->GetName() == wxT("text")) {
-                    result.label = child->GetNodeContent();
-                    break;
-                }
-                child = child->GetNext();
-            }
-        } else if (suberrorNode->GetName() == wxT("auxwhat")) {
-            auxiliaryResult.label = suberrorNode->GetNodeContent();
-            auxiliaryResult.type = MemCheckError::TYPE_AUXILIARY;
-            auxiliary = true;
-        } else if (suberrorNode->GetName() == wxT("stack")) {
-            wxXmlNode* locationNode = suberrorNode->GetChildren();
-            while (locationNode) {
-                if (locationNode->GetName() == wxT("frame")) {
-                    if (auxiliary) {
-                        auxiliaryResult.locations.push_back(ProcessLocation(doc, locationNode));
-                    } else {
-                        result.locations.push_back(ProcessLocation(doc, locationNode));
-                    }
-                }
-                locationNode = locationNode->GetNext();
-            }
-        } else if (suberrorNode->GetName() == wxT("suppression")) {
-            wxXmlNode* child = suberrorNode->GetChildren();
-            while (child) {
-                if (child->GetName() == wxT("rawtext")) {
-                    result.suppression = child->GetNodeContent();
-                    break;
-                }
-                child = child->GetNext();
-            }
-        }
-        suberrorNode = suberrorNode->GetNext();
+void HashCombine(size_t& seed, size_t value) { seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2); }
+
+size_t HashError(const MemCheckError& error)
+{
+    size_t seed = std::hash<wxString>{}(error.label);
+    for (const auto& location : error.locations) {
+        HashCombine(seed, std::hash<wxString>{}(location.func));
+        HashCombine(seed, std::hash<wxString>{}(location.file));
+        HashCombine(seed, std::hash<int>{}(location.line));
+    }
+    for (const auto& nestedError : error.nestedErrors) {
+        HashCombine(seed, HashError(nestedError));
     }
+    return seed;
+}
 
-    if (!result.suppression)
-        result.suppression =
-            wxT("#Suppression pattern not present in output log.\n#This plugin requires Valgrind to be "
-                "run with '--gen-suppressions=all' option");
-
-    if (auxiliary)
-        result.nestedErrors.push_back(auxiliaryResult);
-
-    // TODO ? add checkout ?
-    // add check for empty locationArrays
-    //  CL_DEBUG1(PLUGIN_PREFIX("\t equal #0 and #1 = %s", (errorArray.Item(0) == errorArray.Item(1)?"true":"false") ));
-    //  CL_DEBUG1(PLUGIN_PREFIX("\t equal #1 and #2 = %s", (*(errorArray.Item(2)) ==
-    //  *(errorArray.Item(1))?"true":"false") )); CL_DEBUG1(PLUGIN_PREFIX("\t equal #2 and #3 = %s", (errorArray.Item(2)
-    //  == errorArray.Item(3)?"true":"false") ));
-
-    // check if required fields was found
-    //  CL_ERROR1(PLUGIN_PREFIX("Broken input, tag <what> or <xwhat> not found, can't continue!"));
-    //  CL_ERROR1(PLUGIN_PREFIX("Broken input, tag <stack> not found, can't continue!"));
-    return result;
+bool IsSameError(const MemCheckError& lhs, const MemCheckError& rhs)
+{
+    if (lhs.type != rhs.type || lhs.label != rhs.label || lhs.locations != rhs.locations ||
+        lhs.nestedErrors.size() != rhs.nestedErrors.size()) {
+        return false;
+    }
+    return std::equal(lhs.nestedErrors.begin(), lhs.nestedErrors.end(), rhs.nestedErrors.begin(), IsSameError);
 }
+} // namespace
 
-MemCheckErrorLocation ValgrindMemcheckProcessor::ProcessLocation(wxXmlDocument& doc, wxXmlNode* locationNode)
+void ValgrindMemcheckProcessor::AddError(MemCheckError&& error)
 {
-    // CL_DEBUG1(PLUGIN_PREFIX("ValgrindMemcheckProcessor::ProcessLocation()"));
-
-    MemCheckErrorLocation result;
-    result.line = -1;
-    wxString file;
-    wxString dir;
-
-    wxXmlNode* subframeNode = locationNode->GetChildren();
-    while (subframeNode) {
-
-        if (subframeNode->GetName() == wxT("ip")) {
-            // ignoring
-        } else if (subframeNode->GetName() == wxT("obj")) {
-            result.obj = subframeNode->GetNodeContent();
-        } else if (subframeNode->GetName() == wxT("fn")) {
-            result.func = subframeNode->GetNodeContent();
-        } else if (subframeNode->GetName() == wxT("dir")) {
-            dir = subframeNode->GetNodeContent();
-        } else if (subframeNode->GetName() == wxT("file")) {
-            file = subframeNode->GetNodeContent();
-        } else if (subframeNode->GetName() == wxT("line")) {
-            result.line = wxAtoi(subframeNode->GetNodeContent());
+    size_t hash = HashError(error);
+    auto range = m_errorIndex.equal_range(hash);
+    for (auto iter = range.first; iter != range.second; ++iter) {
+        if (IsSameError(*iter->second, error)) {
+            ++iter->second->count;
+            return;
         }
-        subframeNode = subframeNode->GetNext();
     }
 
-    if (!dir.IsEmpty() && !dir.EndsWith(wxT("/")))
-        dir.Append(wxT("/"));
-    result.file = dir + file;
+    if (m_errorIndex.size() >= MAX_UNIQUE_ERRORS) {
+        ++m_omittedErrors;
+        return;
+    }
 
-    // TODO ? add checkout ?
-    return result;
+    m_errorList.push_back(std::move(error));
+    m_errorIndex.insert({hash, &m_errorList.back()});
+    ++m_newErrors;
 }
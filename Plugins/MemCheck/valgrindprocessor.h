@@ -34,8 +34,10 @@
 #define _VALGRINDPROCESSOR_H_
 
 #include "imemcheckprocessor.h"
+#include "valgrindxmlreader.h"
 
-#include <wx/xml/xml.h>
+#include <unordered_map>
+#include <wx/ffile.h>
 
 /**
  * @class ValgrindMemcheckProcessor
@@ -75,29 +77,42 @@ public:
      * @param outputLogFileName
      * @return
      *
-     * Loads Valgrind's xml log to wxXmlDocument, and goes trought nodes
+     * Streams Valgrind's xml log through ValgrindXmlReader. Without a file name, the log of the last run is read from
+     * where ProcessPending() stopped.
      */
     bool Process(const wxString& outputLogFileName = wxEmptyString) override;
 
-protected:
     /**
-     * @brief creates one MemCheckError object
-     * @param doc whole log document
-     * @param errorNode reference to current processed node in that doc file
-     * @return MemCheckError object
+     * @brief interface implementation
+     * @return number of new errors
      *
-     * Auxiliary section is not in subnode. First part of the node describes particular error, second part describes
-     * auxiliary info. For auxiliary is created sub MemCheckError object.
+     * Reads at most LOG_READ_PER_POLL bytes of what Valgrind appended to its log.
+     */
+    size_t ProcessPending() override;
+
+protected:
+    /**
+     * @brief forget the log read so far and its errors
      */
-    MemCheckError ProcessError(wxXmlDocument& doc, wxXmlNode* errorNode);
+    void ResetLog();
 
     /**
-     * @brief creates one MemCheckErrorLocation object
-     * @param doc whole log document
-     * @param locationNode reference to current processed node in that doc file
-     * @return MemCheckErrorLocation object
+     * @brief feed the log to the reader, from where the last read stopped
+     * @param maxBytes stop after that many bytes, 0 reads up to the end of the file
+     * @return false if the log can not be read or is not a Valgrind xml log
      */
-    MemCheckErrorLocation ProcessLocation(wxXmlDocument& doc, wxXmlNode* locationNode);
+    bool ReadLog(size_t maxBytes);
+
+    /**
+     * @brief add error to the list, or only count it if the same error (label and stack) is already there
+     */
+    void AddError(MemCheckError&& error);
+
+    ValgrindXmlReader m_reader;
+    wxFFile m_log;
+    size_t m_newErrors = 0;
+    size_t m_omittedErrors = 0; ///< errors dropped once MAX_UNIQUE_ERRORS is reached
+    std::unordered_multimap<size_t, MemCheckError*> m_errorIndex; ///< error signature hash -> error in m_errorList
 };
 
 #endif // _VALGRINDPROCESSOR_H_
@@ -0,0 +1,290 @@
+/**
+ * @file
+ * @copyright GNU General Public License v2
+ */
+
+#include "valgrindxmlreader.h"
+
+#include <cstdlib>
+
+namespace
+{
+void AppendUTF8(std::string& out, unsigned long cp)
+{
+    if (cp < 0x80) {
+        out += static_cast<char>(cp);
+    } else if (cp < 0x800) {
+        out += static_cast<char>(0xC0 | (cp >> 6));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x10000) {
+        out += static_cast<char>(0xE0 | (cp >> 12));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    } else if (cp < 0x110000) {
+        out += static_cast<char>(0xF0 | (cp >> 18));
+        out += static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (cp & 0x3F));
+    }
+}
+
+/// replace the xml entities and convert to wxString
+wxString DecodeText(const std::string& raw)
+{
+    if (raw.find('&') == std::string::npos) {
+        return wxString::FromUTF8(raw.data(), raw.length());
+    }
+
+    std::string out;
+    out.reserve(raw.length());
+    for (size_t i = 0; i < raw.length(); ++i) {
+        size_t semicolon = raw[i] == '&' ? raw.find(';', i) : std::string::npos;
+        if (semicolon == std::string::npos) {
+            out += raw[i];
+            continue;
+        }
+
+        std::string entity = raw.substr(i + 1, semicolon - i - 1);
+        if (entity == "lt") {
+            out += '<';
+        } else if (entity == "gt") {
+            out += '>';
+        } else if (entity == "amp") {
+            out += '&';
+        } else if (entity == "quot") {
+            out += '"';
+        } else if (entity == "apos") {
+            out += '\'';
+        } else if (entity.length() > 2 && entity[0] == '#' && (entity[1] == 'x' || entity[1] == 'X')) {
+            AppendUTF8(out, std::strtoul(entity.c_str() + 2, nullptr, 16));
+        } else if (entity.length() > 1 && entity[0] == '#') {
+            AppendUTF8(out, std::strtoul(entity.c_str() + 1, nullptr, 10));
+        } else {
+            // unknown entity, keep it as is
+            out.append(raw, i, semicolon - i + 1);
+        }
+        i = semicolon;
+    }
+    return wxString::FromUTF8(out.data(), out.length());
+}
+} // namespace
+
+ValgrindXmlReader::ValgrindXmlReader(ErrorCallback callback)
+    : m_callback(std::move(callback))
+{
+}
+
+void ValgrindXmlReader::Reset()
+{
+    m_buffer.clear();
+    m_path.clear();
+    m_text.clear();
+    m_isValgrindOutput = false;
+    m_invalid = false;
+    m_error = MemCheckError();
+    m_auxiliary = MemCheckError();
+    m_hasAuxiliary = false;
+    m_strings.clear();
+}
+
+bool ValgrindXmlReader::Feed(const char* data, size_t length)
+{
+    if (m_invalid) {
+        return false;
+    }
+
+    m_buffer.append(data, length);
+    size_t pos = 0;
+    while (pos < m_buffer.length() && !m_invalid) {
+        if (m_buffer[pos] != '<') {
+            // text is consumed as it comes, it is decoded when its element ends
+            size_t end = m_buffer.find('<', pos);
+            if (end == std::string::npos) {
+                end = m_buffer.length();
+            }
+            if (!m_path.empty()) {
+                m_text.append(m_buffer, pos, end - pos);
+            }
+            pos = end;
+            continue;
+        }
+
+        if (m_buffer.compare(pos, 4, "<!--") == 0) {
+            size_t end = m_buffer.find("-->", pos + 4);
+            if (end == std::string::npos) {
+                break;
+            }
+            pos = end + 3;
+            continue;
+        }
+
+        if (m_buffer.compare(pos, 9, "<![CDATA[") == 0) {
+            size_t end = m_buffer.find("]]>", pos + 9);
+            if (end == std::string::npos) {
+                break;
+            }
+            // m_text holds raw xml text: escape '&', the only character GetText() interprets
+            for (size_t i = pos + 9; i < end; ++i) {
+                if (m_buffer[i] == '&') {
+                    m_text += "&amp;";
+                } else {
+                    m_text += m_buffer[i];
+                }
+            }
+            pos = end + 3;
+            continue;
+        }
+
+        size_t end = m_buffer.find('>', pos);
+        if (end == std::string::npos) {
+            // incomplete tag, wait for the next chunk
+            break;
+        }
+
+        if (pos + 1 == end || m_buffer[pos + 1] == '?' || m_buffer[pos + 1] == '!') {
+            // processing instruction, DOCTYPE...
+        } else if (m_buffer[pos + 1] == '/') {
+            OnEndElement();
+        } else {
+            size_t nameEnd = m_buffer.find_first_of(" \t\r\n/>", pos + 1);
+            std::string name = m_buffer.substr(pos + 1, nameEnd - pos - 1);
+            OnStartElement(name);
+            if (m_buffer[end - 1] == '/') {
+                OnEndElement();
+            }
+        }
+        pos = end + 1;
+    }
+
+    m_buffer.erase(0, pos);
+    return !m_invalid;
+}
+
+bool ValgrindXmlReader::IsElement(const char* name, const char* parent) const
+{
+    size_t depth = m_path.size();
+    return depth >= 2 && m_path[depth - 1] == name && m_path[depth - 2] == parent;
+}
+
+void ValgrindXmlReader::OnStartElement(const std::string& name)
+{
+    if (m_path.empty()) {
+        if (name != "valgrindoutput") {
+            m_invalid = true;
+            return;
+        }
+        m_isValgrindOutput = true;
+    }
+
+    m_path.push_back(name);
+    m_text.clear();
+
+    if (m_path.size() == 2 && name == "error") {
+        m_error = MemCheckError();
+        m_error.type = MemCheckError::TYPE_ERROR;
+        m_auxiliary = MemCheckError();
+        m_auxiliary.type = MemCheckError::TYPE_AUXILIARY;
+        m_hasAuxiliary = false;
+    } else if (m_path.size() == 4 && m_path[1] == "error" && IsElement("frame", "stack")) {
+        m_location = MemCheckErrorLocation();
+        m_location.line = -1;
+        m_dir.clear();
+        m_file.clear();
+    }
+}
+
+void ValgrindXmlReader::OnEndElement()
+{
+    if (m_path.empty()) {
+        return;
+    }
+
+    size_t depth = m_path.size();
+    if (depth >= 2 && m_path[1] == "error") {
+        const std::string& element = m_path.back();
+        if (depth == 2) {
+            OnErrorEnd();
+
+        } else if (depth == 3) {
+            if (element == "what") {
+                m_error.label = GetText();
+            } else if (element == "auxwhat") {
+                m_auxiliary.label = GetText();
+                m_hasAuxiliary = true;
+            }
+
+        } else if (depth == 4) {
+            if (IsElement("text", "xwhat")) {
+                m_error.label = GetText();
+            } else if (IsElement("text", "xauxwhat")) {
+                m_auxiliary.label = GetText();
+                m_hasAuxiliary = true;
+            } else if (IsElement("rawtext", "suppression")) {
+                m_error.suppression = GetText();
+            } else if (IsElement("frame", "stack")) {
+                OnFrameEnd();
+            }
+
+        } else if (depth == 5 && m_path[3] == "frame") {
+            if (element == "obj") {
+                m_location.obj = GetPooledText();
+            } else if (element == "fn") {
+                m_location.func = GetPooledText();
+            } else if (element == "dir") {
+                m_dir = m_text;
+            } else if (element == "file") {
+                m_file = m_text;
+            } else if (element == "line") {
+                m_location.line = std::atoi(m_text.c_str());
+            }
+        }
+    }
+
+    m_path.pop_back();
+    m_text.clear();
+}
+
+void ValgrindXmlReader::OnFrameEnd()
+{
+    if (!m_dir.empty() && m_dir.back() != '/') {
+        m_dir += '/';
+    }
+    m_text = m_dir + m_file;
+    m_location.file = GetPooledText();
+
+    if (m_hasAuxiliary) {
+        m_auxiliary.locations.push_back(std::move(m_location));
+    } else {
+        m_error.locations.push_back(std::move(m_location));
+    }
+    m_location = MemCheckErrorLocation();
+}
+
+void ValgrindXmlReader::OnErrorEnd()
+{
+    if (m_error.suppression.IsEmpty()) {
+        m_error.suppression = wxT("#Suppression pattern not present in output log.\n#This plugin requires Valgrind to be "
+                                  "run with '--gen-suppressions=all' option");
+    }
+
+    if (m_hasAuxiliary) {
+        m_error.nestedErrors.push_back(std::move(m_auxiliary));
+    }
+
+    m_callback(std::move(m_error));
+
+    m_error = MemCheckError();
+    m_auxiliary = MemCheckError();
+    m_hasAuxiliary = false;
+}
+
+wxString ValgrindXmlReader::GetText() const { return DecodeText(m_text); }
+
+const wxString& ValgrindXmlReader::GetPooledText()
+{
+    auto iter = m_strings.find(m_text);
+    if (iter == m_strings.end()) {
+        iter = m_strings.insert({m_text, DecodeText(m_text)}).first;
+    }
+    return iter->second;
+}
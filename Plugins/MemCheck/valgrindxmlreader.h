@@ -0,0 +1,86 @@
+/**
+ * @file
+ * @copyright GNU General Public License v2
+ *
+ * @brief ValgrindXmlReader - incremental (SAX like) reader of Valgrind's --xml output.
+ */
+
+#ifndef _VALGRINDXMLREADER_H_
+#define _VALGRINDXMLREADER_H_
+
+#include "memcheckerror.h"
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <wx/string.h>
+
+/**
+ * @class ValgrindXmlReader
+ * @brief Parses Valgrind's xml log as it is fed, chunk by chunk, and reports every complete <error> element.
+ *
+ * No document is built: only the element path, the error being read and the last incomplete tag are kept in memory.
+ * Function, object and file names are decoded once and then taken from a pool.
+ */
+class ValgrindXmlReader
+{
+public:
+    using ErrorCallback = std::function<void(MemCheckError&& error)>;
+
+    explicit ValgrindXmlReader(ErrorCallback callback);
+
+    /**
+     * @brief parse the next chunk of the log. Elements split between two chunks are completed on the next call.
+     * @return false if the data is not a Valgrind xml log
+     */
+    bool Feed(const char* data, size_t length);
+
+    /**
+     * @brief forget everything read so far, including the string pool
+     */
+    void Reset();
+
+    /**
+     * @brief true once the <valgrindoutput> root element was found
+     */
+    bool IsValgrindOutput() const { return m_isValgrindOutput; }
+
+    /**
+     * @brief true if the data read so far is not a Valgrind xml log
+     */
+    bool IsInvalid() const { return m_invalid; }
+
+protected:
+    void OnStartElement(const std::string& name);
+    void OnEndElement();
+    void OnErrorEnd();
+    void OnFrameEnd();
+
+    /// the text of the current element, with the xml entities replaced
+    wxString GetText() const;
+    /// the text of the current element, from the pool
+    const wxString& GetPooledText();
+
+    /// true if the current element is `name`, child of `parent`
+    bool IsElement(const char* name, const char* parent) const;
+
+    ErrorCallback m_callback;
+    std::string m_buffer; ///< unparsed data: at most one incomplete tag
+    std::vector<std::string> m_path;
+    std::string m_text;
+    bool m_isValgrindOutput = false;
+    bool m_invalid = false;
+
+    // the <error> being read
+    MemCheckError m_error;
+    MemCheckError m_auxiliary;
+    bool m_hasAuxiliary = false;
+    MemCheckErrorLocation m_location;
+    std::string m_dir;
+    std::string m_file;
+
+    std::unordered_map<std::string, wxString> m_strings;
+};
+
+#endif // _VALGRINDXMLREADER_H_
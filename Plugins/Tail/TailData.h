@@ -10,6 +10,8 @@ public:
     wxFileName filename;
     size_t lastPos;
     wxString displayedText;
+    wxString includeFilter;
+    wxString excludeFilter;
 
 public:
     TailData()
@@ -7,25 +7,34 @@
 #include "cl_config.h"
 #include "codelite_events.h"
 #include "event_notifier.h"
-#include "fileutils.h"
 #include "globals.h"
 #include "imanager.h"
 #include "lexer_configuration.h"
 #include "tail.h"
 
-#include <wx/ffile.h>
+#include <algorithm>
 #include <wx/filedlg.h>
 
+namespace
+{
+// the indicators marking the lines by severity
+constexpr int INDICATOR_ERROR = 1;
+constexpr int INDICATOR_WARNING = 2;
+constexpr int INDICATOR_NOTICE = 3;
+
+constexpr int MIN_MAX_LINES = 100;
+constexpr int MAX_MAX_LINES = 1000000;
+} // namespace
+
 TailPanel::TailPanel(wxWindow* parent, Tail* plugin)
     : TailPanelBase(parent)
-    , m_lastPos(0)
     , m_plugin(plugin)
     , m_isDetached(false)
     , m_frame(NULL)
 {
+    m_reader = std::make_unique<clTailReader>();
+    m_reader->SetMaxLines(clConfig::Get().Read("Tail/MaxLines", (int)clTailReader::DEFAULT_MAX_LINES));
     DoBuildToolbar();
-    m_fileWatcher = std::make_unique<clFileSystemWatcher>();
-    Bind(wxEVT_FILE_MODIFIED, &TailPanel::OnFileModified, this);
 
     wxCommandEvent dummy;
     OnThemeChanged(dummy);
@@ -34,55 +43,123 @@ TailPanel::TailPanel(wxWindow* parent, Tail* plugin)
 
 TailPanel::~TailPanel()
 {
-    Unbind(wxEVT_FILE_MODIFIED, &TailPanel::OnFileModified, this);
+    // the worker must not notify a destroyed panel
+    m_reader->Stop();
     EventNotifier::Get()->Unbind(wxEVT_CL_THEME_CHANGED, &TailPanel::OnThemeChanged, this);
 }
 
-void TailPanel::OnPause(wxCommandEvent& event) { m_fileWatcher->Stop(); }
+void TailPanel::OnPause(wxCommandEvent& event) { m_reader->Stop(); }
 
-void TailPanel::OnPauseUI(wxUpdateUIEvent& event) { event.Enable(m_file.IsOk() && m_fileWatcher->IsRunning()); }
+void TailPanel::OnPauseUI(wxUpdateUIEvent& event) { event.Enable(m_file.IsOk() && m_reader->IsRunning()); }
 
-void TailPanel::OnPlay(wxCommandEvent& event) { m_fileWatcher->Start(); }
+void TailPanel::OnPlay(wxCommandEvent& event) { DoStartReader(); }
 
-void TailPanel::OnPlayUI(wxUpdateUIEvent& event) { event.Enable(m_file.IsOk() && !m_fileWatcher->IsRunning()); }
+void TailPanel::OnPlayUI(wxUpdateUIEvent& event) { event.Enable(m_file.IsOk() && !m_reader->IsRunning()); }
+
+void TailPanel::DoStartReader()
+{
+    // the reader notifies from its thread, the lines are taken on the main thread
+    m_reader->Start([this]() { CallAfter(&TailPanel::OnLines); });
+}
 
 void TailPanel::DoClear()
 {
-    m_fileWatcher->Stop();
-    m_fileWatcher->Clear();
+    m_reader->Stop();
+    m_reader->Close();
+    // discard the lines that were not displayed yet
+    m_reader->TakeUpdate();
 
     m_file.Clear();
     m_stc->SetReadOnly(false);
     m_stc->ClearAll();
     m_stc->SetReadOnly(true);
-    m_lastPos = 0;
 
     m_staticTextFileName->SetLabel(_("<No opened file>"));
     SetFrameTitle();
     Layout();
 }
 
-void TailPanel::OnFileModified(clFileSystemEvent& event)
+void TailPanel::OnLines()
 {
-    wxFileName fn(event.GetPath());
-    // Get the current file size
-    size_t cursize = FileUtils::GetFileSize(m_file);
-    wxFFile fp(m_file.GetFullPath(), "rb");
-    if (fp.IsOpened() && fp.Seek(m_lastPos)) {
-        if (cursize > m_lastPos) {
-            size_t bufferSize = cursize - m_lastPos;
-            char* buffer = new char[bufferSize + 1];
-            if (fp.Read(buffer, bufferSize) == bufferSize) {
-                buffer[bufferSize] = '\0';
-                wxString content((const char*)buffer, wxConvUTF8);
-                DoAppendText(content);
-            }
-            wxDELETEA(buffer);
-        } else {
-            DoAppendText(_("\n>>> File truncated <<<\n"));
+    clTailReader::Update update = m_reader->TakeUpdate();
+    if (update.reset) {
+        m_stc->SetReadOnly(false);
+        m_stc->ClearAll();
+        m_stc->SetReadOnly(true);
+    }
+
+    if (update.dropped > 0) {
+        std::vector<clTailReader::Line> notice;
+        notice.push_back({wxString::Format(_(">>> %lu lines skipped <<<"), (unsigned long)update.dropped),
+                          clTailReader::Severity::kNotice});
+        DoAppendLines(notice);
+    }
+    DoAppendLines(update.lines);
+    DoTrimScrollback();
+    DoScrollToEnd();
+}
+
+void TailPanel::DoAppendLines(const std::vector<clTailReader::Line>& lines)
+{
+    if (lines.empty()) {
+        return;
+    }
+
+    // the text always ends with a new line: the lines are appended to the last (empty) line
+    int firstLine = std::max(m_stc->GetLineCount() - 1, 0);
+    if (m_stc->GetLineLength(firstLine) > 0) {
+        // text added by DoAppendText()
+        m_stc->SetReadOnly(false);
+        m_stc->AppendText("\n");
+        m_stc->SetReadOnly(true);
+        ++firstLine;
+    }
+
+    // a single append for the whole batch
+    wxString text;
+    for (const auto& line : lines) {
+        text << line.text << "\n";
+    }
+    m_stc->SetReadOnly(false);
+    m_stc->AppendText(text);
+    m_stc->SetReadOnly(true);
+
+    for (size_t i = 0; i < lines.size(); ++i) {
+        int indicator = wxNOT_FOUND;
+        switch (lines[i].severity) {
+        case clTailReader::Severity::kError:
+            indicator = INDICATOR_ERROR;
+            break;
+        case clTailReader::Severity::kWarning:
+            indicator = INDICATOR_WARNING;
+            break;
+        case clTailReader::Severity::kNotice:
+            indicator = INDICATOR_NOTICE;
+            break;
+        case clTailReader::Severity::kNone:
+            break;
+        }
+        if (indicator == wxNOT_FOUND) {
+            continue;
         }
-        m_lastPos = cursize;
+
+        int line = firstLine + static_cast<int>(i);
+        int start = m_stc->PositionFromLine(line);
+        m_stc->SetIndicatorCurrent(indicator);
+        m_stc->IndicatorFillRange(start, m_stc->GetLineEndPosition(line) - start);
+    }
+}
+
+void TailPanel::DoTrimScrollback()
+{
+    // the last line is empty
+    int excess = m_stc->GetLineCount() - 1 - static_cast<int>(m_reader->GetMaxLines());
+    if (excess <= 0) {
+        return;
     }
+    m_stc->SetReadOnly(false);
+    m_stc->DeleteRange(0, m_stc->PositionFromLine(excess));
+    m_stc->SetReadOnly(true);
 }
 
 void TailPanel::DoAppendText(const wxString& text)
@@ -90,6 +167,11 @@ void TailPanel::DoAppendText(const wxString& text)
     m_stc->SetReadOnly(false);
     m_stc->AppendText(text);
     m_stc->SetReadOnly(true);
+    DoScrollToEnd();
+}
+
+void TailPanel::DoScrollToEnd()
+{
     m_stc->SetSelectionEnd(m_stc->GetLength());
     m_stc->SetSelectionStart(m_stc->GetLength());
     m_stc->SetCurrentPos(m_stc->GetLength());
@@ -105,6 +187,41 @@ void TailPanel::OnThemeChanged(wxCommandEvent& event)
     }
     m_stc->SetEOLMode(wxSTC_EOL_CRLF);
     m_stc->SetViewWhiteSpace(wxSTC_WS_VISIBLEALWAYS);
+
+    bool isDark = lexer && lexer->IsDark();
+    m_stc->IndicatorSetForeground(INDICATOR_ERROR, isDark ? "#FF6B68" : "#C62828");
+    m_stc->IndicatorSetForeground(INDICATOR_WARNING, isDark ? "#FFD700" : "#B8860B");
+    m_stc->IndicatorSetForeground(INDICATOR_NOTICE, isDark ? "#6CB6FF" : "#1565C0");
+    for (int indicator : {INDICATOR_ERROR, INDICATOR_WARNING, INDICATOR_NOTICE}) {
+        m_stc->IndicatorSetStyle(indicator, wxSTC_INDIC_TEXTFORE);
+        m_stc->IndicatorSetUnder(indicator, true);
+    }
+}
+
+void TailPanel::OnFilterChanged(wxCommandEvent& event)
+{
+    event.Skip();
+    wxString include = m_includeFilter->GetValue();
+    wxString exclude = m_excludeFilter->GetValue();
+    // while an expression is being typed it can be invalid: keep the previous filters until it is fixed
+    bool isValid = m_reader->SetFilters(include, exclude);
+    wxColour colour = isValid ? wxNullColour : *wxRED;
+    m_includeFilter->SetForegroundColour(colour);
+    m_excludeFilter->SetForegroundColour(colour);
+    m_includeFilter->Refresh();
+    m_excludeFilter->Refresh();
+    if (isValid) {
+        clConfig::Get().Write("Tail/IncludeFilter", include);
+        clConfig::Get().Write("Tail/ExcludeFilter", exclude);
+    }
+}
+
+void TailPanel::OnMaxLinesChanged(wxSpinEvent& event)
+{
+    event.Skip();
+    m_reader->SetMaxLines(m_maxLines->GetValue());
+    clConfig::Get().Write("Tail/MaxLines", m_maxLines->GetValue());
+    DoTrimScrollback();
 }
 
 void TailPanel::OnClear(wxCommandEvent& event)
@@ -147,10 +264,9 @@ void TailPanel::OnOpenMenu(wxAuiToolBarEvent& event)
     OnOpen();
 }
 
-void TailPanel::DoOpen(const wxString& filename)
+void TailPanel::DoOpen(const wxString& filename, size_t startPos)
 {
     m_file = filename;
-    m_lastPos = FileUtils::GetFileSize(m_file);
 
     wxArrayString recentItems = clConfig::Get().Read("tail", wxArrayString());
     if (recentItems.Index(m_file.GetFullPath()) == wxNOT_FOUND) {
@@ -160,9 +276,11 @@ void TailPanel::DoOpen(const wxString& filename)
         clConfig::Get().Write("tail", recentItems);
     }
 
-    // Stop the current watcher
-    m_fileWatcher->SetFile(m_file.GetFullPath(), this);
-    m_fileWatcher->Start();
+    m_reader->Stop();
+    m_reader->Open(m_file.GetFullPath(), startPos);
+    // the reader was reset when opening, the view already is
+    m_reader->TakeUpdate();
+    DoStartReader();
     m_staticTextFileName->SetLabel(m_file.GetFullPath());
     SetFrameTitle();
     Layout();
@@ -203,10 +321,13 @@ void TailPanel::OnDetachWindowUI(wxUpdateUIEvent& event) { event.Enable(!m_isDet
 void TailPanel::Initialize(const TailData& tailData)
 {
     DoClear();
+    m_includeFilter->ChangeValue(tailData.includeFilter);
+    m_excludeFilter->ChangeValue(tailData.excludeFilter);
+    m_reader->SetFilters(tailData.includeFilter, tailData.excludeFilter);
     if (tailData.filename.IsOk() && tailData.filename.Exists()) {
-        DoOpen(tailData.filename.GetFullPath());
+        // the lines are appended on the next event loop iteration, after the displayed text
+        DoOpen(tailData.filename.GetFullPath(), tailData.lastPos);
         DoAppendText(tailData.displayedText);
-        m_lastPos = tailData.lastPos;
         SetFrameTitle();
     }
 }
@@ -216,7 +337,9 @@ TailData TailPanel::GetTailData() const
     TailData dt;
     dt.displayedText = m_stc->GetText();
     dt.filename = m_file;
-    dt.lastPos = m_lastPos;
+    dt.lastPos = m_reader->GetPosition();
+    dt.includeFilter = m_includeFilter->GetValue();
+    dt.excludeFilter = m_excludeFilter->GetValue();
     return dt;
 }
 
@@ -254,6 +377,30 @@ void TailPanel::DoBuildToolbar()
     clAuiToolBarArt::AddTool(m_toolbar, XRCID("tail_play"), _("Play"), images->LoadBitmap("debugger_start"));
     m_toolbar->AddSeparator();
     clAuiToolBarArt::AddTool(m_toolbar, XRCID("tail_detach"), _("Detach window"), images->LoadBitmap("windows"));
+    m_toolbar->AddSeparator();
+
+    // live filters, applied to the kept lines
+    wxSize filterSize{GetTextExtent("ERROR|WARNING|FATAL").GetWidth(), -1};
+    m_includeFilter = new wxTextCtrl(m_toolbar, wxID_ANY, clConfig::Get().Read("Tail/IncludeFilter", wxString()),
+                                     wxDefaultPosition, filterSize);
+    m_includeFilter->SetHint(_("Show lines matching"));
+    m_includeFilter->SetToolTip(_("Show only the lines matching this regular expression"));
+    m_excludeFilter = new wxTextCtrl(m_toolbar, wxID_ANY, clConfig::Get().Read("Tail/ExcludeFilter", wxString()),
+                                     wxDefaultPosition, filterSize);
+    m_excludeFilter->SetHint(_("Hide lines matching"));
+    m_excludeFilter->SetToolTip(_("Hide the lines matching this regular expression"));
+    m_maxLines = new wxSpinCtrl(m_toolbar, wxID_ANY, wxEmptyString, wxDefaultPosition, wxDefaultSize,
+                                wxSP_ARROW_KEYS, MIN_MAX_LINES, MAX_MAX_LINES, (int)m_reader->GetMaxLines());
+    m_maxLines->SetToolTip(_("The number of lines to keep"));
+    for (wxWindow* control : std::vector<wxWindow*>{m_includeFilter, m_excludeFilter, m_maxLines}) {
+#ifdef __WXMAC__
+        control->SetWindowVariant(wxWINDOW_VARIANT_MINI);
+#else
+        control->SetWindowVariant(wxWINDOW_VARIANT_SMALL);
+#endif
+        m_toolbar->AddControl(control);
+    }
+    m_reader->SetFilters(m_includeFilter->GetValue(), m_excludeFilter->GetValue());
 
     // Bind events
     m_toolbar->Bind(wxEVT_AUITOOLBAR_TOOL_DROPDOWN, &TailPanel::OnOpenMenu, this, XRCID("tail_open"));
@@ -262,6 +409,9 @@ void TailPanel::DoBuildToolbar()
     m_toolbar->Bind(wxEVT_TOOL, &TailPanel::OnPause, this, XRCID("tail_pause"));
     m_toolbar->Bind(wxEVT_TOOL, &TailPanel::OnPlay, this, XRCID("tail_play"));
     m_toolbar->Bind(wxEVT_TOOL, &TailPanel::OnDetachWindow, this, XRCID("tail_detach"));
+    m_includeFilter->Bind(wxEVT_TEXT, &TailPanel::OnFilterChanged, this);
+    m_excludeFilter->Bind(wxEVT_TEXT, &TailPanel::OnFilterChanged, this);
+    m_maxLines->Bind(wxEVT_SPINCTRL, &TailPanel::OnMaxLinesChanged, this);
 
     m_toolbar->Bind(wxEVT_UPDATE_UI, &TailPanel::OnCloseUI, this, XRCID("tail_close"));
     m_toolbar->Bind(wxEVT_UPDATE_UI, &TailPanel::OnClearUI, this, XRCID("tail_clear"));
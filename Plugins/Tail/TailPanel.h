@@ -4,25 +4,30 @@
 #include "TailData.h"
 #include "TailUI.hpp"
 #include "clEditorEditEventsHandler.h"
-#include "clFileSystemEvent.h"
-#include "clFileSystemWatcher.h"
+#include "clTailReader.hpp"
 
 #include <map>
+#include <memory>
+#include <vector>
 #include <wx/aui/auibar.h>
 #include <wx/filename.h>
+#include <wx/spinctrl.h>
+#include <wx/textctrl.h>
 
 class TailFrame;
 class Tail;
 class TailPanel : public TailPanelBase
 {
-    std::unique_ptr<clFileSystemWatcher> m_fileWatcher;
+    std::unique_ptr<clTailReader> m_reader;
     wxFileName m_file;
-    size_t m_lastPos;
     clEditEventsHandler::Ptr_t m_editEvents;
     std::map<int, wxString> m_recentItemsMap;
     Tail* m_plugin;
     bool m_isDetached;
     wxAuiToolBar* m_toolbar{nullptr};
+    wxTextCtrl* m_includeFilter{nullptr};
+    wxTextCtrl* m_excludeFilter{nullptr};
+    wxSpinCtrl* m_maxLines{nullptr};
     TailFrame* m_frame;
 
 protected:
@@ -39,8 +44,12 @@ protected:
 private:
     void DoBuildToolbar();
     void DoClear();
-    void DoOpen(const wxString& filename);
+    void DoOpen(const wxString& filename, size_t startPos = clTailReader::END_OF_FILE);
+    void DoStartReader();
     void DoAppendText(const wxString& text);
+    void DoAppendLines(const std::vector<clTailReader::Line>& lines);
+    void DoTrimScrollback();
+    void DoScrollToEnd();
     void DoPrepareRecentItemsMenu(wxMenu& menu);
     wxString GetTailTitle() const;
 
@@ -68,7 +77,7 @@ public:
     /**
      * @brief is this panel watching a file?
      */
-    bool IsOpen() const { return m_fileWatcher && m_fileWatcher->IsRunning(); }
+    bool IsOpen() const { return m_reader && m_reader->IsRunning(); }
 
     /**
      * @brief return the currently watched file name
@@ -80,7 +89,9 @@ protected:
     virtual void OnPauseUI(wxUpdateUIEvent& event);
     virtual void OnPlay(wxCommandEvent& event);
     virtual void OnPlayUI(wxUpdateUIEvent& event);
-    void OnFileModified(clFileSystemEvent& event);
+    void OnLines();
+    void OnFilterChanged(wxCommandEvent& event);
+    void OnMaxLinesChanged(wxSpinEvent& event);
     void OnThemeChanged(wxCommandEvent& event);
 };
 #endif // TAILPANEL_H
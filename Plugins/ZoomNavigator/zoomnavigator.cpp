@@ -32,7 +32,6 @@
 
 #include "zoomnavigator.h"
 
-#include "bookmark_manager.h"
 #include "event_notifier.h"
 #include "znSettingsDlg.h"
 #include "zn_config_item.h"
@@ -66,26 +65,6 @@ CL_PLUGIN_API PluginInfo* GetPluginInfo()
 
 CL_PLUGIN_API int GetPluginInterfaceVersion() { return PLUGIN_INTERFACE_VERSION; }
 
-namespace
-{
-/// @[param]in ctrl the control
-/// @[param]in marker_mask marker type to check
-std::vector<int> GetMarkers(wxStyledTextCtrl& ctrl, marker_mask_type marker_mask)
-{
-    std::vector<int> lines;
-    int nFoundLine = 0;
-    while (true) {
-        nFoundLine = ctrl.MarkerNext(nFoundLine, marker_mask);
-        if (nFoundLine == wxNOT_FOUND) {
-            break;
-        }
-        lines.push_back(nFoundLine);
-        ++nFoundLine;
-    }
-    return lines;
-}
-} // namespace
-
 ZoomNavigator::ZoomNavigator(IManager* manager)
     : IPlugin(manager)
     , m_config(new clConfig("zoom-navigator.conf"))
@@ -185,11 +164,9 @@ void ZoomNavigator::DoUpdate()
     CHECK_CONDITION(stc);
     CHECK_CONDITION(stc->IsShown());
 
-    // locate any error and warning markers in the main editor and duplicate then into the zoomed view
-    m_text->UpdateMarkers(GetMarkers(*stc, mmt_error), ZoomText::MarkerType::Error);
-    m_text->UpdateMarkers(GetMarkers(*stc, mmt_warning), ZoomText::MarkerType::Warning);
-
-    if (curEditor->GetFileName().GetFullPath() != m_curfile) {
+    // the edits and the markers of the editor are seen through the shared document. The document changes when
+    // another editor is activated, and when the editor reloads its file (e.g. in large file mode)
+    if (!m_text->IsShowing(curEditor)) {
         SetEditorText(curEditor);
     }
 
@@ -226,7 +203,6 @@ void ZoomNavigator::SetZoomTextScrollPosToMiddle(wxStyledTextCtrl& stc)
         first = 0;
 
     m_text->SetFirstVisibleLine(first);
-    m_text->ClearSelections();
 }
 
 void ZoomNavigator::PatchUpHighlights(const int first, const int last)
@@ -308,8 +284,7 @@ void ZoomNavigator::OnFileSaved(clCommandEvent& e)
     e.Skip();
 
     if (e.GetString() == m_curfile) {
-        // Update the file content
-        m_curfile.Clear();
+        // the content is shared with the editor, only the scroll position is updated
         m_markerFirstLine = m_markerLastLine = wxNOT_FOUND; // forces a scrolling
         DoUpdate();
     }
@@ -338,7 +313,6 @@ void ZoomNavigator::OnInitDone(wxCommandEvent& e)
 {
     e.Skip();
     m_startupCompleted = true;
-    m_text->Startup();
 }
 
 void ZoomNavigator::OnIdle(wxIdleEvent& e) { e.Skip(); }
@@ -32,40 +32,19 @@
 
 #include "zoomtext.h"
 
-#include "ColoursAndFontsManager.h"
 #include "bookmark_manager.h"
 #include "cl_config.h"
-#include "editor_config.h"
 #include "event_notifier.h"
-#include "fileextmanager.h"
 #include "globals.h"
-#include "lexer_configuration.h"
-#include "macros.h"
-#include "plugin.h"
+#include "imanager.h"
 #include "znSettingsDlg.h"
 #include "zn_config_item.h"
 
-#include <vector>
-#include <wx/app.h>
 #include <wx/settings.h>
-#include <wx/timer.h>
-#include <wx/xrc/xmlres.h>
 
 namespace
 {
-static constexpr int TIMER_DELAY = 150;
-static constexpr int FIRST_LINE_MARKER = 1;
-
-sci_marker_types ToSciMarkerTypes(ZoomText::MarkerType type)
-{
-    switch (type) {
-    default:
-    case ZoomText::MarkerType::Error:
-        return smt_error;
-    case ZoomText::MarkerType::Warning:
-        return smt_warning;
-    }
-}
+static constexpr int HIGHLIGHT_ALPHA = 50;
 } // namespace
 
 ZoomText::ZoomText(
@@ -85,10 +64,10 @@ ZoomText::ZoomText(
     clConfig conf("zoom-navigator.conf");
     conf.ReadItem(data);
 
-    SetEditable(false);
     SetUseHorizontalScrollBar(false);
     SetUseVerticalScrollBar(data.IsUseScrollbar());
-    HideSelection(true);
+    SetCaretStyle(wxSTC_CARETSTYLE_INVISIBLE);
+    UsePopUp(wxSTC_POPUP_NEVER);
 
     SetMarginWidth(1, 0);
     SetMarginWidth(2, 0);
@@ -97,11 +76,11 @@ ZoomText::ZoomText(
     m_zoomFactor = data.GetZoomFactor();
     m_colour = data.GetHighlightColour();
     SetZoom(m_zoomFactor);
+    DoApplyHighlightColour();
     EventNotifier::Get()->Bind(wxEVT_ZN_SETTINGS_UPDATED, &ZoomText::OnSettingsChanged, this);
     EventNotifier::Get()->Bind(wxEVT_CL_THEME_CHANGED, &ZoomText::OnThemeChanged, this);
 
-    MarkerDefine(FIRST_LINE_MARKER, wxSTC_MARK_BACKGROUND, m_colour, m_colour);
-
+    // the markers are set by the editor on the shared document, only their appearance is ours
     MarkerDefine(smt_warning, wxSTC_MARK_SHORTARROW);
     MarkerSetForeground(smt_error, wxColor(128, 128, 0));
     MarkerSetBackground(smt_warning, wxColor(255, 215, 0));
@@ -118,8 +97,11 @@ ZoomText::ZoomText(
     SetLayoutCache(wxSTC_CACHE_DOCUMENT);
 #endif
 
-    m_timer = new wxTimer(this);
-    Bind(wxEVT_TIMER, &ZoomText::OnTimer, this, m_timer->GetId());
+    // the read-only flag belongs to the document: the input that would modify the editor's document is dropped here
+    Bind(wxEVT_KEY_DOWN, &ZoomText::OnBlockedInput, this);
+    Bind(wxEVT_CHAR, &ZoomText::OnBlockedInput, this);
+    Bind(wxEVT_MIDDLE_DOWN, &ZoomText::OnBlockedInput, this);
+    SetDropTarget(nullptr);
     Show();
 }
 
@@ -127,12 +109,6 @@ ZoomText::~ZoomText()
 {
     EventNotifier::Get()->Unbind(wxEVT_ZN_SETTINGS_UPDATED, &ZoomText::OnSettingsChanged, this);
     EventNotifier::Get()->Unbind(wxEVT_CL_THEME_CHANGED, &ZoomText::OnThemeChanged, this);
-    Unbind(wxEVT_TIMER, &ZoomText::OnTimer, this, m_timer->GetId());
-
-    if (m_timer->IsRunning()) {
-        m_timer->Stop();
-    }
-    wxDELETE(m_timer);
 }
 
 void ZoomText::UpdateLexer(IEditor* editor)
@@ -149,20 +125,22 @@ void ZoomText::UpdateLexer(IEditor* editor)
     clConfig conf("zoom-navigator.conf");
     conf.ReadItem(data);
 
-    m_filename = editor->GetFileName().GetFullPath();
-    LexerConf::Ptr_t lexer = EditorConfigST::Get()->GetLexerForFile(m_filename);
-    if (!lexer) {
-        lexer = EditorConfigST::Get()->GetLexer("Text");
+    // the lexer belongs to the document and the editor already runs it: setting it here would restart the lexing
+    // of the editor. Only copy the appearance of the styles
+    wxStyledTextCtrl* ctrl = editor->GetCtrl();
+    for (int i = 0; i < wxSTC_STYLE_MAX; ++i) {
+        StyleSetForeground(i, ctrl->StyleGetForeground(i));
+        StyleSetBackground(i, ctrl->StyleGetBackground(i));
+        StyleSetBold(i, ctrl->StyleGetBold(i));
+        StyleSetItalic(i, ctrl->StyleGetItalic(i));
+        StyleSetUnderline(i, ctrl->StyleGetUnderline(i));
+        StyleSetCase(i, ctrl->StyleGetCase(i));
     }
-    lexer->Apply(this, true);
-
-    MarkerSetAlpha(FIRST_LINE_MARKER, 30);
 
     SetZoom(m_zoomFactor);
-    SetEditable(false);
     SetUseHorizontalScrollBar(false);
     SetUseVerticalScrollBar(data.IsUseScrollbar());
-    HideSelection(true);
+    DoApplyHighlightColour();
     SetSTCCursor(wxSTC_CURSORARROW);
 }
 
@@ -175,11 +153,8 @@ void ZoomText::OnSettingsChanged(wxCommandEvent& e)
         m_zoomFactor = data.GetZoomFactor();
         m_colour = data.GetHighlightColour();
 
-        MarkerSetBackground(FIRST_LINE_MARKER, m_colour);
-        MarkerSetAlpha(FIRST_LINE_MARKER, 50);
-
+        DoApplyHighlightColour();
         SetZoom(m_zoomFactor);
-        Colourise(0, wxSTC_INVALID_POSITION);
     }
 }
 
@@ -188,14 +163,17 @@ void ZoomText::UpdateText(IEditor* editor)
     if (!editor) {
         DoClear();
 
-    } else {
-        SetReadOnly(false);
-        SetText(editor->GetEditorText());
-        SetReadOnly(true);
-        SetCurrentPos(editor->GetCurrentPosition());
+    } else if (!IsShowing(editor)) {
+        // the document is reference counted: it remains valid until both the editor and this view release it
+        SetDocPointer(editor->GetCtrl()->GetDocPointer());
     }
 }
 
+bool ZoomText::IsShowing(IEditor* editor)
+{
+    return editor && editor->GetCtrl()->GetDocPointer() == GetDocPointer();
+}
+
 void ZoomText::HighlightLines(int start, int end)
 {
     const int nLineCount = end - start;
@@ -207,116 +185,30 @@ void ZoomText::HighlightLines(int start, int end)
             start = 0;
     }
 
-    MarkerDeleteAll(FIRST_LINE_MARKER);
-
-    for (int i = start; i <= end; ++i) {
-        MarkerAdd(i, FIRST_LINE_MARKER);
-    }
+    // the selection belongs to the view, unlike markers which would be added to the editor's document. Unlike
+    // SetSelection(), this does not scroll the view
+    SetAnchor(PositionFromLine(start));
+    SetCurrentPos(GetLineEndPosition(end));
 }
 
 void ZoomText::OnThemeChanged(wxCommandEvent& e)
 {
     e.Skip();
-    UpdateLexer(nullptr);
+    // copy the styles once the editors applied the new theme
+    CallAfter(&ZoomText::UpdateLexer, static_cast<IEditor*>(nullptr));
 }
 
-void ZoomText::OnTimer(wxTimerEvent& event)
-{
-    // sanity
-    if (IsEmpty()) {
-        m_timer->Start(TIMER_DELAY, true);
-        return;
-    }
-
-    IEditor* editor = clGetManager()->GetActiveEditor();
-    if (!editor || !editor->GetCtrl()->IsShown()) {
-        m_timer->Start(TIMER_DELAY, true);
-        return;
-    }
-
-    if (!editor->GetKeywordClasses().IsEmpty() && (editor->GetFileName().GetFullPath() == m_filename)) {
-        // Sync between the keywords
-        SetSemanticTokens(
-            editor->GetKeywordClasses(), editor->GetKeywordLocals(), editor->GetKeywordMethods(), wxEmptyString);
-    }
-    m_timer->Start(TIMER_DELAY, true);
-}
+void ZoomText::OnBlockedInput(wxEvent& e) { wxUnusedVar(e); }
 
 void ZoomText::DoClear()
 {
-    SetReadOnly(false);
-    SetText("");
-    SetReadOnly(true);
-}
-
-void ZoomText::Startup() { m_timer->Start(TIMER_DELAY, true); }
-
-void ZoomText::UpdateMarkers(const std::vector<int>& lines, MarkerType type)
-{
-    const int marker_number = ToSciMarkerTypes(type);
-    MarkerDeleteAll(marker_number);
-    for (int line : lines) {
-        MarkerAdd(line, marker_number);
-    }
+    // release the editor's document, the view gets an empty document of its own
+    SetDocPointer(nullptr);
 }
 
-void ZoomText::SetSemanticTokens(const wxString& classes,
-                                 const wxString& variables,
-                                 const wxString& methods,
-                                 const wxString& others)
+void ZoomText::DoApplyHighlightColour()
 {
-    IEditor* editor = clGetManager()->GetActiveEditor();
-    CHECK_PTR_RET(editor);
-
-    wxString flatStrClasses = classes;
-    wxString flatStrLocals = variables;
-    wxString flatStrOthers = others;
-    wxString flatStrMethods = methods;
-
-    flatStrClasses.Trim().Trim(false);
-    flatStrLocals.Trim().Trim(false);
-    flatStrOthers.Trim().Trim(false);
-    flatStrMethods.Trim().Trim(false);
-
-    // locate the lexer
-    auto lexer = ColoursAndFontsManager::Get().GetLexerForFile(editor->GetFileName().GetFullName());
-    CHECK_PTR_RET(lexer);
-
-    if (lexer->GetWordSet(LexerConf::WS_CLASS).is_ok()) {
-        lexer->ApplyWordSet(this, LexerConf::WS_CLASS, flatStrClasses);
-        lexer->ApplyWordSet(this, LexerConf::WS_FUNCTIONS, flatStrMethods);
-        lexer->ApplyWordSet(this, LexerConf::WS_VARIABLES, flatStrLocals);
-        lexer->ApplyWordSet(this, LexerConf::WS_OTHERS, flatStrOthers);
-
-    } else {
-
-        int keywords_class = wxNOT_FOUND;
-        int keywords_variables = wxNOT_FOUND;
-
-        switch (lexer->GetLexerId()) {
-        case wxSTC_LEX_CPP:
-            keywords_class = 1;
-            keywords_variables = 3;
-            break;
-
-        case wxSTC_LEX_RUST:
-            keywords_class = 3;
-            keywords_variables = 4;
-            break;
-
-        case wxSTC_LEX_PYTHON:
-            keywords_variables = 1;
-            break;
-        default:
-            break;
-        }
-        if (!flatStrClasses.empty() && keywords_class != wxNOT_FOUND) {
-            SetKeyWords(keywords_class, flatStrClasses);
-        }
-
-        if (!flatStrLocals.empty() && keywords_variables != wxNOT_FOUND) {
-            SetKeyWords(keywords_variables, flatStrLocals);
-        }
-    }
-    Colourise(0, wxSTC_INVALID_POSITION);
+    SetSelBackground(true, m_colour);
+    SetSelAlpha(HIGHLIGHT_ALPHA);
+    SetSelEOLFilled(true);
 }
@@ -37,30 +37,24 @@
 
 #include <wx/stc/stc.h>
 
-class wxTimer;
-class wxTimerEvent;
-
+/**
+ * @brief a zoomed out view of the active editor.
+ *
+ * The view shares the editor's Scintilla document: it is never copied, and the edits, the styling done by the
+ * editor's lexer and the markers are seen by the view as they happen. Since the text, the lexer, the markers and the
+ * read-only flag belong to the document, the view only changes its own presentation (styles, zoom, selection) and
+ * ignores the input that would modify the document.
+ */
 class ZoomText : public wxStyledTextCtrl
 {
     int m_zoomFactor;
     wxColour m_colour;
-    wxString m_filename;
-    wxTimer* m_timer = nullptr;
-
-public:
-    enum class MarkerType {
-        Error,
-        Warning,
-    };
 
 protected:
     void OnThemeChanged(wxCommandEvent& e);
-    void OnTimer(wxTimerEvent& event);
+    void OnBlockedInput(wxEvent& e);
     void DoClear();
-    void SetSemanticTokens(const wxString& classes,
-                           const wxString& variables,
-                           const wxString& methods,
-                           const wxString& others);
+    void DoApplyHighlightColour();
 
 public:
     explicit ZoomText(wxWindow* parent,
@@ -72,10 +66,15 @@ public:
     ~ZoomText() override;
     void UpdateLexer(IEditor* editor);
     void OnSettingsChanged(wxCommandEvent& e);
+    /**
+     * @brief show the document of `editor` (nullptr: clear the view)
+     */
     void UpdateText(IEditor* editor);
+    /**
+     * @brief is the view showing the document of `editor`?
+     */
+    bool IsShowing(IEditor* editor);
     void HighlightLines(int start, int end);
-    void UpdateMarkers(const std::vector<int>& lines, MarkerType type);
-    void Startup();
 };
 
 #endif // ZOOM_NAV_TEXT
@@ -1,11 +1,10 @@
 #include "php_parser_thread.h"
 
+#include "PHP/PHPIndexer.h"
 #include "PHP/PHPLookupTable.h"
 #include "PHP/PHPSourceFile.h"
 #include "macros.h"
 
-#include <wx/dir.h>
-
 PHPParserThread* PHPParserThread::ms_instance = 0;
 bool PHPParserThread::ms_goingDown = false;
 
@@ -47,7 +46,6 @@ void PHPParserThread::ParseFiles(PHPParserThreadRequest* request)
 {
     wxFileName fnWorkspaceFile(request->workspaceFile);
     bool isFull = request->requestType == PHPParserThreadRequest::kParseWorkspaceFilesFull;
-    wxUnusedVar(isFull);
 
     wxStringSet_t uniqueFilesSet;
     uniqueFilesSet.insert(request->files.begin(), request->files.end());
@@ -57,29 +55,27 @@ void PHPParserThread::ParseFiles(PHPParserThreadRequest* request)
     lookuptable.Open(fnWorkspaceFile.GetPath());
     lookuptable.RebuildClassCache();
 
-    for (size_t i = 0; i < request->frameworksPaths.GetCount(); ++i) {
-        if (ms_goingDown) {
-            ms_goingDown = false;
-            return;
-        }
-        wxArrayString frameworkFiles;
-        wxDir::GetAllFiles(request->frameworksPaths.Item(i), &frameworkFiles, "*.php", wxDIR_DIRS | wxDIR_FILES);
-        uniqueFilesSet.insert(frameworkFiles.begin(), frameworkFiles.end());
+    // Scan the frameworks folders in parallel
+    wxArrayString frameworkFiles = PHPIndexer::CollectFiles(request->frameworksPaths);
+    if (ms_goingDown) {
+        ms_goingDown = false;
+        return;
     }
+    uniqueFilesSet.insert(frameworkFiles.begin(), frameworkFiles.end());
 
     // Convert the set back to array
     wxArrayString allFiles;
+    allFiles.Alloc(uniqueFilesSet.size());
     for (const auto& file : uniqueFilesSet) {
         allFiles.Add(file);
     }
 
-    // Get list of PHP files under
-    lookuptable.RecreateSymbolsDatabase(
-        allFiles,
-        request->requestType == PHPParserThreadRequest::kParseWorkspaceFilesFull ? PHPLookupTable::kUpdateMode_Full
-                                                                                 : PHPLookupTable::kUpdateMode_Fast,
-        [&]() { return PHPParserThread::ms_goingDown; },
-        false);
+    // Parse the files on the indexer threads, this thread stores them
+    PHPIndexer indexer(lookuptable);
+    indexer.SetParseFunctionBodies(false);
+    indexer.Index(allFiles,
+                  isFull ? PHPLookupTable::kUpdateMode_Full : PHPLookupTable::kUpdateMode_Fast,
+                  [&]() { return PHPParserThread::ms_goingDown; });
     // reset the shutdown flag
     ms_goingDown = false;
 }
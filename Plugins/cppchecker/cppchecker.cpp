@@ -33,17 +33,45 @@
 #include "build_settings_config.h"
 #include "clWorkspaceManager.h"
 #include "codelite_events.h"
+#include "cppcheckreportview.h"
 #include "cppchecksettingsdlg.h"
 #include "event_notifier.h"
+#include "file_logger.h"
 #include "fileextmanager.h"
 #include "imanager.h"
 #include "shell_command.h"
 
+#include <algorithm>
+#include <iterator>
 #include <wx/menu.h>
 #include <wx/msgdlg.h>
+#include <wx/thread.h>
 #include <wx/tokenzr.h>
 #include <wx/xrc/xmlres.h>
 
+namespace
+{
+/// the diagnostics are read from the XML output (stderr). The files are checked by one job per core, unless the
+/// user set the number of jobs. With "--cppcheck-build-dir" only the changed files are analysed again
+wxString PrepareCommand(const wxString& command)
+{
+    wxString cmd = command;
+    if (!cmd.Contains(" --xml")) {
+        cmd << " --xml";
+    }
+    if (!cmd.Contains(" -j") && wxThread::GetCPUCount() > 1) {
+        cmd << " -j" << wxThread::GetCPUCount();
+    }
+    return cmd;
+}
+
+bool IsSourceFile(const wxString& filename)
+{
+    return FileExtManager::IsFileType(filename, FileExtManager::TypeSourceC) ||
+           FileExtManager::IsFileType(filename, FileExtManager::TypeSourceCpp);
+}
+} // namespace
+
 // Define the plugin entry point
 CL_PLUGIN_API IPlugin* CreatePlugin(IManager* manager) { return new CppCheckPlugin(manager); }
 
@@ -72,6 +100,7 @@ CppCheckPlugin::CppCheckPlugin(IManager* manager)
 
     // Connect events
     Bind(wxEVT_ASYNC_PROCESS_OUTPUT, &CppCheckPlugin::OnCppCheckReadData, this);
+    Bind(wxEVT_ASYNC_PROCESS_STDERR, &CppCheckPlugin::OnCppCheckStderr, this);
     Bind(wxEVT_ASYNC_PROCESS_TERMINATED, &CppCheckPlugin::OnCppCheckTerminated, this);
     m_mgr->GetTheApp()->Bind(wxEVT_MENU, &CppCheckPlugin::OnRun, this, XRCID("run_cppcheck"));
     m_mgr->GetTheApp()->Bind(wxEVT_MENU, &CppCheckPlugin::OnSettings, this, XRCID("cppcheck_settings_item"));
@@ -80,7 +109,12 @@ CppCheckPlugin::CppCheckPlugin(IManager* manager)
     EventNotifier::Get()->Bind(wxEVT_STOP_BUILD, &CppCheckPlugin::OnStopRun, this);
 
     EventNotifier::Get()->Bind(wxEVT_WORKSPACE_CLOSED, &CppCheckPlugin::OnWorkspaceClosed, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_SAVED, &CppCheckPlugin::OnFileSaved, this);
+    EventNotifier::Get()->Bind(wxEVT_FILE_LOADED, &CppCheckPlugin::OnFileLoaded, this);
     clKeyboardManager::Get()->AddAccelerator(_("CppCheck"), {{"run_cppcheck", _("Run cppcheck...")}});
+
+    m_view = new CppCheckReportView(m_mgr->BookGet(PaneId::BOTTOM_BAR), m_mgr, m_report);
+    m_mgr->BookAddPage(PaneId::BOTTOM_BAR, m_view, _("CppCheck"));
 }
 
 void CppCheckPlugin::CreateToolBar(clToolBarGeneric* toolbar) { wxUnusedVar(toolbar); }
@@ -106,28 +140,84 @@ void CppCheckPlugin::HookPopupMenu(wxMenu* menu, MenuType type)
 void CppCheckPlugin::UnPlug()
 {
     Unbind(wxEVT_ASYNC_PROCESS_OUTPUT, &CppCheckPlugin::OnCppCheckReadData, this);
+    Unbind(wxEVT_ASYNC_PROCESS_STDERR, &CppCheckPlugin::OnCppCheckStderr, this);
     Unbind(wxEVT_ASYNC_PROCESS_TERMINATED, &CppCheckPlugin::OnCppCheckTerminated, this);
     m_mgr->GetTheApp()->Unbind(wxEVT_MENU, &CppCheckPlugin::OnRun, this, XRCID("run_cppcheck"));
     m_mgr->GetTheApp()->Unbind(wxEVT_MENU, &CppCheckPlugin::OnSettings, this, XRCID("cppcheck_settings_item"));
     EventNotifier::Get()->Unbind(wxEVT_WORKSPACE_CLOSED, &CppCheckPlugin::OnWorkspaceClosed, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_SAVED, &CppCheckPlugin::OnFileSaved, this);
+    EventNotifier::Get()->Unbind(wxEVT_FILE_LOADED, &CppCheckPlugin::OnFileLoaded, this);
     // terminate the cppcheck daemon
     wxDELETE(m_cppcheckProcess);
+    wxDELETE(m_recheckProcess);
     m_runStartedByUser = false;
+
+    if (!m_mgr->BookDeletePage(PaneId::BOTTOM_BAR, m_view)) {
+        // failed to delete, delete it manually
+        m_view->Destroy();
+    }
+    m_view = nullptr;
 }
 
 void CppCheckPlugin::OnCppCheckTerminated(clProcessEvent& e)
 {
+    if (m_recheckProcess && e.GetProcess() == m_recheckProcess) {
+        DoRecheckTerminated();
+        return;
+    }
+    if (!m_cppcheckProcess || e.GetProcess() != m_cppcheckProcess) {
+        // a process that was stopped
+        return;
+    }
+
     wxDELETE(m_cppcheckProcess);
     m_runStartedByUser = false;
+    m_reportReady = true;
+    AddOutputLine(wxString::Format(_("cppcheck: %u diagnostics\n"), (unsigned)m_report.GetCount()));
+    DoAnnotateEditors();
+    m_view->UpdateView();
     NotifyStopped();
+
+    // the files saved while the workspace was checked
+    DoRecheckPendingFiles();
+}
+
+void CppCheckPlugin::DoRecheckTerminated()
+{
+    wxDELETE(m_recheckProcess);
+
+    // replace the diagnostics of the files that were checked again
+    for (const auto& file : m_recheckFiles) {
+        m_report.ClearFile(file);
+    }
+    DoAddDiagnostics(std::move(m_recheckDiagnostics), false);
+    m_recheckDiagnostics.clear();
+
+    for (const auto& file : m_recheckFiles) {
+        DoAnnotateEditor(m_mgr->FindEditor(file));
+    }
+    m_recheckFiles.clear();
+    m_view->UpdateView();
+
+    DoRecheckPendingFiles();
 }
 
 void CppCheckPlugin::DoRun()
 {
+    if (m_cppcheckProcess) {
+        return;
+    }
+
     wxString command = DoGetCommand();
     if (command.empty()) {
         return;
     }
+    command = PrepareCommand(command);
+
+    m_report.Clear();
+    m_parser.Reset();
+    m_reportReady = false;
+    m_view->UpdateView();
 
     // notify about starting build process.
     // we pass the selected compiler in the event
@@ -148,7 +238,7 @@ void CppCheckPlugin::DoRun()
 
     AddOutputLine(command + "\n");
 
-    size_t flags = IProcessCreateDefault | IProcessWrapInShell;
+    size_t flags = IProcessCreateDefault | IProcessWrapInShell | IProcessStderrEvent;
     m_cppcheckProcess = ::CreateAsyncProcess(this, command, flags);
     if (!m_cppcheckProcess) {
         wxMessageBox(_("Failed to launch cppcheck process.\nMake sure its installed and in your PATH"),
@@ -159,11 +249,123 @@ void CppCheckPlugin::DoRun()
     m_runStartedByUser = true;
 }
 
-wxString CppCheckPlugin::DoGetCommand()
+void CppCheckPlugin::DoRecheckPendingFiles()
+{
+    if (m_pendingFiles.empty() || m_recheckProcess || m_cppcheckProcess) {
+        return;
+    }
+
+    wxString command = DoGetCommand(false);
+    if (command.empty()) {
+        m_pendingFiles.clear();
+        return;
+    }
+
+    // the files are taken from the project (compile_commands.json), with their flags
+    command = PrepareCommand(command) << " --quiet";
+    m_recheckFiles.assign(m_pendingFiles.begin(), m_pendingFiles.end());
+    m_pendingFiles.clear();
+    for (const auto& file : m_recheckFiles) {
+        command << " --file-filter=" << StringUtils::WrapWithDoubleQuotes(file);
+    }
+
+    clDEBUG() << "CppCheck: checking the saved files:" << command << endl;
+    m_recheckParser.Reset();
+    m_recheckDiagnostics.clear();
+    m_recheckProcess =
+        ::CreateAsyncProcess(this, command, IProcessCreateDefault | IProcessWrapInShell | IProcessStderrEvent);
+    if (!m_recheckProcess) {
+        clWARNING() << "CppCheck: failed to launch:" << command << endl;
+        m_recheckFiles.clear();
+    }
+}
+
+void CppCheckPlugin::DoAddDiagnostics(std::vector<clCppCheckDiagnostic>&& diagnostics, bool addOutputLines)
+{
+    for (auto& d : diagnostics) {
+        if (!d.file.empty()) {
+            wxFileName fn(d.file);
+            if (fn.IsRelative()) {
+                fn.MakeAbsolute(DoGetWorkspacePath());
+            }
+            d.file = fn.GetFullPath();
+        }
+
+        if (addOutputLines && d.HasLocation()) {
+            // in the format of the compiler messages, so the build output can jump to it. The diagnostics without a
+            // location are only listed in the report view
+            wxString prefix;
+            if (d.severity != clCppCheckDiagnostic::Severity::kError &&
+                d.severity != clCppCheckDiagnostic::Severity::kWarning) {
+                prefix << "(" << clCppCheckDiagnostic::ToString(d.severity) << ") ";
+            }
+            wxString line;
+            line << d.file << ":" << d.line << ":" << d.column << ": ";
+            line << (d.severity == clCppCheckDiagnostic::Severity::kError ? "error: " : "warning: ") << prefix
+                 << d.message << " [" << d.id << "]\n";
+            AddOutputLine(line);
+        }
+        m_report.Add(std::move(d));
+    }
+}
+
+void CppCheckPlugin::DoAnnotateEditor(IEditor* editor)
+{
+    if (!editor) {
+        return;
+    }
+
+    wxString file = editor->GetFileName().GetFullPath();
+    auto diagnostics = m_report.GetFileDiagnostics(file);
+    if (diagnostics.empty() && m_annotatedFiles.count(file) == 0) {
+        // nothing of ours to clear
+        return;
+    }
+
+    // cppcheck has its own markers: the build errors and warnings are left alone
+    editor->DelAllStaticAnalysisMarkers();
+    for (const auto& d : diagnostics) {
+        if (d.line <= 0) {
+            continue;
+        }
+        wxString message;
+        message << "cppcheck: " << d.message << " [" << d.id << "]";
+        editor->SetStaticAnalysisMarker(d.line - 1, d.severity == clCppCheckDiagnostic::Severity::kError, message);
+    }
+
+    if (diagnostics.empty()) {
+        m_annotatedFiles.erase(file);
+    } else {
+        m_annotatedFiles.insert(file);
+    }
+}
+
+void CppCheckPlugin::DoAnnotateEditors()
+{
+    IEditor::List_t editors;
+    m_mgr->GetAllEditors(editors);
+    for (auto editor : editors) {
+        DoAnnotateEditor(editor);
+    }
+}
+
+wxString CppCheckPlugin::DoGetWorkspacePath() const
+{
+    auto workspace = clWorkspaceManager::Get().GetWorkspace();
+    if (!workspace || workspace->IsRemote()) {
+        return wxEmptyString;
+    }
+    return wxFileName(workspace->GetFileName()).GetPath();
+}
+
+wxString CppCheckPlugin::DoGetCommand(bool interactive)
 {
     // Linux / Mac way: spawn the process and execute the command
     const auto cppcheck = ThePlatform->Which("cppcheck");
     if (!cppcheck) {
+        if (!interactive) {
+            return wxEmptyString;
+        }
         ::wxMessageBox(_("Could not locate \"cppcheck\". Please install it and try again"),
                        "CodeLite",
                        wxICON_WARNING | wxOK | wxOK_DEFAULT | wxCENTRE);
@@ -210,6 +412,9 @@ wxString CppCheckPlugin::DoGetCommand()
     }
     cmd.Trim();
     if (cmd.empty()) {
+        if (!interactive) {
+            return wxEmptyString;
+        }
         ::wxMessageBox(
             _("Cannot run cppcheck. Empty command"), "CodeLite", wxICON_WARNING | wxOK | wxOK_DEFAULT | wxCENTRE);
         return wxEmptyString;
@@ -220,9 +425,31 @@ wxString CppCheckPlugin::DoGetCommand()
 void CppCheckPlugin::OnCppCheckReadData(clProcessEvent& e)
 {
     e.Skip();
+    if (m_recheckProcess && e.GetProcess() == m_recheckProcess) {
+        return;
+    }
+    // the progress
     AddOutputLine(e.GetOutputRaw());
 }
 
+void CppCheckPlugin::OnCppCheckStderr(clProcessEvent& e)
+{
+    e.Skip();
+    if (m_recheckProcess && e.GetProcess() == m_recheckProcess) {
+        auto diagnostics = m_recheckParser.Feed(e.GetOutputRaw());
+        std::move(diagnostics.begin(), diagnostics.end(), std::back_inserter(m_recheckDiagnostics));
+        return;
+    }
+
+    auto diagnostics = m_parser.Feed(e.GetOutputRaw());
+    if (diagnostics.empty() && e.GetOutputRaw().find('<') == std::string::npos) {
+        // not part of the XML output (e.g. a bad command line)
+        AddOutputLine(e.GetOutputRaw());
+        return;
+    }
+    DoAddDiagnostics(std::move(diagnostics), true);
+}
+
 void CppCheckPlugin::OnSettings(wxCommandEvent& event)
 {
     wxUnusedVar(event);
@@ -236,7 +463,41 @@ void CppCheckPlugin::OnRun(wxCommandEvent& event)
     DoRun();
 }
 
-void CppCheckPlugin::OnWorkspaceClosed(clWorkspaceEvent& e) { e.Skip(); }
+void CppCheckPlugin::OnWorkspaceClosed(clWorkspaceEvent& e)
+{
+    e.Skip();
+    wxDELETE(m_recheckProcess);
+    m_recheckFiles.clear();
+    m_recheckDiagnostics.clear();
+    m_pendingFiles.clear();
+    m_annotatedFiles.clear();
+    m_report.Clear();
+    m_reportReady = false;
+    m_view->UpdateView();
+}
+
+void CppCheckPlugin::OnFileSaved(clCommandEvent& e)
+{
+    e.Skip();
+    // there is nothing to update until the workspace was checked
+    if (!m_reportReady || !clConfig::Get().Read("cppcheck/check_on_save", true)) {
+        return;
+    }
+
+    auto workspace = clWorkspaceManager::Get().GetWorkspace();
+    wxString file = wxFileName(e.GetFileName()).GetFullPath();
+    if (!workspace || workspace->IsRemote() || !IsSourceFile(file)) {
+        return;
+    }
+    m_pendingFiles.insert(file);
+    DoRecheckPendingFiles();
+}
+
+void CppCheckPlugin::OnFileLoaded(clCommandEvent& e)
+{
+    e.Skip();
+    DoAnnotateEditor(m_mgr->FindEditor(e.GetFileName()));
+}
 
 void CppCheckPlugin::AddOutputLine(const wxString& message)
 {
@@ -27,25 +27,55 @@
 #define __CppChecker__
 
 #include "AsyncProcess/asyncprocess.h"
+#include "clCppCheck.hpp"
 #include "clToolBar.h"
 #include "clWorkspaceEvent.hpp"
 #include "cl_command_event.h"
 #include "imanager.h"
+#include "macros.h"
 #include "plugin.h"
 
+#include <vector>
 #include <wx/menu.h>
 
+class CppCheckReportView;
+
 class CppCheckPlugin : public IPlugin
 {
     wxString m_cppcheckPath;
     IProcess* m_cppcheckProcess = nullptr;
     bool m_runStartedByUser = false;
 
+    // the diagnostics of the last run, updated by the checks of the saved files
+    clCppCheckReport m_report;
+    clCppCheckXmlParser m_parser;
+    bool m_reportReady = false;
+    CppCheckReportView* m_view = nullptr;
+    // the files whose editor may show cppcheck markers
+    wxStringSet_t m_annotatedFiles;
+
+    // the background check of the saved files
+    IProcess* m_recheckProcess = nullptr;
+    clCppCheckXmlParser m_recheckParser;
+    std::vector<wxString> m_recheckFiles;
+    std::vector<clCppCheckDiagnostic> m_recheckDiagnostics;
+    // the files saved while a check was running
+    wxStringSet_t m_pendingFiles;
+
 protected:
-    wxString DoGetCommand();
+    /**
+     * @brief the cppcheck command. When not interactive, nothing is reported to the user when it can not be built
+     */
+    wxString DoGetCommand(bool interactive = true);
 
 protected:
     void DoRun();
+    void DoRecheckPendingFiles();
+    void DoAddDiagnostics(std::vector<clCppCheckDiagnostic>&& diagnostics, bool addOutputLines);
+    void DoAnnotateEditor(IEditor* editor);
+    void DoAnnotateEditors();
+    void DoRecheckTerminated();
+    wxString DoGetWorkspacePath() const;
     void AddOutputLine(const wxString& message);
     void NotifyStopped();
 
@@ -56,7 +86,10 @@ protected:
     void OnRun(wxCommandEvent& event);
     void OnCppCheckTerminated(clProcessEvent& e);
     void OnCppCheckReadData(clProcessEvent& e);
+    void OnCppCheckStderr(clProcessEvent& e);
     void OnWorkspaceClosed(clWorkspaceEvent& e);
+    void OnFileSaved(clCommandEvent& e);
+    void OnFileLoaded(clCommandEvent& e);
 
 public:
     explicit CppCheckPlugin(IManager* manager);
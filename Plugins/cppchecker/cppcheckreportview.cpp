@@ -0,0 +1,101 @@
+#include "cppcheckreportview.h"
+
+#include "clThemedListCtrl.h"
+#include "imanager.h"
+
+#include <wx/choice.h>
+#include <wx/sizer.h>
+#include <wx/stattext.h>
+#include <wx/textctrl.h>
+
+namespace
+{
+struct DiagnosticLocation {
+    wxString file;
+    int line = 0;
+};
+
+void DeleteLocation(wxUIntPtr data) { delete reinterpret_cast<DiagnosticLocation*>(data); }
+} // namespace
+
+CppCheckReportView::CppCheckReportView(wxWindow* parent, IManager* mgr, const clCppCheckReport& report)
+    : wxPanel(parent, wxID_ANY)
+    , m_mgr(mgr)
+    , m_report(report)
+{
+    SetSizer(new wxBoxSizer(wxVERTICAL));
+
+    // the choices follow the order of clCppCheckDiagnostic::Severity
+    wxArrayString severities;
+    severities.Add(_("All"));
+    severities.Add(_("Errors"));
+    severities.Add(_("Warnings"));
+    severities.Add(_("Style"));
+    severities.Add(_("Performance"));
+    severities.Add(_("Portability"));
+    severities.Add(_("Information"));
+
+    auto filtersSizer = new wxBoxSizer(wxHORIZONTAL);
+    m_severity = new wxChoice(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, severities);
+    m_severity->SetSelection(0);
+    m_filter = new wxTextCtrl(this, wxID_ANY);
+    m_filter->SetHint(_("Filter by message, file or id"));
+    m_summary = new wxStaticText(this, wxID_ANY, wxEmptyString);
+    filtersSizer->Add(m_severity, 0, wxALL | wxALIGN_CENTER_VERTICAL, 2);
+    filtersSizer->Add(m_filter, 1, wxALL | wxALIGN_CENTER_VERTICAL, 2);
+    filtersSizer->Add(m_summary, 0, wxALL | wxALIGN_CENTER_VERTICAL, 2);
+    GetSizer()->Add(filtersSizer, 0, wxEXPAND);
+
+    m_ctrl = new clThemedListCtrl(this, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxDV_ROW_LINES);
+    m_ctrl->AppendTextColumn(_("Severity"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    m_ctrl->AppendTextColumn(_("File"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    m_ctrl->AppendTextColumn(_("Line"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    m_ctrl->AppendTextColumn(_("Id"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    m_ctrl->AppendTextColumn(_("Message"), wxDATAVIEW_CELL_INERT, -2, wxALIGN_LEFT, wxDATAVIEW_COL_RESIZABLE);
+    GetSizer()->Add(m_ctrl, 1, wxEXPAND);
+    GetSizer()->Layout();
+
+    m_severity->Bind(wxEVT_CHOICE, &CppCheckReportView::OnFilterChanged, this);
+    m_filter->Bind(wxEVT_TEXT, &CppCheckReportView::OnFilterChanged, this);
+    m_ctrl->Bind(wxEVT_DATAVIEW_ITEM_ACTIVATED, &CppCheckReportView::OnItemActivated, this);
+    UpdateView();
+}
+
+CppCheckReportView::~CppCheckReportView() { m_ctrl->DeleteAllItems(DeleteLocation); }
+
+void CppCheckReportView::UpdateView()
+{
+    int selection = m_severity->GetSelection();
+    size_t mask = selection <= 0 ? clCppCheckReport::ALL_SEVERITIES : size_t{1} << (selection - 1);
+    auto diagnostics = m_report.Filter(mask, m_filter->GetValue());
+
+    m_ctrl->Begin();
+    m_ctrl->DeleteAllItems(DeleteLocation);
+    for (const auto& d : diagnostics) {
+        wxVector<wxVariant> cols;
+        cols.push_back(clCppCheckDiagnostic::ToString(d.severity));
+        cols.push_back(d.file);
+        cols.push_back(d.line > 0 ? wxString() << d.line : wxString());
+        cols.push_back(d.id);
+        cols.push_back(d.message);
+        m_ctrl->AppendItem(cols, (wxUIntPtr) new DiagnosticLocation{d.file, d.line});
+    }
+    m_ctrl->Commit();
+    m_summary->SetLabel(wxString::Format(_("%u of %u"), (unsigned)diagnostics.size(), (unsigned)m_report.GetCount()));
+    GetSizer()->Layout();
+}
+
+void CppCheckReportView::OnFilterChanged(wxCommandEvent& event)
+{
+    wxUnusedVar(event);
+    UpdateView();
+}
+
+void CppCheckReportView::OnItemActivated(wxDataViewEvent& event)
+{
+    auto location = reinterpret_cast<DiagnosticLocation*>(m_ctrl->GetItemData(event.GetItem()));
+    if (!location || location->file.empty()) {
+        return;
+    }
+    m_mgr->OpenFile(location->file, wxEmptyString, location->line > 0 ? location->line - 1 : wxNOT_FOUND);
+}
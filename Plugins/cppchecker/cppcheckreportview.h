@@ -0,0 +1,38 @@
+#ifndef CPPCHECKREPORTVIEW_H
+#define CPPCHECKREPORTVIEW_H
+
+#include "clCppCheck.hpp"
+
+#include <wx/dataview.h>
+#include <wx/panel.h>
+
+class IManager;
+class clThemedListCtrl;
+class wxChoice;
+class wxStaticText;
+class wxTextCtrl;
+
+/// the diagnostics of the last cppcheck run, filtered by severity and text. Activating a row opens its location
+class CppCheckReportView : public wxPanel
+{
+public:
+    CppCheckReportView(wxWindow* parent, IManager* mgr, const clCppCheckReport& report);
+    ~CppCheckReportView() override;
+
+    /// the report changed
+    void UpdateView();
+
+protected:
+    void OnFilterChanged(wxCommandEvent& event);
+    void OnItemActivated(wxDataViewEvent& event);
+
+private:
+    IManager* m_mgr = nullptr;
+    const clCppCheckReport& m_report;
+    wxChoice* m_severity = nullptr;
+    wxTextCtrl* m_filter = nullptr;
+    wxStaticText* m_summary = nullptr;
+    clThemedListCtrl* m_ctrl = nullptr;
+};
+
+#endif // CPPCHECKREPORTVIEW_H
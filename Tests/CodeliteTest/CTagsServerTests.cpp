@@ -0,0 +1,122 @@
+#include "CTags.hpp"
+#include "CTagsServer.hpp"
+#include "Platform/Platform.hpp"
+#include "TestUtils.hpp"
+#include "fileutils.h"
+
+#include <csignal>
+#include <doctest.h>
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+namespace
+{
+const wxString SOURCE = "namespace ns {\n"
+                        "class Shape {\n"
+                        "public:\n"
+                        "    virtual double Area() const;\n"
+                        "    void Move(int dx, int dy) { m_x += dx; m_y += dy; }\n"
+                        "private:\n"
+                        "    int m_x = 0;\n"
+                        "    int m_y = 0;\n"
+                        "};\n"
+                        "double Shape::Area() const { return 0.0; }\n"
+                        "}\n"
+                        "int main() { return 0; }\n";
+
+std::optional<wxString> FindCtags()
+{
+#ifdef __WXMAC__
+    return ThePlatform->Which("ctags", false);
+#else
+    return ThePlatform->Which("ctags", true);
+#endif
+}
+} // namespace
+
+TEST_CASE("CTagsServer - no ctags")
+{
+    CTagsServer server{"/no/such/ctags"};
+    CHECK_FALSE(server.GetSymbols("/src/shape.cpp", SOURCE).ok());
+    CHECK(server.GetPid() == wxNOT_FOUND);
+}
+
+TEST_CASE("CTagsServer - same symbols as the one shot path")
+{
+    auto ctags = FindCtags();
+    if (!ctags.has_value()) {
+        MESSAGE("universal-ctags is not installed");
+        return;
+    }
+
+    CTags::Initialise();
+    wxFileName fn = TestUtils::TempFile("CTagsServer", "cpp");
+    REQUIRE(FileUtils::WriteFileContent(fn, SOURCE));
+    auto expected = CTags::ParseFileSymbols(fn.GetFullPath());
+    FileUtils::RemoveFile(fn);
+    REQUIRE(expected.ok());
+
+    CTagsServer server{ctags.value()};
+    auto symbols = server.GetSymbols(fn.GetFullPath(), SOURCE);
+    if (!symbols.ok()) {
+        MESSAGE("ctags does not support the interactive mode: " << symbols.error_message());
+        return;
+    }
+
+    REQUIRE(symbols.value().size() == expected.value().size());
+    CHECK_FALSE(symbols.value().empty());
+    for (size_t i = 0; i < expected.value().size(); ++i) {
+        const auto& lhs = symbols.value()[i];
+        const auto& rhs = expected.value()[i];
+        CHECK(lhs.name == rhs.name);
+        CHECK(lhs.file == rhs.file);
+        CHECK(lhs.kind == rhs.kind);
+        CHECK(lhs.line == rhs.line);
+        CHECK(lhs.end_line == rhs.end_line);
+        CHECK(lhs.signature == rhs.signature);
+    }
+
+    // the same buffer is answered from the cache
+    size_t queries = server.GetQueryCount();
+    CHECK(server.GetSymbols(fn.GetFullPath(), SOURCE).ok());
+    CHECK(server.GetQueryCount() == queries);
+    // a change is not
+    CHECK(server.GetSymbols(fn.GetFullPath(), SOURCE + "void f();\n").ok());
+    CHECK(server.GetQueryCount() == queries + 1);
+}
+
+TEST_CASE("CTagsServer - restarted after a crash")
+{
+    auto ctags = FindCtags();
+    if (!ctags.has_value()) {
+        MESSAGE("universal-ctags is not installed");
+        return;
+    }
+
+#ifndef __WXMSW__
+    // writing to the dead server must fail, not kill the test (CodeLite handles SIGPIPE)
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+
+    CTagsServer server{ctags.value()};
+    if (!server.GetSymbols("/src/shape.cpp", SOURCE).ok()) {
+        MESSAGE("ctags does not support the interactive mode");
+        return;
+    }
+
+    int pid = server.GetPid();
+    REQUIRE(pid != wxNOT_FOUND);
+    ::wxKill(pid, wxSIGKILL);
+    wxMilliSleep(100);
+
+    auto symbols = server.GetSymbols("/src/shape2.cpp", SOURCE);
+    REQUIRE(symbols.ok());
+    CHECK_FALSE(symbols.value().empty());
+    CHECK(server.GetRestartCount() == 1);
+    CHECK(server.GetPid() != pid);
+
+    // a stopped server is started again, this is not a restart
+    server.Stop();
+    CHECK(server.GetSymbols("/src/shape3.cpp", SOURCE).ok());
+    CHECK(server.GetRestartCount() == 1);
+}
@@ -0,0 +1,166 @@
+#include "CTags.hpp"
+#include "TestUtils.hpp"
+#include "fileutils.h"
+
+#include <doctest.h>
+#include <string>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/stopwatch.h>
+
+namespace
+{
+// ctags output for: namespace ns { enum Color { Red, Green }; }
+const std::string ENUM_OUTPUT = "Color\t/src/colors.h\t/^enum Color {$/;\"\tenum\tline:2\tnamespace:ns\n"
+                                "Red\t/src/colors.h\t/^    Red,$/;\"\tenumerator\tline:3\tenum:ns::Color\n"
+                                "Green\t/src/colors.h\t/^    Green$/;\"\tenumerator\tline:4\tenum:ns::Color\n";
+} // namespace
+
+TEST_CASE("CTagsOutputParser - lines split across chunks")
+{
+    // feed the output one byte at a time: every line is split
+    CTagsOutputParser parser;
+    std::vector<TagEntryPtr> tags;
+    for (char ch : ENUM_OUTPUT) {
+        parser.Feed(&ch, 1, tags);
+    }
+    parser.Flush(tags);
+
+    REQUIRE(tags.size() == 3);
+    CHECK(tags[0]->GetName() == "Color");
+    CHECK(tags[0]->IsEnum());
+    CHECK(tags[1]->GetName() == "Red");
+    CHECK(tags[1]->GetFile() == "/src/colors.h");
+    CHECK(tags[1]->GetLine() == 3);
+    // the enumerators are in the scope of their enum's parent
+    CHECK(tags[1]->GetScope() == "ns");
+    CHECK(tags[2]->GetScope() == "ns");
+}
+
+TEST_CASE("CTagsOutputParser - incomplete last line")
+{
+    CTagsOutputParser parser;
+    std::vector<TagEntryPtr> tags;
+    std::string output = ENUM_OUTPUT.substr(0, ENUM_OUTPUT.size() - 1);
+    parser.Feed(output.data(), output.size(), tags);
+    CHECK(tags.size() == 2);
+
+    parser.Flush(tags);
+    REQUIRE(tags.size() == 3);
+    CHECK(tags[2]->GetName() == "Green");
+
+    // a multi byte character split between two chunks
+    std::string line = "caf\xC3\xA9\t/src/menu.h\t/^int caf\xC3\xA9;$/;\"\tvariable\tline:1\n";
+    size_t split = line.find('\xA9');
+    tags.clear();
+    parser.Feed(line.data(), split, tags);
+    parser.Feed(line.data() + split, line.size() - split, tags);
+    REQUIRE(tags.size() == 1);
+    CHECK(tags[0]->GetName() == wxString::FromUTF8("caf\xC3\xA9"));
+}
+
+TEST_CASE("CTags::ShardFiles - balanced by size")
+{
+    wxFileName root = TestUtils::TempDir("CTagsShards");
+    std::vector<wxString> files;
+    // one large file and many small ones
+    const std::vector<size_t> sizes = {4000, 1000, 1000, 1000, 1000, 500, 500, 500, 500};
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        wxFileName fn(root.GetPath(), wxString::Format("file%zu.cpp", i));
+        FileUtils::WriteFileContent(fn, wxString('x', sizes[i]));
+        files.push_back(fn.GetFullPath());
+    }
+
+    auto shards = CTags::ShardFiles(files, 2);
+    REQUIRE(shards.size() == 2);
+    std::vector<size_t> totals;
+    size_t count = 0;
+    for (const auto& shard : shards) {
+        size_t total = 0;
+        for (const auto& file : shard) {
+            total += wxFileName::GetSize(file).GetValue();
+        }
+        totals.push_back(total);
+        count += shard.size();
+    }
+    CHECK(count == files.size());
+    CHECK(totals[0] == 5000);
+    CHECK(totals[1] == 5000);
+
+    // never more shards than files
+    CHECK(CTags::ShardFiles({files[0], files[1]}, 8).size() == 2);
+    CHECK(CTags::ShardFiles(files, 0).size() == 1);
+
+    root.Rmdir(wxPATH_RMDIR_RECURSIVE);
+}
+
+// indexing a 50k files tree, requires universal-ctags. Run with --no-skip
+TEST_CASE("CTags - sharded streaming benchmark" * doctest::skip())
+{
+    constexpr size_t FILES_COUNT = 50000;
+
+    CTags::Initialise();
+    wxFileName root = TestUtils::TempDir("CTagsBenchmark");
+    std::vector<wxString> files;
+    files.reserve(FILES_COUNT);
+    for (size_t i = 0; i < FILES_COUNT; ++i) {
+        wxFileName fn(root.GetPath(), wxString::Format("file%zu.cpp", i));
+        fn.AppendDir(wxString::Format("dir%zu", i / 1000));
+        if (i % 1000 == 0) {
+            fn.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+        }
+
+        wxString content;
+        content << "namespace ns" << i % 50 << " {\n";
+        for (size_t j = 0; j < 1 + i % 8; ++j) {
+            content << "class Class" << i << "_" << j << " {\npublic:\n    int Method" << j << "(int a) const;\n"
+                    << "    enum State { kIdle, kRunning };\n    int m_member" << j << " = 0;\n};\n";
+        }
+        content << "}\n";
+        FileUtils::WriteFileContent(fn, content);
+        files.push_back(fn.GetFullPath());
+    }
+
+    // the single process path, all the tags in memory
+    TestUtils::ResetPeakMemory();
+    wxStopWatch sw;
+    std::vector<TagEntryPtr> all_tags;
+    auto status = CTags::ParseCxxFiles(
+        files,
+        [&all_tags](std::vector<TagEntryPtr>&& batch) {
+            all_tags.insert(all_tags.end(), batch.begin(), batch.end());
+            return true;
+        },
+        CTags::ParseOptions{.shards = 1});
+    if (!status.ok()) {
+        MESSAGE("universal-ctags is not installed");
+        root.Rmdir(wxPATH_RMDIR_RECURSIVE);
+        return;
+    }
+    long single_ms = sw.Time();
+    size_t single_kb = TestUtils::GetPeakMemoryKB();
+    size_t tags_count = all_tags.size();
+    all_tags.clear();
+    all_tags.shrink_to_fit();
+
+    // sharded and streamed to a consumer that does not keep them
+    TestUtils::ResetPeakMemory();
+    sw.Start();
+    size_t streamed = 0;
+    status = CTags::ParseCxxFiles(
+        files,
+        [&streamed](std::vector<TagEntryPtr>&& batch) {
+            streamed += batch.size();
+            return true;
+        },
+        CTags::ParseOptions{});
+    long sharded_ms = sw.Time();
+    size_t sharded_kb = TestUtils::GetPeakMemoryKB();
+
+    MESSAGE(files.size() << " files, " << tags_count << " tags. Single process: " << single_ms << "ms, peak "
+                         << single_kb << "KB. Sharded, streaming: " << sharded_ms << "ms, peak " << sharded_kb
+                         << "KB");
+    CHECK(streamed == tags_count);
+
+    root.Rmdir(wxPATH_RMDIR_RECURSIVE);
+}
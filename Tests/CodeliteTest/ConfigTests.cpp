@@ -0,0 +1,141 @@
+#include "JSON.h"
+#include "TestUtils.hpp"
+#include "cl_config.h"
+#include "fileutils.h"
+
+#include <atomic>
+#include <doctest.h>
+#include <thread>
+#include <wx/filefn.h>
+
+TEST_CASE("clConfig - a burst of writes is written once")
+{
+    wxFileName fn = TestUtils::TempFile("clConfigBurst", "conf");
+    {
+        clConfig config(fn.GetFullPath());
+        config.SetFlushDelay(std::chrono::seconds(10));
+        for (int i = 0; i < 50; ++i) {
+            config.Write(wxString::Format("key%d", i), i);
+        }
+        CHECK(config.IsDirty());
+        CHECK(config.GetSaveCount() == 0);
+        CHECK_FALSE(fn.FileExists());
+
+        config.Flush();
+        CHECK_FALSE(config.IsDirty());
+        CHECK(config.GetSaveCount() == 1);
+
+        // nothing changed since
+        config.Flush();
+        CHECK(config.GetSaveCount() == 1);
+    }
+
+    clConfig reloaded(fn.GetFullPath());
+    CHECK(reloaded.Read("key0", -1) == 0);
+    CHECK(reloaded.Read("key49", -1) == 49);
+    ::wxRemoveFile(fn.GetFullPath());
+}
+
+TEST_CASE("clConfig - pending writes are flushed in the background")
+{
+    wxFileName fn = TestUtils::TempFile("clConfigDebounce", "conf");
+    clConfig config(fn.GetFullPath());
+    config.SetFlushDelay(std::chrono::milliseconds(50));
+    for (int i = 0; i < 10; ++i) {
+        config.Write("counter", i);
+    }
+
+    for (int i = 0; i < 200 && config.IsDirty(); ++i) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    CHECK_FALSE(config.IsDirty());
+    CHECK(config.GetSaveCount() == 1);
+
+    clConfig reloaded(fn.GetFullPath());
+    CHECK(reloaded.Read("counter", -1) == 9);
+    ::wxRemoveFile(fn.GetFullPath());
+}
+
+TEST_CASE("clConfig - the file on disk is never truncated")
+{
+    wxFileName fn = TestUtils::TempFile("clConfigAtomic", "conf");
+    clConfig config(fn.GetFullPath());
+    wxArrayString big_value;
+    for (int i = 0; i < 2000; ++i) {
+        big_value.Add(wxString::Format("a somewhat long value number %d", i));
+    }
+    config.Write("big", big_value);
+    config.Flush();
+
+    // read the file while it is being replaced: every read must see a complete document
+    std::atomic_bool done{false};
+    std::atomic_int bad_reads{0};
+    std::thread reader([&]() {
+        while (!done.load()) {
+            wxString content;
+            if (FileUtils::ReadFileContent(fn, content)) {
+                JSON json(content);
+                if (!json.isOk() || json.toElement()["General"]["big"].toArrayString().size() != 2000) {
+                    ++bad_reads;
+                }
+            }
+        }
+    });
+
+    for (int i = 0; i < 50; ++i) {
+        config.Write("counter", i);
+        config.Save();
+    }
+    done.store(true);
+    reader.join();
+    CHECK(bad_reads.load() == 0);
+
+    clConfig reloaded(fn.GetFullPath());
+    CHECK(reloaded.Read("counter", -1) == 49);
+    ::wxRemoveFile(fn.GetFullPath());
+}
+
+TEST_CASE("clConfig - reload keeps the pending writes")
+{
+    wxFileName fn = TestUtils::TempFile("clConfigReload", "conf");
+    clConfig config(fn.GetFullPath());
+    config.SetFlushDelay(std::chrono::seconds(10));
+    config.Write("counter", 42);
+    CHECK(config.IsDirty());
+
+    config.Reload();
+    CHECK_FALSE(config.IsDirty());
+    CHECK(config.Read("counter", -1) == 42);
+
+    // a new instance for the same file sees the pending writes of the live ones
+    config.Write("counter", 43);
+    clConfig other(fn.GetFullPath());
+    CHECK(other.Read("counter", -1) == 43);
+    ::wxRemoveFile(fn.GetFullPath());
+}
+
+TEST_CASE("clConfig - instances of the same file flush each other without deadlocking")
+{
+    wxFileName fn = TestUtils::TempFile("clConfigInstances", "conf");
+    clConfig first(fn.GetFullPath());
+    clConfig second(fn.GetFullPath());
+    first.SetFlushDelay(std::chrono::seconds(10));
+    second.SetFlushDelay(std::chrono::seconds(10));
+
+    // each instance flushes the other while holding no lock of its own, a new instance flushes both
+    auto clear_answers = [&fn](clConfig& config) {
+        for (int i = 0; i < 50; ++i) {
+            config.SetAnnoyingDlgAnswer("question", i);
+            config.ClearAnnoyingDlgAnswers();
+            clConfig reader(fn.GetFullPath());
+        }
+    };
+    std::thread t1([&] { clear_answers(first); });
+    std::thread t2([&] { clear_answers(second); });
+    t1.join();
+    t2.join();
+
+    first.ClearAnnoyingDlgAnswers();
+    CHECK(first.GetAnnoyingDlgAnswer("question") == wxNOT_FOUND);
+    ::wxRemoveFile(fn.GetFullPath());
+}
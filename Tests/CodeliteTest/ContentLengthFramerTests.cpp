@@ -0,0 +1,84 @@
+#include "clContentLengthFramer.hpp"
+
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+std::string Frame(const std::string& body) { return "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n" + body; }
+
+std::vector<std::string> FeedInChunks(const std::string& stream, size_t chunkSize)
+{
+    clContentLengthFramer framer;
+    std::vector<std::string> messages;
+    std::string message;
+    for (size_t pos = 0; pos < stream.size(); pos += chunkSize) {
+        std::string chunk = stream.substr(pos, chunkSize);
+        framer.Append(chunk.data(), chunk.size());
+        while (framer.Next(message)) {
+            messages.push_back(message);
+        }
+    }
+    return messages;
+}
+} // namespace
+
+TEST_CASE("clContentLengthFramer - several messages in one read")
+{
+    std::string first = Frame(R"({"seq":1,"type":"request","command":"initialize"})");
+    std::string second = Frame(R"({"seq":2,"type":"event","event":"initialized"})");
+    std::string third = Frame("{}");
+
+    auto messages = FeedInChunks(first + second + third, 4096);
+    REQUIRE(messages.size() == 3);
+    CHECK(messages[0] == first);
+    CHECK(messages[1] == second);
+    CHECK(messages[2] == third);
+}
+
+TEST_CASE("clContentLengthFramer - split headers and bodies")
+{
+    std::string first = Frame(R"({"seq":1,"type":"response","body":{"text":"a\r\n\r\nb"}})");
+    std::string second = Frame(R"({"seq":2,"type":"event","event":"stopped"})");
+    std::string stream = first + second;
+
+    // every split position, including inside "Content-Length", "\r\n\r\n" and the bodies
+    for (size_t chunkSize = 1; chunkSize <= stream.size(); ++chunkSize) {
+        auto messages = FeedInChunks(stream, chunkSize);
+        REQUIRE(messages.size() == 2);
+        CHECK(messages[0] == first);
+        CHECK(messages[1] == second);
+    }
+}
+
+TEST_CASE("clContentLengthFramer - header fields")
+{
+    clContentLengthFramer framer;
+    std::string message;
+
+    // the header is case insensitive and may have other fields
+    std::string body = "{\"seq\":3}";
+    std::string stream = "Content-Type: application/vscode-jsonrpc; charset=utf-8\r\ncontent-length:" +
+                         std::to_string(body.size()) + "\r\n\r\n" + body;
+    framer.Append(stream.data(), stream.size());
+    REQUIRE(framer.Next(message));
+    CHECK(message == stream);
+    CHECK_FALSE(framer.Next(message));
+
+    // a message without a Content-Length is dropped, the next one is still framed
+    std::string next = Frame("{}");
+    stream = "X-Custom: 1\r\n\r\n" + next;
+    framer.Append(stream.data(), stream.size());
+    REQUIRE(framer.Next(message));
+    CHECK(message == next);
+
+    // a partial message is discarded by Clear()
+    stream = Frame("{\"seq\":4}");
+    framer.Append(stream.data(), stream.size() - 1);
+    CHECK_FALSE(framer.Next(message));
+    framer.Clear();
+    framer.Append(next.data(), next.size());
+    REQUIRE(framer.Next(message));
+    CHECK(message == next);
+}
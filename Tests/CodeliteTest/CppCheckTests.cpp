@@ -0,0 +1,168 @@
+#include "clCppCheck.hpp"
+
+#include <doctest.h>
+#include <string>
+#include <vector>
+
+namespace
+{
+// the output of "cppcheck --xml --xml-version=2" (stderr)
+const std::string CPPCHECK_XML = R"(<?xml version="1.0" encoding="UTF-8"?>
+<results version="2">
+    <cppcheck version="2.13.0"/>
+    <errors>
+        <error id="nullPointer" severity="error" msg="Null pointer dereference: p" verbose="Null pointer dereference: p" cwe="476" file0="/src/main.cpp">
+            <location file="/src/main.cpp" line="12" column="6" info="Null pointer dereference"/>
+            <location file="/src/main.cpp" line="10" column="14" info="Assignment &apos;p=nullptr&apos;, assigned value is 0"/>
+            <symbol>p</symbol>
+        </error>
+        <error id="passedByValue" severity="performance" msg="Function parameter &apos;name&apos; should be passed by const reference." verbose="Parameter &apos;name&apos; is passed by value. It could be passed as a const reference which is usually faster and recommended in C++." cwe="398" file0="/src/main.cpp">
+            <location file="/src/util.h" line="4" column="30"/>
+            <symbol>name</symbol>
+        </error>
+        <error id="uninitMemberVar" severity="warning" msg="Member variable &apos;Foo::m_x&apos; is not initialized in the constructor. Maybe it should be initialized directly in the class Foo?" verbose="..." cwe="398" file0="/src/foo.cpp">
+            <location file="/src/foo.cpp" line="7" column="5"/>
+            <symbol>Foo::m_x</symbol>
+        </error>
+        <error id="missingIncludeSystem" severity="information" msg="Include file: &lt;vector&gt; not found. Please note: Cppcheck does not need standard library headers to get proper results." verbose="Include file: &lt;vector&gt; not found."/>
+    </errors>
+</results>
+)";
+
+std::vector<clCppCheckDiagnostic> FeedInChunks(const std::string& xml, size_t chunkSize)
+{
+    clCppCheckXmlParser parser;
+    std::vector<clCppCheckDiagnostic> diagnostics;
+    for (size_t pos = 0; pos < xml.size(); pos += chunkSize) {
+        auto completed = parser.Feed(xml.substr(pos, chunkSize));
+        diagnostics.insert(diagnostics.end(), completed.begin(), completed.end());
+    }
+    return diagnostics;
+}
+
+clCppCheckDiagnostic MakeDiagnostic(const wxString& file,
+                                    int line,
+                                    const wxString& id,
+                                    clCppCheckDiagnostic::Severity severity,
+                                    const wxString& message)
+{
+    clCppCheckDiagnostic diagnostic;
+    diagnostic.file = file;
+    diagnostic.line = line;
+    diagnostic.id = id;
+    diagnostic.severity = severity;
+    diagnostic.message = message;
+    return diagnostic;
+}
+
+size_t Mask(clCppCheckDiagnostic::Severity severity)
+{
+    return MakeDiagnostic("", 0, "", severity, "").GetSeverityMask();
+}
+} // namespace
+
+TEST_CASE("clCppCheckXmlParser - parse the diagnostics")
+{
+    auto diagnostics = FeedInChunks(CPPCHECK_XML, CPPCHECK_XML.size());
+    REQUIRE(diagnostics.size() == 4);
+
+    // the first location is the primary one
+    CHECK(diagnostics[0].id == "nullPointer");
+    CHECK(diagnostics[0].severity == clCppCheckDiagnostic::Severity::kError);
+    CHECK(diagnostics[0].message == "Null pointer dereference: p");
+    CHECK(diagnostics[0].cwe == "476");
+    CHECK(diagnostics[0].file == "/src/main.cpp");
+    CHECK(diagnostics[0].line == 12);
+    CHECK(diagnostics[0].column == 6);
+
+    // the entities are decoded
+    CHECK(diagnostics[1].severity == clCppCheckDiagnostic::Severity::kPerformance);
+    CHECK(diagnostics[1].message == "Function parameter 'name' should be passed by const reference.");
+    CHECK(diagnostics[1].file == "/src/util.h");
+
+    CHECK(diagnostics[2].severity == clCppCheckDiagnostic::Severity::kWarning);
+    CHECK(diagnostics[2].HasLocation());
+
+    // a self closing element without a location
+    CHECK(diagnostics[3].id == "missingIncludeSystem");
+    CHECK(diagnostics[3].severity == clCppCheckDiagnostic::Severity::kInformation);
+    CHECK(diagnostics[3].message.StartsWith("Include file: <vector> not found."));
+    CHECK_FALSE(diagnostics[3].HasLocation());
+}
+
+TEST_CASE("clCppCheckXmlParser - output split at any position")
+{
+    auto expected = FeedInChunks(CPPCHECK_XML, CPPCHECK_XML.size());
+    for (size_t chunkSize : {1, 2, 3, 5, 7, 64, 333}) {
+        auto diagnostics = FeedInChunks(CPPCHECK_XML, chunkSize);
+        REQUIRE(diagnostics.size() == expected.size());
+        for (size_t i = 0; i < expected.size(); ++i) {
+            CHECK(diagnostics[i].id == expected[i].id);
+            CHECK(diagnostics[i].message == expected[i].message);
+            CHECK(diagnostics[i].line == expected[i].line);
+        }
+    }
+}
+
+TEST_CASE("clCppCheckXmlParser - progress lines and invalid elements are ignored")
+{
+    clCppCheckXmlParser parser;
+    CHECK(parser.Feed("Checking /src/main.cpp ...\n1/2 files checked 50% done\n").empty());
+    // a '>' in an attribute value does not end the element
+    auto diagnostics = parser.Feed(R"(<error id="a" severity="style" msg="x > y is always true"/>)"
+                                   "<error id=\"broken\" severity=\"style\" msg=\"unterminated/>"
+                                   "\n<error id=\"b\" severity=\"style\" msg=\"b\"/>");
+    REQUIRE(diagnostics.size() == 1);
+    CHECK(diagnostics[0].id == "a");
+    CHECK(diagnostics[0].message == "x > y is always true");
+
+    // the unterminated attribute swallowed the next element: a new run starts clean
+    parser.Reset();
+    diagnostics = parser.Feed("<error id=\"c\" severity=\"portability\" msg=\"c\"/>");
+    REQUIRE(diagnostics.size() == 1);
+    CHECK(diagnostics[0].severity == clCppCheckDiagnostic::Severity::kPortability);
+}
+
+TEST_CASE("clCppCheckReport - incremental updates and filters")
+{
+    using Severity = clCppCheckDiagnostic::Severity;
+    clCppCheckReport report;
+    for (auto& diagnostic : FeedInChunks(CPPCHECK_XML, 128)) {
+        CHECK(report.Add(std::move(diagnostic)));
+    }
+    CHECK(report.GetCount() == 4);
+
+    // a header checked with two files is reported once
+    CHECK_FALSE(report.Add(MakeDiagnostic("/src/util.h",
+                                          4,
+                                          "passedByValue",
+                                          Severity::kPerformance,
+                                          "Function parameter 'name' should be passed by const reference.")));
+    CHECK(report.GetCount() == 4);
+
+    CHECK(report.Filter(clCppCheckReport::ALL_SEVERITIES).size() == 4);
+    CHECK(report.Filter(Mask(Severity::kError)).size() == 1);
+    size_t warnings = Mask(Severity::kWarning) | Mask(Severity::kPerformance);
+    CHECK(report.Filter(warnings).size() == 2);
+    CHECK(report.Filter(clCppCheckReport::ALL_SEVERITIES, "FOO").size() == 1);
+    CHECK(report.Filter(clCppCheckReport::ALL_SEVERITIES, "nullpointer").size() == 1);
+    CHECK(report.Filter(warnings, "null").empty());
+
+    // main.cpp is saved and checked again: the null pointer was fixed
+    report.ClearFile("/src/main.cpp");
+    CHECK(report.GetFileDiagnostics("/src/main.cpp").empty());
+    CHECK(report.GetCount() == 3);
+    // the diagnostics removed with the file can be reported again
+    auto nullPointer =
+        MakeDiagnostic("/src/main.cpp", 12, "nullPointer", Severity::kError, "Null pointer dereference: p");
+    nullPointer.column = 6;
+    CHECK(report.Add(nullPointer));
+    CHECK(report.GetFileDiagnostics("/src/main.cpp").size() == 1);
+    report.ClearFile("/src/main.cpp");
+    CHECK(report.Add(MakeDiagnostic("/src/main.cpp", 20, "unusedVariable", Severity::kStyle, "Unused variable: x")));
+    CHECK(report.GetFileDiagnostics("/src/main.cpp").size() == 1);
+    CHECK(report.GetFileDiagnostics("/src/foo.cpp").size() == 1);
+
+    report.Clear();
+    CHECK(report.GetCount() == 0);
+}
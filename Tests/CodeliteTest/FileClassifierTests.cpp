@@ -0,0 +1,132 @@
+#include "clFileClassifier.hpp"
+#include "fileutils.h"
+
+#include <doctest.h>
+#include <wx/stopwatch.h>
+
+TEST_CASE("clFileClassifier - extensions and exact names")
+{
+    clFileClassifier classifier;
+    classifier.Add("*.cxx;*.hpp;*.cc;*.h;*.c;*.cpp", 0);
+    classifier.Add("*.rs", 1);
+    classifier.Add("*.cmake;CMakeLists.txt", 2);
+    classifier.Add("*.txt", 3);
+
+    CHECK(classifier.Match("/home/user/src/main.cpp") == std::vector<size_t>{0});
+    CHECK(classifier.Match("MAIN.CPP") == std::vector<size_t>{0});
+    CHECK(classifier.Match("lib.rs") == std::vector<size_t>{1});
+    CHECK(classifier.Match("/tmp/CMakeLists.txt") == std::vector<size_t>{2, 3});
+    CHECK(classifier.Match("notes.txt") == std::vector<size_t>{3});
+    CHECK(classifier.Match("Makefile").empty());
+    CHECK(classifier.Match(".cpp") == std::vector<size_t>{0});
+}
+
+TEST_CASE("clFileClassifier - globs, exclusions and match all")
+{
+    clFileClassifier classifier;
+    classifier.Add("*.tar.gz", 0);
+    classifier.Add("Makefile*;!Makefile.am", 1);
+    classifier.Add("*;!*.o", 2);
+    classifier.Add("*.md,-readme.md", 3);
+
+    CHECK(classifier.Match("archive.tar.gz") == std::vector<size_t>{0, 2});
+    CHECK(classifier.Match("Makefile.in") == std::vector<size_t>{1, 2});
+    CHECK(classifier.Match("Makefile.am") == std::vector<size_t>{2});
+    CHECK(classifier.Match("README.md") == std::vector<size_t>{2});
+    CHECK(classifier.Match("docs.md") == std::vector<size_t>{2, 3});
+    CHECK(classifier.Matches("main.o", 2));
+    CHECK_FALSE(classifier.Matches("main.o", 1));
+}
+
+TEST_CASE("clFileClassifier - same result as FileUtils::WildMatch")
+{
+    const std::vector<wxString> masks = {
+        "*.cxx;*.hpp;*.cc;*.h;*.c;*.cpp", "Makefile*;!Makefile.am", "*.md,-readme.md", "*.tar.gz", "*.j?on", "Dockerfile",
+    };
+    const std::vector<wxString> files = {
+        "main.cpp", "foo.H", "Makefile.am", "Makefile", "README.md", "docs.md",
+        "a.tar.gz", "tsconfig.json", "x.jxon", "Dockerfile", "dockerfile", "noext",
+    };
+
+    clFileClassifier classifier;
+    for (size_t i = 0; i < masks.size(); ++i) {
+        classifier.Add(masks[i], i);
+    }
+    for (const auto& file : files) {
+        for (size_t i = 0; i < masks.size(); ++i) {
+            CHECK(classifier.Matches(file, i) == FileUtils::WildMatch(masks[i], wxFileName(file)));
+        }
+    }
+}
+
+// classify 100k paths with file specs like the lexers' ones, versus matching every mask. Run with --no-skip
+TEST_CASE("clFileClassifier - 100k paths benchmark" * doctest::skip())
+{
+    constexpr size_t PATHS = 100000;
+    const std::vector<wxString> masks = {
+        "*.cxx;*.hpp;*.cc;*.h;*.c;*.cpp;*.l;*.y;*.c++;*.hh;*.ipp;*.hxx;*.h++;*.ino",
+        "*.java",
+        "*.js;*.javascript;*.qml;*.json;*.ts;*.tsx;*.wxcp",
+        "*.htm;*.html;*.xhtml",
+        "*.css;*.less",
+        "*.php;*.inc;*.phtml;*.ctp",
+        "*.py;waf;wscript;wscript_build;SConstruct;SConscript",
+        "*.rs",
+        "*.go",
+        "*.rb;Rakefile",
+        "*.md;*.markdown",
+        "*.xml;*.xrc;*.plist;*.svg;*.xsd;*.xsl",
+        "*.yaml;*.yml",
+        "*.toml;.clangd",
+        "*.sql;*.sqlite",
+        "*.sh;*.bash;*.zsh;.bashrc;.zshrc",
+        "*.bat;*.cmd",
+        "*.cmake;CMakeLists.txt",
+        "*akefile;*akefile.in;*akefile.am;*.mk;*.make",
+        "*.diff;*.patch",
+        "*.ini;*.properties;*.conf;*.desktop",
+        "*.f;*.for;*.f90;*.f95;*.f03",
+        "*.lua",
+        "*.dockerfile;Dockerfile",
+    };
+    const std::vector<wxString> names = {
+        "main.cpp", "widget.h", "App.java", "index.ts", "page.html", "style.less", "index.php", "setup.py",
+        "lib.rs",   "main.go",  "Rakefile", "README.md", "config.yml", "Cargo.toml", "build.sh", "CMakeLists.txt",
+        "Makefile", "fix.patch", "settings.ini", "solver.f90", "init.lua", "Dockerfile", "notes.txt", "image.png",
+    };
+
+    clFileClassifier classifier;
+    for (size_t i = 0; i < masks.size(); ++i) {
+        classifier.Add(masks[i], i);
+    }
+    std::vector<wxString> paths;
+    paths.reserve(PATHS);
+    for (size_t i = 0; i < PATHS; ++i) {
+        paths.push_back(wxString::Format("/home/user/src/module%u/%s", (unsigned)(i % 500), names[i % names.size()]));
+    }
+
+    wxStopWatch sw;
+    size_t matched = 0;
+    for (const auto& path : paths) {
+        matched += !classifier.Match(path).empty();
+    }
+    long classifierMs = sw.Time();
+
+    sw.Start();
+    size_t wildMatched = 0;
+    for (const auto& path : paths) {
+        wxFileName fn(path);
+        for (const auto& mask : masks) {
+            if (FileUtils::WildMatch(mask, fn)) {
+                ++wildMatched;
+                break;
+            }
+        }
+    }
+    long wildMatchMs = sw.Time();
+
+    CHECK(matched == wildMatched);
+    MESSAGE(PATHS << " paths: clFileClassifier " << classifierMs << "ms, FileUtils::WildMatch per mask " << wildMatchMs
+                  << "ms");
+    CHECK(classifierMs < 1000);
+}
@@ -0,0 +1,195 @@
+#include "TestUtils.hpp"
+#include "clLogRingBuffer.hpp"
+#include "file_logger.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <doctest.h>
+#include <thread>
+#include <vector>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+
+namespace
+{
+void RemoveLogFile(const wxString& path)
+{
+    for (const wxString& file : {path, path + ".1", path + ".2", path + ".3"}) {
+        if (wxFileName::FileExists(file)) {
+            ::wxRemoveFile(file);
+        }
+    }
+}
+
+wxString MakeLogFile(const wxString& name)
+{
+    wxString path = TestUtils::TempFile(name, "log").GetFullPath();
+    RemoveLogFile(path);
+
+    // the logger only writes into an existing file
+    wxFFile fp(path, "wb");
+    fp.Close();
+    return path;
+}
+
+/// log `lines_per_thread` lines with clDEBUG() from `threads` threads, return the latency of every call
+std::vector<long long> LogFromThreads(size_t threads, size_t lines_per_thread)
+{
+    std::vector<std::vector<long long>> latencies(threads);
+    std::vector<std::thread> workers;
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([t, lines_per_thread, &latencies]() {
+            auto& samples = latencies[t];
+            samples.reserve(lines_per_thread);
+            for (size_t i = 0; i < lines_per_thread; ++i) {
+                auto start = std::chrono::steady_clock::now();
+                clDEBUG() << "benchmark thread" << t << "line" << i << endl;
+                auto end = std::chrono::steady_clock::now();
+                samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    std::vector<long long> all;
+    all.reserve(threads * lines_per_thread);
+    for (const auto& samples : latencies) {
+        all.insert(all.end(), samples.begin(), samples.end());
+    }
+    std::sort(all.begin(), all.end());
+    return all;
+}
+
+long long Percentile(const std::vector<long long>& sorted, double p)
+{
+    return sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+}
+} // namespace
+
+TEST_CASE("clLogRingBuffer - FIFO and capacity")
+{
+    clLogRingBuffer queue(5);
+    CHECK(queue.GetCapacity() == 8);
+    CHECK(queue.IsEmpty());
+
+    for (int i = 0; i < 8; ++i) {
+        std::string message = std::to_string(i);
+        CHECK(queue.TryPush(message));
+    }
+
+    // full: the message is left untouched
+    std::string overflow = "overflow";
+    CHECK_FALSE(queue.TryPush(overflow));
+    CHECK(overflow == "overflow");
+
+    std::string message;
+    for (int i = 0; i < 8; ++i) {
+        REQUIRE(queue.TryPop(message));
+        CHECK(message == std::to_string(i));
+    }
+    CHECK_FALSE(queue.TryPop(message));
+    CHECK(queue.IsEmpty());
+}
+
+TEST_CASE("clLogRingBuffer - concurrent producers")
+{
+    constexpr int PRODUCERS = 4;
+    constexpr int MESSAGES = 20000;
+
+    clLogRingBuffer queue(64);
+    std::vector<std::thread> producers;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        producers.emplace_back([p, &queue]() {
+            for (int i = 0; i < MESSAGES; ++i) {
+                std::string message = std::to_string(p) + ":" + std::to_string(i);
+                while (!queue.TryPush(message)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    // every producer's messages come out in the order they were pushed
+    std::vector<int> last(PRODUCERS, -1);
+    int received = 0;
+    bool in_order = true;
+    std::string message;
+    while (received < PRODUCERS * MESSAGES) {
+        if (!queue.TryPop(message)) {
+            std::this_thread::yield();
+            continue;
+        }
+        size_t colon = message.find(':');
+        int producer = std::stoi(message.substr(0, colon));
+        int index = std::stoi(message.substr(colon + 1));
+        in_order = in_order && index == last[producer] + 1;
+        last[producer] = index;
+        ++received;
+    }
+
+    for (auto& producer : producers) {
+        producer.join();
+    }
+    CHECK(in_order);
+    CHECK(queue.IsEmpty());
+}
+
+TEST_CASE("FileLogger - the log file is rotated by size")
+{
+    wxString logfile = MakeLogFile("FileLoggerRotation");
+    FileLogger::SetLogFile(logfile);
+    FileLogger::SetRotation(1024, 2);
+
+    for (int i = 0; i < 200; ++i) {
+        clSYSTEM() << "a line long enough to fill the log file quickly" << i << endl;
+    }
+    FileLogger::WaitForPendingWrites();
+
+    CHECK(wxFileName::FileExists(logfile));
+    CHECK(wxFileName::FileExists(logfile + ".1"));
+    CHECK(wxFileName::FileExists(logfile + ".2"));
+    CHECK_FALSE(wxFileName::FileExists(logfile + ".3"));
+    CHECK(wxFileName::GetSize(logfile + ".1").GetValue() <= 2048);
+
+    FileLogger::SetRotation(20 * 1024 * 1024, 2);
+    FileLogger::SetLogFile(wxEmptyString);
+    FileLogger::WaitForPendingWrites();
+    RemoveLogFile(logfile);
+}
+
+// 1M lines from 8 threads, synchronous writes vs. the queue. Run with --no-skip
+TEST_CASE("FileLogger - clDEBUG() latency benchmark" * doctest::skip())
+{
+    constexpr size_t THREADS = 8;
+    constexpr size_t LINES_PER_THREAD = 125000;
+
+    wxString logfile = MakeLogFile("FileLoggerBenchmark");
+    int verbosity = FileLogger::GetGlobalLogVerbosity();
+    FileLogger::SetLogFile(logfile);
+    FileLogger::SetRotation(0, 0);
+    FileLogger::SetGlobalLogVerbosity(FileLogger::Dbg);
+
+    for (bool async : {false, true}) {
+        FileLogger::SetAsync(async);
+        auto start = std::chrono::steady_clock::now();
+        auto latencies = LogFromThreads(THREADS, LINES_PER_THREAD);
+        FileLogger::WaitForPendingWrites();
+        auto total = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start);
+
+        MESSAGE((async ? "async" : "sync") << ": p50=" << Percentile(latencies, 0.5)
+                                           << "ns p99=" << Percentile(latencies, 0.99)
+                                           << "ns max=" << latencies.back() << "ns total=" << total.count() << "ms");
+        CHECK(latencies.size() == THREADS * LINES_PER_THREAD);
+    }
+
+    FileLogger::SetGlobalLogVerbosity(verbosity);
+    FileLogger::SetAsync(true);
+    FileLogger::SetRotation(20 * 1024 * 1024, 2);
+    FileLogger::SetLogFile(wxEmptyString);
+    FileLogger::WaitForPendingWrites();
+    RemoveLogFile(logfile);
+}
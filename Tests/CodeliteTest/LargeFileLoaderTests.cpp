@@ -0,0 +1,193 @@
+#include "TestUtils.hpp"
+#include "clLargeFileLoader.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <doctest.h>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+#include <wx/stopwatch.h>
+
+TEST_CASE("clLargeFileLoader - chunks end on line boundaries")
+{
+    std::string content;
+    for (size_t i = 0; i < 200; ++i) {
+        content += "line " + std::to_string(i) + std::string(i % 37, 'x') + "\n";
+    }
+    content += "last line without EOL";
+
+    wxString filename = TestUtils::TempFile("LargeFileLoader", "txt").GetFullPath();
+    {
+        wxFFile fp(filename, "wb");
+        REQUIRE(fp.IsOpened());
+        fp.Write("\xEF\xBB\xBF", 3);
+        fp.Write(content.data(), content.size());
+    }
+
+    std::vector<std::string> chunks;
+    size_t lastBytesRead = 0;
+    std::atomic_bool done{false};
+    clLargeFileLoader loader;
+    REQUIRE(loader.Load(
+        filename,
+        [&](std::shared_ptr<std::string> chunk, size_t bytesRead, size_t fileSize) {
+            chunks.push_back(*chunk);
+            lastBytesRead = bytesRead;
+            CHECK(fileSize == content.size() + 3);
+            loader.Release();
+        },
+        [&](bool success) { done.store(success); },
+        100));
+    loader.Wait();
+
+    CHECK(done.load());
+    CHECK(loader.HasUtf8Bom());
+    CHECK(lastBytesRead == content.size() + 3);
+    REQUIRE(chunks.size() > 1);
+
+    std::string joined;
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        joined += chunks[i];
+        if (i + 1 < chunks.size()) {
+            CHECK(chunks[i].back() == '\n');
+        }
+    }
+    CHECK(joined == content);
+
+    ::wxRemoveFile(filename);
+}
+
+TEST_CASE("clLargeFileLoader - cancel and errors")
+{
+    clLargeFileLoader loader;
+    CHECK_FALSE(loader.Load("/this/file/does/not/exist.log", [](auto, size_t, size_t) {}, [](bool) {}));
+    CHECK_FALSE(clLargeFileLoader::IsLargeFile("/this/file/does/not/exist.log", 1));
+
+    wxString filename = TestUtils::TempFile("LargeFileLoaderCancel", "txt").GetFullPath();
+    {
+        wxFFile fp(filename, "wb");
+        REQUIRE(fp.IsOpened());
+        std::string line(99, 'a');
+        line += "\n";
+        for (size_t i = 0; i < 1000; ++i) {
+            fp.Write(line.data(), line.size());
+        }
+    }
+    CHECK(clLargeFileLoader::IsLargeFile(filename, 0) == false);
+
+    // nothing is released: the worker stops after MAX_PENDING_CHUNKS chunks until it is cancelled
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t chunks = 0;
+    std::atomic_bool done{false};
+    REQUIRE(loader.Load(
+        filename,
+        [&](auto, size_t, size_t) {
+            {
+                std::unique_lock lock{mutex};
+                ++chunks;
+            }
+            cv.notify_all();
+        },
+        [&](bool) { done.store(true); },
+        100));
+    {
+        std::unique_lock lock{mutex};
+        CHECK(cv.wait_for(
+            lock, std::chrono::seconds(10), [&] { return chunks >= clLargeFileLoader::MAX_PENDING_CHUNKS; }));
+        CHECK(chunks == clLargeFileLoader::MAX_PENDING_CHUNKS);
+    }
+    loader.Cancel();
+    CHECK_FALSE(loader.IsRunning());
+    CHECK_FALSE(done.load());
+
+    ::wxRemoveFile(filename);
+}
+
+TEST_CASE("clLargeFileLoader - files that are not UTF-8")
+{
+    auto isUtf8 = [](const std::string& content, size_t chunkSize) {
+        wxString filename = TestUtils::TempFile("LargeFileLoaderUtf8", "txt").GetFullPath();
+        {
+            wxFFile fp(filename, "wb");
+            fp.Write(content.data(), content.size());
+        }
+        clLargeFileLoader loader;
+        bool loaded = loader.Load(
+            filename, [&](auto, size_t, size_t) { loader.Release(); }, [](bool) {}, chunkSize);
+        loader.Wait();
+        ::wxRemoveFile(filename);
+        return loaded && loader.IsUtf8();
+    };
+
+    // the sequences split between two reads
+    const std::string utf8 = "caf\xC3\xA9 \xE2\x82\xAC \xF0\x9F\x98\x80\n";
+    for (size_t chunkSize : {1, 2, 3, 5, 64}) {
+        CHECK(isUtf8(utf8, chunkSize));
+    }
+    CHECK_FALSE(isUtf8("caf\xE9\n", 64));          // Latin-1
+    CHECK_FALSE(isUtf8("\xC0\xAF\n", 64));         // overlong
+    CHECK_FALSE(isUtf8("\xED\xA0\x80\n", 64));     // surrogate
+    CHECK_FALSE(isUtf8("truncated \xE2\x82", 64)); // truncated at the end of the file
+    CHECK_FALSE(isUtf8("\xE2\x82 split \x41", 1)); // truncated sequence, one byte per read
+}
+
+// load a generated 1GB file. Run with --no-skip
+TEST_CASE("clLargeFileLoader - 1GB file benchmark" * doctest::skip())
+{
+    constexpr size_t FILE_SIZE = 1024 * 1024 * 1024;
+    // the editor is painted once the first chunk is appended
+    constexpr long MAX_FIRST_CHUNK_MS = 500;
+    constexpr size_t MAX_RESIDENT_GROWTH = 64 * 1024 * 1024;
+
+    wxString filename = TestUtils::TempFile("LargeFileLoaderBenchmark", "txt").GetFullPath();
+    {
+        wxFFile fp(filename, "wb");
+        REQUIRE(fp.IsOpened());
+        std::string block;
+        for (size_t line = 0; block.size() < 1024 * 1024; ++line) {
+            block += "2024-01-01 12:00:00.000 [INFO] worker " + std::to_string(line) + ": request completed\n";
+        }
+        for (size_t written = 0; written < FILE_SIZE; written += block.size()) {
+            fp.Write(block.data(), std::min(block.size(), FILE_SIZE - written));
+        }
+    }
+
+    size_t residentBefore = TestUtils::GetResidentMemory();
+    std::atomic_size_t residentPeak{residentBefore};
+    std::atomic_long firstChunkMs{-1};
+    std::atomic_size_t total{0};
+    std::atomic_bool done{false};
+
+    wxStopWatch sw;
+    clLargeFileLoader loader;
+    REQUIRE(loader.Load(
+        filename,
+        [&](std::shared_ptr<std::string> chunk, size_t, size_t) {
+            if (firstChunkMs.load() < 0) {
+                firstChunkMs.store(sw.Time());
+            }
+            total += chunk->size();
+            residentPeak.store(std::max(residentPeak.load(), TestUtils::GetResidentMemory()));
+            loader.Release();
+        },
+        [&](bool success) { done.store(success); }));
+    loader.Wait();
+    long elapsedMs = sw.Time();
+
+    size_t growth = residentPeak.load() - residentBefore;
+    MESSAGE("first chunk after " << firstChunkMs.load() << "ms, file read in " << elapsedMs
+                                 << "ms, resident memory grew by " << growth / 1024 << "KB");
+
+    CHECK(done.load());
+    CHECK(total.load() == FILE_SIZE);
+    CHECK(firstChunkMs.load() <= MAX_FIRST_CHUNK_MS);
+    CHECK(growth <= MAX_RESIDENT_GROWTH);
+
+    ::wxRemoveFile(filename);
+}
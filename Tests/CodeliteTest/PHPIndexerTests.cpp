@@ -0,0 +1,148 @@
+#include "PHP/PHPIndexer.h"
+#include "PHP/PHPLookupTable.h"
+#include "TestUtils.hpp"
+#include "fileutils.h"
+
+#include <algorithm>
+#include <doctest.h>
+#include <thread>
+#include <wx/datetime.h>
+#include <wx/dir.h>
+#include <wx/filefn.h>
+#include <wx/stopwatch.h>
+
+namespace
+{
+wxString PhpFileContent(size_t index)
+{
+    wxString content;
+    content << "<?php\n"
+            << "namespace App\\Module" << (index % 20) << ";\n\n"
+            << "class Class" << index << " extends Base {\n"
+            << "    /** @var int */\n"
+            << "    private $counter = 0;\n\n"
+            << "    /**\n"
+            << "     * @return Class" << index << "\n"
+            << "     */\n"
+            << "    public function run" << index << "(int $a, string $b) {\n"
+            << "        return $this;\n"
+            << "    }\n"
+            << "}\n";
+    return content;
+}
+
+/// create `count` PHP files under a new temporary folder, 100 files per sub folder
+wxString MakePhpTree(const wxString& name, size_t count, wxArrayString& files)
+{
+    wxFileName root = TestUtils::TempDir(name);
+
+    files.clear();
+    for (size_t i = 0; i < count; ++i) {
+        wxFileName fn(root.GetPath(), wxString::Format("class%zu.php", i));
+        fn.AppendDir(wxString::Format("dir%zu", i / 100));
+        fn.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+        FileUtils::WriteFileContent(fn, PhpFileContent(i));
+        files.Add(fn.GetFullPath());
+    }
+    return root.GetPath();
+}
+
+/// move the modification time of `file` one minute in the future, so it looks newer than the database
+void TouchInTheFuture(const wxString& file)
+{
+    wxDateTime future = wxDateTime::Now() + wxTimeSpan::Minutes(1);
+    wxFileName(file).SetTimes(&future, &future, nullptr);
+}
+} // namespace
+
+TEST_CASE("PHPIndexer - full and incremental indexing")
+{
+    wxArrayString files;
+    wxString root = MakePhpTree("PHPIndexer", 50, files);
+    wxArrayString folders;
+    folders.Add(root);
+    CHECK(PHPIndexer::CollectFiles(folders).size() == 50);
+
+    PHPLookupTable lookup;
+    lookup.Open(wxString(":memory:"));
+
+    PHPIndexer indexer(lookup);
+    indexer.SetWorkers(4);
+    indexer.SetBatchSize(16);
+
+    auto not_going_down = []() { return false; };
+    auto stats = indexer.Index(files, PHPLookupTable::kUpdateMode_Full, not_going_down);
+    CHECK(stats.files == 50);
+    CHECK(stats.parsed == 50);
+    CHECK(stats.failed == 0);
+    CHECK(lookup.FindClass("\\App\\Module0\\Class0"));
+    CHECK(lookup.FindClass("\\App\\Module9\\Class49"));
+    CHECK(lookup.ClassExists("\\App\\Module9\\Class49"));
+
+    // nothing changed
+    stats = indexer.Index(files, PHPLookupTable::kUpdateMode_Fast, not_going_down);
+    CHECK(stats.parsed == 0);
+    CHECK(stats.unchanged == 50);
+
+    // newer, but the same content: not parsed again
+    TouchInTheFuture(files[1]);
+    // newer, with a new class
+    wxString content = PhpFileContent(2);
+    content.Replace("class Class2 ", "class Renamed2 ");
+    FileUtils::WriteFileContent(files[2], content);
+    TouchInTheFuture(files[2]);
+
+    stats = indexer.Index(files, PHPLookupTable::kUpdateMode_Fast, not_going_down);
+    CHECK(stats.parsed == 1);
+    CHECK(stats.unchanged == 49);
+    CHECK(lookup.FindClass("\\App\\Module2\\Renamed2"));
+    CHECK_FALSE(lookup.FindClass("\\App\\Module2\\Class2"));
+
+    wxFileName::Rmdir(root, wxPATH_RMDIR_RECURSIVE);
+}
+
+TEST_CASE("PHPIndexer - the content hash")
+{
+    CHECK(PHPIndexer::GetContentHash("<?php echo 1;") == PHPIndexer::GetContentHash("<?php echo 1;"));
+    CHECK(PHPIndexer::GetContentHash("<?php echo 1;") != PHPIndexer::GetContentHash("<?php echo 2;"));
+    CHECK(PHPIndexer::GetContentHash("") != 0);
+}
+
+// index a generated tree of 20k files with 1 worker and with all the cores. Run with --no-skip
+TEST_CASE("PHPIndexer - 20k files benchmark" * doctest::skip())
+{
+    constexpr size_t FILES_COUNT = 20000;
+    wxArrayString files;
+    wxString root = MakePhpTree("PHPIndexerBenchmark", FILES_COUNT, files);
+
+    wxArrayString folders;
+    folders.Add(root);
+
+    wxStopWatch sw;
+    files = PHPIndexer::CollectFiles(folders);
+    MESSAGE("collected " << files.size() << " files in " << sw.Time() << "ms");
+    REQUIRE(files.size() == FILES_COUNT);
+
+    auto not_going_down = []() { return false; };
+    size_t cores = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+    for (size_t workers : {size_t(1), cores}) {
+        wxFileName db_file(root, "phpsymbols.db");
+        ::wxRemoveFile(db_file.GetFullPath());
+
+        PHPLookupTable lookup;
+        lookup.Open(db_file);
+        PHPIndexer indexer(lookup);
+        indexer.SetWorkers(workers);
+
+        auto full = indexer.Index(files, PHPLookupTable::kUpdateMode_Full, not_going_down);
+        CHECK(full.parsed == FILES_COUNT);
+        auto incremental = indexer.Index(files, PHPLookupTable::kUpdateMode_Fast, not_going_down);
+        CHECK(incremental.unchanged == FILES_COUNT);
+
+        MESSAGE(workers << " worker(s): full " << full.elapsedMs << "ms, incremental " << incremental.elapsedMs
+                        << "ms");
+        lookup.Close();
+    }
+
+    wxFileName::Rmdir(root, wxPATH_RMDIR_RECURSIVE);
+}
@@ -0,0 +1,130 @@
+#include "PHP/PHPLookupTable.h"
+#include "PHP/PHPSourceFile.h"
+
+#include <algorithm>
+#include <doctest.h>
+#include <vector>
+#include <wx/arrstr.h>
+#include <wx/stopwatch.h>
+
+namespace
+{
+void IndexSource(PHPLookupTable& lookup, const wxString& content)
+{
+    PHPSourceFile source(content, &lookup);
+    source.SetFilename(wxFileName("/tmp/functions.php"));
+    source.Parse();
+    lookup.UpdateSourceFile(source);
+}
+
+std::vector<wxString> Names(const PHPEntityBase::List_t& matches)
+{
+    std::vector<wxString> names;
+    for (const auto& match : matches) {
+        names.push_back(match->GetShortName());
+    }
+    return names;
+}
+} // namespace
+
+TEST_CASE("PHPLookupTable - name lookups are ranked")
+{
+    PHPLookupTable lookup;
+    lookup.Open(wxString(":memory:"));
+    IndexSource(lookup, "<?php\n"
+                        "function forget_user_data() {}\n"
+                        "function userGetter() {}\n"
+                        "function getUserName() {}\n"
+                        "function get_user() {}\n"
+                        "function getuser() {}\n"
+                        "function getUsers() {}\n"
+                        "function setUser() {}\n");
+
+    // the exact match, the names starting with the hint and then the names containing it
+    auto matches = lookup.FindGlobalFunctionAndConsts(PHPLookupTable::kLookupFlags_Contains, "getuser");
+    REQUIRE(matches.size() == 3);
+    CHECK(matches.front()->GetShortName() == "getuser");
+    CHECK(Names(matches) == std::vector<wxString>{"getuser", "getUserName", "getUsers"});
+
+    matches = lookup.FindGlobalFunctionAndConsts(PHPLookupTable::kLookupFlags_Contains, "user");
+    auto names = Names(matches);
+    REQUIRE(names.size() == 7);
+    CHECK(names[0] == "userGetter");
+    CHECK(std::find(names.begin(), names.end(), "setUser") != names.end());
+
+    // '_' is not a wildcard
+    matches = lookup.FindGlobalFunctionAndConsts(PHPLookupTable::kLookupFlags_Contains, "t_u");
+    names = Names(matches);
+    std::sort(names.begin(), names.end());
+    CHECK(names == std::vector<wxString>{"forget_user_data", "get_user"});
+
+    matches = lookup.FindGlobalFunctionAndConsts(PHPLookupTable::kLookupFlags_StartsWith, "getuser");
+    CHECK(Names(matches) == std::vector<wxString>{"getuser", "getUserName", "getUsers"});
+
+    matches = lookup.FindGlobalFunctionAndConsts(PHPLookupTable::kLookupFlags_ExactMatch, "getUsers");
+    CHECK(Names(matches) == std::vector<wxString>{"getUsers"});
+
+    CHECK(lookup.FindGlobalFunctionAndConsts(PHPLookupTable::kLookupFlags_Contains, "it's").empty());
+
+    // the open resource dialog
+    matches.clear();
+    lookup.LoadAllByFilter(matches, "user");
+    names = Names(matches);
+    REQUIRE(names.size() == 7);
+    CHECK(names[0] == "userGetter");
+
+    // the index follows the updates
+    IndexSource(lookup, "<?php\nfunction renamedUser() {}\n");
+    CHECK(lookup.FindGlobalFunctionAndConsts(PHPLookupTable::kLookupFlags_Contains, "getter").empty());
+    CHECK(lookup.FindGlobalFunctionAndConsts(PHPLookupTable::kLookupFlags_Contains, "amedUse").size() == 1);
+}
+
+// look for substrings in a database of 1M functions. Run with --no-skip
+TEST_CASE("PHPLookupTable - 1M symbols benchmark" * doctest::skip())
+{
+    constexpr size_t SYMBOLS_COUNT = 1000000;
+    wxArrayString words = ::wxSplit("get set load save find create update delete handle parse build user order item "
+                                    "cache config request token query result stream listener",
+                                    ' ');
+
+    PHPLookupTable lookup;
+    lookup.Open(wxString(":memory:"));
+    MESSAGE("trigram index: " << lookup.HasTrigramIndex());
+    IndexSource(lookup, "<?php\nfunction main() {}\n");
+    auto globalNs = lookup.FindScope("\\");
+    REQUIRE(globalNs);
+
+    wxStopWatch sw;
+    wxSQLite3Database& db = lookup.Database();
+    db.Begin();
+    wxSQLite3Statement st = db.PrepareStatement("INSERT INTO FUNCTION_TABLE (ID, SCOPE_ID, NAME, FULLNAME, FILE_NAME) "
+                                                "VALUES (NULL, :SCOPE_ID, :NAME, :FULLNAME, :FILE_NAME)");
+    for (size_t i = 0; i < SYMBOLS_COUNT; ++i) {
+        // 1 function out of 10 is global, the others are class members
+        wxLongLong scopeId = (i % 10 == 0) ? globalNs->GetDbId() : wxLongLong(i % 5000 + 1000000);
+        wxString name;
+        name << words[i % words.size()] << words[(i / 7) % words.size()].Capitalize()
+             << words[(i / 13) % words.size()].Capitalize() << i;
+        st.Bind(st.GetParamIndex(":SCOPE_ID"), scopeId);
+        st.Bind(st.GetParamIndex(":NAME"), name);
+        st.Bind(st.GetParamIndex(":FULLNAME"), wxString::Format("\\App\\Class%d\\%s", (int)(i % 5000), name));
+        st.Bind(st.GetParamIndex(":FILE_NAME"), wxString::Format("/src/file%d.php", (int)(i % 20000)));
+        st.ExecuteUpdate();
+        st.Reset();
+    }
+    db.Commit();
+    MESSAGE("inserted " << SYMBOLS_COUNT << " symbols in " << sw.Time() << "ms");
+
+    for (const wxString& hint : {"ListenerCache", "rCacheQ", "Stream12345", "12345", "zzzz"}) {
+        sw.Start();
+        auto matches = lookup.FindGlobalFunctionAndConsts(PHPLookupTable::kLookupFlags_Contains, hint);
+        long global_ms = sw.Time();
+
+        sw.Start();
+        PHPEntityBase::List_t all;
+        lookup.LoadAllByFilter(all, hint);
+        long all_ms = sw.Time();
+        MESSAGE(hint << ": global functions " << global_ms << "ms (" << matches.size() << "), all symbols " << all_ms
+                     << "ms (" << all.size() << ")");
+    }
+}
@@ -0,0 +1,62 @@
+#include "clFoldedStacks.hpp"
+#include "clLatencyHistogram.hpp"
+
+#include <doctest.h>
+
+TEST_CASE("clFoldedStacks - aggregate identical stacks")
+{
+    clFoldedStacks folded;
+    folded.AddSample({"main", "wxEntry", "clEditor::OnSciUpdateUI"});
+    folded.AddSample({"main", "wxEntry", "clEditor::OnSciUpdateUI"});
+    folded.AddSample({"main", "wxEntry", "MainBook::DoRestoreSession"});
+    folded.AddSample({});
+
+    CHECK(folded.GetSamplesCount() == 3);
+    CHECK(folded.GetHottestStack() == "main;wxEntry;clEditor::OnSciUpdateUI");
+    CHECK(folded.ToString() ==
+          "main;wxEntry;MainBook::DoRestoreSession 1\n"
+          "main;wxEntry;clEditor::OnSciUpdateUI 2\n");
+}
+
+TEST_CASE("clFoldedStacks - separators in frame names")
+{
+    clFoldedStacks folded;
+    folded.AddSample({"a;b", "c"});
+    CHECK(folded.ToString() == "a:b;c 1\n");
+}
+
+TEST_CASE("clLatencyHistogram - percentiles and buckets")
+{
+    clLatencyHistogram histogram{1000};
+    for (uint64_t i = 1; i <= 100; ++i) {
+        histogram.Add(i * 100); // 0.1ms .. 10ms
+    }
+
+    CHECK(histogram.GetCount() == 100);
+    CHECK(histogram.GetPercentile(50) == 5000);
+    CHECK(histogram.GetPercentile(99) == 9900);
+    CHECK(histogram.GetPercentile(100) == 10000);
+
+    auto buckets = histogram.GetBuckets();
+    REQUIRE(buckets.size() == 15);
+    CHECK(buckets[0].first == 1);
+    CHECK(buckets[0].second == 10); // <= 1ms
+    CHECK(buckets[1].second == 10); // (1ms, 2ms]
+    CHECK(buckets[2].second == 20); // (2ms, 4ms]
+    CHECK(buckets[3].second == 40); // (4ms, 8ms]
+    CHECK(buckets[4].second == 20); // (8ms, 16ms]
+    CHECK(buckets.back().second == 0);
+}
+
+TEST_CASE("clLatencyHistogram - rolling window")
+{
+    clLatencyHistogram histogram{10};
+    for (uint64_t i = 0; i < 10; ++i) {
+        histogram.Add(1);
+    }
+    for (uint64_t i = 0; i < 10; ++i) {
+        histogram.Add(1000000);
+    }
+    CHECK(histogram.GetCount() == 10);
+    CHECK(histogram.GetPercentile(0) == 1000000);
+}
@@ -0,0 +1,107 @@
+#include "TestUtils.hpp"
+#include "clRecoveryJournal.hpp"
+
+#include <algorithm>
+#include <doctest.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include <wx/ffile.h>
+#include <wx/filename.h>
+
+namespace
+{
+std::string FindContent(const std::vector<clRecoveryJournal::Snapshot>& snapshots, const wxString& filename)
+{
+    auto iter = std::find_if(snapshots.begin(), snapshots.end(), [&](const clRecoveryJournal::Snapshot& snapshot) {
+        return snapshot.filename == filename;
+    });
+    return iter == snapshots.end() ? std::string{"<none>"} : iter->content;
+}
+} // namespace
+
+TEST_CASE("clRecoveryJournal - only changed content is written")
+{
+    wxString root = TestUtils::TempDir("RecoveryJournalWrites").GetPath();
+    clRecoveryJournal journal(root);
+
+    journal.Write("/src/main.cpp", "int main() {}");
+    journal.Flush();
+    CHECK(journal.GetWriteCount() == 1);
+
+    // the same content again: nothing to write
+    journal.Write("/src/main.cpp", "int main() {}");
+    journal.Flush();
+    CHECK(journal.GetWriteCount() == 1);
+
+    journal.Write("/src/main.cpp", "int main() { return 0; }");
+    journal.Flush();
+    CHECK(journal.GetWriteCount() == 2);
+
+    // the session of a running journal is not orphaned
+    CHECK(clRecoveryJournal::FindOrphanedSessions(root).empty());
+
+    // a normal exit leaves nothing to recover
+    journal.Discard();
+    CHECK_FALSE(wxFileName::DirExists(journal.GetSessionDirectory()));
+    wxFileName::Rmdir(root, wxPATH_RMDIR_RECURSIVE);
+}
+
+TEST_CASE("clRecoveryJournal - recover the last snapshot after a crash")
+{
+    wxString root = TestUtils::TempDir("RecoveryJournalCrash").GetPath();
+    wxString sessionDir;
+    {
+        auto journal = std::make_unique<clRecoveryJournal>(root);
+        sessionDir = journal->GetSessionDirectory();
+
+        journal->Write("/src/a.cpp", "a version 1");
+        journal->Write("/src/b.cpp", "b version 1");
+        journal->Write("/src/c.cpp", "c version 1");
+        journal->Flush();
+        journal->Write("/src/a.cpp", "a version 2");
+        // b.cpp was saved
+        journal->Remove("/src/b.cpp");
+        journal->Flush();
+
+        // the process dies while writing the next snapshot of c.cpp
+        wxFFile partial(sessionDir + wxFileName::GetPathSeparator() + "0123456789abcdef.tmp", "wb");
+        partial.Write(wxString("/src/c.cpp\nc vers"));
+        partial.Close();
+        // no Discard(): the session did not end normally
+    }
+
+    // the next start
+    clRecoveryJournal journal(root);
+    auto orphaned = clRecoveryJournal::FindOrphanedSessions(root);
+    REQUIRE(orphaned.size() == 1);
+    CHECK(orphaned[0] == sessionDir);
+
+    auto snapshots = clRecoveryJournal::LoadSession(orphaned[0]);
+    CHECK(snapshots.size() == 2);
+    CHECK(FindContent(snapshots, "/src/a.cpp") == "a version 2");
+    CHECK(FindContent(snapshots, "/src/b.cpp") == "<none>");
+    CHECK(FindContent(snapshots, "/src/c.cpp") == "c version 1");
+
+    clRecoveryJournal::DeleteSession(orphaned[0]);
+    CHECK(clRecoveryJournal::FindOrphanedSessions(root).empty());
+    journal.Discard();
+    wxFileName::Rmdir(root, wxPATH_RMDIR_RECURSIVE);
+}
+
+TEST_CASE("clRecoveryJournal - compare with the file on the disk")
+{
+    wxString root = TestUtils::TempDir("RecoveryJournalDisk").GetPath();
+    wxString path = wxFileName(root, "file.txt").GetFullPath();
+    wxFFile fp(path, "wb");
+    fp.Write(wxString("on disk\n"));
+    fp.Close();
+
+    clRecoveryJournal::Snapshot snapshot{path, "on disk\n"};
+    CHECK_FALSE(clRecoveryJournal::DiffersFromDisk(snapshot));
+    snapshot.content = "edited\n";
+    CHECK(clRecoveryJournal::DiffersFromDisk(snapshot));
+    snapshot.filename = wxFileName(root, "deleted.txt").GetFullPath();
+    CHECK(clRecoveryJournal::DiffersFromDisk(snapshot));
+    wxFileName::Rmdir(root, wxPATH_RMDIR_RECURSIVE);
+}
@@ -0,0 +1,162 @@
+#include "clSearchResultsModel.hpp"
+
+#include <algorithm>
+#include <doctest.h>
+#include <wx/stopwatch.h>
+
+namespace
+{
+SearchResult MakeResult(const wxString& file, int line, const wxString& pattern, int column, int len)
+{
+    SearchResult result;
+    result.SetFileName(file);
+    result.SetLineNumber(line);
+    result.SetPattern(pattern);
+    result.SetColumn(column);
+    result.SetLen(len);
+    result.SetColumnInChars(column);
+    result.SetLenInChars(len);
+    result.SetPosition(line * 100 + column);
+    result.SetFindWhat("value");
+    result.SetFlags(wxSD_MATCHCASE);
+    return result;
+}
+} // namespace
+
+TEST_CASE("clSearchResultsModel - files and matches")
+{
+    clSearchResultsModel model;
+    SearchResultList results;
+    results.push_back(MakeResult("/src/a.cpp", 10, "int value = value + 1;", 4, 5));
+    results.push_back(MakeResult("/src/a.cpp", 10, "int value = value + 1;", 12, 5));
+    results.push_back(MakeResult("/src/a.cpp", 20, "return value;", 7, 5));
+    results.push_back(MakeResult("/src/b.cpp", 3, wxString::FromUTF8("// no value: \xC3\xA9t\xC3\xA9"), 6, 5));
+    results.back().SetScope("Foo::Bar");
+    wxArrayString captures;
+    captures.Add("value");
+    results.back().SetRegexCaptures(captures);
+    model.Append(results);
+
+    REQUIRE(model.GetMatchCount() == 4);
+    REQUIRE(model.GetFileCount() == 2);
+    CHECK(model.GetFileName(0) == "/src/a.cpp");
+    CHECK(model.GetFileMatchCount(0) == 3);
+    CHECK(model.GetFileMatchCount(1) == 1);
+    CHECK(model.GetFileOfMatch(2) == 0);
+    CHECK(model.GetFileOfMatch(3) == 1);
+
+    // the SearchResult is built back as it was added
+    SearchResult match = model.GetMatch(1);
+    CHECK(match.GetFileName() == "/src/a.cpp");
+    CHECK(match.GetLineNumber() == 10);
+    CHECK(match.GetColumn() == 12);
+    CHECK(match.GetLen() == 5);
+    CHECK(match.GetPosition() == 1012);
+    CHECK(match.GetPattern() == "int value = value + 1;");
+    CHECK(match.GetFindWhat() == "value");
+    CHECK(match.GetFlags() == wxSD_MATCHCASE);
+    CHECK(match.GetScope().empty());
+
+    match = model.GetMatch(3);
+    CHECK(match.GetPattern() == results[3].GetPattern());
+    CHECK(match.GetScope() == "Foo::Bar");
+    CHECK(match.GetRegexCapture(0) == "value");
+}
+
+TEST_CASE("clSearchResultsModel - collapse and expand")
+{
+    clSearchResultsModel model;
+    for (int file = 0; file < 3; ++file) {
+        for (int line = 1; line <= 4; ++line) {
+            model.Append(MakeResult(wxString::Format("/src/file%d.cpp", file), line, "value", 0, 5));
+        }
+    }
+
+    // a row per file + a row per match
+    REQUIRE(model.GetRowCount() == 15);
+    CHECK(model.GetRow(0).IsFile());
+    CHECK(model.GetRow(0).file == 0);
+    CHECK(model.GetRow(1).match == 0);
+    CHECK(model.GetRow(5).IsFile());
+    CHECK(model.GetRow(5).file == 1);
+    CHECK(model.GetRow(14).match == 11);
+    CHECK(model.GetRow(15).file == clSearchResultsModel::npos);
+    CHECK(model.GetMatchRow(4) == 6);
+
+    model.SetExpanded(1, false);
+    CHECK(model.GetRowCount() == 11);
+    CHECK(model.GetRow(5).file == 1);
+    CHECK(model.GetRow(6).IsFile());
+    CHECK(model.GetRow(6).file == 2);
+    CHECK(model.GetRow(7).match == 8);
+    CHECK(model.GetMatchRow(4) == clSearchResultsModel::npos);
+    CHECK(model.GetMatchRow(8) == 7);
+
+    model.SetAllExpanded(false);
+    CHECK(model.GetRowCount() == 3);
+    CHECK(model.GetRow(2).file == 2);
+
+    // new matches are added to the last file, new files are added collapsed
+    model.SetExpandNewFiles(false);
+    model.Append(MakeResult("/src/file2.cpp", 5, "value", 0, 5));
+    model.Append(MakeResult("/src/file3.cpp", 1, "value", 0, 5));
+    CHECK(model.GetFileMatchCount(2) == 5);
+    CHECK(model.GetRowCount() == 4);
+    model.SetExpanded(3, true);
+    CHECK(model.GetRowCount() == 5);
+    CHECK(model.GetRow(4).match == 13);
+
+    model.Clear();
+    CHECK(model.IsEmpty());
+    CHECK(model.GetRowCount() == 0);
+}
+
+TEST_CASE("clSearchResultsModel - 1M matches")
+{
+    constexpr size_t MATCHES_COUNT = 1000000;
+    constexpr size_t MATCHES_PER_FILE = 50;
+    // the line text is ~60 bytes, a SearchResult alone is several hundred
+    constexpr size_t MAX_BYTES_PER_MATCH = 160;
+    constexpr double MIN_MATCHES_PER_SECOND = 100000;
+
+    clSearchResultsModel model;
+    SearchResult result = MakeResult("", 0, "", 0, 5);
+
+    // the search thread sends its results in batches. Only the time spent in the model is measured
+    SearchResultList batch;
+    batch.reserve(100);
+    wxStopWatch sw;
+    sw.Pause();
+    for (size_t i = 0; i < MATCHES_COUNT; ++i) {
+        result.SetFileName(wxString::Format("/home/user/src/project/module%zu/file%zu.cpp",
+                                            i / (MATCHES_PER_FILE * 100),
+                                            i / MATCHES_PER_FILE));
+        result.SetLineNumber(static_cast<int>(i % MATCHES_PER_FILE) + 1);
+        result.SetPattern(wxString::Format("    auto value%zu = ComputeTheValue(value, %zu); // value", i, i));
+        result.SetColumn(9);
+        batch.push_back(result);
+        if (batch.size() == batch.capacity()) {
+            sw.Resume();
+            model.Append(batch);
+            sw.Pause();
+            batch.clear();
+        }
+    }
+    long elapsed_ms = std::max(sw.Time(), 1L);
+
+    double matches_per_second = MATCHES_COUNT * 1000.0 / elapsed_ms;
+    size_t bytes_per_match = model.GetMemoryUsage() / MATCHES_COUNT;
+    MESSAGE("appended " << MATCHES_COUNT << " matches in " << elapsed_ms << "ms, " << bytes_per_match
+                        << " bytes per match");
+
+    REQUIRE(model.GetMatchCount() == MATCHES_COUNT);
+    CHECK(model.GetFileCount() == MATCHES_COUNT / MATCHES_PER_FILE);
+    CHECK(model.GetRowCount() == MATCHES_COUNT + MATCHES_COUNT / MATCHES_PER_FILE);
+    CHECK(bytes_per_match <= MAX_BYTES_PER_MATCH);
+    CHECK(matches_per_second >= MIN_MATCHES_PER_SECOND);
+
+    // rows are mapped without walking the files
+    auto row = model.GetRow(model.GetRowCount() - 1);
+    CHECK(row.match == MATCHES_COUNT - 1);
+    CHECK(model.GetLineText(row.match).Contains("value999999"));
+}
@@ -0,0 +1,299 @@
+#include "TestUtils.hpp"
+#include "clTailReader.hpp"
+
+#include <chrono>
+#include <condition_variable>
+#include <doctest.h>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+
+namespace
+{
+void RemoveTailFile(const wxString& path)
+{
+    for (const wxString& file : {path, path + ".1"}) {
+        if (wxFileName::FileExists(file)) {
+            ::wxRemoveFile(file);
+        }
+    }
+}
+
+wxString MakeTailFile(const wxString& name)
+{
+    wxString path = TestUtils::TempFile(name, "log").GetFullPath();
+    RemoveTailFile(path);
+    wxFFile fp(path, "wb");
+    fp.Close();
+    return path;
+}
+
+void WriteTo(const wxString& path, const std::string& content, const char* mode = "ab")
+{
+    wxFFile fp(path, mode);
+    fp.Write(content.data(), content.size());
+    fp.Close();
+}
+
+std::vector<wxString> Texts(const std::vector<clTailReader::Line>& lines)
+{
+    std::vector<wxString> texts;
+    for (const auto& line : lines) {
+        texts.push_back(line.text);
+    }
+    return texts;
+}
+} // namespace
+
+TEST_CASE("clTailReader - UTF-8 boundary and severity")
+{
+    // "é" is C3 A9, "€" is E2 82 AC
+    CHECK(clTailReader::Utf8Boundary("abc", 3) == 3);
+    CHECK(clTailReader::Utf8Boundary("a\xC3\xA9", 3) == 3);
+    CHECK(clTailReader::Utf8Boundary("a\xC3", 2) == 1);
+    CHECK(clTailReader::Utf8Boundary("a\xE2\x82", 3) == 1);
+    CHECK(clTailReader::Utf8Boundary("a\xE2\x82\xAC", 4) == 4);
+
+    CHECK(clTailReader::GetSeverity("[ERROR] disk full") == clTailReader::Severity::kError);
+    CHECK(clTailReader::GetSeverity("Fatal: out of memory") == clTailReader::Severity::kError);
+    CHECK(clTailReader::GetSeverity("warning: unused variable") == clTailReader::Severity::kWarning);
+    CHECK(clTailReader::GetSeverity("request served in 3ms") == clTailReader::Severity::kNone);
+}
+
+TEST_CASE("clTailReader - lines and characters spanning chunks")
+{
+    wxString path = MakeTailFile("TailChunks");
+    WriteTo(path, "h\xC3\xA9llo w\xC3\xB6rld\r\n\xE2\x82\xAC 42\nlast line ");
+
+    // a chunk is smaller than a line and splits the multi byte characters
+    clTailReader reader(3);
+    REQUIRE(reader.Open(path, 0));
+    reader.Poll();
+    auto update = reader.TakeUpdate();
+    CHECK(Texts(update.lines) ==
+          std::vector<wxString>{wxString::FromUTF8("h\xC3\xA9llo w\xC3\xB6rld"), wxString::FromUTF8("\xE2\x82\xAC 42")});
+
+    // the partial line is completed by the next write
+    WriteTo(path, "written\n");
+    reader.Poll();
+    CHECK(Texts(reader.TakeUpdate().lines) == std::vector<wxString>{"last line written"});
+
+    // from the end of the file
+    CHECK(reader.Open(path, clTailReader::END_OF_FILE));
+    reader.Poll();
+    CHECK(reader.TakeUpdate().lines.empty());
+    RemoveTailFile(path);
+}
+
+#ifndef __WXMSW__
+TEST_CASE("clTailReader - rotation and truncation")
+{
+    wxString path = MakeTailFile("TailRotation");
+    clTailReader reader(16);
+    REQUIRE(reader.Open(path, 0));
+
+    WriteTo(path, "one\ntw");
+    reader.Poll();
+    CHECK(Texts(reader.TakeUpdate().lines) == std::vector<wxString>{"one"});
+
+    // the logger finishes writing to the rotated file, then writes to a new one
+    REQUIRE(::wxRenameFile(path, path + ".1"));
+    WriteTo(path + ".1", "o\n");
+    WriteTo(path, "three is a long line\n", "wb");
+    reader.Poll();
+    auto update = reader.TakeUpdate();
+    REQUIRE(update.lines.size() == 3);
+    CHECK(update.lines[0].text == "two");
+    CHECK(update.lines[1].severity == clTailReader::Severity::kNotice);
+    CHECK(update.lines[2].text == "three is a long line");
+
+    // truncated, then written again
+    WriteTo(path, "four\n", "wb");
+    reader.Poll();
+    update = reader.TakeUpdate();
+    REQUIRE(update.lines.size() == 2);
+    CHECK(update.lines[0].severity == clTailReader::Severity::kNotice);
+    CHECK(update.lines[1].text == "four");
+    RemoveTailFile(path);
+}
+
+TEST_CASE("clTailReader - follow a fast growing, rotated file")
+{
+    constexpr size_t LINES = 20000;
+    constexpr size_t ROTATE_EVERY = 5000;
+
+    wxString path = MakeTailFile("TailFollow");
+    clTailReader reader(4096);
+    reader.SetMaxLines(LINES * 2);
+    REQUIRE(reader.Open(path, 0));
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool notified = false;
+    reader.Start(
+        [&]() {
+            std::unique_lock lock{mutex};
+            notified = true;
+            cv.notify_all();
+        },
+        std::chrono::milliseconds(5));
+
+    std::thread writer([&]() {
+        std::string batch;
+        for (size_t i = 0; i < LINES; ++i) {
+            batch += "line " + std::to_string(i) + " \xE2\x82\xAC\n";
+            if (batch.size() > 1000) {
+                WriteTo(path, batch);
+                batch.clear();
+            }
+            if ((i + 1) % ROTATE_EVERY == 0 && i + 1 < LINES) {
+                WriteTo(path, batch);
+                batch.clear();
+                ::wxRemoveFile(path + ".1");
+                ::wxRenameFile(path, path + ".1");
+                WriteTo(path, "", "wb");
+                // a file rotated twice between two polls is not followed
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+        }
+        WriteTo(path, batch);
+    });
+
+    std::vector<wxString> lines;
+    size_t notices = 0;
+    wxString lastLine = wxString::FromUTF8("line " + std::to_string(LINES - 1) + " \xE2\x82\xAC");
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(20);
+    while ((lines.empty() || lines.back() != lastLine) && std::chrono::steady_clock::now() < deadline) {
+        {
+            std::unique_lock lock{mutex};
+            cv.wait_for(lock, std::chrono::milliseconds(100), [&] { return notified; });
+            notified = false;
+        }
+        auto update = reader.TakeUpdate();
+        CHECK(update.dropped == 0);
+        for (const auto& line : update.lines) {
+            if (line.severity == clTailReader::Severity::kNotice) {
+                ++notices;
+            } else {
+                lines.push_back(line.text);
+            }
+        }
+    }
+    writer.join();
+    reader.Stop();
+
+    REQUIRE(lines.size() == LINES);
+    for (size_t i = 0; i < LINES; ++i) {
+        REQUIRE(lines[i] == wxString::FromUTF8("line " + std::to_string(i) + " \xE2\x82\xAC"));
+    }
+    CHECK(notices == LINES / ROTATE_EVERY - 1);
+    RemoveTailFile(path);
+}
+#endif
+
+TEST_CASE("clTailReader - bounded memory")
+{
+    constexpr size_t MAX_LINES = 100;
+    wxString path = MakeTailFile("TailBounded");
+    std::string content;
+    for (size_t i = 0; i < 10000; ++i) {
+        content += "line " + std::to_string(i) + "\n";
+    }
+    WriteTo(path, content);
+
+    // nobody takes the lines: only the last ones are kept
+    clTailReader reader(256);
+    reader.SetMaxLines(MAX_LINES);
+    REQUIRE(reader.Open(path, 0));
+    reader.Poll();
+    WriteTo(path, content);
+    reader.Poll();
+    CHECK(reader.GetLineCount() == MAX_LINES);
+
+    auto update = reader.TakeUpdate();
+    REQUIRE(update.lines.size() == MAX_LINES);
+    CHECK(update.dropped == 20000 - MAX_LINES);
+    CHECK(update.lines.front().text == "line 9900");
+    CHECK(update.lines.back().text == "line 9999");
+    RemoveTailFile(path);
+}
+
+TEST_CASE("clTailReader - filters")
+{
+    wxString path = MakeTailFile("TailFilters");
+    WriteTo(path, "INFO started\nERROR disk full\nWARN slow request\nERROR timeout in health check\n");
+
+    clTailReader reader;
+    REQUIRE(reader.Open(path, 0));
+    reader.Poll();
+    CHECK(reader.TakeUpdate().lines.size() == 4);
+
+    // the kept lines are filtered again
+    REQUIRE(reader.SetFilters("error", "health"));
+    auto update = reader.TakeUpdate();
+    CHECK(update.reset);
+    CHECK(Texts(update.lines) == std::vector<wxString>{"ERROR disk full"});
+    CHECK(update.lines[0].severity == clTailReader::Severity::kError);
+
+    // and so are the new ones
+    WriteTo(path, "error again\ninfo\n");
+    reader.Poll();
+    update = reader.TakeUpdate();
+    CHECK_FALSE(update.reset);
+    CHECK(Texts(update.lines) == std::vector<wxString>{"error again"});
+
+    // an invalid expression keeps the current filters
+    CHECK_FALSE(reader.SetFilters("error(", ""));
+    CHECK_FALSE(reader.TakeUpdate().reset);
+
+    REQUIRE(reader.SetFilters("", ""));
+    CHECK(reader.TakeUpdate().lines.size() == 6);
+    RemoveTailFile(path);
+}
+
+TEST_CASE("clTailReader - filters changed while paused")
+{
+    wxString path = MakeTailFile("TailPaused");
+    WriteTo(path, "INFO started\nERROR disk full\n");
+
+    clTailReader reader;
+    REQUIRE(reader.Open(path, 0));
+    reader.Poll();
+    CHECK(reader.TakeUpdate().lines.size() == 2);
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t notifications = 0;
+    auto onLines = [&]() {
+        std::unique_lock lock{mutex};
+        ++notifications;
+        cv.notify_all();
+    };
+    auto waitForNotification = [&]() {
+        std::unique_lock lock{mutex};
+        bool notified = cv.wait_for(lock, std::chrono::seconds(5), [&] { return notifications > 0; });
+        notifications = 0;
+        return notified;
+    };
+
+    // pause, change the filters: the update is delivered on resume
+    reader.Start(onLines, std::chrono::milliseconds(5));
+    reader.Stop();
+    REQUIRE(reader.SetFilters("error", ""));
+    reader.Start(onLines, std::chrono::milliseconds(5));
+    REQUIRE(waitForNotification());
+    auto update = reader.TakeUpdate();
+    CHECK(update.reset);
+    CHECK(Texts(update.lines) == std::vector<wxString>{"ERROR disk full"});
+
+    // and the new lines are still notified
+    WriteTo(path, "error again\n");
+    REQUIRE(waitForNotification());
+    CHECK(Texts(reader.TakeUpdate().lines) == std::vector<wxString>{"error again"});
+    reader.Stop();
+    RemoveTailFile(path);
+}
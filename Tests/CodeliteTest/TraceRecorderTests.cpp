@@ -0,0 +1,90 @@
+#include "clTraceRecorder.hpp"
+
+#include <assistant/common/json.hpp>
+#include <doctest.h>
+#include <thread>
+
+namespace
+{
+clTraceEvent MakeEvent(const std::string& name, uint64_t start_us, uint64_t duration_us)
+{
+    clTraceEvent event;
+    event.name = name;
+    event.category = clTraceRecorder::CategoryFromLabel(name);
+    event.start_us = start_us;
+    event.duration_us = duration_us;
+    return event;
+}
+} // namespace
+
+TEST_CASE("clTraceRecorder::CategoryFromLabel")
+{
+    CHECK(clTraceRecorder::CategoryFromLabel("LSP->ProcessQueue") == "LSP");
+    CHECK(clTraceRecorder::CategoryFromLabel("clEditor::OnKeyDown") == "clEditor");
+    CHECK(clTraceRecorder::CategoryFromLabel("HighlightWord") == "General");
+    CHECK(clTraceRecorder::CategoryFromLabel("->Odd") == "General");
+}
+
+TEST_CASE("clTraceRecorder::ComputeStats - percentiles")
+{
+    std::vector<clTraceEvent> events;
+    for (uint64_t i = 1; i <= 100; ++i) {
+        events.push_back(MakeEvent("UpdateLineNumbers", i, i));
+    }
+    events.push_back(MakeEvent("HighlightWord", 0, 5000));
+
+    auto stats = clTraceRecorder::ComputeStats(events);
+    REQUIRE(stats.size() == 2);
+
+    // sorted by p99, slowest first
+    CHECK(stats[0].name == "HighlightWord");
+    CHECK(stats[0].count == 1);
+    CHECK(stats[0].p50_us == 5000);
+    CHECK(stats[0].max_us == 5000);
+
+    CHECK(stats[1].name == "UpdateLineNumbers");
+    CHECK(stats[1].count == 100);
+    CHECK(stats[1].p50_us == 50);
+    CHECK(stats[1].p95_us == 95);
+    CHECK(stats[1].p99_us == 99);
+    CHECK(stats[1].max_us == 100);
+}
+
+TEST_CASE("clTraceRecorder::ToChromeTraceJSON")
+{
+    std::vector<clTraceEvent> events{MakeEvent("LSP->ProcessQueue", 10, 20)};
+    events[0].args = "queue size: 3";
+
+    auto root = nlohmann::json::parse(clTraceRecorder::ToChromeTraceJSON(events));
+    REQUIRE(root.contains("traceEvents"));
+    const auto& trace_events = root["traceEvents"];
+    REQUIRE(trace_events.size() == 2); // thread name metadata + the span
+
+    const auto& span = trace_events[1];
+    CHECK(span["name"] == "LSP->ProcessQueue");
+    CHECK(span["cat"] == "LSP");
+    CHECK(span["ph"] == "X");
+    CHECK(span["ts"] == 10);
+    CHECK(span["dur"] == 20);
+    CHECK(span["args"]["message"] == "queue size: 3");
+}
+
+TEST_CASE("clTraceRecorder::Record - per thread buffers")
+{
+    auto& recorder = clTraceRecorder::Get();
+    recorder.Clear();
+
+    uint64_t now = clTraceRecorder::NowMicro();
+    recorder.Record("Main->Span", "", now + 1, 10, 0);
+    std::thread worker{[now]() { clTraceRecorder::Get().Record("Worker->Span", "", now + 2, 20, 0); }};
+    worker.join();
+
+    auto events = recorder.Snapshot();
+    REQUIRE(events.size() == 2);
+    CHECK(events[0].name == "Main->Span");
+    CHECK(events[1].name == "Worker->Span");
+    CHECK(events[0].thread_id != events[1].thread_id);
+
+    recorder.Clear();
+    CHECK(recorder.Snapshot().empty());
+}
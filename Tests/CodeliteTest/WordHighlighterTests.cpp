@@ -0,0 +1,165 @@
+#include "clWordHighlighter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <doctest.h>
+#include <mutex>
+#include <string>
+#include <wx/stopwatch.h>
+
+namespace
+{
+/// collect the results of a clWordHighlighter
+struct ResultCollector {
+    std::mutex mutex;
+    std::condition_variable cv;
+    size_t lastId = 0;
+    size_t callbacks = 0;
+    clWordHighlighter::Matches_t matches;
+
+    clWordHighlighter::Callback_t Callback()
+    {
+        return [this](size_t id, clWordHighlighter::Matches_t m) {
+            std::unique_lock lock{mutex};
+            lastId = id;
+            ++callbacks;
+            matches = std::move(m);
+            cv.notify_all();
+        };
+    }
+
+    bool WaitFor(size_t id)
+    {
+        std::unique_lock lock{mutex};
+        return cv.wait_for(lock, std::chrono::seconds(5), [this, id] { return lastId == id; });
+    }
+};
+
+std::string MakeDocument(size_t lines)
+{
+    std::string doc;
+    for (size_t i = 0; i < lines; ++i) {
+        doc += "    int value_" + std::to_string(i % 100) + " = value + compute(value, " + std::to_string(i) + ");\n";
+    }
+    return doc;
+}
+} // namespace
+
+TEST_CASE("clWordHighlighter - whole words")
+{
+    using Matches_t = clWordHighlighter::Matches_t;
+
+    // positions are offset and in bytes
+    CHECK(clWordHighlighter::FindWholeWords("value value_1 _value value;", 100, "value") ==
+          Matches_t{{100, 5}, {121, 5}});
+    // multi byte characters are word characters and count as their UTF-8 length
+    CHECK(clWordHighlighter::FindWholeWords("h\xC3\xA9llo hello h\xC3\xA9llo", 0, "h\xC3\xA9llo") ==
+          Matches_t{{0, 6}, {13, 6}});
+    CHECK(clWordHighlighter::FindWholeWords("\xC3\xA9value value", 0, "value") == Matches_t{{8, 5}});
+    // match case
+    CHECK(clWordHighlighter::FindWholeWords("Value value", 0, "value") == Matches_t{{6, 5}});
+    // no boundary is required on a side that is not a word character
+    CHECK(clWordHighlighter::FindWholeWords("a->b x->y", 0, "->") == Matches_t{{1, 2}, {6, 2}});
+    CHECK(clWordHighlighter::FindWholeWords("value", 0, "").empty());
+    CHECK(clWordHighlighter::FindWholeWords("val", 0, "value").empty());
+
+    // a cancelled search returns nothing
+    std::string doc = MakeDocument(10000);
+    CHECK_FALSE(clWordHighlighter::FindWholeWords(doc, 0, "value").empty());
+    CHECK(clWordHighlighter::FindWholeWords(doc, 0, "value", [] { return true; }).empty());
+}
+
+TEST_CASE("clWordHighlighter - the latest request wins")
+{
+    ResultCollector collector;
+    clWordHighlighter highlighter;
+    const void* key = &collector;
+
+    size_t id = highlighter.Submit(key, "foo bar foo", 10, "foo", collector.Callback());
+    REQUIRE(collector.WaitFor(id));
+    CHECK(collector.matches == clWordHighlighter::Matches_t{{10, 3}, {18, 3}});
+
+    // a burst of requests: the last one is always reported, the ones it superseded may not be
+    std::string doc = MakeDocument(20000);
+    size_t callbacksBefore = collector.callbacks;
+    size_t last = 0;
+    for (size_t i = 0; i < 50; ++i) {
+        last = highlighter.Submit(key, doc, 0, "value", collector.Callback());
+    }
+    last = highlighter.Submit(key, "bar foo", 0, "bar", collector.Callback());
+    REQUIRE(collector.WaitFor(last));
+    CHECK(collector.matches == clWordHighlighter::Matches_t{{0, 3}});
+    CHECK(collector.callbacks - callbacksBefore <= 51);
+
+    // a cancelled request is never reported
+    size_t cancelled = highlighter.Submit(key, doc, 0, "compute", collector.Callback());
+    highlighter.Cancel(key);
+    last = highlighter.Submit(key, "x", 0, "x", collector.Callback());
+    REQUIRE(collector.WaitFor(last));
+    CHECK(last != cancelled);
+}
+
+TEST_CASE("clWordHighlighter - the owners share the worker")
+{
+    ResultCollector first;
+    ResultCollector second;
+    clWordHighlighter highlighter;
+    std::string doc = MakeDocument(20000);
+
+    // a request of one owner does not supersede the request of another
+    size_t firstId = highlighter.Submit(&first, doc, 0, "compute", first.Callback());
+    size_t secondId = highlighter.Submit(&second, "foo bar", 5, "bar", second.Callback());
+    CHECK(firstId != secondId);
+    REQUIRE(first.WaitFor(firstId));
+    REQUIRE(second.WaitFor(secondId));
+    CHECK(first.matches.size() == 20000);
+    CHECK(second.matches == clWordHighlighter::Matches_t{{9, 3}});
+
+    // once Cancel() returns the owner is not called again, the other owners are
+    highlighter.Submit(&first, doc, 0, "value", first.Callback());
+    highlighter.Cancel(&first);
+    size_t callbacks = first.callbacks;
+    secondId = highlighter.Submit(&second, "bar", 0, "bar", second.Callback());
+    REQUIRE(second.WaitFor(secondId));
+    CHECK(first.callbacks == callbacks);
+}
+
+// time from a caret move to the matches of the visible lines, on a 50k lines file. Run with --no-skip
+TEST_CASE("clWordHighlighter - keystroke latency benchmark" * doctest::skip())
+{
+    constexpr size_t LINES = 50000;
+    // the editor searches the visible lines plus a screen above and below
+    constexpr size_t WINDOW_LINES = 3 * 60;
+    constexpr size_t KEYSTROKES = 200;
+
+    std::string doc = MakeDocument(LINES);
+    size_t lineLen = doc.find('\n') + 1;
+
+    wxStopWatch sw;
+    clWordHighlighter::FindWholeWords(doc, 0, "value");
+    long wholeDocumentMs = sw.Time();
+
+    ResultCollector collector;
+    clWordHighlighter highlighter;
+    long maxMicro = 0;
+    long totalMicro = 0;
+    for (size_t i = 0; i < KEYSTROKES; ++i) {
+        size_t first = (i * 250) % (LINES - WINDOW_LINES);
+        wxStopWatch keystroke;
+        // the UI thread only copies the window, the search runs on the worker
+        size_t id = highlighter.Submit(&collector,
+                                       doc.substr(first * lineLen, WINDOW_LINES * lineLen),
+                                       static_cast<int>(first * lineLen),
+                                       "value",
+                                       collector.Callback());
+        REQUIRE(collector.WaitFor(id));
+        long micro = keystroke.TimeInMicro().GetValue();
+        maxMicro = std::max(maxMicro, micro);
+        totalMicro += micro;
+    }
+
+    MESSAGE("whole document search: " << wholeDocumentMs << "ms, keystroke to matches: avg "
+                                      << totalMicro / KEYSTROKES << "us, max " << maxMicro << "us");
+    CHECK(maxMicro < 16000); // one frame
+}
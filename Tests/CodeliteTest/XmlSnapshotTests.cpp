@@ -0,0 +1,84 @@
+#include "TestUtils.hpp"
+#include "fileutils.h"
+#include "xml/clXmlSnapshot.hpp"
+
+#include <doctest.h>
+#include <wx/sstream.h>
+
+namespace
+{
+wxString ToXml(const wxXmlDocument& doc)
+{
+    wxString xml;
+    wxStringOutputStream sos(&xml);
+    doc.Save(sos);
+    return xml;
+}
+} // namespace
+
+TEST_CASE("clXmlSnapshot - round trip")
+{
+    const char* xml = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                      "<CodeLite_Project Name=\"demo\" Version=\"11000\">\n"
+                      "  <!-- a comment -->\n"
+                      "  <VirtualDirectory Name=\"src\">\n"
+                      "    <File Name=\"main.cpp\"/>\n"
+                      "    <File Name=\"\xc3\xa9t\xc3\xa9.cpp\" Flags=\"1\"/>\n"
+                      "  </VirtualDirectory>\n"
+                      "  <Plugins><Plugin Name=\"x\"><![CDATA[data]]></Plugin></Plugins>\n"
+                      "  <Description>some text</Description>\n"
+                      "</CodeLite_Project>\n";
+    wxStringInputStream sis(wxString::FromUTF8(xml));
+    wxXmlDocument doc;
+    REQUIRE(doc.Load(sis));
+
+    std::string buffer = clXmlSnapshot::ToBuffer(doc, 1234, 5678);
+
+    wxXmlDocument restored;
+    REQUIRE(clXmlSnapshot::FromBuffer(buffer, 1234, 5678, restored));
+    CHECK(restored.GetRoot()->GetName() == "CodeLite_Project");
+    CHECK(ToXml(restored) == ToXml(doc));
+}
+
+TEST_CASE("clXmlSnapshot - stale or corrupted snapshots are rejected")
+{
+    wxXmlDocument doc;
+    doc.SetRoot(new wxXmlNode(nullptr, wxXML_ELEMENT_NODE, "Root"));
+    std::string buffer = clXmlSnapshot::ToBuffer(doc, 1234, 5678);
+
+    wxXmlDocument restored;
+    CHECK_FALSE(clXmlSnapshot::FromBuffer(buffer, 1235, 5678, restored));
+    CHECK_FALSE(clXmlSnapshot::FromBuffer(buffer, 1234, 5679, restored));
+    CHECK_FALSE(clXmlSnapshot::FromBuffer(buffer.substr(0, buffer.size() - 1), 1234, 5678, restored));
+    CHECK_FALSE(clXmlSnapshot::FromBuffer("garbage", 1234, 5678, restored));
+    CHECK(clXmlSnapshot::FromBuffer(buffer, 1234, 5678, restored));
+}
+
+TEST_CASE("clXmlSnapshot - a change within the same second invalidates the snapshot")
+{
+    wxFileName root = TestUtils::TempDir("clXmlSnapshot");
+
+    wxFileName source(root.GetPath(), "demo.project");
+    REQUIRE(FileUtils::WriteFileContent(source, "<Root Name=\"a\"/>"));
+    wxXmlDocument doc;
+    REQUIRE(doc.Load(source.GetFullPath()));
+    wxFileName snapshot = clXmlSnapshot::GetSnapshotFile(root.GetPath(), source);
+    REQUIRE(clXmlSnapshot::Save(doc, source, snapshot));
+
+    wxXmlDocument restored;
+    REQUIRE(clXmlSnapshot::Load(restored, source, snapshot));
+    CHECK(restored.GetRoot()->GetAttribute("Name") == "a");
+
+    // same size, written right away: the modification time may not change
+    REQUIRE(FileUtils::WriteFileContent(source, "<Root Name=\"b\"/>"));
+    CHECK_FALSE(clXmlSnapshot::Load(restored, source, snapshot));
+
+    // the snapshots of the other sources are pruned
+    wxFileName removed(root.GetPath(), "removed.project");
+    REQUIRE(FileUtils::WriteFileContent(removed, "<Root/>"));
+    REQUIRE(clXmlSnapshot::Save(doc, removed, clXmlSnapshot::GetSnapshotFile(root.GetPath(), removed)));
+    CHECK(clXmlSnapshot::Prune(root.GetPath(), {source}) == 1);
+    CHECK(snapshot.FileExists());
+    CHECK_FALSE(clXmlSnapshot::GetSnapshotFile(root.GetPath(), removed).FileExists());
+    root.Rmdir(wxPATH_RMDIR_RECURSIVE);
+}
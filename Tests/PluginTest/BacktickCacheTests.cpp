@@ -0,0 +1,157 @@
+#include "TestUtils.hpp"
+#include "clBacktickCache.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <doctest.h>
+#include <thread>
+#include <vector>
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+namespace
+{
+/// a runner that counts its calls and the number of commands running at the same time
+struct CountingRunner {
+    std::atomic_size_t calls{0};
+    std::atomic_size_t running{0};
+    std::atomic_size_t maxRunning{0};
+
+    clBacktickCache::Runner_t Runner()
+    {
+        return [this](const wxString& command, const wxString& workingDirectory) {
+            ++calls;
+            size_t now = ++running;
+            size_t max = maxRunning.load();
+            while (now > max && !maxRunning.compare_exchange_weak(max, now)) {
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+            --running;
+            return "  " + command + "@" + workingDirectory + "\n";
+        };
+    }
+};
+} // namespace
+
+TEST_CASE("clBacktickCache - each distinct command runs once")
+{
+    constexpr size_t PROJECTS_COUNT = 100;
+    constexpr size_t COMMANDS_COUNT = 5;
+
+    CountingRunner runner;
+    clBacktickCache cache;
+    cache.SetRunner(runner.Runner());
+
+    // every project of the workspace uses the same pkg-config calls
+    std::vector<clBacktickCache::Request> requests;
+    for (size_t i = 0; i < PROJECTS_COUNT; ++i) {
+        for (size_t j = 0; j < COMMANDS_COUNT; ++j) {
+            requests.push_back({wxString::Format("pkg-config --cflags lib%zu", j), "/workspace"});
+        }
+    }
+
+    auto outputs = cache.EvaluateAll(requests, 4);
+    CHECK(runner.calls == COMMANDS_COUNT);
+    CHECK(cache.GetRunCount() == COMMANDS_COUNT);
+    CHECK(runner.maxRunning > 1);
+    CHECK(runner.maxRunning <= 4);
+
+    // the outputs are trimmed and in the order of the requests
+    REQUIRE(outputs.size() == requests.size());
+    for (size_t i = 0; i < requests.size(); ++i) {
+        CHECK(outputs[i] == requests[i].command + "@/workspace");
+    }
+
+    // a second build is served from the cache
+    cache.EvaluateAll(requests);
+    CHECK(cache.Evaluate("pkg-config --cflags lib0", "/workspace") == "pkg-config --cflags lib0@/workspace");
+    CHECK(runner.calls == COMMANDS_COUNT);
+
+    // the working directory is part of the key
+    CHECK(cache.Evaluate("pkg-config --cflags lib0", "/other") == "pkg-config --cflags lib0@/other");
+    CHECK(runner.calls == COMMANDS_COUNT + 1);
+}
+
+TEST_CASE("clBacktickCache - concurrent evaluations of a command wait for a single run")
+{
+    CountingRunner runner;
+    clBacktickCache cache;
+    cache.SetRunner(runner.Runner());
+
+    std::vector<std::thread> threads;
+    std::vector<wxString> outputs(8);
+    for (size_t i = 0; i < outputs.size(); ++i) {
+        threads.emplace_back([&cache, &outputs, i]() { outputs[i] = cache.Evaluate("wx-config --cxxflags", "/ws"); });
+    }
+    for (auto& thr : threads) {
+        thr.join();
+    }
+
+    CHECK(runner.calls == 1);
+    for (const auto& output : outputs) {
+        CHECK(output == "wx-config --cxxflags@/ws");
+    }
+}
+
+TEST_CASE("clBacktickCache - invalidation")
+{
+    CountingRunner runner;
+    clBacktickCache cache;
+    cache.SetRunner(runner.Runner());
+
+    SUBCASE("the environment is part of the key")
+    {
+        cache.Evaluate("pkg-config --cflags gtk+-3.0", "/ws");
+        ::wxSetEnv("CL_BACKTICK_CACHE_TEST", "1");
+        cache.Evaluate("pkg-config --cflags gtk+-3.0", "/ws");
+        CHECK(runner.calls == 2);
+
+        ::wxUnsetEnv("CL_BACKTICK_CACHE_TEST");
+        cache.Evaluate("pkg-config --cflags gtk+-3.0", "/ws");
+        CHECK(runner.calls == 2);
+    }
+
+    SUBCASE("the entries expire")
+    {
+        cache.SetTTL(std::chrono::milliseconds(50));
+        cache.Evaluate("pkg-config --cflags gtk+-3.0", "/ws");
+        cache.Evaluate("pkg-config --cflags gtk+-3.0", "/ws");
+        CHECK(runner.calls == 1);
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        cache.Evaluate("pkg-config --cflags gtk+-3.0", "/ws");
+        CHECK(runner.calls == 2);
+    }
+
+    SUBCASE("clear")
+    {
+        cache.Evaluate("pkg-config --cflags gtk+-3.0", "/ws");
+        cache.Clear();
+        cache.Evaluate("pkg-config --cflags gtk+-3.0", "/ws");
+        CHECK(runner.calls == 2);
+    }
+}
+
+TEST_CASE("clBacktickCache - the cache is saved with the workspace")
+{
+    wxFileName root = TestUtils::TempDir("BacktickCache");
+    wxFileName::Mkdir(root.GetPath() + wxFileName::GetPathSeparator() + ".codelite", wxS_DIR_DEFAULT,
+                      wxPATH_MKDIR_FULL);
+
+    {
+        CountingRunner runner;
+        clBacktickCache cache(root.GetPath());
+        cache.SetRunner(runner.Runner());
+        cache.Evaluate("pkg-config --libs gtk+-3.0", root.GetPath());
+        cache.Save();
+    }
+
+    CountingRunner runner;
+    clBacktickCache cache(root.GetPath());
+    cache.SetRunner(runner.Runner());
+    CHECK(cache.Evaluate("pkg-config --libs gtk+-3.0", root.GetPath()) ==
+          "pkg-config --libs gtk+-3.0@" + root.GetPath());
+    CHECK(runner.calls == 0);
+
+    root.Rmdir(wxPATH_RMDIR_RECURSIVE);
+}
@@ -0,0 +1,234 @@
+#include "gdbmi.hpp"
+#include "gdbmi_legacy.hpp"
+
+#include <doctest.h>
+#include <vector>
+#include <wx/stopwatch.h>
+
+namespace
+{
+// a session recorded with gdb 13: start, break in a function, step, look at the stack, locals and memory
+const std::vector<wxString> RECORDED_SESSION = {
+    R"MI(=thread-group-added,id="i1")MI",
+    R"MI(~"GNU gdb (GDB) 13.2\n")MI",
+    R"MI(~"Reading symbols from ./demo...\n")MI",
+    R"MI(1^done)MI",
+    R"MI(2^done,bkpt={number="1",type="breakpoint",disp="keep",enabled="y",addr="0x0000000000401136",func="compute(int, std::vector<int, std::allocator<int> > const&)",file="main.cpp",fullname="/src/demo/main.cpp",line="12",thread-groups=["i1"],times="0",original-location="main.cpp:12"})MI",
+    R"MI(=thread-group-started,id="i1",pid="4242")MI",
+    R"MI(=thread-created,id="1",group-id="i1")MI",
+    R"MI(=library-loaded,id="/lib64/ld-linux-x86-64.so.2",target-name="/lib64/ld-linux-x86-64.so.2",host-name="/lib64/ld-linux-x86-64.so.2",symbols-loaded="0",thread-group="i1",ranges=[{from="0x00007ffff7fc5090",to="0x00007ffff7fee335"}])MI",
+    R"MI(3^running)MI",
+    R"MI(*running,thread-id="all")MI",
+    R"MI(=breakpoint-modified,bkpt={number="1",type="breakpoint",disp="keep",enabled="y",addr="0x0000000000401136",func="compute(int, std::vector<int, std::allocator<int> > const&)",file="main.cpp",fullname="/src/demo/main.cpp",line="12",thread-groups=["i1"],times="1",original-location="main.cpp:12"})MI",
+    R"MI(*stopped,reason="breakpoint-hit",disp="keep",bkptno="1",frame={addr="0x0000000000401136",func="compute",args=[{name="n",value="3"},{name="values",value="std::vector of length 3, capacity 3 = {1, 2, 3}"}],file="main.cpp",fullname="/src/demo/main.cpp",line="12",arch="i386:x86-64"},thread-id="1",stopped-threads="all",core="5")MI",
+    R"MI(4^done,stack=[frame={level="0",addr="0x0000000000401136",func="compute",file="main.cpp",fullname="/src/demo/main.cpp",line="12",arch="i386:x86-64"},frame={level="1",addr="0x00000000004011f2",func="run",file="main.cpp",fullname="/src/demo/main.cpp",line="25",arch="i386:x86-64"},frame={level="2",addr="0x0000000000401250",func="main",file="main.cpp",fullname="/src/demo/main.cpp",line="31",arch="i386:x86-64"}])MI",
+    R"MI(5^done,locals=[{name="sum",value="0"},{name="name",value="\"hello \\\"world\\\"\""},{name="path",value="\"C:\\\\temp\\\\demo\""},{name="it",value="{_M_current = 0x4052a0}"}])MI",
+    R"MI(6^done,name="var1",numchild="3",value="{...}",type="std::vector<int, std::allocator<int> >",thread-id="1",has_more="0")MI",
+    R"MI(7^done,numchild="3",children=[child={name="var1.0",exp="[0]",numchild="0",value="1",type="int",thread-id="1"},child={name="var1.1",exp="[1]",numchild="0",value="2",type="int",thread-id="1"},child={name="var1.2",exp="[2]",numchild="0",value="3",type="int",thread-id="1"}],has_more="0")MI",
+    R"MI(8^done,memory=[{begin="0x00007fffffffd9c0",offset="0x0000000000000000",end="0x00007fffffffd9e0",contents="0100000002000000030000000000000068656c6c6f20776f726c640000000000"}])MI",
+    R"MI(9^done,threads=[{id="1",target-id="Thread 0x7ffff7d8a740 (LWP 4242)",name="demo",frame={level="0",addr="0x0000000000401136",func="compute",args=[{name="n",value="3"}],file="main.cpp",fullname="/src/demo/main.cpp",line="12",arch="i386:x86-64"},state="stopped",core="5"}],current-thread-id="1")MI",
+    R"MI(&"warning: Error disabling address space randomization: Operation not permitted\n")MI",
+    R"MI(@"program output\n")MI",
+    R"MI(10^error,msg="No symbol \"missing\" in current context.")MI",
+    R"MI(*stopped,reason="exited-normally")MI",
+    R"MI(=thread-group-exited,id="i1",exit-code="0")MI",
+};
+
+/// the value found by following `path` (a list of names) from the root of `result`
+wxString Value(const gdbmi::ParsedResult& result, const std::vector<const char*>& path)
+{
+    const gdbmi::Node* node = result.tree;
+    for (const char* name : path) {
+        node = &node->find_child(name);
+    }
+    return node->value();
+}
+} // namespace
+
+TEST_CASE("gdbmi::Parser - result records")
+{
+    wxString line = R"MI(42^done,value="17",type="int")MI";
+    gdbmi::Parser parser;
+    gdbmi::ParsedResult result;
+    parser.parse(line, &result);
+
+    CHECK(result.line_type == gdbmi::LT_RESULT);
+    CHECK(result.txid == "42");
+    CHECK(result.line_type_context == "done");
+    CHECK(result["value"].value() == "17");
+    CHECK(result["type"].value() == "int");
+    CHECK(result.tree->size() == 2);
+
+    wxString error = R"MI(10^error,msg="No symbol \"missing\" in current context.")MI";
+    gdbmi::ParsedResult errorResult;
+    parser.parse(error, &errorResult);
+    CHECK(errorResult.line_type_context == "error");
+    CHECK(errorResult["msg"].value() == "No symbol \"missing\" in current context.");
+
+    wxString running = "^running";
+    gdbmi::ParsedResult runningResult;
+    parser.parse(running, &runningResult);
+    CHECK(runningResult.line_type == gdbmi::LT_RESULT);
+    CHECK(runningResult.txid.empty());
+    CHECK(runningResult.line_type_context == "running");
+    CHECK(runningResult.tree->empty());
+}
+
+TEST_CASE("gdbmi::Parser - async and stream records")
+{
+    gdbmi::Parser parser;
+
+    gdbmi::ParsedResult stopped;
+    parser.parse(RECORDED_SESSION[11], &stopped);
+    CHECK(stopped.line_type == gdbmi::LT_EXEC_ASYNC_OUTPUT);
+    CHECK(stopped.line_type_context == "stopped");
+    CHECK(stopped["reason"].value() == "breakpoint-hit");
+    CHECK(Value(stopped, {"frame", "func"}) == "compute");
+    CHECK(Value(stopped, {"frame", "line"}) == "12");
+
+    gdbmi::ParsedResult notify;
+    parser.parse(RECORDED_SESSION[5], &notify);
+    CHECK(notify.line_type == gdbmi::LT_NOTIFY_ASYNC_OUTPUT);
+    CHECK(notify.line_type_context == "thread-group-started");
+    CHECK(notify["pid"].value() == "4242");
+
+    wxString status = R"MI(+download,section=".text",section-size="6668")MI";
+    gdbmi::ParsedResult statusResult;
+    parser.parse(status, &statusResult);
+    CHECK(statusResult.line_type == gdbmi::LT_STATUS_ASYNC_OUTPUT);
+    CHECK(statusResult.line_type_context == "download");
+    CHECK(statusResult["section"].value() == ".text");
+
+    gdbmi::ParsedResult console;
+    parser.parse(RECORDED_SESSION[1], &console);
+    CHECK(console.line_type == gdbmi::LT_CONSOLE_STREAM_OUTPUT);
+    CHECK(console.line_type_context.to_string() == R"MI("GNU gdb (GDB) 13.2\n")MI");
+
+    gdbmi::ParsedResult log;
+    parser.parse(RECORDED_SESSION[18], &log);
+    CHECK(log.line_type == gdbmi::LT_LOG_STREAM_OUTPUT);
+
+    gdbmi::ParsedResult target;
+    parser.parse(RECORDED_SESSION[19], &target);
+    CHECK(target.line_type == gdbmi::LT_TARGET_STREAM_OUTPUT);
+}
+
+TEST_CASE("gdbmi::Parser - nested tuples and lists")
+{
+    gdbmi::Parser parser;
+
+    gdbmi::ParsedResult stack;
+    parser.parse(RECORDED_SESSION[12], &stack);
+    const gdbmi::Node& frames = stack["stack"];
+    REQUIRE(frames.size() == 3);
+    std::vector<wxString> functions;
+    for (const auto& frame : frames) {
+        CHECK(frame.name == "frame");
+        functions.push_back(frame["func"].value());
+    }
+    CHECK(functions == std::vector<wxString>{"compute", "run", "main"});
+    CHECK(frames[2]["line"].value() == "31");
+    CHECK_FALSE(frames[3].exists("func"));
+
+    // a list of tuples without names, inside a tuple inside a list
+    gdbmi::ParsedResult threads;
+    parser.parse(RECORDED_SESSION[17], &threads);
+    const gdbmi::Node& thread = threads["threads"][0];
+    CHECK(thread["id"].value() == "1");
+    CHECK(thread["frame"]["args"][0]["name"].value() == "n");
+    CHECK(threads["current-thread-id"].value() == "1");
+
+    // a list of strings
+    gdbmi::ParsedResult bkpt;
+    parser.parse(RECORDED_SESSION[4], &bkpt);
+    REQUIRE(bkpt["bkpt"]["thread-groups"].size() == 1);
+    CHECK(bkpt["bkpt"]["thread-groups"][0].value() == "i1");
+    CHECK(bkpt["bkpt"]["original-location"].value() == "main.cpp:12");
+}
+
+TEST_CASE("gdbmi::Parser - escaped strings")
+{
+    gdbmi::Parser parser;
+    gdbmi::ParsedResult locals;
+    parser.parse(RECORDED_SESSION[13], &locals);
+    const gdbmi::Node& list = locals["locals"];
+    REQUIRE(list.size() == 4);
+
+    // the raw value is kept as found in the record, the value is unescaped
+    CHECK(list[1]["value"].raw_value.to_string() == R"MI(\"hello \\\"world\\\"\")MI");
+    CHECK(list[1]["value"].value() == R"MI("hello "world"")MI");
+    CHECK(list[2]["value"].value() == R"MI("C:\temp\demo")MI");
+    // a '}' or ',' inside a string does not end the tuple
+    CHECK(list[3]["value"].value() == "{_M_current = 0x4052a0}");
+
+    // the values are trimmed
+    wxString padded = R"MI(^done,value="  42 \n")MI";
+    gdbmi::ParsedResult paddedResult;
+    parser.parse(padded, &paddedResult);
+    CHECK(paddedResult["value"].value() == "42 \\n");
+}
+
+TEST_CASE("gdbmi::Parser - malformed input")
+{
+    gdbmi::Parser parser;
+
+    // an unterminated string: the properties read so far are kept
+    wxString truncated = R"MI(^done,a="1",b="unterminated)MI";
+    gdbmi::ParsedResult truncatedResult;
+    parser.parse(truncated, &truncatedResult);
+    CHECK(truncatedResult.line_type == gdbmi::LT_RESULT);
+    CHECK(truncatedResult["a"].value() == "1");
+    CHECK_FALSE(truncatedResult.exists("b"));
+
+    // unbalanced brackets and a missing '='
+    wxString unbalanced = R"MI(^done,frame={func="main",args=[{name="n"}},x "y",z="3")MI";
+    gdbmi::ParsedResult unbalancedResult;
+    parser.parse(unbalanced, &unbalancedResult);
+    CHECK(unbalancedResult["frame"]["func"].value() == "main");
+
+    // not a record at all. The characters that are not part of the MI syntax are skipped
+    for (const wxString& garbage : {wxString(), wxString("   "), wxString("}}]]"), wxString("hello world"),
+                                    wxString("^"), wxString("=,,,="), wxString("\""), wxString("#!?"),
+                                    wxString("warning: Error disabling address space randomization")}) {
+        gdbmi::ParsedResult result;
+        parser.parse(garbage, &result);
+        CHECK(result.tree->empty());
+        CHECK(result["anything"].value().empty());
+        CHECK(result["anything"]["nested"][3].empty());
+    }
+}
+
+// the recorded session parsed with the node arena and with the previous parser. Run with --no-skip
+TEST_CASE("gdbmi::Parser - recorded session benchmark" * doctest::skip())
+{
+    constexpr size_t REPEAT = 5000;
+
+    gdbmi::Parser parser;
+    wxStopWatch sw;
+    size_t nodes = 0;
+    for (size_t i = 0; i < REPEAT; ++i) {
+        for (const wxString& line : RECORDED_SESSION) {
+            gdbmi::ParsedResult result;
+            parser.parse(line, &result);
+            nodes += result.tree->size();
+        }
+    }
+    long arenaMs = sw.Time();
+
+    gdbmi_legacy::Parser legacyParser;
+    sw.Start();
+    size_t legacyNodes = 0;
+    for (size_t i = 0; i < REPEAT; ++i) {
+        for (const wxString& line : RECORDED_SESSION) {
+            gdbmi_legacy::ParsedResult result;
+            legacyParser.parse(line, &result);
+            legacyNodes += result.tree->children.size();
+        }
+    }
+    long legacyMs = sw.Time();
+
+    CHECK(nodes == legacyNodes);
+    MESSAGE(REPEAT * RECORDED_SESSION.size() << " records: node arena " << arenaMs << "ms, previous parser "
+                                             << legacyMs << "ms");
+    CHECK(arenaMs <= legacyMs);
+}
@@ -0,0 +1,160 @@
+#include "TestUtils.hpp"
+#include "clIconAtlas.hpp"
+#include "fileutils.h"
+
+#include <doctest.h>
+#include <string>
+#include <unordered_map>
+#include <wx/ffile.h>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/image.h>
+#include <wx/stopwatch.h>
+
+namespace
+{
+std::string ReadRaw(const wxFileName& fn)
+{
+    wxFFile fp(fn.GetFullPath(), "rb");
+    std::string content(fp.Length(), '\0');
+    fp.Read(content.data(), content.size());
+    return content;
+}
+
+/// a `size` x `size` icon filled with `red`, half transparent
+wxImage MakeIcon(int size, unsigned char red)
+{
+    wxImage image(size, size);
+    image.SetRGB(wxRect(0, 0, size, size), red, 10, 20);
+    image.InitAlpha();
+    for (int x = 0; x < size; ++x) {
+        for (int y = 0; y < size; ++y) {
+            image.SetAlpha(x, y, 128);
+        }
+    }
+    return image;
+}
+
+std::unordered_map<wxString, wxImage> MakeIcons()
+{
+    std::unordered_map<wxString, wxImage> icons;
+    icons.insert({"file_save", MakeIcon(32, 1)});
+    icons.insert({"file_close", MakeIcon(32, 2)});
+    icons.insert({"mime-cpp", MakeIcon(24, 3)});
+    return icons;
+}
+} // namespace
+
+TEST_CASE("clIconAtlas - build and load")
+{
+    constexpr uint64_t HASH = 0x1234;
+    wxFileName fn = TestUtils::TempFile("IconAtlasRoundTrip", "atlas");
+    auto icons = MakeIcons();
+    REQUIRE(clIconAtlas::Build(fn, HASH, 2.0, icons));
+
+    clIconAtlas atlas;
+    REQUIRE(atlas.Load(fn, HASH));
+    CHECK(atlas.GetCount() == icons.size());
+    CHECK(atlas.GetScaleFactor() == doctest::Approx(2.0));
+
+    for (const auto& [name, icon] : icons) {
+        REQUIRE(atlas.Contains(name));
+        wxImage image = atlas.GetImage(name);
+        REQUIRE(image.IsOk());
+        CHECK(image.GetWidth() == icon.GetWidth());
+        CHECK(image.GetHeight() == icon.GetHeight());
+        CHECK(image.GetRed(0, 0) == icon.GetRed(0, 0));
+        CHECK(image.GetGreen(5, 5) == 10);
+        CHECK(image.GetAlpha(icon.GetWidth() - 1, icon.GetHeight() - 1) == 128);
+    }
+    CHECK_FALSE(atlas.GetImage("unknown").IsOk());
+
+    // built from another SVG set or for another scale
+    clIconAtlas stale;
+    CHECK_FALSE(stale.Load(fn, HASH + 1));
+    CHECK_FALSE(stale.IsOk());
+    ::wxRemoveFile(fn.GetFullPath());
+}
+
+TEST_CASE("clIconAtlas - a corrupted or truncated atlas is ignored")
+{
+    constexpr uint64_t HASH = 0x5678;
+    wxFileName fn = TestUtils::TempFile("IconAtlasCorrupted", "atlas");
+    REQUIRE(clIconAtlas::Build(fn, HASH, 1.0, MakeIcons()));
+
+    std::string content = ReadRaw(fn);
+    REQUIRE(content.size() > 100);
+
+    // truncated anywhere: in the header, the index or the pixels
+    for (size_t size : {size_t{0}, size_t{4}, size_t{20}, size_t{40}, size_t{100}, content.size() - 1}) {
+        REQUIRE(FileUtils::WriteFileContentRaw(fn, content.substr(0, size)));
+        clIconAtlas atlas;
+        CHECK_FALSE(atlas.Load(fn, HASH));
+        CHECK_FALSE(atlas.GetImage("file_save").IsOk());
+    }
+
+    // not an atlas
+    std::string garbage = content;
+    garbage[0] = 'X';
+    REQUIRE(FileUtils::WriteFileContentRaw(fn, garbage));
+    clIconAtlas atlas;
+    CHECK_FALSE(atlas.Load(fn, HASH));
+
+    // the caller falls back to the SVG files, and the atlas is built again
+    REQUIRE(clIconAtlas::Build(fn, HASH, 1.0, MakeIcons()));
+    CHECK(atlas.Load(fn, HASH));
+    CHECK(atlas.GetImage("file_save").IsOk());
+    ::wxRemoveFile(fn.GetFullPath());
+}
+
+TEST_CASE("clIconAtlas - missing atlas")
+{
+    wxFileName fn = TestUtils::TempFile("IconAtlasMissing", "atlas");
+    clIconAtlas atlas;
+    CHECK_FALSE(atlas.Load(fn, 0));
+    CHECK_FALSE(atlas.IsOk());
+}
+
+// the startup cost of the icons: one atlas versus a PNG file per icon. Run with --no-skip
+TEST_CASE("clIconAtlas - startup loading benchmark" * doctest::skip())
+{
+    constexpr size_t ICONS = 800;
+    constexpr uint64_t HASH = 0x9abc;
+    if (!wxImage::FindHandler(wxBITMAP_TYPE_PNG)) {
+        wxImage::AddHandler(new wxPNGHandler);
+    }
+
+    wxFileName dir = TestUtils::TempDir("IconAtlasBenchmark");
+    std::unordered_map<wxString, wxImage> icons;
+    for (size_t i = 0; i < ICONS; ++i) {
+        wxString name = wxString::Format("icon-%u", (unsigned)i);
+        wxImage icon = MakeIcon(i % 2 ? 32 : 24, static_cast<unsigned char>(i));
+        REQUIRE(icon.SaveFile(wxFileName(dir.GetPath(), name + ".png").GetFullPath(), wxBITMAP_TYPE_PNG));
+        icons.insert({name, icon});
+    }
+    wxFileName atlasFile(dir.GetPath(), "icons.atlas");
+    REQUIRE(clIconAtlas::Build(atlasFile, HASH, 1.0, icons));
+
+    wxStopWatch sw;
+    size_t loaded = 0;
+    for (const auto& vt : icons) {
+        wxImage image;
+        loaded += image.LoadFile(wxFileName(dir.GetPath(), vt.first + ".png").GetFullPath(), wxBITMAP_TYPE_PNG);
+    }
+    long pngMs = sw.Time();
+    CHECK(loaded == ICONS);
+
+    sw.Start();
+    clIconAtlas atlas;
+    REQUIRE(atlas.Load(atlasFile, HASH));
+    loaded = 0;
+    for (const auto& vt : icons) {
+        loaded += atlas.GetImage(vt.first).IsOk();
+    }
+    long atlasMs = sw.Time();
+    CHECK(loaded == ICONS);
+
+    MESSAGE(ICONS << " icons: PNG files " << pngMs << "ms, atlas " << atlasMs << "ms");
+    CHECK(atlasMs <= pngMs);
+    dir.Rmdir(wxPATH_RMDIR_RECURSIVE);
+}
@@ -0,0 +1,101 @@
+#include "TestUtils.hpp"
+#include "clLazyTabs.hpp"
+#include "fileutils.h"
+
+#include <doctest.h>
+#include <vector>
+#include <wx/filename.h>
+
+namespace
+{
+/// a session of `count` tabs, each one with its own file under a new temporary folder
+std::vector<TabInfo> MakeSession(size_t count, wxFileName& root)
+{
+    root = TestUtils::TempDir("LazyTabs");
+
+    std::vector<TabInfo> tabs;
+    for (size_t i = 0; i < count; ++i) {
+        wxFileName fn(root.GetPath(), wxString::Format("file%zu.cpp", i));
+        FileUtils::WriteFileContent(fn, wxString::Format("int func%zu() { return %zu; }\n", i, i));
+
+        TabInfo tab;
+        tab.SetFileName(fn.GetFullPath());
+        tab.SetFirstVisibleLine((int)i);
+        tab.SetCurrentLine((int)i + 1);
+        tabs.push_back(tab);
+    }
+    return tabs;
+}
+} // namespace
+
+TEST_CASE("clLazyTabs - only the selected tab is loaded on restore")
+{
+    constexpr size_t TABS_COUNT = 200;
+    constexpr size_t SELECTED = 42;
+    wxFileName root;
+    std::vector<TabInfo> session = MakeSession(TABS_COUNT, root);
+
+    // the pages the notebook would get
+    std::vector<wxString> pages;
+    std::vector<wxString> editors;
+
+    clLazyTabs lazy_tabs;
+    lazy_tabs.Restore(session, SELECTED, [&](const TabInfo& tab, bool pending) {
+        pages.push_back(tab.GetFileName());
+        if (!pending) {
+            editors.push_back(tab.GetFileName());
+        }
+    });
+
+    REQUIRE(pages.size() == TABS_COUNT);
+    CHECK(pages[SELECTED] == session[SELECTED].GetFileName());
+    REQUIRE(editors.size() == 1);
+    CHECK(editors[0] == session[SELECTED].GetFileName());
+    CHECK(lazy_tabs.GetPendingCount() == TABS_COUNT - 1);
+    CHECK_FALSE(lazy_tabs.IsPending(session[SELECTED].GetFileName()));
+
+    // the files of the other tabs are read in the background
+    lazy_tabs.WaitForPrefetch();
+    CHECK(lazy_tabs.GetPrefetchedCount() == TABS_COUNT - 1);
+
+    // a tab is loaded with the state it was saved with
+    const wxString& filename = session[7].GetFileName();
+    REQUIRE(lazy_tabs.IsPending(filename));
+    REQUIRE(lazy_tabs.Find(filename));
+    CHECK(lazy_tabs.Find(filename)->GetCurrentLine() == 8);
+
+    TabInfo tab;
+    REQUIRE(lazy_tabs.Take(filename, tab));
+    CHECK(tab.GetFileName() == filename);
+    CHECK(tab.GetFirstVisibleLine() == 7);
+    CHECK(tab.GetCurrentLine() == 8);
+    CHECK_FALSE(lazy_tabs.IsPending(filename));
+    CHECK_FALSE(lazy_tabs.Take(filename, tab));
+    CHECK(lazy_tabs.GetPendingCount() == TABS_COUNT - 2);
+
+    // a tab closed before it was loaded
+    lazy_tabs.Remove(session[8].GetFileName());
+    CHECK_FALSE(lazy_tabs.IsPending(session[8].GetFileName()));
+
+    lazy_tabs.Clear();
+    CHECK(lazy_tabs.GetPendingCount() == 0);
+
+    wxFileName::Rmdir(root.GetPath(), wxPATH_RMDIR_RECURSIVE);
+}
+
+TEST_CASE("clLazyTabs - missing files are not prefetched")
+{
+    std::vector<TabInfo> session(3);
+    session[0].SetFileName("/this/file/does/not/exist.cpp");
+    session[1].SetFileName("/this/file/does/not/exist.h");
+    session[2].SetFileName("/this/file/does/not/exist.txt");
+
+    size_t pages = 0;
+    clLazyTabs lazy_tabs;
+    lazy_tabs.Restore(session, 0, [&pages](const TabInfo&, bool) { ++pages; });
+    lazy_tabs.WaitForPrefetch();
+
+    CHECK(pages == 3);
+    CHECK(lazy_tabs.GetPendingCount() == 2);
+    CHECK(lazy_tabs.GetPrefetchedCount() == 0);
+}
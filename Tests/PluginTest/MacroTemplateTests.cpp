@@ -0,0 +1,261 @@
+#include "clMacroTemplate.hpp"
+#include "macromanager.h"
+
+#include <doctest.h>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <wx/regex.h>
+
+namespace
+{
+using VariableList = std::vector<std::pair<wxString, wxString>>;
+
+// the values of a project context
+const std::unordered_map<wxString, wxString>& GetProjectValues()
+{
+    static const std::unordered_map<wxString, wxString> values = {
+        {"WorkspaceName", "MyWorkspace"},
+        {"WorkspaceConfiguration", "Debug"},
+        {"WorkspacePath", "/home/user/dev/ws"},
+        {"WorkspaceRealPath", "/mnt/data/dev/ws"},
+        {"OutputDirectory", "$(WorkspacePath)/build-$(WorkspaceConfiguration)/bin"},
+        {"ProjectOutputFile", "$(IntermediateDirectory)/$(ProjectName)"},
+        {"OutputFile", "$(IntermediateDirectory)/$(ProjectName)"},
+        {"Program", "$(OutputFile)"},
+        {"ProjectWorkingDirectory", "/home/user/dev/ws/app"},
+        {"ProjectRunWorkingDirectory", "$(IntermediateDirectory)"},
+        {"ProjectPath", "/home/user/dev/ws/app"},
+        {"ProjectName", "my_app"},
+        {"IntermediateDirectory", "./$(ConfigurationName)"},
+        {"ConfigurationName", "Debug"},
+        {"OutDir", "./$(ConfigurationName)"},
+        {"CC", "gcc"},
+        {"CFLAGS", "-g -O0 -Wall"},
+        {"CXX", "g++"},
+        {"CXXFLAGS", "-g -O0 -std=c++17 -Wall $(CFLAGS)"},
+        {"LDFLAGS", "-Wl,-rpath,$(ProjectPath)"},
+        {"AS", "as"},
+        {"ASFLAGS", ""},
+        {"RES", "windres"},
+        {"RESFLAGS", ""},
+        {"AR", "ar rcus"},
+        {"MAKE", "make -j8"},
+        {"IncludePath", "-I. -I$(WorkspacePath)/include"},
+        {"LibraryPath", "-L. -L$(OutputDirectory)"},
+        {"ResourcePath", ""},
+        {"LinkLibraries", "-lpthread -ldl"},
+        {"ProjectFiles", "main.cpp app.cpp"},
+        {"ProjectFilesAbs", "/home/user/dev/ws/app/main.cpp /home/user/dev/ws/app/app.cpp"},
+        {"CurrentFileName", "main"},
+        {"CurrentFilePath", "/home/user/dev/ws/app"},
+        {"CurrentFileExt", "cpp"},
+        {"CurrentFileFullName", "main.cpp"},
+        {"CurrentFileRelPath", "app/main.cpp"},
+        {"CurrentFileFullPath", "/home/user/dev/ws/app/main.cpp"},
+        {"CurrentSelection", "$(NotAMacro) selected text"},
+        {"CurrentSelectionRange", "10:20"},
+        {"User", "user"},
+        {"Date", "10/19/26"},
+        {"Year", "2026"},
+        {"SSH_AccountName", ""},
+        {"SSH_Host", ""},
+        {"SSH_User", ""},
+        {"CodeLitePath", "/usr/share/codelite"},
+    };
+    return values;
+}
+
+// the project context, in the order MacroManager adds (and used to replace) the variables
+VariableList GetProjectVariables()
+{
+    VariableList variables;
+    for (const auto& name : MacroManager::GetVariablesOrder()) {
+        auto iter = GetProjectValues().find(name);
+        variables.push_back({name, iter == GetProjectValues().end() ? wxString() : iter->second});
+    }
+    return variables;
+}
+
+// macros as found in workspace and project settings
+const std::vector<wxString>& GetCorpus()
+{
+    static const std::vector<wxString> corpus = {
+        "",
+        "no macros at all",
+        "$(ProjectName)",
+        "$(IntermediateDirectory)/$(ProjectName)",
+        "$(WorkspacePath)/build-$(WorkspaceConfiguration)/bin",
+        "$(CXX) $(CXXFLAGS) -c \"$(CurrentFileFullPath)\" -o $(IntermediateDirectory)/$(CurrentFileName).o",
+        "$(CC) $(CFLAGS) $(IncludePath) -c $(CurrentFileFullName)",
+        "$(MAKE) -f $(ProjectName).mk clean",
+        "cd $(ProjectPath) && $(MAKE) -e -f Makefile",
+        "$(OutputFile) --config $(ConfigurationName)",
+        "$(Program)",
+        "$(ProjectRunWorkingDirectory)",
+        "$(LibraryPath) $(LinkLibraries)",
+        "$(ProjectFiles) $(ProjectFilesAbs)",
+        "$(CurrentSelection)",
+        "$(CurrentFileRelPath):$(CurrentSelectionRange)",
+        "Copyright (C) $(Year) $(User), $(Date)",
+        "$(CodeLitePath)/codelite-make",
+        "$(UnknownMacro)/$(ProjectName)",
+        "$(ProjectName",
+        "$()$(ProjectName)$",
+        "$($(ProjectName))",
+        "$$(ProjectName) $(ProjectName)",
+        "${HOME}/$(ProjectName) %PATH% $USER",
+        "$(WorkspaceRealPath)$(WorkspacePath)$(WorkspaceName)",
+        "$(projectname) $(PROJECTNAME)",
+        "$(OutDir)$(ProjectName)$(OutDir)",
+    };
+    return corpus;
+}
+
+/// what MacroManager used to do: one wxString::Replace() per macro, in order
+wxString ReplaceChain(wxString str, const VariableList& variables)
+{
+    for (const auto& [name, value] : variables) {
+        str.Replace("$(" + name + ")", value);
+    }
+    return str;
+}
+
+clMacroVariables MakeVariables(const VariableList& list)
+{
+    clMacroVariables variables;
+    for (const auto& [name, value] : list) {
+        variables.Add(name, value);
+    }
+    return variables;
+}
+
+/// the regular expressions used by MacroManager::FindVariable()
+bool FindVariableRegex(const wxString& str, wxString& name, wxString& fullname)
+{
+    for (const wxString& pattern : {"\\$\\(([a-z_0-9]+)\\)", "\\$\\{([a-z_0-9]+)\\}", "\\$([a-z_0-9]+)", "%([a-z_0-9]+)%"}) {
+        wxRegEx re(pattern, wxRE_DEFAULT | wxRE_ICASE);
+        if (re.Matches(str)) {
+            name = re.GetMatch(str, 1);
+            fullname = re.GetMatch(str);
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+TEST_CASE("clMacroTemplate - segments")
+{
+    clMacroTemplate compiled("cd $(ProjectPath) && $(MAKE) $(Broken $()");
+    const auto& segments = compiled.GetSegments();
+    REQUIRE(segments.size() == 5);
+    CHECK(segments[0].text == "cd ");
+    CHECK_FALSE(segments[0].is_macro);
+    CHECK(segments[1].text == "ProjectPath");
+    CHECK(segments[1].is_macro);
+    CHECK(segments[2].text == " && ");
+    CHECK(segments[3].text == "MAKE");
+    CHECK(segments[3].is_macro);
+    CHECK(segments[4].text == " $(Broken $()");
+    CHECK_FALSE(segments[4].is_macro);
+
+    CHECK(compiled.HasMacros());
+    CHECK(compiled.HasMacro("MAKE"));
+    CHECK_FALSE(compiled.HasMacro("Broken"));
+    CHECK_FALSE(clMacroTemplate("no macros").HasMacros());
+
+    // compiled templates are shared
+    CHECK(clMacroTemplate::Compile("$(ProjectName)") == clMacroTemplate::Compile("$(ProjectName)"));
+}
+
+TEST_CASE("clMacroTemplate - lazy values are only computed when used")
+{
+    int calls = 0;
+    clMacroVariables variables;
+    variables.Add("ProjectName", "app");
+    variables.AddLazy("ProjectFiles", [&calls]() {
+        ++calls;
+        return wxString("a.cpp b.cpp");
+    });
+
+    CHECK(clMacroTemplate::Compile("$(ProjectName)")->Expand(variables) == "app");
+    CHECK(calls == 0);
+    CHECK(clMacroTemplate::Compile("$(ProjectFiles) $(ProjectFiles)")->Expand(variables) == "a.cpp b.cpp a.cpp b.cpp");
+    CHECK(calls == 1);
+}
+
+TEST_CASE("MacroManager - every CodeLite macro has a test value")
+{
+    for (const auto& name : MacroManager::GetVariablesOrder()) {
+        INFO("macro: " << name);
+        CHECK(GetProjectValues().count(name) == 1);
+        CHECK(MacroManager::Instance()->IsCodeLiteMacro(name));
+    }
+}
+
+TEST_CASE("clMacroVariables - appended variables come after the existing ones")
+{
+    clMacroVariables block;
+    block.Add("IntermediateDirectory", "./$(ConfigurationName)");
+    block.Add("ConfigurationName", "Debug");
+
+    clMacroVariables variables;
+    variables.Add("ConfigurationName", "Release");
+    variables.Add("OutputFile", "$(IntermediateDirectory)/app");
+    variables.Append(block);
+    variables.Add("ProjectName", "app");
+
+    CHECK(clMacroTemplate::Compile("$(ConfigurationName)")->Expand(variables) == "Release");
+    CHECK(clMacroTemplate::Compile("$(OutputFile) $(ProjectName)")->Expand(variables) == "./Debug/app app");
+}
+
+TEST_CASE("clMacroTemplate - same output as the Replace() chain")
+{
+    const auto list = GetProjectVariables();
+    clMacroVariables variables = MakeVariables(list);
+
+    for (const auto& source : GetCorpus()) {
+        INFO("source: " << source);
+
+        // a single pass
+        CHECK(clMacroTemplate::Compile(source)->Expand(variables) == ReplaceChain(source, list));
+
+        // and the repeated passes done by MacroManager
+        wxString expected = source;
+        wxString actual = source;
+        for (int pass = 0; pass < 5; ++pass) {
+            expected = ReplaceChain(expected, list);
+            actual = clMacroTemplate::Compile(actual)->Expand(variables);
+        }
+        CHECK(actual == expected);
+    }
+}
+
+TEST_CASE("MacroManager::FindVariable - same result as the regular expressions")
+{
+    std::vector<wxString> corpus = GetCorpus();
+    corpus.insert(corpus.end(),
+                  {"${HOME}/$(ProjectName)",
+                   "%PATH% ${HOME}",
+                   "$USER and %TEMP%",
+                   "50% of 100%",
+                   "% not a variable %",
+                   "$ {HOME}",
+                   "$(with space) $_underscore",
+                   "price: $5",
+                   "$(", "$", "%%"});
+
+    for (const auto& str : corpus) {
+        INFO("string: " << str);
+        wxString name, fullname;
+        wxString expected_name, expected_fullname;
+        bool found = MacroManager::Instance()->FindVariable(str, name, fullname);
+        bool expected = FindVariableRegex(str, expected_name, expected_fullname);
+        CHECK(found == expected);
+        if (found && expected) {
+            CHECK(name == expected_name);
+            CHECK(fullname == expected_fullname);
+        }
+    }
+}
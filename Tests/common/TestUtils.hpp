@@ -0,0 +1,80 @@
+#ifndef TESTUTILS_HPP
+#define TESTUTILS_HPP
+
+#include <fstream>
+#include <string>
+#include <wx/filefn.h>
+#include <wx/filename.h>
+#include <wx/utils.h>
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+/// helpers shared by the test executables
+namespace TestUtils
+{
+/**
+ * @brief the file `name`-`pid`.`ext` under the temporary folder. A file left by a previous run is removed
+ */
+inline wxFileName TempFile(const wxString& name, const wxString& ext)
+{
+    wxFileName fn(wxFileName::GetTempDir(), wxString::Format("%s-%lu.%s", name, wxGetProcessId(), ext));
+    if (fn.FileExists()) {
+        ::wxRemoveFile(fn.GetFullPath());
+    }
+    return fn;
+}
+
+/**
+ * @brief the empty folder `name`-`pid` under the temporary folder. A folder left by a previous run is removed
+ */
+inline wxFileName TempDir(const wxString& name)
+{
+    wxFileName root(wxFileName::GetTempDir(), "");
+    root.AppendDir(wxString::Format("%s-%lu", name, wxGetProcessId()));
+    if (root.DirExists()) {
+        root.Rmdir(wxPATH_RMDIR_RECURSIVE);
+    }
+    root.Mkdir(wxS_DIR_DEFAULT, wxPATH_MKDIR_FULL);
+    return root;
+}
+
+/// the resident memory of this process in bytes, 0 if unknown
+inline size_t GetResidentMemory()
+{
+#ifdef __linux__
+    std::ifstream statm("/proc/self/statm");
+    size_t pages = 0;
+    size_t resident = 0;
+    if (statm >> pages >> resident) {
+        return resident * static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+#endif
+    return 0;
+}
+
+/// the peak resident memory since the last ResetPeakMemory(), in KB. 0 when not available
+inline size_t GetPeakMemoryKB()
+{
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("VmHWM:", 0) == 0) {
+            return std::stoul(line.substr(6));
+        }
+    }
+#endif
+    return 0;
+}
+
+inline void ResetPeakMemory()
+{
+#ifdef __linux__
+    std::ofstream("/proc/self/clear_refs") << "5";
+#endif
+}
+} // namespace TestUtils
+
+#endif // TESTUTILS_HPP